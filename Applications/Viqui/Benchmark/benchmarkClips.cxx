@@ -0,0 +1,162 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "viquiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include "vqArchiveVideoSource.h"
+#include "vqTrackingClipBuilder.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgEvent.h>
+
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+
+#include <QJsonObject>
+#include <QUrl>
+
+#include <utility>
+
+using vgBenchmarkData::FrameInterval;
+using vgBenchmarkData::writeSyntheticKwa;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkClips(vgBenchmark& benchmark, const QString& directory,
+                    int frameCount, int width, int height, int clipCount,
+                    int threadCount)
+{
+  QString indexName;
+  if (!writeSyntheticKwa(directory, frameCount, width, height, indexName))
+    {
+    return;
+    }
+
+  const QUrl uri = QUrl::fromLocalFile(indexName);
+  const int clipLength = qMin(frameCount, 60);
+  const int span = frameCount - clipLength + 1;
+
+  // Set up clips; as in viqui, each clip has its own copy of the video source
+  // and event, but the clip is created (and the video index read) before
+  // building starts, so this is not measured
+  vqTrackingClipBuilder::ClipVector clips;
+  for (int n = 0; n < clipCount; ++n)
+    {
+    const int first = (n * 37) % span;
+    const int last = first + clipLength - 1;
+
+    // Event region is a box that moves diagonally across the video
+    auto event = vtkSmartPointer<vtkVgEvent>::New();
+    for (int k = first; k <= last; ++k)
+      {
+      const double t = static_cast<double>(k - first) / clipLength;
+      const double x = 40.0 + t * qMax(0, width - 80);
+      const double y = 40.0 + t * qMax(0, height - 80);
+      double points[] =
+        {
+        x - 40.0, y + 40.0,
+        x + 40.0, y + 40.0,
+        x + 40.0, y - 40.0,
+        x - 40.0, y - 40.0
+        };
+
+      vtkVgTimeStamp ts;
+      ts.SetTime(k * FrameInterval);
+      event->AddRegion(ts, 4, points);
+      }
+
+    vtkVgTimeStamp startTime, endTime;
+    startTime.SetTime(first * FrameInterval);
+    endTime.SetTime(last * FrameInterval);
+    event->SetStartFrame(startTime);
+    event->SetEndFrame(endTime);
+
+    auto video = vtkSmartPointer<vqArchiveVideoSource>::New();
+    video->SetTimeRange(startTime.GetTime(), endTime.GetTime());
+    if (video->AcquireVideoClip(uri) != VTK_OK)
+      {
+      qWarning() << "Failed to open synthetic video" << indexName;
+      return;
+      }
+
+    auto clip = vtkSmartPointer<vtkVQTrackingClip>::New();
+    clip->SetVideo(video);
+    clip->SetEvent(event);
+    clips.push_back(std::make_pair(n, clip));
+    }
+
+  QJsonObject parameters;
+  parameters.insert("clips", clipCount);
+  parameters.insert("clip_length", clipLength);
+  parameters.insert("width", width);
+  parameters.insert("height", height);
+
+  QList<int> threadCounts;
+  threadCounts << 1;
+  if (threadCount > 1)
+    {
+    threadCounts << threadCount;
+    }
+
+  foreach (const int threads, threadCounts)
+    {
+    vqTrackingClipBuilder builder;
+    builder.SetThreadCount(threads);
+
+    // Clips are delivered from the builder's thread; the connection
+    // has no context object, so the slot is always called directly
+    QAtomicInt received;
+    QObject::connect(&builder, &vqTrackingClipBuilder::ClipAvailable,
+                     [&received](vtkImageData* image, int){
+                       image->Delete();
+                       received.ref();
+                     });
+
+    parameters.insert("threads", threads);
+    benchmark.measure(
+      "clips", "build", parameters, clipCount, "clips",
+      [&]{
+        // Mark clips as modified so that they are rebuilt
+        for (auto& clip : clips)
+          {
+          clip.second->Modified();
+          }
+
+        builder.BuildClips(clips.begin(), clips.end());
+        builder.wait();
+      });
+
+    const int expected = clipCount * benchmark.iterations();
+    if (received.load() != expected)
+      {
+      qWarning() << "Tracking clip builder produced" << received.load()
+                 << "clips; expected" << expected;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("clips <num>", "Number of tracking clips to build", "32");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkClips(benchmark, context.workDirectory(), context.count("frames"),
+                 frameSize.width(), frameSize.height(),
+                 context.count("clips"), context.threadCount("threads"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("clips", &addOptions, &run, true);
+
+} // namespace <anonymous>
@@ -0,0 +1,117 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "viquiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include "vtkVQBlastLayoutNode.h"
+
+#include <vtkVgGeode.h>
+#include <vtkVgNodeVisitor.h>
+#include <vtkVgTransformNode.h>
+
+#include <vtkActor.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPolyDataMapper.h>
+
+#include <QJsonObject>
+
+#include <cmath>
+#include <random>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkLayout(vgBenchmark& benchmark, const QList<int>& nodeCounts)
+{
+  // All nodes share the same unit square geometry, and are positioned using
+  // their actors
+  vtkNew<vtkPlaneSource> plane;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(plane->GetOutputPort());
+
+  std::mt19937 rng(42);
+
+  foreach (const int nodeCount, nodeCounts)
+    {
+    // Scatter nodes so that most of them overlap something; additionally,
+    // every tenth node is coincident with the one before it (as happens for
+    // multiple results from the same clip)
+    const double extent = 0.5 * std::sqrt(static_cast<double>(nodeCount));
+    std::uniform_real_distribution<double> position(0.0, extent);
+
+    auto layout = vtkVQBlastLayoutNode::SmartPtr::New();
+    double x = 0.0, y = 0.0;
+    for (int n = 0; n < nodeCount; ++n)
+      {
+      if (n % 10 != 1)
+        {
+        x = position(rng);
+        y = position(rng);
+        }
+
+      vtkNew<vtkActor> actor;
+      actor->SetMapper(mapper.GetPointer());
+      actor->SetPosition(x, y, 0.0);
+
+      auto geode = vtkVgGeode::SmartPtr::New();
+      geode->AddDrawable(actor.GetPointer());
+
+      auto transform = vtkVgTransformNode::SmartPtr::New();
+      transform->AddChild(geode);
+      layout->AddChild(transform);
+      }
+
+    vtkVgNodeVisitor visitor;
+    visitor.SetVisitorType(vtkVgNodeVisitorBase::UPDATE_VISITOR);
+
+    // Compute initial bounds
+    layout->Accept(visitor);
+
+    QJsonObject parameters;
+    parameters.insert("nodes", nodeCount);
+
+    benchmark.measure(
+      "layout", "blast", parameters, nodeCount, "nodes",
+      [&]{
+        // Switching modes undoes any previous layout
+        layout->SetLayoutMode(vtkVQBlastLayoutNode::Z_SORT);
+        layout->SetLayoutMode(vtkVQBlastLayoutNode::BLAST);
+        layout->Accept(visitor);
+      });
+
+    // Requesting the current layout again (as happens for every result added
+    // to the scene) should not redo any work until the next update
+    benchmark.measure(
+      "layout", "rerequest", parameters, nodeCount, "requests",
+      [&]{
+        for (int n = 0; n < nodeCount; ++n)
+          {
+          layout->SetLayoutMode(layout->GetLayoutMode());
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("layout-nodes <list>",
+              "Comma separated list of result node counts for layout",
+              "1000,10000,50000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkLayout(benchmark, context.sizes("layout-nodes"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("layout", &addOptions, &run, true);
+
+} // namespace <anonymous>
@@ -0,0 +1,160 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "viquiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include "vqArchiveVideoSource.h"
+
+#include <vvReportWriter.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgEvent.h>
+#include <vtkVgVideoFrameData.h>
+
+#include <vtkSmartPointer.h>
+
+#include <QDir>
+#include <QFile>
+#include <QJsonObject>
+#include <QUrl>
+
+#include <vector>
+
+using vgBenchmarkData::FrameInterval;
+using vgBenchmarkData::writeSyntheticKwa;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkReport(vgBenchmark& benchmark, const QString& directory,
+                     int frameCount, int width, int height, int resultCount)
+{
+  QString indexName;
+  if (!writeSyntheticKwa(directory, frameCount, width, height, indexName))
+    {
+    return;
+    }
+
+  auto video = vtkSmartPointer<vqArchiveVideoSource>::New();
+  if (video->AcquireVideoClip(QUrl::fromLocalFile(indexName)) != VTK_OK)
+    {
+    qWarning() << "Failed to open synthetic video" << indexName;
+    return;
+    }
+  video->SetLooping(0);
+
+  const QString reportDir = QDir(directory).filePath("report");
+  if (!QDir().mkpath(reportDir))
+    {
+    qWarning() << "Failed to create report directory" << reportDir;
+    return;
+    }
+
+  // Results are short events spread over the video
+  const int eventLength = qMin(frameCount, 10);
+  const int span = frameCount - eventLength + 1;
+  std::vector<vtkSmartPointer<vtkVgEvent> > events;
+  for (int n = 0; n < resultCount; ++n)
+    {
+    const int first = (n * 37) % span;
+
+    vtkVgTimeStamp startTime, endTime;
+    startTime.SetTime(first * FrameInterval);
+    endTime.SetTime((first + eventLength - 1) * FrameInterval);
+
+    auto event = vtkSmartPointer<vtkVgEvent>::New();
+    event->SetId(n);
+    event->SetStartFrame(startTime);
+    event->SetEndFrame(endTime);
+    events.push_back(event);
+    }
+
+  QJsonObject parameters;
+  parameters.insert("results", resultCount);
+  parameters.insert("width", width);
+  parameters.insert("height", height);
+
+  // Summary images, as written for every result of a report; the writer is
+  // destroyed within the measurement, so this includes waiting for all images
+  // to be written
+  benchmark.measure(
+    "report", "summary", parameters, resultCount, "results",
+    [&]{
+      QFile file(QDir(reportDir).filePath("report.xml"));
+      file.open(QIODevice::WriteOnly | QIODevice::Text);
+      vvReportWriter writer(file);
+
+      vtkVgVideoFrameData frame;
+      int id = 1;
+      for (const auto& event : events)
+        {
+        const double mid = 0.5 * (event->GetStartFrame().GetTime() +
+                                  event->GetEndFrame().GetTime());
+        if (video->GetFrame(&frame, mid) != VTK_OK)
+          {
+          continue;
+          }
+
+        writer.setEvent(event, id++, QString());
+        writer.setImageData(frame.VideoImage, frame.TimeStamp);
+        writer.writeEventSummary();
+        }
+    });
+
+  // Video images (frames rendered with the event representation), for a
+  // subset of the results; the video itself is not encoded
+  const int videoResultCount = qMin(resultCount, 8);
+  parameters.insert("results", videoResultCount);
+  parameters.insert("frames_per_result", eventLength);
+
+  benchmark.measure(
+    "report", "video-images", parameters, videoResultCount * eventLength,
+    "frames",
+    [&]{
+      QFile file(QDir(reportDir).filePath("report.xml"));
+      file.open(QIODevice::WriteOnly | QIODevice::Text);
+      vvReportWriter writer(file);
+
+      vtkVgVideoFrameData frame;
+      for (int n = 0; n < videoResultCount; ++n)
+        {
+        vtkVgEvent* const event = events[n];
+        writer.setEvent(event, n + 1, QString());
+
+        int framenum = 0;
+        int result = video->GetFrame(&frame, event->GetStartFrame().GetTime());
+        while (result == VTK_OK && frame.TimeStamp <= event->GetEndFrame())
+          {
+          writer.setImageData(frame.VideoImage, frame.TimeStamp);
+          writer.writeEventVideoImage(++framenum);
+          result = video->GetNextFrame(&frame);
+          }
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("report-results <num>",
+              "Number of results in generated reports", "200");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkReport(benchmark, context.workDirectory(), context.count("frames"),
+                  frameSize.width(), frameSize.height(),
+                  context.count("report-results"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("report", &addOptions, &run, true);
+
+} // namespace <anonymous>
@@ -0,0 +1,33 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "viquiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void addSharedOptions(qtCliOptions& options)
+{
+  options.add("frames <num>", "Number of frames of synthetic video", "300")
+         .add("f", qtCliOption::Short);
+
+  options.add("frame-size <width>x<height>",
+              "Size of synthetic video frames", "640x480");
+
+  options.add("threads <num>",
+              "Number of threads used by parallel builders "
+              "(by default, the number of processor cores)");
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  return vgBenchmarkSuite::exec(argc, argv, "viqui performance benchmark",
+                                &addSharedOptions);
+}
@@ -0,0 +1,11 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __viquiBenchmark_h
+#define __viquiBenchmark_h
+
+#include <vgBenchmark.h>
+#include <vgBenchmarkSuite.h>
+
+#endif
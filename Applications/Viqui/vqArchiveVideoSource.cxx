@@ -107,6 +107,32 @@ int vqArchiveVideoSource::AcquireVideoClip(QUrl clipUri)
   return this->SetVideoClip(clip.take(), clipUri);
 }
 
+//-----------------------------------------------------------------------------
+int vqArchiveVideoSource::AcquireVideoClip(
+  const vgKwaVideoClip& clip, QUrl clipUri)
+{
+  clipUri.setQuery(QUrlQuery{});
+
+  if (clip.frameCount() == 0)
+    {
+    this->SetVideoClip(0, QUrl());
+    return VTK_ERROR; // clip failed to load
+    }
+
+  // Always take a sub-clip (which is a clone of the whole clip if no time
+  // range is set), as the caller retains ownership of the given clip
+  vgKwaVideoClip* subClip =
+    clip.subClip(this->TimeRange[0], this->TimeRange[1],
+                 this->RequestedPadding);
+  if (!subClip)
+    {
+    this->SetVideoClip(0, QUrl());
+    return VTK_ERROR; // failed to obtain sub-clip
+    }
+
+  return this->SetVideoClip(subClip, clipUri);
+}
+
 //-----------------------------------------------------------------------------
 int vqArchiveVideoSource::SetVideoClip(
   vgKwaVideoClip* clip, const QUrl& clipUri)
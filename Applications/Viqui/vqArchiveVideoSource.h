@@ -62,6 +62,12 @@ public:
   // Get and store a clip from a given URI.
   int AcquireVideoClip(QUrl);
 
+  // Description:
+  // Get and store a clip from a clip which has already been loaded from the
+  // given URI. The new clip shares resources with \p clip, so reads of image
+  // data from either clip must be serialized.
+  int AcquireVideoClip(const vgKwaVideoClip& clip, QUrl clipUri);
+
   QUrl GetClipUri() const
     {
     return this->CurrentClipUri;
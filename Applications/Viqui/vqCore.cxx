@@ -8,17 +8,23 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
 #include <QMenu>
 #include <QMessageBox>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QProcess>
 #include <QProgressDialog>
 #include <QSettings>
 #include <QTemporaryFile>
+#include <QThreadPool>
 #include <QTimer>
 #include <QTimerEvent>
 #include <QUrlQuery>
+#include <QtConcurrentRun>
 
 // QtExtensions includes
 #include <qtMap.h>
@@ -40,9 +46,7 @@
 #include <vtkPoints.h>
 #include <vtkPolyDataMapper.h>
 #include <vtkProp3D.h>
-#include <vtkProp3DCollection.h>
 #include <vtkProperty.h>
-#include <vtkRenderedAreaPicker.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 #include <vtkSphereSource.h>
@@ -69,7 +73,6 @@
 #include <vtkVgVideoRepresentation0.h>
 
 #include <vtkVgFindNode.h>
-#include <vtkVgFindNodeVisitor.h>
 #include <vtkVgGeode.h>
 #include <vtkVgGroupNode.h>
 #include <vtkVgTerrain.h>
@@ -126,6 +129,7 @@
 #include <cassert>
 #include <exception>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <vector>
 #include <string>
@@ -1130,42 +1134,30 @@ void vqCore::selectClipsOnContext(
     return;
     }
 
-  vtkRenderer* ren = this->ContextViewer->GetSceneRenderer();
-  vtkSmartPointer<vtkRenderedAreaPicker> area =
-    vtkSmartPointer<vtkRenderedAreaPicker>::New();
-  int picked = area->AreaPick(
+  std::vector<vtkVgNodeBase*> pickedNodes;
+  this->ContextViewer->PickNodes(
     startScreenPosition[0], startScreenPosition[1],
-    endScreenPosition[0],   endScreenPosition[1], ren);
+    endScreenPosition[0],   endScreenPosition[1], pickedNodes);
 
-  if (picked != 1)
-    {
-    return;
-    }
-
-  vtkProp3DCollection* propCollection = area->GetProp3Ds();
-  this->ContextViewer->GetRenderWindowInteractor()->SetPicker(area);
-
-  propCollection->InitTraversal();
-  vtkProp3D* prop = propCollection->GetNextProp3D();
-
-  vtkVgFindNodeVisitor findNodeVisitor;
   QList<vtkVgNodeBase*> selectedNodes;
-  while (prop)
+  foreach (vtkVgNodeBase* node, pickedNodes)
     {
-    findNodeVisitor.SetUsingProp3D(prop);
-
-    this->ContextVideoRoot->Accept(findNodeVisitor);
+    // Only select video nodes that are results shown on the context.
+    if (!dynamic_cast<vtkVgVideoNode*>(node))
+      {
+      continue;
+      }
 
-    vtkVgNodeBase* node = findNodeVisitor.GetNode();
-    vtkVgVideoNode* videoNode = dynamic_cast<vtkVgVideoNode*>(node);
+    vtkVgNodeBase* ancestor = node->GetParent();
+    while (ancestor && ancestor != this->ContextVideoRoot.GetPointer())
+      {
+      ancestor = ancestor->GetParent();
+      }
 
-    // If this is a video node and not already existed in list.
-    if (videoNode && !selectedNodes.contains(node))
+    if (ancestor)
       {
       selectedNodes.push_back(node);
       }
-
-    prop = propCollection->GetNextProp3D();
     }
 
   this->selectNodes(selectedNodes);
@@ -1374,6 +1366,12 @@ void vqCore::addRasterLayer(QUrl uri)
     this->TerrainSource = vtkVgTerrainSource::SmartPtr::New();
     this->TerrainSource->SetDataSource(uri.toEncoded().constData());
 
+    // Load imagery in the background while panning and zooming, and render
+    // again as it arrives
+    this->TerrainSource->SetAsynchronous(true);
+    vtkConnect(this->TerrainSource, vtkCommand::UpdateDataEvent,
+               this, SLOT(postRender()));
+
     // Add the context to the main viewer scene.
     vtkSmartPointer<vtkVgTerrain> terrain
       = this->TerrainSource->CreateTerrain();
@@ -3219,6 +3217,61 @@ static bool eventEarlierThan(vtkVgVideoNode* a, vtkVgVideoNode* b)
   return a->GetTimeRange()[0] < b->GetTimeRange()[0];
 }
 
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+struct ReportClip
+{
+  explicit ReportClip(const QUrl& uri) : Uri(uri) {}
+
+  const QUrl Uri;
+
+  // Loaded on first use by a worker; sub-clips taken from the clip share its
+  // stream, so any read of image data must hold the mutex
+  QScopedPointer<vgKwaVideoClip> Clip;
+  QMutex Mutex;
+};
+
+//-----------------------------------------------------------------------------
+struct ReportItem
+{
+  vtkVgVideoNode* Node;
+  vtkVgEvent* Event;
+  int OutputId;
+  vtkVgTimeStamp MidTime;
+
+  std::shared_ptr<ReportClip> Clip;
+  vqArchiveVideoSource::SmartPtr Video;
+  vtkVgVideoFrameData Frame;
+  QFuture<bool> FrameReady;
+};
+
+//-----------------------------------------------------------------------------
+bool fetchReportFrame(ReportItem* item)
+{
+  // Items from the same source share one loaded clip, from which each takes
+  // its own sub-clip; the clip is only read by one thread at a time
+  QMutexLocker lock(&item->Clip->Mutex);
+
+  if (!item->Clip->Clip)
+    {
+    item->Clip->Clip.reset(new vgKwaVideoClip(item->Clip->Uri));
+    }
+
+  if (item->Video->AcquireVideoClip(*item->Clip->Clip,
+                                    item->Clip->Uri) != VTK_OK ||
+      !item->Video->HasVideoClip())
+    {
+    return false;
+    }
+
+  return (item->Video->GetFrame(&item->Frame, item->MidTime.GetTime()) ==
+          VTK_OK);
+}
+
+} // namespace <anonymous>
+
 //-----------------------------------------------------------------------------
 void vqCore::generateReport(QString path, bool generateVideo)
 {
@@ -3232,10 +3285,10 @@ void vqCore::generateReport(QString path, bool generateVideo)
     return;
     }
 
-  vvReportWriter writer(file);
+  QElapsedTimer timer;
+  timer.start();
 
-  vtkSmartPointer<vqArchiveVideoSource> video =
-    vtkSmartPointer<vqArchiveVideoSource>::New();
+  vvReportWriter writer(file);
 
   vtkSmartPointer<vtkVgTerrainSource> terrainSrc;
   vtkSmartPointer<vtkVgTerrain> terrain;
@@ -3292,12 +3345,11 @@ void vqCore::generateReport(QString path, bool generateVideo)
 
   QApplication::processEvents();
 
-  vtkVgVideoFrameData frame;
-
-  vtkSmartPointer<vtkMatrix4x4> trackModelToImage =
-    vtkSmartPointer<vtkMatrix4x4>::New();
-
-  int count = 0;
+  // Determine the results to be reported, and the time of the summary frame
+  // for each, up front, so that the frames can be fetched in the background
+  // while earlier results are being written
+  std::vector<std::unique_ptr<ReportItem> > items;
+  QHash<QUrl, std::shared_ptr<ReportClip> > clips;
   int currId = 1;
   foreach (vtkVgVideoNode* node, nodes)
     {
@@ -3309,13 +3361,9 @@ void vqCore::generateReport(QString path, bool generateVideo)
     vtkVgVideoModel0* vm = node->GetVideoRepresentation()->GetVideoModel();
     vtkVgEventModel* em = vm->GetEventModel();
 
-    if (vqArchiveVideoSource* src =
-          vqArchiveVideoSource::SafeDownCast(vm->GetVideoSource()))
-      {
-      video->DeepCopy(*src, vqArchiveVideoSource::CopyClipShared);
-      video->SetLooping(0);
-      }
-    else
+    vqArchiveVideoSource* src =
+      vqArchiveVideoSource::SafeDownCast(vm->GetVideoSource());
+    if (!src)
       {
       qDebug() << "Unknown video source.";
       continue;
@@ -3328,9 +3376,7 @@ void vqCore::generateReport(QString path, bool generateVideo)
       continue;
       }
 
-    writer.setEvent(event, currId++, node->GetNote(), 0,
-                    node->GetRank(), node->GetRelevancyScore(),
-                    node->GetMissionId(), node->GetStreamId());
+    const int outputId = currId++;
 
     vtkVgTimeStamp start = event->GetStartFrame();
     vtkVgTimeStamp end = event->GetEndFrame();
@@ -3353,70 +3399,167 @@ void vqCore::generateReport(QString path, bool generateVideo)
       continue;
       }
 
-    if (video->GetFrame(&frame, mid.GetTime()) == VTK_OK)
-      {
-      writer.setImageData(frame.VideoImage,
-                          frame.TimeStamp, 0,
-                          frame.VideoMatrix);
+    std::unique_ptr<ReportItem> item(new ReportItem);
+    item->Node = node;
+    item->Event = event;
+    item->OutputId = outputId;
+    item->MidTime = mid;
 
-      vtkVgTrack* track =
-        this->TrackNode->GetTrackModel()->GetTrack(event->GetId());
-      if (track && frame.VideoMatrix)
-        {
-        // Compute the image-to-context matrix then invert it to get the
-        // track-to-image transform (track points are in context space).
-        vtkMatrix4x4::Multiply4x4(
-          this->TerrainSource->GetCoordinateTransformMatrix(),
-          frame.VideoMatrix, trackModelToImage);
-        trackModelToImage->Invert();
-
-        writer.setTrack(track, trackModelToImage);
-        }
-      else
-        {
-        writer.setTrack(0);
-        }
+    // Consecutive results are typically from the same stream, so load each
+    // clip only once and share it among the items that use it
+    std::shared_ptr<ReportClip>& clip = clips[src->GetClipUri()];
+    if (!clip)
+      {
+      clip = std::make_shared<ReportClip>(src->GetClipUri());
+      }
+    item->Clip = clip;
 
-      writer.writeEventSummary();
+    // Request the same time range and padding as the source clip; the first
+    // time mark holds the range that the source originally requested
+    const std::vector<std::pair<double, double> > marks = src->GetTimeMarks();
+    item->Video = vqArchiveVideoSource::SmartPtr::New();
+    if (marks.empty())
+      {
+      item->Video->SetTimeRange(src->GetTimeRange());
       }
     else
+      {
+      item->Video->SetTimeRange(marks.front().first, marks.front().second);
+      }
+    item->Video->SetRequestedPadding(src->GetRequestedPadding());
+    item->Video->SetLooping(0);
+
+    items.push_back(std::move(item));
+    }
+
+  // Fetch (seek and decode) summary frames on a worker pool, staying a bounded
+  // number of items ahead of the items being written in order to limit the
+  // number of decoded frames held in memory at once; note that the pool must
+  // be destroyed (which waits for any pending fetches) before the items
+  QThreadPool pool;
+  const size_t lookahead = static_cast<size_t>(2 * pool.maxThreadCount());
+  size_t fetched = 0;
+
+  vtkSmartPointer<vtkMatrix4x4> trackModelToImage =
+    vtkSmartPointer<vtkMatrix4x4>::New();
+
+  int count = 0;
+  for (size_t i = 0; i < items.size(); ++i)
+    {
+    for (; fetched < items.size() && fetched < i + lookahead; ++fetched)
+      {
+      ReportItem* const item = items[fetched].get();
+      item->FrameReady = QtConcurrent::run(&pool, fetchReportFrame, item);
+      }
+
+    ReportItem& item = *items[i];
+    vtkVgVideoNode* node = item.Node;
+    vtkVgEvent* event = item.Event;
+
+    writer.setEvent(event, item.OutputId, node->GetNote(), 0,
+                    node->GetRank(), node->GetRelevancyScore(),
+                    node->GetMissionId(), node->GetStreamId());
+
+    if (!item.FrameReady.result())
       {
       qDebug() << "Could not get midpoint frame.";
+      items[i].reset();
       continue;
       }
 
+    vtkVgVideoFrameData& frame = item.Frame;
+    writer.setImageData(frame.VideoImage,
+                        frame.TimeStamp, 0,
+                        frame.VideoMatrix);
+
+    vtkVgTrack* track =
+      this->TrackNode->GetTrackModel()->GetTrack(event->GetId());
+    if (track && frame.VideoMatrix)
+      {
+      // Compute the image-to-context matrix then invert it to get the
+      // track-to-image transform (track points are in context space).
+      vtkMatrix4x4::Multiply4x4(
+        this->TerrainSource->GetCoordinateTransformMatrix(),
+        frame.VideoMatrix, trackModelToImage);
+      trackModelToImage->Invert();
+
+      writer.setTrack(track, trackModelToImage);
+      }
+    else
+      {
+      writer.setTrack(0);
+      }
+
+    writer.writeEventSummary();
+
     // If not generating video, we're done
     if (!generateVideo)
       {
+      items[i].reset();
+      if (progress.wasCanceled())
+        {
+        break;
+        }
       progress.setValue(++count);
       continue;
       }
 
-    // Write video images
-    video->GetFrame(&frame, start.GetTime());
+    // Write video images; each frame is decoded on a worker thread while the
+    // previous one is rendered
+    vqArchiveVideoSource* const video = item.Video;
+    QMutex* const mutex = &item.Clip->Mutex;
+    vtkVgTimeStamp end = event->GetEndFrame();
+    mutex->lock();
+    video->GetFrame(&frame, event->GetStartFrame().GetTime());
+    mutex->unlock();
+
     int framenum = 0;
-    do
+    bool canceled = false;
+    forever
       {
+      vtkVgVideoFrameData next;
+      QFuture<int> nextResult = QtConcurrent::run(
+        &pool, [video, mutex, &next]{
+          QMutexLocker lock(mutex);
+          return video->GetNextFrame(&next);
+          });
+
       writer.setImageData(frame.VideoImage,
                           frame.TimeStamp, 0,
                           frame.VideoMatrix);
       writer.writeEventVideoImage(++framenum);
-      if (progress.wasCanceled())
+
+      canceled = progress.wasCanceled();
+      if (!canceled)
+        {
+        progress.setValue(++count);
+        }
+
+      if (nextResult.result() != VTK_OK || canceled ||
+          !(next.TimeStamp <= end))
         {
         break;
         }
-      progress.setValue(++count);
+      frame = next;
       }
-    while (video->GetNextFrame(&frame) == VTK_OK && frame.TimeStamp <= end);
 
     // Encode video from images
     writer.writeEventVideo();
+    items[i].reset();
+
+    if (canceled)
+      {
+      break;
+      }
     }
 
   writer.writeOverview();
 
   // Now export KML
   this->exportKml(path);
+
+  qDebug() << "Generated report for" << items.size() << "result(s) in"
+           << timer.elapsed() << "ms";
 }
 
 //-----------------------------------------------------------------------------
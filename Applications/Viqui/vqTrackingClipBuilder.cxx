@@ -8,7 +8,9 @@
 
 #include <qtGlobal.h>
 
+#include <QFuture>
 #include <QMutexLocker>
+#include <QtConcurrentRun>
 
 #include <algorithm>
 
@@ -93,6 +95,12 @@ void vqTrackingClipBuilder::SkipClip(int id)
   }
 }
 
+//-----------------------------------------------------------------------------
+void vqTrackingClipBuilder::SetThreadCount(int count)
+{
+  this->Pool.setMaxThreadCount(qMax(1, count));
+}
+
 //-----------------------------------------------------------------------------
 void vqTrackingClipBuilder::Shutdown()
 {
@@ -114,33 +122,75 @@ void vqTrackingClipBuilder::run()
         break;
       }
 
-      for (const auto& clip : this->Clips[i])
+      // Build the clips in parallel. Each clip has its own (detached) copy of
+      // the video source and event, so the clips do not share any state.
+      const size_t count = this->Clips[i].size();
+      std::vector<QFuture<vtkImageData*>> futures;
+      std::vector<int> ids(count, -1);
+      futures.reserve(count);
+      for (size_t k = 0; k < count; ++k)
       {
-        if (this->ShutdownRequested)
-        {
-          return;
-        }
+        const ClipElement& clip = this->Clips[i][k];
+        int& id = ids[k];
+        futures.push_back(QtConcurrent::run(&this->Pool, [this, &clip, &id]{
+          return this->BuildClip(clip, id);
+        }));
+      }
 
-        int id;
-        synchronized (&this->ClipIdMutex)
+      // Deliver the clips from this thread, in the order they were queued, as
+      // each becomes available; the pool runs tasks in the same order, so
+      // the remaining clips continue to build meanwhile
+      for (size_t k = 0; k < count; ++k)
+      {
+        vtkImageData* const output = futures[k].result();
+        if (!output)
         {
-          id = clip.first;
+          continue;
         }
-
-        if (id >= 0)
+        if (this->ShutdownRequested)
         {
-          vtkImageData* output = clip.second->GetOutputImageData();
-
-          // Caller will need to Delete() the image data once it has been
-          // received. This is to ensure the data keeps a reference count > 0
-          // between the time when the signal is emitted until it is received.
-          output->Register(0);
-
-          emit this->ClipAvailable(output, id);
+          output->Delete();
+          continue;
         }
+        emit this->ClipAvailable(output, ids[k]);
+      }
+
+      if (this->ShutdownRequested)
+      {
+        return;
       }
 
       this->Clips[i].clear();
     }
   }
 }
+
+//-----------------------------------------------------------------------------
+vtkImageData* vqTrackingClipBuilder::BuildClip(
+  const ClipElement& clip, int& id)
+{
+  if (this->ShutdownRequested)
+  {
+    return 0;
+  }
+
+  synchronized (&this->ClipIdMutex)
+  {
+    id = clip.first;
+  }
+
+  if (id < 0)
+  {
+    return 0;
+  }
+
+  vtkImageData* const output = clip.second->GetOutputImageData();
+  if (output)
+  {
+    // Caller will need to Delete() the image data once it has been
+    // received. This is to ensure the data keeps a reference count > 0
+    // between the time when the signal is emitted until it is received.
+    output->Register(0);
+  }
+  return output;
+}
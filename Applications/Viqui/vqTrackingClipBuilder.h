@@ -9,6 +9,7 @@
 
 #include <QMutex>
 #include <QThread>
+#include <QThreadPool>
 
 #include <array>
 #include <atomic>
@@ -31,14 +32,23 @@ public:
 
   void SkipClip(int id);
 
+  // Set the maximum number of clips that will be built concurrently; by
+  // default, this is the number of processor cores
+  void SetThreadCount(int count);
+
   void Shutdown();
 
 signals:
+  // Emitted from the builder thread for each clip that is built, in the order
+  // in which clips are queued for building (shortest first); the receiver
+  // must Delete() the clip
   void ClipAvailable(vtkImageData* clip, int index);
 
 protected:
   virtual void run() override;
 
+  vtkImageData* BuildClip(const ClipElement& clip, int& id);
+
 private:
   std::atomic<bool> ShutdownRequested{false};
 
@@ -46,6 +56,8 @@ private:
   std::array<QMutex, 2> ClipsMutex;
 
   QMutex ClipIdMutex;
+
+  QThreadPool Pool;
 };
 
 #endif // __vqTrackingClipBuilder_h
@@ -37,13 +37,192 @@
 // STL includes.
 #include <vector>
 #include <algorithm>
+#include <cmath>
 #include <map>
+#include <set>
 #include <sstream>
+#include <unordered_map>
 
 vtkStandardNewMacro(vtkVQBlastLayoutNode);
 
 const double vtkVQBlastLayoutNode::MinDelta  = 10.0;
 
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+// Test if two 2D bounds (xmin, xmax, ymin, ymax) intersect. Touching bounds
+// intersect, and uninitialized bounds never intersect anything.
+bool BoundsIntersect(const double* a, const double* b)
+{
+  return a[0] <= a[1] && a[2] <= a[3] && b[0] <= b[1] && b[2] <= b[3] &&
+         a[0] <= b[1] && b[0] <= a[1] && a[2] <= b[3] && b[2] <= a[3];
+}
+
+//-----------------------------------------------------------------------------
+// Uniform grid over 2D node bounds, used to find the nodes near a region
+// without testing against every node. Bounds that are uninitialized, or too
+// large to bin, are kept in a separate list that is always searched.
+class BoundsIndex
+{
+public:
+  explicit BoundsIndex(double cellSize) : CellSize(cellSize) {}
+
+  // Add bounds (only the first four values are used); returns the id of the
+  // new entry, which is the number of entries previously added
+  int Insert(const double* bounds);
+
+  // Get the ids of entries that may intersect the given bounds. The result
+  // may contain false positives and duplicates.
+  void FindCandidates(const double* bounds, std::vector<int>& ids) const;
+
+  // Test if any entry intersects the given bounds
+  bool Intersects(const double* bounds) const;
+
+protected:
+  static const long long MaxCellSpan = 64;
+  static const long long MaxCellIndex = 1LL << 30;
+
+  bool GetCellRange(const double* bounds, long long range[4]) const;
+
+  static long long CellKey(long long i, long long j)
+    {
+    return (i << 32) ^ (j & 0xffffffffLL);
+    }
+
+  double CellSize;
+  std::vector<double> Bounds;
+  std::unordered_map<long long, std::vector<int> > Cells;
+  std::vector<int> Unbinned;
+};
+
+//-----------------------------------------------------------------------------
+bool BoundsIndex::GetCellRange(const double* bounds, long long range[4]) const
+{
+  if (!(bounds[0] <= bounds[1] && bounds[2] <= bounds[3]))
+    {
+    return false;
+    }
+
+  double cells[4];
+  for (int k = 0; k < 4; ++k)
+    {
+    cells[k] = std::floor(bounds[k] / this->CellSize);
+    if (!(std::fabs(cells[k]) < MaxCellIndex))
+      {
+      return false;
+      }
+    range[k] = static_cast<long long>(cells[k]);
+    }
+
+  return (range[1] - range[0] < MaxCellSpan &&
+          range[3] - range[2] < MaxCellSpan);
+}
+
+//-----------------------------------------------------------------------------
+int BoundsIndex::Insert(const double* bounds)
+{
+  const int id = static_cast<int>(this->Bounds.size() / 4);
+  this->Bounds.insert(this->Bounds.end(), bounds, bounds + 4);
+
+  long long range[4];
+  if (!this->GetCellRange(bounds, range))
+    {
+    this->Unbinned.push_back(id);
+    return id;
+    }
+
+  for (long long i = range[0]; i <= range[1]; ++i)
+    {
+    for (long long j = range[2]; j <= range[3]; ++j)
+      {
+      this->Cells[CellKey(i, j)].push_back(id);
+      }
+    }
+
+  return id;
+}
+
+//-----------------------------------------------------------------------------
+void BoundsIndex::FindCandidates(
+  const double* bounds, std::vector<int>& ids) const
+{
+  ids.insert(ids.end(), this->Unbinned.begin(), this->Unbinned.end());
+
+  long long range[4];
+  if (!this->GetCellRange(bounds, range))
+    {
+    // Query is too large (or invalid) to use the grid; return everything
+    for (const auto& cell : this->Cells)
+      {
+      ids.insert(ids.end(), cell.second.begin(), cell.second.end());
+      }
+    return;
+    }
+
+  for (long long i = range[0]; i <= range[1]; ++i)
+    {
+    for (long long j = range[2]; j <= range[3]; ++j)
+      {
+      const auto iter = this->Cells.find(CellKey(i, j));
+      if (iter != this->Cells.end())
+        {
+        ids.insert(ids.end(), iter->second.begin(), iter->second.end());
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool BoundsIndex::Intersects(const double* bounds) const
+{
+  long long range[4];
+  if (!this->GetCellRange(bounds, range))
+    {
+    std::vector<int> ids;
+    this->FindCandidates(bounds, ids);
+    for (const int id : ids)
+      {
+      if (BoundsIntersect(&this->Bounds[4 * id], bounds))
+        {
+        return true;
+        }
+      }
+    return false;
+    }
+
+  for (const int id : this->Unbinned)
+    {
+    if (BoundsIntersect(&this->Bounds[4 * id], bounds))
+      {
+      return true;
+      }
+    }
+
+  for (long long i = range[0]; i <= range[1]; ++i)
+    {
+    for (long long j = range[2]; j <= range[3]; ++j)
+      {
+      const auto iter = this->Cells.find(CellKey(i, j));
+      if (iter == this->Cells.end())
+        {
+        continue;
+        }
+      for (const int id : iter->second)
+        {
+        if (BoundsIntersect(&this->Bounds[4 * id], bounds))
+          {
+          return true;
+          }
+        }
+      }
+    }
+
+  return false;
+}
+
+} // namespace <anonymous>
+
 //-----------------------------------------------------------------------------
 class vtkVQBlastLayoutNode::vtkInternal
 {
@@ -57,8 +236,6 @@ public:
     std::vector<double>     NodeBounds;
     };
 
-  bool                                  Repeat;
-
   int                                   InstanceColorIndex;
 
   static int                            ColorIndex;
@@ -79,6 +256,7 @@ public:
   SortedStack;
   std::multimap<long long, vtkVgVideoNode*>::iterator
   StackPositionIter;
+  std::set<vtkVgVideoNode*>             StackNodes;
 
   // NOTE: We could use same sorted list of video nodes in the future.
   std::multimap<long long, vtkVgVideoNode::SmartPtr>
@@ -87,25 +265,8 @@ public:
 
   // Description:
   // Helper functions.
-  void MakeNonIntersectBounds(double delta[3], vtkBoundingBox& bb1,
-                              vtkBoundingBox& bb2, double newNodeBounds[6],
-                              double translation[3], bool& newBounds);
-
-  void DoBlast(vtkVgNodeBase::SmartPtr node,
-               std::vector<vtkVgTransformNode*>& otherNodes, int index,
-               double delta[3], double nodeBounds[6], double translation[3]);
-
-  void DoBlast(vtkVgNodeBase::SmartPtr node,
-               std::vector<vtkVgNodeBase::SmartPtr>& otherNodes, double delta[3],
-               double nodeBounds[6], double translation[3]);
-
-  void DoBlast(vtkVgNodeBase::SmartPtr node,
-               std::vector< std::vector<double> >& otherNodeBounds,
-               double delta[3], double nodeBounds[6], double translation[3]);
-
-  void DoBlast(vtkVgNodeBase::SmartPtr node,
-               std::vector<NewNodeBoundData>& otherNodeBounds, double delta[3],
-               double nodeBounds[6], double translation[3]);
+  void DoBlast(vtkVgTransformNode* node, BoundsIndex& obstacles,
+               const double delta[3], double translation[3]);
 
   vtkVgGeode::SmartPtr
   CreateConnectingNodes(
@@ -139,8 +300,6 @@ double vtkVQBlastLayoutNode::vtkInternal::Colors [MaxNumberOfColors][3] =
 //-----------------------------------------------------------------------------
 vtkVQBlastLayoutNode::vtkInternal::vtkInternal()
 {
-  this->Repeat          = false;
-
   this->InstanceColorIndex  = (++this->ColorIndex) % MaxNumberOfColors;
 
   this->CachedMatrix    = 0;
@@ -157,179 +316,37 @@ vtkVQBlastLayoutNode::vtkInternal::~vtkInternal()
 }
 
 //-----------------------------------------------------------------------------
-void vtkVQBlastLayoutNode::vtkInternal::MakeNonIntersectBounds(double delta[3],
-    vtkBoundingBox& bb1,
-    vtkBoundingBox& bb2,
-    double newNodeBounds[6],
-    double translation[3],
-    bool& newBounds)
-
+void vtkVQBlastLayoutNode::vtkInternal::DoBlast(
+  vtkVgTransformNode* node, BoundsIndex& obstacles, const double delta[3],
+  double translation[3])
 {
-  newBounds = false;
+  // Move the node until it no longer collides with any of the obstacles.
+  // Obstacles include the node's own original position, so the node always
+  // moves at least once.
+  double* bounds = node->GetBounds();
+  std::vector<double> newBounds(bounds, bounds + 6);
 
-  while (bb1.Intersects(bb2))
+  translation[0] = translation[1] = translation[2] = 0.0;
+  while (obstacles.Intersects(&newBounds[0]))
     {
-    newNodeBounds[0] += delta[0];
-    newNodeBounds[1] += delta[0];
-    newNodeBounds[2] += delta[1];
-    newNodeBounds[3] += delta[1];
-
-    bb1.SetBounds(&newNodeBounds[0]);
+    newBounds[0] += delta[0];
+    newBounds[1] += delta[0];
+    newBounds[2] += delta[1];
+    newBounds[3] += delta[1];
 
     translation[0] += delta[0];
     translation[1] += delta[1];
-
-    newBounds = true;
     }
-}
-
-//-----------------------------------------------------------------------------
-void vtkVQBlastLayoutNode::vtkInternal::DoBlast(
-  vtkVgNodeBase::SmartPtr vtkNotUsed(node),
-  std::vector<vtkVgTransformNode*>& otherNodes,
-  int index, double delta[3], double nodeBounds[6], double translation[3])
-{
-  // Check if this node is colliding against other nodes.
-  // If it is move the node until its not colliding.
-  int numberOfOtherNodes = static_cast<int>(otherNodes.size());
-
-  vtkBoundingBox bb1;
-  bb1.SetBounds(nodeBounds[0], nodeBounds[1], nodeBounds[2], nodeBounds[3], 0, 0);
 
-  for (int j = (index + 1); j < numberOfOtherNodes; ++j)
+  if (fabs(translation[0]) > 0.0 || fabs(translation[1]) > 0.0)
     {
-    bool newBounds = false;
-
-    vtkBoundingBox bb2;
-    double* bounds = otherNodes[j]->GetBounds();
-    bb2.SetBounds(bounds[0], bounds[1], bounds[2], bounds[3], 0, 0);
-
-    this->MakeNonIntersectBounds(delta,
-                                 bb1,
-                                 bb2,
-                                 nodeBounds,
-                                 translation,
-                                 newBounds);
+    NewNodeBoundData newNodeBoundData;
+    newNodeBoundData.Node = node;
+    newNodeBoundData.NodeBounds = newBounds;
+    this->NewNodeBounds.push_back(newNodeBoundData);
 
-    if (newBounds)
-      {
-      this->Repeat = true;
-      bb1.SetBounds(nodeBounds);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-void vtkVQBlastLayoutNode::vtkInternal::DoBlast(
-  vtkVgNodeBase::SmartPtr vtkNotUsed(node),
-  std::vector<vtkVgNodeBase::SmartPtr>& otherNodes,
-  double delta[3], double nodeBounds[6], double translation[3])
-{
-  // Check if this node is colliding against other nodes.
-  // If it is move the node until its not colliding.
-  int numberOfOtherNodes = static_cast<int>(otherNodes.size());
-
-  vtkBoundingBox bb1;
-  bb1.SetBounds(nodeBounds[0], nodeBounds[1], nodeBounds[2], nodeBounds[3], 0, 0);
-
-  for (int j = 0; j < numberOfOtherNodes; ++j)
-    {
-    bool newBounds = false;
-
-    vtkBoundingBox bb2;
-    double* bounds = otherNodes[j]->GetBounds();
-    bb2.SetBounds(bounds[0], bounds[1], bounds[2], bounds[3], 0, 0);
-
-    this->MakeNonIntersectBounds(delta,
-                                 bb1,
-                                 bb2,
-                                 nodeBounds,
-                                 translation,
-                                 newBounds);
-
-    if (newBounds)
-      {
-      this->Repeat = true;
-      bb1.SetBounds(nodeBounds);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-void vtkVQBlastLayoutNode::vtkInternal::DoBlast(
-  vtkVgNodeBase::SmartPtr vtkNotUsed(node),
-  std::vector< std::vector<double> >& otherNodeBounds,
-  double delta[3], double nodeBounds[3], double translation[3])
-{
-  // Check if this node is colliding against other nodes.
-  // If it is move the node until its not colliding.
-  int numberOfOtherBounds = static_cast<int>(otherNodeBounds.size());
-
-  vtkBoundingBox bb1;
-  bb1.SetBounds(nodeBounds[0], nodeBounds[1], nodeBounds[2], nodeBounds[3], 0, 0);
-
-  for (int j = 0; j < numberOfOtherBounds; ++j)
-    {
-    bool newBounds = false;
-
-    vtkBoundingBox bb2;
-    bb2.SetBounds(otherNodeBounds[j][0], otherNodeBounds[j][1],
-                  otherNodeBounds[j][2], otherNodeBounds[j][3], 0, 0);
-
-    this->MakeNonIntersectBounds(delta,
-                                 bb1,
-                                 bb2,
-                                 nodeBounds,
-                                 translation,
-                                 newBounds);
-
-    if (newBounds)
-      {
-      this->Repeat = true;
-      bb1.SetBounds(nodeBounds);
-      }
-    }
-}
-
-//-----------------------------------------------------------------------------
-void vtkVQBlastLayoutNode::vtkInternal::DoBlast(vtkVgNodeBase::SmartPtr node,
-                                                std::vector<NewNodeBoundData>& otherNodeBounds, double delta[3],
-                                                double nodeBounds[3], double translation[3])
-{
-  // Check if this node is colliding against other nodes.
-  // If it is move the node until its not colliding.
-  int numberOfOtherBounds = static_cast<int>(otherNodeBounds.size());
-
-  vtkBoundingBox bb1;
-  bb1.SetBounds(nodeBounds[0], nodeBounds[1], nodeBounds[2], nodeBounds[3], 0, 0);
-
-//  bool addNewBound = false;
-
-  for (int j = 0; j < numberOfOtherBounds; ++j)
-    {
-    if (node == otherNodeBounds[j].Node)
-      {
-      continue;
-      }
-
-    bool newBounds = false;
-
-    vtkBoundingBox bb2;
-    bb2.SetBounds(otherNodeBounds[j].NodeBounds[0], otherNodeBounds[j].NodeBounds[1],
-                  otherNodeBounds[j].NodeBounds[2], otherNodeBounds[j].NodeBounds[3], 0, 0);
-
-    this->MakeNonIntersectBounds(delta,
-                                 bb1,
-                                 bb2,
-                                 nodeBounds,
-                                 translation,
-                                 newBounds);
-
-    if (newBounds)
-      {
-      this->Repeat = true;
-      bb1.SetBounds(nodeBounds);
-      }
+    // Nodes placed later must also avoid this node's new position
+    obstacles.Insert(&newBounds[0]);
     }
 }
 
@@ -467,6 +484,18 @@ void vtkVQBlastLayoutNode::SetLayoutMode(int mode)
     return;
     }
 
+  // If the requested layout is already pending (that is, it has been
+  // requested but not yet applied), the previous layout has already been
+  // undone and there is nothing to do; this makes repeated requests (e.g.
+  // as nodes are added) cheap
+  if (mode == this->LayoutMode &&
+      ((mode == STACK && this->Stack) ||
+       (mode == Z_SORT && this->ZSort) ||
+       (mode == BLAST && this->Blast)))
+    {
+    return;
+    }
+
   if (this->LayoutMode == STACK)
     {
     this->UndoStackLayout();
@@ -501,6 +530,9 @@ void vtkVQBlastLayoutNode::SetLayoutMode(int mode)
     }
 
   this->LayoutMode = mode;
+
+  // The layout is applied by the next update
+  this->RequestUpdate();
 }
 
 //-----------------------------------------------------------------------------
@@ -576,10 +608,10 @@ void vtkVQBlastLayoutNode::RestoreFocusedNodePosition()
 //-----------------------------------------------------------------------------
 void vtkVQBlastLayoutNode::SetChildrenVisible(int visible)
 {
-  int numberOfChildren = this->GetNumberOfChildren();
-  for (int i = 0; i < numberOfChildren; ++i)
+  const std::vector<vtkVgNodeBase::SmartPtr> children = this->GetChildren();
+  for (size_t i = 0, k = children.size(); i < k; ++i)
     {
-    if (vtkVgNodeBase* node = this->GetChild(i))
+    if (vtkVgNodeBase* node = children[i])
       {
       node->SetVisible(visible);
       }
@@ -739,16 +771,9 @@ bool vtkVQBlastLayoutNode::IsCoincidental(double bounds1[6], double bounds2[6])
 //-----------------------------------------------------------------------------
 void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
 {
-// First find all the video with exact same bound center as this node.
-  std::vector<vtkVgTransformNode*> coincidentalNodes;
-  std::vector<vtkVgTransformNode*> overlappingNodes;
-
   this->Implementation->NewNodeBounds.clear();
-  this->Implementation->Repeat = false;
   this->Implementation->ConnectingNodes.clear();
 
-  int numberOfChildren = this->GetNumberOfChildren();
-
   this->Superclass::TraverseChildren(nodeVisitor);
 
   if (this->GetBoundsDirty())
@@ -756,10 +781,63 @@ void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
     this->ComputeBounds();
     }
 
+  // Get the video transforms; fetch these all at once, as looking up
+  // children by index is linear in the index.
+  std::vector<vtkVgTransformNode*> transformNodes;
+  const std::vector<vtkVgNodeBase::SmartPtr> children = this->GetChildren();
+  for (size_t i = 0, k = children.size(); i < k; ++i)
+    {
+    if (vtkVgTransformNode* transformNode =
+          dynamic_cast<vtkVgTransformNode*>(children[i].GetPointer()))
+      {
+      transformNodes.push_back(transformNode);
+      }
+    }
+  const int numberOfChildren = static_cast<int>(transformNodes.size());
+
+  // Find a distance seed for the blast. This is also used as the cell size of
+  // the spatial indices, as it is roughly the size of a node.
+  const double someFactor = 1.2;
+
+  double blastDistnace = MinDelta;
+
+  for (int i = 0; i < numberOfChildren; ++i)
+    {
+    vtkVgTransformNode* videoTransform = transformNodes[i];
+    if (videoTransform->GetNumberOfChildren())
+      {
+      double* nodeBounds = videoTransform->GetChild(0)->GetBounds();
+      double distance = (nodeBounds[1] - nodeBounds[0]) * someFactor;
+
+      if (distance > 0.0)
+        {
+        blastDistnace = distance;
+        break;
+        }
+      }
+    }
+
+  const double cellSize =
+    (blastDistnace < VTK_DOUBLE_MAX ? blastDistnace : MinDelta);
+
+  // Find all the videos with exactly the same bounds as some other video
+  // ("coincidental" nodes); the rest are (possibly) just overlapping. Use a
+  // spatial index over the node bounds so that each node is only compared to
+  // nodes near it.
+  BoundsIndex childIndex(cellSize);
   for (int i = 0; i < numberOfChildren; ++i)
     {
-    vtkVgTransformNode* transformNode1 =
-      dynamic_cast<vtkVgTransformNode*>(this->GetChild(i));
+    childIndex.Insert(transformNodes[i]->GetBounds());
+    }
+
+  std::vector<vtkVgTransformNode*> coincidentalNodes;
+  std::vector<vtkVgTransformNode*> overlappingNodes;
+  std::vector<bool> isCoincidental(numberOfChildren, false);
+  std::vector<int> candidates;
+
+  for (int i = 0; i < numberOfChildren; ++i)
+    {
+    vtkVgTransformNode* transformNode1 = transformNodes[i];
 
     // If the video transform or its video is not visible ignore it.
     if (!transformNode1->GetVisible() || (transformNode1->GetChild(0)
@@ -770,57 +848,105 @@ void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
 
     double* bounds1 = transformNode1->GetBounds();
 
-    for (int j = (i + 1); j < this->GetNumberOfChildren(); ++j)
-      {
-      vtkVgTransformNode* transformNode2 =
-        dynamic_cast<vtkVgTransformNode*>(this->GetChild(j));
+    // Visit candidates in order, so that the order in which coincidental
+    // nodes are found (and therefore the layout) is deterministic
+    candidates.clear();
+    childIndex.FindCandidates(bounds1, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
 
-      double* bounds2 = transformNode2->GetBounds();
+    for (size_t n = 0; n < candidates.size(); ++n)
+      {
+      const int j = candidates[n];
+      if (j <= i)
+        {
+        continue;
+        }
 
-      if (this->IsCoincidental(bounds1, bounds2))
+      if (this->IsCoincidental(bounds1, transformNodes[j]->GetBounds()))
         {
-        if (std::find(coincidentalNodes.begin(), coincidentalNodes.end(),
-                      transformNode1) == coincidentalNodes.end())
+        if (!isCoincidental[i])
           {
+          isCoincidental[i] = true;
           coincidentalNodes.push_back(transformNode1);
           }
-        if (std::find(coincidentalNodes.begin(),
-                      coincidentalNodes.end(), transformNode2) == coincidentalNodes.end())
+        if (!isCoincidental[j])
           {
-          coincidentalNodes.push_back(transformNode2);
+          isCoincidental[j] = true;
+          coincidentalNodes.push_back(transformNodes[j]);
           }
         }
       }
 
-    if (std::find(coincidentalNodes.begin(),
-                  coincidentalNodes.end(), transformNode1) == coincidentalNodes.end())
+    if (!isCoincidental[i])
       {
       overlappingNodes.push_back(transformNode1);
       }
     }
-// Now we have exact overlapping nodes and just overlapping nodes,
-// we need to find a random distance seed.
-  const double someFactor = 1.2;
 
-  double blastDistnace = MinDelta;
+  // Build the set of obstacles that blasted nodes must avoid. This is the
+  // scene nodes (and their original positions), the original positions of
+  // the nodes being blasted (so that even the last node moves out), and the
+  // new positions of nodes that have already been moved (which are added as
+  // the nodes are moved).
+  BoundsIndex obstacles(cellSize);
+
+  const int numberOfSceneNodes =
+    static_cast<int>(this->Implementation->SceneNodes.size());
+  for (int i = 0; i < numberOfSceneNodes; ++i)
+    {
+    obstacles.Insert(this->Implementation->SceneNodes[i]->GetBounds());
+    }
+
+  const int numberOfOriginalBounds =
+    static_cast<int>(this->Implementation->OriginalNodeBounds.size());
+  for (int i = 0; i < numberOfOriginalBounds; ++i)
+    {
+    obstacles.Insert(&this->Implementation->OriginalNodeBounds[i][0]);
+    }
+
+  int numberOfOverlappingNodes  = static_cast<int>(overlappingNodes.size());
+  int numberOfCoincidentalNodes = static_cast<int>(coincidentalNodes.size());
 
-  int totalNumberOfChildren = this->GetNumberOfChildren();
-  for (int ll = 0; ll < totalNumberOfChildren; ++ll)
+  for (int i = 0; i < numberOfOverlappingNodes; ++i)
     {
-    vtkVgTransformNode::SmartPtr videoTransform =
-      dynamic_cast<vtkVgTransformNode*>(this->GetChild(ll));
-    if (videoTransform && videoTransform->GetNumberOfChildren())
+    obstacles.Insert(overlappingNodes[i]->GetBounds());
+    }
+
+  // Overlapping nodes only need to avoid one of the coincidental nodes
+  if (numberOfCoincidentalNodes > 0)
+    {
+    obstacles.Insert(coincidentalNodes[0]->GetBounds());
+    }
+
+  // Apply the translation computed for a node, and add a line connecting the
+  // node to its original position.
+  auto applyBlast = [this](vtkVgTransformNode* node, double translation[3])
+    {
+    if (fabs(translation[0]) > 0.0 || fabs(translation [1]) > 0.0)
       {
-      double* nodeBounds = videoTransform->GetChild(0)->GetBounds();
-      double distance = (nodeBounds[1] - nodeBounds[0]) * someFactor;
+      vtkSmartPointer<vtkMatrix4x4> translationMatrix =
+        vtkSmartPointer<vtkMatrix4x4>::New();
+      translationMatrix->SetElement(0, 3, translation[0]);
+      translationMatrix->SetElement(1, 3, translation[1]);
 
-      if (distance > 0.0)
-        {
-        blastDistnace = distance;
-        break;
-        }
+      node->SetMatrix(translationMatrix, true);
+
+      vtkSmartPointer<vtkMatrix4x4> invertMat =
+        vtkSmartPointer<vtkMatrix4x4>::New();
+      invertMat->DeepCopy(node->GetFinalMatrix());
+      invertMat->Invert();
+
+      vtkVgTransformNode::SmartPtr lineTransformNode(
+        vtkVgTransformNode::SmartPtr::New());
+      lineTransformNode->SetMatrix(invertMat);
+      lineTransformNode->SetName("lineTransformNode");
+      lineTransformNode->AddChild(this->Implementation->CreateConnectingNodes(
+                                    translationMatrix, node, this));
+      this->AddChild(lineTransformNode);
       }
-    }
+    };
 
   double coinAngleSeparation = 0.0;
 
@@ -841,48 +967,11 @@ void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
 
   double ovrAngle = 0.0;
 
-// First deal with the just overlapping nodes.
-  int numberOfOverlappingNodes  = static_cast<int>(overlappingNodes.size());
-  int numberOfCoincidentalNodes = static_cast<int>(coincidentalNodes.size());
-
-// NOTE: Commented out for now.
-// Get center of this blast node.
-//double *overallBounds = this->GetBounds();
-//double overallCenter[3] =
-//  {
-//  overallBounds[1] - overallBounds[0] / 2.0,
-//  overallBounds[3] - overallBounds[2] / 2.0,
-//  overallBounds[5] - overallBounds[4] / 2.0,
-//  };
-
 // Deal with just overlapping nodes.
 //-------------------------------------------------------------------------
   for (int i = 0; i < numberOfOverlappingNodes; ++i)
     {
     double translation[3] = {0.0, 0.0, 0.0};
-    double* bounds = overlappingNodes[i]->GetBounds();
-
-    std::vector<double> newBounds(bounds, bounds + 6);
-
-    // NOTE: Commented out for now.
-//  double nodeCenter[3] =
-//    {
-//    bounds[1] - bounds[0] / 2.0,
-//    bounds[3] - bounds[2] / 2.0,
-//    bounds[5] - bounds[4] / 2.0,
-//    };
-
-//  double direction[3] = {
-//    nodeCenter[0] - overallCenter[0],
-//    nodeCenter[1] - overallCenter[1],
-//    0.0};
-//  vtkMath::Normalize(direction);
-
-//  double delta[3] = {
-//    blastDistnace * direction[0],
-//    blastDistnace * direction[1],
-//    0.0};
-
     double delta [3] =
       {
       blastDistnace * cos(ovrAngle *  3.14 / 180.0),
@@ -890,76 +979,23 @@ void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
       0.0
       };
 
-    // This is to make sure that during blast even the last node moves out.
-    this->Implementation->OriginalNodeBounds.push_back(std::vector<double>(bounds, bounds + 6));
-    \
-    do
-      {
-      this->Implementation->Repeat = false;
-
-      // Do blast against overlapping nodes.
-      this->Implementation->DoBlast(overlappingNodes[i], overlappingNodes,
-                                    i, delta, &newBounds[0], translation);
-
-      // Do blast against exactOverlapping  nodes.
-      if (coincidentalNodes.size() > 0)
-        {
-        std::vector<vtkVgTransformNode*> anyCoincidentalNode(
-          1, coincidentalNodes[0]);
-        this->Implementation->DoBlast(overlappingNodes[i], anyCoincidentalNode,
-                                      -1, delta, &newBounds[0], translation);
-        }
-
-      // Do blast against scene  nodes.
-      this->Implementation->DoBlast(overlappingNodes[i],
-                                    this->Implementation->SceneNodes, delta, &newBounds[0], translation);
-
-      // Do blast against original bounds.
-      this->Implementation->DoBlast(overlappingNodes[i],
-                                    this->Implementation->OriginalNodeBounds, delta, &newBounds[0], translation);
-
-      // Do blast against the new node bounds if any.
-      this->Implementation->DoBlast(overlappingNodes[i],
-                                    this->Implementation->NewNodeBounds, delta, &newBounds[0], translation);
-
-      }
-    while (this->Implementation->Repeat);
-
-    if (fabs(translation[0]) > 0.0 || fabs(translation [1]) > 0.0)
-      {
-      vtkInternal::NewNodeBoundData newNodeBoundData;
-      newNodeBoundData.Node = overlappingNodes[i];
-      newNodeBoundData.NodeBounds = newBounds;
-      this->Implementation->NewNodeBounds.push_back(newNodeBoundData);
-
-      vtkSmartPointer<vtkMatrix4x4> translationMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-      translationMatrix->SetElement(0, 3, translation[0]);
-      translationMatrix->SetElement(1, 3, translation[1]);
-
-      overlappingNodes[i]->SetMatrix(translationMatrix, true);
-
-      vtkSmartPointer<vtkMatrix4x4> invertMat = vtkSmartPointer<vtkMatrix4x4>::New();
-      invertMat->DeepCopy(overlappingNodes[i]->GetFinalMatrix());
-      invertMat->Invert();
-
-      vtkVgTransformNode::SmartPtr lineTransformNode(vtkVgTransformNode::SmartPtr::New());
-      lineTransformNode->SetMatrix(invertMat);
-      lineTransformNode->SetName("lineTransformNode");
-      lineTransformNode->AddChild(this->Implementation->CreateConnectingNodes(
-                                    translationMatrix, overlappingNodes[i], this));
-      this->AddChild(lineTransformNode);
-      }
+    this->Implementation->DoBlast(overlappingNodes[i], obstacles, delta,
+                                  translation);
+    applyBlast(overlappingNodes[i], translation);
 
     ovrAngle += ovrAngleSeparation;
     }
 
 // Now deal with coincidental nodes.
 // ---------------------------------------------------------------------------------
+  for (int i = 1; i < numberOfCoincidentalNodes; ++i)
+    {
+    obstacles.Insert(coincidentalNodes[i]->GetBounds());
+    }
+
   for (int i = 0; i < numberOfCoincidentalNodes; ++i)
     {
     double translation[3] = {0.0, 0.0, 0.0};
-    double* bounds = coincidentalNodes[i]->GetBounds();
-    std::vector<double> newBounds(bounds, bounds + 6);
     double delta [3] =
       {
       blastDistnace * cos(coinAngle *  3.14 / 180.0),
@@ -967,67 +1003,9 @@ void vtkVQBlastLayoutNode::SetLayoutToBlast(vtkVgNodeVisitorBase& nodeVisitor)
       0.0
       };
 
-    // This is to make sure that during blast even the last node moves out.
-    this->Implementation->OriginalNodeBounds.push_back(std::vector<double>(bounds, bounds + 6));
-
-    do
-      {
-      this->Implementation->Repeat = false;
-
-      // Do blast against the coincidental nodes.
-      this->Implementation->DoBlast(coincidentalNodes[i], coincidentalNodes, i,
-                                    delta, &newBounds[0], translation);
-
-      // Do blast against the just overlapping nodes.
-      this->Implementation->DoBlast(coincidentalNodes[i], overlappingNodes, -1,
-                                    delta, &newBounds[0], translation);
-
-      // Do blast against the scene nodes.
-      // If these are coincidental with this node
-      // then we have to make sure we test blast
-      // against this node itself.
-      if (IsCoincidental(bounds, this->GetBounds()))
-        {
-        this->Implementation->OriginalNodeBounds.push_back(std::vector<double>(bounds, (bounds + 6)));
-        }
-      this->Implementation->DoBlast(coincidentalNodes[i],
-                                    this->Implementation->SceneNodes, delta, &newBounds[0], translation);
-
-      // Do blast against the original node bounds.
-      this->Implementation->DoBlast(coincidentalNodes[i],
-                                    this->Implementation->OriginalNodeBounds, delta, &newBounds[0], translation);
-
-      // Do blast against the new node bounds if any.
-      this->Implementation->DoBlast(coincidentalNodes[i],
-                                    this->Implementation->NewNodeBounds, delta, &newBounds[0], translation);
-
-      }
-    while (this->Implementation->Repeat);
-
-    if (fabs(translation[0]) > 0.0 || fabs(translation [1]) > 0.0)
-      {
-      vtkInternal::NewNodeBoundData newNodeBoundData;
-      newNodeBoundData.Node = coincidentalNodes[i];
-      newNodeBoundData.NodeBounds = newBounds;
-      this->Implementation->NewNodeBounds.push_back(newNodeBoundData);
-
-      vtkSmartPointer<vtkMatrix4x4> translationMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-      translationMatrix->SetElement(0, 3, translation[0]);
-      translationMatrix->SetElement(1, 3, translation[1]);
-
-      coincidentalNodes[i]->SetMatrix(translationMatrix, true);
-
-      vtkSmartPointer<vtkMatrix4x4> invertMat = vtkSmartPointer<vtkMatrix4x4>::New();
-      invertMat->DeepCopy(coincidentalNodes[i]->GetFinalMatrix());
-      invertMat->Invert();
-
-      vtkVgTransformNode::SmartPtr lineTransformNode(vtkVgTransformNode::SmartPtr::New());
-      lineTransformNode->SetMatrix(invertMat);
-      lineTransformNode->SetName("lineTransformNode");
-      lineTransformNode->AddChild(this->Implementation->CreateConnectingNodes(
-                                    translationMatrix, coincidentalNodes[i], this));
-      this->AddChild(lineTransformNode);
-      }
+    this->Implementation->DoBlast(coincidentalNodes[i], obstacles, delta,
+                                  translation);
+    applyBlast(coincidentalNodes[i], translation);
 
     coinAngle += coinAngleSeparation;
     }
@@ -1070,11 +1048,12 @@ void vtkVQBlastLayoutNode::SetLayoutToZSort(
     {
     this->Implementation->SortedZSortStack.clear();
 
+    const std::vector<vtkVgNodeBase::SmartPtr> children = this->GetChildren();
     for (int i = 0; i < numberOfChildren; ++i)
       {
       // Get the trasnform node.
       vtkVgTransformNode::SmartPtr transformNode =
-        vtkVgTransformNode::SafeDownCast(this->GetChild(i));
+        vtkVgTransformNode::SafeDownCast(children[i]);
       if (transformNode)
         {
         vtkVgVideoNode::SmartPtr currentVideoNode =
@@ -1155,25 +1134,26 @@ void vtkVQBlastLayoutNode::UndoZSortLayout()
 void vtkVQBlastLayoutNode::SetLayoutToStack(
   vtkVgNodeVisitorBase& vtkNotUsed(nodeVisitor))
 {
-  // Z Sort likely to use this as well, but for now just create for our needs
-  if (this->Implementation->SortedStack.size() == 0)
-    {
-    int numberOfChildren = this->GetNumberOfChildren();
-    for (int i = 0; i < numberOfChildren; ++i)
+  // Z Sort likely to use this as well, but for now just create for our needs.
+  // Add any nodes that are not yet in the stack (i.e. that have been added
+  // since the stack was last built); inserting into the stack does not
+  // invalidate the current stack position.
+  const std::vector<vtkVgNodeBase::SmartPtr> children = this->GetChildren();
+  for (size_t i = 0, k = children.size(); i < k; ++i)
+    {
+    // Get the trasnform node.
+    vtkVgTransformNode* transformNode =
+      vtkVgTransformNode::SafeDownCast(children[i]);
+    if (transformNode)
       {
-      // Get the trasnform node.
-      vtkVgTransformNode* transformNode =
-        vtkVgTransformNode::SafeDownCast(this->GetChild(i));
-      if (transformNode)
-        {
-        vtkVgVideoNode* currentVideoNode =
-          vtkVgVideoNode::SafeDownCast(transformNode->GetChild(0));
+      vtkVgVideoNode* currentVideoNode =
+        vtkVgVideoNode::SafeDownCast(transformNode->GetChild(0));
 
-        if (currentVideoNode)
-          {
-          this->Implementation->SortedStack.insert(std::pair<double, vtkVgVideoNode*>(
-                                                     currentVideoNode->GetRank(), currentVideoNode));
-          }
+      if (currentVideoNode &&
+          this->Implementation->StackNodes.insert(currentVideoNode).second)
+        {
+        this->Implementation->SortedStack.insert(
+          std::make_pair(currentVideoNode->GetRank(), currentVideoNode));
         }
       }
     }
@@ -1223,14 +1203,15 @@ void vtkVQBlastLayoutNode::UndoStackLayout()
 //-----------------------------------------------------------------------------
 void vtkVQBlastLayoutNode::UndoBlastLayout()
 {
-  int numberOfChildren = this->GetNumberOfChildren();
+  const std::vector<vtkVgNodeBase::SmartPtr> children = this->GetChildren();
+  int numberOfChildren = static_cast<int>(children.size());
 
   // Remove blast connection lines.
   std::vector<vtkVgTransformNode::SmartPtr> lineTransforms;
   for (int i = 0; i < numberOfChildren; ++i)
     {
     vtkVgTransformNode::SmartPtr transformNode =
-      vtkVgTransformNode::SafeDownCast(this->GetChild(i));
+      vtkVgTransformNode::SafeDownCast(children[i]);
 
     if (transformNode)
       {
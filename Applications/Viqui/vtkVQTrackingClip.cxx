@@ -9,16 +9,16 @@
 #include "vtkVgVideoProviderBase.h"
 #include "vtkVgVideoFrameData.h"
 
+#include <vtkDataArray.h>
 #include <vtkDoubleArray.h>
-#include <vtkExtractVOI.h>
 #include <vtkFieldData.h>
-#include <vtkImageAppend.h>
-#include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkPoints.h>
 
 #include <algorithm>
+#include <cstring>
 
 vtkStandardNewMacro(vtkVQTrackingClip);
 
@@ -178,17 +178,53 @@ void vtkVQTrackingClip::Update()
     vtkErrorMacro("Tracking clip extents exceed input video dimensions.")
     }
 
-  vtkImageAppend* IAInput = vtkImageAppend::New();
-  IAInput->SetNumberOfThreads(1);
-  IAInput->SetAppendAxis(2);
+  vtkDataArray* inScalars = frameData.VideoImage->GetPointData()->GetScalars();
+  if (!inScalars || dim[0] < 1 || dim[1] < 1)
+    {
+    vtkErrorMacro("Source video frame has no image data.");
+    return;
+    }
 
-  vtkImageAppend* IA = vtkImageAppend::New();
-  IA->SetNumberOfThreads(1);
-  IA->SetAppendAxis(2);
+  // The size of the crop region actually extracted from each frame; this may
+  // be smaller than the requested region if the video is smaller
+  const int cropDim[] = { std::min(regionDim[0], dim[0]),
+                          std::min(regionDim[1], dim[1]) };
+  const int outDim[] = { (cropDim[0] - 1) / sampleRate + 1,
+                         (cropDim[1] - 1) / sampleRate + 1 };
+
+  // Allocate the output volume up front; the frame count is estimated from
+  // the portion of the video's time range covered by the event, and the
+  // array will grow if this turns out to be too small
+  vtkIdType estimatedFrames = 1;
+  const int videoFrames = this->Video->GetNumberOfFrames();
+  const double videoDuration = videoTimeRange[1] - videoTimeRange[0];
+  if (videoFrames > 0 && videoDuration > 0.0)
+    {
+    const double eventDuration = eventEnd.GetTime() - eventStart.GetTime();
+    estimatedFrames += static_cast<vtkIdType>(
+      videoFrames * std::max(0.0, eventDuration) / videoDuration);
+    }
 
-  vtkDoubleArray* timeStampData = vtkDoubleArray::New();
+  // Only the format of the first frame's scalars is needed; later frames
+  // replace the frame data, which may release the array
+  const int dataType = inScalars->GetDataType();
+  const int components = inScalars->GetNumberOfComponents();
+  const int pixelSize = components * inScalars->GetDataTypeSize();
+  const vtkIdType sliceValues =
+    static_cast<vtkIdType>(outDim[0]) * outDim[1] * components;
+
+  vtkSmartPointer<vtkDataArray> outScalars;
+  outScalars.TakeReference(vtkDataArray::CreateDataArray(dataType));
+  outScalars->SetName(inScalars->GetName());
+  outScalars->SetNumberOfComponents(components);
+  outScalars->Allocate(sliceValues * estimatedFrames);
+
+  vtkSmartPointer<vtkDoubleArray> timeStampData =
+    vtkSmartPointer<vtkDoubleArray>::New();
   timeStampData->SetName("TimeStampData");
 
+  vtkIdType frames = 0;
+
   // loop over the video
   do
     {
@@ -198,6 +234,24 @@ void vtkVQTrackingClip::Update()
       break;
       }
 
+    vtkImageData* image = frameData.VideoImage;
+    vtkDataArray* scalars = image->GetPointData()->GetScalars();
+    if (!scalars || scalars->GetDataType() != dataType ||
+        scalars->GetNumberOfComponents() != components)
+      {
+      vtkErrorMacro("Source video frame format changed; stopping.");
+      break;
+      }
+
+    int extent[6];
+    image->GetExtent(extent);
+    if (extent[1] - extent[0] + 1 != dim[0] ||
+        extent[3] - extent[2] + 1 != dim[1])
+      {
+      vtkErrorMacro("Source video frame size changed; stopping.");
+      break;
+      }
+
     double center[2];
     bool interpolated = false;
     bool found = this->Event->GetRegionCenter(frameData.TimeStamp,
@@ -217,90 +271,45 @@ void vtkVQTrackingClip::Update()
       static_cast<int>(center[1] - regionDim[1] / 2)
       };
 
-    int ur[] =
-      {
-      ll[0] + regionDim[0] - 1,
-      ll[1] + regionDim[1] - 1
-      };
-
     // keep the clipping region within the bounds of the video
-    if (ll[0] < 0)
+    ll[0] = std::max(0, std::min(ll[0], dim[0] - cropDim[0]));
+    ll[1] = std::max(0, std::min(ll[1], dim[1] - cropDim[1]));
+
+    // crop (and downsample) the area of interest directly into the output
+    // slice for this frame
+    char* out = static_cast<char*>(
+      outScalars->WriteVoidPointer(frames * sliceValues, sliceValues));
+    for (int j = 0; j < outDim[1]; ++j)
       {
-      ur[0] += -ll[0];
-      ll[0] = 0;
-      }
-    if (ll[1] < 0)
-      {
-      ur[1] += -ll[1];
-      ll[1] = 0;
-      }
-    if (ur[0] > dim[0] - 1)
-      {
-      ll[0] -= ur[0] - (dim[0] - 1);
-      ur[0] = dim[0] - 1;
-      }
-    if (ur[1] > dim[1] - 1)
-      {
-      ll[1] -= ur[1] - (dim[1] - 1);
-      ur[1] = dim[1] - 1;
-      }
-
-    int wholeExtent[6] =
-      {
-      ll[0], ur[0],
-      ll[1], ur[1],
-      0,     0
-      };
-
-    // crop to the area of interest
-    vtkExtractVOI* IC = vtkExtractVOI::New();
-    IC->SetInputData(frameData.VideoImage);
-    IC->SetVOI(wholeExtent);
-    IC->SetSampleRate(sampleRate, sampleRate, 1);
-
-    // make sure cropped images are aligned
-    vtkImageChangeInformation* ICI = vtkImageChangeInformation::New();
-    ICI->SetInputConnection(IC->GetOutputPort());
-    ICI->SetOutputExtentStart(0, 0, 0);
-    ICI->SetOutputSpacing(1.0, 1.0, 1.0);
-    IC->FastDelete();
-
-    IAInput->AddInputConnection(ICI->GetOutputPort());
-    ICI->FastDelete();
-
-    // process input frames in small batches to achieve fast execution
-    // while limiting the number of input frames in memory at any given time
-    if (IAInput->GetNumberOfInputConnections(0) == 8)
-      {
-      IAInput->Update();
-      vtkImageData* copy = vtkImageData::New();
-      copy->DeepCopy(IAInput->GetOutput());
-      IAInput->Delete();
-      IAInput = vtkImageAppend::New();
-      IAInput->SetNumberOfThreads(1);
-      IAInput->SetAppendAxis(2);
-      IA->AddInputData(copy);
-      copy->FastDelete();
+      const char* in = static_cast<const char*>(
+        image->GetScalarPointer(extent[0] + ll[0],
+                                extent[2] + ll[1] + j * sampleRate,
+                                extent[4]));
+      if (sampleRate == 1)
+        {
+        memcpy(out, in, static_cast<size_t>(outDim[0]) * pixelSize);
+        out += outDim[0] * pixelSize;
+        }
+      else
+        {
+        for (int i = 0; i < outDim[0]; ++i)
+          {
+          memcpy(out, in, pixelSize);
+          out += pixelSize;
+          in += sampleRate * pixelSize;
+          }
+        }
       }
+    ++frames;
 
     // embed the timestamp
     timeStampData->InsertNextValue(frameData.TimeStamp.GetTime());
-
-    // prevent the GetNextFrame call from de-registering our data
-    frameData.VideoImage = vtkSmartPointer<vtkImageData>::New();
     }
   while (this->Video->GetNextFrame(&frameData) == VTK_OK);
 
-  // add any remaining input frames
-  if (IAInput->GetNumberOfInputs() > 0)
-    {
-    IA->AddInputConnection(IAInput->GetOutputPort());
-    }
-
-  IA->Update();
-  this->OutputImageData->DeepCopy(IA->GetOutput());
-  this->OutputImageData->GetFieldData()->AddArray(timeStampData);
-  timeStampData->FastDelete();
-  IAInput->Delete();
-  IA->Delete();
+  vtkImageData* output = vtkImageData::New();
+  output->SetDimensions(outDim[0], outDim[1], static_cast<int>(frames));
+  output->GetPointData()->SetScalars(outScalars);
+  output->GetFieldData()->AddArray(timeStampData);
+  this->OutputImageData.TakeReference(output);
 }
@@ -0,0 +1,141 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vpViewBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include "vpTreeModel.h"
+#include "vpTreeProxyModel.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgEvent.h>
+#include <vtkVgEventFilter.h>
+#include <vtkVgEventModel.h>
+#include <vtkVgEventTypeRegistry.h>
+#include <vtkVgTrack.h>
+#include <vtkVgTrackFilter.h>
+#include <vtkVgTrackModel.h>
+#include <vtkVgTrackTypeRegistry.h>
+
+#include <vtkNew.h>
+
+#include <QJsonObject>
+
+using vgBenchmarkData::FrameInterval;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTree(vgBenchmark& benchmark, const QList<int>& itemCounts)
+{
+  foreach (const int itemCount, itemCounts)
+    {
+    vtkNew<vtkVgTrackModel> trackModel;
+    vtkNew<vtkVgEventModel> eventModel;
+    eventModel->SetTrackModel(trackModel.GetPointer());
+
+    // One event per track, so that each event item has a child item
+    for (int n = 0; n < itemCount; ++n)
+      {
+      const vtkVgTimeStamp start(n * FrameInterval, n);
+      const vtkVgTimeStamp end((n + 30) * FrameInterval, n + 30);
+
+      vtkNew<vtkVgTrack> track;
+      track->SetPoints(trackModel->GetPoints());
+      track->SetId(n);
+      const double p0[2] = { 0.0, 0.0 }, p1[2] = { 20.0, 20.0 };
+      track->InsertNextPoint(start, p0, vtkVgGeoCoord());
+      track->InsertNextPoint(end, p1, vtkVgGeoCoord());
+      trackModel->AddTrack(track.GetPointer());
+
+      vtkNew<vtkVgEvent> event;
+      event->SetId(n);
+      event->SetStartFrame(start);
+      event->SetEndFrame(end);
+      event->AddTrack(track.GetPointer(), start, end);
+      eventModel->AddEvent(event.GetPointer());
+      }
+
+    vtkNew<vtkVgEventFilter> eventFilter;
+    vtkNew<vtkVgTrackFilter> trackFilter;
+    vtkNew<vtkVgEventTypeRegistry> eventTypes;
+    vtkNew<vtkVgTrackTypeRegistry> trackTypes;
+
+    vpTreeModel model;
+    model.Initialize(0, eventModel.GetPointer(), trackModel.GetPointer(),
+                     eventFilter.GetPointer(), trackFilter.GetPointer(),
+                     eventTypes.GetPointer(), trackTypes.GetPointer());
+
+    QJsonObject parameters;
+    parameters.insert("items", itemCount);
+
+    benchmark.measure(
+      "tree", "populate-tracks", parameters, itemCount, "items",
+      [&]{
+        model.Clear();
+        model.AddAllTracks();
+      });
+
+    benchmark.measure(
+      "tree", "populate-events", parameters, itemCount, "items",
+      [&]{
+        model.Clear();
+        model.AddAllEvents();
+      });
+
+    // Synchronizing with an unchanged model is what a project update that
+    // does not touch the events costs
+    benchmark.measure(
+      "tree", "resync", parameters, itemCount, "items",
+      [&]{ model.AddAllEvents(); });
+
+    // Expand every event item, as the view would on demand, so that the
+    // state changes below also cover existing child items
+    for (int row = 0, rows = model.rowCount(); row < rows; ++row)
+      {
+      model.rowCount(model.index(row, 0));
+      }
+
+    benchmark.measure(
+      "tree", "toggle-all", parameters, 4 * itemCount, "objects",
+      [&]{
+        model.SetAllStates(Qt::Unchecked);
+        model.SetAllStates(Qt::Checked);
+      });
+
+    vpTreeProxyModel proxy;
+    proxy.SetShowExcludedItems(true);
+    proxy.setSourceModel(&model);
+
+    benchmark.measure(
+      "tree", "sort", parameters, itemCount, "items",
+      [&]{
+        proxy.SetSortType(vpTreeModel::ST_Id);
+        proxy.sort(0, Qt::DescendingOrder);
+        proxy.sort(0, Qt::AscendingOrder);
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("tree-items <list>",
+              "Comma separated list of item counts for the tree model",
+              "10000,100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTree(benchmark, context.sizes("tree-items"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("tree", &addOptions, &run, true);
+
+} // namespace <anonymous>
@@ -0,0 +1,366 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "../vpTreeModel.h"
+
+#include <qtTest.h>
+
+#include <vgActivityType.h>
+
+#include "vtkVgActivity.h"
+#include "vtkVgActivityManager.h"
+#include "vtkVgActivityTypeRegistry.h"
+#include "vtkVgEvent.h"
+#include "vtkVgEventModel.h"
+#include "vtkVgTimeStamp.h"
+#include "vtkVgTrack.h"
+#include "vtkVgTrackModel.h"
+
+#include <vtkSmartPointer.h>
+
+#include <QList>
+
+typedef vpTreeModel::ItemType ItemType;
+
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp frameTime(int n)
+{
+  return vtkVgTimeStamp(n * 1e6, n);
+}
+
+//-----------------------------------------------------------------------------
+// Objects shown by a tree model; tracks 1 - 3 belong to events 10 (tracks 1
+// and 2) and 11 (track 3), and event 12 has no tracks
+struct Project
+{
+  Project();
+
+  vtkVgEvent* addEvent(int id, const QList<vtkVgTrack*>& tracks);
+  vtkVgTrack* addTrack(int id);
+  void addActivity(int id, vtkVgEvent* event);
+
+  vtkSmartPointer<vtkVgActivityTypeRegistry> ActivityTypes;
+  vtkSmartPointer<vtkVgActivityManager> ActivityManager;
+  vtkSmartPointer<vtkVgEventModel> EventModel;
+  vtkSmartPointer<vtkVgTrackModel> TrackModel;
+
+  vpTreeModel Model;
+};
+
+//-----------------------------------------------------------------------------
+Project::Project()
+{
+  this->ActivityTypes = vtkSmartPointer<vtkVgActivityTypeRegistry>::New();
+  this->ActivityTypes->AddType(vgActivityType());
+
+  this->TrackModel = vtkSmartPointer<vtkVgTrackModel>::New();
+  this->EventModel = vtkSmartPointer<vtkVgEventModel>::New();
+  this->EventModel->SetTrackModel(this->TrackModel);
+
+  this->ActivityManager = vtkSmartPointer<vtkVgActivityManager>::New();
+  this->ActivityManager->SetActivityTypeRegistry(this->ActivityTypes);
+  this->ActivityManager->SetEventModel(this->EventModel);
+
+  vtkVgTrack* track1 = this->addTrack(1);
+  vtkVgTrack* track2 = this->addTrack(2);
+  vtkVgTrack* track3 = this->addTrack(3);
+  this->addEvent(10, QList<vtkVgTrack*>() << track1 << track2);
+  this->addEvent(11, QList<vtkVgTrack*>() << track3);
+  this->addEvent(12, QList<vtkVgTrack*>());
+
+  // The filters and type registries are only used for display
+  this->Model.Initialize(this->ActivityManager, this->EventModel,
+                         this->TrackModel, 0, 0, 0, 0);
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTrack* Project::addTrack(int id)
+{
+  vtkSmartPointer<vtkVgTrack> track = vtkSmartPointer<vtkVgTrack>::New();
+  track->SetId(id);
+  this->TrackModel->AddTrack(track);
+
+  const double point[2] = { 0.0, 0.0 };
+  track->InsertNextPoint(frameTime(0), point, vtkVgGeoCoord());
+  track->InsertNextPoint(frameTime(1), point, vtkVgGeoCoord());
+  return track;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgEvent* Project::addEvent(int id, const QList<vtkVgTrack*>& tracks)
+{
+  vtkSmartPointer<vtkVgEvent> event = vtkSmartPointer<vtkVgEvent>::New();
+  event->SetId(id);
+  event->SetStartFrame(frameTime(0));
+  event->SetEndFrame(frameTime(1));
+  foreach (vtkVgTrack* track, tracks)
+    {
+    event->AddTrack(track, event->GetStartFrame(), event->GetEndFrame());
+    }
+  return this->EventModel->AddEvent(event);
+}
+
+//-----------------------------------------------------------------------------
+void Project::addActivity(int id, vtkVgEvent* event)
+{
+  vtkSmartPointer<vtkVgActivity> activity =
+    vtkSmartPointer<vtkVgActivity>::New();
+  activity->SetId(id);
+  activity->SetType(0);
+  activity->AddEvent(event);
+  this->ActivityManager->AddActivity(activity);
+}
+
+//-----------------------------------------------------------------------------
+// Records the rows inserted into, and removed from, a model
+struct RowChanges
+{
+  RowChanges(QAbstractItemModel* model)
+    {
+    QObject::connect(
+      model, &QAbstractItemModel::rowsInserted,
+      [this](const QModelIndex& parent, int first, int last)
+        { this->Inserted.append(Change(parent, first, last)); });
+    QObject::connect(
+      model, &QAbstractItemModel::rowsRemoved,
+      [this](const QModelIndex& parent, int first, int last)
+        { this->Removed.append(Change(parent, first, last)); });
+    }
+
+  void clear() { this->Inserted.clear(); this->Removed.clear(); }
+
+  struct Change
+    {
+    Change(const QModelIndex& parent, int first, int last)
+      : Parent(parent), First(first), Last(last) {}
+
+    QPersistentModelIndex Parent;
+    int First;
+    int Last;
+    };
+
+  QList<Change> Inserted;
+  QList<Change> Removed;
+};
+
+//-----------------------------------------------------------------------------
+int itemId(const QModelIndex& index)
+{
+  return index.data(vpTreeModel::IDR_ItemId).toInt();
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex findTopLevel(const vpTreeModel& model, int id)
+{
+  for (int row = 0, end = model.rowCount(); row < end; ++row)
+    {
+    const QModelIndex index = model.index(row, 0);
+    if (itemId(index) == id)
+      {
+      return index;
+      }
+    }
+  return QModelIndex();
+}
+
+//-----------------------------------------------------------------------------
+int testFetchMore(qtTest& testObject)
+{
+  Project project;
+  vpTreeModel& model = project.Model;
+  RowChanges changes(&model);
+
+  model.AddAllEvents();
+  TEST_EQUAL(model.rowCount(), 3);
+  TEST_EQUAL(changes.Inserted.size(), 1);
+  changes.clear();
+
+  const QModelIndex event10 = findTopLevel(model, 10);
+  const QModelIndex event12 = findTopLevel(model, 12);
+  if (TEST(event10.isValid()) || TEST(event12.isValid()))
+    {
+    return 0;
+    }
+
+  // An item with child objects has children, but they are only created when
+  // fetched
+  TEST(model.hasChildren(event10));
+  TEST(model.canFetchMore(event10));
+  TEST(changes.Inserted.isEmpty());
+
+  model.fetchMore(event10);
+  if (TEST_EQUAL(changes.Inserted.size(), 1) == 0)
+    {
+    const RowChanges::Change& change = changes.Inserted.first();
+    TEST(change.Parent == event10);
+    TEST_EQUAL(change.First, 0);
+    TEST_EQUAL(change.Last, 1);
+    }
+  TEST(!model.canFetchMore(event10));
+  TEST(model.hasChildren(event10));
+  if (TEST_EQUAL(model.rowCount(event10), 2) == 0)
+    {
+    for (int row = 0; row < 2; ++row)
+      {
+      const QModelIndex track = model.index(row, 0, event10);
+      TEST_EQUAL(track.data(vpTreeModel::IDR_ItemType).toInt(),
+                 static_cast<int>(ItemType::Track));
+      TEST_EQUAL(itemId(track), row + 1);
+      TEST_EQUAL(track.data(vpTreeModel::IDR_ItemIndex).toInt(), row);
+      TEST(track.parent() == event10);
+      TEST(!model.hasChildren(track));
+      TEST(!model.canFetchMore(track));
+      }
+    }
+
+  // Fetching again does nothing
+  changes.clear();
+  model.fetchMore(event10);
+  TEST(changes.Inserted.isEmpty());
+  TEST_EQUAL(model.rowCount(event10), 2);
+
+  // An item without child objects has nothing to fetch
+  TEST(!model.hasChildren(event12));
+  TEST(!model.canFetchMore(event12));
+  model.fetchMore(event12);
+  TEST(changes.Inserted.isEmpty());
+  TEST_EQUAL(model.rowCount(event12), 0);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testPopulate(qtTest& testObject)
+{
+  Project project;
+  vpTreeModel& model = project.Model;
+  model.AddAllEvents();
+
+  RowChanges changes(&model);
+  const QModelIndex event10 = findTopLevel(model, 10);
+  const QModelIndex event11 = findTopLevel(model, 11);
+  if (TEST(event10.isValid()) || TEST(event11.isValid()))
+    {
+    return 0;
+    }
+
+  // Asking for the children of an item that has not been fetched creates
+  // them without notification, since no view has been told about them
+  TEST_EQUAL(model.rowCount(event11), 1);
+  TEST_EQUAL(itemId(model.index(0, 0, event11)), 3);
+  TEST(!model.canFetchMore(event11));
+  TEST(changes.Inserted.isEmpty());
+
+  // Synchronizing with the event model updates the children of fetched
+  // items, and leaves the others to be fetched when needed
+  model.fetchMore(event10);
+  changes.clear();
+
+  vtkVgTrack* track4 = project.addTrack(4);
+  vtkVgEvent* e10 = project.EventModel->GetEvent(10);
+  e10->AddTrack(track4, e10->GetStartFrame(), e10->GetEndFrame());
+  vtkVgEvent* e12 = project.EventModel->GetEvent(12);
+  e12->AddTrack(track4, e12->GetStartFrame(), e12->GetEndFrame());
+
+  model.AddAllEvents();
+  TEST_EQUAL(model.rowCount(), 3);
+  if (TEST_EQUAL(model.rowCount(event10), 3) == 0)
+    {
+    TEST_EQUAL(itemId(model.index(2, 0, event10)), 4);
+    }
+  TEST(!changes.Inserted.isEmpty());
+
+  const QModelIndex event12 = findTopLevel(model, 12);
+  TEST(model.canFetchMore(event12));
+  foreach (const RowChanges::Change& change, changes.Inserted)
+    {
+    TEST(change.Parent == event10);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testActivityIdentity(qtTest& testObject)
+{
+  Project project;
+  vpTreeModel& model = project.Model;
+  vtkVgActivityManager* am = project.ActivityManager;
+
+  vtkVgEvent* e10 = project.EventModel->GetEvent(10);
+  vtkVgEvent* e11 = project.EventModel->GetEvent(11);
+  project.addActivity(100, e10);
+  project.addActivity(200, e11);
+  project.addActivity(300, e10);
+  model.AddAllActivities();
+
+  // Activities are referred to by index, but shown by id
+  if (TEST_EQUAL(model.rowCount(), 3) == 0)
+    {
+    const QModelIndex second = model.index(1, 0);
+    TEST_EQUAL(itemId(second), 1);
+    TEST_EQUAL(second.data().toString().right(4), QString("-200"));
+    TEST(model.FindItem(ItemType::Activity, 1) == second);
+
+    // Pin and expand the second activity
+    model.SetSticky(QModelIndexList() << second, true);
+    model.fetchMore(second);
+    }
+
+  // Remove the first activity; the pinned and expanded item must still be
+  // that of the activity with id 200, which is now the first activity
+  vtkSmartPointer<vtkVgActivity> a200 = am->GetActivity(1);
+  vtkSmartPointer<vtkVgActivity> a300 = am->GetActivity(2);
+  am->Initialize();
+  am->AddActivity(a200);
+  am->AddActivity(a300);
+
+  RowChanges changes(&model);
+  model.AddAllActivities();
+  if (TEST_EQUAL(changes.Removed.size(), 1) == 0)
+    {
+    TEST_EQUAL(changes.Removed.first().First, 0);
+    TEST_EQUAL(changes.Removed.first().Last, 0);
+    }
+  TEST(changes.Inserted.isEmpty());
+
+  if (TEST_EQUAL(model.rowCount(), 2) == 0)
+    {
+    const QModelIndex first = model.index(0, 0);
+    const QModelIndex second = model.index(1, 0);
+    TEST_EQUAL(itemId(first), 0);
+    TEST_EQUAL(itemId(second), 1);
+    TEST(first.data(vpTreeModel::IDR_ItemSticky).toBool());
+    TEST(!second.data(vpTreeModel::IDR_ItemSticky).toBool());
+    TEST(!model.canFetchMore(first));
+    if (TEST_EQUAL(model.rowCount(first), 1) == 0)
+      {
+      TEST_EQUAL(itemId(model.index(0, 0, first)), 11);
+      }
+    TEST(model.FindItem(ItemType::Activity, 0) == first);
+
+    // The check state of an item is that of its activity
+    am->SetActivityDisplayState(0, false);
+    TEST_EQUAL(first.data(Qt::CheckStateRole).toInt(),
+               static_cast<int>(Qt::Unchecked));
+    TEST_EQUAL(second.data(Qt::CheckStateRole).toInt(),
+               static_cast<int>(Qt::Checked));
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Fetch More",        testFetchMore);
+  testObject.runSuite("Populate",          testPopulate);
+  testObject.runSuite("Activity Identity", testActivityIdentity);
+  return testObject.result();
+}
@@ -0,0 +1,314 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "../vpImageSourceFactory.h"
+#include "../vpWebExporterPrivate.h"
+
+#include <qtTest.h>
+
+#include <vtkVgPNGReader.h>
+
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPNGWriter.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+#include <QSet>
+#include <QTemporaryDir>
+
+#include <cstring>
+
+namespace // anonymous
+{
+
+QString frameFile;
+
+//-----------------------------------------------------------------------------
+vpWebExportImage makeImage(int x0, int x1, int y0, int y1)
+{
+  vpWebExportImage image;
+  image.Extents[0] = x0;
+  image.Extents[1] = x1;
+  image.Extents[2] = y0;
+  image.Extents[3] = y1;
+  image.SampleRate = 1;
+  image.DrawBox = false;
+  return image;
+}
+
+//-----------------------------------------------------------------------------
+qint64 area(const int extents[4])
+{
+  return static_cast<qint64>(extents[1] - extents[0] + 1) *
+         static_cast<qint64>(extents[3] - extents[2] + 1);
+}
+
+//-----------------------------------------------------------------------------
+// Check that every image is in exactly one read which covers it, and that
+// each read is within the limits on its size
+int testReadBounds(qtTest& testObject,
+                   const QVector<vpWebExportImage>& images,
+                   const QVector<vpWebExportRead>& reads)
+{
+  QVector<int> count(images.size(), 0);
+  foreach (const vpWebExportRead& read, reads)
+    {
+    const int* const r = read.Extents;
+    qint64 imageArea = 0;
+    foreach (const int index, read.Images)
+      {
+      const int* const e = images[index].Extents;
+      TEST(r[0] <= e[0] && e[1] <= r[1] && r[2] <= e[2] && e[3] <= r[3]);
+      imageArea += area(e);
+      ++count[index];
+      }
+
+    TEST_EQUAL(read.ImageArea, imageArea);
+    TEST(area(r) <= vpWebExportMaxReadOverhead * imageArea);
+    TEST(area(r) <= vpWebExportMaxReadPixels || read.Images.size() == 1);
+    }
+
+  foreach (const int n, count)
+    {
+    TEST_EQUAL(n, 1);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+QVector<vpWebExportRead> groupReads(qtTest& testObject,
+                                    const QVector<vpWebExportImage>& images)
+{
+  const QVector<vpWebExportRead> reads =
+    vpWebExporterPrivate::groupReads(images);
+  TEST_CALL(testReadBounds, images, reads);
+  return reads;
+}
+
+//-----------------------------------------------------------------------------
+int testGroupReads(qtTest& testObject)
+{
+  // Adjacent images are read together
+  QVector<vpWebExportImage> images;
+  images << makeImage(0, 99, 0, 99) << makeImage(100, 199, 0, 99)
+         << makeImage(0, 99, 110, 209);
+  QVector<vpWebExportRead> reads = groupReads(testObject, images);
+  if (TEST_EQUAL(reads.size(), 1) == 0)
+    {
+    TEST_EQUAL(reads[0].Images.size(), 3);
+    TEST_EQUAL(reads[0].Extents[0], 0);
+    TEST_EQUAL(reads[0].Extents[1], 199);
+    TEST_EQUAL(reads[0].Extents[2], 0);
+    TEST_EQUAL(reads[0].Extents[3], 209);
+    }
+
+  // Images far apart, or diagonal to each other, are read separately
+  images.clear();
+  images << makeImage(0, 99, 0, 99) << makeImage(10000, 10099, 0, 99)
+         << makeImage(150, 249, 150, 249);
+  reads = groupReads(testObject, images);
+  TEST_EQUAL(reads.size(), 3);
+
+  // A read grows only up to the pixel limit, even if it stays dense
+  images.clear();
+  images << makeImage(0, 4095, 0, 2047) << makeImage(0, 4095, 2048, 4095)
+         << makeImage(0, 4095, 4096, 6143);
+  reads = groupReads(testObject, images);
+  if (TEST_EQUAL(reads.size(), 2) == 0)
+    {
+    TEST_EQUAL(reads[0].Images.size(), 2);
+    TEST_EQUAL(area(reads[0].Extents), vpWebExportMaxReadPixels);
+    }
+
+  // An image larger than the limit is still read, on its own
+  images.clear();
+  images << makeImage(0, 4999, 0, 4999) << makeImage(5000, 5099, 0, 99);
+  reads = groupReads(testObject, images);
+  if (TEST_EQUAL(reads.size(), 2) == 0)
+    {
+    TEST_EQUAL(area(reads[0].Extents), qint64(5000 * 5000));
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+QString manifestPath(const QTemporaryDir& dir)
+{
+  return QDir(dir.path()).filePath(vpWebExportManifestName);
+}
+
+//-----------------------------------------------------------------------------
+QList<QByteArray> readManifest(const QTemporaryDir& dir)
+{
+  QList<QByteArray> lines;
+  QFile file(manifestPath(dir));
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+    while (!file.atEnd())
+      {
+      lines.append(file.readLine());
+      }
+    }
+  return lines;
+}
+
+//-----------------------------------------------------------------------------
+// Plan and write images 'a.png', 'b.png' (a different region of the same
+// frame) and 'c.png' (from another frame); \p n is the number to plan
+int exportImages(const QTemporaryDir& dir, int n, int offset = 0)
+{
+  const int extents[3][4] =
+    {
+      { offset, offset + 15, 0, 15 },
+      { 16, 31, 16, 31 },
+      { 0, 31, 0, 31 }
+    };
+  const char* const names[3] = { "a.png", "b.png", "c.png" };
+  const int frames[3] = { 0, 0, 1 };
+
+  vpWebExporter exporter(dir.path());
+  exporter.setThreadCount(2);
+  for (int i = 0; i < n; ++i)
+    {
+    exporter.addImage(frames[i], frameFile, names[i], extents[i], 1);
+    }
+  return exporter.execute();
+}
+
+//-----------------------------------------------------------------------------
+bool isPng(const QString& path)
+{
+  QFile file(path);
+  return file.open(QIODevice::ReadOnly) && file.read(4) == "\x89PNG";
+}
+
+//-----------------------------------------------------------------------------
+int testManifest(qtTest& testObject)
+{
+  QTemporaryDir dir;
+  TEST_EQUAL(exportImages(dir, 3), 0);
+
+  // Each line is the hexadecimal MD5 key of an image and the name of its
+  // file, in the order the images were written
+  const QRegExp format("[0-9a-f]{32} [abc]\\.png\n");
+  const QList<QByteArray> lines = readManifest(dir);
+  QSet<QByteArray> keys;
+  QSet<QByteArray> names;
+  foreach (const QByteArray& line, lines)
+    {
+    TEST(format.exactMatch(QString::fromUtf8(line)));
+    keys.insert(line.left(32));
+    names.insert(line.mid(33).trimmed());
+    }
+  TEST_EQUAL(lines.size(), 3);
+  TEST_EQUAL(keys.size(), 3);
+  TEST(names == (QSet<QByteArray>() << "a.png" << "b.png" << "c.png"));
+
+  foreach (const QByteArray& name, names)
+    {
+    TEST(isPng(QDir(dir.path()).filePath(QString::fromUtf8(name))));
+    }
+
+  // Exporting the same images again writes nothing
+  TEST_EQUAL(exportImages(dir, 3), 0);
+  TEST_EQUAL(readManifest(dir).size(), 3);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testResume(qtTest& testObject)
+{
+  QTemporaryDir dir;
+  const QDir outputDir(dir.path());
+  TEST_EQUAL(exportImages(dir, 2), 0);
+  TEST_EQUAL(readManifest(dir).size(), 2);
+
+  // Interrupt an export: replace the first image with something which is
+  // not an image, so that rewriting it can be detected, lose the second
+  // image, and leave an incomplete line at the end of the manifest
+  QFile a(outputDir.filePath("a.png"));
+  if (TEST(a.open(QIODevice::WriteOnly)) == 0)
+    {
+    a.write("not rewritten");
+    a.close();
+    }
+  TEST(QFile::remove(outputDir.filePath("b.png")));
+
+  QFile manifest(manifestPath(dir));
+  if (TEST(manifest.open(QIODevice::Append)) == 0)
+    {
+    manifest.write("0123abcd");
+    manifest.close();
+    }
+
+  // Resume the export, with one more image; only the images which are not
+  // both in the manifest and on disk are written
+  TEST_EQUAL(exportImages(dir, 3), 0);
+  TEST(!isPng(outputDir.filePath("a.png")));
+  TEST(isPng(outputDir.filePath("b.png")));
+  TEST(isPng(outputDir.filePath("c.png")));
+
+  // The incomplete line is ended rather than joined to the next image
+  QList<QByteArray> lines = readManifest(dir);
+  if (TEST_EQUAL(lines.size(), 5) == 0)
+    {
+    TEST_EQUAL(lines[2], QByteArray("0123abcd\n"));
+    QSet<QByteArray> resumed;
+    resumed << lines[3].mid(33).trimmed() << lines[4].mid(33).trimmed();
+    TEST(resumed == (QSet<QByteArray>() << "b.png" << "c.png"));
+    }
+
+  // An image planned from a different region is written again
+  TEST_EQUAL(exportImages(dir, 3, 8), 0);
+  TEST(isPng(outputDir.filePath("a.png")));
+  lines = readManifest(dir);
+  if (TEST_EQUAL(lines.size(), 6) == 0)
+    {
+    TEST_EQUAL(lines[5].mid(33).trimmed(), QByteArray("a.png"));
+    }
+
+  return 0;
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  qtTest testObject;
+
+  vpImageSourceFactory::GetInstance()->Register(&vtkVgPNGReader::Create);
+
+  // Write a frame from which to export images
+  QTemporaryDir tempDir;
+  frameFile = QDir(tempDir.path()).filePath("frame.png");
+
+  vtkNew<vtkImageData> frame;
+  frame->SetExtent(0, 63, 0, 63, 0, 0);
+  frame->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+  memset(frame->GetScalarPointer(), 128, 64 * 64 * 3);
+
+  vtkNew<vtkPNGWriter> writer;
+  writer->SetInputData(frame.GetPointer());
+  writer->SetFileName(qPrintable(frameFile));
+  writer->Write();
+  if (!QFileInfo(frameFile).exists())
+    {
+    testObject.out() << "unable to write test data\n";
+    return 1;
+    }
+
+  testObject.runSuite("Group Reads Tests", testGroupReads);
+  testObject.runSuite("Manifest Tests",    testManifest);
+  testObject.runSuite("Resume Tests",      testResume);
+
+  vpImageSourceFactory::OnApplicationExit();
+  return testObject.result();
+}
@@ -7,6 +7,7 @@
 #include "vpObjectSelectionPanel.h"
 
 #include "vgEventType.h"
+#include "vpTreeModel.h"
 #include "vpViewCore.h"
 #include "vtkVpTrackModel.h"
 
@@ -33,7 +34,7 @@
 //-----------------------------------------------------------------------------
 static void AddSortComboItem(const QString& fmt, QComboBox* cb, int type)
 {
-  cb->addItem(fmt.arg(vpTreeView::GetSortTypeString(type)), type);
+  cb->addItem(fmt.arg(vpTreeModel::GetSortTypeString(type)), type);
 }
 
 //-----------------------------------------------------------------------------
@@ -57,23 +58,23 @@ vpObjectSelectionPanel::vpObjectSelectionPanel(QWidget* p)
   QString fmt("Sort By %1");
 
   // Populate the various sort type combo boxes.
-  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeView::ST_Id);
-  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeView::ST_Name);
-  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeView::ST_Saliency);
-  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeView::ST_Probability);
+  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeModel::ST_Id);
+  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeModel::ST_Name);
+  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeModel::ST_Saliency);
+  AddSortComboItem(fmt, this->Ui->activitySortType, vpTreeModel::ST_Probability);
 
-  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeView::ST_Id);
-  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeView::ST_Name);
-  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeView::ST_Normalcy);
+  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeModel::ST_Id);
+  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeModel::ST_Name);
+  AddSortComboItem(fmt, this->Ui->eventSortType, vpTreeModel::ST_Normalcy);
 
-  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeView::ST_Id);
-  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeView::ST_Name);
-  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeView::ST_Normalcy);
-  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeView::ST_Length);
+  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeModel::ST_Id);
+  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeModel::ST_Name);
+  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeModel::ST_Normalcy);
+  AddSortComboItem(fmt, this->Ui->trackSortType, vpTreeModel::ST_Length);
 
-  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeView::ST_Id);
-  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeView::ST_Name);
-  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeView::ST_Probability);
+  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeModel::ST_Id);
+  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeModel::ST_Name);
+  AddSortComboItem(fmt, this->Ui->fseSortType, vpTreeModel::ST_Probability);
 
   connect(this->Ui->activitySortType,
           SIGNAL(currentIndexChanged(int)),
@@ -353,7 +354,7 @@ QList<vtkIdType> vpObjectSelectionPanel::GetSelectedItems(int type)
 
   vgItemInfo info;
   QList<vtkIdType> ids;
-  foreach(QTreeWidgetItem* item, tree->selectedItems())
+  foreach (const QModelIndex& item, tree->GetSelectedIndexes())
     {
     tree->GetItemInfo(item, info.Type, info.Id, info.ParentId, info.Index);
     if (info.Type == type)
@@ -366,7 +367,7 @@ QList<vtkIdType> vpObjectSelectionPanel::GetSelectedItems(int type)
 }
 
 //-----------------------------------------------------------------------------
-void vpObjectSelectionPanel::OnTreeHoverItemChanged(QTreeWidgetItem* item)
+void vpObjectSelectionPanel::OnTreeHoverItemChanged(const QModelIndex& item)
 {
   this->CurrentTree()->GetItemInfo(item,
                                    this->HoveredItem.Type,
@@ -389,7 +390,7 @@ void vpObjectSelectionPanel::OnTreeHoverStopped()
 void vpObjectSelectionPanel::OnTreeSelectionChanged()
 {
   vpTreeView* tree = this->CurrentTree();
-  QList<QTreeWidgetItem*> items = tree->selectedItems();
+  QModelIndexList items = tree->GetSelectedIndexes();
 
   if (items.isEmpty())
     {
@@ -400,8 +401,8 @@ void vpObjectSelectionPanel::OnTreeSelectionChanged()
     }
   else
     {
-    QTreeWidgetItem* item = items.first();
-    tree->GetItemInfo(item, this->SelectedItem.Type, this->SelectedItem.Id,
+    tree->GetItemInfo(items.first(),
+                      this->SelectedItem.Type, this->SelectedItem.Id,
                       this->SelectedItem.ParentId, this->SelectedItem.Index);
     }
 
@@ -411,7 +412,7 @@ void vpObjectSelectionPanel::OnTreeSelectionChanged()
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::OnTreeContextMenu(QMenu& menu)
 {
-  int numSelections = this->CurrentTree()->selectedItems().size();
+  int numSelections = this->CurrentTree()->GetSelectedIndexes().size();
   switch (this->CurrentTab())
     {
     case vgObjectTypeDefinitions::Activity:
@@ -561,7 +562,7 @@ void vpObjectSelectionPanel::AddSetStatusActions(QMenu* menu,
                                                  QSignalMapper* mapper,
                                                  int curStatus)
 {
-  int numSelections = this->CurrentTree()->selectedItems().size();
+  int numSelections = this->CurrentTree()->GetSelectedIndexes().size();
 
   QAction* a;
   a = menu->addAction("None", mapper, SLOT(map()));
@@ -583,14 +584,14 @@ void vpObjectSelectionPanel::AddSetStatusActions(QMenu* menu,
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::CreateEvent(int type)
 {
-  QList<QTreeWidgetItem*> trackItems = this->CurrentTree()->selectedItems();
+  QModelIndexList trackItems = this->CurrentTree()->GetSelectedIndexes();
 
   vtkIdList* idl = vtkIdList::New();
   idl->SetNumberOfIds(trackItems.size());
 
   vgItemInfo info;
   vtkIdType i = 0;
-  foreach (QTreeWidgetItem* item, trackItems)
+  foreach (const QModelIndex& item, trackItems)
     {
     this->CurrentTree()->GetItemInfo(item, info.Type, info.Id,
                                      info.ParentId, info.Index);
@@ -641,10 +642,10 @@ void vpObjectSelectionPanel::ImproveTrack()
 void vpObjectSelectionPanel::SetEventStatus(int status)
 {
   vgItemInfo info;
-  QList<QTreeWidgetItem*> items = this->CurrentTree()->selectedItems();
+  QModelIndexList items = this->CurrentTree()->GetSelectedIndexes();
 
   // set the status on all selected events
-  foreach (QTreeWidgetItem* item, items)
+  foreach (const QModelIndex& item, items)
     {
     this->CurrentTree()->GetItemInfo(item, info.Type, info.Id,
                                      info.ParentId, info.Index);
@@ -663,10 +664,10 @@ void vpObjectSelectionPanel::SetEventStatus(int status)
 void vpObjectSelectionPanel::SetActivityStatus(int status)
 {
   vgItemInfo info;
-  QList<QTreeWidgetItem*> items = this->CurrentTree()->selectedItems();
+  QModelIndexList items = this->CurrentTree()->GetSelectedIndexes();
 
   // set the status on all selected events
-  foreach (QTreeWidgetItem* item, items)
+  foreach (const QModelIndex& item, items)
     {
     this->CurrentTree()->GetItemInfo(item, info.Type, info.Id,
                                      info.ParentId, info.Index);
@@ -685,10 +686,10 @@ void vpObjectSelectionPanel::SetActivityStatus(int status)
 void vpObjectSelectionPanel::SetTrackStatus(int status)
 {
   vgItemInfo info;
-  QList<QTreeWidgetItem*> items = this->CurrentTree()->selectedItems();
+  QModelIndexList items = this->CurrentTree()->GetSelectedIndexes();
 
   // set the status on all selected events
-  foreach (QTreeWidgetItem* item, items)
+  foreach (const QModelIndex& item, items)
     {
     this->CurrentTree()->GetItemInfo(item, info.Type, info.Id,
                                      info.ParentId, info.Index);
@@ -726,7 +727,8 @@ void vpObjectSelectionPanel::AddEventToActivity()
   vtkVgActivity* a = this->ActivityManager->GetActivity(this->SelectedItem.Id);
   a->AddEvent(event);
 
-  this->CurrentTree()->UpdateActivityItem(this->CurrentTree()->currentItem());
+  this->CurrentTree()->UpdateActivityItem(
+    this->CurrentTree()->currentIndex());
 
   this->ActivityManager->Modified();
   emit this->ItemsChanged();
@@ -738,57 +740,20 @@ void vpObjectSelectionPanel::RemoveEventFromActivity()
   vtkVgActivity* a = this->ActivityManager->GetActivity(this->SelectedItem.ParentId);
   a->RemoveEvent(this->SelectedItem.Index);
 
-  this->CurrentTree()->UpdateActivityItem(this->CurrentTree()->currentItem()->parent());
+  this->CurrentTree()->UpdateActivityItem(
+    this->CurrentTree()->currentIndex().parent());
 
   this->ActivityManager->Modified();
   emit this->ItemsChanged();
 }
 
 //-----------------------------------------------------------------------------
-void vpObjectSelectionPanel::OnTreeItemsChanged(const QList<QTreeWidgetItem*>& items,
+void vpObjectSelectionPanel::OnTreeItemsChanged(int numShown, int numHidden,
                                                 bool updateStatus)
 {
-  bool changed = false;
-
-  vpTreeView* tree = this->CurrentTree();
-
-  int numShown = 0;
-  int numHidden = 0;
-
-  // update the display status for each changed item
-  foreach (QTreeWidgetItem* item, items)
-    {
-    int itemType, itemId;
-    int parentItemId, index;
-    tree->GetItemInfo(item, itemType, itemId, parentItemId, index);
-
-    bool displayObject = item->checkState(0) != Qt::Unchecked;
-    displayObject ? ++numShown : ++numHidden;
-
-    switch (itemType)
-      {
-      case vgObjectTypeDefinitions::Activity:
-        // @TODO: this is linear in the number of activities
-        this->ActivityManager->SetActivityState(
-          this->ActivityManager->GetActivity(itemId), displayObject);
-        changed = true;
-        break;
-
-      case vgObjectTypeDefinitions::Event:
-        this->EventModel->SetEventDisplayState(itemId, displayObject);
-        changed = true;
-        break;
-
-      case vgObjectTypeDefinitions::SceneElement:
-      case vgObjectTypeDefinitions::Track:
-        this->TrackModel->SetTrackDisplayState(itemId, displayObject);
-        changed = true;
-        break;
-      }
-    }
-
+  // The tree has already updated the display state of the changed objects;
   // update the viewport
-  if (changed)
+  if (numShown > 0 || numHidden > 0)
     {
     emit this->ItemsChanged();
     }
@@ -998,7 +963,7 @@ void vpObjectSelectionPanel::FocusItemAlone()
   this->TrackModel->TurnOffAllTracks();
 
   // turn on the selected item
-  QTreeWidgetItem* item = this->CurrentTree()->selectedItems().first();
+  QModelIndex item = this->CurrentTree()->GetSelectedIndexes().first();
   this->SetItemDisplayState(item, true);
 
   // make sure the item type is visible
@@ -1010,13 +975,13 @@ void vpObjectSelectionPanel::FocusItemAlone()
 void vpObjectSelectionPanel::FocusItem()
 {
   // first, make sure the item is selected for display
-  QTreeWidgetItem* item = this->CurrentTree()->selectedItems().first();
-  item->setCheckState(0, Qt::Checked);
+  QModelIndex item = this->CurrentTree()->GetSelectedIndexes().first();
+  this->CurrentTree()->SetCheckState(item, Qt::Checked);
   this->FocusItem(item);
 }
 
 //-----------------------------------------------------------------------------
-void vpObjectSelectionPanel::FocusItem(QTreeWidgetItem* item)
+void vpObjectSelectionPanel::FocusItem(const QModelIndex& item)
 {
   int itemType, itemId;
   int parentItemId, index;
@@ -1079,7 +1044,7 @@ void vpObjectSelectionPanel::OnGoToEndFrame()
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::FollowTrack()
 {
-  QList<QTreeWidgetItem*> trackItem = this->CurrentTree()->selectedItems();
+  QModelIndexList trackItem = this->CurrentTree()->GetSelectedIndexes();
 
   vgItemInfo info;
   this->CurrentTree()->GetItemInfo(trackItem[0], info.Type, info.Id,
@@ -1115,9 +1080,9 @@ void vpObjectSelectionPanel::OnHideLinkedActivities()
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::ToggleLinkedEvents(bool state)
 {
-  QList<QTreeWidgetItem*> trackItems = this->CurrentTree()->selectedItems();
+  QModelIndexList trackItems = this->CurrentTree()->GetSelectedIndexes();
 
-  foreach (auto trackItem, trackItems)
+  foreach (const QModelIndex& trackItem, trackItems)
     {
     vgItemInfo info;
     this->CurrentTree()->GetItemInfo(trackItem, info.Type, info.Id,
@@ -1140,9 +1105,9 @@ void vpObjectSelectionPanel::ToggleLinkedEvents(bool state)
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::ToggleLinkedActivities(bool state)
 {
-  QList<QTreeWidgetItem*> trackItems = this->CurrentTree()->selectedItems();
+  QModelIndexList trackItems = this->CurrentTree()->GetSelectedIndexes();
 
-  foreach (auto trackItem, trackItems)
+  foreach (const QModelIndex& trackItem, trackItems)
     {
     vgItemInfo info;
     this->CurrentTree()->GetItemInfo(trackItem, info.Type, info.Id,
@@ -1177,16 +1142,16 @@ void vpObjectSelectionPanel::SetupTab()
   prevTree->disconnect(this);
 
   // connect signals to current tab's tree
-  connect(currTree, SIGNAL(itemSelectionChanged()),
+  connect(currTree, SIGNAL(SelectionChanged()),
           this, SLOT(OnTreeSelectionChanged()));
 
-  connect(currTree, SIGNAL(itemEntered(QTreeWidgetItem*, int)),
-          this, SLOT(OnTreeHoverItemChanged(QTreeWidgetItem*)));
+  connect(currTree, SIGNAL(entered(QModelIndex)),
+          this, SLOT(OnTreeHoverItemChanged(QModelIndex)));
 
   connect(currTree, SIGNAL(MouseLeft()), this, SLOT(OnTreeHoverStopped()));
 
-  connect(currTree, SIGNAL(ItemsChanged(const QList<QTreeWidgetItem*>&, bool)),
-          this, SLOT(OnTreeItemsChanged(const QList<QTreeWidgetItem*>&, bool)));
+  connect(currTree, SIGNAL(ItemsChanged(int, int, bool)),
+          this, SLOT(OnTreeItemsChanged(int, int, bool)));
 
   connect(currTree, SIGNAL(FocusItemAlone()), this, SLOT(FocusItemAlone()));
   connect(currTree, SIGNAL(FocusItem()), this, SLOT(FocusItem()));
@@ -1223,22 +1188,20 @@ void vpObjectSelectionPanel::RefreshTreeView()
 //-----------------------------------------------------------------------------
 void vpObjectSelectionPanel::RebuildTreeView()
 {
+  // The trees keep their existing items, adding and removing only those whose
+  // objects have been added or removed
   switch (this->CurrentTab())
     {
     case vgObjectTypeDefinitions::Activity:
-      this->Ui->activityTree->Clear();
       this->Ui->activityTree->AddAllActivities();
       break;
     case vgObjectTypeDefinitions::Event:
-      this->Ui->eventTree->Clear();
       this->Ui->eventTree->AddAllEvents();
       break;
     case vgObjectTypeDefinitions::Track:
-      this->Ui->trackTree->Clear();
       this->Ui->trackTree->AddAllTracks();
       break;
     case vgObjectTypeDefinitions::SceneElement:
-      this->Ui->fseTree->Clear();
       this->Ui->fseTree->AddAllSceneElements();
       break;
     }
@@ -1317,11 +1280,11 @@ void vpObjectSelectionPanel::OnShowAll()
 void vpObjectSelectionPanel::OnAddEventsToGraphModel()
 {
   vpTreeView* tree = this->CurrentTree();
-  QList<QTreeWidgetItem*> items = tree->selectedItems();
+  QModelIndexList items = tree->GetSelectedIndexes();
   QList<int> ids;
 
   vgItemInfo info;
-  foreach (QTreeWidgetItem* item, items)
+  foreach (const QModelIndex& item, items)
     {
     tree->GetItemInfo(item, info.Type, info.Id,
                       info.ParentId, info.Index);
@@ -1350,7 +1313,8 @@ void vpObjectSelectionPanel::UpdateItemVisibility()
 }
 
 //-----------------------------------------------------------------------------
-int vpObjectSelectionPanel::SetItemDisplayState(QTreeWidgetItem* item, bool on)
+int vpObjectSelectionPanel::SetItemDisplayState(const QModelIndex& item,
+                                                bool on)
 {
   int itemType, itemId;
   int parentItemId, index;
@@ -1359,9 +1323,7 @@ int vpObjectSelectionPanel::SetItemDisplayState(QTreeWidgetItem* item, bool on)
   switch (itemType)
     {
     case vgObjectTypeDefinitions::Activity:
-      // @TODO: this is linear in the number of activities
-      this->ActivityManager->SetActivityState(
-        this->ActivityManager->GetActivity(itemId), on);
+      this->ActivityManager->SetActivityDisplayState(itemId, on);
       emit this->ItemsChanged();
       return vgObjectTypeDefinitions::Activity;
 
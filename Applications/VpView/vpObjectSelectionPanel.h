@@ -29,8 +29,8 @@ class vtkVgTrackFilter;
 class vtkVgTrackTypeRegistry;
 
 class QMenu;
+class QModelIndex;
 class QSignalMapper;
-class QTreeWidgetItem;
 
 struct vgItemInfo
 {
@@ -123,11 +123,10 @@ protected slots:
   void SetActivityStatus(int status);
   void SetTrackStatus(int status);
 
-  void OnTreeHoverItemChanged(QTreeWidgetItem* item);
+  void OnTreeHoverItemChanged(const QModelIndex& item);
   void OnTreeHoverStopped();
 
-  void OnTreeItemsChanged(const QList<QTreeWidgetItem*>& items,
-                          bool updateStatus);
+  void OnTreeItemsChanged(int numShown, int numHidden, bool updateStatus);
 
   void OnObjectTypeChanged(int);
 
@@ -191,9 +190,9 @@ private:
 
   void UpdateItemVisibility();
 
-  int SetItemDisplayState(QTreeWidgetItem* item, bool on);
+  int SetItemDisplayState(const QModelIndex& item, bool on);
 
-  void FocusItem(QTreeWidgetItem* item);
+  void FocusItem(const QModelIndex& item);
 
 private:
   Ui::vpObjectSelectionPanel* Ui;
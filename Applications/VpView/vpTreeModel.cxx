@@ -0,0 +1,1404 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vpTreeModel.h"
+
+#include "vtkVgActivity.h"
+#include "vtkVgActivityManager.h"
+#include "vtkVgEvent.h"
+#include "vtkVgEventFilter.h"
+#include "vtkVgEventModel.h"
+#include "vtkVgEventTypeRegistry.h"
+#include "vtkVgTrack.h"
+#include "vtkVgTrackFilter.h"
+#include "vtkVgTrackModel.h"
+#include "vtkVgTrackTypeRegistry.h"
+
+#include "vgEventType.h"
+#include "vgTrackType.h"
+
+#include <QBrush>
+#include <QFont>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QPalette>
+#include <QSet>
+
+namespace // anonymous
+{
+
+// Removing many separate runs of rows one run at a time is more expensive
+// than rebuilding the whole tree; past this many runs, the model is reset
+const int MaxRemovedRanges = 64;
+
+//-----------------------------------------------------------------------------
+int childType(int type)
+{
+  switch (type)
+    {
+    case vgObjectTypeDefinitions::Activity:
+      return vgObjectTypeDefinitions::Event;
+    case vgObjectTypeDefinitions::Event:
+      return vgObjectTypeDefinitions::Track;
+    default:
+      return -1;
+    }
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+struct vpTreeModel::Node
+{
+  Node(int type, int id, int index, Node* parent, int row)
+    : Type(type), Id(id), Index(index), Row(row), Sticky(false),
+      Populated(false), Parent(parent)
+    {}
+
+  ~Node() { qDeleteAll(this->Children); }
+
+  int Type;
+  int Id;
+  int Index; // index of the object in the parent's object, or -1
+  int Row;
+  bool Sticky;
+  bool Populated;
+
+  Node* Parent;
+  QList<Node*> Children;
+};
+
+//-----------------------------------------------------------------------------
+struct vpTreeModel::StateCounts
+{
+  StateCounts() : Shown(0), Hidden(0) {}
+
+  int Shown;
+  int Hidden;
+};
+
+//-----------------------------------------------------------------------------
+vpTreeModel::vpTreeModel(QObject* p)
+  : QAbstractItemModel(p), ActivityManager(0), EventModel(0), TrackModel(0),
+    TrackFilter(0), EventFilter(0), TrackTypeRegistry(0),
+    EventTypeRegistry(0), Root(new Node(-1, -1, -1, 0, -1))
+{
+  this->Root->Populated = true;
+}
+
+//-----------------------------------------------------------------------------
+vpTreeModel::~vpTreeModel()
+{
+  delete this->Root;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::Initialize(vtkVgActivityManager* activityManager,
+                             vtkVgEventModel* eventModel,
+                             vtkVgTrackModel* trackModel,
+                             vtkVgEventFilter* eventFilter,
+                             vtkVgTrackFilter* trackFilter,
+                             vtkVgEventTypeRegistry* eventTypes,
+                             vtkVgTrackTypeRegistry* trackTypes)
+{
+  this->beginResetModel();
+
+  this->ActivityManager = activityManager;
+  this->EventModel = eventModel;
+  this->TrackModel = trackModel;
+
+  this->TrackFilter = trackFilter;
+  this->EventFilter = eventFilter;
+  this->TrackTypeRegistry = trackTypes;
+  this->EventTypeRegistry = eventTypes;
+
+  qDeleteAll(this->Root->Children);
+  this->Root->Children.clear();
+  this->TopLevelNodes.clear();
+  this->ActivityIndices.clear();
+
+  this->endResetModel();
+}
+
+//-----------------------------------------------------------------------------
+vpTreeModel::Node* vpTreeModel::NodeFromIndex(const QModelIndex& index) const
+{
+  return index.isValid() ? static_cast<Node*>(index.internalPointer())
+                         : this->Root;
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::IndexFromNode(Node* node) const
+{
+  return node == this->Root ? QModelIndex()
+                            : this->createIndex(node->Row, 0, node);
+}
+
+//-----------------------------------------------------------------------------
+int vpTreeModel::GetChildObjectCount(const Node* node) const
+{
+  switch (node->Type)
+    {
+    case ItemType::Activity:
+      {
+      vtkVgActivity* a = this->GetActivity(node->Id);
+      return a ? static_cast<int>(a->GetNumberOfEvents()) : 0;
+      }
+
+    case ItemType::Event:
+      {
+      vtkVgEvent* e = this->EventModel->GetEvent(node->Id);
+      return e ? static_cast<int>(e->GetNumberOfTracks()) : 0;
+      }
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::GetChildObjectIds(int type, int id, QVector<int>& ids) const
+{
+  switch (type)
+    {
+    case ItemType::Activity:
+      if (vtkVgActivity* a = this->GetActivity(id))
+        {
+        const int numEvents = a->GetNumberOfEvents();
+        ids.reserve(numEvents);
+        for (int j = 0; j < numEvents; ++j)
+          {
+          ids.append(a->GetEvent(j)->GetId());
+          }
+        }
+      break;
+
+    case ItemType::Event:
+      if (vtkVgEvent* e = this->EventModel->GetEvent(id))
+        {
+        const int numTracks = e->GetNumberOfTracks();
+        ids.reserve(numTracks);
+        for (int k = 0; k < numTracks; ++k)
+          {
+          ids.append(e->GetTrackId(k));
+          }
+        }
+      break;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vpTreeModel::GetActivityIndex(int id) const
+{
+  vtkVgActivityManager* const am = this->ActivityManager;
+  const int numActivities = am->GetNumberOfActivities();
+
+  const int index = this->ActivityIndices.value(id, -1);
+  if (index >= 0 && index < numActivities &&
+      am->GetActivity(index)->GetId() == id)
+    {
+    return index;
+    }
+
+  // the activities have changed since the indices were last looked up
+  this->ActivityIndices.clear();
+  this->ActivityIndices.reserve(numActivities);
+  for (int i = 0; i < numActivities; ++i)
+    {
+    this->ActivityIndices.insert(am->GetActivity(i)->GetId(), i);
+    }
+  return this->ActivityIndices.value(id, -1);
+}
+
+//-----------------------------------------------------------------------------
+vtkVgActivity* vpTreeModel::GetActivity(int id) const
+{
+  const int index = this->GetActivityIndex(id);
+  return index >= 0 ? this->ActivityManager->GetActivity(index) : 0;
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::ContainsObject(int type, int id,
+                                 int descendantType, int descendantId) const
+{
+  QVector<int> ids;
+  this->GetChildObjectIds(type, id, ids);
+
+  const int ct = childType(type);
+  foreach (int cid, ids)
+    {
+    if ((ct == descendantType && cid == descendantId) ||
+        this->ContainsObject(ct, cid, descendantType, descendantId))
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::Populate(Node* node) const
+{
+  QVector<int> ids;
+  this->GetChildObjectIds(node->Type, node->Id, ids);
+  this->Populate(node, ids);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::Populate(Node* node, const QVector<int>& ids) const
+{
+  const int ct = childType(node->Type);
+  node->Children.reserve(ids.size());
+  for (int i = 0, end = ids.size(); i < end; ++i)
+    {
+    // store the index of the child object in addition to its id
+    node->Children.append(new Node(ct, ids[i], i, node, i));
+    }
+  node->Populated = true;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::RemoveChildren(Node* node, int first, int last)
+{
+  this->beginRemoveRows(this->IndexFromNode(node), first, last);
+
+  for (int i = first; i <= last; ++i)
+    {
+    if (node == this->Root)
+      {
+      this->TopLevelNodes.remove(node->Children[i]->Id);
+      }
+    delete node->Children[i];
+    }
+  node->Children.erase(node->Children.begin() + first,
+                       node->Children.begin() + last + 1);
+
+  for (int i = first, end = node->Children.size(); i < end; ++i)
+    {
+    node->Children[i]->Row = i;
+    }
+
+  this->endRemoveRows();
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SyncChildren(Node* node)
+{
+  QVector<int> ids;
+  this->GetChildObjectIds(node->Type, node->Id, ids);
+
+  bool same = ids.size() == node->Children.size();
+  for (int i = 0, end = ids.size(); same && i < end; ++i)
+    {
+    same = node->Children[i]->Id == ids[i];
+    }
+
+  if (same)
+    {
+    // the children are the same objects, but their own children may not be
+    foreach (Node* child, node->Children)
+      {
+      if (child->Populated)
+        {
+        this->SyncChildren(child);
+        }
+      }
+    return;
+    }
+
+  if (!node->Children.isEmpty())
+    {
+    this->RemoveChildren(node, 0, node->Children.size() - 1);
+    }
+  if (!ids.isEmpty())
+    {
+    this->beginInsertRows(this->IndexFromNode(node), 0, ids.size() - 1);
+    this->Populate(node, ids);
+    this->endInsertRows();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SyncTopLevel(int type, const QVector<int>& ids)
+{
+  QSet<int> current;
+  current.reserve(ids.size());
+  foreach (int id, ids)
+    {
+    current.insert(id);
+    }
+
+  QList<Node*>& children = this->Root->Children;
+
+  // Find the runs of items whose objects no longer exist
+  QList<QPair<int, int> > removed;
+  for (int row = children.size() - 1; row >= 0; --row)
+    {
+    if (children[row]->Type == type && current.contains(children[row]->Id))
+      {
+      continue;
+      }
+    const int last = row;
+    while (row > 0 && !(children[row - 1]->Type == type &&
+                        current.contains(children[row - 1]->Id)))
+      {
+      --row;
+      }
+    removed.append(qMakePair(row, last));
+    }
+
+  if (removed.size() > MaxRemovedRanges)
+    {
+    // Too many scattered removals; rebuild the top level items, keeping the
+    // sticky flags of those that remain
+    QSet<int> sticky;
+    foreach (Node* node, children)
+      {
+      if (node->Sticky)
+        {
+        sticky.insert(node->Id);
+        }
+      }
+
+    this->beginResetModel();
+    qDeleteAll(children);
+    children.clear();
+    this->TopLevelNodes.clear();
+
+    children.reserve(ids.size());
+    foreach (int id, ids)
+      {
+      Node* node = new Node(type, id, -1, this->Root, children.size());
+      node->Sticky = sticky.contains(id);
+      children.append(node);
+      this->TopLevelNodes.insert(id, node);
+      }
+    this->endResetModel();
+    return;
+    }
+
+  // Remove the runs back to front, so that the rows of the runs yet to be
+  // removed are not affected
+  typedef QPair<int, int> Range;
+  foreach (const Range& range, removed)
+    {
+    this->RemoveChildren(this->Root, range.first, range.second);
+    }
+
+  // The objects of the remaining items may have gained or lost children
+  foreach (Node* node, children)
+    {
+    if (node->Populated)
+      {
+      this->SyncChildren(node);
+      }
+    }
+
+  // Append items for new objects
+  QVector<int> added;
+  foreach (int id, ids)
+    {
+    if (!this->TopLevelNodes.contains(id))
+      {
+      added.append(id);
+      }
+    }
+
+  if (!added.isEmpty())
+    {
+    const int first = children.size();
+    this->beginInsertRows(QModelIndex(), first, first + added.size() - 1);
+    children.reserve(first + added.size());
+    foreach (int id, added)
+      {
+      Node* node = new Node(type, id, -1, this->Root, children.size());
+      children.append(node);
+      this->TopLevelNodes.insert(id, node);
+      }
+    this->endInsertRows();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::AddAllActivities()
+{
+  vtkVgActivityManager* am = this->ActivityManager;
+
+  QVector<int> ids;
+  const int numActivities = am->GetNumberOfActivities();
+  ids.reserve(numActivities);
+  this->ActivityIndices.clear();
+  for (int i = 0; i < numActivities; ++i)
+    {
+    const int id = am->GetActivity(i)->GetId();
+    ids.append(id);
+    this->ActivityIndices.insert(id, i);
+    }
+
+  this->SyncTopLevel(ItemType::Activity, ids);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::AddAllEvents()
+{
+  vtkVgEventModel* em = this->EventModel;
+
+  QVector<int> ids;
+  ids.reserve(em->GetNumberOfEvents());
+
+  em->InitEventTraversal();
+  while (vtkVgEvent* event = em->GetNextEvent().GetEvent())
+    {
+    ids.append(event->GetId());
+    }
+
+  this->SyncTopLevel(ItemType::Event, ids);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::AddAllTracks()
+{
+  vtkVgTrackModel* tm = this->TrackModel;
+
+  QVector<int> ids;
+  ids.reserve(tm->GetNumberOfTracks());
+
+  tm->InitTrackTraversal();
+  while (vtkVgTrack* track = tm->GetNextTrack().GetTrack())
+    {
+    if (!(track->GetDisplayFlags() & vtkVgTrack::DF_SceneElement))
+      {
+      ids.append(track->GetId());
+      }
+    }
+
+  this->SyncTopLevel(ItemType::Track, ids);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::AddAllSceneElements()
+{
+  vtkVgTrackModel* tm = this->TrackModel;
+
+  QVector<int> ids;
+
+  tm->InitTrackTraversal();
+  while (vtkVgTrack* track = tm->GetNextTrack().GetTrack())
+    {
+    if (track->GetDisplayFlags() & vtkVgTrack::DF_SceneElement)
+      {
+      ids.append(track->GetId());
+      }
+    }
+
+  this->SyncTopLevel(ItemType::SceneElement, ids);
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::AddTrack(vtkVgTrack* track, bool isFseTrack)
+{
+  const int id = track->GetId();
+  if (Node* node = this->TopLevelNodes.value(id))
+    {
+    return this->IndexFromNode(node);
+    }
+
+  QList<Node*>& children = this->Root->Children;
+  const int row = children.size();
+
+  this->beginInsertRows(QModelIndex(), row, row);
+  Node* node = new Node(isFseTrack ? ItemType::SceneElement : ItemType::Track,
+                        id, -1, this->Root, row);
+  children.append(node);
+  this->TopLevelNodes.insert(id, node);
+  this->endInsertRows();
+
+  return this->IndexFromNode(node);
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::AddEvent(vtkVgEvent* event)
+{
+  const int id = event->GetId();
+  if (Node* node = this->TopLevelNodes.value(id))
+    {
+    return this->IndexFromNode(node);
+    }
+
+  QList<Node*>& children = this->Root->Children;
+  const int row = children.size();
+
+  this->beginInsertRows(QModelIndex(), row, row);
+  Node* node = new Node(ItemType::Event, id, -1, this->Root, row);
+  children.append(node);
+  this->TopLevelNodes.insert(id, node);
+  this->endInsertRows();
+
+  return this->IndexFromNode(node);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::Clear()
+{
+  this->beginResetModel();
+  qDeleteAll(this->Root->Children);
+  this->Root->Children.clear();
+  this->TopLevelNodes.clear();
+  this->endResetModel();
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::Refresh()
+{
+  this->EmitSubtreeChanged(this->Root);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::EmitSubtreeChanged(Node* node)
+{
+  if (node->Children.isEmpty())
+    {
+    return;
+    }
+
+  // one signal for all of the children, rather than one per item
+  emit this->dataChanged(
+    this->createIndex(0, 0, node->Children.first()),
+    this->createIndex(node->Children.size() - 1, 0, node->Children.last()));
+
+  foreach (Node* child, node->Children)
+    {
+    if (child->Populated)
+      {
+      this->EmitSubtreeChanged(child);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+vpTreeModel::Node* vpTreeModel::FindDescendant(Node* node, int type, int id)
+{
+  QVector<int> ids;
+  this->GetChildObjectIds(node->Type, node->Id, ids);
+
+  // perform a pre-order traversal of the objects, creating items only on the
+  // path to the object that was found
+  const int ct = childType(node->Type);
+  for (int i = 0, end = ids.size(); i < end; ++i)
+    {
+    const bool found = ct == type && ids[i] == id;
+    if (found || this->ContainsObject(ct, ids[i], type, id))
+      {
+      this->fetchMore(this->IndexFromNode(node));
+      Node* child = node->Children.value(i);
+      if (!child || found)
+        {
+        return child;
+        }
+      return this->FindDescendant(child, type, id);
+      }
+    }
+  return 0; // not found
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::FindItem(int type, int id)
+{
+  if (type == ItemType::Activity)
+    {
+    // activities are given by index, but their items are keyed by id
+    vtkVgActivityManager* am = this->ActivityManager;
+    if (!am || id < 0 || id >= am->GetNumberOfActivities())
+      {
+      return QModelIndex();
+      }
+    id = am->GetActivity(id)->GetId();
+    }
+
+  Node* node = this->TopLevelNodes.value(id);
+  if (node && node->Type == type)
+    {
+    return this->IndexFromNode(node);
+    }
+
+  foreach (Node* topLevelNode, this->Root->Children)
+    {
+    if (Node* child = this->FindDescendant(topLevelNode, type, id))
+      {
+      return this->IndexFromNode(child);
+      }
+    }
+  return QModelIndex();
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::FindChildItem(int parentType, int parentId,
+                                       int index)
+{
+  const QModelIndex parent = this->FindItem(parentType, parentId);
+  if (!parent.isValid())
+    {
+    return QModelIndex();
+    }
+
+  this->fetchMore(parent);
+  return this->index(index, 0, parent);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::UpdateItem(const QModelIndex& index)
+{
+  if (index.isValid())
+    {
+    emit this->dataChanged(index, index);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::UpdateActivityItem(const QModelIndex& index)
+{
+  Node* node = this->NodeFromIndex(index);
+  if (node == this->Root || node->Type != ItemType::Activity)
+    {
+    return;
+    }
+
+  emit this->dataChanged(index, index);
+
+  if (!node->Populated)
+    {
+    // the children will be created from the current events when needed
+    return;
+    }
+
+  vtkVgActivity* activity = this->GetActivity(node->Id);
+  if (!activity)
+    {
+    return;
+    }
+
+  // NOTE: We assume here that the child event items appear in the model in
+  // order of their index in the parent activity. The proxy may sort them
+  // differently, but that does not affect the order of the model itself.
+  int eventIndex = 0;
+  int childIndex = 0;
+  const int numEvents = activity->GetNumberOfEvents();
+  for (; eventIndex < numEvents && childIndex < node->Children.size();)
+    {
+    vtkVgEvent* event = activity->GetEvent(eventIndex);
+    Node* child = node->Children[childIndex];
+
+    if (event->GetId() == child->Id)
+      {
+      // update the index of the item
+      child->Index = eventIndex;
+      ++childIndex;
+      ++eventIndex;
+      }
+    else
+      {
+      // This event has a different id, so the event referred to in the tree
+      // must have been deleted. Remove the item.
+      this->RemoveChildren(node, childIndex, childIndex);
+      }
+    }
+
+  // remove any remaining dangling children
+  if (childIndex < node->Children.size())
+    {
+    this->RemoveChildren(node, childIndex, node->Children.size() - 1);
+    }
+
+  // Add new events to the tree. We assume new events are always added to the
+  // end of the activity event list.
+  if (eventIndex < numEvents)
+    {
+    const int first = node->Children.size();
+    this->beginInsertRows(index, first, first + numEvents - eventIndex - 1);
+    for (; eventIndex < numEvents; ++eventIndex)
+      {
+      node->Children.append(
+        new Node(ItemType::Event, activity->GetEvent(eventIndex)->GetId(),
+                 eventIndex, node, node->Children.size()));
+      }
+    this->endInsertRows();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::IsOn(int type, int id) const
+{
+  switch (type)
+    {
+    case ItemType::Activity:
+      {
+      const int index = this->GetActivityIndex(id);
+      return index >= 0 &&
+             this->ActivityManager->GetActivityDisplayState(index);
+      }
+
+    case ItemType::Event:
+      return this->EventModel->GetEventInfo(id).GetDisplayEvent();
+
+    case ItemType::Track:
+    case ItemType::SceneElement:
+      return this->TrackModel->GetTrackInfo(id).GetDisplayTrack();
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::IsShown(const Node* node) const
+{
+  const int id = node->Id;
+  switch (node->Type)
+    {
+    case ItemType::Activity:
+      {
+      const int index = this->GetActivityIndex(id);
+      if (index < 0)
+        {
+        return false;
+        }
+      vtkVgActivity* a = this->ActivityManager->GetActivity(index);
+      return !this->ActivityManager->ActivityIsFiltered(a) &&
+             this->ActivityManager->GetActivityFilteredDisplayState(index);
+      }
+
+    case ItemType::Event:
+      {
+      vtkVgEventInfo info = this->EventModel->GetEventInfo(id);
+      return this->EventFilter->GetBestClassifier(info.GetEvent()) >= 0 &&
+             info.GetPassesFilters();
+      }
+
+    case ItemType::Track:
+      {
+      vtkVgTrackInfo info = this->TrackModel->GetTrackInfo(id);
+      return this->TrackFilter->GetBestClassifier(info.GetTrack()) >= 0 &&
+             info.GetPassesFilters();
+      }
+
+    case ItemType::SceneElement:
+      return this->TrackModel->GetTrackInfo(id).GetPassesFilters();
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+int vpTreeModel::GetStatus(const Node* node) const
+{
+  switch (node->Type)
+    {
+    case ItemType::Activity:
+      {
+      vtkVgActivity* a = this->GetActivity(node->Id);
+      return a ? a->GetStatus() : vgObjectStatus::None;
+      }
+
+    case ItemType::Event:
+      {
+      vtkVgEvent* e = this->EventModel->GetEvent(node->Id);
+      return e ? e->GetStatus() : vgObjectStatus::None;
+      }
+
+    case ItemType::Track:
+    case ItemType::SceneElement:
+      {
+      vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+      return t ? t->GetStatus() : vgObjectStatus::None;
+      }
+    }
+  return vgObjectStatus::None;
+}
+
+//-----------------------------------------------------------------------------
+QString vpTreeModel::GetName(const Node* node) const
+{
+  switch (node->Type)
+    {
+    case ItemType::Activity:
+      {
+      vtkVgActivity* a = this->GetActivity(node->Id);
+      return a ? QString(a->GetName()) : QString();
+      }
+
+    case ItemType::Event:
+      {
+      vtkVgEvent* e = this->EventModel->GetEvent(node->Id);
+      return e ? QString(this->EventTypeRegistry->GetTypeById(
+                           e->GetActiveClassifierType()).GetName())
+               : QString();
+      }
+
+    case ItemType::Track:
+    case ItemType::SceneElement:
+      {
+      vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+      if (!t)
+        {
+        return QString();
+        }
+      const int type = t->GetType();
+      return type == -1
+               ? QString("track")
+               : QString(this->TrackTypeRegistry->GetType(type).GetName());
+      }
+    }
+  return QString();
+}
+
+//-----------------------------------------------------------------------------
+QVariant vpTreeModel::GetSortValue(const Node* node, int sortType) const
+{
+  switch (sortType)
+    {
+    case ST_Id:
+      return node->Id;
+
+    case ST_Name:
+      return this->GetName(node);
+
+    case ST_Normalcy:
+      if (node->Type == ItemType::Event)
+        {
+        vtkVgEvent* e = this->EventModel->GetEvent(node->Id);
+        return e ? e->GetActiveClassifierNormalcy() : QVariant();
+        }
+      if (node->Type == ItemType::Track)
+        {
+        vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+        return t ? t->GetNormalcy() : QVariant();
+        }
+      break;
+
+    case ST_Saliency:
+      if (node->Type == ItemType::Activity)
+        {
+        vtkVgActivity* a = this->GetActivity(node->Id);
+        return a ? a->GetSaliency() : QVariant();
+        }
+      break;
+
+    case ST_Probability:
+      if (node->Type == ItemType::Activity)
+        {
+        vtkVgActivity* a = this->GetActivity(node->Id);
+        return a ? a->GetProbability() : QVariant();
+        }
+      if (node->Type == ItemType::SceneElement)
+        {
+        vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+        return t ? t->GetNormalcy() : QVariant();
+        }
+      break;
+
+    case ST_Length:
+      if (node->Type == ItemType::Track ||
+          node->Type == ItemType::SceneElement)
+        {
+        vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+        if (!t)
+          {
+          break;
+          }
+
+        vtkVgTimeStamp startFrame = t->GetStartFrame();
+        vtkVgTimeStamp endFrame = t->GetEndFrame();
+        if (startFrame.HasTime() && endFrame.HasTime())
+          {
+          return endFrame.GetTime() - startFrame.GetTime();
+          }
+        return static_cast<double>(endFrame.GetFrameNumber() -
+                                   startFrame.GetFrameNumber());
+        }
+      break;
+    }
+  return QVariant();
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::index(int row, int column,
+                               const QModelIndex& parent) const
+{
+  if (row < 0 || column != 0)
+    {
+    return QModelIndex();
+    }
+
+  Node* node = this->NodeFromIndex(parent);
+  if (!node->Populated)
+    {
+    // no one has been told how many children there are, so it is safe to
+    // create them without notification
+    this->Populate(node);
+    }
+
+  if (row >= node->Children.size())
+    {
+    return QModelIndex();
+    }
+  return this->createIndex(row, 0, node->Children[row]);
+}
+
+//-----------------------------------------------------------------------------
+QModelIndex vpTreeModel::parent(const QModelIndex& index) const
+{
+  if (!index.isValid())
+    {
+    return QModelIndex();
+    }
+  return this->IndexFromNode(this->NodeFromIndex(index)->Parent);
+}
+
+//-----------------------------------------------------------------------------
+int vpTreeModel::rowCount(const QModelIndex& parent) const
+{
+  if (parent.column() > 0)
+    {
+    return 0;
+    }
+
+  Node* node = this->NodeFromIndex(parent);
+  if (!node->Populated)
+    {
+    this->Populate(node);
+    }
+  return node->Children.size();
+}
+
+//-----------------------------------------------------------------------------
+int vpTreeModel::columnCount(const QModelIndex& /*parent*/) const
+{
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::hasChildren(const QModelIndex& parent) const
+{
+  const Node* node = this->NodeFromIndex(parent);
+  return node->Populated ? !node->Children.isEmpty()
+                         : this->GetChildObjectCount(node) > 0;
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::canFetchMore(const QModelIndex& parent) const
+{
+  const Node* node = this->NodeFromIndex(parent);
+  return !node->Populated && this->GetChildObjectCount(node) > 0;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::fetchMore(const QModelIndex& parent)
+{
+  Node* node = this->NodeFromIndex(parent);
+  if (node->Populated)
+    {
+    return;
+    }
+
+  QVector<int> ids;
+  this->GetChildObjectIds(node->Type, node->Id, ids);
+  if (ids.isEmpty())
+    {
+    node->Populated = true;
+    return;
+    }
+
+  this->beginInsertRows(parent, 0, ids.size() - 1);
+  this->Populate(node, ids);
+  this->endInsertRows();
+}
+
+//-----------------------------------------------------------------------------
+Qt::ItemFlags vpTreeModel::flags(const QModelIndex& index) const
+{
+  if (!index.isValid())
+    {
+    return Qt::NoItemFlags;
+    }
+  return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
+
+//-----------------------------------------------------------------------------
+QVariant vpTreeModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid())
+    {
+    return QVariant();
+    }
+
+  const Node* node = this->NodeFromIndex(index);
+  switch (role)
+    {
+    case Qt::DisplayRole:
+      {
+      int displayId = node->Id;
+      if (node->Type == ItemType::SceneElement)
+        {
+        displayId = this->TrackModel->GetSceneElementIdForTrack(node->Id);
+        }
+      return QString("%1-%2").arg(this->GetName(node)).arg(displayId);
+      }
+
+    case Qt::CheckStateRole:
+      return this->IsOn(node->Type, node->Id) ? Qt::Checked : Qt::Unchecked;
+
+    case Qt::ForegroundRole:
+      if (!this->IsShown(node))
+        {
+        // gray out excluded (filtered) items
+        QPalette palette;
+        palette.setCurrentColorGroup(QPalette::Disabled);
+        return palette.windowText();
+        }
+      break;
+
+    case Qt::FontRole:
+      {
+      bool bold = false;
+      bool italic = false;
+      if (node->Type == ItemType::Event)
+        {
+        // show modifiable events in bold type
+        vtkVgEvent* e = this->EventModel->GetEvent(node->Id);
+        bold = e && e->IsModifiable();
+        }
+      else if (node->Type == ItemType::Track ||
+               node->Type == ItemType::SceneElement)
+        {
+        vtkVgTrack* t = this->TrackModel->GetTrack(node->Id);
+        bold = t && t->IsModifiable();
+        italic = t && t->IsUserCreated();
+        }
+      if (bold || italic)
+        {
+        QFont f;
+        f.setBold(bold);
+        f.setItalic(italic);
+        return f;
+        }
+      break;
+      }
+
+    case Qt::BackgroundRole:
+      // set background color based on item status
+      switch (this->GetStatus(node))
+        {
+        case vgObjectStatus::Positive:
+          return QBrush(QColor(159, 202, 166));
+        case vgObjectStatus::Negative:
+          return QBrush(QColor(255, 106, 106));
+        }
+      break;
+
+    case Qt::DecorationRole:
+      if (node->Sticky)
+        {
+        return QIcon(":/icons/16x16/pin");
+        }
+      break;
+
+    case IDR_ItemType:
+      return node->Type;
+
+    case IDR_ItemId:
+      return node->Type == ItemType::Activity
+               ? this->GetActivityIndex(node->Id) : node->Id;
+
+    case IDR_ItemIndex:
+      return node->Index;
+
+    case IDR_ItemSticky:
+      return node->Sticky;
+
+    case IDR_ItemShown:
+      return this->IsShown(node);
+
+    default:
+      if (role >= IDR_ItemSortValsStart &&
+          role <= IDR_ItemSortValsStart + ST_Length)
+        {
+        return this->GetSortValue(node, role - IDR_ItemSortValsStart);
+        }
+      break;
+    }
+
+  return QVariant();
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::setData(const QModelIndex& index, const QVariant& value,
+                          int role)
+{
+  if (!index.isValid())
+    {
+    return false;
+    }
+
+  Node* node = this->NodeFromIndex(index);
+  switch (role)
+    {
+    case Qt::CheckStateRole:
+      {
+      const bool on = value.toInt() != Qt::Unchecked;
+      StateCounts counts;
+
+      // set child state as well unless holding Ctrl
+      if ((QGuiApplication::keyboardModifiers() & Qt::ControlModifier) == 0)
+        {
+        this->SetStateRecursive(node->Type, node->Id, on, counts);
+        }
+      else
+        {
+        this->SetState(node->Type, node->Id, on, counts);
+        }
+
+      emit this->dataChanged(index, index);
+      this->EmitSubtreeChanged(node);
+      emit this->DisplayStatesChanged(counts.Shown, counts.Hidden,
+                                      counts.Shown + counts.Hidden > 1);
+      return true;
+      }
+
+    case IDR_ItemSticky:
+      if (node->Parent != this->Root)
+        {
+        return false;
+        }
+      node->Sticky = value.toBool();
+      emit this->dataChanged(index, index);
+      return true;
+    }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeModel::SetState(int type, int id, bool on, StateCounts& counts)
+{
+  if (this->IsOn(type, id) == on)
+    {
+    return false;
+    }
+
+  switch (type)
+    {
+    case ItemType::Activity:
+      {
+      const int index = this->GetActivityIndex(id);
+      if (index < 0)
+        {
+        return false;
+        }
+      this->ActivityManager->SetActivityDisplayState(index, on);
+      break;
+      }
+
+    case ItemType::Event:
+      this->EventModel->SetEventDisplayState(id, on);
+      break;
+
+    case ItemType::Track:
+    case ItemType::SceneElement:
+      this->TrackModel->SetTrackDisplayState(id, on);
+      break;
+
+    default:
+      return false;
+    }
+
+  on ? ++counts.Shown : ++counts.Hidden;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetStateRecursive(int type, int id, bool on,
+                                    StateCounts& counts)
+{
+  this->SetState(type, id, on, counts);
+
+  QVector<int> ids;
+  this->GetChildObjectIds(type, id, ids);
+
+  const int ct = childType(type);
+  foreach (int cid, ids)
+    {
+    this->SetStateRecursive(ct, cid, on, counts);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetMatchingStatesRecursive(int type, int id, bool on,
+                                             const ItemMatcher& matcher,
+                                             StateCounts& counts)
+{
+  if (matcher(type, id))
+    {
+    this->SetStateRecursive(type, id, on, counts);
+    return;
+    }
+
+  QVector<int> ids;
+  this->GetChildObjectIds(type, id, ids);
+
+  const int ct = childType(type);
+  foreach (int cid, ids)
+    {
+    this->SetMatchingStatesRecursive(ct, cid, on, matcher, counts);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetMatchingStates(Qt::CheckState state,
+                                    const ItemMatcher& matcher)
+{
+  // Work on the objects rather than on the items, so that objects whose items
+  // have not been created are changed as well
+  const bool on = state != Qt::Unchecked;
+  StateCounts counts;
+  foreach (Node* node, this->Root->Children)
+    {
+    this->SetMatchingStatesRecursive(node->Type, node->Id, on, matcher,
+                                     counts);
+    }
+
+  this->EmitSubtreeChanged(this->Root);
+  emit this->DisplayStatesChanged(counts.Shown, counts.Hidden, true);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetAllStates(Qt::CheckState state, int type)
+{
+  if (type < 0)
+    {
+    this->SetMatchingStates(state, [](int, int) { return true; });
+    }
+  else
+    {
+    this->SetMatchingStates(
+      state, [type](int t, int) { return t == type; });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetEventTypeStates(Qt::CheckState state, int eventType)
+{
+  vtkVgEventModel* em = this->EventModel;
+  this->SetMatchingStates(
+    state,
+    [em, eventType](int type, int id)
+      {
+      if (type != ItemType::Event)
+        {
+        return false;
+        }
+      vtkVgEvent* e = em->GetEvent(id);
+      return e && e->GetActiveClassifierType() == eventType;
+      });
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetActivityTypeStates(Qt::CheckState state,
+                                        int activityType)
+{
+  this->SetMatchingStates(
+    state,
+    [this, activityType](int type, int id)
+      {
+      if (type != ItemType::Activity)
+        {
+        return false;
+        }
+      vtkVgActivity* a = this->GetActivity(id);
+      return a && a->GetType() == activityType;
+      });
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetStates(const QModelIndexList& indexes,
+                            Qt::CheckState state)
+{
+  const bool on = state != Qt::Unchecked;
+  StateCounts counts;
+  foreach (const QModelIndex& index, indexes)
+    {
+    const Node* node = this->NodeFromIndex(index);
+    if (node != this->Root &&
+        this->SetState(node->Type, node->Id, on, counts))
+      {
+      emit this->dataChanged(index, index);
+      }
+    }
+
+  emit this->DisplayStatesChanged(counts.Shown, counts.Hidden, true);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetStatesExceptRecursive(int type, int id,
+                                           const ObjectSet& selected,
+                                           StateCounts& counts)
+{
+  this->SetState(type, id, selected.contains(qMakePair(type, id)), counts);
+
+  QVector<int> ids;
+  this->GetChildObjectIds(type, id, ids);
+
+  const int ct = childType(type);
+  foreach (int cid, ids)
+    {
+    this->SetStatesExceptRecursive(ct, cid, selected, counts);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetStatesExcept(const QModelIndexList& indexes)
+{
+  ObjectSet selected;
+  foreach (const QModelIndex& index, indexes)
+    {
+    const Node* node = this->NodeFromIndex(index);
+    if (node != this->Root)
+      {
+      selected.insert(qMakePair(node->Type, node->Id));
+      }
+    }
+
+  // hide all the unselected objects and show the selected ones
+  StateCounts counts;
+  foreach (Node* node, this->Root->Children)
+    {
+    this->SetStatesExceptRecursive(node->Type, node->Id, selected, counts);
+    }
+
+  this->EmitSubtreeChanged(this->Root);
+  emit this->DisplayStatesChanged(counts.Shown, counts.Hidden, true);
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeModel::SetSticky(const QModelIndexList& indexes, bool sticky)
+{
+  foreach (const QModelIndex& index, indexes)
+    {
+    Node* node = this->NodeFromIndex(index);
+    if (node->Parent == this->Root)
+      {
+      node->Sticky = sticky;
+      emit this->dataChanged(index, index);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+const char* vpTreeModel::GetSortTypeString(int sortType)
+{
+  switch (sortType)
+    {
+    case ST_Id:          return "Id";
+    case ST_Name:        return "Name";
+    case ST_Normalcy:    return "Normalcy";
+    case ST_Saliency:    return "Saliency";
+    case ST_Probability: return "Probability";
+    case ST_Length:      return "Length";
+    }
+  return 0;
+}
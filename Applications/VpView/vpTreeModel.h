@@ -0,0 +1,232 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vpTreeModel_h
+#define __vpTreeModel_h
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+
+#include "vtkVgTypeDefs.h"
+
+#include <functional>
+
+class vtkVgActivity;
+class vtkVgActivityManager;
+class vtkVgEvent;
+class vtkVgEventFilter;
+class vtkVgEventModel;
+class vtkVgEventTypeRegistry;
+class vtkVgTrack;
+class vtkVgTrackFilter;
+class vtkVgTrackModel;
+class vtkVgTrackTypeRegistry;
+
+// Item model presenting the activities, events, tracks or scene elements of a
+// project as a tree.
+//
+// Items store only the type, id and (for children) index of the object they
+// represent; everything else is computed from the vtk models when requested,
+// so that the model stays cheap at hundreds of thousands of items. Activity
+// items are keyed by activity id, so that they keep their state when other
+// activities are removed, but like the rest of the application, FindItem and
+// the IDR_ItemId role refer to activities by their current index. The
+// children of an item (the events of an activity, or the tracks of an event)
+// are created the first time they are needed, e.g. when the item is expanded.
+//
+// The check state of an item is the display state of its object. Changing it
+// updates the display state directly, and the bulk operations (SetAllStates,
+// etc.) do so for every object in the tree, including those whose items have
+// not been created, emitting only one dataChanged() per group of siblings.
+// Each change of check state is reported by DisplayStatesChanged().
+class vpTreeModel : public QAbstractItemModel
+{
+  Q_OBJECT
+
+public:
+  typedef vgObjectTypeDefinitions                  ItemType;
+  typedef vgObjectTypeDefinitions::enumObjectTypes ItemTypeEnum;
+
+  enum SortType
+    {
+    ST_Id,
+    ST_Name,
+    ST_Normalcy,
+    ST_Saliency,
+    ST_Probability,
+    ST_Length
+    };
+
+  enum ItemDataRole
+    {
+    IDR_ItemType = Qt::UserRole,
+    IDR_ItemId,
+    IDR_ItemIndex,
+    IDR_ItemSticky,
+    IDR_ItemShown,
+    IDR_ItemSortValsStart // must be last
+    };
+
+public:
+  vpTreeModel(QObject* parent = 0);
+  virtual ~vpTreeModel();
+
+  void Initialize(vtkVgActivityManager* activityManager,
+                  vtkVgEventModel* eventModel,
+                  vtkVgTrackModel* trackModel,
+                  vtkVgEventFilter* eventFilter,
+                  vtkVgTrackFilter* trackFilter,
+                  vtkVgEventTypeRegistry* eventTypes,
+                  vtkVgTrackTypeRegistry* trackTypes);
+
+  // Bring the top level items up to date with the corresponding vtk model.
+  // Items for objects which no longer exist are removed, and items for new
+  // objects are appended, so that existing items (and their expanded and
+  // selected state) are kept.
+  void AddAllActivities();
+  void AddAllEvents();
+  void AddAllTracks();
+  void AddAllSceneElements();
+
+  // Add a top level item for the object if there is not one already, and
+  // return its index.
+  QModelIndex AddTrack(vtkVgTrack* track, bool isFseTrack = false);
+  QModelIndex AddEvent(vtkVgEvent* event);
+
+  void Clear();
+
+  // Notify views that the data of all existing items may have changed.
+  void Refresh();
+
+  // Find the item for an object, creating the items on the path to it if
+  // necessary.
+  QModelIndex FindItem(int type, int id);
+  QModelIndex FindChildItem(int parentType, int parentId, int index);
+
+  // Notify views that the status of the object of an item has changed.
+  void UpdateItem(const QModelIndex& index);
+
+  // Synchronize the children of an activity item with its events.
+  void UpdateActivityItem(const QModelIndex& index);
+
+  // Bulk check state changes. SetAllStates changes every object of the given
+  // type, or every object if \p type is -1; SetEventTypeStates and
+  // SetActivityTypeStates change every event or activity of the given
+  // classifier type. The children of each changed object are changed as well.
+  void SetAllStates(Qt::CheckState state, int type = -1);
+  void SetEventTypeStates(Qt::CheckState state, int eventType);
+  void SetActivityTypeStates(Qt::CheckState state, int activityType);
+
+  // Change the check state of the given items, but not of their children.
+  void SetStates(const QModelIndexList& indexes, Qt::CheckState state);
+
+  // Check the given items and uncheck everything else.
+  void SetStatesExcept(const QModelIndexList& indexes);
+
+  // Set the "sticky" flag of the given top level items.
+  void SetSticky(const QModelIndexList& indexes, bool sticky);
+
+  static const char* GetSortTypeString(int sortType);
+
+  // Reimplemented from QAbstractItemModel
+  virtual QModelIndex index(
+    int row, int column,
+    const QModelIndex& parent = QModelIndex()) const override;
+  virtual QModelIndex parent(const QModelIndex& index) const override;
+
+  virtual int rowCount(
+    const QModelIndex& parent = QModelIndex()) const override;
+  virtual int columnCount(
+    const QModelIndex& parent = QModelIndex()) const override;
+
+  virtual bool hasChildren(
+    const QModelIndex& parent = QModelIndex()) const override;
+  virtual bool canFetchMore(const QModelIndex& parent) const override;
+  virtual void fetchMore(const QModelIndex& parent) override;
+
+  virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+  virtual QVariant data(
+    const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  virtual bool setData(
+    const QModelIndex& index, const QVariant& value, int role) override;
+
+signals:
+  // Emitted when display states are changed through the model, with the
+  // number of objects that were shown and hidden. If \p updateStatus is
+  // false, the change was a single object toggled by the user, which is not
+  // worth reporting.
+  void DisplayStatesChanged(int shown, int hidden, bool updateStatus);
+
+private:
+  struct Node;
+  struct StateCounts;
+
+  // Function used to select objects for bulk state changes; it is given the
+  // type and id of an object, and returns true if its state (and that of its
+  // children) should be changed.
+  typedef std::function<bool (int type, int id)> ItemMatcher;
+
+  // Set of objects, by type and id.
+  typedef QSet<QPair<int, int> > ObjectSet;
+
+  Node* NodeFromIndex(const QModelIndex& index) const;
+  QModelIndex IndexFromNode(Node* node) const;
+
+  int GetChildObjectCount(const Node* node) const;
+  void GetChildObjectIds(int type, int id, QVector<int>& ids) const;
+  bool ContainsObject(int type, int id,
+                      int descendantType, int descendantId) const;
+
+  int GetActivityIndex(int id) const;
+  vtkVgActivity* GetActivity(int id) const;
+
+  void Populate(Node* node) const;
+  void Populate(Node* node, const QVector<int>& ids) const;
+  void SyncTopLevel(int type, const QVector<int>& ids);
+  void SyncChildren(Node* node);
+  void RemoveChildren(Node* node, int first, int last);
+
+  Node* FindDescendant(Node* node, int type, int id);
+
+  void EmitSubtreeChanged(Node* node);
+
+  QString GetName(const Node* node) const;
+  QVariant GetSortValue(const Node* node, int sortType) const;
+
+  bool IsOn(int type, int id) const;
+  bool IsShown(const Node* node) const;
+  int GetStatus(const Node* node) const;
+
+  void SetMatchingStates(Qt::CheckState state, const ItemMatcher& matcher);
+
+  bool SetState(int type, int id, bool on, StateCounts& counts);
+  void SetStateRecursive(int type, int id, bool on, StateCounts& counts);
+  void SetMatchingStatesRecursive(int type, int id, bool on,
+                                  const ItemMatcher& matcher,
+                                  StateCounts& counts);
+  void SetStatesExceptRecursive(int type, int id, const ObjectSet& selected,
+                                StateCounts& counts);
+
+private:
+  vtkVgActivityManager* ActivityManager;
+  vtkVgEventModel* EventModel;
+  vtkVgTrackModel* TrackModel;
+
+  vtkVgTrackFilter* TrackFilter;
+  vtkVgEventFilter* EventFilter;
+
+  vtkVgTrackTypeRegistry* TrackTypeRegistry;
+  vtkVgEventTypeRegistry* EventTypeRegistry;
+
+  Node* Root;
+  QHash<int, Node*> TopLevelNodes;
+
+  // Index in the activity manager of each activity, by id
+  mutable QHash<int, int> ActivityIndices;
+};
+
+#endif
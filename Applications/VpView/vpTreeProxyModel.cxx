@@ -0,0 +1,117 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vpTreeProxyModel.h"
+
+#include "vpTreeModel.h"
+
+//-----------------------------------------------------------------------------
+vpTreeProxyModel::vpTreeProxyModel(QObject* p)
+  : QSortFilterProxyModel(p), SortType(vpTreeModel::ST_Id),
+    ShowExcludedItems(false), ShowUncheckedItems(true)
+{
+  this->setDynamicSortFilter(false);
+}
+
+//-----------------------------------------------------------------------------
+vpTreeProxyModel::~vpTreeProxyModel()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeProxyModel::SetSortType(int sortType)
+{
+  this->SortType = sortType;
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeProxyModel::SetShowExcludedItems(bool show)
+{
+  if (show != this->ShowExcludedItems)
+    {
+    this->ShowExcludedItems = show;
+    this->invalidateFilter();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeProxyModel::SetShowUncheckedItems(bool show)
+{
+  if (show != this->ShowUncheckedItems)
+    {
+    this->ShowUncheckedItems = show;
+    this->invalidateFilter();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpTreeProxyModel::UpdateFilter()
+{
+  this->invalidateFilter();
+}
+
+//-----------------------------------------------------------------------------
+QVariant vpTreeProxyModel::data(const QModelIndex& index, int role) const
+{
+  if (role == Qt::ToolTipRole && index.isValid() && !index.parent().isValid())
+    {
+    // Show the rank of top level items in the tree.
+    return QString("%1 of %2").arg(index.row() + 1).arg(this->rowCount());
+    }
+  return QSortFilterProxyModel::data(index, role);
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeProxyModel::filterAcceptsRow(
+  int sourceRow, const QModelIndex& sourceParent) const
+{
+  // Hide top level items if the options have been set, but continue to show
+  // children, even if they are filtered, in order to avoid confusion.
+  if (sourceParent.isValid() ||
+      (this->ShowExcludedItems && this->ShowUncheckedItems))
+    {
+    return true;
+    }
+
+  const QModelIndex index = this->sourceModel()->index(sourceRow, 0);
+  if (index.data(vpTreeModel::IDR_ItemSticky).toBool())
+    {
+    return true;
+    }
+
+  if (!this->ShowUncheckedItems &&
+      index.data(Qt::CheckStateRole).toInt() == Qt::Unchecked)
+    {
+    return false;
+    }
+
+  return this->ShowExcludedItems ||
+         index.data(vpTreeModel::IDR_ItemShown).toBool();
+}
+
+//-----------------------------------------------------------------------------
+bool vpTreeProxyModel::lessThan(
+  const QModelIndex& left, const QModelIndex& right) const
+{
+  const int role = vpTreeModel::IDR_ItemSortValsStart + this->SortType;
+  const QVariant leftData = left.data(role);
+  const QVariant rightData = right.data(role);
+
+  switch (this->SortType)
+    {
+    case vpTreeModel::ST_Id:
+      return leftData.toInt() < rightData.toInt();
+
+    case vpTreeModel::ST_Name:
+      return leftData.toString() < rightData.toString();
+
+    case vpTreeModel::ST_Normalcy:
+    case vpTreeModel::ST_Saliency:
+    case vpTreeModel::ST_Probability:
+    case vpTreeModel::ST_Length:
+      return leftData.toReal() < rightData.toReal();
+    }
+
+  return QSortFilterProxyModel::lessThan(left, right);
+}
@@ -0,0 +1,53 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vpTreeProxyModel_h
+#define __vpTreeProxyModel_h
+
+#include <QSortFilterProxyModel>
+
+// Proxy model sorting and filtering the items of a vpTreeModel.
+//
+// Items are sorted by the value of the selected sort type. Top level items
+// may be hidden if they are unchecked or excluded by the filters, unless they
+// are sticky; children are always shown, in order to avoid confusion.
+//
+// The proxy is not dynamic; items are sorted when sort() is called, and
+// filtered when UpdateFilter() is called or the filter options change, rather
+// than whenever item data changes, so that bulk changes of many items do not
+// cause them to be sorted and filtered again.
+class vpTreeProxyModel : public QSortFilterProxyModel
+{
+  Q_OBJECT
+
+public:
+  vpTreeProxyModel(QObject* parent = 0);
+  virtual ~vpTreeProxyModel();
+
+  void SetSortType(int sortType);
+  int GetSortType() const { return this->SortType; }
+
+  void SetShowExcludedItems(bool show);
+  void SetShowUncheckedItems(bool show);
+
+  void UpdateFilter();
+
+  // Reimplemented from QAbstractItemModel
+  virtual QVariant data(
+    const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+protected:
+  // Reimplemented from QSortFilterProxyModel
+  virtual bool filterAcceptsRow(
+    int sourceRow, const QModelIndex& sourceParent) const override;
+  virtual bool lessThan(
+    const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+  int SortType;
+  bool ShowExcludedItems;
+  bool ShowUncheckedItems;
+};
+
+#endif
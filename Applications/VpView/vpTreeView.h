@@ -5,9 +5,7 @@
 #ifndef __vpTreeView_h
 #define __vpTreeView_h
 
-#include <QTreeWidget>
-
-#include "vtkVgTypeDefs.h"
+#include <QTreeView>
 
 class vtkVgActivityManager;
 class vtkVgEvent;
@@ -19,26 +17,18 @@ class vtkVgTrackFilter;
 class vtkVgTrackModel;
 class vtkVgTrackTypeRegistry;
 
-class SignalBlocker;
+class vpTreeModel;
+class vpTreeProxyModel;
 
-class vpTreeView : public QTreeWidget
+// Tree view of the activities, events, tracks or scene elements of a project.
+//
+// The view presents a vpTreeModel through a vpTreeProxyModel. All indexes
+// taken or returned by the view's methods are indexes of the proxy (i.e. of
+// the view's model()).
+class vpTreeView : public QTreeView
 {
   Q_OBJECT
 
-public:
-  typedef vgObjectTypeDefinitions                  ItemType;
-  typedef vgObjectTypeDefinitions::enumObjectTypes ItemTypeEnum;
-
-  enum SortType
-    {
-    ST_Id,
-    ST_Name,
-    ST_Normalcy,
-    ST_Saliency,
-    ST_Probability,
-    ST_Length
-    };
-
 public:
   vpTreeView(QWidget* parent = 0);
   virtual ~vpTreeView();
@@ -66,26 +56,29 @@ public:
   bool SelectItem(int type, int id);
   bool SelectChildItem(int parentType, int parentId, int index);
 
-  void GetItemInfo(QTreeWidgetItem* item,
+  QModelIndexList GetSelectedIndexes() const;
+
+  void GetItemInfo(const QModelIndex& item,
                    int& type, int& id,
                    int& parentId, int& index);
 
-  void UpdateItemStatus(QTreeWidgetItem* item);
+  void SetCheckState(const QModelIndex& item, Qt::CheckState state);
+
+  void UpdateItemStatus(const QModelIndex& item);
 
-  void UpdateActivityItem(QTreeWidgetItem* item);
+  void UpdateActivityItem(const QModelIndex& item);
 
   // reimplemented from QWidget
   virtual QSize sizeHint() const;
   virtual void contextMenuEvent(QContextMenuEvent* event);
   virtual void leaveEvent(QEvent* event);
 
-  int GetSortType() { return this->SortType; }
-
-  static const char* GetSortTypeString(int sortType);
+  int GetSortType() const;
 
 signals:
-  void ItemsChanged(const QList<QTreeWidgetItem*>& items,
-                    bool updateStatus = true);
+  void ItemsChanged(int numShown, int numHidden, bool updateStatus = true);
+
+  void SelectionChanged();
 
   void MouseLeft();
   void ContextMenuOpened(QMenu& menu);
@@ -129,8 +122,6 @@ public slots:
   void SetShowUncheckedItems(bool show);
 
 private slots:
-  void OnItemChanged(QTreeWidgetItem* item);
-
   void ShowItems();
   void HideItems();
   void HideItemsExcept();
@@ -138,64 +129,13 @@ private slots:
   void ToggleSticky();
 
 private:
-  enum ItemDataRole
-    {
-    IDR_ItemType = Qt::UserRole,
-    IDR_ItemId,
-    IDR_ItemIndex,
-    IDR_ItemSticky,
-    IDR_ItemSortValsStart // must be last
-    };
-
-  class TreeWidgetItem;
-  friend class SignalBlocker;
-
-  QTreeWidgetItem* CreateItem(ItemTypeEnum type, const char* name, int id);
-  QTreeWidgetItem* CreateItem(vtkVgTrack* track, bool isFseTrack = false);
-
-  void AddEventTracks(vtkVgEvent* event, QTreeWidgetItem* eventItem);
+  QModelIndexList GetSelectedSourceIndexes() const;
 
-  bool RefreshItem(QTreeWidgetItem* item, bool isTopLevel = false);
-
-  void RefreshRecursive(QTreeWidgetItem* root, int depth);
-
-  void SetStateRecursive(QTreeWidgetItem* root, Qt::CheckState state,
-                         QList<QTreeWidgetItem*>& changed);
-
-  void SetStateRecursive(QTreeWidgetItem* root, Qt::CheckState state,
-                         QList<QTreeWidgetItem*>& changed, int type);
-
-  void SetEventStateRecursive(QTreeWidgetItem* root, Qt::CheckState state,
-                              QList<QTreeWidgetItem*>& changed, int eventType);
-
-  void SetActivityStateRecursive(QTreeWidgetItem* root, Qt::CheckState state,
-                                 QList<QTreeWidgetItem*>& changed, int activityType);
-
-  QTreeWidgetItem* FindItem(QTreeWidgetItem* root, int type, int id);
-  QTreeWidgetItem* FindTopLevelItem(int type, int id);
-
-  void HideUnselectedShowSelected(QTreeWidgetItem* root,
-                                  QList<QTreeWidgetItem*>& changed);
-
-  void SetAll(Qt::CheckState state);
-  void SetAll(Qt::CheckState state, int type);
-  void SetAllEvents(Qt::CheckState state, int eventType);
-  void SetAllActivities(Qt::CheckState state, int activityType);
+  void SetCurrentSourceIndex(const QModelIndex& index, bool scroll = false);
 
 private:
-  vtkVgActivityManager* ActivityManager;
-  vtkVgEventModel* EventModel;
-  vtkVgTrackModel* TrackModel;
-
-  vtkVgTrackFilter* TrackFilter;
-  vtkVgEventFilter* EventFilter;
-
-  vtkVgTrackTypeRegistry* TrackTypeRegistry;
-  vtkVgEventTypeRegistry* EventTypeRegistry;
-
-  int SortType;
-  bool ShowExcludedItems;
-  bool ShowUncheckedItems;
+  vpTreeModel* Model;
+  vpTreeProxyModel* ProxyModel;
 };
 
 #endif
@@ -38,6 +38,7 @@
 #include "vpTrackConfig.h"
 #include "vpTrackIO.h"
 #include "vpVideoAnimation.h"
+#include "vpWebExporter.h"
 #include "vtkVpTrackModel.h"
 
 #ifdef VISGUI_USE_VIDTK
@@ -70,7 +71,6 @@
 #include <vtkDoubleArray.h>
 #include <vtkElevationFilter.h>
 #include <vtkEventQtSlotConnect.h>
-#include <vtkExtractVOI.h>
 #include <vtkGraph.h>
 #include <vtkGraphLayoutView.h>
 #include <vtkGreedyTerrainDecimation.h>
@@ -4407,26 +4407,10 @@ void vpViewCore::loadFilters(const char* fileName)
   this->update();
 }
 
-//-----------------------------------------------------------------------------
-static inline void writePixel(vtkImageData* imageData, int x, int y,
-                              unsigned char value)
-{
-  unsigned char* pixel =
-    static_cast<unsigned char*>(imageData->GetScalarPointer(x, y, 0));
-
-  for (int i = 0, nc = imageData->GetNumberOfScalarComponents(); i < nc; ++i)
-    {
-    pixel[i] = value;
-    }
-}
-
 //-----------------------------------------------------------------------------
 void vpViewCore::exportForWeb(const char* path, int paddingFrames)
 {
-  QString fullPath = QString("%1/%2").arg(path).arg("context.png");
-
-  vtkSmartPointer<vtkPNGWriter> imageWriter =
-    vtkSmartPointer<vtkPNGWriter>::New();
+  vpWebExporter exporter(QString::fromLocal8Bit(path));
 
   int currentExtents[4];
   int aoiExtents[4] =
@@ -4445,12 +4429,11 @@ void vpViewCore::exportForWeb(const char* path, int paddingFrames)
   this->ImageSource->SetReadExtents(aoiExtents);
   this->ImageSource->SetLevel(0);
   this->ImageSource->Update();
-  imageWriter->SetInputData(this->ImageSource->GetOutput());
-  imageWriter->SetFileName(qPrintable(fullPath));
-  imageWriter->Write();
+  exporter.writeImage(this->ImageSource->GetOutput(), "context.png");
   this->ImageSource->SetLevel(currentLevel);
   this->ImageSource->SetReadExtents(currentExtents);
 
+  // Make sure the frames can be read before planning the export
   const auto& firstFileName = this->ImageDataSource->frameName(0);
 
   vtkSmartPointer<vtkVgBaseImageSource> imageSource;
@@ -4463,31 +4446,19 @@ void vpViewCore::exportForWeb(const char* path, int paddingFrames)
     return;
     }
 
-  vtkSmartPointer<vtkExtractVOI> extractVOI =
-    vtkSmartPointer<vtkExtractVOI>::New();
+  int imageDimensions[2];
+  this->ImageSource->GetDimensions(imageDimensions);
 
   int session = this->SessionView->GetCurrentSession();
   vpProject* project = this->Projects[session];
 
-  QProgressDialog progress("Generating event clip images...", "Cancel", 1,
-                           project->EventModel->GetNumberOfEvents());
-  progress.setWindowModality(Qt::ApplicationModal);
-  progress.setMinimumDuration(0);
-  progress.setAutoClose(false);
-  progress.setAutoReset(false);
-  progress.setValue(0);
-
-  int count = 0;
+  // Plan the images of every event first; the exporter then reads each frame
+  // only once, even if several events share it, and does the reading,
+  // cropping and encoding in the background
   vtkVgEventInfo eventInfo;
   project->EventModel->InitEventTraversal();
   while ((eventInfo = project->EventModel->GetNextEvent()).GetEvent())
     {
-    if (progress.wasCanceled())
-      {
-      break;
-      }
-    progress.setValue(++count);
-
     if (!eventInfo.GetDisplayEvent())
       {
       continue;
@@ -4499,10 +4470,10 @@ void vpViewCore::exportForWeb(const char* path, int paddingFrames)
       continue; // ignoring node events for now.
       }
 
-    fullPath = QString("%1/event-%2/").arg(path).arg(event->GetId());
-    if (!QDir().mkpath(fullPath))
+    const QString eventDir = QString("event-%1/").arg(event->GetId());
+    if (!QDir().mkpath(QString("%1/%2").arg(path).arg(eventDir)))
       {
-      qDebug() << "Failed to create path" << fullPath;
+      qDebug() << "Failed to create path" << eventDir << "in" << path;
       continue;
       }
 
@@ -4591,7 +4562,7 @@ void vpViewCore::exportForWeb(const char* path, int paddingFrames)
       thumbImageDim[1] *= thumbSampleRate;
       }
 
-    // Second pass: Iterate over the track points again, this time writing a
+    // Second pass: Iterate over the track points again, this time planning a
     // clip image for each point.
     track->InitPathTraversal();
 
@@ -4642,22 +4613,8 @@ void vpViewCore::exportForWeb(const char* path, int paddingFrames)
         continue;
         }
 
-again:
-      int dim[2];
-      int sampleRate;
-      if (!madeThumbnail &&
-          timeStamp.GetFrameNumber() == trackTimeStamp.GetFrameNumber())
-        {
-        dim[0] = thumbImageDim[0];
-        dim[1] = thumbImageDim[1];
-        sampleRate = thumbSampleRate;
-        }
-      else
-        {
-        dim[0] = clipImageDim[0];
-        dim[1] = clipImageDim[1];
-        sampleRate = clipSampleRate;
-        }
+      const bool atTrackPoint =
+        timeStamp.GetFrameNumber() == trackTimeStamp.GetFrameNumber();
 
       double point[3];
       points->GetPoint(id, point);
@@ -4666,52 +4623,14 @@ again:
       point[0] -= project->OverviewOrigin.x();
       point[1] -= project->OverviewOrigin.y();
 
-      // compute the cropped region of the image
-      int extents[6];
-      extents[0] = std::max(qRound(point[0] - dim[0] / 2), 0);
-      extents[2] = std::max(qRound(point[1] - dim[1] / 2), 0);
-      extents[1] = extents[0] + dim[0] - 1;
-      extents[3] = extents[2] + dim[1] - 1;
-      extents[4] = extents[5] = 0;
-
-      imageSource->SetFileName(qPrintable(fileName));
-      imageSource->UpdateInformation();
-
-      int imageDimensions[2];
-      this->ImageSource->GetDimensions(imageDimensions);
-
-      // shift extents if part of the crop region falls outside the image
-      if (extents[1] >= imageDimensions[0])
-        {
-        int shift = extents[1] - (imageDimensions[0] - 1);
-        extents[0] -= shift;
-        extents[1] -= shift;
-        }
-      if (extents[3] >= imageDimensions[1])
-        {
-        int shift = extents[3] - (imageDimensions[1] - 1);
-        extents[2] -= shift;
-        extents[3] -= shift;
-        }
-
-      imageSource->SetReadExtents(extents);
-      imageSource->SetLevel(0);
-      imageSource->Update();
-
-      // crop to the area of interest / downsample to output dimensions
-      extractVOI->SetInputConnection(imageSource->GetOutputPort());
-      extractVOI->SetVOI(extents);
-      extractVOI->SetSampleRate(sampleRate, sampleRate, 1);
-      extractVOI->UpdateWholeExtent();
-
-      vtkImageData* image = extractVOI->GetOutput();
-
-      // draw the track head bounding box on top of the image
-      if (timeStamp.GetFrameNumber() == trackTimeStamp.GetFrameNumber())
+      // compute the track head bounding box, at 2x scale
+      bool haveBox = false;
+      int box[4];
+      if (atTrackPoint)
         {
         vtkIdType npts, *ptIds, ptId;
         track->GetHeadIdentifier(trackTimeStamp, npts, ptIds, ptId);
-        if (sampleRate == 1 && npts > 1)
+        if (npts > 1)
           {
           vtkBoundingBox bbox;
           for (int i = 0; i < npts - 1; ++i)
@@ -4723,67 +4642,88 @@ again:
             bbox.AddPoint(point);
             }
 
-          // draw bbox at 2x scale
-          double center[3], minPt[3], maxPt[3];
+          double center[3];
           bbox.GetCenter(center);
-          bbox.GetMinPoint(minPt[0], minPt[1], minPt[2]);
-          bbox.GetMaxPoint(maxPt[0], maxPt[1], maxPt[2]);
-          minPt[0] -= center[0];
-          minPt[1] -= center[1];
-          maxPt[0] -= center[0];
-          maxPt[1] -= center[1];
-          minPt[0] *= 2.0;
-          minPt[1] *= 2.0;
-          maxPt[0] *= 2.0;
-          maxPt[1] *= 2.0;
-          minPt[0] += center[0];
-          minPt[1] += center[1];
-          maxPt[0] += center[0];
-          maxPt[1] += center[1];
-          bbox.SetMinPoint(minPt);
-          bbox.SetMaxPoint(maxPt);
-
-          int p0[] = { qRound(bbox.GetMinPoint()[0]),
-                       qRound(bbox.GetMinPoint()[1]) };
-          int p1[] = { qRound(bbox.GetMaxPoint()[0]),
-                       qRound(bbox.GetMaxPoint()[1]) };
-
-          p0[0] = qBound(extents[0], p0[0], extents[1]);
-          p0[1] = qBound(extents[2], p0[1], extents[3]);
-          p1[0] = qBound(extents[0], p1[0], extents[1]);
-          p1[1] = qBound(extents[2], p1[1], extents[3]);
-
-          for (int i = p0[0]; i <= p1[0]; ++i)
-            {
-            writePixel(image, i, p0[1], 255);
-            writePixel(image, i, p1[1], 255);
-            }
-
-          for (int i = p0[1] + 1; i < p1[1]; ++i)
-            {
-            writePixel(image, p0[0], i, 255);
-            writePixel(image, p1[0], i, 255);
-            }
+          box[0] = qRound(2.0 * bbox.GetMinPoint()[0] - center[0]);
+          box[1] = qRound(2.0 * bbox.GetMaxPoint()[0] - center[0]);
+          box[2] = qRound(2.0 * bbox.GetMinPoint()[1] - center[1]);
+          box[3] = qRound(2.0 * bbox.GetMaxPoint()[1] - center[1]);
+          haveBox = true;
           }
         }
 
-      QString file = madeThumbnail ||
-                     trackTimeStamp.GetFrameNumber() != timeStamp.GetFrameNumber()
-                     ? QString("%1.png").arg(frame, 6, 10, QChar('0'))
-                     : QString("event-%1.png").arg(event->GetId());
-      imageWriter->SetInputData(image);
-      imageWriter->SetFileName(qPrintable(fullPath + file));
-      imageWriter->Write();
-
-      // if we just generated a thumbnail, go back and write the real frame now
-      if (!madeThumbnail &&
-          trackTimeStamp.GetFrameNumber() == timeStamp.GetFrameNumber())
+      auto addImage = [&](const int dim[2], int sampleRate,
+                          const QString& file)
         {
+        // compute the cropped region of the image
+        int extents[4];
+        extents[0] = std::max(qRound(point[0] - dim[0] / 2), 0);
+        extents[2] = std::max(qRound(point[1] - dim[1] / 2), 0);
+        extents[1] = extents[0] + dim[0] - 1;
+        extents[3] = extents[2] + dim[1] - 1;
+
+        // shift extents if part of the crop region falls outside the image
+        if (extents[1] >= imageDimensions[0])
+          {
+          int shift = extents[1] - (imageDimensions[0] - 1);
+          extents[0] -= shift;
+          extents[1] -= shift;
+          }
+        if (extents[3] >= imageDimensions[1])
+          {
+          int shift = extents[3] - (imageDimensions[1] - 1);
+          extents[2] -= shift;
+          extents[3] -= shift;
+          }
+
+        // the box is only drawn on images which are not downsampled
+        int clippedBox[4];
+        if (haveBox && sampleRate == 1)
+          {
+          clippedBox[0] = qBound(extents[0], box[0], extents[1]);
+          clippedBox[1] = qBound(extents[0], box[1], extents[1]);
+          clippedBox[2] = qBound(extents[2], box[2], extents[3]);
+          clippedBox[3] = qBound(extents[2], box[3], extents[3]);
+          }
+
+        exporter.addImage(frameNum, fileName, eventDir + file, extents,
+                          sampleRate,
+                          haveBox && sampleRate == 1 ? clippedBox : 0);
+        };
+
+      // the first frame at a track point also provides the event thumbnail
+      if (!madeThumbnail && atTrackPoint)
+        {
+        addImage(thumbImageDim, thumbSampleRate,
+                 QString("event-%1.png").arg(event->GetId()));
         madeThumbnail = true;
-        goto again;
         }
+
+      addImage(clipImageDim, clipSampleRate,
+               QString("%1.png").arg(frame, 6, 10, QChar('0')));
       }
     }
+
+  QProgressDialog progress("Generating event clip images...", "Cancel", 0,
+                           exporter.frameCount());
+  progress.setWindowModality(Qt::ApplicationModal);
+  progress.setMinimumDuration(0);
+  progress.setAutoClose(false);
+  progress.setAutoReset(false);
+  progress.setValue(0);
+
+  const int failures = exporter.execute(
+    [&progress](int framesDone, int)
+      {
+      progress.setValue(framesDone);
+      return !progress.wasCanceled();
+      });
+
+  if (failures > 0)
+    {
+    emit this->warningError(
+      QString("%1 event clip image(s) could not be written.").arg(failures));
+    }
 }
 
 //-----------------------------------------------------------------------------
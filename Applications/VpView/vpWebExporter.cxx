@@ -0,0 +1,468 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vpWebExporterPrivate.h"
+
+#include "vpImageSourceFactory.h"
+
+#include <vtkVgBaseImageSource.h>
+
+#include <qtStlUtil.h>
+
+#include <vtkErrorCode.h>
+#include <vtkExtractVOI.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPNGWriter.h>
+#include <vtkSmartPointer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+QTE_IMPLEMENT_D_FUNC(vpWebExporter)
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+inline void writePixel(vtkImageData* imageData, int x, int y,
+                       unsigned char value)
+{
+  unsigned char* pixel =
+    static_cast<unsigned char*>(imageData->GetScalarPointer(x, y, 0));
+
+  for (int i = 0, nc = imageData->GetNumberOfScalarComponents(); i < nc; ++i)
+    {
+    pixel[i] = value;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void drawBox(vtkImageData* image, const int box[4])
+{
+  for (int i = box[0]; i <= box[1]; ++i)
+    {
+    writePixel(image, i, box[2], 255);
+    writePixel(image, i, box[3], 255);
+    }
+
+  for (int i = box[2] + 1; i < box[3]; ++i)
+    {
+    writePixel(image, box[0], i, 255);
+    writePixel(image, box[1], i, 255);
+    }
+}
+
+//-----------------------------------------------------------------------------
+inline qint64 extentsArea(const int extents[4])
+{
+  return static_cast<qint64>(extents[1] - extents[0] + 1) *
+         static_cast<qint64>(extents[3] - extents[2] + 1);
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+QVector<vpWebExportRead> vpWebExporterPrivate::groupReads(
+  const QVector<vpWebExportImage>& images)
+{
+  QVector<vpWebExportRead> reads;
+  for (int i = 0, k = images.size(); i < k; ++i)
+    {
+    const int* const e = images[i].Extents;
+    const qint64 area = extentsArea(e);
+
+    // Add the image to the first read which remains dense enough with it
+    bool added = false;
+    for (int j = 0, l = reads.size(); j < l && !added; ++j)
+      {
+      vpWebExportRead& read = reads[j];
+      const int merged[4] =
+        {
+        std::min(read.Extents[0], e[0]), std::max(read.Extents[1], e[1]),
+        std::min(read.Extents[2], e[2]), std::max(read.Extents[3], e[3])
+        };
+      const qint64 mergedArea = extentsArea(merged);
+      if (mergedArea <= vpWebExportMaxReadPixels &&
+          mergedArea <= vpWebExportMaxReadOverhead * (read.ImageArea + area))
+        {
+        std::copy(merged, merged + 4, read.Extents);
+        read.ImageArea += area;
+        read.Images.append(i);
+        added = true;
+        }
+      }
+
+    if (!added)
+      {
+      vpWebExportRead read;
+      std::copy(e, e + 4, read.Extents);
+      read.ImageArea = area;
+      read.Images.append(i);
+      reads.append(read);
+      }
+    }
+
+  return reads;
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporterPrivate::addTime(Stage stage, QElapsedTimer& timer)
+{
+  this->StageTime[stage].fetchAndAddRelaxed(timer.nsecsElapsed());
+  timer.start();
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporterPrivate::exportFrame(const vpWebExportFrame& frame)
+{
+  if (this->Canceled.load())
+    {
+    return;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Each task uses its own image source, as they are not thread safe
+  vtkSmartPointer<vtkVgBaseImageSource> imageSource;
+  imageSource.TakeReference(
+    vpImageSourceFactory::GetInstance()->Create(stdString(frame.FrameFile)));
+  if (!imageSource)
+    {
+    qWarning() << "Unable to read" << frame.FrameFile;
+    this->Failures.fetchAndAddOrdered(frame.Images.size());
+    this->FramesDone.ref();
+    return;
+    }
+
+  imageSource->SetFileName(qPrintable(frame.FrameFile));
+  imageSource->UpdateInformation();
+  imageSource->SetLevel(0);
+
+  vtkNew<vtkExtractVOI> extractVOI;
+  extractVOI->SetInputConnection(imageSource->GetOutputPort());
+
+  // Read nearby images of the frame together, and crop each from its read
+  foreach (const vpWebExportRead& read, this->groupReads(frame.Images))
+    {
+    int extents[4];
+    std::copy(read.Extents, read.Extents + 4, extents);
+    imageSource->SetReadExtents(extents);
+    imageSource->Update();
+    this->addTime(ReadStage, timer);
+
+    foreach (const int index, read.Images)
+      {
+      if (this->Canceled.load())
+        {
+        return;
+        }
+
+      // crop to the area of interest / downsample to output dimensions
+      const vpWebExportImage& image = frame.Images[index];
+      int voi[6] =
+        {
+        image.Extents[0], image.Extents[1],
+        image.Extents[2], image.Extents[3],
+        0, 0
+        };
+      extractVOI->SetVOI(voi);
+      extractVOI->SetSampleRate(image.SampleRate, image.SampleRate, 1);
+
+      // re-execute even if the region has not changed, as the output may
+      // have been drawn on
+      extractVOI->Modified();
+      extractVOI->UpdateWholeExtent();
+
+      vtkImageData* output = extractVOI->GetOutput();
+      if (image.DrawBox)
+        {
+        drawBox(output, image.Box);
+        }
+      this->addTime(CropStage, timer);
+
+      if (this->writeImage(output, image.OutputFile, image.Key, timer))
+        {
+        this->Exported.ref();
+        }
+      else
+        {
+        this->Failures.ref();
+        }
+      }
+    }
+
+  this->FramesDone.ref();
+}
+
+//-----------------------------------------------------------------------------
+bool vpWebExporterPrivate::writeImage(
+  vtkImageData* image, const QString& outputFile, const QByteArray& key,
+  QElapsedTimer& timer)
+{
+  const QString path = this->OutputDir.filePath(outputFile);
+
+  // Encode the image in memory, so that the file can be written atomically
+  vtkNew<vtkPNGWriter> writer;
+  writer->WriteToMemoryOn();
+  writer->SetInputData(image);
+  writer->Write();
+
+  vtkUnsignedCharArray* result = writer->GetResult();
+  if (writer->GetErrorCode() != vtkErrorCode::NoError || !result)
+    {
+    qWarning() << "Failed to encode" << path << '-'
+               << vtkErrorCode::GetStringFromErrorCode(
+                    writer->GetErrorCode());
+    return false;
+    }
+  this->addTime(EncodeStage, timer);
+
+  const qint64 size = result->GetNumberOfTuples() *
+                      result->GetNumberOfComponents();
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly) ||
+      file.write(reinterpret_cast<const char*>(result->GetPointer(0)),
+                 size) != size ||
+      !file.commit())
+    {
+    qWarning() << "Failed to write" << path << '-' << file.errorString();
+    return false;
+    }
+  this->addTime(WriteStage, timer);
+
+  if (!key.isEmpty())
+    {
+    this->record(outputFile, key);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporterPrivate::loadManifest()
+{
+  const QString path = this->OutputDir.filePath(vpWebExportManifestName);
+
+  // Each line of the manifest is the key of an image, followed by the name of
+  // the file it was written to; a line is only added once the file has been
+  // written, so an interrupted export leaves at most an incomplete last line
+  bool complete = true;
+  QFile file(path);
+  if (file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+    while (!file.atEnd())
+      {
+      const QByteArray line = file.readLine();
+      const int split = line.indexOf(' ');
+      complete = line.endsWith('\n');
+      if (split > 0 && complete)
+        {
+        this->Written.insert(
+          QString::fromUtf8(line.mid(split + 1).trimmed()),
+          line.left(split));
+        }
+      }
+    }
+
+  this->Manifest.setFileName(path);
+  if (!this->Manifest.open(QIODevice::Append | QIODevice::Text))
+    {
+    qWarning() << "Failed to open" << path << '-'
+               << this->Manifest.errorString()
+               << "; the export will not be resumable";
+    }
+  else if (!complete)
+    {
+    // End the incomplete line, so that it is not joined to the next image
+    this->Manifest.write("\n");
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporterPrivate::record(
+  const QString& outputFile, const QByteArray& key)
+{
+  QMutexLocker lock(&this->ManifestMutex);
+  if (this->Manifest.isOpen())
+    {
+    this->Manifest.write(key + ' ' + outputFile.toUtf8() + '\n');
+    this->Manifest.flush();
+    }
+}
+
+//-----------------------------------------------------------------------------
+vpWebExporter::vpWebExporter(const QString& outputPath)
+  : d_ptr{new vpWebExporterPrivate}
+{
+  QTE_D();
+  d->OutputDir.setPath(outputPath);
+  d->Timer.start();
+}
+
+//-----------------------------------------------------------------------------
+vpWebExporter::~vpWebExporter()
+{
+  QTE_D();
+  d->Canceled.store(1);
+  d->Pool.clear();
+  d->Pool.waitForDone();
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporter::setThreadCount(int count)
+{
+  QTE_D();
+  d->Pool.setMaxThreadCount(qMax(1, count));
+}
+
+//-----------------------------------------------------------------------------
+void vpWebExporter::addImage(int frameIndex, const QString& frameFile,
+                             const QString& outputFile, const int extents[4],
+                             int sampleRate, const int* box)
+{
+  QTE_D();
+
+  vpWebExportImage image;
+  image.OutputFile = outputFile;
+  std::copy(extents, extents + 4, image.Extents);
+  image.SampleRate = sampleRate;
+  image.DrawBox = (box != 0);
+  std::fill(image.Box, image.Box + 4, 0);
+  if (box)
+    {
+    std::copy(box, box + 4, image.Box);
+    }
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(frameFile.toUtf8());
+  hash.addData(reinterpret_cast<const char*>(image.Extents),
+               sizeof(image.Extents));
+  hash.addData(reinterpret_cast<const char*>(&image.SampleRate),
+               sizeof(image.SampleRate));
+  hash.addData(reinterpret_cast<const char*>(&image.DrawBox),
+               sizeof(image.DrawBox));
+  hash.addData(reinterpret_cast<const char*>(image.Box), sizeof(image.Box));
+  image.Key = hash.result().toHex();
+
+  vpWebExportFrame& frame = d->Frames[frameIndex];
+  frame.FrameFile = frameFile;
+  frame.Images.append(image);
+  ++d->ImageCount;
+}
+
+//-----------------------------------------------------------------------------
+int vpWebExporter::imageCount() const
+{
+  QTE_D();
+  return d->ImageCount;
+}
+
+//-----------------------------------------------------------------------------
+int vpWebExporter::frameCount() const
+{
+  QTE_D();
+  return d->Frames.count();
+}
+
+//-----------------------------------------------------------------------------
+bool vpWebExporter::writeImage(vtkImageData* image, const QString& outputFile)
+{
+  QTE_D();
+
+  QElapsedTimer timer;
+  timer.start();
+  return d->writeImage(image, outputFile, QByteArray(), timer);
+}
+
+//-----------------------------------------------------------------------------
+int vpWebExporter::execute(const ProgressFunction& progress)
+{
+  QTE_D();
+
+  const qint64 planTime = d->Timer.nsecsElapsed();
+  d->Timer.start();
+
+  d->loadManifest();
+
+  // Queue the frames in order, leaving out images already written by a
+  // previous export from the same frame and region
+  int skipped = 0;
+  foreach (const vpWebExportFrame& frame, d->Frames)
+    {
+    vpWebExportFrame pending;
+    pending.FrameFile = frame.FrameFile;
+    foreach (const vpWebExportImage& image, frame.Images)
+      {
+      if (d->Written.value(image.OutputFile) == image.Key &&
+          QFileInfo::exists(d->OutputDir.filePath(image.OutputFile)))
+        {
+        ++skipped;
+        }
+      else
+        {
+        pending.Images.append(image);
+        }
+      }
+
+    if (pending.Images.isEmpty())
+      {
+      d->FramesDone.ref();
+      continue;
+      }
+
+    QtConcurrent::run(&d->Pool, [d, pending]{ d->exportFrame(pending); });
+    }
+
+  const int total = d->Frames.count();
+  while (!d->Pool.waitForDone(100))
+    {
+    if (progress && !progress(d->FramesDone.load(), total))
+      {
+      d->Canceled.store(1);
+      d->Pool.clear();
+      d->Pool.waitForDone();
+      break;
+      }
+    }
+  if (progress && !d->Canceled.load())
+    {
+    progress(d->FramesDone.load(), total);
+    }
+
+  d->Manifest.close();
+
+  // Report the time spent in each stage; apart from planning, these are
+  // summed over the worker threads, and so may exceed the elapsed time
+  // Images which were neither written nor failed were not reached before the
+  // export was canceled
+  const int exported = d->Exported.fetchAndStoreOrdered(0);
+  const int failures = d->Failures.fetchAndStoreOrdered(0);
+  const int canceled = d->ImageCount - skipped - exported - failures;
+
+  static const double msPerNs = 1e-6;
+  qDebug().nospace()
+    << "Exported " << exported << " image(s) from " << total
+    << " frame(s) in " << d->Timer.elapsed() << " ms (" << skipped
+    << " already written, " << failures << " failed, " << canceled
+    << " canceled); planning "
+    << qRound64(planTime * msPerNs) << " ms, read "
+    << qRound64(d->StageTime[vpWebExporterPrivate::ReadStage].load() *
+                msPerNs) << " ms, crop "
+    << qRound64(d->StageTime[vpWebExporterPrivate::CropStage].load() *
+                msPerNs) << " ms, encode "
+    << qRound64(d->StageTime[vpWebExporterPrivate::EncodeStage].load() *
+                msPerNs) << " ms, write "
+    << qRound64(d->StageTime[vpWebExporterPrivate::WriteStage].load() *
+                msPerNs) << " ms";
+
+  return failures;
+}
@@ -0,0 +1,71 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vpWebExporter_h
+#define __vpWebExporter_h
+
+#include <qtGlobal.h>
+
+#include <functional>
+
+class QString;
+
+class vtkImageData;
+
+class vpWebExporterPrivate;
+
+// Writer of the images of an export for the web viewer.
+//
+// The images to be written are first planned, by calling addImage() for each
+// of them. When the plan is executed, each frame is read only once, however
+// many images are cropped from it, and the frames are read, cropped, encoded
+// and written on a pool of worker threads. Only the frames being worked on
+// are held in memory, so memory use is bounded by the number of threads.
+//
+// Images are written atomically, and a manifest of the images that have been
+// written is kept in the output directory. When an export is repeated in the
+// same directory (e.g. after it was interrupted), images which the manifest
+// shows were already written from the same frame and region are skipped.
+class vpWebExporter
+{
+public:
+  // Called periodically by execute() with the number of frames finished so
+  // far; returning false cancels the export.
+  typedef std::function<bool (int framesDone, int framesTotal)>
+    ProgressFunction;
+
+  explicit vpWebExporter(const QString& outputPath);
+  ~vpWebExporter();
+
+  void setThreadCount(int count);
+
+  // Plan an image, cropped from the region \p extents (x0, x1, y0, y1) of the
+  // frame \p frameIndex, read from \p frameFile, and downsampled by
+  // \p sampleRate. If \p box is not null, the outline of the region \p box
+  // (x0, x1, y0, y1) is drawn on the image. \p outputFile is relative to the
+  // output path.
+  void addImage(int frameIndex, const QString& frameFile,
+                const QString& outputFile, const int extents[4],
+                int sampleRate, const int* box = 0);
+
+  int imageCount() const;
+  int frameCount() const;
+
+  // Write an image right away, on the calling thread.
+  bool writeImage(vtkImageData* image, const QString& outputFile);
+
+  // Write the planned images, and log the time spent in each stage.
+  //
+  // \return Number of images that could not be written.
+  int execute(const ProgressFunction& progress = ProgressFunction());
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vpWebExporter)
+
+private:
+  QTE_DECLARE_PRIVATE(vpWebExporter)
+  Q_DISABLE_COPY(vpWebExporter)
+};
+
+#endif
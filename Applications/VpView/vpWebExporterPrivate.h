@@ -0,0 +1,105 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vpWebExporterPrivate_h
+#define __vpWebExporterPrivate_h
+
+#include "vpWebExporter.h"
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+
+// Name of the manifest of written images, in the output directory
+const char* const vpWebExportManifestName = "export.manifest";
+
+// Limits on reading several images of a frame as one region; the region may
+// be at most this many times the total area of the images it covers, and at
+// most this many pixels (unless a single image is larger)
+const qint64 vpWebExportMaxReadOverhead = 2;
+const qint64 vpWebExportMaxReadPixels = 4096 * 4096;
+
+//-----------------------------------------------------------------------------
+struct vpWebExportImage
+{
+  QString OutputFile;
+  QByteArray Key; // identifies the frame, region and options
+  int Extents[4];
+  int SampleRate;
+  bool DrawBox;
+  int Box[4];
+};
+
+//-----------------------------------------------------------------------------
+struct vpWebExportFrame
+{
+  QString FrameFile;
+  QVector<vpWebExportImage> Images;
+};
+
+//-----------------------------------------------------------------------------
+// Region of a frame which is read at once, and the images cropped from it
+struct vpWebExportRead
+{
+  int Extents[4];
+  qint64 ImageArea;
+  QVector<int> Images;
+};
+
+//-----------------------------------------------------------------------------
+class vpWebExporterPrivate
+{
+public:
+  enum Stage
+    {
+    ReadStage,
+    CropStage,
+    EncodeStage,
+    WriteStage,
+    StageCount
+    };
+
+  // Group the images of a frame into regions to be read. Nearby images share
+  // a read, but images far apart are read separately, so that memory use is
+  // bounded by the size of the images rather than by how far apart they are.
+  static QVector<vpWebExportRead> groupReads(
+    const QVector<vpWebExportImage>& images);
+
+  void exportFrame(const vpWebExportFrame& frame);
+  bool writeImage(vtkImageData* image, const QString& outputFile,
+                  const QByteArray& key, QElapsedTimer& timer);
+
+  void loadManifest();
+  void record(const QString& outputFile, const QByteArray& key);
+
+  void addTime(Stage stage, QElapsedTimer& timer);
+
+  QDir OutputDir;
+  QMap<int, vpWebExportFrame> Frames;
+  int ImageCount = 0;
+
+  QThreadPool Pool;
+  QAtomicInt Canceled;
+  QAtomicInt Exported;
+  QAtomicInt Failures;
+  QAtomicInt FramesDone;
+  QAtomicInteger<qint64> StageTime[StageCount];
+  QElapsedTimer Timer;
+
+  // Images written by previous exports, and the manifest, which is appended
+  // to from the worker threads
+  QHash<QString, QByteArray> Written;
+  QMutex ManifestMutex;
+  QFile Manifest;
+};
+
+#endif
@@ -0,0 +1,125 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <qtTest.h>
+
+#include "../vgRowChangeSet.h"
+
+#include <QStringList>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+// Describe ranges as text, e.g. "1-3 5", so that they can be compared
+QString describe(const QList<vgRowChangeSet::Range>& ranges)
+{
+  QStringList parts;
+  foreach (const vgRowChangeSet::Range& range, ranges)
+    {
+    parts.append(range.first == range.second
+                 ? QString::number(range.first)
+                 : QString("%1-%2").arg(range.first).arg(range.second));
+    }
+  return parts.join(" ");
+}
+
+//-----------------------------------------------------------------------------
+QString ranges(const QList<int>& rows, int rowCount, int maxRanges = 32)
+{
+  vgRowChangeSet changes;
+  foreach (const int row, rows)
+    {
+    changes.insert(row);
+    }
+  return describe(changes.ranges(rowCount, maxRanges));
+}
+
+//-----------------------------------------------------------------------------
+int testRuns(qtTest& testObject)
+{
+  // Adjacent rows form a single range
+  TEST_EQUAL(ranges(QList<int>() << 3 << 4 << 5, 10), QString("3-5"));
+  TEST_EQUAL(ranges(QList<int>() << 3 << 5, 10), QString("3 5"));
+
+  // Rows are reported in order, however they were recorded
+  TEST_EQUAL(ranges(QList<int>() << 9 << 1 << 5 << 2, 10),
+             QString("1-2 5 9"));
+  TEST_EQUAL(ranges(QList<int>() << 5 << 3 << 4, 10), QString("3-5"));
+
+  // Duplicate rows are reported once
+  TEST_EQUAL(ranges(QList<int>() << 2 << 2 << 2, 10), QString("2"));
+  TEST_EQUAL(ranges(QList<int>() << 7 << 2 << 7 << 3 << 2, 10),
+             QString("2-3 7"));
+
+  // Overlapping runs of rows are joined
+  TEST_EQUAL(ranges(QList<int>() << 1 << 2 << 3 << 4 << 3 << 4 << 5 << 6, 10),
+             QString("1-6"));
+  TEST_EQUAL(ranges(QList<int>() << 4 << 5 << 6 << 1 << 2 << 3 << 4, 10),
+             QString("1-6"));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testLimits(qtTest& testObject)
+{
+  // Rows outside of the model are dropped
+  TEST_EQUAL(ranges(QList<int>() << -1 << 0 << 7 << 8 << 9, 8),
+             QString("0 7"));
+  TEST_EQUAL(ranges(QList<int>() << 8 << 9, 8), QString());
+  TEST_EQUAL(ranges(QList<int>() << 0, 0), QString());
+
+  // Nothing changed
+  vgRowChangeSet changes;
+  TEST(changes.isEmpty());
+  TEST_EQUAL(describe(changes.ranges(10)), QString());
+
+  // Every row changed, whatever else was recorded
+  changes.insert(4);
+  changes.insertAll();
+  TEST(!changes.isEmpty());
+  TEST(changes.containsAll());
+  TEST_EQUAL(describe(changes.ranges(10)), QString("0-9"));
+  TEST_EQUAL(describe(changes.ranges(0)), QString());
+
+  changes.clear();
+  TEST(changes.isEmpty());
+  TEST(!changes.containsAll());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testMerging(qtTest& testObject)
+{
+  // The smallest gaps are merged over first
+  const QList<int> rows = QList<int>() << 0 << 2 << 10 << 11 << 20;
+  TEST_EQUAL(ranges(rows, 30, 4), QString("0 2 10-11 20"));
+  TEST_EQUAL(ranges(rows, 30, 3), QString("0-2 10-11 20"));
+  TEST_EQUAL(ranges(rows, 30, 2), QString("0-11 20"));
+  TEST_EQUAL(ranges(rows, 30, 1), QString("0-20"));
+  TEST_EQUAL(ranges(rows, 30, 0), QString("0-20"));
+
+  // Of equal gaps, only as many as needed are merged over
+  const QList<int> evenRows = QList<int>() << 6 << 0 << 4 << 2 << 4;
+  TEST_EQUAL(ranges(evenRows, 10, 3), QString("0-2 4 6"));
+  TEST_EQUAL(ranges(evenRows, 10, 2), QString("0-4 6"));
+
+  return 0;
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  qtTest testObject;
+
+  testObject.runSuite("Run Tests", testRuns);
+  testObject.runSuite("Limit Tests", testLimits);
+  testObject.runSuite("Merging Tests", testMerging);
+
+  return testObject.result();
+}
@@ -0,0 +1,158 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgRowCache_h
+#define __vgRowCache_h
+
+#include <QHash>
+#include <QVector>
+
+#include "vgRowChangeSet.h"
+
+// Row bookkeeping for a flat item model whose items are identified by key.
+//
+// The cache maps keys to rows, holds per-row display values which are costly
+// to compute (computed when first needed and kept until the row is
+// invalidated) and records invalidated rows, so that a model can announce
+// them with a few dataChanged() signals.
+template <typename KeyType, typename ValuesType>
+class vgRowCache
+{
+public:
+  typedef vgRowChangeSet::Range Range;
+
+  int count() const { return this->Entries.count(); }
+
+  KeyType key(int row) const { return this->Entries[row].Key; }
+
+  // Get the row of the item with key \p key, or -1 if there is no such item.
+  int row(const KeyType& key) const { return this->Rows.value(key, -1); }
+
+  void append(const KeyType& key);
+
+  // Remove the item at \p row; the rows of the items which follow it are
+  // shifted up by one.
+  void removeRow(int row);
+
+  void clear();
+
+  // Get the cached values of the item at \p row, or null if they have not
+  // been computed since the row was last invalidated.
+  const ValuesType* values(int row) const;
+
+  // Cache the values of the item at \p row, and return the cached values.
+  const ValuesType& setValues(int row, const ValuesType& values) const;
+
+  // Discard the cached values of the item at \p row, and record the row as
+  // changed.
+  void invalidate(int row);
+
+  // Discard all cached values, and record every row as changed.
+  void invalidateAll();
+
+  // Get the rows changed since the last call as ranges of consecutive rows
+  // (see vgRowChangeSet::ranges), and clear the recorded changes.
+  QList<Range> takeChanges(int maxRanges = 32);
+
+protected:
+  struct Entry
+    {
+    Entry() : Cached(false) {}
+    explicit Entry(const KeyType& key) : Key(key), Cached(false) {}
+
+    KeyType Key;
+    bool Cached;
+    ValuesType Values;
+    };
+
+  QHash<KeyType, int> Rows;
+  mutable QVector<Entry> Entries;
+  vgRowChangeSet Changes;
+};
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+void vgRowCache<KeyType, ValuesType>::append(const KeyType& key)
+{
+  this->Rows.insert(key, this->Entries.count());
+  this->Entries.append(Entry(key));
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+void vgRowCache<KeyType, ValuesType>::removeRow(int row)
+{
+  this->Rows.remove(this->Entries[row].Key);
+  this->Entries.remove(row);
+
+  for (int i = row, k = this->Entries.count(); i < k; ++i)
+    {
+    this->Rows.insert(this->Entries[i].Key, i);
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+void vgRowCache<KeyType, ValuesType>::clear()
+{
+  this->Rows.clear();
+  this->Entries.clear();
+  this->Changes.clear();
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+const ValuesType* vgRowCache<KeyType, ValuesType>::values(int row) const
+{
+  const Entry& entry = this->Entries[row];
+  return (entry.Cached ? &entry.Values : 0);
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+const ValuesType& vgRowCache<KeyType, ValuesType>::setValues(
+  int row, const ValuesType& values) const
+{
+  Entry& entry = this->Entries[row];
+  entry.Values = values;
+  entry.Cached = true;
+  return entry.Values;
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+void vgRowCache<KeyType, ValuesType>::invalidate(int row)
+{
+  Entry& entry = this->Entries[row];
+  if (entry.Cached)
+    {
+    entry.Values = ValuesType();
+    entry.Cached = false;
+    }
+  this->Changes.insert(row);
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+void vgRowCache<KeyType, ValuesType>::invalidateAll()
+{
+  for (int i = 0, k = this->Entries.count(); i < k; ++i)
+    {
+    this->Entries[i].Values = ValuesType();
+    this->Entries[i].Cached = false;
+    }
+  this->Changes.insertAll();
+}
+
+//-----------------------------------------------------------------------------
+template <typename KeyType, typename ValuesType>
+QList<typename vgRowCache<KeyType, ValuesType>::Range>
+vgRowCache<KeyType, ValuesType>::takeChanges(int maxRanges)
+{
+  const QList<Range> ranges = this->Changes.ranges(this->count(), maxRanges);
+  this->Changes.clear();
+  return ranges;
+}
+
+#endif
@@ -0,0 +1,100 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vgRowChangeSet.h"
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+void vgRowChangeSet::clear()
+{
+  this->Rows.clear();
+  this->All = false;
+}
+
+//-----------------------------------------------------------------------------
+QList<vgRowChangeSet::Range> vgRowChangeSet::ranges(
+  int rowCount, int maxRanges) const
+{
+  QList<Range> result;
+  if (rowCount < 1)
+    {
+    return result;
+    }
+
+  if (this->All)
+    {
+    result.append(Range(0, rowCount - 1));
+    return result;
+    }
+
+  QVector<int> rows = this->Rows;
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+
+  // Collect runs of consecutive rows
+  QVector<Range> runs;
+  foreach (int row, rows)
+    {
+    if (row < 0 || row >= rowCount)
+      {
+      continue;
+      }
+    if (!runs.isEmpty() && runs.last().second + 1 == row)
+      {
+      runs.last().second = row;
+      }
+    else
+      {
+      runs.append(Range(row, row));
+      }
+    }
+
+  const int excess = runs.count() - qMax(1, maxRanges);
+  if (excess <= 0)
+    {
+    return runs.toList();
+    }
+
+  // Too many runs; find the largest gap that must still be bridged, so that
+  // only the smallest gaps are merged over
+  QVector<int> gaps;
+  gaps.reserve(runs.count() - 1);
+  for (int i = 1, k = runs.count(); i < k; ++i)
+    {
+    gaps.append(runs[i].first - runs[i - 1].second);
+    }
+
+  QVector<int> sortedGaps = gaps;
+  std::nth_element(sortedGaps.begin(), sortedGaps.begin() + (excess - 1),
+                   sortedGaps.end());
+  const int threshold = sortedGaps[excess - 1];
+
+  // Gaps equal to the threshold may be more than are needed; merge only as
+  // many of those as required
+  int equalToMerge = excess;
+  foreach (int gap, gaps)
+    {
+    if (gap < threshold)
+      {
+      --equalToMerge;
+      }
+    }
+
+  result.append(runs.first());
+  for (int i = 1, k = runs.count(); i < k; ++i)
+    {
+    const int gap = gaps[i - 1];
+    if (gap < threshold || (gap == threshold && equalToMerge-- > 0))
+      {
+      result.last().second = runs[i].second;
+      }
+    else
+      {
+      result.append(runs[i]);
+      }
+    }
+
+  return result;
+}
@@ -0,0 +1,47 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgRowChangeSet_h
+#define __vgRowChangeSet_h
+
+#include <QList>
+#include <QPair>
+#include <QVector>
+
+#include <vgExport.h>
+
+// Set of changed rows of a flat item model.
+//
+// Rows are recorded as they change, and reported as ranges of consecutive
+// rows, so that a model can announce them with a few dataChanged() signals
+// rather than either one per row or one for the whole model.
+class QTVG_COMMON_EXPORT vgRowChangeSet
+{
+public:
+  typedef QPair<int, int> Range; // first and last row
+
+  vgRowChangeSet() : All(false) {}
+
+  void insert(int row) { this->Rows.append(row); }
+
+  // Mark every row as changed.
+  void insertAll() { this->All = true; }
+
+  bool isEmpty() const { return !this->All && this->Rows.isEmpty(); }
+  bool containsAll() const { return this->All; }
+
+  void clear();
+
+  // Get the changed rows, in order, as ranges of consecutive rows, limited to
+  // rows less than \p rowCount. If there are more than \p maxRanges ranges,
+  // the ranges separated by the smallest gaps are merged, so that the ranges
+  // cover as few unchanged rows as possible.
+  QList<Range> ranges(int rowCount, int maxRanges = 32) const;
+
+protected:
+  QVector<int> Rows;
+  bool All;
+};
+
+#endif
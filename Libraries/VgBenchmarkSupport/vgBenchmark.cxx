@@ -0,0 +1,183 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vgBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QVariant>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+//-----------------------------------------------------------------------------
+void vgBenchmark::record(
+  const QString& suite, const QString& name, const QJsonObject& parameters,
+  double work, const QString& unit, double best, double mean)
+{
+  const double rate = (best > 0.0 ? work / best : 0.0);
+
+  QJsonObject result;
+  result.insert("suite", suite);
+  result.insert("name", name);
+  result.insert("parameters", parameters);
+  result.insert("iterations", this->Iterations);
+  result.insert("best_seconds", best);
+  result.insert("mean_seconds", mean);
+  result.insert("work", work);
+  result.insert("unit", unit);
+  result.insert("rate", rate);
+  result.insert("peak_rss_bytes", peakResidentBytes());
+  this->Results.append(result);
+
+  qDebug().nospace()
+    << qPrintable(suite) << '/' << qPrintable(name) << ' '
+    << qPrintable(QString::fromUtf8(
+                    QJsonDocument(parameters).toJson(QJsonDocument::Compact)))
+    << ": best " << qPrintable(QString::number(best, 'f', 6)) << " s, mean "
+    << qPrintable(QString::number(mean, 'f', 6)) << " s ("
+    << qPrintable(QString::number(rate, 'f', 1)) << ' '
+    << qPrintable(unit) << "/s)";
+}
+
+//-----------------------------------------------------------------------------
+void vgBenchmark::annotate(const QString& key, const QJsonValue& value)
+{
+  if (this->Results.isEmpty())
+    {
+    return;
+    }
+
+  const int last = this->Results.count() - 1;
+  QJsonObject result = this->Results.at(last).toObject();
+  result.insert(key, value);
+  this->Results.replace(last, result);
+
+  qDebug().nospace()
+    << "  " << qPrintable(key) << ": "
+    << qPrintable(value.toVariant().toString());
+}
+
+//-----------------------------------------------------------------------------
+bool vgBenchmark::writeResults(const QString& fileName) const
+{
+  QJsonObject root;
+  root.insert("version", 1);
+  root.insert("timestamp",
+              QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+  root.insert("results", this->Results);
+  const QByteArray json = QJsonDocument(root).toJson();
+
+  QFile file(fileName);
+  const bool opened = (fileName == "-"
+                       ? file.open(stdout, QIODevice::WriteOnly)
+                       : file.open(QIODevice::WriteOnly));
+  if (!opened || file.write(json) != json.size())
+    {
+    qCritical() << "ERROR: Failed to write results to" << fileName
+                << '-' << file.errorString();
+    return false;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vgBenchmark::addOptions(
+  qtCliOptions& options, const QString& suiteNames,
+  const QString& defaultSuites)
+{
+  options.add("suites <names>",
+              "Comma separated list of benchmark suites to run " + suiteNames,
+              defaultSuites)
+         .add("s", qtCliOption::Short);
+
+  options.add("output <file>",
+              "Write results as JSON to the specified file "
+              "(use '-' to write to stdout)")
+         .add("o", qtCliOption::Short);
+
+  options.add("iterations <num>",
+              "Number of times to run each measurement", "3")
+         .add("i", qtCliOption::Short);
+
+  options.add("work-dir <dir>",
+              "Directory in which to write synthetic data "
+              "(a temporary directory is used by default)")
+         .add("w", qtCliOption::Short);
+}
+
+//-----------------------------------------------------------------------------
+QString vgBenchmark::workDirectory(
+  const QString& path, QScopedPointer<QTemporaryDir>& tempDir)
+{
+  if (path.isEmpty())
+    {
+    tempDir.reset(new QTemporaryDir);
+    if (!tempDir->isValid())
+      {
+      qCritical() << "ERROR: Failed to create temporary directory";
+      return QString();
+      }
+    return tempDir->path();
+    }
+  else if (!QDir().mkpath(path))
+    {
+    qCritical() << "ERROR: Failed to create work directory" << path;
+    return QString();
+    }
+
+  return path;
+}
+
+//-----------------------------------------------------------------------------
+QList<int> vgBenchmark::parseSizes(const QString& list)
+{
+  QList<int> sizes;
+  foreach (const QString& s, list.split(',', QString::SkipEmptyParts))
+    {
+    bool okay;
+    const int n = s.trimmed().toInt(&okay);
+    if (okay && n > 0)
+      {
+      sizes.append(n);
+      }
+    else
+      {
+      qWarning() << "Ignoring invalid size" << s;
+      }
+    }
+  return sizes;
+}
+
+//-----------------------------------------------------------------------------
+QSize vgBenchmark::parseFrameSize(const QString& size)
+{
+  const QStringList parts = size.split('x');
+  return QSize(qMax(1, parts.value(0).toInt()),
+               qMax(1, parts.value(1).toInt()));
+}
+
+//-----------------------------------------------------------------------------
+qint64 vgBenchmark::peakResidentBytes()
+{
+#ifdef Q_OS_UNIX
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef Q_OS_MAC
+    return static_cast<qint64>(usage.ru_maxrss);
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+  return -1;
+}
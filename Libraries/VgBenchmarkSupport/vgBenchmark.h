@@ -0,0 +1,110 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgBenchmark_h
+#define __vgBenchmark_h
+
+#include <vgExport.h>
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QScopedPointer>
+#include <QSize>
+#include <QString>
+
+#include <limits>
+
+class QTemporaryDir;
+
+class qtCliOptions;
+
+// Runner and recorder of performance measurements.
+//
+// Each measurement is run a number of times, and the best and mean times are
+// recorded, along with the peak resident memory of the process. The recorded
+// results can be written as JSON, so that results from different builds can
+// be compared.
+class VG_BENCHMARKSUPPORT_EXPORT vgBenchmark
+{
+public:
+  explicit vgBenchmark(int iterations) : Iterations(qMax(1, iterations)) {}
+
+  // Run a measurement, and record the best and mean times; 'work' is the
+  // number of items (frames, tracks, seeks, etc.) processed by each run, and
+  // is used to report a rate
+  template <typename Func>
+  void measure(const QString& suite, const QString& name,
+               const QJsonObject& parameters, double work,
+               const QString& unit, Func func);
+
+  // Add \p value as \p key to the most recently recorded result, e.g. to
+  // report a count which is measured separately from the run times
+  void annotate(const QString& key, const QJsonValue& value);
+
+  int iterations() const { return this->Iterations; }
+  QJsonArray results() const { return this->Results; }
+
+  // Write the recorded results as JSON to \p fileName ('-' for stdout).
+  bool writeResults(const QString& fileName) const;
+
+  // Add the options common to all benchmark tools ('suites', 'output',
+  // 'iterations' and 'work-dir') to \p options.
+  static void addOptions(qtCliOptions& options, const QString& suiteNames,
+                         const QString& defaultSuites);
+
+  // Get the directory in which to write synthetic data. If \p path is empty,
+  // a temporary directory is created, which is removed when \p tempDir is
+  // destroyed. Returns an empty string on failure.
+  static QString workDirectory(const QString& path,
+                               QScopedPointer<QTemporaryDir>& tempDir);
+
+  // Parse a comma separated list of positive sizes, ignoring invalid ones.
+  static QList<int> parseSizes(const QString& list);
+
+  // Parse a size given as '<width>x<height>'.
+  static QSize parseFrameSize(const QString& size);
+
+  // Get the peak resident set size of the process, in bytes, or -1 if not
+  // available; note that this is a high-water mark for the entire process,
+  // and so only reflects a particular measurement if it is the largest so far
+  static qint64 peakResidentBytes();
+
+protected:
+  void record(const QString& suite, const QString& name,
+              const QJsonObject& parameters, double work,
+              const QString& unit, double best, double mean);
+
+  const int Iterations;
+  QJsonArray Results;
+};
+
+//-----------------------------------------------------------------------------
+template <typename Func>
+void vgBenchmark::measure(
+  const QString& suite, const QString& name, const QJsonObject& parameters,
+  double work, const QString& unit, Func func)
+{
+  QElapsedTimer timer;
+  double best = std::numeric_limits<double>::infinity();
+  double total = 0.0;
+
+  for (int n = 0; n < this->Iterations; ++n)
+    {
+    timer.start();
+    func();
+    const double elapsed = 1e-9 * timer.nsecsElapsed();
+    best = qMin(best, elapsed);
+    total += elapsed;
+    }
+
+  this->record(suite, name, parameters, work, unit,
+               best, total / this->Iterations);
+}
+
+#endif
@@ -0,0 +1,233 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vgBenchmarkData.h"
+
+#include <qtStlUtil.h>
+
+#include <vil/io/vil_io_image_view.h>
+#include <vil/vil_image_view.h>
+#include <vnl/io/vnl_io_matrix_fixed.h>
+#include <vnl/io/vnl_io_vector_fixed.hxx>
+#include <vnl/vnl_matrix_fixed.h>
+#include <vsl/vsl_binary_io.h>
+#include <vsl/vsl_vector_io.hxx>
+
+#include <QDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <vector>
+
+VNL_IO_VECTOR_FIXED_INSTANTIATE(double, 2);
+VSL_VECTOR_IO_INSTANTIATE(vnl_vector_fixed<double VCL_COMMA 2>);
+
+//-----------------------------------------------------------------------------
+bool vgBenchmarkData::writeSyntheticKwa(
+  const QString& directory, int frameCount, int width, int height,
+  QString& indexName)
+{
+  const QDir dir(directory);
+  const QString dataName = dir.filePath("synthetic.data");
+  const QString metaName = dir.filePath("synthetic.meta");
+  indexName = dir.filePath("synthetic.index");
+
+  QFile indexFile(indexName);
+  if (!indexFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+    qWarning() << "Failed to create" << indexName;
+    return false;
+    }
+
+  vsl_b_ofstream dataStream(stdString(dataName));
+  vsl_b_ofstream metaStream(stdString(metaName));
+  if (!dataStream || !metaStream)
+    {
+    qWarning() << "Failed to create synthetic video data in" << directory;
+    return false;
+    }
+
+  QTextStream index(&indexFile);
+  index << "3\n" << dataName << '\n' << metaName << '\n' << "BENCHMARK\n";
+
+  vsl_b_write(dataStream, 2);
+  vsl_b_write(metaStream, 2);
+
+  vnl_matrix_fixed<double, 3, 3> homography;
+  homography.set_identity();
+
+  std::vector<vnl_vector_fixed<double, 2> > corners(4);
+  corners[0] = vnl_vector_fixed<double, 2>(42.90, -73.80);
+  corners[1] = vnl_vector_fixed<double, 2>(42.90, -73.79);
+  corners[2] = vnl_vector_fixed<double, 2>(42.89, -73.80);
+  corners[3] = vnl_vector_fixed<double, 2>(42.89, -73.79);
+
+  const vxl_int_64 imageWidth = width;
+  const vxl_int_64 imageHeight = height;
+  const double gsd = 0.5;
+  const vxl_int_64 referenceFrame = 0;
+
+  vil_image_view<vxl_byte> image(width, height, 3);
+  for (int n = 0; n < frameCount; ++n)
+    {
+    const vxl_int_64 time = n * FrameInterval;
+    const vxl_int_64 frameNumber = n;
+
+    // Draw a moving gradient, so frames are not all identical
+    for (unsigned int j = 0; j < image.nj(); ++j)
+      {
+      for (unsigned int i = 0; i < image.ni(); ++i)
+        {
+        image(i, j, 0) = static_cast<vxl_byte>(i + n);
+        image(i, j, 1) = static_cast<vxl_byte>(j + n);
+        image(i, j, 2) = static_cast<vxl_byte>(i ^ j);
+        }
+      }
+
+    // Write frame data
+    dataStream.clear_serialisation_records();
+    const std::streamoff offset = dataStream.os().tellp();
+    vsl_b_write(dataStream, time);
+    vsl_b_write(dataStream, image);
+    vsl_b_write(dataStream, homography);
+    vsl_b_write(dataStream, corners);
+    vsl_b_write(dataStream, gsd);
+    vsl_b_write(dataStream, frameNumber);
+    vsl_b_write(dataStream, referenceFrame);
+    vsl_b_write(dataStream, imageWidth);
+    vsl_b_write(dataStream, imageHeight);
+
+    // Write frame metadata
+    metaStream.clear_serialisation_records();
+    vsl_b_write(metaStream, time);
+    vsl_b_write(metaStream, homography);
+    vsl_b_write(metaStream, corners);
+    vsl_b_write(metaStream, gsd);
+    vsl_b_write(metaStream, frameNumber);
+    vsl_b_write(metaStream, referenceFrame);
+    vsl_b_write(metaStream, imageWidth);
+    vsl_b_write(metaStream, imageHeight);
+
+    // Write index entry
+    index << static_cast<qint64>(time) << ' '
+          << static_cast<quint64>(offset) << '\n';
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+QList<vvTrack> vgBenchmarkData::makeSyntheticTracks(
+  int trackCount, int trackLength, int frameCount, std::mt19937& rng)
+{
+  std::uniform_int_distribution<int> startDist(
+    0, qMax(0, frameCount - trackLength));
+  std::uniform_real_distribution<double> posDist(0.0, 1000.0);
+  std::uniform_real_distribution<double> velDist(-2.0, 2.0);
+
+  QList<vvTrack> tracks;
+  for (int t = 0; t < trackCount; ++t)
+    {
+    vvTrack track;
+    track.Id = vvTrackId(1, t);
+    track.Classification["Person"] = 0.5;
+    track.Classification["Vehicle"] = 0.3;
+    track.Classification["Other"] = 0.2;
+
+    const int start = startDist(rng);
+    double x = posDist(rng), y = posDist(rng);
+    const double dx = velDist(rng), dy = velDist(rng);
+
+    for (int n = start; n < start + trackLength; ++n, x += dx, y += dy)
+      {
+      vvTrackState state;
+      state.TimeStamp = vgTimeStamp(n * FrameInterval, n);
+      state.ImagePoint = vvImagePointF(x, y);
+      state.ImageBox.TopLeft = vvImagePoint(qRound(x) - 8, qRound(y) - 16);
+      state.ImageBox.BottomRight = vvImagePoint(qRound(x) + 8, qRound(y));
+      state.ImageObject.push_back(vvImagePointF(x - 8.0, y - 16.0));
+      state.ImageObject.push_back(vvImagePointF(x + 8.0, y - 16.0));
+      state.ImageObject.push_back(vvImagePointF(x + 8.0, y));
+      state.ImageObject.push_back(vvImagePointF(x - 8.0, y));
+      state.WorldLocation.GCS = 4326;
+      state.WorldLocation.Latitude = 42.9 - 1e-6 * y;
+      state.WorldLocation.Longitude = -73.8 + 1e-6 * x;
+      track.Trajectory.insert(state);
+      }
+
+    tracks.append(track);
+    }
+
+  return tracks;
+}
+
+//-----------------------------------------------------------------------------
+QList<vvDescriptor> vgBenchmarkData::makeSyntheticDescriptors(
+  int descriptorCount, int valueCount, std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> valueDist(0.0f, 1.0f);
+
+  QList<vvDescriptor> descriptors;
+  for (int d = 0; d < descriptorCount; ++d)
+    {
+    vvDescriptor descriptor;
+    descriptor.DescriptorName = "synthetic";
+    descriptor.ModuleName = "vgBenchmark";
+    descriptor.InstanceId = d;
+    descriptor.Confidence = 1.0;
+    descriptor.TrackIds.push_back(vvTrackId(1, d));
+
+    std::vector<float> values(valueCount);
+    std::generate(values.begin(), values.end(),
+                  [&]{ return valueDist(rng); });
+    descriptor.Values.push_back(values);
+
+    for (int n = 0; n < 10; ++n)
+      {
+      vvDescriptorRegionEntry region;
+      region.TimeStamp = vgTimeStamp((d + n) * FrameInterval, d + n);
+      region.ImageRegion.TopLeft = vvImagePoint(n, n);
+      region.ImageRegion.BottomRight = vvImagePoint(n + 32, n + 64);
+      descriptor.Region.insert(region);
+      }
+
+    descriptors.append(descriptor);
+    }
+
+  return descriptors;
+}
+
+//-----------------------------------------------------------------------------
+QList<vvQueryResult> vgBenchmarkData::makeSyntheticResults(
+  int resultCount, int trackLength, int frameCount, std::mt19937& rng)
+{
+  const QList<vvTrack> tracks =
+    makeSyntheticTracks(resultCount, trackLength, frameCount, rng);
+  const QList<vvDescriptor> descriptors =
+    makeSyntheticDescriptors(resultCount, 128, rng);
+
+  QList<vvQueryResult> results;
+  for (int r = 0; r < resultCount; ++r)
+    {
+    vvQueryResult result;
+    result.MissionId = "MISSION-BENCHMARK";
+    result.QueryId = "QUERY-BENCHMARK";
+    result.StreamId = "STREAM-BENCHMARK";
+    result.InstanceId = r;
+    result.StartTime = static_cast<long long>(
+                         tracks[r].Trajectory.begin()->TimeStamp.Time);
+    result.EndTime = static_cast<long long>(
+                       tracks[r].Trajectory.rbegin()->TimeStamp.Time);
+    result.Location.GCS = 4326;
+    result.Location.Latitude = 42.9;
+    result.Location.Longitude = -73.8;
+    result.Rank = r;
+    result.RelevancyScore = 1.0 - (static_cast<double>(r) / resultCount);
+    result.Tracks.push_back(tracks[r]);
+    result.Descriptors.push_back(descriptors[r]);
+    results.append(result);
+    }
+
+  return results;
+}
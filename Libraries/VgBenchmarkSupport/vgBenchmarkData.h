@@ -0,0 +1,74 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgBenchmarkData_h
+#define __vgBenchmarkData_h
+
+#include <vgExport.h>
+
+#include <vvDescriptor.h>
+#include <vvHeader.h>
+#include <vvQueryResult.h>
+#include <vvTrack.h>
+#include <vvWriter.h>
+
+#include <QDebug>
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include <random>
+
+// Generation of synthetic data for benchmarks.
+namespace vgBenchmarkData
+{
+  // Synthetic data is generated at 30 frames per second, with times in
+  // microseconds
+  const qint64 FrameInterval = 33333;
+
+  // Write a KWA video archive of \p frameCount frames of a moving gradient
+  // to \p directory, and set \p indexName to the name of its index file.
+  VG_BENCHMARKSUPPORT_EXPORT bool writeSyntheticKwa(
+    const QString& directory, int frameCount, int width, int height,
+    QString& indexName);
+
+  // Make tracks of \p trackLength states, moving in straight lines and
+  // starting at random frames.
+  VG_BENCHMARKSUPPORT_EXPORT QList<vvTrack> makeSyntheticTracks(
+    int trackCount, int trackLength, int frameCount, std::mt19937& rng);
+
+  VG_BENCHMARKSUPPORT_EXPORT QList<vvDescriptor> makeSyntheticDescriptors(
+    int descriptorCount, int valueCount, std::mt19937& rng);
+
+  // Make query results, each with one track and one descriptor.
+  VG_BENCHMARKSUPPORT_EXPORT QList<vvQueryResult> makeSyntheticResults(
+    int resultCount, int trackLength, int frameCount, std::mt19937& rng);
+
+  template <typename T>
+  bool writeSyntheticArchive(const QString& fileName, vvWriter::Format format,
+                             vvHeader::FileType type, const QList<T>& data);
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool vgBenchmarkData::writeSyntheticArchive(
+  const QString& fileName, vvWriter::Format format, vvHeader::FileType type,
+  const QList<T>& data)
+{
+  QFile file(fileName);
+  const QIODevice::OpenMode mode =
+    (format == vvWriter::Binary ? QIODevice::WriteOnly
+                                : QIODevice::WriteOnly | QIODevice::Text);
+  if (!file.open(mode))
+    {
+    qWarning() << "Failed to create" << fileName;
+    return false;
+    }
+
+  vvWriter writer(file, format, false);
+  writer << type << data;
+  return true;
+}
+
+#endif
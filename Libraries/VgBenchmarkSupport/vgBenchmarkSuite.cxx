@@ -0,0 +1,192 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vgBenchmarkSuite.h"
+
+#include "vgBenchmark.h"
+
+#include <qtCliArgs.h>
+
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+QList<vgBenchmarkSuite*>& registeredSuites()
+{
+  static QList<vgBenchmarkSuite*> suites;
+  return suites;
+}
+
+//-----------------------------------------------------------------------------
+bool compareSuiteNames(const vgBenchmarkSuite* a, const vgBenchmarkSuite* b)
+{
+  return a->name() < b->name();
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+QString vgBenchmarkContext::value(const QString& option) const
+{
+  return this->Args.value(option);
+}
+
+//-----------------------------------------------------------------------------
+bool vgBenchmarkContext::isSet(const QString& option) const
+{
+  return this->Args.isSet(option);
+}
+
+//-----------------------------------------------------------------------------
+QList<int> vgBenchmarkContext::sizes(const QString& option) const
+{
+  return vgBenchmark::parseSizes(this->Args.value(option));
+}
+
+//-----------------------------------------------------------------------------
+int vgBenchmarkContext::count(const QString& option, int minimum) const
+{
+  return qMax(minimum, this->Args.value(option).toInt());
+}
+
+//-----------------------------------------------------------------------------
+QSize vgBenchmarkContext::frameSize(const QString& option) const
+{
+  return vgBenchmark::parseFrameSize(this->Args.value(option));
+}
+
+//-----------------------------------------------------------------------------
+int vgBenchmarkContext::threadCount(const QString& option) const
+{
+  return (this->Args.isSet(option)
+          ? qMax(1, this->Args.value(option).toInt())
+          : QThread::idealThreadCount());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite::vgBenchmarkSuite(
+  const char* name, OptionsFunction addOptions, RunFunction run,
+  bool runByDefault)
+  : Name(name), AddOptions(addOptions), Run(run), RunByDefault(runByDefault)
+{
+  registeredSuites().append(this);
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite::~vgBenchmarkSuite()
+{
+  registeredSuites().removeAll(this);
+}
+
+//-----------------------------------------------------------------------------
+int vgBenchmarkSuite::exec(
+  int argc, char** argv, const QString& applicationName,
+  OptionsFunction addSharedOptions)
+{
+  // Set application information
+  QCoreApplication::setApplicationName(applicationName);
+  QCoreApplication::setOrganizationName("Kitware");
+  QCoreApplication::setOrganizationDomain("kitware.com");
+
+  // Registration order depends on link order, so list suites by name
+  QList<vgBenchmarkSuite*> suites = registeredSuites();
+  std::sort(suites.begin(), suites.end(), &compareSuiteNames);
+
+  QStringList suiteNames;
+  QStringList defaultSuites;
+  foreach (vgBenchmarkSuite* const suite, suites)
+    {
+    suiteNames.append('\'' + suite->name() + '\'');
+    if (suite->RunByDefault)
+      {
+      defaultSuites.append(suite->name());
+      }
+    }
+
+  // Set up command line options
+  qtCliArgs args(argc, argv);
+
+  qtCliOptions options;
+
+  vgBenchmark::addOptions(options, '(' + suiteNames.join(", ") + ')',
+                          defaultSuites.join(','));
+  if (addSharedOptions)
+    {
+    addSharedOptions(options);
+    }
+  foreach (vgBenchmarkSuite* const suite, suites)
+    {
+    if (suite->AddOptions)
+      {
+      suite->AddOptions(options);
+      }
+    }
+
+  args.addOptions(options);
+
+  // Parse arguments
+  args.parseOrDie();
+
+  QCoreApplication app(args.qtArgc(), args.qtArgv());
+
+  // Look up the requested suites
+  QList<vgBenchmarkSuite*> selectedSuites;
+  const QString requested = args.value("suites").toLower();
+  foreach (const QString& name, requested.split(',', QString::SkipEmptyParts))
+    {
+    vgBenchmarkSuite* selected = 0;
+    foreach (vgBenchmarkSuite* const suite, suites)
+      {
+      if (suite->name() == name.trimmed())
+        {
+        selected = suite;
+        break;
+        }
+      }
+
+    if (!selected)
+      {
+      qWarning() << "Benchmark suite" << name.trimmed()
+                 << "is not available; skipping";
+      }
+    else if (!selectedSuites.contains(selected))
+      {
+      selectedSuites.append(selected);
+      }
+    }
+
+  // Set up directory for synthetic data
+  QScopedPointer<QTemporaryDir> tempDir;
+  const QString workDir =
+    vgBenchmark::workDirectory(args.value("work-dir"), tempDir);
+  if (workDir.isEmpty())
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Run benchmarks
+  vgBenchmark benchmark(args.value("iterations").toInt());
+  const vgBenchmarkContext context(args, workDir);
+
+  foreach (vgBenchmarkSuite* const suite, selectedSuites)
+    {
+    suite->Run(benchmark, context);
+    }
+
+  // Write results
+  if (args.isSet("output") && !benchmark.writeResults(args.value("output")))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
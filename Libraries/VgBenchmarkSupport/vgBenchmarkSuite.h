@@ -0,0 +1,93 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgBenchmarkSuite_h
+#define __vgBenchmarkSuite_h
+
+#include <vgExport.h>
+
+#include <QList>
+#include <QSize>
+#include <QString>
+
+class qtCliArgs;
+class qtCliOptions;
+
+class vgBenchmark;
+
+// Parsed command line and work directory of a benchmark tool, as given to
+// each of its suites.
+class VG_BENCHMARKSUPPORT_EXPORT vgBenchmarkContext
+{
+public:
+  vgBenchmarkContext(const qtCliArgs& args, const QString& workDirectory)
+    : Args(args), WorkDirectory(workDirectory) {}
+
+  QString value(const QString& option) const;
+  bool isSet(const QString& option) const;
+
+  // Directory in which to write synthetic data.
+  QString workDirectory() const { return this->WorkDirectory; }
+
+  // Get the value of \p option as a comma separated list of positive sizes.
+  QList<int> sizes(const QString& option) const;
+
+  // Get the value of \p option as a count of at least \p minimum.
+  int count(const QString& option, int minimum = 1) const;
+
+  // Get the value of \p option as a size given as '<width>x<height>'.
+  QSize frameSize(const QString& option) const;
+
+  // Get the value of \p option as a number of threads, or the number of
+  // processor cores if the option is not set.
+  int threadCount(const QString& option) const;
+
+protected:
+  const qtCliArgs& Args;
+  const QString WorkDirectory;
+};
+
+// Named set of measurements run by a benchmark tool.
+//
+// Suites register themselves when constructed, and are meant to be declared
+// as static objects in the source file which implements them, so that adding
+// a suite to a tool only requires adding that file to the tool's sources.
+class VG_BENCHMARKSUPPORT_EXPORT vgBenchmarkSuite
+{
+public:
+  typedef void (*OptionsFunction)(qtCliOptions& options);
+  typedef void (*RunFunction)(vgBenchmark& benchmark,
+                              const vgBenchmarkContext& context);
+
+  // Register a suite named \p name. The suite's command line options are
+  // added by \p addOptions (which may be null), and its measurements are made
+  // by \p run. If \p runByDefault is set, the suite is run when the user does
+  // not select suites explicitly.
+  vgBenchmarkSuite(const char* name, OptionsFunction addOptions,
+                   RunFunction run, bool runByDefault);
+  ~vgBenchmarkSuite();
+
+  QString name() const { return QString::fromLatin1(this->Name); }
+
+  // Run a benchmark tool; this is meant to be called from the tool's main().
+  //
+  // The command line accepts the options common to all tools, the options
+  // added by \p addSharedOptions (for options used by several of the tool's
+  // suites; may be null), and the options of each registered suite. The
+  // selected suites are run in the order given, and the results are written
+  // as requested. Returns the process exit code.
+  static int exec(int argc, char** argv, const QString& applicationName,
+                  OptionsFunction addSharedOptions);
+
+protected:
+  const char* const Name;
+  const OptionsFunction AddOptions;
+  const RunFunction Run;
+  const bool RunByDefault;
+
+private:
+  Q_DISABLE_COPY(vgBenchmarkSuite)
+};
+
+#endif
@@ -126,6 +126,40 @@ int testRoundTripConversion(qtTest& testObject)
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+int testPolyConversion(qtTest& testObject)
+{
+  vgGeocodedPoly poly;
+  poly.GCS = vgGeodesy::LatLon_Wgs84;
+  poly.Coordinate.push_back(llCoord());
+  poly.Coordinate.push_back(llCoord());
+  poly.Coordinate.push_back(llCoord());
+
+  const vgGeocodedPoly utmPoly = vgGeodesy::convertGcs(poly, TestUtmZoneGcs);
+  TEST_EQUAL(utmPoly.GCS, TestUtmZoneGcs);
+  if (TEST_EQUAL(utmPoly.Coordinate.size(), poly.Coordinate.size()))
+    return 1;
+
+  for (size_t n = 0; n < utmPoly.Coordinate.size(); ++n)
+    {
+    const vgGeocodedCoordinate c(utmPoly.Coordinate[n], utmPoly.GCS);
+    TEST_EQUAL(c, utmCoord());
+    }
+
+  const vgGeocodedPoly llPoly =
+    vgGeodesy::convertGcs(utmPoly, vgGeodesy::LatLon_Wgs84);
+  if (TEST_EQUAL(llPoly.Coordinate.size(), poly.Coordinate.size()))
+    return 1;
+
+  for (size_t n = 0; n < llPoly.Coordinate.size(); ++n)
+    {
+    const vgGeocodedCoordinate c(llPoly.Coordinate[n], llPoly.GCS);
+    TEST_EQUAL(c, llCoord());
+    }
+
+  return 0;
+}
+
 //-----------------------------------------------------------------------------
 int testCreateRegion(qtTest& testObject)
 {
@@ -156,6 +190,7 @@ int main(int argc, const char* argv[])
   testObject.runSuite("LL -> UTM Conversion Test", testLatLonToUtmConversion);
   testObject.runSuite("UTM -> LL Conversion Test", testUtmToLatLonConversion);
   testObject.runSuite("Round Trip Conversion Test", testRoundTripConversion);
+  testObject.runSuite("Poly Conversion Test", testPolyConversion);
   testObject.runSuite("Generate Region Test", testCreateRegion);
 //   testObject.runSuite("Region Center Test", testRegionCenter);
   return testObject.result();
@@ -0,0 +1,132 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <qtTest.h>
+
+#include "../vgIntervalIndex.h"
+#include "../vgTimeStamp.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+typedef vgIntervalIndex<int, int> Index;
+
+//-----------------------------------------------------------------------------
+std::vector<int> query(const Index& index, int lower, int upper)
+{
+  std::vector<int> result;
+  index.ForEachOverlapping(lower, upper,
+                           [&result](int v){ result.push_back(v); });
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+int testBasic(qtTest& testObject)
+{
+  Index index;
+  TEST(index.IsEmpty());
+  TEST(query(index, 0, 100).empty());
+
+  index.Insert(10, 20, 0);
+  index.Insert(15, 15, 1);
+  index.Insert(30, 40, 2);
+  index.Insert(0, 100, 3);
+
+  // Not queryable until built
+  TEST(query(index, 15, 15).empty());
+
+  index.Build();
+  TEST_EQUAL(index.GetSize(), size_t(4));
+
+  TEST(query(index, 15, 15) == std::vector<int>({0, 1, 3}));
+  TEST(query(index, 20, 30) == std::vector<int>({0, 2, 3}));
+  TEST(query(index, 21, 29) == std::vector<int>({3}));
+  TEST(query(index, 101, 200).empty());
+
+  std::vector<int> containing;
+  index.ForEachContaining(40, [&](int v){ containing.push_back(v); });
+  std::sort(containing.begin(), containing.end());
+  TEST(containing == std::vector<int>({2, 3}));
+
+  index.Clear();
+  TEST(index.IsEmpty());
+  TEST(query(index, 0, 100).empty());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testRandom(qtTest& testObject)
+{
+  srand(42);
+
+  std::vector<std::pair<int, int> > intervals;
+  Index index;
+  for (int i = 0; i < 1000; ++i)
+    {
+    const int lower = rand() % 10000;
+    const int upper = lower + rand() % 500;
+    intervals.push_back(std::make_pair(lower, upper));
+    index.Insert(lower, upper, i);
+    }
+  index.Build();
+
+  // Compare against brute force search
+  for (int q = 0; q < 200; ++q)
+    {
+    const int lower = rand() % 11000;
+    const int upper = lower + rand() % 100;
+
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; ++i)
+      {
+      if (intervals[i].first <= upper && intervals[i].second >= lower)
+        {
+        expected.push_back(i);
+        }
+      }
+
+    TEST(query(index, lower, upper) == expected);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testTimeStamp(qtTest& testObject)
+{
+  vgIntervalIndex<vgTimeStamp, int> index;
+  index.Insert(vgTimeStamp(1.0, 1u), vgTimeStamp(5.0, 5u), 0);
+  index.Insert(vgTimeStamp(4.0, 4u), vgTimeStamp(9.0, 9u), 1);
+  index.Build();
+
+  std::vector<int> result;
+  index.ForEachContaining(vgTimeStamp(4.5, 4u),
+                          [&](int v){ result.push_back(v); });
+  TEST_EQUAL(result.size(), size_t(2));
+
+  result.clear();
+  index.ForEachContaining(vgTimeStamp(7.0, 7u),
+                          [&](int v){ result.push_back(v); });
+  TEST(result == std::vector<int>({1}));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Basic Tests", testBasic);
+  testObject.runSuite("Random Tests", testRandom);
+  testObject.runSuite("Time Stamp Tests", testTimeStamp);
+
+  return testObject.result();
+}
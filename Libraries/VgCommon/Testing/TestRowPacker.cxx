@@ -0,0 +1,201 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <qtTest.h>
+
+#include "../vgRowPacker.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+namespace // anonymous
+{
+
+struct Placement
+{
+  int Row;
+  double Lower;
+  double Upper;
+
+  bool operator<(const Placement& other) const
+    {
+    return (this->Row < other.Row ||
+            (this->Row == other.Row && this->Lower < other.Lower));
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Test that intervals in the same row are separated by more than the padding
+bool isValidLayout(std::vector<Placement> placements, double padding)
+{
+  std::sort(placements.begin(), placements.end());
+  for (size_t n = 1; n < placements.size(); ++n)
+    {
+    const Placement& prev = placements[n - 1];
+    const Placement& next = placements[n];
+    if (prev.Row == next.Row && !(prev.Upper + padding < next.Lower))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Classic greedy partitioning of intervals sorted by lower bound; each
+// interval goes in the first row whose last interval it does not overlap
+std::vector<int> greedyLayout(const std::vector<Placement>& intervals,
+                              double padding)
+{
+  std::vector<int> result;
+  std::vector<double> rowEnds;
+  for (size_t n = 0; n < intervals.size(); ++n)
+    {
+    size_t row = 0;
+    while (row < rowEnds.size() &&
+           !(rowEnds[row] + padding < intervals[n].Lower))
+      {
+      ++row;
+      }
+    if (row == rowEnds.size())
+      {
+      rowEnds.push_back(0.0);
+      }
+    rowEnds[row] = intervals[n].Upper;
+    result.push_back(static_cast<int>(row));
+    }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+std::vector<Placement> randomIntervals(int count, int jitter)
+{
+  std::vector<Placement> result;
+  for (int n = 0; n < count; ++n)
+    {
+    const double lower =
+      10.0 * n + (jitter ? static_cast<double>(rand() % jitter) : 0.0);
+    const Placement p = { -1, lower, lower + static_cast<double>(rand() % 60) };
+    result.push_back(p);
+    }
+  return result;
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+int testInOrder(qtTest& testObject)
+{
+  srand(1);
+  std::vector<Placement> intervals = randomIntervals(1000, 0);
+
+  vgRowPacker packer(2.0);
+  for (size_t n = 0; n < intervals.size(); ++n)
+    {
+    intervals[n].Row = packer.insert(intervals[n].Lower, intervals[n].Upper);
+    }
+
+  TEST(isValidLayout(intervals, 2.0));
+
+  const std::vector<int> expected = greedyLayout(intervals, 2.0);
+  int mismatches = 0;
+  for (size_t n = 0; n < intervals.size(); ++n)
+    {
+    mismatches += (intervals[n].Row != expected[n] ? 1 : 0);
+    }
+  TEST_EQUAL(mismatches, 0);
+
+  const vgRange<double> extents = packer.extents();
+  TEST_EQUAL(extents.lower, intervals.front().Lower);
+
+  packer.clear();
+  TEST_EQUAL(packer.rowCount(), 0);
+  TEST(packer.extents().lower > packer.extents().upper);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testOutOfOrder(qtTest& testObject)
+{
+  srand(2);
+  std::vector<Placement> intervals = randomIntervals(1000, 100);
+
+  vgRowPacker packer(2.0);
+  for (size_t n = 0; n < intervals.size(); ++n)
+    {
+    intervals[n].Row = packer.insert(intervals[n].Lower, intervals[n].Upper);
+    }
+
+  TEST(isValidLayout(intervals, 2.0));
+
+  // A late interval should be fitted into a gap in the first row
+  vgRowPacker gaps;
+  TEST_EQUAL(gaps.insert(0.0, 10.0), 0);
+  TEST_EQUAL(gaps.insert(5.0, 30.0), 1);
+  TEST_EQUAL(gaps.insert(50.0, 60.0), 0);
+  TEST_EQUAL(gaps.insert(20.0, 40.0), 0);
+  TEST_EQUAL(gaps.insert(35.0, 45.0), 1);
+  TEST_EQUAL(gaps.rowCount(), 2);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testUpdate(qtTest& testObject)
+{
+  srand(3);
+  std::vector<Placement> intervals = randomIntervals(500, 50);
+
+  vgRowPacker packer(1.0);
+  for (size_t n = 0; n < intervals.size(); ++n)
+    {
+    intervals[n].Row = packer.insert(intervals[n].Lower, intervals[n].Upper);
+    }
+
+  // Grow and shift intervals; layout must remain valid
+  for (size_t n = 0; n < intervals.size(); n += 3)
+    {
+    Placement& p = intervals[n];
+    const double lower = p.Lower - static_cast<double>(rand() % 20);
+    const double upper = p.Upper + static_cast<double>(rand() % 40);
+    p.Row = packer.update(p.Row, p.Lower, lower, upper);
+    p.Lower = lower;
+    p.Upper = upper;
+    }
+
+  TEST(isValidLayout(intervals, 1.0));
+
+  // An interval which still fits stays in its row
+  vgRowPacker simple;
+  TEST_EQUAL(simple.insert(0.0, 10.0), 0);
+  TEST_EQUAL(simple.insert(5.0, 15.0), 1);
+  TEST_EQUAL(simple.update(1, 5.0, 5.0, 8.0), 1);
+  TEST_EQUAL(simple.update(1, 5.0, 5.0, 25.0), 1);
+  TEST_EQUAL(simple.insert(20.0, 30.0), 0);
+  TEST_EQUAL(simple.update(0, 20.0, 12.0, 30.0), 0);
+  TEST_EQUAL(simple.update(0, 12.0, 8.0, 30.0), 2);
+
+  simple.remove(2, 8.0);
+  TEST_EQUAL(simple.insert(40.0, 50.0), 0);
+  TEST_EQUAL(simple.insert(40.0, 50.0), 1);
+  TEST_EQUAL(simple.insert(40.0, 50.0), 2);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("In Order Test", testInOrder);
+  testObject.runSuite("Out of Order Test", testOutOfOrder);
+  testObject.runSuite("Update Test", testUpdate);
+  return testObject.result();
+}
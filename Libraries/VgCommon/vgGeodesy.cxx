@@ -6,8 +6,10 @@
 
 #include <cmath>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H
 #include <proj_api.h>
@@ -21,13 +23,82 @@
 namespace // anonymous
 {
 
+//-----------------------------------------------------------------------------
+// Cache of initialized projections. Initializing a projection from an EPSG
+// code requires PROJ to parse its init files, which is far more expensive
+// than transforming a coordinate, so projections are created once and kept.
+// PROJ projection objects may not be used concurrently from more than one
+// thread, so each thread has its own cache, with its own PROJ context.
+class ProjectionCache
+{
+public:
+  ProjectionCache() : Context(pj_ctx_alloc()) {}
+  ~ProjectionCache();
+
+  // Get the projection for \p definition, creating it if needed. If
+  // \p cached is given, it is set to whether the projection (or the failure
+  // to create it) was already in the cache.
+  projPJ get(const std::string& definition, bool* cached = nullptr);
+
+protected:
+  projCtx Context;
+  std::map<std::string, projPJ> Projections;
+
+private:
+  ProjectionCache(const ProjectionCache&) = delete;
+  ProjectionCache& operator=(const ProjectionCache&) = delete;
+};
+
+//-----------------------------------------------------------------------------
+ProjectionCache::~ProjectionCache()
+{
+  for (auto iter = this->Projections.begin(),
+            end = this->Projections.end(); iter != end; ++iter)
+    {
+    if (iter->second)
+      {
+      pj_free(iter->second);
+      }
+    }
+
+  pj_ctx_free(this->Context);
+}
+
+//-----------------------------------------------------------------------------
+projPJ ProjectionCache::get(const std::string& definition, bool* cached)
+{
+  const auto iter = this->Projections.find(definition);
+  if (cached)
+    {
+    *cached = (iter != this->Projections.end());
+    }
+  if (iter != this->Projections.end())
+    {
+    return iter->second;
+    }
+
+  // Failures are also cached, so that creation is only attempted (and the
+  // failure reported by the caller) once
+  projPJ result = pj_init_plus_ctx(this->Context, definition.c_str());
+  this->Projections.insert(std::make_pair(definition, result));
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+ProjectionCache& projections()
+{
+  static thread_local ProjectionCache cache;
+  return cache;
+}
+
 //-----------------------------------------------------------------------------
 projPJ adaptEPSG(int gcs)
 {
   std::stringstream proj4Arg;
   proj4Arg << "+init=epsg:" << gcs;
-  projPJ result = pj_init_plus(proj4Arg.str().c_str());
-  if (!result)
+  bool cached;
+  projPJ result = projections().get(proj4Arg.str(), &cached);
+  if (!result && !cached)
     {
     std::cerr << "Failed to construct GCS conversion. This may indicate a "
               << "problem with your PROJ installation, and/or you may need to "
@@ -77,6 +148,65 @@ vgGeocodedCoordinate transformCoordinate(
   return out;
 }
 
+//-----------------------------------------------------------------------------
+// Transform an array of coordinates in place, with a single call into PROJ.
+// If the batch transformation fails, the coordinates are transformed one at a
+// time, and any that cannot be transformed are set to zero, as would be the
+// case if they had been converted individually.
+bool transformCoordinates(
+  vgGeoRawCoordinate* coords, size_t count,
+  const projPJ& fromProj, const projPJ& toProj)
+{
+  static_assert(sizeof(vgGeoRawCoordinate) == 2 * sizeof(double),
+                "vgGeoRawCoordinate must be a pair of doubles");
+
+  if (count == 0)
+    {
+    return true;
+    }
+
+  const bool fromLatLong = pj_is_latlong(fromProj);
+  const bool toLatLong = pj_is_latlong(toProj);
+  const double inScale = (fromLatLong ? DEG_TO_RAD : 1.0);
+  const double outScale = (toLatLong ? RAD_TO_DEG : 1.0);
+
+  const std::vector<vgGeoRawCoordinate> original(coords, coords + count);
+  for (size_t n = 0; n < count; ++n)
+    {
+    coords[n].Easting *= inScale;
+    coords[n].Northing *= inScale;
+    }
+
+  // The coordinates are stored as (northing, easting) pairs, so the x and y
+  // arrays are interleaved with a stride of two
+  const int err = pj_transform(fromProj, toProj, static_cast<long>(count), 2,
+                               &coords[0].Easting, &coords[0].Northing, 0);
+
+  if (err == 0)
+    {
+    for (size_t n = 0; n < count; ++n)
+      {
+      coords[n].Easting *= outScale;
+      coords[n].Northing *= outScale;
+      }
+    return true;
+    }
+
+  // Fall back to transforming individual coordinates, starting again from the
+  // original input, as PROJ may have modified some coordinates before failing
+  // (the GCS passed here only serves to identify successful transformations)
+  bool result = true;
+  for (size_t n = 0; n < count; ++n)
+    {
+    const vgGeocodedCoordinate in(original[n], 0);
+    const vgGeocodedCoordinate out =
+      transformCoordinate(in, fromProj, toProj, 0);
+    coords[n] = out;
+    result = result && (out.GCS == 0);
+    }
+  return result;
+}
+
 //-----------------------------------------------------------------------------
 projPJ createUTMProj(const vgGeocodedCoordinate& inCoord, int& outGcs)
 {
@@ -86,7 +216,7 @@ projPJ createUTMProj(const vgGeocodedCoordinate& inCoord, int& outGcs)
   if (inCoord.GCS < 0)
     {
     // Default
-    return pj_init_plus(baseInit);
+    return projections().get(baseInit);
     }
   else if (inProj && pj_is_latlong(inProj))
     {
@@ -119,7 +249,7 @@ projPJ createUTMProj(const vgGeocodedCoordinate& inCoord, int& outGcs)
       outGcs = vgGeodesy::UTM_Wgs84North + zone;
       }
 
-    return pj_init_plus(proj4Arg.str().c_str());
+    return projections().get(proj4Arg.str());
     }
   else
     {
@@ -205,10 +335,6 @@ vgGeocodedPoly vgGeodesy::generateRegion(
 
   createRegion(out, utmCoord, diameter);
 
-  // Release resources
-  pj_free(fromProj);
-  pj_free(toProj);
-
   return out;
 }
 
@@ -268,14 +394,30 @@ vgGeocodedCoordinate vgGeodesy::convertGcs(
     return vgGeocodedCoordinate();
     }
 
-  const vgGeocodedCoordinate out =
-    transformCoordinate(in, fromProj, toProj, desiredGcs);
+  return transformCoordinate(in, fromProj, toProj, desiredGcs);
+}
 
-  // Release resources
-  pj_free(fromProj);
-  pj_free(toProj);
+//-----------------------------------------------------------------------------
+bool vgGeodesy::convertGcs(
+  vgGeoRawCoordinate* coords, size_t count, int fromGcs, int desiredGcs)
+{
+  // Validate input
+  if (fromGcs < 0 || desiredGcs < 0)
+    return false;
 
-  return out;
+  // Check for no-op
+  if (fromGcs == desiredGcs)
+    return true;
+
+  projPJ fromProj = adaptEPSG(fromGcs);
+  projPJ toProj = adaptEPSG(desiredGcs);
+
+  if (!fromProj || !toProj)
+    {
+    return false;
+    }
+
+  return transformCoordinates(coords, count, fromProj, toProj);
 }
 
 //-----------------------------------------------------------------------------
@@ -283,24 +425,16 @@ vgGeocodedTile vgGeodesy::convertGcs(const vgGeocodedTile& in, int desiredGcs)
 {
   // Validate input
   if (in.GCS < 0)
-    return {};
+    return vgGeocodedTile();
 
   // Check for no-op
   if (in.GCS == desiredGcs)
     return in;
 
-  // Prepare for conversion
-  vgGeocodedCoordinate temp;
-  vgGeoRawCoordinate& raw = temp;
-  temp.GCS = in.GCS;
-  vgGeocodedTile out;
-
   // Convert points
-  for (int n = 0; n < in.Size; ++n)
-    {
-    raw = in.Coordinate[n];
-    out.Coordinate[n] = convertGcs(temp, desiredGcs);
-    }
+  vgGeocodedTile out = in;
+  if (!convertGcs(out.Coordinate, out.Size, in.GCS, desiredGcs))
+    return vgGeocodedTile();
 
   out.GCS = desiredGcs;
 
@@ -319,17 +453,13 @@ vgGeocodedPoly vgGeodesy::convertGcs(const vgGeocodedPoly& in, int desiredGcs)
   if (in.GCS == desiredGcs)
     return in;
 
-  // Prepare for conversion
-  vgGeocodedCoordinate temp;
-  vgGeoRawCoordinate& raw = temp;
-  temp.GCS = in.GCS;
-  vgGeocodedPoly out;
-
   // Convert points
-  for (size_t n = 0, k = in.Coordinate.size(); n < k; ++n)
+  vgGeocodedPoly out = in;
+  if (!out.Coordinate.empty() &&
+      !convertGcs(&out.Coordinate[0], out.Coordinate.size(),
+                  in.GCS, desiredGcs))
     {
-    raw = in.Coordinate[n];
-    out.Coordinate.push_back(convertGcs(temp, desiredGcs));
+    return vgGeocodedPoly();
     }
 
   out.GCS = desiredGcs;
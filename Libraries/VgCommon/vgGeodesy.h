@@ -7,8 +7,10 @@
 
 #include <vgExport.h>
 
+#include <cstddef>
 #include <string>
 
+struct vgGeoRawCoordinate;
 struct vgGeocodedCoordinate;
 struct vgGeocodedPoly;
 
@@ -43,6 +45,12 @@ namespace vgGeodesy
   VG_COMMON_EXPORT vgGeocodedPoly convertGcs(
     const vgGeocodedPoly&, int desiredGcs);
 
+  // Convert an array of coordinates, in place, from one GCS to another, in a
+  // single batch. Returns false if the conversion failed. This is much faster
+  // than converting the coordinates individually.
+  VG_COMMON_EXPORT bool convertGcs(
+    vgGeoRawCoordinate* coords, size_t count, int fromGcs, int desiredGcs);
+
   VG_COMMON_EXPORT std::string mgrs(
     const vgGeocodedCoordinate&, int precision = 5);
 }
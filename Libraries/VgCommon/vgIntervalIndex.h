@@ -0,0 +1,180 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgIntervalIndex_h
+#define __vgIntervalIndex_h
+
+#include <algorithm>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+/// Static index of closed intervals, supporting overlap queries.
+///
+/// Intervals are added with Insert(), after which Build() must be called
+/// before the index is queried. The index is stored as a sorted array which is
+/// treated as an implicit balanced tree, with each node recording the largest
+/// upper bound of its subtree, so that a query visits O(log n + k) entries,
+/// where k is the number of intervals reported.
+///
+/// \p Key must provide operator<.
+template <typename Key, typename Value>
+class vgIntervalIndex
+{
+public:
+  vgIntervalIndex() : Built(true) {}
+
+  void Clear();
+  void Reserve(size_t size) { this->Entries.reserve(size); }
+
+  /// Add the interval [\p lower, \p upper] with associated \p value.
+  void Insert(const Key& lower, const Key& upper, const Value& value);
+
+  /// Build the index. This must be called after inserting intervals and
+  /// before the index is queried.
+  void Build();
+
+  bool IsEmpty() const { return this->Entries.empty(); }
+  size_t GetSize() const { return this->Entries.size(); }
+
+  /// Call \p f with the value of each interval which contains \p key.
+  template <typename Functor>
+  void ForEachContaining(const Key& key, Functor f) const
+    { this->ForEachOverlapping(key, key, f); }
+
+  /// Call \p f with the value of each interval which overlaps the interval
+  /// [\p lower, \p upper]. Values are visited in order of their lower bounds.
+  template <typename Functor>
+  void ForEachOverlapping(const Key& lower, const Key& upper,
+                          Functor f) const;
+
+protected:
+  struct Entry
+    {
+    Key Lower;
+    Key Upper;
+    Value Item;
+
+    bool operator<(const Entry& other) const
+      { return this->Lower < other.Lower; }
+    };
+
+  const Key& BuildRange(size_t first, size_t last);
+
+  template <typename Functor>
+  void QueryRange(size_t first, size_t last, const Key& lower,
+                  const Key& upper, Functor& f) const;
+
+  std::vector<Entry> Entries;
+  std::vector<Key> MaxUpper;
+  bool Built;
+};
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+void vgIntervalIndex<Key, Value>::Clear()
+{
+  this->Entries.clear();
+  this->MaxUpper.clear();
+  this->Built = true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+void vgIntervalIndex<Key, Value>::Insert(
+  const Key& lower, const Key& upper, const Value& value)
+{
+  const Entry entry = { lower, upper, value };
+  this->Entries.push_back(entry);
+  this->Built = false;
+}
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+void vgIntervalIndex<Key, Value>::Build()
+{
+  std::stable_sort(this->Entries.begin(), this->Entries.end());
+
+  this->MaxUpper.resize(this->Entries.size());
+  if (!this->Entries.empty())
+    {
+    this->BuildRange(0, this->Entries.size());
+    }
+
+  this->Built = true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+const Key& vgIntervalIndex<Key, Value>::BuildRange(size_t first, size_t last)
+{
+  // The node for the range [first, last) is its middle element; its left and
+  // right subtrees are the ranges before and after it
+  const size_t mid = first + (last - first) / 2;
+
+  const Key* maxUpper = &this->Entries[mid].Upper;
+  if (first < mid)
+    {
+    const Key& leftMax = this->BuildRange(first, mid);
+    maxUpper = (*maxUpper < leftMax ? &leftMax : maxUpper);
+    }
+  if (mid + 1 < last)
+    {
+    const Key& rightMax = this->BuildRange(mid + 1, last);
+    maxUpper = (*maxUpper < rightMax ? &rightMax : maxUpper);
+    }
+
+  this->MaxUpper[mid] = *maxUpper;
+  return this->MaxUpper[mid];
+}
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+template <typename Functor>
+void vgIntervalIndex<Key, Value>::ForEachOverlapping(
+  const Key& lower, const Key& upper, Functor f) const
+{
+  if (!this->Built || this->Entries.empty())
+    {
+    return;
+    }
+
+  this->QueryRange(0, this->Entries.size(), lower, upper, f);
+}
+
+//-----------------------------------------------------------------------------
+template <typename Key, typename Value>
+template <typename Functor>
+void vgIntervalIndex<Key, Value>::QueryRange(
+  size_t first, size_t last, const Key& lower, const Key& upper,
+  Functor& f) const
+{
+  while (first < last)
+    {
+    const size_t mid = first + (last - first) / 2;
+
+    // Nothing in this subtree ends at or after the start of the query
+    if (this->MaxUpper[mid] < lower)
+      {
+      return;
+      }
+
+    this->QueryRange(first, mid, lower, upper, f);
+
+    // This node, and everything to its right, starts after the query ends
+    const Entry& entry = this->Entries[mid];
+    if (upper < entry.Lower)
+      {
+      return;
+      }
+
+    if (!(entry.Upper < lower))
+      {
+      f(entry.Item);
+      }
+
+    first = mid + 1;
+    }
+}
+
+#endif
@@ -0,0 +1,195 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vgRowPacker.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace // anonymous
+{
+
+const double Infinity = std::numeric_limits<double>::infinity();
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+vgRowPacker::vgRowPacker(double padding) : Padding(padding)
+{
+  this->clear();
+}
+
+//-----------------------------------------------------------------------------
+void vgRowPacker::clear()
+{
+  this->Rows.clear();
+  this->RowLastLower.clear();
+  this->MaxLastLower = -Infinity;
+
+  // Unused leaves are +inf, so that they are never selected
+  this->Leaves = 1;
+  this->RowEndTree.assign(2, Infinity);
+}
+
+//-----------------------------------------------------------------------------
+int vgRowPacker::insert(double lower, double upper)
+{
+  // Find the first row in which the interval fits after the last interval;
+  // this is the only possibility for an interval that is added in order
+  int candidate = this->firstRowEndingBefore(lower - this->Padding);
+
+  // If the interval is out of order, it may fit in a gap in an earlier row
+  if (lower < this->MaxLastLower)
+    {
+    for (int row = 0; row < candidate; ++row)
+      {
+      if (lower < this->RowLastLower[row] && this->fits(row, lower, upper))
+        {
+        candidate = row;
+        break;
+        }
+      }
+    }
+
+  // Add a new row if necessary
+  if (candidate >= this->rowCount())
+    {
+    candidate = this->rowCount();
+    this->Rows.push_back(Row());
+    this->RowLastLower.push_back(-Infinity);
+
+    if (this->Rows.size() > this->Leaves)
+      {
+      // Grow the tree, and rebuild it
+      this->Leaves *= 2;
+      this->RowEndTree.assign(2 * this->Leaves, Infinity);
+      for (int row = 0; row < candidate; ++row)
+        {
+        this->updateRowEnd(row);
+        }
+      }
+    }
+
+  this->place(candidate, lower, upper);
+  return candidate;
+}
+
+//-----------------------------------------------------------------------------
+void vgRowPacker::remove(int row, double lower)
+{
+  if (row < 0 || row >= this->rowCount())
+    {
+    return;
+    }
+
+  this->Rows[row].erase(lower);
+
+  // Note that MaxLastLower is not reduced; it is only used to skip searching
+  // for gaps, so it is sufficient that it is an upper bound
+  const Row& r = this->Rows[row];
+  this->RowLastLower[row] = (r.empty() ? -Infinity : r.rbegin()->first);
+  this->updateRowEnd(row);
+}
+
+//-----------------------------------------------------------------------------
+int vgRowPacker::update(int row, double oldLower, double lower, double upper)
+{
+  this->remove(row, oldLower);
+
+  if (row >= 0 && row < this->rowCount() && this->fits(row, lower, upper))
+    {
+    this->place(row, lower, upper);
+    return row;
+    }
+
+  return this->insert(lower, upper);
+}
+
+//-----------------------------------------------------------------------------
+vgRange<double> vgRowPacker::extents() const
+{
+  vgRange<double> result(Infinity, -Infinity);
+  for (size_t n = 0, k = this->Rows.size(); n < k; ++n)
+    {
+    const Row& row = this->Rows[n];
+    if (!row.empty())
+      {
+      result.lower = std::min(result.lower, row.begin()->first);
+      result.upper = std::max(result.upper, row.rbegin()->second);
+      }
+    }
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+bool vgRowPacker::fits(int row, double lower, double upper) const
+{
+  const Row& r = this->Rows[row];
+  const Row::const_iterator next = r.lower_bound(lower);
+
+  // Test against the next interval (the first which starts at or after the
+  // new interval)
+  if (next != r.end() && !(upper + this->Padding < next->first))
+    {
+    return false;
+    }
+
+  // Test against the previous interval
+  if (next != r.begin())
+    {
+    const Row::const_iterator prev = std::prev(next);
+    if (!(prev->second + this->Padding < lower))
+      {
+      return false;
+      }
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vgRowPacker::place(int row, double lower, double upper)
+{
+  this->Rows[row].insert(std::make_pair(lower, upper));
+
+  if (lower > this->RowLastLower[row])
+    {
+    this->RowLastLower[row] = lower;
+    this->MaxLastLower = std::max(this->MaxLastLower, lower);
+    this->updateRowEnd(row);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vgRowPacker::updateRowEnd(int row)
+{
+  // Empty rows are -inf, so that they accept any interval
+  const Row& r = this->Rows[row];
+  size_t i = this->Leaves + static_cast<size_t>(row);
+  this->RowEndTree[i] = (r.empty() ? -Infinity : r.rbegin()->second);
+
+  for (i /= 2; i > 0; i /= 2)
+    {
+    this->RowEndTree[i] =
+      std::min(this->RowEndTree[2 * i], this->RowEndTree[2 * i + 1]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vgRowPacker::firstRowEndingBefore(double limit) const
+{
+  if (!(this->RowEndTree[1] < limit))
+    {
+    return this->rowCount();
+    }
+
+  // Descend to the leftmost leaf whose value is less than the limit
+  size_t i = 1;
+  while (i < this->Leaves)
+    {
+    i = (this->RowEndTree[2 * i] < limit ? 2 * i : 2 * i + 1);
+    }
+  return static_cast<int>(i - this->Leaves);
+}
@@ -0,0 +1,103 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vgRowPacker_h
+#define __vgRowPacker_h
+
+#include <vgExport.h>
+
+#include "vgRange.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Disable warning about the STL members of vgRowPacker not being exported.
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4251)
+#endif
+
+//-----------------------------------------------------------------------------
+/// Packing of intervals into rows, for timeline-style layouts.
+///
+/// Each interval is placed in the lowest numbered row in which it does not
+/// come within the padding distance of another interval in the same row.
+/// Intervals may be added in any order; when intervals are added in order of
+/// their lower bounds, the resulting layout is the same as that of the
+/// classic greedy interval partitioning algorithm, and each interval is
+/// placed in logarithmic time. An interval which arrives out of order is
+/// fitted into a gap in an existing row if possible, rather than requiring the
+/// layout to be recomputed.
+///
+/// Intervals are identified by their row and lower bound.
+class VG_COMMON_EXPORT vgRowPacker
+{
+public:
+  explicit vgRowPacker(double padding = 0.0);
+
+  /// Remove all intervals and rows.
+  void clear();
+
+  /// Set the minimum distance between intervals in the same row. This only
+  /// affects intervals that are added after the padding is changed.
+  void setPadding(double padding) { this->Padding = padding; }
+  double padding() const { return this->Padding; }
+
+  /// Add the interval [\p lower, \p upper].
+  ///
+  /// \return Row in which the interval was placed.
+  int insert(double lower, double upper);
+
+  /// Remove the interval with lower bound \p lower from \p row.
+  void remove(int row, double lower);
+
+  /// Change the interval with lower bound \p oldLower in \p row to
+  /// [\p lower, \p upper].
+  ///
+  /// If the changed interval still fits in its current row, it stays there;
+  /// otherwise, it is placed as if it was newly added.
+  ///
+  /// \return Row in which the interval is now placed.
+  int update(int row, double oldLower, double lower, double upper);
+
+  /// Get the number of rows. Rows which have become empty due to intervals
+  /// being removed are included.
+  int rowCount() const { return static_cast<int>(this->Rows.size()); }
+
+  /// Get the lowest lower bound and highest upper bound of all intervals.
+  /// Returns an empty range (lower > upper) if there are no intervals.
+  vgRange<double> extents() const;
+
+protected:
+  typedef std::map<double, double> Row; // lower bound -> upper bound
+
+  bool fits(int row, double lower, double upper) const;
+  void place(int row, double lower, double upper);
+  void updateRowEnd(int row);
+
+  int firstRowEndingBefore(double limit) const;
+
+  double Padding;
+
+  std::vector<Row> Rows;
+
+  // Largest lower bound of any interval in each row; an interval can only fit
+  // in a gap of a row if its lower bound is less than this
+  std::vector<double> RowLastLower;
+  double MaxLastLower;
+
+  // Implicit binary tree (heap layout) over the rows, storing the minimum of
+  // the upper bounds of the last intervals of the rows in each subtree, so
+  // that the first row whose last interval ends before a given time can be
+  // found in O(log r)
+  std::vector<double> RowEndTree;
+  size_t Leaves;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif
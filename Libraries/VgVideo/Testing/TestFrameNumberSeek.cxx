@@ -0,0 +1,203 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "../vgVideoBuffer.h"
+
+#include <qtTest.h>
+
+#include <QScopedPointer>
+
+const int NONE = -1;
+const unsigned int INVALID = vgTimeStamp::InvalidFrameNumber();
+
+//-----------------------------------------------------------------------------
+vgVideoBuffer* createVideo(const QList<vgTimeStamp>& times, bool index)
+{
+  // The seek tests only look at time stamps, so every frame can use the same
+  // tiny image
+  unsigned char pixel = 0;
+  const vgImage image(&pixel, 1, 1, 1, 1, 1, 1);
+
+  vgVideoBuffer* const video = new vgVideoBuffer;
+  foreach (const vgTimeStamp& ts, times)
+    {
+    video->insert(ts, image);
+    }
+  if (index)
+    {
+    video->buildFrameNumberIndex();
+    }
+  return video;
+}
+
+//-----------------------------------------------------------------------------
+vgVideoBuffer* createGappedVideo(bool index)
+{
+  // Frame numbers 10, 11, 13, 16 and 17; missing frame numbers leave gaps in
+  // both frame numbers and times
+  QList<vgTimeStamp> times;
+  times << vgTimeStamp(10e6, 10) << vgTimeStamp(11e6, 11)
+        << vgTimeStamp(13e6, 13) << vgTimeStamp(16e6, 16)
+        << vgTimeStamp(17e6, 17);
+  return createVideo(times, index);
+}
+
+//-----------------------------------------------------------------------------
+int seekFrameNumber(const vgVideo& video, unsigned int frameNumber,
+                    vg::SeekMode direction)
+{
+  const vgTimeStamp ts =
+    video.frameAtFrameNumber(frameNumber, direction).time();
+  return (ts.IsValid() ? static_cast<int>(ts.FrameNumber) : NONE);
+}
+
+//-----------------------------------------------------------------------------
+void testSeek(qtTest& testObject, const vgVideo& video,
+              unsigned int frameNumber, vg::SeekMode direction, int expected)
+{
+  TEST_EQUAL(seekFrameNumber(video, frameNumber, direction), expected);
+}
+
+//-----------------------------------------------------------------------------
+int testGaps(qtTest& testObject, bool index)
+{
+  const QScopedPointer<vgVideoBuffer> video(createGappedVideo(index));
+  const vgVideo& v = *video;
+
+  // Frame numbers present in the video
+  TEST_CALL(testSeek, v, 11, vg::SeekExact, 11);
+  TEST_CALL(testSeek, v, 13, vg::SeekLowerBound, 13);
+  TEST_CALL(testSeek, v, 13, vg::SeekUpperBound, 13);
+  TEST_CALL(testSeek, v, 13, vg::SeekNext, 16);
+  TEST_CALL(testSeek, v, 13, vg::SeekPrevious, 11);
+  TEST_CALL(testSeek, v, 16, vg::SeekNearest, 16);
+
+  // Frame numbers in the gaps between frames
+  TEST_CALL(testSeek, v, 12, vg::SeekExact, NONE);
+  TEST_CALL(testSeek, v, 12, vg::SeekLowerBound, 13);
+  TEST_CALL(testSeek, v, 12, vg::SeekUpperBound, 11);
+  TEST_CALL(testSeek, v, 14, vg::SeekNext, 16);
+  TEST_CALL(testSeek, v, 15, vg::SeekPrevious, 13);
+  TEST_CALL(testSeek, v, 14, vg::SeekNearest, 13);
+  TEST_CALL(testSeek, v, 15, vg::SeekNearest, 16);
+
+  // Equally distant frames; the earlier one wins
+  TEST_CALL(testSeek, v, 12, vg::SeekNearest, 11);
+
+  // Before the first frame
+  TEST_CALL(testSeek, v, 5, vg::SeekExact, NONE);
+  TEST_CALL(testSeek, v, 5, vg::SeekLowerBound, 10);
+  TEST_CALL(testSeek, v, 5, vg::SeekUpperBound, NONE);
+  TEST_CALL(testSeek, v, 5, vg::SeekNext, 10);
+  TEST_CALL(testSeek, v, 5, vg::SeekPrevious, NONE);
+  TEST_CALL(testSeek, v, 5, vg::SeekNearest, 10);
+  TEST_CALL(testSeek, v, 10, vg::SeekPrevious, NONE);
+
+  // After the last frame
+  TEST_CALL(testSeek, v, 20, vg::SeekExact, NONE);
+  TEST_CALL(testSeek, v, 20, vg::SeekLowerBound, NONE);
+  TEST_CALL(testSeek, v, 20, vg::SeekUpperBound, 17);
+  TEST_CALL(testSeek, v, 20, vg::SeekNext, NONE);
+  TEST_CALL(testSeek, v, 20, vg::SeekPrevious, 17);
+  TEST_CALL(testSeek, v, 20, vg::SeekNearest, 17);
+  TEST_CALL(testSeek, v, 17, vg::SeekNext, NONE);
+
+  // The invalid frame number never matches
+  TEST_CALL(testSeek, v, INVALID, vg::SeekUpperBound, NONE);
+  TEST_CALL(testSeek, v, INVALID, vg::SeekNearest, NONE);
+
+  // Frame ranges are shrunk to the frames they contain
+  TEST_EQUAL(v.timeRange(12, 15),
+             vgRange<vgTimeStamp>(vgTimeStamp(13e6, 13),
+                                  vgTimeStamp(13e6, 13)));
+  TEST_EQUAL(v.timeRange(0, 100),
+             vgRange<vgTimeStamp>(vgTimeStamp(10e6, 10),
+                                  vgTimeStamp(17e6, 17)));
+  TEST_EQUAL(v.timeRange(14, 15), vgRange<vgTimeStamp>());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testIndexedGaps(qtTest& testObject)
+{
+  return testGaps(testObject, true);
+}
+
+//-----------------------------------------------------------------------------
+int testUnindexedGaps(qtTest& testObject)
+{
+  return testGaps(testObject, false);
+}
+
+//-----------------------------------------------------------------------------
+int testDuplicates(qtTest& testObject)
+{
+  // A frame number repeated at a later time makes the video unindexable;
+  // seeks must still find frames by searching the time map
+  QList<vgTimeStamp> times;
+  times << vgTimeStamp(10e6, 10) << vgTimeStamp(11e6, 11)
+        << vgTimeStamp(12e6, 11) << vgTimeStamp(13e6, 12);
+  const QScopedPointer<vgVideoBuffer> video(createVideo(times, true));
+  const vgVideo& v = *video;
+
+  TEST_CALL(testSeek, v, 11, vg::SeekExact, 11);
+  TEST_CALL(testSeek, v, 11, vg::SeekLowerBound, 11);
+  TEST_CALL(testSeek, v, 11, vg::SeekUpperBound, 11);
+  TEST_CALL(testSeek, v, 11, vg::SeekNext, 12);
+  TEST_CALL(testSeek, v, 11, vg::SeekPrevious, 10);
+  TEST_CALL(testSeek, v, 13, vg::SeekNearest, 12);
+
+  // A frame at a time which is already present is rejected, even with a new
+  // frame number, so that frame number is never found
+  unsigned char pixel = 0;
+  TEST_QUIET_XFAIL(video->insert(vgTimeStamp(13e6, 14),
+                                 vgImage(&pixel, 1, 1, 1, 1, 1, 1)));
+  video->buildFrameNumberIndex();
+  TEST_EQUAL(v.frameCount(), 4);
+  TEST_CALL(testSeek, v, 14, vg::SeekExact, NONE);
+  TEST_CALL(testSeek, v, 14, vg::SeekUpperBound, 12);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testReindex(qtTest& testObject)
+{
+  // Inserting a frame drops the index; seeks must see the new frame both
+  // before and after the index is rebuilt
+  const QScopedPointer<vgVideoBuffer> video(createGappedVideo(true));
+  const vgVideo& v = *video;
+
+  TEST_CALL(testSeek, v, 12, vg::SeekExact, NONE);
+
+  unsigned char pixel = 0;
+  TEST(video->insert(vgTimeStamp(12e6, 12),
+                     vgImage(&pixel, 1, 1, 1, 1, 1, 1)));
+  TEST_CALL(testSeek, v, 12, vg::SeekExact, 12);
+  TEST_CALL(testSeek, v, 13, vg::SeekPrevious, 12);
+
+  video->buildFrameNumberIndex();
+  TEST_CALL(testSeek, v, 12, vg::SeekExact, 12);
+  TEST_CALL(testSeek, v, 13, vg::SeekPrevious, 12);
+  TEST_CALL(testSeek, v, 12, vg::SeekNearest, 12);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char** argv)
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Indexed Gap Seek Tests", testIndexedGaps);
+  testObject.runSuite("Unindexed Gap Seek Tests", testUnindexedGaps);
+  testObject.runSuite("Duplicate Frame Number Tests", testDuplicates);
+  testObject.runSuite("Reindex Tests", testReindex);
+
+  return testObject.result();
+}
@@ -102,6 +102,9 @@ void usage(const QString& argv0)
   qWarning() << "    --show-frames  Display the frame image data in a window";
   qWarning() << "    --test-performance[=<compression format>]";
   qWarning() << "                   Run some performance tests";
+  qWarning() << "    --test-seek-performance";
+  qWarning() << "                   Compare seeking by frame number with";
+  qWarning() << "                   seeking by time";
 }
 
 //-----------------------------------------------------------------------------
@@ -263,6 +266,51 @@ int main(int argc, char** argv)
           }
         }
       }
+    else if (arg == "--test-seek-performance")
+      {
+      // Collect the frame numbers and times of all frames
+      QList<vgTimeStamp> times;
+      clip.rewind();
+      while (clip.currentTimeStamp().IsValid())
+        {
+        times.append(clip.currentTimeStamp());
+        clip.advance();
+        }
+
+      const int count = times.count();
+      int mismatches = 0;
+      for (int n = 0; n < 2; ++n)
+        {
+        if (1) // Scope for PerformanceTimer
+          {
+          PerformanceTimer timer(
+            QString("Seek by time (iteration %1)").arg(n + 1), count);
+          foreach (const vgTimeStamp& ts, times)
+            {
+            clip.frameAt(ts, vg::SeekExact);
+            }
+          }
+
+        if (1) // Scope for PerformanceTimer
+          {
+          PerformanceTimer timer(
+            QString("Seek by frame number (iteration %1)").arg(n + 1), count);
+          foreach (const vgTimeStamp& ts, times)
+            {
+            const vgVideoFramePtr frame =
+              clip.frameAtFrameNumber(ts.FrameNumber, vg::SeekExact);
+            mismatches += (frame.time() == ts ? 0 : 1);
+            }
+          }
+        }
+
+      if (mismatches)
+        {
+        qWarning() << "Error:" << mismatches
+                   << "frame number seeks did not find the expected frame";
+        return 1;
+        }
+      }
     }
 
   return 0;
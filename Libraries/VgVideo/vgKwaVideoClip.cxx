@@ -469,6 +469,8 @@ vgKwaVideoClip::vgKwaVideoClip(const QUrl& uri) :
                              dataVersion);
     d->frames.insert(iter.key(), vgVideoFramePtr(frame));
     }
+
+  d->buildFrameNumberIndex();
 }
 
 //-----------------------------------------------------------------------------
@@ -510,6 +512,8 @@ vgKwaVideoClip::vgKwaVideoClip(const vgKwaVideoClip& other,
       d->frames.insert(fIter.key(), fIter.value());
       }
     }
+
+  d->buildFrameNumberIndex();
 }
 
 //-----------------------------------------------------------------------------
@@ -5,10 +5,21 @@
 #include "vgVideo.h"
 #include "vgVideoPrivate.h"
 
+#include <limits>
+
 QTE_IMPLEMENT_D_FUNC(vgVideo)
 
+namespace
+{
+
+// Maximum ratio of indexed frame number span to frame count; videos with
+// sparser frame numbers than this are not indexed
+const qint64 MaxIndexSparseness = 16;
+
+} // namespace <anonymous>
+
 //-----------------------------------------------------------------------------
-vgVideoPrivate::vgVideoPrivate()
+vgVideoPrivate::vgVideoPrivate() : firstFrameNumber(0)
 {
 }
 
@@ -17,6 +28,140 @@ vgVideoPrivate::~vgVideoPrivate()
 {
 }
 
+//-----------------------------------------------------------------------------
+void vgVideoPrivate::buildFrameNumberIndex()
+{
+  this->clearFrameNumberIndex();
+  if (this->frames.isEmpty())
+    {
+    return;
+    }
+
+  // The index is only usable if every frame has a frame number, and frame
+  // numbers strictly increase with time
+  const FrameIterator end = this->frames.constEnd();
+  const FrameIterator first = this->frames.constBegin();
+  FrameIterator iter = first;
+  if (!first.key().HasFrameNumber())
+    {
+    return;
+    }
+  for (unsigned int lastFrameNumber = first.key().FrameNumber;
+       ++iter != end; lastFrameNumber = iter.key().FrameNumber)
+    {
+    if (!iter.key().HasFrameNumber() ||
+        iter.key().FrameNumber <= lastFrameNumber)
+      {
+      return;
+      }
+    }
+
+  // Don't build a huge index for a video with very sparse frame numbers
+  const qint64 span = static_cast<qint64>((end - 1).key().FrameNumber) -
+                      static_cast<qint64>(first.key().FrameNumber) + 1;
+  if (span > MaxIndexSparseness * this->frames.count())
+    {
+    return;
+    }
+
+  // Fill the index; each frame is the lower bound for its own frame number
+  // and any missing frame numbers immediately preceding it
+  this->indexedFrames = this->frames;
+  this->firstFrameNumber = first.key().FrameNumber;
+  this->frameNumberIndex.reserve(static_cast<int>(span));
+
+  const FrameIterator indexedEnd = this->indexedFrames.constEnd();
+  for (iter = this->indexedFrames.constBegin(); iter != indexedEnd; ++iter)
+    {
+    const int n =
+      static_cast<int>(iter.key().FrameNumber - this->firstFrameNumber);
+    while (this->frameNumberIndex.count() <= n)
+      {
+      this->frameNumberIndex.append(iter);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vgVideoPrivate::clearFrameNumberIndex()
+{
+  this->frameNumberIndex.clear();
+  this->indexedFrames.clear();
+  this->firstFrameNumber = 0;
+}
+
+//-----------------------------------------------------------------------------
+vgVideoPrivate::FrameIterator vgVideoPrivate::frameNumberLowerBound(
+  unsigned int frameNumber) const
+{
+  if (frameNumber < this->firstFrameNumber)
+    {
+    return this->indexedFrames.constBegin();
+    }
+
+  const unsigned int n = frameNumber - this->firstFrameNumber;
+  if (n >= static_cast<unsigned int>(this->frameNumberIndex.count()))
+    {
+    return this->indexedFrames.constEnd();
+    }
+
+  return this->frameNumberIndex[static_cast<int>(n)];
+}
+
+//-----------------------------------------------------------------------------
+vgVideoPrivate::FrameIterator vgVideoPrivate::findFrameNumber(
+  unsigned int frameNumber, vg::SeekMode direction) const
+{
+  const FrameIterator begin = this->indexedFrames.constBegin();
+  const FrameIterator end = this->indexedFrames.constEnd();
+  const bool isLastPossible =
+    (frameNumber == std::numeric_limits<unsigned int>::max());
+
+  FrameIterator iter;
+  switch (direction)
+    {
+    case vg::SeekExact:
+      iter = this->frameNumberLowerBound(frameNumber);
+      return (iter != end && iter.key().FrameNumber == frameNumber)
+             ? iter : end;
+
+    case vg::SeekLowerBound:
+      return this->frameNumberLowerBound(frameNumber);
+
+    case vg::SeekNext:
+      return (isLastPossible ? end
+                             : this->frameNumberLowerBound(frameNumber + 1));
+
+    case vg::SeekUpperBound:
+      iter = (isLastPossible ? end
+                             : this->frameNumberLowerBound(frameNumber + 1));
+      return (iter == begin ? end : --iter);
+
+    case vg::SeekPrevious:
+      iter = this->frameNumberLowerBound(frameNumber);
+      return (iter == begin ? end : --iter);
+
+    default: // Nearest
+      iter = this->frameNumberLowerBound(frameNumber);
+      if (iter == end)
+        {
+        return --iter;
+        }
+      else if (iter == begin || iter.key().FrameNumber == frameNumber)
+        {
+        return iter;
+        }
+      else
+        {
+        // Prefer the previous frame when both are equally distant, as
+        // vgTimeMap does
+        const FrameIterator prev = iter - 1;
+        return ((iter.key().FrameNumber - frameNumber) <
+                (frameNumber - prev.key().FrameNumber)) ? iter : prev;
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 vgVideo::vgVideo(vgVideoPrivate* d) : d_ptr(d)
 {
@@ -33,7 +178,7 @@ vgVideo::~vgVideo()
 vgVideoFramePtr vgVideo::currentFrame() const
 {
   QTE_D_CONST(vgVideo);
-  if (d->pos == d->frames.end())
+  if (d->pos == d->frames.constEnd())
     {
     return vgVideoFramePtr();
     }
@@ -44,7 +189,7 @@ vgVideoFramePtr vgVideo::currentFrame() const
 vgTimeStamp vgVideo::currentTimeStamp() const
 {
   QTE_D_CONST(vgVideo);
-  if (d->pos == d->frames.end())
+  if (d->pos == d->frames.constEnd())
     {
     return vgTimeStamp();
     }
@@ -55,7 +200,7 @@ vgTimeStamp vgVideo::currentTimeStamp() const
 vgImage vgVideo::currentImage() const
 {
   QTE_D_CONST(vgVideo);
-  if (d->pos == d->frames.end())
+  if (d->pos == d->frames.constEnd())
     {
     return vgImage();
     }
@@ -66,13 +211,13 @@ vgImage vgVideo::currentImage() const
 vgTimeStamp vgVideo::advance()
 {
   QTE_D(vgVideo);
-  if (d->pos == d->frames.end())
+  if (d->pos == d->frames.constEnd())
     {
     return vgTimeStamp();
     }
 
   ++d->pos;
-  if (d->pos == d->frames.end())
+  if (d->pos == d->frames.constEnd())
     {
     return vgTimeStamp();
     }
@@ -84,7 +229,7 @@ vgTimeStamp vgVideo::advance()
 vgTimeStamp vgVideo::recede()
 {
   QTE_D(vgVideo);
-  if (d->pos == d->frames.begin())
+  if (d->pos == d->frames.constBegin())
     {
     return vgTimeStamp();
     }
@@ -97,7 +242,7 @@ vgTimeStamp vgVideo::recede()
 void vgVideo::rewind()
 {
   QTE_D(vgVideo);
-  d->pos = d->frames.begin();
+  d->pos = d->frames.constBegin();
 }
 
 //-----------------------------------------------------------------------------
@@ -114,7 +259,7 @@ vgVideoFramePtr vgVideo::frameAt(
 {
   QTE_D_CONST(vgVideo);
   FrameMap::const_iterator iter = this->iterAt(pos, direction);
-  if (iter == d->frames.end())
+  if (iter == d->frames.constEnd())
     {
     return vgVideoFramePtr();
     }
@@ -126,7 +271,7 @@ vgImage vgVideo::imageAt(vgTimeStamp pos, vg::SeekMode direction) const
 {
   QTE_D_CONST(vgVideo);
   FrameMap::const_iterator iter = this->iterAt(pos, direction);
-  if (iter == d->frames.end())
+  if (iter == d->frames.constEnd())
     {
     return vgImage();
     }
@@ -148,8 +293,8 @@ vgRange<vgTimeStamp> vgVideo::timeRange() const
     {
     return vgRange<vgTimeStamp>();
     }
-  return vgRange<vgTimeStamp>(d->frames.begin().key(),
-                              (--d->frames.end()).key());
+  return vgRange<vgTimeStamp>(d->frames.constBegin().key(),
+                              (d->frames.constEnd() - 1).key());
 }
 
 //-----------------------------------------------------------------------------
@@ -160,7 +305,7 @@ vgTimeStamp vgVideo::firstTime() const
     {
     return vgTimeStamp();
     }
-  return d->frames.begin().key();
+  return d->frames.constBegin().key();
 }
 
 //-----------------------------------------------------------------------------
@@ -171,7 +316,7 @@ vgTimeStamp vgVideo::lastTime() const
     {
     return vgTimeStamp();
     }
-  return (--d->frames.end()).key();
+  return (d->frames.constEnd() - 1).key();
 }
 
 //-----------------------------------------------------------------------------
@@ -181,6 +326,62 @@ int vgVideo::frameCount() const
   return d->frames.count();
 }
 
+//-----------------------------------------------------------------------------
+vgVideoFramePtr vgVideo::frameAtFrameNumber(
+  unsigned int frameNumber, vg::SeekMode direction) const
+{
+  QTE_D_CONST(vgVideo);
+
+  // The invalid frame number never matches, as in the time map
+  if (frameNumber == vgTimeStamp::InvalidFrameNumber())
+    {
+    return vgVideoFramePtr();
+    }
+
+  if (!d->frameNumberIndex.isEmpty())
+    {
+    FrameMap::const_iterator iter = d->findFrameNumber(frameNumber, direction);
+    if (iter == d->indexedFrames.constEnd())
+      {
+      return vgVideoFramePtr();
+      }
+    return iter.value();
+    }
+
+  // No index; fall back to searching the time map with a time-less time
+  // stamp, which the map is entitled to not match exactly even if a frame
+  // with the requested frame number exists, so handle Exact by finding the
+  // nearest frame and accepting it if it has the correct frame number
+  const vgTimeStamp ts(frameNumber);
+  if (direction == vg::SeekExact)
+    {
+    const vgVideoFramePtr frame = this->frameAt(ts);
+    const vgTimeStamp fts = frame.time();
+    if (fts.HasFrameNumber() && fts.FrameNumber == frameNumber)
+      {
+      return frame;
+      }
+    return vgVideoFramePtr();
+    }
+
+  return this->frameAt(ts, direction);
+}
+
+//-----------------------------------------------------------------------------
+vgRange<vgTimeStamp> vgVideo::timeRange(
+  unsigned int firstFrame, unsigned int lastFrame) const
+{
+  const vgTimeStamp first =
+    this->frameAtFrameNumber(firstFrame, vg::SeekLowerBound).time();
+  const vgTimeStamp last =
+    this->frameAtFrameNumber(lastFrame, vg::SeekUpperBound).time();
+  if (!first.IsValid() || !last.IsValid() || last < first)
+    {
+    return vgRange<vgTimeStamp>();
+    }
+  return vgRange<vgTimeStamp>(first, last);
+}
+
 //-----------------------------------------------------------------------------
 vgVideo::FrameMap::const_iterator vgVideo::iterAt(
   vgTimeStamp pos, vg::SeekMode direction) const
@@ -53,6 +53,14 @@ public:
 
   int frameCount() const;
 
+  // Frame number accessors; these are constant time for videos whose frames
+  // all have frame numbers that increase with time
+  vgVideoFramePtr frameAtFrameNumber(
+    unsigned int frameNumber,
+    vg::SeekMode direction = vg::SeekExact) const;
+  vgRange<vgTimeStamp> timeRange(unsigned int firstFrame,
+                                 unsigned int lastFrame) const;
+
 protected:
   QTE_DECLARE_PRIVATE_RPTR(vgVideo)
 
@@ -104,6 +104,7 @@ void vgVideoBufferPrivate::insertFrame(
   vgVideoFramePtr frame(
     new vgVideoDataStreamFramePtr(pos, this->Store, offset, compressionFormat));
   this->pos = this->frames.insert(pos, frame);
+  this->clearFrameNumberIndex();
 }
 
 //-----------------------------------------------------------------------------
@@ -149,6 +150,13 @@ void vgVideoBufferPrivate::insert(const vgTimeStamp& pos, const QImage& image,
   this->insertFrame(pos, offset, compressionFormat);
 }
 
+//-----------------------------------------------------------------------------
+void vgVideoBuffer::buildFrameNumberIndex()
+{
+  QTE_D(vgVideoBuffer);
+  d->buildFrameNumberIndex();
+}
+
 //END vgVideoBufferPrivate
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -292,4 +300,11 @@ bool vgVideoBuffer::insert(const vgTimeStamp& pos, const QByteArray& imageData,
   return true;
 }
 
+//-----------------------------------------------------------------------------
+void vgVideoBuffer::buildFrameNumberIndex()
+{
+  QTE_D(vgVideoBuffer);
+  d->buildFrameNumberIndex();
+}
+
 //END vgVideoBuffer
@@ -21,6 +21,10 @@ public:
   bool insert(const vgTimeStamp& pos, const QByteArray& imageData,
               const QByteArray& imageFormat);
 
+  // Index the buffered frames by frame number, so that frame number seeks are
+  // constant time; inserting a frame discards the index
+  void buildFrameNumberIndex();
+
 private:
   QTE_DECLARE_PRIVATE(vgVideoBuffer)
   Q_DISABLE_COPY(vgVideoBuffer)
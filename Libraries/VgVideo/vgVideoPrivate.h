@@ -5,16 +5,37 @@
 #ifndef __vgVideoPrivate_h
 #define __vgVideoPrivate_h
 
+#include <QVector>
+
 #include "vgVideo.h"
 
 class vgVideoPrivate
 {
 public:
+  typedef vgVideo::FrameMap::const_iterator FrameIterator;
+
   vgVideoPrivate();
   virtual ~vgVideoPrivate();
 
+  // Build the frame number index; this must be called again (or the index
+  // cleared) whenever the frame map is modified
+  void buildFrameNumberIndex();
+  void clearFrameNumberIndex();
+
+  FrameIterator findFrameNumber(unsigned int frameNumber,
+                                vg::SeekMode direction) const;
+  FrameIterator frameNumberLowerBound(unsigned int frameNumber) const;
+
   vgVideo::FrameMap frames;
-  vgVideo::FrameMap::const_iterator pos;
+  FrameIterator pos;
+
+  // Dense frame number index; entry n is the first frame whose frame number
+  // is not less than firstFrameNumber + n (i.e. the lower bound); the
+  // iterators refer to indexedFrames, which shares data with frames and keeps
+  // the iterators valid even if frames is detached
+  vgVideo::FrameMap indexedFrames;
+  QVector<FrameIterator> frameNumberIndex;
+  unsigned int firstFrameNumber;
 };
 
 #endif
@@ -0,0 +1,43 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "TestKw18Data.h"
+
+#include <QByteArray>
+
+//-----------------------------------------------------------------------------
+static QByteArray record(unsigned int id, int length, unsigned int frame,
+                         double x, double y, double time)
+{
+  // Box is 10x20, centered on the image location
+  return QByteArray::number(id) + ' ' + QByteArray::number(length) + ' '
+         + QByteArray::number(frame) + " 0 0 0 0 "
+         + QByteArray::number(x) + ' ' + QByteArray::number(y) + ' '
+         + QByteArray::number(x - 5) + ' ' + QByteArray::number(y - 10) + ' '
+         + QByteArray::number(x + 5) + ' ' + QByteArray::number(y + 10)
+         + " 200 0 0 0 " + QByteArray::number(time, 'f', 3) + " -1\n";
+}
+
+//-----------------------------------------------------------------------------
+QByteArray generateKw18(int trackCount, int trackLength)
+{
+  // Tracks start every other frame, so that many tracks are interleaved
+  QByteArray data = "# 1:Track-id 2:Track-length 3:Frame-number ...\n";
+  const int lastFrame = 2 * trackCount + trackLength;
+  for (int frame = 0; frame < lastFrame; ++frame)
+    {
+    const int first = qMax(0, (frame - trackLength) / 2);
+    for (int id = first; id < trackCount && 2 * id <= frame; ++id)
+      {
+      const int offset = frame - (2 * id);
+      if (offset < trackLength)
+        {
+        data += record(static_cast<unsigned int>(id), trackLength,
+                       static_cast<unsigned int>(frame),
+                       id + offset, 2.5 * offset, 0.5 * frame);
+        }
+      }
+    }
+  return data;
+}
@@ -0,0 +1,9 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+class QByteArray;
+
+// Generate kw18 data for the specified number of tracks, each having the
+// specified number of states; track n starts at frame 2n
+extern QByteArray generateKw18(int trackCount, int trackLength);
@@ -0,0 +1,228 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <QByteArray>
+#include <QList>
+
+#include <qtTest.h>
+
+#include "../vsKw18TrackReader.h"
+
+#include "TestKw18Data.h"
+
+typedef vsKw18TrackReader::Track Track;
+
+//-----------------------------------------------------------------------------
+void readAll(qtTest& testObject, vsKw18TrackReader& reader,
+             QList<Track>& tracks, int& batches)
+{
+  batches = 0;
+  TEST(reader.readTracks([&](QList<Track>& batch){
+    tracks += batch;
+    ++batches;
+    return true;
+  }));
+  TEST_EQUAL(reader.position(), reader.size());
+}
+
+//-----------------------------------------------------------------------------
+int testParse(qtTest& testObject)
+{
+  const QByteArray data =
+    "# 1:Track-id 2:Track-length 3:Frame-number ...\n"
+    "\n"
+    "1 2 0 0 0 0 0 10.5 20.25 5 6 15.9 26 1 0 0 0 0.5\n"
+    "2 3 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5 3\r\n"
+    "  2 3 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n"
+    "1 2 1 0 0 0 0 11 21 5 6 15 26 1 0 0 0 1.0\n"
+    "3 5 2 0 0 0 0 7 8 1 2 3 4 1 0 0 0 1.5\n"
+    "2 3 2 0 0 0 0 1 2 0 0 3 4 1 0 0 0 1.5\n";
+
+  for (int threads = 1; threads <= 2; ++threads)
+    {
+    vsKw18TrackReader reader;
+    reader.setThreadCount(threads);
+    reader.setChunkSize(1);
+
+    int batches;
+    QList<Track> tracks;
+    TEST(reader.setInput(data));
+    TEST_CALL(readAll, reader, tracks, batches);
+    if (TEST_EQUAL(tracks.count(), 3) != 0)
+      {
+      continue;
+      }
+
+    // Track 1 is complete first; track 3 is short of its recorded length, so
+    // it is not complete until the end of the input
+    TEST_EQUAL(tracks[0].Id, 1LL);
+    TEST_EQUAL(tracks[1].Id, 2LL);
+    TEST_EQUAL(tracks[2].Id, 3LL);
+
+    if (TEST_EQUAL(tracks[0].States.count(), 2) == 0)
+      {
+      const vvTrackState& state = tracks[0].States[0];
+      TEST_EQUAL(state.TimeStamp.FrameNumber, 0U);
+      TEST_EQUAL(state.TimeStamp.Time, 0.5e6);
+      TEST_EQUAL(state.ImagePoint.X, 10.5);
+      TEST_EQUAL(state.ImagePoint.Y, 20.25);
+      TEST_EQUAL(state.ImageBox.TopLeft.X, 5);
+      TEST_EQUAL(state.ImageBox.TopLeft.Y, 6);
+      TEST_EQUAL(state.ImageBox.BottomRight.X, 15);
+      TEST_EQUAL(state.ImageBox.BottomRight.Y, 26);
+      if (TEST_EQUAL(state.ImageObject.size(), size_t(4)) == 0)
+        {
+        TEST_EQUAL(state.ImageObject[1].X, 15.0);
+        TEST_EQUAL(state.ImageObject[1].Y, 6.0);
+        }
+      TEST_EQUAL(tracks[0].States[1].TimeStamp.FrameNumber, 1U);
+      }
+
+    // The repeated state of track 2 is dropped
+    if (TEST_EQUAL(tracks[1].States.count(), 2) == 0)
+      {
+      TEST_EQUAL(tracks[1].States[0].TimeStamp.FrameNumber, 0U);
+      TEST_EQUAL(tracks[1].States[1].TimeStamp.FrameNumber, 2U);
+      }
+
+    TEST_EQUAL(tracks[2].States.count(), 1);
+    }
+
+  // Track ids wider than 32 bits are kept, and not confused with the ids
+  // that they would be truncated to
+  vsKw18TrackReader reader;
+  QList<Track> tracks;
+  int batches;
+  TEST(reader.setInput("4294967297 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n"
+                       "1 1 1 0 0 0 0 1 2 0 0 3 4 1 0 0 0 1.0\n"));
+  TEST_CALL(readAll, reader, tracks, batches);
+  if (TEST_EQUAL(tracks.count(), 2) == 0)
+    {
+    TEST_EQUAL(tracks[0].Id, 4294967297LL);
+    TEST_EQUAL(tracks[1].Id, 1LL);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testStreaming(qtTest& testObject)
+{
+  const int trackCount = 500;
+  const int trackLength = 40;
+  const QByteArray data = generateKw18(trackCount, trackLength);
+
+  QList<Track> expected;
+  for (int threads = 1; threads <= 4; threads += 3)
+    {
+    vsKw18TrackReader reader;
+    reader.setThreadCount(threads);
+    reader.setChunkSize(4096);
+
+    // Tracks are delivered in many batches, as they are completed
+    int batches;
+    QList<Track> tracks;
+    TEST(reader.setInput(data));
+    TEST_CALL(readAll, reader, tracks, batches);
+    TEST(batches > 10);
+    if (TEST_EQUAL(tracks.count(), trackCount) != 0)
+      {
+      continue;
+      }
+
+    for (int n = 0; n < trackCount; ++n)
+      {
+      const Track& track = tracks[n];
+      TEST_EQUAL(track.Id, static_cast<long long>(n));
+      if (TEST_EQUAL(track.States.count(), trackLength) == 0)
+        {
+        const vvTrackState& last = track.States.last();
+        TEST_EQUAL(last.TimeStamp.FrameNumber,
+                   static_cast<unsigned int>(2 * n + trackLength - 1));
+        TEST_EQUAL(last.ImagePoint.X, n + trackLength - 1.0);
+        }
+      }
+
+    // Parallel and serial reads give the same result
+    if (expected.isEmpty())
+      {
+      expected = tracks;
+      }
+    else
+      {
+      for (int n = 0; n < trackCount; ++n)
+        {
+        for (int i = 0; i < trackLength; ++i)
+          {
+          const vvTrackState& a = tracks[n].States[i];
+          const vvTrackState& b = expected[n].States[i];
+          TEST_EQUAL(a.TimeStamp.Time, b.TimeStamp.Time);
+          TEST_EQUAL(a.ImagePoint.Y, b.ImagePoint.Y);
+          }
+        }
+      }
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testControl(qtTest& testObject)
+{
+  const QByteArray data =
+    "1 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n"
+    "2 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n"
+    "3 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n"
+    "4 1 0 0 0 0 0 1 2 0 0 3 4 1 bad 0 0 0.5\n"
+    "5 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0 0.5\n";
+
+  for (int threads = 1; threads <= 2; ++threads)
+    {
+    vsKw18TrackReader reader;
+    QList<long long> ids;
+    reader.setThreadCount(threads);
+    reader.setChunkSize(1);
+
+    // Stopping early is not an error
+    TEST(reader.setInput(data));
+    TEST(reader.readTracks([&ids](QList<Track>& tracks){
+      foreach (const Track& track, tracks)
+        {
+        ids.append(track.Id);
+        }
+      return ids.count() < 2;
+    }));
+    TEST_EQUAL(ids.count(), 2);
+
+    // Tracks preceding an invalid record are delivered before the error
+    ids.clear();
+    TEST(reader.setInput(data));
+    TEST(!reader.readTracks([&ids](QList<Track>& tracks){
+      foreach (const Track& track, tracks)
+        {
+        ids.append(track.Id);
+        }
+      return true;
+    }));
+    TEST_EQUAL(ids.count(), 3);
+    TEST(!reader.error().isEmpty());
+
+    // Records with too few fields are invalid
+    TEST(reader.setInput("1 1 0 0 0 0 0 1 2 0 0 3 4 1 0 0 0\n"));
+    TEST(!reader.readTracks([](QList<Track>&){ return true; }));
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  qtTest testObject;
+
+  testObject.runSuite("Parse Tests",                testParse);
+  testObject.runSuite("Streaming Tests",            testStreaming);
+  testObject.runSuite("Read Control Tests",         testControl);
+  return testObject.result();
+}
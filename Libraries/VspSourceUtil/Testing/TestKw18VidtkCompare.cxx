@@ -0,0 +1,121 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QTemporaryDir>
+
+#include <qtTest.h>
+
+#include <tracking/kw18_reader.h>
+
+#include <vvAdaptVidtk.h>
+
+#include "../vsKw18TrackReader.h"
+
+#include "TestKw18Data.h"
+
+QString testFileName;
+
+//-----------------------------------------------------------------------------
+void compareStates(qtTest& testObject, const QList<vvTrackState>& actual,
+                   const QList<vvTrackState>& expected)
+{
+  if (TEST_EQUAL(actual.count(), expected.count()) != 0)
+    {
+    return;
+    }
+
+  for (int i = 0, k = actual.count(); i < k; ++i)
+    {
+    const vvTrackState& a = actual[i];
+    const vvTrackState& b = expected[i];
+    TEST_EQUAL(a.TimeStamp.FrameNumber, b.TimeStamp.FrameNumber);
+    TEST_EQUAL(a.TimeStamp.Time, b.TimeStamp.Time);
+    TEST_EQUAL(a.ImagePoint.X, b.ImagePoint.X);
+    TEST_EQUAL(a.ImagePoint.Y, b.ImagePoint.Y);
+    TEST_EQUAL(a.ImageBox.TopLeft.X, b.ImageBox.TopLeft.X);
+    TEST_EQUAL(a.ImageBox.TopLeft.Y, b.ImageBox.TopLeft.Y);
+    TEST_EQUAL(a.ImageBox.BottomRight.X, b.ImageBox.BottomRight.X);
+    TEST_EQUAL(a.ImageBox.BottomRight.Y, b.ImageBox.BottomRight.Y);
+    TEST_EQUAL(a.ImageObject.size(), b.ImageObject.size());
+    TEST_EQUAL(a.WorldLocation.GCS, b.WorldLocation.GCS);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int testCompare(qtTest& testObject)
+{
+  // Read with the vidtk reader
+  QElapsedTimer timer;
+  timer.start();
+
+  vidtk::kw18_reader vidtkReader(qPrintable(testFileName));
+  std::vector<vidtk::track_sptr> vidtkTracks;
+  TEST(vidtkReader.read(vidtkTracks));
+
+  QHash<long long, QList<vvTrackState> > expected;
+  for (size_t n = 0; n < vidtkTracks.size(); ++n)
+    {
+    QList<vvTrackState>& states = expected[vidtkTracks[n]->id()];
+    const std::vector<vidtk::track_state_sptr>& h =
+      vidtkTracks[n]->history();
+    for (size_t j = 0; j < h.size(); ++j)
+      {
+      states.append(vvAdapt(*h[j]));
+      }
+    }
+  vidtkTracks.clear();
+
+  testObject.out() << "vidtk reader: " << timer.elapsed() << " ms\n";
+
+  // Read with the streaming reader
+  timer.restart();
+
+  vsKw18TrackReader reader;
+  QHash<long long, QList<vvTrackState> > actual;
+  TEST(reader.open(testFileName));
+  TEST(reader.readTracks([&actual](QList<vsKw18TrackReader::Track>& tracks){
+    foreach (const vsKw18TrackReader::Track& track, tracks)
+      {
+      actual[track.Id] += track.States;
+      }
+    return true;
+  }));
+
+  testObject.out() << "streaming reader: " << timer.elapsed() << " ms\n";
+
+  // Compare results
+  TEST_EQUAL(actual.count(), expected.count());
+  foreach (long long id, expected.keys())
+    {
+    TEST(actual.contains(id));
+    TEST_CALL(compareStates, actual.value(id), expected.value(id));
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main()
+{
+  qtTest testObject;
+
+  QTemporaryDir tempDir;
+  testFileName = tempDir.path() + "/tracks.kw18";
+
+  QFile file(testFileName);
+  if (!file.open(QIODevice::WriteOnly) ||
+      file.write(generateKw18(10000, 100)) < 0)
+    {
+    testObject.out() << "unable to write test data\n";
+    return 1;
+    }
+  file.close();
+
+  testObject.runSuite("Comparison Tests",           testCompare);
+  return testObject.result();
+}
@@ -133,7 +133,7 @@ vsEvent vsAdapt(const vvQueryResult& result)
 }
 
 //-----------------------------------------------------------------------------
-vsTrackId vsAdaptTrackId(unsigned int vidtkId)
+vsTrackId vsAdaptTrackId(long long vidtkId)
 {
   vsTrackId vvId(0, vidtkId, QUuid());
   if (vvId.SerialNumber >= 1000000)
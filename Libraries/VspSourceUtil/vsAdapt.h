@@ -26,7 +26,7 @@ extern VSP_SOURCEUTIL_EXPORT vsEvent
 vsAdapt(const vvQueryResult&);
 
 extern VSP_SOURCEUTIL_EXPORT vsTrackId
-vsAdaptTrackId(unsigned int);
+vsAdaptTrackId(long long);
 
 extern VSP_SOURCEUTIL_EXPORT bool
 vsExtractClassifier(const vvDescriptor&, QList<vsEvent>&);
@@ -0,0 +1,609 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsKw18TrackReader.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QHash>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#define die(_msg) return this->abort(_msg)
+#define test_or_die(_cond, _msg) if (!(_cond)) die(_msg)
+
+QTE_IMPLEMENT_D_FUNC(vsKw18TrackReader)
+
+namespace // anonymous
+{
+
+// Columns of a kw18 record; only the columns that are used are listed
+enum Column
+{
+  TrackIdColumn = 0,
+  TrackLengthColumn = 1,
+  FrameNumberColumn = 2,
+  ImageLocationXColumn = 7,
+  ImageLocationYColumn = 8,
+  BoxMinXColumn = 9,
+  BoxMinYColumn = 10,
+  BoxMaxXColumn = 11,
+  BoxMaxYColumn = 12,
+  TimeStampColumn = 17,
+  RequiredColumnCount = 18
+};
+
+//-----------------------------------------------------------------------------
+struct Row
+{
+  long long Id;
+  long long Length;
+  vvTrackState State;
+};
+
+//-----------------------------------------------------------------------------
+struct ChunkResult
+{
+  std::vector<Row> Rows;
+  const char* FailedAt;
+};
+
+//-----------------------------------------------------------------------------
+struct OpenTrack
+{
+  OpenTrack() : Order(0), Rows(0) {}
+
+  long long Order;
+  long long Rows;
+  vsKw18TrackReader::Track Data;
+};
+
+//-----------------------------------------------------------------------------
+inline bool isBlank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+//-----------------------------------------------------------------------------
+bool nextField(const char*& pos, const char* end,
+               const char*& fb, const char*& fe)
+{
+  while (pos < end && isBlank(*pos))
+    {
+    ++pos;
+    }
+  if (pos == end)
+    {
+    return false;
+    }
+
+  fb = pos;
+  while (pos < end && !isBlank(*pos))
+    {
+    ++pos;
+    }
+  fe = pos;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool parseInteger(const char* p, const char* end, long long& out)
+{
+  const bool negative = (*p == '-');
+  p += (negative || *p == '+');
+
+  // Limit the number of digits so that the value cannot overflow
+  if (p == end || end - p > 18)
+    {
+    return false;
+    }
+
+  long long value = 0;
+  for (; p < end; ++p)
+    {
+    if (*p < '0' || *p > '9')
+      {
+      return false;
+      }
+    value = (value * 10) + (*p - '0');
+    }
+
+  out = (negative ? -value : value);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool parseReal(const char* begin, const char* end, double& out)
+{
+  static const double powersOfTen[] =
+    {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+  static const unsigned long long maxExactMantissa = 1ULL << 53;
+
+  // Plain decimal values whose digits fit exactly in a double are converted
+  // with a single (correctly rounded) division, giving the same result as a
+  // full conversion
+  const char* p = begin;
+  const bool negative = (*p == '-');
+  p += (negative || *p == '+');
+
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int fractionDigits = 0;
+  bool inFraction = false;
+  bool exact = true;
+  for (; p < end && exact; ++p)
+    {
+    if (*p >= '0' && *p <= '9')
+      {
+      mantissa = (mantissa * 10) + static_cast<unsigned>(*p - '0');
+      exact = (mantissa <= maxExactMantissa);
+      fractionDigits += (inFraction ? 1 : 0);
+      ++digits;
+      }
+    else if (*p == '.' && !inFraction)
+      {
+      inFraction = true;
+      }
+    else
+      {
+      exact = false;
+      }
+    }
+
+  if (exact && digits && fractionDigits <= 22)
+    {
+    const double value =
+      static_cast<double>(mantissa) / powersOfTen[fractionDigits];
+    out = (negative ? -value : value);
+    return true;
+    }
+
+  // Fall back to Qt's locale-independent conversion
+  bool okay;
+  out = QByteArray::fromRawData(begin, static_cast<int>(end - begin))
+          .toDouble(&okay);
+  return okay;
+}
+
+//-----------------------------------------------------------------------------
+// Parse a line; returns false if the line is not a valid record, or sets
+// 'isRecord' to false if it is blank or a comment
+bool parseLine(const char* pos, const char* end, Row& row, bool& isRecord)
+{
+  const char* fb;
+  const char* fe;
+
+  isRecord = nextField(pos, end, fb, fe) && *fb != '#';
+  if (!isRecord)
+    {
+    return true;
+    }
+
+  long long id, frame;
+  double fields[RequiredColumnCount];
+  for (int column = 0; column < RequiredColumnCount; ++column)
+    {
+    if (column > 0 && !nextField(pos, end, fb, fe))
+      {
+      return false;
+      }
+
+    bool okay;
+    switch (column)
+      {
+      case TrackIdColumn:
+        okay = parseInteger(fb, fe, id) && id >= 0;
+        break;
+      case TrackLengthColumn:
+        okay = parseInteger(fb, fe, row.Length);
+        break;
+      case FrameNumberColumn:
+        okay = parseInteger(fb, fe, frame) && frame >= 0;
+        break;
+      default:
+        okay = parseReal(fb, fe, fields[column]);
+        break;
+      }
+    if (!okay)
+      {
+      return false;
+      }
+    }
+
+  row.Id = id;
+
+  vvTrackState& state = row.State;
+  state.TimeStamp.FrameNumber = static_cast<unsigned int>(frame);
+  state.TimeStamp.Time = fields[TimeStampColumn] * 1e6;
+
+  state.ImagePoint.X = fields[ImageLocationXColumn];
+  state.ImagePoint.Y = fields[ImageLocationYColumn];
+
+  // The vidtk reader stores the box with integer coordinates, and vvAdapt
+  // uses it as the image object
+  vvImageBoundingBox& box = state.ImageBox;
+  box.TopLeft.X = static_cast<int>(fields[BoxMinXColumn]);
+  box.TopLeft.Y = static_cast<int>(fields[BoxMinYColumn]);
+  box.BottomRight.X = static_cast<int>(fields[BoxMaxXColumn]);
+  box.BottomRight.Y = static_cast<int>(fields[BoxMaxYColumn]);
+
+  state.ImageObject.clear();
+  state.ImageObject.reserve(4);
+  state.ImageObject.push_back(
+    vvImagePointF(box.TopLeft.X, box.TopLeft.Y));
+  state.ImageObject.push_back(
+    vvImagePointF(box.BottomRight.X, box.TopLeft.Y));
+  state.ImageObject.push_back(
+    vvImagePointF(box.BottomRight.X, box.BottomRight.Y));
+  state.ImageObject.push_back(
+    vvImagePointF(box.TopLeft.X, box.BottomRight.Y));
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void parseChunk(const char* pos, const char* end, ChunkResult& result)
+{
+  result.Rows.clear();
+  result.FailedAt = 0;
+
+  Row row;
+  while (pos < end)
+    {
+    const void* const nl = std::memchr(pos, '\n', end - pos);
+    const char* const le = (nl ? static_cast<const char*>(nl) : end);
+
+    bool isRecord;
+    if (!parseLine(pos, le, row, isRecord))
+      {
+      result.FailedAt = pos;
+      return;
+      }
+    if (isRecord)
+      {
+      result.Rows.push_back(row);
+      }
+
+    pos = le + 1;
+    }
+}
+
+} // namespace <anonymous>
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vsKw18TrackReaderPrivate
+
+//-----------------------------------------------------------------------------
+class vsKw18TrackReaderPrivate
+{
+public:
+  vsKw18TrackReaderPrivate();
+
+  bool abort(const QString&);
+  void reset();
+
+  bool nextChunk(const char*& begin, const char*& end);
+  bool readTracks(const vsKw18TrackReader::Callback& callback);
+
+  QFile file;
+  QByteArray buffer;
+  const char* begin;
+  const char* pos;
+  const char* end;
+
+  QString lastError;
+
+  int threadCount;
+  int chunkSize;
+  QThreadPool pool;
+};
+
+//-----------------------------------------------------------------------------
+vsKw18TrackReaderPrivate::vsKw18TrackReaderPrivate()
+  : begin(0), pos(0), end(0), threadCount(1), chunkSize(1 << 20)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReaderPrivate::abort(const QString& error)
+{
+  this->lastError = error;
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vsKw18TrackReaderPrivate::reset()
+{
+  this->file.close();
+  this->buffer.clear();
+  this->begin = this->pos = this->end = 0;
+  this->lastError.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReaderPrivate::nextChunk(const char*& cb, const char*& ce)
+{
+  if (this->pos >= this->end)
+    {
+    return false;
+    }
+
+  // Take (approximately) the requested number of bytes, extended to the end
+  // of the line
+  cb = this->pos;
+  ce = cb + qMin(static_cast<qint64>(this->chunkSize),
+                 static_cast<qint64>(this->end - cb));
+  if (ce < this->end)
+    {
+    const void* const nl = std::memchr(ce, '\n', this->end - ce);
+    ce = (nl ? static_cast<const char*>(nl) + 1 : this->end);
+    }
+
+  this->pos = ce;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReaderPrivate::readTracks(
+  const vsKw18TrackReader::Callback& callback)
+{
+  typedef std::pair<const char*, const char*> Range;
+
+  test_or_die(this->begin, "No data is available");
+
+  QHash<long long, OpenTrack> openTracks;
+  QList<vsKw18TrackReader::Track> completedTracks;
+  long long nextOrder = 0;
+
+  std::vector<Range> chunks;
+  std::vector<ChunkResult> results;
+  const size_t maxChunks = static_cast<size_t>(this->threadCount);
+  chunks.reserve(maxChunks);
+
+  forever
+    {
+    // Find the next set of chunks, one per thread
+    Range r;
+    chunks.clear();
+    while (chunks.size() < maxChunks && this->nextChunk(r.first, r.second))
+      {
+      chunks.push_back(r);
+      }
+    if (chunks.empty())
+      {
+      break;
+      }
+
+    // Parse the chunks; the calling thread takes the first chunk
+    const int count = static_cast<int>(chunks.size());
+    results.resize(chunks.size());
+
+    auto parse = [&chunks, &results](int n){
+      const Range& range = chunks[static_cast<size_t>(n)];
+      parseChunk(range.first, range.second, results[static_cast<size_t>(n)]);
+    };
+
+    QVector<QFuture<void> > futures;
+    for (int n = 1; n < count; ++n)
+      {
+      futures.append(QtConcurrent::run(&this->pool, [&parse, n]{
+        parse(n);
+      }));
+      }
+    parse(0);
+    foreach (QFuture<void> f, futures)
+      {
+      f.waitForFinished();
+      }
+
+    // Group the states by track, in file order, up to the first failure (if
+    // any), setting aside tracks that have been completed
+    const char* failedAt = 0;
+    for (int n = 0; n < count && !failedAt; ++n)
+      {
+      ChunkResult& result = results[static_cast<size_t>(n)];
+      for (size_t i = 0, k = result.Rows.size(); i < k; ++i)
+        {
+        Row& row = result.Rows[i];
+        OpenTrack& track = openTracks[row.Id];
+        if (track.Rows == 0)
+          {
+          track.Order = nextOrder++;
+          track.Data.Id = row.Id;
+          }
+
+        // Like the vidtk reader, drop states whose time stamp is the same as
+        // that of the preceding state
+        QList<vvTrackState>& states = track.Data.States;
+        if (states.isEmpty() || states.last().TimeStamp != row.State.TimeStamp)
+          {
+          states.append(std::move(row.State));
+          }
+
+        // A track is complete once it has as many rows as its recorded
+        // length; tracks with no (valid) length remain open until the end
+        if (++track.Rows >= row.Length && row.Length > 0)
+          {
+          completedTracks.append(std::move(track.Data));
+          openTracks.remove(row.Id);
+          }
+        }
+      failedAt = result.FailedAt;
+      }
+
+    // Deliver completed tracks
+    if (!completedTracks.isEmpty())
+      {
+      const bool keepReading = callback(completedTracks);
+      completedTracks.clear();
+      if (!keepReading)
+        {
+        return true;
+        }
+      }
+
+    test_or_die(!failedAt, "Error parsing kw18 record at offset "
+                           + QString::number(failedAt - this->begin));
+    }
+
+  // Deliver any remaining tracks, in order of their first appearance
+  std::vector<OpenTrack*> remainingTracks;
+  remainingTracks.reserve(static_cast<size_t>(openTracks.count()));
+  for (auto iter = openTracks.begin(); iter != openTracks.end(); ++iter)
+    {
+    remainingTracks.push_back(&iter.value());
+    }
+  std::sort(remainingTracks.begin(), remainingTracks.end(),
+            [](const OpenTrack* a, const OpenTrack* b){
+              return a->Order < b->Order;
+            });
+
+  foreach (OpenTrack* track, remainingTracks)
+    {
+    completedTracks.append(std::move(track->Data));
+    }
+  if (!completedTracks.isEmpty())
+    {
+    callback(completedTracks);
+    }
+
+  return true;
+}
+
+//END vsKw18TrackReaderPrivate
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vsKw18TrackReader
+
+//-----------------------------------------------------------------------------
+vsKw18TrackReader::vsKw18TrackReader() : d_ptr(new vsKw18TrackReaderPrivate)
+{
+  this->setThreadCount(QThread::idealThreadCount());
+}
+
+//-----------------------------------------------------------------------------
+vsKw18TrackReader::~vsKw18TrackReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+QString vsKw18TrackReader::error() const
+{
+  QTE_D_CONST(vsKw18TrackReader);
+  return d->lastError;
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReader::open(const QString& fileName)
+{
+  QTE_D(vsKw18TrackReader);
+  d->reset();
+
+  d->file.setFileName(fileName);
+  if (!d->file.open(QIODevice::ReadOnly))
+    {
+    return d->abort("Unable to open " + fileName + ": "
+                    + d->file.errorString());
+    }
+
+  const qint64 size = d->file.size();
+  if (size == 0)
+    {
+    d->begin = d->pos = d->end = "";
+    return true;
+    }
+
+  // Map the file; if that fails (e.g. the file is not a regular file), fall
+  // back to reading it into memory
+  const uchar* const data = d->file.map(0, size);
+  if (data)
+    {
+    d->begin = reinterpret_cast<const char*>(data);
+    d->pos = d->begin;
+    d->end = d->begin + size;
+    return true;
+    }
+
+  const QByteArray contents = d->file.readAll();
+  d->file.close();
+  return this->setInput(contents);
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReader::setInput(const QByteArray& data)
+{
+  QTE_D(vsKw18TrackReader);
+  d->reset();
+
+  d->buffer = data;
+  d->begin = d->buffer.constData();
+  d->pos = d->begin;
+  d->end = d->begin + d->buffer.size();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vsKw18TrackReader::setThreadCount(int count)
+{
+  QTE_D(vsKw18TrackReader);
+  d->threadCount = qMax(1, count);
+  d->pool.setMaxThreadCount(qMax(1, count - 1));
+}
+
+//-----------------------------------------------------------------------------
+int vsKw18TrackReader::threadCount() const
+{
+  QTE_D_CONST(vsKw18TrackReader);
+  return d->threadCount;
+}
+
+//-----------------------------------------------------------------------------
+void vsKw18TrackReader::setChunkSize(int size)
+{
+  QTE_D(vsKw18TrackReader);
+  d->chunkSize = qMax(1, size);
+}
+
+//-----------------------------------------------------------------------------
+int vsKw18TrackReader::chunkSize() const
+{
+  QTE_D_CONST(vsKw18TrackReader);
+  return d->chunkSize;
+}
+
+//-----------------------------------------------------------------------------
+bool vsKw18TrackReader::readTracks(const Callback& callback)
+{
+  QTE_D(vsKw18TrackReader);
+  return d->readTracks(callback);
+}
+
+//-----------------------------------------------------------------------------
+qint64 vsKw18TrackReader::position() const
+{
+  QTE_D_CONST(vsKw18TrackReader);
+  return d->pos - d->begin;
+}
+
+//-----------------------------------------------------------------------------
+qint64 vsKw18TrackReader::size() const
+{
+  QTE_D_CONST(vsKw18TrackReader);
+  return d->end - d->begin;
+}
+
+//END vsKw18TrackReader
@@ -0,0 +1,98 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsKw18TrackReader_h
+#define __vsKw18TrackReader_h
+
+#include <QList>
+#include <QString>
+
+#include <qtGlobal.h>
+
+#include <vgExport.h>
+
+#include <vvTrack.h>
+
+#include <functional>
+
+class QByteArray;
+
+class vsKw18TrackReaderPrivate;
+
+/// Streaming reader for kw18 (Kitware CSV) track files.
+///
+/// The input (which, when reading from a file, is memory mapped) is split
+/// into chunks at line boundaries, which are parsed in parallel. States are
+/// grouped by track id in file order. A track is complete once the number of
+/// rows read for it reaches the track length recorded in those rows; completed
+/// tracks are passed to the callback in batches while the remainder of the
+/// input is still being read. Tracks which never reach their recorded length
+/// are delivered when the end of the input is reached.
+///
+/// States are converted in the same manner as the vidtk kw18 reader followed
+/// by vvAdapt: the bounding box is truncated to integers and also used as the
+/// image object, the time stamp is converted from seconds to microseconds,
+/// and a state whose time stamp is the same as that of the preceding state of
+/// the same track is dropped. The tracking plane and world locations are
+/// ignored.
+class VSP_SOURCEUTIL_EXPORT vsKw18TrackReader
+{
+public:
+  struct Track
+    {
+    long long Id;
+    QList<vvTrackState> States;
+    };
+
+  /// Track batch callback.
+  ///
+  /// The callback is invoked from the thread that called readTracks(), and
+  /// may take ownership of the tracks' contents. Returning \c false stops
+  /// reading; this is not an error.
+  typedef std::function<bool (QList<Track>&)> Callback;
+
+  vsKw18TrackReader();
+  ~vsKw18TrackReader();
+
+  QString error() const;
+
+  /// Open (and memory map) the specified file.
+  bool open(const QString& fileName);
+
+  /// Read from an in-memory buffer.
+  ///
+  /// The reader keeps a (shallow) copy of \p data.
+  bool setInput(const QByteArray& data);
+
+  /// Set number of threads used to parse the input.
+  ///
+  /// Values less than 2 parse the input serially, in the calling thread. The
+  /// default is the ideal thread count of the system.
+  void setThreadCount(int);
+  int threadCount() const;
+
+  /// Set approximate number of bytes of input parsed by each task.
+  ///
+  /// One chunk per thread is held in memory at a time. The default is 1 MiB.
+  void setChunkSize(int);
+  int chunkSize() const;
+
+  /// Read all tracks from the input.
+  bool readTracks(const Callback& callback);
+
+  /// Get number of bytes of input consumed so far.
+  qint64 position() const;
+
+  /// Get total size of input, in bytes.
+  qint64 size() const;
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vsKw18TrackReader)
+
+private:
+  QTE_DECLARE_PRIVATE(vsKw18TrackReader)
+  Q_DISABLE_COPY(vsKw18TrackReader)
+};
+
+#endif
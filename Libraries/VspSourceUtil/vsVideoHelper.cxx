@@ -80,23 +80,7 @@ void vsVideoHelper::clearLastRequest(vgVideoSourceRequestor* requestor)
 vgTimeStamp vsVideoHelper::findTime(
   const vgVideo& video, unsigned int frameNumber, vg::SeekMode roundMode)
 {
-  vgTimeStamp ts(frameNumber);
-
-  // vgVideo would be perfectly within its rights to not find a matching frame
-  // to our time-less time stamp, even if a frame with that frame number
-  // exists; so, handle Exact by finding the nearest frame, and accepting it if
-  // it has the correct frame number
-  if (roundMode == vg::SeekExact)
-    {
-    vgVideoFramePtr frame = video.frameAt(ts);
-    ts = frame.time();
-    if (ts.HasFrameNumber() && ts.FrameNumber == frameNumber)
-      return ts;
-    return vgTimeStamp();
-    }
-
-  // Everything else (fuzzy modes) should just work correctly
-  return video.frameAt(ts, roundMode).time();
+  return video.frameAtFrameNumber(frameNumber, roundMode).time();
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsAlertMatchIndex.h"
+
+//-----------------------------------------------------------------------------
+int vsAlertMatchIndex::addMatch(int alertId, vtkIdType eventId)
+{
+  QSet<vtkIdType>& matches = this->AlertMatches[alertId];
+  matches.insert(eventId);
+  this->EventAlerts.insert(eventId, alertId);
+  return matches.count();
+}
+
+//-----------------------------------------------------------------------------
+int vsAlertMatchIndex::removeEvent(vtkIdType eventId, int* alertId)
+{
+  QHash<vtkIdType, int>::iterator eventIter = this->EventAlerts.find(eventId);
+  if (eventIter == this->EventAlerts.end())
+    {
+    return -1;
+    }
+
+  const int matchedAlertId = eventIter.value();
+  this->EventAlerts.erase(eventIter);
+
+  QHash<int, QSet<vtkIdType> >::iterator alertIter =
+    this->AlertMatches.find(matchedAlertId);
+  if (alertIter == this->AlertMatches.end() ||
+      !alertIter->remove(eventId))
+    {
+    return -1;
+    }
+
+  if (alertId)
+    {
+    *alertId = matchedAlertId;
+    }
+  return alertIter->count();
+}
+
+//-----------------------------------------------------------------------------
+void vsAlertMatchIndex::removeAlert(int alertId)
+{
+  foreach (vtkIdType eventId, this->AlertMatches.take(alertId))
+    {
+    this->EventAlerts.remove(eventId);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vsAlertMatchIndex::matchCount(int alertId) const
+{
+  return this->AlertMatches.value(alertId).count();
+}
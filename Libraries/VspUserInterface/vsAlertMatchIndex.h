@@ -0,0 +1,41 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsAlertMatchIndex_h
+#define __vsAlertMatchIndex_h
+
+#include <QHash>
+#include <QSet>
+
+#include <vtkType.h>
+
+#include <vgExport.h>
+
+// Record of which events have matched which alerts.
+//
+// An event matches at most one alert. Matches are indexed both by alert and
+// by event, so that removing an event does not need to visit every alert.
+class VSP_USERINTERFACE_EXPORT vsAlertMatchIndex
+{
+public:
+  // Record that event \p eventId matches alert \p alertId, and return the
+  // number of events matching the alert.
+  int addMatch(int alertId, vtkIdType eventId);
+
+  // Remove the match of event \p eventId, if any. If the event matched an
+  // alert, sets \p alertId to the alert and returns the number of events
+  // still matching the alert; otherwise, returns -1.
+  int removeEvent(vtkIdType eventId, int* alertId = 0);
+
+  // Remove all matches of alert \p alertId.
+  void removeAlert(int alertId);
+
+  int matchCount(int alertId) const;
+
+protected:
+  QHash<int, QSet<vtkIdType> > AlertMatches;
+  QHash<vtkIdType, int> EventAlerts;
+};
+
+#endif
@@ -495,8 +495,9 @@ void vsCore::removeAlert(int id, bool removeEvents)
   if (!d->Alerts.contains(id))
     return;
 
-  // Remove from internal map
+  // Remove from internal map and forget its matches
   vsCorePrivate::AlertInfo info = d->Alerts.take(id);
+  d->AlertMatches.removeAlert(id);
 
   // Revoke alert from descriptors
   foreach (qint64 inputId, info.inputIdList)
@@ -11,6 +11,7 @@
 #include <qtMap.h>
 #include <qtStlUtil.h>
 
+#include <vtkMatrix4x4.h>
 #include <vtkPoints.h>
 
 #include <vtkVgEvent.h>
@@ -34,6 +35,7 @@
 
 #include "vsAlertEditor.h"
 #include "vsTrackInfo.h"
+#include "vsTrackStateTransform.h"
 #include "vsTripwireDescriptor.h"
 
 //-----------------------------------------------------------------------------
@@ -586,6 +588,11 @@ void vsCorePrivate::updateTrack(
   vvTrack& vvTrack = this->getVvTrack(trackId);
   bool stateAccepted = false;
   bool isNewTrack = false;
+
+  // Scratch buffer for the transformed object points, reused across states so
+  // that it is allocated at most once per batch rather than grown per point
+  QVector<float> object;
+
   foreach (const vvTrackState& state, states)
     {
     // Always accept the state for our internal vvTrack (used for QF), as we
@@ -638,18 +645,11 @@ void vsCorePrivate::updateTrack(
     wstate.time = state.TimeStamp;
 
     // Use homography to get stabilized coordinates from image coordinates
-    const vtkMatrix4x4& homography = iter.value();
-    QVector<float> object;
+    const vsTrackStateTransform transform(iter.value());
+    transform.mapObject(state.ImageObject, object, wstate.object);
+
     double wp[2];
-    for (size_t n = 0; n < state.ImageObject.size(); ++n)
-      {
-      const vvImagePointF& ip = state.ImageObject[n];
-      vtkVgApplyHomography(ip.X, ip.Y, homography, wp);
-      object.append(wp[0]); object.append(wp[1]); object.append(0.0f);
-      wstate.object.append(QPointF(wp[0], wp[1]));
-      }
-    vtkVgApplyHomography(state.ImagePoint.X, state.ImagePoint.Y,
-                         homography, wp);
+    transform.map(state.ImagePoint.X, state.ImagePoint.Y, wp[0], wp[1]);
     wstate.point = QPointF(wp[0], wp[1]);
 
     // Accept the update
@@ -1114,13 +1114,7 @@ vtkIdType vsCorePrivate::addReadyEvent(
   if (source && eventPtr->GetNumberOfClassifiers() == 1)
     {
     eventPtr->InitClassifierTraversal();
-    int classifier = eventPtr->GetClassifierType();
-    if (this->Alerts.contains(classifier))
-      {
-      AlertInfo& ai = this->Alerts[classifier];
-      ai.matchingEvents.insert(ref.modelId);
-      emit q->alertMatchesChanged(classifier, ai.matchingEvents.count());
-      }
+    this->addAlertMatch(eventPtr->GetClassifierType(), ref.modelId);
     }
 
   // Generate new event
@@ -1183,15 +1177,7 @@ void vsCorePrivate::removeEvent(
       }
 
     // Remove from alert matches, if present
-    foreach_iter (AlertMap::iterator, iter, this->Alerts)
-      {
-      QSet<vtkIdType>& me = iter->matchingEvents;
-      if (me.contains(ref.modelId))
-        {
-        me.remove(ref.modelId);
-        emit q->alertMatchesChanged(iter.key(), me.count());
-        }
-      }
+    this->removeAlertMatch(ref.modelId);
 
     emit q->eventRemoved(ref.modelId);
     }
@@ -1211,6 +1197,32 @@ void vsCorePrivate::removeEvent(
     }
 }
 
+//-----------------------------------------------------------------------------
+void vsCorePrivate::addAlertMatch(int alertId, vtkIdType eventId)
+{
+  if (!this->Alerts.contains(alertId))
+    {
+    return;
+    }
+
+  QTE_Q(vsCore);
+
+  const int matches = this->AlertMatches.addMatch(alertId, eventId);
+  emit q->alertMatchesChanged(alertId, matches);
+}
+
+//-----------------------------------------------------------------------------
+void vsCorePrivate::removeAlertMatch(vtkIdType eventId)
+{
+  int alertId;
+  const int matches = this->AlertMatches.removeEvent(eventId, &alertId);
+  if (matches >= 0)
+    {
+    QTE_Q(vsCore);
+    emit q->alertMatchesChanged(alertId, matches);
+    }
+}
+
 //-----------------------------------------------------------------------------
 vtkVgEvent* vsCorePrivate::event(
   vtkIdType id, vtkVgEventModelCollection** model)
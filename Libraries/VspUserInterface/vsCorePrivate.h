@@ -16,6 +16,7 @@
 #include <vsEvent.h>
 #include <vsTrackId.h>
 
+#include "vsAlertMatchIndex.h"
 #include "vsCore.h"
 
 class vtkMatrix4x4;
@@ -97,7 +98,6 @@ public:
     vsAlert alert;
     QList<qint64> inputIdList;
     bool enabled;
-    QSet<vtkIdType> matchingEvents;
     };
 
   typedef QList<vsTrackSourcePtr>::iterator vsTrackSourceIterator;
@@ -165,6 +165,9 @@ public:
 
   void registerEventType(const vsEventInfo&, bool isManualType);
 
+  void addAlertMatch(int alertId, vtkIdType eventId);
+  void removeAlertMatch(vtkIdType eventId);
+
   void loadPersistentAlerts();
   void findAndStorePossibleAlerts(QString path, QStringList& filePaths);
 
@@ -196,6 +199,7 @@ public:
   int NextContourId;
 
   AlertMap Alerts;
+  vsAlertMatchIndex AlertMatches;
   int NextAlertType;
 
   QHash<const vsDescriptorSource*, QHash<int, UserEventType> > UserEventTypeMap;
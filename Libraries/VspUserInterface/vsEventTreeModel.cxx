@@ -44,13 +44,13 @@ vsEventTreeModel::vsEventTreeModel(
   vtkVgEventTypeRegistry* eventTypeRegistry, const vgSwatchCache& swatchCache,
   QObject* parent)
   : QAbstractItemModel(parent), Scene(scene), eventFilter(eventFilter),
-    eventTypeRegistry(eventTypeRegistry), swatchCache(swatchCache),
-    isSorted(true)
+    eventTypeRegistry(eventTypeRegistry), swatchCache(swatchCache)
 {
   this->yesIcon = qtUtil::standardIcon("okay", 16);
   this->noIcon = qtUtil::standardIcon("cancel", 16);
 
-  connect(scene, SIGNAL(eventSceneUpdated()), this, SLOT(update()));
+  connect(scene, SIGNAL(eventSceneChanged(QSet<vtkIdType>, bool)),
+          this, SLOT(updateScene(QSet<vtkIdType>, bool)));
 }
 
 //-----------------------------------------------------------------------------
@@ -104,28 +104,16 @@ QVariant vsEventTreeModel::data(const QModelIndex& index, int role) const
             }
 
         case EventTypeColumn:
-          {
-          int type = this->eventFilter->GetBestClassifier(event);
-          if (type == -1)
-            {
-            return QString("(none)");
-            }
-          return this->eventTypeRegistry->GetTypeById(type).GetName();
-          }
+          return this->displayValues(index.row()).Type;
 
         case ProbabilityColumn:
-          {
-          int type = this->eventFilter->GetBestClassifier(event);
-          double probability =
-            (type == -1 ? 0.0 : event->GetProbability(type));
-          return QString::number(probability, 'f', 4);
-          }
+          return this->displayValues(index.row()).Probability;
 
         case StartTimeColumn:
-          return vgUnixTime(event->GetStartFrame().GetTime()).timeString();
+          return this->displayValues(index.row()).StartTime;
 
         case EndTimeColumn:
-          return vgUnixTime(event->GetEndFrame().GetTime()).timeString();
+          return this->displayValues(index.row()).EndTime;
 
         case NoteColumn:
           return QString::fromLocal8Bit(event->GetNote());
@@ -148,14 +136,8 @@ QVariant vsEventTreeModel::data(const QModelIndex& index, int role) const
         }
       else if (index.column() == EventTypeColumn)
         {
-        const vsDisplayInfo& di = this->Scene->eventDisplayInfo(event->GetId());
-        if (di.Color.isValid())
-          {
-          QColor color = di.Color.toQColor();
-          color.setAlphaF(di.Visible ? 1.0 : 0.5);
-          return this->swatchCache.swatch(color);
-          }
-        return this->swatchCache.swatch(Qt::transparent);
+        const QColor& color = this->displayValues(index.row()).SwatchColor;
+        return this->swatchCache.swatch(color);
         }
       break;
 
@@ -423,10 +405,6 @@ void vsEventTreeModel::updateEvent(vtkVgEvent* event)
 //-----------------------------------------------------------------------------
 void vsEventTreeModel::deferredUpdateEvents()
 {
-  bool changed = false;
-  int minRow = this->rowCount() - 1;
-  int maxRow = 0;
-
   // Flush any new additions first, as we might also have updates for the new
   // events
   if (!this->addedEvents.isEmpty())
@@ -442,48 +420,30 @@ void vsEventTreeModel::deferredUpdateEvents()
       ei.Event = iter.value();
       ei.Status = vgObjectStatus::None;
 
-      vtkVgEvent* prev = this->events.isEmpty() ? 0 : this->events.back().Event;
+      this->rowCache.append(iter.key());
       this->events.append(ei);
-
-      // Check if ordering has been violated... we assume that the ID of an
-      // event will not change once it has been added, so this check should be
-      // sufficient
-      if (prev && this->isSorted && iter.key() < prev->GetId())
-        {
-        this->isSorted = false;
-        qWarning() << "Event tree ids are not in sorted order, "
-                      "falling back to linear search";
-        }
       }
 
     this->addedEvents.clear();
     this->endInsertRows();
     }
 
-  // Update event pointers and compute the model rows covered by the events
+  // Update event pointers and collect the model rows of the events
   foreach (vtkVgEvent* event, this->updatedEvents)
     {
-    QModelIndex index = this->indexOfEvent(event->GetId());
-    if (!index.isValid())
+    const vtkIdType eventId = event->GetId();
+    const int row = this->rowCache.row(eventId);
+    if (row < 0)
       {
       continue;
       }
 
-    changed = true;
-    const int row = index.row();
     this->events[row].Event = event;
-
-    minRow = qMin(row, minRow);
-    maxRow = qMax(row, maxRow);
+    this->rowCache.invalidate(row);
     }
 
   this->updatedEvents.clear();
-
-  if (changed)
-    {
-    emit this->dataChanged(this->index(minRow, 0),
-                           this->index(maxRow, NumColumns - 1));
-    }
+  this->emitChangedRows();
 }
 
 //-----------------------------------------------------------------------------
@@ -496,12 +456,12 @@ void vsEventTreeModel::removeEvent(vtkIdType eventId)
     return;
     }
 
-  QModelIndex index = this->indexOfEvent(eventId);
-  if (index.isValid())
+  const int row = this->rowCache.row(eventId);
+  if (row >= 0)
     {
-    int row = index.row();
     this->beginRemoveRows(QModelIndex(), row, row);
     this->events.removeAt(row);
+    this->rowCache.removeRow(row);
     this->endRemoveRows();
     }
 }
@@ -509,10 +469,86 @@ void vsEventTreeModel::removeEvent(vtkIdType eventId)
 //-----------------------------------------------------------------------------
 void vsEventTreeModel::update()
 {
-  // If the event model has been updated, conservatively assume that every
-  // event has been modified
-  emit this->dataChanged(this->index(0, 0),
-                         this->index(this->rowCount() - 1, NumColumns - 1));
+  // Conservatively assume that every event has been modified
+  this->rowCache.invalidateAll();
+  this->emitChangedRows();
+}
+
+//-----------------------------------------------------------------------------
+void vsEventTreeModel::updateScene(QSet<vtkIdType> eventIds, bool allEvents)
+{
+  if (allEvents)
+    {
+    this->update();
+    return;
+    }
+
+  foreach (vtkIdType eventId, eventIds)
+    {
+    const int row = this->rowCache.row(eventId);
+    if (row >= 0)
+      {
+      this->rowCache.invalidate(row);
+      }
+    }
+
+  this->emitChangedRows();
+}
+
+//-----------------------------------------------------------------------------
+void vsEventTreeModel::emitChangedRows()
+{
+  typedef vgRowCache<vtkIdType, DisplayValues>::Range Range;
+  foreach (const Range& range, this->rowCache.takeChanges())
+    {
+    emit this->dataChanged(this->index(range.first, 0),
+                           this->index(range.second, NumColumns - 1));
+    }
+}
+
+//-----------------------------------------------------------------------------
+const vsEventTreeModel::DisplayValues& vsEventTreeModel::displayValues(
+  int row) const
+{
+  vtkVgEvent* const event = this->events[row].Event;
+  const vtkIdType eventId = event->GetId();
+
+  if (const DisplayValues* const cached = this->rowCache.values(row))
+    {
+    return *cached;
+    }
+
+  DisplayValues values;
+
+  const int type = this->eventFilter->GetBestClassifier(event);
+  if (type == -1)
+    {
+    values.Type = "(none)";
+    values.Probability = QString::number(0.0, 'f', 4);
+    }
+  else
+    {
+    values.Type = this->eventTypeRegistry->GetTypeById(type).GetName();
+    values.Probability =
+      QString::number(event->GetProbability(type), 'f', 4);
+    }
+
+  values.StartTime = vgUnixTime(event->GetStartFrame().GetTime()).timeString();
+  values.EndTime = vgUnixTime(event->GetEndFrame().GetTime()).timeString();
+
+  const vsDisplayInfo& di = this->Scene->eventDisplayInfo(eventId);
+  values.Hidden = !di.Visible;
+  if (di.Color.isValid())
+    {
+    values.SwatchColor = di.Color.toQColor();
+    values.SwatchColor.setAlphaF(di.Visible ? 1.0 : 0.5);
+    }
+  else
+    {
+    values.SwatchColor = Qt::transparent;
+    }
+
+  return this->rowCache.setValues(row, values);
 }
 
 //-----------------------------------------------------------------------------
@@ -529,8 +565,7 @@ void vsEventTreeModel::setEventDisplayState(
 //-----------------------------------------------------------------------------
 bool vsEventTreeModel::isIndexHidden(const QModelIndex& index) const
 {
-  vtkVgEvent* event = this->events[index.row()].Event;
-  return !this->Scene->eventVisibility(event->GetId());
+  return this->displayValues(index.row()).Hidden;
 }
 
 //-----------------------------------------------------------------------------
@@ -561,37 +596,13 @@ QStringList vsEventTreeModel::mimeTypes() const
   return types;
 }
 
-//-----------------------------------------------------------------------------
-struct compareEventIds
-{
-  bool operator()(const vsEventUserInfo& a, vtkIdType b)
-    { return a.Event->GetId() < b; }
-  bool operator()(vtkIdType a, const vsEventUserInfo& b)
-    { return a < b.Event->GetId(); }
-};
-
 //-----------------------------------------------------------------------------
 QModelIndex vsEventTreeModel::indexOfEvent(vtkIdType eventId) const
 {
-  if (this->isSorted)
-    {
-    // We can do binary search
-    const QList<vsEventUserInfo>::const_iterator iter =
-      qBinaryFind(this->events.constBegin(), this->events.constEnd(),
-                  eventId, compareEventIds());
-    if (iter != this->events.constEnd())
-      {
-      return this->index(iter - this->events.constBegin(), 0);
-      }
-    }
-  else
+  const int row = this->rowCache.row(eventId);
+  if (row >= 0)
     {
-    // Not sorted by id, fall back to linear search
-    for (int i = 0, k = this->events.count(); i < k; ++i)
-      {
-      if (this->events[i].Event->GetId() == eventId)
-        return this->index(i, 0);
-      }
+    return this->index(row, 0);
     }
 
   qDebug() << "Event" << eventId << "not found in tree";
@@ -6,10 +6,14 @@
 #define __vsEventTreeModel_h
 
 #include <QAbstractItemModel>
+#include <QColor>
 #include <QIcon>
+#include <QSet>
 
 #include <qtGlobal.h>
 
+#include <vgRowCache.h>
+
 #include <vtkSmartPointer.h>
 
 #include "vsEventUserInfo.h"
@@ -109,12 +113,29 @@ public slots:
   void update();
 
 protected:
+  // Display values of an event which are costly to compute, cached until the
+  // event or its display changes
+  struct DisplayValues
+    {
+    QString Type;
+    QString Probability;
+    QString StartTime;
+    QString EndTime;
+    QColor SwatchColor;
+    bool Hidden;
+    };
+
   void setEventDisplayState(const QModelIndex& index, bool show);
 
   QPixmap colorSwatch(const QColor&) const;
 
+  const DisplayValues& displayValues(int row) const;
+
+  void emitChangedRows();
+
 protected slots:
   void deferredUpdateEvents();
+  void updateScene(QSet<vtkIdType> eventIds, bool allEvents);
 
 private:
   QTE_DISABLE_COPY(vsEventTreeModel)
@@ -132,7 +153,7 @@ private:
   QIcon yesIcon;
   QIcon noIcon;
 
-  bool isSorted;
+  vgRowCache<vtkIdType, DisplayValues> rowCache;
 };
 
 #endif
@@ -376,6 +376,8 @@ void vsScene::setupEventTree(
           this, SLOT(setEventStatus(vtkVgEvent*, int)));
   connect(d->Core, SIGNAL(eventRatingChanged(vtkVgEvent*, int)),
           d->EventTreeModel, SLOT(updateEvent(vtkVgEvent*)));
+  connect(d->Core, SIGNAL(eventNoteChanged(vtkVgEvent*, QString)),
+          d->EventTreeModel, SLOT(updateEvent(vtkVgEvent*)));
 
   connect(d->EventTreeSelectionModel, SIGNAL(selectionChanged(QSet<vtkIdType>)),
           this, SLOT(updateEventSelection(QSet<vtkIdType>)));
@@ -836,6 +838,7 @@ void vsScene::updateTrackSelection(QSet<vtkIdType> selectedIds)
     if (!selectedTracks.contains(track))
       {
       track->UseCustomColorOff();
+      d->ChangedTrackIds.insert(track->GetId());
       modified = true;
       }
     }
@@ -847,6 +850,7 @@ void vsScene::updateTrackSelection(QSet<vtkIdType> selectedIds)
       {
       track->SetCustomColor(d->SelectionColor.constData().array);
       track->UseCustomColorOn();
+      d->ChangedTrackIds.insert(track->GetId());
       modified = true;
       }
     }
@@ -886,6 +890,7 @@ void vsScene::updateEventSelection(QSet<vtkIdType> selectedIds)
     if (!selectedEvents.contains(event))
       {
       event->UseCustomColorOff();
+      d->ChangedEventIds.insert(event->GetId());
       modified = true;
       }
     }
@@ -897,6 +902,7 @@ void vsScene::updateEventSelection(QSet<vtkIdType> selectedIds)
       {
       event->SetCustomColor(d->SelectionColor.constData().array);
       event->UseCustomColorOn();
+      d->ChangedEventIds.insert(event->GetId());
       modified = true;
       }
     }
@@ -1511,8 +1517,8 @@ void vsScene::setSelectionColor(QColor color)
   QTE_D(vsScene);
   d->SelectionColor = color;
   // TODO update track/event colors
-  emit this->trackSceneUpdated();
-  emit this->eventSceneUpdated();
+  d->notifyTrackSceneChanged(true);
+  d->notifyEventSceneChanged(true);
 }
 
 //-----------------------------------------------------------------------------
@@ -2187,6 +2193,7 @@ void vsScene::setTrackDisplayState(vtkIdType trackId, bool state)
 
   d->NormalGraph.TrackModel->SetTrackDisplayState(trackId, state);
   d->GroundTruthGraph.TrackModel->SetTrackDisplayState(trackId, state);
+  d->ChangedTrackIds.insert(trackId);
   this->postUpdate();
 }
 
@@ -2269,6 +2276,7 @@ void vsScene::setEventDisplayState(vtkIdType eventId, bool state)
 
   d->NormalGraph.EventModel->SetEventDisplayState(eventId, state);
   d->GroundTruthGraph.EventModel->SetEventDisplayState(eventId, state);
+  d->ChangedEventIds.insert(eventId);
   this->postUpdate();
 }
 
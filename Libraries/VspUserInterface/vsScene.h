@@ -145,6 +145,11 @@ signals:
   void trackSceneUpdated();
   void eventSceneUpdated();
 
+  // Emitted when the display of specific tracks or events has changed, or,
+  // if \p allTracks / \p allEvents is \c true, when any may have changed
+  void trackSceneChanged(QSet<vtkIdType> trackIds, bool allTracks);
+  void eventSceneChanged(QSet<vtkIdType> eventIds, bool allEvents);
+
   void alertThresholdChanged(int id, double);
 
 public slots:
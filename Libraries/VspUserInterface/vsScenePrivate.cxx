@@ -633,10 +633,13 @@ bool vsScenePrivate::updateModels(Graph& graph, bool forceUpdate)
 
   // Only notify that the event scene has changed in case of a change to the
   // type registry, event filter, or the event model (not counting normal
-  // updates)
-  const bool notifyEventSceneUpdated =
+  // updates); a change to the type registry or event filter may affect any
+  // event, while other changes are those recorded in the change set
+  const bool allEventsChanged =
     forceUpdate ||
-    this->EventFilter->GetMTime() >  graph.EventRepresentationsUpdateTime ||
+    this->EventFilter->GetMTime() >  graph.EventRepresentationsUpdateTime;
+  const bool notifyEventSceneUpdated =
+    allEventsChanged ||
     graph.EventModel->GetMTime() > graph.EventModel->GetUpdateTime();
 
   bool updated =
@@ -645,8 +648,7 @@ bool vsScenePrivate::updateModels(Graph& graph, bool forceUpdate)
                        graph.EventRepresentationsUpdateTime, forceUpdate);
   if (notifyEventSceneUpdated)
     {
-    QTE_Q(vsScene);
-    emit q->eventSceneUpdated();
+    this->notifyEventSceneChanged(allEventsChanged);
     }
 
   // Tracks
@@ -663,8 +665,10 @@ bool vsScenePrivate::updateModels(Graph& graph, bool forceUpdate)
 
   // Only notify that the track scene has changed in case of a change to the
   // track filter or the model (not counting normal updates)
+  const bool allTracksChanged =
+    this->TrackFilter->GetMTime() > graph.TrackRepresentationsUpdateTime;
   const bool notifyTrackSceneUpdated =
-    this->TrackFilter->GetMTime() > graph.TrackRepresentationsUpdateTime ||
+    allTracksChanged ||
     graph.TrackModel->GetMTime() > graph.TrackModel->GetUpdateTime();
 
   updated =
@@ -674,8 +678,7 @@ bool vsScenePrivate::updateModels(Graph& graph, bool forceUpdate)
                        updated || forceUpdate) || updated;
   if (notifyTrackSceneUpdated)
     {
-    QTE_Q(vsScene);
-    emit q->trackSceneUpdated();
+    this->notifyTrackSceneChanged(allTracksChanged);
     }
 
   return updated;
@@ -769,8 +772,6 @@ bool vsScenePrivate::updateModels(
 //-----------------------------------------------------------------------------
 void vsScenePrivate::updateTrackColors()
 {
-  QTE_Q(vsScene);
-
   this->TrackColors.clear();
   foreach (vsTrackInfo ti, vsTrackInfo::trackTypes())
     {
@@ -792,7 +793,27 @@ void vsScenePrivate::updateTrackColors()
   setHelperForGraph(this->NormalGraph, helper);
   setHelperForGraph(this->GroundTruthGraph, helper);
 
+  this->notifyTrackSceneChanged(true);
+}
+
+//-----------------------------------------------------------------------------
+void vsScenePrivate::notifyTrackSceneChanged(bool allTracks)
+{
+  QTE_Q(vsScene);
+
   emit q->trackSceneUpdated();
+  emit q->trackSceneChanged(this->ChangedTrackIds, allTracks);
+  this->ChangedTrackIds.clear();
+}
+
+//-----------------------------------------------------------------------------
+void vsScenePrivate::notifyEventSceneChanged(bool allEvents)
+{
+  QTE_Q(vsScene);
+
+  emit q->eventSceneUpdated();
+  emit q->eventSceneChanged(this->ChangedEventIds, allEvents);
+  this->ChangedEventIds.clear();
 }
 
 //-----------------------------------------------------------------------------
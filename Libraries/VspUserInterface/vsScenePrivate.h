@@ -174,6 +174,9 @@ public:
 
   void updateTrackColors();
 
+  void notifyTrackSceneChanged(bool allTracks);
+  void notifyEventSceneChanged(bool allEvents);
+
   vtkVgTrackInfo trackInfo(vtkIdType trackId);
   vtkVgEventInfo eventInfo(vtkIdType eventId);
 
@@ -211,6 +214,11 @@ public:
   QSet<vtkVgTrack*> SelectedTracks;
   QSet<vtkVgEvent*> SelectedEvents;
 
+  // Tracks and events whose display has changed since the scene was last
+  // updated
+  QSet<vtkIdType> ChangedTrackIds;
+  QSet<vtkIdType> ChangedEventIds;
+
   vgColor FilteringMaskColor;
   vtkVgInstance<vtkAssembly> FilterMaskProps;
   vtkVgInstance<vtkAssembly> SelectorMaskProps;
@@ -0,0 +1,38 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsTrackStateTransform.h"
+
+#include <vtkMatrix4x4.h>
+
+//-----------------------------------------------------------------------------
+vsTrackStateTransform::vsTrackStateTransform(const vtkMatrix4x4& homography)
+{
+  const double (*e)[4] = homography.Element;
+  double* const c = this->Coefficients;
+  c[0] = e[0][0]; c[1] = e[0][1]; c[2] = e[0][3];
+  c[3] = e[1][0]; c[4] = e[1][1]; c[5] = e[1][3];
+  c[6] = e[3][0]; c[7] = e[3][1]; c[8] = e[3][3];
+}
+
+//-----------------------------------------------------------------------------
+void vsTrackStateTransform::mapObject(
+  const vvImagePolygonF& in, QVector<float>& object, QPolygonF& polygon) const
+{
+  const int k = static_cast<int>(in.size());
+  object.resize(3 * k);
+  polygon.resize(k);
+
+  float* const op = object.data();
+  QPointF* const pp = polygon.data();
+  for (int n = 0; n < k; ++n)
+    {
+    double x, y;
+    this->map(in[n].X, in[n].Y, x, y);
+    op[(3 * n) + 0] = static_cast<float>(x);
+    op[(3 * n) + 1] = static_cast<float>(y);
+    op[(3 * n) + 2] = 0.0f;
+    pp[n] = QPointF(x, y);
+    }
+}
@@ -0,0 +1,53 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsTrackStateTransform_h
+#define __vsTrackStateTransform_h
+
+#include <QPolygonF>
+#include <QVector>
+
+#include <vvTrack.h>
+
+#include <vgExport.h>
+
+#include <cmath>
+
+class vtkMatrix4x4;
+
+// Mapping of track state coordinates from image to stabilized space.
+//
+// Only the x, y and w rows and columns of the homography take part in mapping
+// a 2D point, so those are extracted once when the transform is created,
+// rather than going through a full 4x4 multiply for every point.
+class VSP_USERINTERFACE_EXPORT vsTrackStateTransform
+{
+public:
+  explicit vsTrackStateTransform(const vtkMatrix4x4& homography);
+
+  void map(double x, double y, double& outX, double& outY) const;
+
+  // Map the points of \p in. The points are written to \p object as
+  // (x, y, 0) triples, as expected by vtkVgTrack::SetPoint, and to
+  // \p polygon. Both are resized to fit, so that a buffer reused across
+  // states is only reallocated when it needs to grow.
+  void mapObject(const vvImagePolygonF& in,
+                 QVector<float>& object, QPolygonF& polygon) const;
+
+protected:
+  double Coefficients[9];
+};
+
+//-----------------------------------------------------------------------------
+inline void vsTrackStateTransform::map(
+  double x, double y, double& outX, double& outY) const
+{
+  const double* const c = this->Coefficients;
+  const double w = c[6] * x + c[7] * y + c[8];
+  const double wi = (fabs(w) > 1e-10 ? 1.0 / w : 1.0);
+  outX = (c[0] * x + c[1] * y + c[2]) * wi;
+  outY = (c[3] * x + c[4] * y + c[5]) * wi;
+}
+
+#endif
@@ -17,9 +17,6 @@
 #include <vtkVgTrackFilter.h>
 #include <vtkVgTypeDefs.h>
 
-#include <algorithm>
-#include <vector>
-
 #include <vsDisplayInfo.h>
 
 #include "vsCore.h"
@@ -30,10 +27,12 @@ vsTrackTreeModel::vsTrackTreeModel(
   vsCore* core, vsScene* scene, vtkVgTrackFilter* trackFilter,
   QObject* parent)
   : QAbstractItemModel(parent), Core(core), Scene(scene),
-    trackFilter(trackFilter), swatchCache(core->swatchCache()),
-    isSorted(true)
+    trackFilter(trackFilter), swatchCache(core->swatchCache())
 {
-  connect(scene, SIGNAL(trackSceneUpdated()), this, SLOT(update()));
+  connect(scene, SIGNAL(trackSceneChanged(QSet<vtkIdType>, bool)),
+          this, SLOT(updateScene(QSet<vtkIdType>, bool)));
+  connect(core, SIGNAL(trackNoteChanged(vtkVgTrack*, QString)),
+          this, SLOT(updateTrack(vtkVgTrack*)));
 }
 
 //-----------------------------------------------------------------------------
@@ -75,44 +74,16 @@ QVariant vsTrackTreeModel::data(const QModelIndex& index, int role) const
           return track->GetName();
 
         case TrackTypeColumn:
-          {
-          int type = this->trackFilter->GetBestClassifier(track);
-          switch (type)
-            {
-            case vtkVgTrack::Person:       return "Person";
-            case vtkVgTrack::Vehicle:      return "Vehicle";
-            case vtkVgTrack::Other:        return "Other";
-            case vtkVgTrack::Unclassified: return "Unclassified";
-            }
-          return "(none)";
-          }
+          return this->displayValues(index.row()).Type;
 
         case ProbabilityColumn:
-          {
-          int type = this->trackFilter->GetBestClassifier(track);
-
-          double probability;
-          if (type == -1 || type == vtkVgTrack::Unclassified)
-            {
-            probability = 0.0;
-            }
-          else
-            {
-            probability = track->GetPVO()[type];
-            }
-
-          return QString::number(probability, 'f', 4);
-          }
+          return this->displayValues(index.row()).Probability;
 
         case StartTimeColumn:
-          return track->IsStarted()
-            ? vgUnixTime(track->GetStartFrame().GetTime()).timeString()
-            : QString("unknown");
+          return this->displayValues(index.row()).StartTime;
 
         case EndTimeColumn:
-          return track->IsStarted()
-              ? vgUnixTime(track->GetEndFrame().GetTime()).timeString()
-              : QString("unknown");
+          return this->displayValues(index.row()).EndTime;
 
         case NoteColumn:
           return QString::fromLocal8Bit(track->GetNote());
@@ -122,14 +93,8 @@ QVariant vsTrackTreeModel::data(const QModelIndex& index, int role) const
     case Qt::DecorationRole:
       if (index.column() == TrackTypeColumn)
         {
-        const vsDisplayInfo& di = this->Scene->trackDisplayInfo(track->GetId());
-        if (di.Color.isValid())
-          {
-          QColor color = di.Color.toQColor();
-          color.setAlphaF(di.Visible ? 1.0 : 0.5);
-          return this->swatchCache.swatch(color);
-          }
-        return this->swatchCache.swatch(Qt::transparent);
+        const QColor& color = this->displayValues(index.row()).SwatchColor;
+        return this->swatchCache.swatch(color);
         }
       else if (index.column() == StarColumn)
         {
@@ -325,10 +290,6 @@ void vsTrackTreeModel::updateTrack(vtkVgTrack* track)
 //-----------------------------------------------------------------------------
 void vsTrackTreeModel::deferredUpdateTracks()
 {
-  bool changed = false;
-  int minRow = this->rowCount() - 1;
-  int maxRow = 0;
-
   // Flush any new additions first, as we might also have updates for the new
   // tracks
   if (!this->addedTracks.isEmpty())
@@ -340,48 +301,30 @@ void vsTrackTreeModel::deferredUpdateTracks()
     typedef QMap<vtkIdType, vtkVgTrack*>::const_iterator Iterator;
     foreach_iter (Iterator, iter, this->addedTracks)
       {
-      vtkVgTrack* prev = this->tracks.isEmpty() ? 0 : this->tracks.back();
+      this->rowCache.append(iter.key());
       this->tracks.append(iter.value());
-
-      // Check if ordering has been violated... we assume that the ID of a
-      // track will not change once it has been added, so this check should be
-      // sufficient
-      if (prev && this->isSorted && iter.key() < prev->GetId())
-        {
-        this->isSorted = false;
-        qWarning() << "Track tree IDs are not in sorted order; "
-                      "falling back to linear search";
-        }
       }
 
     this->addedTracks.clear();
     this->endInsertRows();
     }
 
-  // Update track pointers and compute the model rows covered by the tracks
+  // Update track pointers and collect the model rows of the tracks
   foreach (vtkVgTrack* track, this->updatedTracks)
     {
-    QModelIndex index = this->indexOfTrack(track->GetId());
-    if (!index.isValid())
+    const vtkIdType trackId = track->GetId();
+    const int row = this->rowCache.row(trackId);
+    if (row < 0)
       {
       continue;
       }
 
-    changed = true;
-    const int row = index.row();
     this->tracks[row] = track;
-
-    minRow = qMin(row, minRow);
-    maxRow = qMax(row, maxRow);
+    this->rowCache.invalidate(row);
     }
 
   this->updatedTracks.clear();
-
-  if (changed)
-    {
-    emit this->dataChanged(this->index(minRow, 0),
-                           this->index(maxRow, NumColumns - 1));
-    }
+  this->emitChangedRows();
 }
 
 //-----------------------------------------------------------------------------
@@ -394,12 +337,12 @@ void vsTrackTreeModel::removeTrack(vtkIdType trackId)
     return;
     }
 
-  QModelIndex index = this->indexOfTrack(trackId);
-  if (index.isValid())
+  const int row = this->rowCache.row(trackId);
+  if (row >= 0)
     {
-    int row = index.row();
     this->beginRemoveRows(QModelIndex(), row, row);
     this->tracks.removeAt(row);
+    this->rowCache.removeRow(row);
     this->endRemoveRows();
     }
 }
@@ -407,10 +350,103 @@ void vsTrackTreeModel::removeTrack(vtkIdType trackId)
 //-----------------------------------------------------------------------------
 void vsTrackTreeModel::update()
 {
-  // If the track model has been updated, conservatively assume that every
-  // track has been modified
-  emit this->dataChanged(this->index(0, 0),
-                         this->index(this->rowCount() - 1, NumColumns - 1));
+  // Conservatively assume that every track has been modified
+  this->rowCache.invalidateAll();
+  this->emitChangedRows();
+}
+
+//-----------------------------------------------------------------------------
+void vsTrackTreeModel::updateScene(QSet<vtkIdType> trackIds, bool allTracks)
+{
+  if (allTracks)
+    {
+    this->update();
+    return;
+    }
+
+  foreach (vtkIdType trackId, trackIds)
+    {
+    const int row = this->rowCache.row(trackId);
+    if (row >= 0)
+      {
+      this->rowCache.invalidate(row);
+      }
+    }
+
+  this->emitChangedRows();
+}
+
+//-----------------------------------------------------------------------------
+void vsTrackTreeModel::emitChangedRows()
+{
+  typedef vgRowCache<vtkIdType, DisplayValues>::Range Range;
+  foreach (const Range& range, this->rowCache.takeChanges())
+    {
+    emit this->dataChanged(this->index(range.first, 0),
+                           this->index(range.second, NumColumns - 1));
+    }
+}
+
+//-----------------------------------------------------------------------------
+const vsTrackTreeModel::DisplayValues& vsTrackTreeModel::displayValues(
+  int row) const
+{
+  vtkVgTrack* const track = this->tracks[row];
+  const vtkIdType trackId = track->GetId();
+
+  if (const DisplayValues* const cached = this->rowCache.values(row))
+    {
+    return *cached;
+    }
+
+  DisplayValues values;
+
+  const int type = this->trackFilter->GetBestClassifier(track);
+  switch (type)
+    {
+    case vtkVgTrack::Person:       values.Type = "Person"; break;
+    case vtkVgTrack::Vehicle:      values.Type = "Vehicle"; break;
+    case vtkVgTrack::Other:        values.Type = "Other"; break;
+    case vtkVgTrack::Unclassified: values.Type = "Unclassified"; break;
+    default:                       values.Type = "(none)"; break;
+    }
+
+  double probability;
+  if (type == -1 || type == vtkVgTrack::Unclassified)
+    {
+    probability = 0.0;
+    }
+  else
+    {
+    probability = track->GetPVO()[type];
+    }
+  values.Probability = QString::number(probability, 'f', 4);
+
+  if (track->IsStarted())
+    {
+    values.StartTime =
+      vgUnixTime(track->GetStartFrame().GetTime()).timeString();
+    values.EndTime =
+      vgUnixTime(track->GetEndFrame().GetTime()).timeString();
+    }
+  else
+    {
+    values.StartTime = values.EndTime = "unknown";
+    }
+
+  const vsDisplayInfo& di = this->Scene->trackDisplayInfo(trackId);
+  values.Hidden = !di.Visible;
+  if (di.Color.isValid())
+    {
+    values.SwatchColor = di.Color.toQColor();
+    values.SwatchColor.setAlphaF(di.Visible ? 1.0 : 0.5);
+    }
+  else
+    {
+    values.SwatchColor = Qt::transparent;
+    }
+
+  return this->rowCache.setValues(row, values);
 }
 
 //-----------------------------------------------------------------------------
@@ -427,41 +463,16 @@ void vsTrackTreeModel::setTrackDisplayState(
 //-----------------------------------------------------------------------------
 bool vsTrackTreeModel::isIndexHidden(const QModelIndex& index) const
 {
-  vtkVgTrack* track = this->tracks[index.row()];
-  return !this->Scene->trackVisibility(track->GetId());
+  return this->displayValues(index.row()).Hidden;
 }
 
-//-----------------------------------------------------------------------------
-struct compareTrackIds
-{
-  bool operator()(vtkVgTrack* a, vtkIdType b)
-    { return a->GetId() < b; }
-  bool operator()(vtkIdType a, vtkVgTrack* b)
-    { return a < b->GetId(); }
-};
-
 //-----------------------------------------------------------------------------
 QModelIndex vsTrackTreeModel::indexOfTrack(vtkIdType trackId) const
 {
-  if (this->isSorted)
-    {
-    // We can do binary search
-    const QList<vtkVgTrack*>::const_iterator iter =
-      qBinaryFind(this->tracks.constBegin(), this->tracks.constEnd(),
-                  trackId, compareTrackIds());
-    if (iter != this->tracks.constEnd())
-      {
-      return this->index(iter - this->tracks.constBegin(), 0);
-      }
-    }
-  else
+  const int row = this->rowCache.row(trackId);
+  if (row >= 0)
     {
-    // Not sorted by id, fall back to linear search
-    for (int i = 0, k = this->tracks.count(); i < k; ++i)
-      {
-      if (this->tracks[i]->GetId() == trackId)
-        return this->index(i, 0);
-      }
+    return this->index(row, 0);
     }
 
   qDebug() << "Track" << trackId << "not found in tree";
@@ -7,13 +7,16 @@
 
 #include <vsTrackId.h>
 
+#include <vgRowCache.h>
+
 #include <qtGlobal.h>
 
 #include <vtkSmartPointer.h>
 
 #include <QAbstractItemModel>
+#include <QColor>
+#include <QSet>
 
-class QColor;
 class QPixmap;
 
 class vgSwatchCache;
@@ -93,12 +96,29 @@ public slots:
   void update();
 
 protected:
+  // Display values of a track which are costly to compute, cached until the
+  // track or its display changes
+  struct DisplayValues
+    {
+    QString Type;
+    QString Probability;
+    QString StartTime;
+    QString EndTime;
+    QColor SwatchColor;
+    bool Hidden;
+    };
+
   void setTrackDisplayState(const QModelIndex& index, bool show);
 
   QPixmap colorSwatch(const QColor&) const;
 
+  const DisplayValues& displayValues(int row) const;
+
+  void emitChangedRows();
+
 protected slots:
   void deferredUpdateTracks();
+  void updateScene(QSet<vtkIdType> trackIds, bool allTracks);
 
 private:
   QTE_DISABLE_COPY(vsTrackTreeModel)
@@ -113,7 +133,7 @@ private:
   QMap<vtkIdType, vtkVgTrack*> addedTracks;
   QList<vtkVgTrack*> updatedTracks;
 
-  bool isSorted;
+  vgRowCache<vtkIdType, DisplayValues> rowCache;
 };
 
 Q_DECLARE_METATYPE(vsTrackId)
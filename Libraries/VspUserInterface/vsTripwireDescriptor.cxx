@@ -216,10 +216,6 @@ void vsTripwireDescriptorPrivate::updateTrack(
       previousPt, pt, previousTimeStamp, state->time, intersections);
     this->processIntersections(intersections, track, id);
 
-    // \NOTE For performance, it would be best to calculate a bounding
-    //       box for the track segment, and compare that to the bounding box
-    //       (precomputed!) of each known region before progressing to a full
-    //       intersection test.
     // \NOTE DO NOT assume that states will arrive in order; this should be
     //       true at the moment, but is expected to change in the future. This
     //       does mean that the arrival of a new segment could mean than an
@@ -0,0 +1,311 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <qtTest.h>
+
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+#include <cmath>
+#include <cstring>
+
+#include "vtkVgTimeStamp.h"
+#include "vtkVgVideoCache.h"
+#include "vtkVgVideoFrame.h"
+
+//-----------------------------------------------------------------------------
+class TestVideoSource : public vtkVgVideoSourceBase
+{
+public:
+  static TestVideoSource* New() { return new TestVideoSource; }
+  vtkTypeMacro(TestVideoSource, vtkVgVideoSourceBase);
+
+  static vtkVgTimeStamp FrameTime(int n)
+    { return vtkVgTimeStamp(n * 1e6, n); }
+
+  virtual vtkVgTimeStamp ResolveSeek(
+    const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+    {
+    const double pos = ts.GetTime() * 1e-6;
+    int n;
+    switch (direction)
+      {
+      case vg::SeekExact:
+        n = static_cast<int>(pos);
+        if (n != pos)
+          {
+          return vtkVgTimeStamp();
+          }
+        break;
+      case vg::SeekLowerBound: n = static_cast<int>(std::ceil(pos)); break;
+      case vg::SeekUpperBound: n = static_cast<int>(std::floor(pos)); break;
+      case vg::SeekNext: n = static_cast<int>(std::floor(pos)) + 1; break;
+      case vg::SeekPrevious: n = static_cast<int>(std::ceil(pos)) - 1; break;
+      default:
+        n = static_cast<int>(std::floor(pos + 0.5));
+        n = (n < 0 ? 0 : n >= this->Count ? this->Count - 1 : n);
+        break;
+      }
+    return (n >= 0 && n < this->Count) ? FrameTime(n) : vtkVgTimeStamp();
+    }
+
+  virtual vtkVgVideoFrame GetFrame(
+    const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+    {
+    vtkVgVideoFrame frame;
+    const vtkVgTimeStamp resolved = this->ResolveSeek(ts, direction);
+    if (resolved.IsValid())
+      {
+      ++this->Decodes;
+      frame.Image->SetDimensions(64, 64, 1);
+      frame.Image->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+      memset(frame.Image->GetScalarPointer(), 0, 64 * 64);
+      frame.MetaData.Time = resolved;
+      }
+    return frame;
+    }
+
+  virtual vtkVgVideoFrameMetaData GetMetadata(
+    const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+    {
+    vtkVgVideoFrameMetaData md;
+    md.Time = this->ResolveSeek(ts, direction);
+    return md;
+    }
+
+  virtual vtkVgTimeStamp GetMinTime() const
+    { return FrameTime(0); }
+  virtual vtkVgTimeStamp GetMaxTime() const
+    { return FrameTime(this->Count - 1); }
+  virtual int GetFrameCount() const
+    { return this->Count; }
+
+  int Count;
+  mutable int Decodes;
+
+protected:
+  TestVideoSource() : Count(20), Decodes(0) {}
+};
+
+typedef vtkSmartPointer<TestVideoSource> SourcePtr;
+
+//-----------------------------------------------------------------------------
+int getFrame(vtkVgVideoCache* cache, int n)
+{
+  const vtkVgVideoFrame frame =
+    cache->GetFrame(TestVideoSource::FrameTime(n), vg::SeekExact);
+  return static_cast<int>(frame.MetaData.Time.GetFrameNumber());
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 setBudgetInFrames(vtkVgVideoCache* cache, int frames)
+{
+  // Measure the size of one frame, then size the budget to hold the
+  // requested number of frames
+  cache->Clear();
+  getFrame(cache, 0);
+  const vtkTypeInt64 frameSize = cache->GetCachedBytes();
+  cache->Clear();
+  cache->ResetStatistics();
+  cache->SetMemoryBudget(frames * frameSize);
+  return frameSize;
+}
+
+//-----------------------------------------------------------------------------
+int testHitMiss(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+
+  TEST_EQUAL(getFrame(cache, 2), 2);
+  TEST_EQUAL(getFrame(cache, 2), 2);
+  TEST_EQUAL(cache->GetMissCount(), 1);
+  TEST_EQUAL(cache->GetHitCount(), 1);
+  TEST_EQUAL(source->Decodes, 1);
+
+  // A non-exact seek resolving to a cached frame is also a hit
+  cache->GetFrame(vtkVgTimeStamp(2.4e6), vg::SeekNearest);
+  TEST_EQUAL(cache->GetHitCount(), 2);
+  TEST_EQUAL(source->Decodes, 1);
+
+  // Requests for frames that do not exist are misses and are not cached
+  TEST(!cache->GetFrame(TestVideoSource::FrameTime(50),
+                        vg::SeekExact).MetaData.Time.IsValid());
+  TEST_EQUAL(cache->GetCachedFrameCount(), 1);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testCopies(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+
+  // Write through a shallow copy of the returned image, as a consumer that
+  // does not go through vtkVgSharedInstance might; the cached frame must not
+  // change, whether the frame was returned from a miss or from a hit
+  for (int i = 0; i < 2; ++i)
+    {
+    const vtkVgVideoFrame frame =
+      cache->GetFrame(TestVideoSource::FrameTime(4), vg::SeekExact);
+    vtkNew<vtkImageData> alias;
+    alias->ShallowCopy(
+      const_cast<vtkImageData*>(frame.Image.GetVolatileConstPointer()));
+    *static_cast<unsigned char*>(alias->GetScalarPointer(1, 1, 0)) = 255;
+    }
+
+  const vtkVgVideoFrame frame =
+    cache->GetFrame(TestVideoSource::FrameTime(4), vg::SeekExact);
+  vtkImageData* image =
+    const_cast<vtkImageData*>(frame.Image.GetVolatileConstPointer());
+  const unsigned char* pixel =
+    static_cast<unsigned char*>(image->GetScalarPointer(1, 1, 0));
+  TEST_EQUAL(static_cast<int>(*pixel), 0);
+  TEST_EQUAL(cache->GetHitCount(), 2);
+  TEST_EQUAL(source->Decodes, 1);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testLruEviction(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+  cache->SetEvictionPolicyToLeastRecentlyUsed();
+  const vtkTypeInt64 frameSize = setBudgetInFrames(cache, 3);
+
+  getFrame(cache, 0);
+  getFrame(cache, 1);
+  getFrame(cache, 2);
+  getFrame(cache, 0); // Make 1 the least recently used
+  getFrame(cache, 3);
+  TEST_EQUAL(cache->GetEvictionCount(), 1);
+  TEST_EQUAL(cache->GetCachedFrameCount(), 3);
+  TEST_EQUAL(cache->GetCachedBytes(), 3 * frameSize);
+
+  cache->ResetStatistics();
+  getFrame(cache, 0);
+  TEST_EQUAL(cache->GetHitCount(), 1);
+  getFrame(cache, 1);
+  TEST_EQUAL(cache->GetMissCount(), 1);
+
+  // Shrinking the budget evicts immediately
+  cache->SetMemoryBudget(frameSize);
+  TEST_EQUAL(cache->GetCachedFrameCount(), 1);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testWindowEviction(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+  cache->SetEvictionPolicyToPrefetchWindow();
+  setBudgetInFrames(cache, 3);
+
+  getFrame(cache, 5);
+  getFrame(cache, 6);
+  getFrame(cache, 7);
+  getFrame(cache, 5); // Under LRU, this would protect 5 and evict 6
+  getFrame(cache, 8);
+
+  // Play head is at 8, so 5 is the farthest frame and should be evicted
+  cache->ResetStatistics();
+  getFrame(cache, 7);
+  getFrame(cache, 6);
+  TEST_EQUAL(cache->GetHitCount(), 2);
+  getFrame(cache, 5);
+  TEST_EQUAL(cache->GetMissCount(), 1);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testRequestRange(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+
+  cache->RequestRange(TestVideoSource::FrameTime(2),
+                      TestVideoSource::FrameTime(6));
+  cache->WaitForPendingRequests();
+  TEST_EQUAL(cache->GetCachedFrameCount(), 5);
+  TEST_EQUAL(cache->GetPrefetchedCount(), 5);
+
+  for (int n = 2; n <= 6; ++n)
+    {
+    getFrame(cache, n);
+    }
+  TEST_EQUAL(cache->GetHitCount(), 5);
+  TEST_EQUAL(cache->GetMissCount(), 0);
+  TEST_EQUAL(source->Decodes, 5);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testPrefetch(qtTest& testObject)
+{
+  SourcePtr source = SourcePtr::New();
+  vtkVgVideoCache::SmartPtr cache = vtkVgVideoCache::SmartPtr::New();
+  cache->SetVideoSource(source);
+  cache->SetPrefetchCount(3);
+
+  // Play forward; following frames should be loaded in the background
+  getFrame(cache, 10);
+  cache->WaitForPendingRequests();
+  TEST_EQUAL(cache->GetCachedFrameCount(), 4);
+  getFrame(cache, 11);
+  getFrame(cache, 12);
+  getFrame(cache, 13);
+  cache->WaitForPendingRequests();
+  TEST_EQUAL(cache->GetMissCount(), 1);
+  TEST_EQUAL(cache->GetHitCount(), 3);
+
+  // Step backward; prefetch should follow the direction of play
+  cache->SetVideoSource(0);
+  cache->SetVideoSource(source);
+  cache->ResetStatistics();
+  getFrame(cache, 10);
+  cache->WaitForPendingRequests();
+  getFrame(cache, 9);
+  cache->WaitForPendingRequests();
+  getFrame(cache, 8);
+  getFrame(cache, 7);
+  getFrame(cache, 6);
+  TEST_EQUAL(cache->GetMissCount(), 2);
+  TEST_EQUAL(cache->GetHitCount(), 3);
+
+  // Prefetch must stop at the end of the video
+  getFrame(cache, 19);
+  cache->WaitForPendingRequests();
+  TEST(cache->GetPrefetchedCount() > 0);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Hits and Misses",          testHitMiss);
+  testObject.runSuite("Frame Copies",             testCopies);
+  testObject.runSuite("LRU Eviction",             testLruEviction);
+  testObject.runSuite("Prefetch Window Eviction", testWindowEviction);
+  testObject.runSuite("Background Range Load",    testRequestRange);
+  testObject.runSuite("Prefetch",                 testPrefetch);
+  return testObject.result();
+}
@@ -514,6 +514,7 @@ void vtkVgActivity::AddEvent(vtkVgEvent* theEvent)
   theEvent->GetFullBounds(bounds);
   this->Internal->BoundingBox.AddBounds(bounds);
   this->Internal->BoundingBox.GetBounds(bounds);
+  this->Modified();
 
   // rebuild the representation
   if (this->Actor)
@@ -532,6 +533,7 @@ void vtkVgActivity::RemoveEvent(unsigned int index)
 {
   this->Internal->Events.erase(this->Internal->Events.begin() + index);
   this->UpdateFrameExtentsAndBounds();
+  this->Modified();
 
   // rebuild the representation
   if (this->Actor)
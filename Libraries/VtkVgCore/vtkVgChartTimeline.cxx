@@ -74,6 +74,8 @@ vtkStandardNewMacro(vtkVgChartTimeline);
 //-----------------------------------------------------------------------------
 vtkVgChartTimeline::vtkVgChartTimeline()
 {
+  this->PlotTransform = vtkTransform2D::New();
+
   this->GetAxis(vtkAxis::BOTTOM)->SetBehavior(vtkAxis::CUSTOM);
   this->GetAxis(vtkAxis::BOTTOM)->SetRange(0.0, 1.0);
 
@@ -119,6 +121,7 @@ vtkVgChartTimeline::vtkVgChartTimeline()
 vtkVgChartTimeline::~vtkVgChartTimeline()
 {
   this->xAxis2->Delete();
+  this->PlotTransform->Delete();
 }
 
 //-----------------------------------------------------------------------------
@@ -677,12 +680,7 @@ bool vtkVgChartTimeline::UpdateTooltip(const vtkContextMouseEvent& mouse)
   int plots = this->GetNumberOfPlots();
   if (plots)
     {
-    // @TODO: Since vtkChartXY keeps its transforms private, we have to
-    // recalculate the transform every time the mouse moves. We need access to
-    // the private transforms, or at least know when they have been invalidated.
-    vtkTransform2D* transform = vtkTransform2D::New();
-    this->CalculatePlotTransform(this->GetAxis(vtkAxis::BOTTOM),
-                                 this->GetAxis(vtkAxis::LEFT), transform);
+    vtkTransform2D* transform = this->GetPlotTransform();
 
     vtkVector2f position;
     transform->InverseTransformPoints(mouse.GetPos().GetData(),
@@ -691,7 +689,6 @@ bool vtkVgChartTimeline::UpdateTooltip(const vtkContextMouseEvent& mouse)
     // use a tolerance of +/- 5 pixels
     vtkVector2f tolerance(5 * (1.0 / transform->GetMatrix()->GetElement(0, 0)),
                           5 * (1.0 / transform->GetMatrix()->GetElement(1, 1)));
-    transform->Delete();
 
     // search for hits
     for (int j = 0; j < plots; ++j)
@@ -755,6 +752,24 @@ bool vtkVgChartTimeline::UpdateTooltip(const vtkContextMouseEvent& mouse)
   return false;
 }
 
+//-----------------------------------------------------------------------------
+vtkTransform2D* vtkVgChartTimeline::GetPlotTransform()
+{
+  // The plot transform depends only on the ranges and positions of the axes,
+  // so it only needs to be recalculated when one of them changes, rather than
+  // on every mouse event
+  vtkAxis* const xAxis = this->GetAxis(vtkAxis::BOTTOM);
+  vtkAxis* const yAxis = this->GetAxis(vtkAxis::LEFT);
+  if (this->PlotTransformTime < xAxis->GetMTime() ||
+      this->PlotTransformTime < yAxis->GetMTime() ||
+      this->PlotTransformTime < this->GetMTime())
+    {
+    this->CalculatePlotTransform(xAxis, yAxis, this->PlotTransform);
+    this->PlotTransformTime.Modified();
+    }
+  return this->PlotTransform;
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgChartTimeline::DoSelect(const vtkContextMouseEvent& mouse,
                                   bool activate)
@@ -765,10 +780,7 @@ void vtkVgChartTimeline::DoSelect(const vtkContextMouseEvent& mouse,
   int plots = this->GetNumberOfPlots();
   if (plots)
     {
-    vtkTransform2D* transform = vtkTransform2D::New();
-    this->CalculatePlotTransform(this->GetAxis(vtkAxis::BOTTOM),
-                                 this->GetAxis(vtkAxis::LEFT),
-                                 transform);
+    vtkTransform2D* transform = this->GetPlotTransform();
 
     // check within a 5 pixel radius of the click
     float tol = 5.0f;
@@ -813,7 +825,6 @@ void vtkVgChartTimeline::DoSelect(const vtkContextMouseEvent& mouse,
           }
         }
       }
-    transform->Delete();
     }
 
   // NOTE: If plotChanged is still not initialized, then I am not sure if the
@@ -20,6 +20,7 @@
 
 class vtkIdTypeArray;
 class vtkPlot;
+class vtkTransform2D;
 
 class VTKVG_CORE_EXPORT vtkVgChartTimeline : public vtkChartXY
 {
@@ -113,6 +114,7 @@ protected:
 private:
   void MakePointVisible(float x, float y);
   bool UpdateTooltip(const vtkContextMouseEvent& mouse);
+  vtkTransform2D* GetPlotTransform();
   void BuildXColumn();
   void NormalizeXAxis();
 
@@ -125,6 +127,11 @@ private:
   vtkTimeStamp DataBuildTime;
   vtkTimeStamp AxisBuildTime;
 
+  // Cached plot transform for mouse interaction, since vtkChartXY keeps its
+  // own transforms private
+  vtkTransform2D* PlotTransform;
+  vtkTimeStamp PlotTransformTime;
+
   vtkAxis* xAxis2;
 };
 
@@ -0,0 +1,778 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vtkVgLabelLayer.h"
+
+#include <vtkActor2D.h>
+#include <vtkCamera.h>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper2D.h>
+#include <vtkPropCollection.h>
+#include <vtkProperty2D.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
+#include <vtkTextProperty.h>
+#include <vtkTextRenderer.h>
+#include <vtkTexture.h>
+#include <vtkTexturedActor2D.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkWindow.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+vtkStandardNewMacro(vtkVgLabelLayer);
+
+namespace
+{
+
+// Padding between the text and the edge of the frame, in pixels; these match
+// vtkVgAnnotationActor
+const int PadLeft = 4, PadRight = 4, PadBottom = 1, PadTop = 4;
+
+const int AtlasWidth = 1024;
+const int InitialAtlasHeight = 128;
+const int MaximumAtlasHeight = 4096;
+
+// Size of the cells used to find placed labels near a new label
+const int GridCellSize = 64;
+
+//-----------------------------------------------------------------------------
+struct AtlasEntry
+{
+  // Location of the text in the atlas; X is negative if the text has been
+  // measured, but is not currently in the atlas
+  int X, Y;
+  int Width, Height;
+};
+
+//-----------------------------------------------------------------------------
+struct LabelRect
+{
+  int Left, Bottom, Right, Top;
+
+  bool Overlaps(const LabelRect& other) const
+    {
+    return this->Left < other.Right && other.Left < this->Right &&
+           this->Bottom < other.Top && other.Bottom < this->Top;
+    }
+};
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+class vtkVgLabelLayer::vtkInternal
+{
+public:
+  vtkInternal();
+
+  void ResetAtlas(int height);
+  void ClearAtlas();
+  bool GrowAtlas(int height);
+  bool AddToAtlas(AtlasEntry& entry);
+  AtlasEntry* GetAtlasEntry(const std::string& text, int dpi);
+  bool EnsureInAtlas(const std::string& text, AtlasEntry& entry, int dpi);
+
+  void Layout(vtkVgLabelLayer* self, vtkRenderer* ren);
+
+  bool Place(const LabelRect& rect, bool cull, const int size[2]);
+
+  vtkSmartPointer<vtkTextProperty> TextProperty;
+  vtkSmartPointer<vtkTextProperty> RenderProperty;
+
+  // Atlas of rendered label text; text is rendered in white, and tinted by
+  // the per-vertex foreground colors
+  vtkSmartPointer<vtkImageData> Atlas;
+  std::unordered_map<std::string, AtlasEntry> AtlasEntries;
+  int AtlasHeight;
+  int ShelfX, ShelfY, ShelfHeight;
+  int AtlasDpi;
+  vtkTimeStamp AtlasTime;
+  vtkSmartPointer<vtkImageData> TextImage;
+
+  // Placement results of the last layout, in viewport coordinates
+  std::vector<LabelRect> Placed;
+  std::vector<vtkIdType> PlacedIds;
+  std::vector<vtkIdType> PlacedIndices;
+  std::vector<AtlasEntry*> PlacedEntries;
+  std::vector<std::vector<int> > Grid;
+  int GridSize[2];
+  int ViewportOrigin[2];
+  int ViewportSize[2];
+  vtkTimeStamp LayoutTime;
+  vtkMTimeType CameraTime;
+
+  vtkSmartPointer<vtkPoints> BackgroundPoints;
+  vtkSmartPointer<vtkCellArray> BackgroundPolys;
+  vtkSmartPointer<vtkUnsignedCharArray> BackgroundScalars;
+  vtkSmartPointer<vtkActor2D> BackgroundActor;
+
+  vtkSmartPointer<vtkPoints> TextPoints;
+  vtkSmartPointer<vtkCellArray> TextPolys;
+  vtkSmartPointer<vtkFloatArray> TextTCoords;
+  vtkSmartPointer<vtkUnsignedCharArray> TextScalars;
+  vtkSmartPointer<vtkTexture> TextTexture;
+  vtkSmartPointer<vtkTexturedActor2D> TextActor;
+};
+
+//-----------------------------------------------------------------------------
+vtkVgLabelLayer::vtkInternal::vtkInternal()
+  : AtlasHeight(0), ShelfX(0), ShelfY(0), ShelfHeight(0), AtlasDpi(0),
+    CameraTime(0)
+{
+  this->TextProperty = vtkSmartPointer<vtkTextProperty>::New();
+  this->TextProperty->SetFontSize(14);
+  this->TextProperty->SetJustificationToCentered();
+
+  this->RenderProperty = vtkSmartPointer<vtkTextProperty>::New();
+  this->TextImage = vtkSmartPointer<vtkImageData>::New();
+  this->Atlas = vtkSmartPointer<vtkImageData>::New();
+
+  this->GridSize[0] = this->GridSize[1] = 0;
+  this->ViewportOrigin[0] = this->ViewportOrigin[1] = 0;
+  this->ViewportSize[0] = this->ViewportSize[1] = 0;
+
+  // Set up frames
+  this->BackgroundPoints = vtkSmartPointer<vtkPoints>::New();
+  this->BackgroundPolys = vtkSmartPointer<vtkCellArray>::New();
+  this->BackgroundScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  this->BackgroundScalars->SetNumberOfComponents(3);
+
+  vtkNew<vtkPolyData> backgroundPolyData;
+  backgroundPolyData->SetPoints(this->BackgroundPoints);
+  backgroundPolyData->SetPolys(this->BackgroundPolys);
+  backgroundPolyData->GetPointData()->SetScalars(this->BackgroundScalars);
+
+  vtkNew<vtkPolyDataMapper2D> backgroundMapper;
+  backgroundMapper->SetInputData(backgroundPolyData.GetPointer());
+
+  this->BackgroundActor = vtkSmartPointer<vtkActor2D>::New();
+  this->BackgroundActor->SetMapper(backgroundMapper.GetPointer());
+
+  // Set up text
+  this->TextPoints = vtkSmartPointer<vtkPoints>::New();
+  this->TextPolys = vtkSmartPointer<vtkCellArray>::New();
+  this->TextTCoords = vtkSmartPointer<vtkFloatArray>::New();
+  this->TextTCoords->SetNumberOfComponents(2);
+  this->TextScalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+  this->TextScalars->SetNumberOfComponents(3);
+
+  vtkNew<vtkPolyData> textPolyData;
+  textPolyData->SetPoints(this->TextPoints);
+  textPolyData->SetPolys(this->TextPolys);
+  textPolyData->GetPointData()->SetTCoords(this->TextTCoords);
+  textPolyData->GetPointData()->SetScalars(this->TextScalars);
+
+  vtkNew<vtkPolyDataMapper2D> textMapper;
+  textMapper->SetInputData(textPolyData.GetPointer());
+
+  // Text quads are pixel aligned, so there is no need to interpolate
+  this->TextTexture = vtkSmartPointer<vtkTexture>::New();
+  this->TextTexture->SetInputData(this->Atlas);
+  this->TextTexture->InterpolateOff();
+  this->TextTexture->RepeatOff();
+
+  this->TextActor = vtkSmartPointer<vtkTexturedActor2D>::New();
+  this->TextActor->SetMapper(textMapper.GetPointer());
+  this->TextActor->SetTexture(this->TextTexture);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::vtkInternal::ResetAtlas(int height)
+{
+  this->AtlasHeight = height;
+  this->Atlas->SetExtent(0, AtlasWidth - 1, 0, height - 1, 0, 0);
+  this->Atlas->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+
+  this->AtlasEntries.clear();
+  this->ClearAtlas();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::vtkInternal::ClearAtlas()
+{
+  // Remove all text from the atlas, but keep the measured text sizes
+  memset(this->Atlas->GetScalarPointer(), 0,
+         AtlasWidth * this->AtlasHeight * 4);
+  this->Atlas->Modified();
+
+  std::unordered_map<std::string, AtlasEntry>::iterator iter;
+  for (iter = this->AtlasEntries.begin(); iter != this->AtlasEntries.end();
+       ++iter)
+    {
+    iter->second.X = -1;
+    }
+
+  this->ShelfX = this->ShelfY = this->ShelfHeight = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgLabelLayer::vtkInternal::GrowAtlas(int height)
+{
+  if (this->AtlasHeight >= MaximumAtlasHeight)
+    {
+    return false;
+    }
+
+  while (this->AtlasHeight < height)
+    {
+    this->AtlasHeight *= 2;
+    }
+  this->AtlasHeight = std::min(this->AtlasHeight, MaximumAtlasHeight);
+  if (this->AtlasHeight < height)
+    {
+    return false;
+    }
+
+  // Rows are contiguous and the width does not change, so the existing
+  // contents can be copied as one block
+  vtkNew<vtkImageData> atlas;
+  atlas->SetExtent(0, AtlasWidth - 1, 0, this->AtlasHeight - 1, 0, 0);
+  atlas->AllocateScalars(VTK_UNSIGNED_CHAR, 4);
+
+  const vtkIdType oldSize = this->Atlas->GetNumberOfPoints() * 4;
+  const vtkIdType newSize = atlas->GetNumberOfPoints() * 4;
+  unsigned char* const out =
+    static_cast<unsigned char*>(atlas->GetScalarPointer());
+  memcpy(out, this->Atlas->GetScalarPointer(), oldSize);
+  memset(out + oldSize, 0, newSize - oldSize);
+
+  this->Atlas->ShallowCopy(atlas.GetPointer());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgLabelLayer::vtkInternal::AddToAtlas(AtlasEntry& entry)
+{
+  // Find space on the current shelf, or start a new shelf; leave a pixel
+  // between entries so that neighbors do not bleed into each other
+  if (this->ShelfX + entry.Width > AtlasWidth)
+    {
+    this->ShelfX = 0;
+    this->ShelfY += this->ShelfHeight + 1;
+    this->ShelfHeight = 0;
+    }
+  if (this->ShelfY + entry.Height > this->AtlasHeight &&
+      !this->GrowAtlas(this->ShelfY + entry.Height))
+    {
+    return false;
+    }
+
+  entry.X = this->ShelfX;
+  entry.Y = this->ShelfY;
+
+  this->ShelfX += entry.Width + 1;
+  this->ShelfHeight = std::max(this->ShelfHeight, entry.Height);
+
+  // Copy the rendered text (which must be in TextImage) into the atlas
+  int* const extent = this->TextImage->GetExtent();
+  for (int y = 0; y < entry.Height; ++y)
+    {
+    const void* const in =
+      this->TextImage->GetScalarPointer(extent[0], extent[2] + y, extent[4]);
+    void* const out =
+      this->Atlas->GetScalarPointer(entry.X, entry.Y + y, 0);
+    memcpy(out, in, entry.Width * 4);
+    }
+  this->Atlas->Modified();
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+AtlasEntry* vtkVgLabelLayer::vtkInternal::GetAtlasEntry(
+  const std::string& text, int dpi)
+{
+  std::unordered_map<std::string, AtlasEntry>::iterator iter =
+    this->AtlasEntries.find(text);
+  if (iter != this->AtlasEntries.end())
+    {
+    return &iter->second;
+    }
+
+  vtkTextRenderer* const textRenderer = vtkTextRenderer::GetInstance();
+  int textDims[2];
+  if (!textRenderer ||
+      !textRenderer->RenderString(this->RenderProperty, text,
+                                  this->TextImage, textDims, dpi))
+    {
+    return 0;
+    }
+
+  // Text is measured by rendering it, so add it to the atlas now if there is
+  // room, rather than rendering it again if the label is placed
+  AtlasEntry entry;
+  entry.X = entry.Y = -1;
+  entry.Width = std::min(textDims[0], AtlasWidth);
+  entry.Height = std::min(textDims[1], MaximumAtlasHeight);
+  if (!this->AddToAtlas(entry))
+    {
+    entry.X = -1;
+    }
+
+  return &(this->AtlasEntries[text] = entry);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgLabelLayer::vtkInternal::EnsureInAtlas(
+  const std::string& text, AtlasEntry& entry, int dpi)
+{
+  if (entry.X >= 0)
+    {
+    return true;
+    }
+
+  vtkTextRenderer* const textRenderer = vtkTextRenderer::GetInstance();
+  int textDims[2];
+  return textRenderer &&
+         textRenderer->RenderString(this->RenderProperty, text,
+                                    this->TextImage, textDims, dpi) &&
+         this->AddToAtlas(entry);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgLabelLayer::vtkInternal::Place(
+  const LabelRect& rect, bool cull, const int size[2])
+{
+  // Labels that are entirely outside the viewport are never drawn
+  if (rect.Right <= 0 || rect.Top <= 0 ||
+      rect.Left >= size[0] || rect.Bottom >= size[1])
+    {
+    return false;
+    }
+
+  const int gx0 = std::max(0, rect.Left / GridCellSize);
+  const int gy0 = std::max(0, rect.Bottom / GridCellSize);
+  const int gx1 = std::min(this->GridSize[0] - 1, rect.Right / GridCellSize);
+  const int gy1 = std::min(this->GridSize[1] - 1, rect.Top / GridCellSize);
+
+  if (cull)
+    {
+    for (int gy = gy0; gy <= gy1; ++gy)
+      {
+      for (int gx = gx0; gx <= gx1; ++gx)
+        {
+        const std::vector<int>& cell =
+          this->Grid[gy * this->GridSize[0] + gx];
+        for (size_t i = 0, k = cell.size(); i < k; ++i)
+          {
+          if (rect.Overlaps(this->Placed[cell[i]]))
+            {
+            return false;
+            }
+          }
+        }
+      }
+    }
+
+  const int index = static_cast<int>(this->Placed.size());
+  this->Placed.push_back(rect);
+  for (int gy = gy0; gy <= gy1; ++gy)
+    {
+    for (int gx = gx0; gx <= gx1; ++gx)
+      {
+      this->Grid[gy * this->GridSize[0] + gx].push_back(index);
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::vtkInternal::Layout(
+  vtkVgLabelLayer* self, vtkRenderer* ren)
+{
+  // Rebuild the atlas if the text appearance has changed
+  const int dpi = ren->GetVTKWindow() ? ren->GetVTKWindow()->GetDPI() : 72;
+  if (this->AtlasHeight == 0 || dpi != this->AtlasDpi ||
+      this->TextProperty->GetMTime() > this->AtlasTime)
+    {
+    this->RenderProperty->ShallowCopy(this->TextProperty);
+    this->RenderProperty->SetColor(1.0, 1.0, 1.0);
+    this->RenderProperty->SetOpacity(1.0);
+    this->RenderProperty->SetBackgroundOpacity(0.0);
+    this->RenderProperty->SetVerticalJustificationToBottom();
+
+    this->ResetAtlas(InitialAtlasHeight);
+    this->AtlasDpi = dpi;
+    this->AtlasTime.Modified();
+    }
+
+  // Set up the placement grid
+  const int* const origin = ren->GetOrigin();
+  const int* const size = ren->GetSize();
+  this->ViewportOrigin[0] = origin[0];
+  this->ViewportOrigin[1] = origin[1];
+  this->ViewportSize[0] = size[0];
+  this->ViewportSize[1] = size[1];
+
+  this->GridSize[0] = std::max(1, (size[0] + GridCellSize - 1) / GridCellSize);
+  this->GridSize[1] = std::max(1, (size[1] + GridCellSize - 1) / GridCellSize);
+  this->Grid.resize(this->GridSize[0] * this->GridSize[1]);
+  for (size_t i = 0, k = this->Grid.size(); i < k; ++i)
+    {
+    this->Grid[i].clear();
+    }
+
+  this->Placed.clear();
+  this->PlacedIds.clear();
+  this->PlacedIndices.clear();
+  this->PlacedEntries.clear();
+  this->BackgroundPoints->Reset();
+  this->BackgroundPolys->Reset();
+  this->BackgroundScalars->Reset();
+  this->TextPoints->Reset();
+  this->TextPolys->Reset();
+  this->TextTCoords->Reset();
+  this->TextScalars->Reset();
+
+  // Compute the transform from model to view coordinates once, rather than
+  // asking the renderer to transform each label
+  vtkNew<vtkMatrix4x4> xf;
+  vtkMatrix4x4::Multiply4x4(
+    ren->GetActiveCamera()->GetCompositeProjectionTransformMatrix(
+      ren->GetTiledAspectRatio(), 0, 1),
+    self->GetMatrix(), xf.GetPointer());
+  const double (*const m)[4] = xf->Element;
+
+  vtkIdType count = self->LabelPositions->GetNumberOfPoints();
+  count = std::min(count, self->LabelText->GetNumberOfValues());
+  count = std::min(count, self->LabelIds->GetNumberOfTuples());
+  count = std::min(count, self->ForegroundColors->GetNumberOfTuples());
+  count = std::min(count, self->BackgroundColors->GetNumberOfTuples());
+
+  // Forget text that is probably no longer used, so that the set of measured
+  // text does not grow without bound
+  if (this->AtlasEntries.size() > static_cast<size_t>(2 * count + 4096))
+    {
+    this->ResetAtlas(InitialAtlasHeight);
+    }
+
+  const size_t maxLabels =
+    (self->MaximumNumberOfLabels > 0
+     ? static_cast<size_t>(self->MaximumNumberOfLabels)
+     : static_cast<size_t>(count));
+
+  // Place labels
+  for (vtkIdType i = 0; i < count && this->Placed.size() < maxLabels; ++i)
+    {
+    const std::string& text = self->LabelText->GetValue(i);
+    if (text.empty())
+      {
+      continue;
+      }
+
+    // Transform the anchor to viewport coordinates
+    double p[3];
+    self->LabelPositions->GetPoint(i, p);
+    const double w =
+      m[3][0] * p[0] + m[3][1] * p[1] + m[3][2] * p[2] + m[3][3];
+    if (w <= 0.0)
+      {
+      continue;
+      }
+    const double vx = (m[0][0] * p[0] + m[0][1] * p[1] +
+                       m[0][2] * p[2] + m[0][3]) / w;
+    const double vy = (m[1][0] * p[0] + m[1][1] * p[1] +
+                       m[1][2] * p[2] + m[1][3]) / w;
+    const int ax = static_cast<int>(floor(0.5 * (vx + 1.0) * size[0]));
+    const int ay = static_cast<int>(floor(0.5 * (vy + 1.0) * size[1]));
+
+    AtlasEntry* const entry = this->GetAtlasEntry(text, dpi);
+    if (!entry)
+      {
+      continue;
+      }
+
+    // Frame is centered horizontally below the anchor, as with
+    // vtkVgAnnotationActor::AutoCenterX
+    LabelRect rect;
+    rect.Left = ax + self->Offset[0] - (entry->Width / 2) - PadLeft;
+    rect.Right = ax + self->Offset[0] + (entry->Width / 2) + PadRight;
+    rect.Top = ay + self->Offset[1];
+    rect.Bottom = rect.Top - entry->Height - (PadBottom + PadTop);
+
+    if (this->Place(rect, self->CullOverlappingLabels, size))
+      {
+      this->PlacedIds.push_back(self->LabelIds->GetValue(i));
+      this->PlacedIndices.push_back(i);
+      this->PlacedEntries.push_back(entry);
+      }
+    }
+
+  // Make sure the text of every placed label is in the atlas; if the atlas
+  // fills up, clear it and add only the text of the placed labels
+  const size_t placedCount = this->Placed.size();
+  for (int attempt = 0; attempt < 2; ++attempt)
+    {
+    bool complete = true;
+    for (size_t n = 0; n < placedCount; ++n)
+      {
+      const std::string& text =
+        self->LabelText->GetValue(this->PlacedIndices[n]);
+      if (!this->EnsureInAtlas(text, *this->PlacedEntries[n], dpi))
+        {
+        complete = false;
+        break;
+        }
+      }
+
+    if (complete)
+      {
+      break;
+      }
+    this->ClearAtlas();
+    }
+
+  // Build geometry
+  for (size_t n = 0; n < placedCount; ++n)
+    {
+    const LabelRect& rect = this->Placed[n];
+    const AtlasEntry* const entry = this->PlacedEntries[n];
+    const vtkIdType i = this->PlacedIndices[n];
+
+    // Add frame
+    const vtkIdType b = this->BackgroundPoints->GetNumberOfPoints();
+    this->BackgroundPoints->InsertNextPoint(rect.Left, rect.Bottom, 0.0);
+    this->BackgroundPoints->InsertNextPoint(rect.Right, rect.Bottom, 0.0);
+    this->BackgroundPoints->InsertNextPoint(rect.Right, rect.Top, 0.0);
+    this->BackgroundPoints->InsertNextPoint(rect.Left, rect.Top, 0.0);
+    const vtkIdType bids[] = { b, b + 1, b + 2, b + 3 };
+    this->BackgroundPolys->InsertNextCell(4, bids);
+
+    unsigned char color[3];
+    self->BackgroundColors->GetTypedTuple(i, color);
+    for (int k = 0; k < 4; ++k)
+      {
+      this->BackgroundScalars->InsertNextTypedTuple(color);
+      }
+
+    if (entry->X < 0)
+      {
+      // Text could not be fitted in the atlas
+      continue;
+      }
+
+    // Add text
+    const int tx = (rect.Left + rect.Right - entry->Width) / 2;
+    const int ty = rect.Top - PadTop - entry->Height;
+    const vtkIdType t = this->TextPoints->GetNumberOfPoints();
+    this->TextPoints->InsertNextPoint(tx, ty, 0.0);
+    this->TextPoints->InsertNextPoint(tx + entry->Width, ty, 0.0);
+    this->TextPoints->InsertNextPoint(tx + entry->Width,
+                                      ty + entry->Height, 0.0);
+    this->TextPoints->InsertNextPoint(tx, ty + entry->Height, 0.0);
+    const vtkIdType tids[] = { t, t + 1, t + 2, t + 3 };
+    this->TextPolys->InsertNextCell(4, tids);
+
+    const float u0 = static_cast<float>(entry->X) / AtlasWidth;
+    const float u1 = static_cast<float>(entry->X + entry->Width) / AtlasWidth;
+    const float v0 = static_cast<float>(entry->Y) / this->AtlasHeight;
+    const float v1 =
+      static_cast<float>(entry->Y + entry->Height) / this->AtlasHeight;
+    this->TextTCoords->InsertNextTuple2(u0, v0);
+    this->TextTCoords->InsertNextTuple2(u1, v0);
+    this->TextTCoords->InsertNextTuple2(u1, v1);
+    this->TextTCoords->InsertNextTuple2(u0, v1);
+
+    self->ForegroundColors->GetTypedTuple(i, color);
+    for (int k = 0; k < 4; ++k)
+      {
+      this->TextScalars->InsertNextTypedTuple(color);
+      }
+    }
+
+  this->BackgroundPoints->Modified();
+  this->BackgroundPolys->Modified();
+  this->BackgroundScalars->Modified();
+  this->TextPoints->Modified();
+  this->TextPolys->Modified();
+  this->TextTCoords->Modified();
+  this->TextScalars->Modified();
+
+  this->BackgroundActor->GetProperty()->SetOpacity(self->BackgroundOpacity);
+}
+
+//-----------------------------------------------------------------------------
+vtkVgLabelLayer::vtkVgLabelLayer()
+  : BackgroundOpacity(0.7), MaximumNumberOfLabels(0),
+    CullOverlappingLabels(false), Internal(new vtkInternal)
+{
+  this->Offset[0] = this->Offset[1] = 0;
+
+  this->LabelPositions = vtkPoints::New();
+  this->LabelPositions->SetDataTypeToDouble();
+  this->LabelText = vtkStringArray::New();
+  this->LabelIds = vtkIdTypeArray::New();
+  this->ForegroundColors = vtkUnsignedCharArray::New();
+  this->ForegroundColors->SetNumberOfComponents(3);
+  this->BackgroundColors = vtkUnsignedCharArray::New();
+  this->BackgroundColors->SetNumberOfComponents(3);
+}
+
+//-----------------------------------------------------------------------------
+vtkVgLabelLayer::~vtkVgLabelLayer()
+{
+  this->LabelPositions->Delete();
+  this->LabelText->Delete();
+  this->LabelIds->Delete();
+  this->ForegroundColors->Delete();
+  this->BackgroundColors->Delete();
+  delete this->Internal;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::AddLabel(
+  vtkIdType id, const double position[3], const char* text,
+  const unsigned char foregroundColor[3],
+  const unsigned char backgroundColor[3])
+{
+  this->LabelPositions->InsertNextPoint(position);
+  this->LabelText->InsertNextValue(text ? text : "");
+  this->LabelIds->InsertNextValue(id);
+  this->ForegroundColors->InsertNextTypedTuple(foregroundColor);
+  this->BackgroundColors->InsertNextTypedTuple(backgroundColor);
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::RemoveAllLabels()
+{
+  this->LabelPositions->Reset();
+  this->LabelText->Reset();
+  this->LabelIds->Reset();
+  this->ForegroundColors->Reset();
+  this->BackgroundColors->Reset();
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkTextProperty* vtkVgLabelLayer::GetTextProperty()
+{
+  return this->Internal->TextProperty;
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgLabelLayer::GetNumberOfPlacedLabels()
+{
+  return static_cast<int>(this->Internal->Placed.size());
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkVgLabelLayer::PickLabel(double x, double y)
+{
+  // Placement is in viewport coordinates
+  x -= this->Internal->ViewportOrigin[0];
+  y -= this->Internal->ViewportOrigin[1];
+
+  const std::vector<LabelRect>& placed = this->Internal->Placed;
+  for (size_t i = placed.size(); i > 0; --i)
+    {
+    const LabelRect& rect = placed[i - 1];
+    if (x >= rect.Left && x <= rect.Right &&
+        y >= rect.Bottom && y <= rect.Top)
+      {
+      return this->Internal->PlacedIds[i - 1];
+      }
+    }
+
+  return -1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::ReleaseGraphicsResources(vtkWindow* w)
+{
+  this->Superclass::ReleaseGraphicsResources(w);
+  this->Internal->BackgroundActor->ReleaseGraphicsResources(w);
+  this->Internal->TextActor->ReleaseGraphicsResources(w);
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgLabelLayer::RenderOpaqueGeometry(vtkViewport* v)
+{
+  vtkRenderer* const ren = vtkRenderer::SafeDownCast(v);
+  if (!ren || !ren->GetActiveCamera())
+    {
+    return 0;
+    }
+
+  // Labels only need to be placed again if the labels, their appearance or
+  // the view have changed
+  vtkInternal* const internal = this->Internal;
+  vtkMTimeType mtime = this->GetMTime();
+  mtime = std::max(mtime, this->LabelPositions->GetMTime());
+  mtime = std::max(mtime, this->LabelText->GetMTime());
+  mtime = std::max(mtime, this->LabelIds->GetMTime());
+  mtime = std::max(mtime, this->ForegroundColors->GetMTime());
+  mtime = std::max(mtime, this->BackgroundColors->GetMTime());
+  mtime = std::max(mtime, internal->TextProperty->GetMTime());
+  if (this->UserMatrix)
+    {
+    mtime = std::max(mtime, this->UserMatrix->GetMTime());
+    }
+
+  const vtkMTimeType cameraTime = ren->GetActiveCamera()->GetMTime();
+  const int* const origin = ren->GetOrigin();
+  const int* const size = ren->GetSize();
+
+  if (mtime > internal->LayoutTime || cameraTime != internal->CameraTime ||
+      origin[0] != internal->ViewportOrigin[0] ||
+      origin[1] != internal->ViewportOrigin[1] ||
+      size[0] != internal->ViewportSize[0] ||
+      size[1] != internal->ViewportSize[1])
+    {
+    internal->Layout(this, ren);
+    internal->CameraTime = cameraTime;
+    internal->LayoutTime.Modified();
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgLabelLayer::RenderOverlay(vtkViewport* v)
+{
+  if (this->Internal->Placed.empty())
+    {
+    return 0;
+    }
+
+  int count = 0;
+  count += this->Internal->BackgroundActor->RenderOverlay(v);
+  count += this->Internal->TextActor->RenderOverlay(v);
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::GetActors2D(vtkPropCollection* pc)
+{
+  pc->AddItem(this->Internal->BackgroundActor);
+  pc->AddItem(this->Internal->TextActor);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgLabelLayer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number Of Labels: "
+     << this->LabelPositions->GetNumberOfPoints() << '\n';
+  os << indent << "Maximum Number Of Labels: "
+     << this->MaximumNumberOfLabels << '\n';
+  os << indent << "Cull Overlapping Labels: "
+     << (this->CullOverlappingLabels ? "On\n" : "Off\n");
+}
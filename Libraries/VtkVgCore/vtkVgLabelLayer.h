@@ -0,0 +1,138 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+// .NAME vtkVgLabelLayer - a 2D prop that draws many text labels at once
+// .SECTION Description
+// vtkVgLabelLayer draws a set of framed text labels, in the style of
+// vtkVgAnnotationActor, as a single prop. Labels are described by parallel
+// arrays of anchor positions, text, and foreground and background colors.
+// The text of each distinct label is rendered once into a shared texture
+// atlas, so that all labels are drawn with one textured and one untextured
+// draw, regardless of how many labels there are.
+//
+// Labels are placed in array order (so earlier labels take priority). A label
+// is culled if its frame lies outside the viewport, or, if
+// CullOverlappingLabels is on, if it would overlap a label that has already
+// been placed. At most MaximumNumberOfLabels labels are drawn.
+
+#ifndef __vtkVgLabelLayer_h
+#define __vtkVgLabelLayer_h
+
+#include "vtkActor.h"
+
+#include <vgExport.h>
+
+class vtkIdTypeArray;
+class vtkPoints;
+class vtkStringArray;
+class vtkTextProperty;
+class vtkUnsignedCharArray;
+
+class VTKVG_CORE_EXPORT vtkVgLabelLayer : public vtkActor
+{
+public:
+  vtkTypeMacro(vtkVgLabelLayer, vtkActor);
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Instantiate the class.
+  static vtkVgLabelLayer* New();
+
+  // Description:
+  // Per-label data. Positions are the (model space) anchor points of the
+  // labels; colors have three components. Ids are reported by PickLabel. All
+  // arrays must have the same number of tuples. Call Modified() after
+  // changing the contents of the arrays.
+  vtkGetObjectMacro(LabelPositions, vtkPoints);
+  vtkGetObjectMacro(LabelText, vtkStringArray);
+  vtkGetObjectMacro(LabelIds, vtkIdTypeArray);
+  vtkGetObjectMacro(ForegroundColors, vtkUnsignedCharArray);
+  vtkGetObjectMacro(BackgroundColors, vtkUnsignedCharArray);
+
+  // Description:
+  // Convenience method to append a label to the label arrays.
+  void AddLabel(vtkIdType id, const double position[3], const char* text,
+                const unsigned char foregroundColor[3],
+                const unsigned char backgroundColor[3]);
+
+  // Description:
+  // Remove all labels.
+  void RemoveAllLabels();
+
+  // Description:
+  // Get the text property used to render the labels. The color and opacity of
+  // the text property are ignored; the foreground color of each label is used
+  // instead.
+  vtkTextProperty* GetTextProperty();
+
+  // Description:
+  // Set/get the opacity of the label frames.
+  vtkSetClampMacro(BackgroundOpacity, double, 0.0, 1.0);
+  vtkGetMacro(BackgroundOpacity, double);
+
+  // Description:
+  // Specify the display offset of the labels from their anchor points.
+  vtkSetVector2Macro(Offset, int);
+  vtkGetVector2Macro(Offset, int);
+
+  // Description:
+  // Set/get the maximum number of labels to draw. Zero (the default) means no
+  // limit.
+  vtkSetMacro(MaximumNumberOfLabels, int);
+  vtkGetMacro(MaximumNumberOfLabels, int);
+
+  // Description:
+  // Set/get whether labels which would overlap a label that has already been
+  // placed are culled. The default is off, so that no label is hidden by
+  // another merely because it comes later in the arrays.
+  vtkSetMacro(CullOverlappingLabels, bool);
+  vtkGetMacro(CullOverlappingLabels, bool);
+  vtkBooleanMacro(CullOverlappingLabels, bool);
+
+  // Description:
+  // Return the number of labels that were drawn by the last render.
+  int GetNumberOfPlacedLabels();
+
+  // Description:
+  // Return the id of the label whose frame contains the given display
+  // position, as of the last render, or -1 if there is no such label.
+  vtkIdType PickLabel(double x, double y);
+
+  // Description:
+  // Methods required by vtkProp superclass.
+  virtual void ReleaseGraphicsResources(vtkWindow* w);
+  virtual int RenderOpaqueGeometry(vtkViewport* viewport);
+  virtual int RenderTranslucentPolygonalGeometry(vtkViewport*) {return 0;};
+  virtual int RenderOverlay(vtkViewport* viewport);
+  virtual int HasTranslucentPolygonalGeometry() { return 0; }
+
+  virtual void GetActors2D(vtkPropCollection* pc);
+
+  // Returning a null bounds prevents the renderer from culling this actor
+  virtual double* GetBounds() { return 0; }
+
+protected:
+  vtkVgLabelLayer();
+  ~vtkVgLabelLayer();
+
+  vtkPoints*            LabelPositions;
+  vtkStringArray*       LabelText;
+  vtkIdTypeArray*       LabelIds;
+  vtkUnsignedCharArray* ForegroundColors;
+  vtkUnsignedCharArray* BackgroundColors;
+
+  double BackgroundOpacity;
+  int    Offset[2];
+  int    MaximumNumberOfLabels;
+  bool   CullOverlappingLabels;
+
+private:
+  vtkVgLabelLayer(const vtkVgLabelLayer&);  // Not implemented
+  void operator=(const vtkVgLabelLayer&);   // Not implemented
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
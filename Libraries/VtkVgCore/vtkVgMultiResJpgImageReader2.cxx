@@ -20,6 +20,8 @@
 
 #include "vtkVgJPEGMemoryReader.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkVgMultiResJpgImageReader2);
 
 //----------------------------------------------------------------------------
@@ -387,6 +389,94 @@ void vtkVgMultiResJpgImageReader2::ExecuteDataWithInformation(
   fclose(fp);
 }
 
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkVgMultiResJpgImageReader2::ReadTile(
+  int level, int x, int y) const
+{
+  if (!this->FileName || level < 0 || level >= this->NumberOfLevels ||
+      x < 0 || y < 0)
+    {
+    return 0;
+    }
+
+  FILE* fp;
+#ifdef _WIN32
+  fopen_s(&fp, this->FileName, "rb");
+#else
+  fp = fopen(this->FileName, "rb");
+#endif
+  if (! fp)
+    {
+    cerr << "File " << this->FileName << " does not exist.\n";
+    return 0;
+    }
+
+  // Read the location of the level, and its grid dimensions
+  vtkTypeUInt64 levelLocation;
+  vtkTypeUInt32 gridDims[2];
+  fseek(fp, this->LevelTableLocation + (sizeof(vtkTypeUInt64) * level),
+        SEEK_SET);
+  bool okay = (fread(&levelLocation, sizeof(vtkTypeUInt64), 1, fp) == 1);
+  vtkByteSwap::Swap8LE(&levelLocation);
+  okay = okay && fseek(fp, levelLocation, SEEK_SET) == 0 &&
+         fread(gridDims, sizeof(vtkTypeUInt32), 2, fp) == 2;
+  vtkByteSwap::Swap4LERange(gridDims, 2);
+  okay = okay && static_cast<vtkTypeUInt32>(x) < gridDims[0] &&
+                 static_cast<vtkTypeUInt32>(y) < gridDims[1];
+
+  // Read only the two entries of the tile table which bound the tile, rather
+  // than the whole table
+  vtkTypeUInt64 tileRange[2] = { 0, 0 };
+  if (okay)
+    {
+    const vtkTypeUInt64 tileIdx =
+      (static_cast<vtkTypeUInt64>(y) * gridDims[0]) + x;
+    const vtkTypeUInt64 entryLocation =
+      levelLocation + (2 * sizeof(vtkTypeUInt32)) +
+      (tileIdx * sizeof(vtkTypeUInt64));
+    okay = fseek(fp, entryLocation, SEEK_SET) == 0 &&
+           fread(tileRange, sizeof(vtkTypeUInt64), 2, fp) == 2;
+    vtkByteSwap::Swap8LERange(tileRange, 2);
+    okay = okay && tileRange[1] > tileRange[0];
+    }
+
+  std::vector<unsigned char> tileBuf;
+  if (okay)
+    {
+    tileBuf.resize(static_cast<size_t>(tileRange[1] - tileRange[0]));
+    okay = fseek(fp, tileRange[0], SEEK_SET) == 0 &&
+           fread(&tileBuf[0], 1, tileBuf.size(), fp) == tileBuf.size();
+    }
+  fclose(fp);
+
+  if (!okay)
+    {
+    return 0;
+    }
+
+  // Decompress the tile
+  vtkSmartPointer<vtkVgJPEGMemoryReader> reader =
+    vtkSmartPointer<vtkVgJPEGMemoryReader>::New();
+  reader->SetMemoryBuffer(&tileBuf[0], static_cast<int>(tileBuf.size()));
+  reader->Update();
+
+  vtkSmartPointer<vtkImageData> tile = vtkSmartPointer<vtkImageData>::New();
+  tile->ShallowCopy(reader->GetOutput());
+
+  // Shift the tile to its location in the level
+  int tileExt[6];
+  tile->GetExtent(tileExt);
+  const int xOffset = x * this->TileDimensions[0];
+  const int yOffset = y * this->TileDimensions[1];
+  tileExt[0] += xOffset;
+  tileExt[1] += xOffset;
+  tileExt[2] += yOffset;
+  tileExt[3] += yOffset;
+  tile->SetExtent(tileExt);
+
+  return tile;
+}
+
 //----------------------------------------------------------------------------
 vtkVgBaseImageSource* vtkVgMultiResJpgImageReader2::Create()
 {
@@ -13,6 +13,8 @@
 
 #include <vgExport.h>
 
+#include <vtkSmartPointer.h>
+
 class vtkImageData;
 
 class VTKVG_CORE_EXPORT vtkVgMultiResJpgImageReader2
@@ -76,6 +78,17 @@ public:
   // Return the number of level of details.
   virtual int GetNumberOfLevels() const;
 
+  // Description:
+  // Read the single tile at grid position (\p x, \p y) of level \p level,
+  // independent of the pipeline. The extents of the returned image are in
+  // the pixel coordinates of the level. Returns NULL if the tile does not
+  // exist or could not be read.
+  //
+  // UpdateInformation must have been called first. This method does not
+  // modify the reader, and may be called from multiple threads at once,
+  // provided the pipeline is not updated at the same time.
+  vtkSmartPointer<vtkImageData> ReadTile(int level, int x, int y) const;
+
   virtual bool CanRead(const std::string& source) const;
 
   virtual std::string GetShortDescription() const;
@@ -7,6 +7,7 @@
 #include "vtkIdTypeArray.h"
 #include "vtkContext2D.h"
 #include "vtkContextDevice2D.h"
+#include "vtkContextScene.h"
 #include "vtkObjectFactory.h"
 #include "vtkPen.h"
 #include "vtkPoints2D.h"
@@ -14,7 +15,290 @@
 #include "vtkUnsignedCharArray.h"
 #include "vtkVector.h"
 
+#include <vgIntervalIndex.h>
+
 #include <algorithm>
+#include <cmath>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class vtkVgPlotTimeline::vtkInternal
+{
+public:
+  // Interval i of the plot is formed by points 2i and 2i + 1
+  struct Interval
+    {
+    vtkVector2f Start;
+    vtkVector2f End;
+    unsigned char Color[4];
+    bool Indexed; // interval has an entry in the index...
+    bool Stale;   // ...which no longer matches the interval
+    bool Pending; // interval is in the list of unindexed intervals
+
+    float Lower() const { return std::min(Start.GetX(), End.GetX()); }
+    float Upper() const { return std::max(Start.GetX(), End.GetX()); }
+    };
+
+  // Summary of the intervals of a row which overlap a bin; the color is the
+  // sum of the colors of the intervals, so that intervals can be removed
+  struct Bin
+    {
+    int Count;
+    double Coverage;
+    double Color[4];
+    };
+
+  // Bins are sparse, keyed by bin number; each row (interval y value) has one
+  // set of bins per level, where the bins of level l are 2^l times as wide as
+  // those of level 0
+  typedef std::map<long long, Bin> BinMap;
+  typedef std::map<float, std::vector<BinMap> > RowMap;
+
+  enum
+    {
+    NumberOfLevels = 12,
+    BaseBinCount = 1024
+    };
+
+  vtkInternal() : StaleCount(0), Origin(0.0), BinWidth(0.0) {}
+
+  void Update(const vtkVector2f* points, vtkIdType numberOfPoints,
+              const unsigned char* colors, int numberOfComponents);
+  void Reset(const vtkVector2f* points, vtkIdType numberOfPoints);
+  void Reindex();
+  void Summarize(const Interval& interval, int sign);
+
+  double GetBinWidth(int level) const
+    { return this->BinWidth * static_cast<double>(1 << level); }
+
+  // Return the (sorted) numbers of the intervals which overlap [lower, upper]
+  std::vector<vtkIdType> FindIntervals(float lower, float upper) const;
+
+  std::vector<Interval> Intervals;
+
+  // Intervals are found using the index, plus a linear search of the
+  // intervals which were added or changed since the index was last built
+  vgIntervalIndex<float, vtkIdType> Index;
+  std::vector<vtkIdType> Unindexed;
+  size_t StaleCount;
+
+  double Origin;
+  double BinWidth;
+  RowMap Rows;
+
+  vtkTimeStamp UpdateTime;
+};
+
+//-----------------------------------------------------------------------------
+void vtkVgPlotTimeline::vtkInternal::Reset(
+  const vtkVector2f* points, vtkIdType numberOfPoints)
+{
+  this->Intervals.clear();
+  this->Index.Clear();
+  this->Unindexed.clear();
+  this->StaleCount = 0;
+  this->Rows.clear();
+
+  float minX = VTK_FLOAT_MAX, maxX = -VTK_FLOAT_MAX;
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    {
+    minX = std::min(minX, points[i].GetX());
+    maxX = std::max(maxX, points[i].GetX());
+    }
+
+  // Size the bins so that level 0 has about BaseBinCount bins across the
+  // data; bins outside of this range are still valid, so data that is added
+  // later does not require the summary to be rebuilt unless the data range
+  // grows substantially
+  this->Origin = (minX < maxX ? minX : 0.0);
+  this->BinWidth = (minX < maxX ? (maxX - minX) / BaseBinCount : 1.0);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgPlotTimeline::vtkInternal::Update(
+  const vtkVector2f* points, vtkIdType numberOfPoints,
+  const unsigned char* colors, int numberOfComponents)
+{
+  const size_t count = static_cast<size_t>(numberOfPoints / 2);
+
+  // Start over if intervals were removed, or if the data range has grown to
+  // the point that intervals would span too many bins
+  bool reset = (count < this->Intervals.size() || this->BinWidth <= 0.0);
+  if (!reset)
+    {
+    const double limit = 16.0 * BaseBinCount * this->BinWidth;
+    for (vtkIdType i = 0; i < numberOfPoints && !reset; ++i)
+      {
+      reset = (std::fabs(points[i].GetX() - this->Origin) > limit);
+      }
+    }
+  if (reset)
+    {
+    this->Reset(points, numberOfPoints);
+    }
+
+  this->Intervals.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    {
+    Interval next;
+    next.Start = points[2 * i];
+    next.End = points[2 * i + 1];
+    next.Color[0] = next.Color[1] = next.Color[2] = 0;
+    next.Color[3] = 255;
+    if (colors)
+      {
+      const unsigned char* c = colors + (2 * i * numberOfComponents);
+      std::copy(c, c + std::min(numberOfComponents, 4), next.Color);
+      }
+
+    if (i < this->Intervals.size())
+      {
+      Interval& current = this->Intervals[i];
+      if (current.Start == next.Start && current.End == next.End &&
+          std::equal(current.Color, current.Color + 4, next.Color))
+        {
+        continue;
+        }
+
+      // The interval changed; remove its old contribution to the summary,
+      // and mark its index entry (if any) as out of date
+      this->Summarize(current, -1);
+      if (current.Indexed && !current.Stale)
+        {
+        current.Stale = true;
+        ++this->StaleCount;
+        }
+      if (!current.Pending)
+        {
+        current.Pending = true;
+        this->Unindexed.push_back(static_cast<vtkIdType>(i));
+        }
+      current.Start = next.Start;
+      current.End = next.End;
+      std::copy(next.Color, next.Color + 4, current.Color);
+      }
+    else
+      {
+      next.Indexed = false;
+      next.Stale = false;
+      next.Pending = true;
+      this->Intervals.push_back(next);
+      this->Unindexed.push_back(static_cast<vtkIdType>(i));
+      }
+
+    this->Summarize(this->Intervals[i], +1);
+    }
+
+  // Rebuild the index once enough of the intervals are not indexed that the
+  // linear search would dominate the cost of finding intervals
+  const size_t pending = this->Unindexed.size() + this->StaleCount;
+  if (pending > std::max(size_t(256), this->Index.GetSize() / 4))
+    {
+    this->Reindex();
+    }
+
+  this->UpdateTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgPlotTimeline::vtkInternal::Reindex()
+{
+  this->Index.Clear();
+  this->Index.Reserve(this->Intervals.size());
+
+  const vtkIdType count = static_cast<vtkIdType>(this->Intervals.size());
+  for (vtkIdType i = 0; i < count; ++i)
+    {
+    Interval& interval = this->Intervals[i];
+    this->Index.Insert(interval.Lower(), interval.Upper(), i);
+    interval.Indexed = true;
+    interval.Stale = false;
+    interval.Pending = false;
+    }
+
+  this->Index.Build();
+  this->Unindexed.clear();
+  this->StaleCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgPlotTimeline::vtkInternal::Summarize(
+  const Interval& interval, int sign)
+{
+  const double lower = interval.Lower();
+  const double upper = interval.Upper();
+  if (!std::isfinite(lower) || !std::isfinite(upper) ||
+      !std::isfinite(interval.Start.GetY()))
+    {
+    return;
+    }
+
+  std::vector<BinMap>& levels = this->Rows[interval.Start.GetY()];
+  levels.resize(NumberOfLevels);
+
+  for (int level = 0; level < NumberOfLevels; ++level)
+    {
+    BinMap& bins = levels[level];
+    const double width = this->GetBinWidth(level);
+    const long long first =
+      static_cast<long long>(std::floor((lower - this->Origin) / width));
+    const long long last =
+      static_cast<long long>(std::floor((upper - this->Origin) / width));
+
+    for (long long b = first; b <= last; ++b)
+      {
+      const double binLower = this->Origin + (b * width);
+      const double overlap = std::min(upper, binLower + width) -
+                             std::max(lower, binLower);
+
+      BinMap::iterator iter = bins.insert(std::make_pair(b, Bin())).first;
+      Bin& bin = iter->second;
+      if ((bin.Count += sign) <= 0)
+        {
+        bins.erase(iter);
+        continue;
+        }
+      bin.Coverage += sign * std::max(overlap, 0.0);
+      for (int k = 0; k < 4; ++k)
+        {
+        bin.Color[k] += sign * interval.Color[k];
+        }
+      }
+    }
+
+  if (levels.back().empty())
+    {
+    this->Rows.erase(interval.Start.GetY());
+    }
+}
+
+//-----------------------------------------------------------------------------
+std::vector<vtkIdType> vtkVgPlotTimeline::vtkInternal::FindIntervals(
+  float lower, float upper) const
+{
+  std::vector<vtkIdType> result;
+
+  const std::vector<Interval>& intervals = this->Intervals;
+  this->Index.ForEachOverlapping(
+    lower, upper, [&result, &intervals](vtkIdType i){
+      if (!intervals[i].Stale)
+        {
+        result.push_back(i);
+        }
+    });
+
+  for (size_t k = 0; k < this->Unindexed.size(); ++k)
+    {
+    const vtkIdType i = this->Unindexed[k];
+    if (!(upper < intervals[i].Lower() || intervals[i].Upper() < lower))
+      {
+      result.push_back(i);
+      }
+    }
+
+  std::sort(result.begin(), result.end());
+  return result;
+}
 
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkVgPlotTimeline);
@@ -26,11 +310,14 @@ vtkVgPlotTimeline::vtkVgPlotTimeline()
   this->SortedIds = 0;
   this->AreaPointIds = 0;
   this->IsIntervalPlot = false;
+  this->LevelOfDetailThreshold = 2000;
+  this->Internal = new vtkInternal;
 }
 
 //-----------------------------------------------------------------------------
 vtkVgPlotTimeline::~vtkVgPlotTimeline()
 {
+  delete this->Internal;
   delete [] this->SortedIds;
 
   if (this->AreaPointIds)
@@ -73,6 +360,36 @@ void vtkVgPlotTimeline::SetProperty(const vtkStdString& property,
   this->Properties[property] = var;
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgPlotTimeline::UpdateIntervals()
+{
+  vtkInternal* const internal = this->Internal;
+  if (!this->Points)
+    {
+    return;
+    }
+
+  const vtkIdType numPoints = this->Points->GetNumberOfPoints();
+  if (internal->UpdateTime > this->BuildTime &&
+      internal->Intervals.size() == static_cast<size_t>(numPoints / 2))
+    {
+    return;
+    }
+
+  const unsigned char* colors = 0;
+  int numComponents = 0;
+  if (this->ScalarVisibility && this->Colors &&
+      this->Colors->GetNumberOfTuples() == numPoints)
+    {
+    colors = this->Colors->GetPointer(0);
+    numComponents = this->Colors->GetNumberOfComponents();
+    }
+
+  internal->Update(
+    static_cast<vtkVector2f*>(this->Points->GetVoidPointer(0)), numPoints,
+    colors, numComponents);
+}
+
 //-----------------------------------------------------------------------------
 bool vtkVgPlotTimeline::Paint(vtkContext2D* painter)
 {
@@ -98,6 +415,9 @@ bool vtkVgPlotTimeline::Paint(vtkContext2D* painter)
         static_cast<vtkVector2f*>(this->Points->GetVoidPointer(0));
 
       // coloring with scalars?
+      unsigned char* c = 0;
+      int nc_comps = 0;
+      float minWidth = 0.0f;
       if (this->ScalarVisibility && this->Colors)
         {
         int nc = static_cast<int>(this->Colors->GetNumberOfTuples());
@@ -107,14 +427,108 @@ bool vtkVgPlotTimeline::Paint(vtkContext2D* painter)
           return false;
           }
 
-        int nc_comps = static_cast<int>(this->Colors->GetNumberOfComponents());
-        unsigned char* c = this->Colors->GetPointer(0);
+        nc_comps = static_cast<int>(this->Colors->GetNumberOfComponents());
+        c = this->Colors->GetPointer(0);
 
+        // Enforce a minimum screen width to ensure items remain visible.
         painter->GetPen()->SetWidth(5);
+        minWidth = (widthScale > 0.0f ? minScreenWidth / widthScale : 0.0f);
+        }
+
+      this->UpdateIntervals();
+      vtkInternal* const internal = this->Internal;
+
+      // Determine the visible range of the plot, so that we only need to draw
+      // the intervals (or bins) which overlap it
+      float visible[4] = { -VTK_FLOAT_MAX, 0.0f, VTK_FLOAT_MAX, 0.0f };
+      vtkContextScene* const scene = this->GetScene();
+      const bool bounded = (scene && widthScale > 0.0f);
+      if (bounded)
+        {
+        visible[2] = static_cast<float>(scene->GetSceneWidth());
+        painter->GetTransform()->InverseTransformPoints(visible, visible, 2);
+        visible[0] -= minWidth;
+        visible[2] += minWidth;
+        }
+
+      // When zoomed out, draw from the summary, using the finest level whose
+      // bins are at least one pixel wide; this requires a bounded visible
+      // range, as the bins to draw are found from its (finite) lower end
+      int level = -1;
+      if (bounded &&
+          static_cast<vtkIdType>(internal->Intervals.size()) >
+            this->LevelOfDetailThreshold &&
+          internal->GetBinWidth(0) * widthScale < 1.0)
+        {
+        level = vtkInternal::NumberOfLevels - 1;
+        for (int l = 1; l < vtkInternal::NumberOfLevels; ++l)
+          {
+          if (internal->GetBinWidth(l) * widthScale >= 1.0)
+            {
+            level = l;
+            break;
+            }
+          }
+        }
+
+      std::vector<float> lines;
+      std::vector<unsigned char> lineColors;
+
+      if (level >= 0)
+        {
+        // Draw a segment for each occupied bin, as wide as the total length
+        // of the intervals in the bin, in the average color of the intervals
+        const double width = internal->GetBinWidth(level);
+        const long long firstBin = static_cast<long long>(
+          std::floor((visible[0] - internal->Origin) / width));
+
+        vtkInternal::RowMap::const_iterator row, rowEnd;
+        for (row = internal->Rows.begin(), rowEnd = internal->Rows.end();
+             row != rowEnd; ++row)
+          {
+          const vtkInternal::BinMap& bins = row->second[level];
+          vtkInternal::BinMap::const_iterator iter, end = bins.end();
+          for (iter = bins.lower_bound(firstBin); iter != end; ++iter)
+            {
+            const double binLower = internal->Origin + (iter->first * width);
+            if (binLower > visible[2])
+              {
+              break;
+              }
+
+            const vtkInternal::Bin& bin = iter->second;
+            const double extent =
+              std::max(std::min(bin.Coverage, width),
+                       static_cast<double>(minWidth));
+            const double mid = binLower + 0.5 * width;
+
+            lines.push_back(static_cast<float>(mid - 0.5 * extent));
+            lines.push_back(row->first);
+            lines.push_back(static_cast<float>(mid + 0.5 * extent));
+            lines.push_back(row->first);
 
-        // draw intervals
-        for (vtkIdType i = 0; i < numPoints - 1; i += 2)
+            unsigned char color[4];
+            for (int k = 0; k < 4; ++k)
+              {
+              color[k] = static_cast<unsigned char>(
+                bin.Color[k] / bin.Count + 0.5);
+              }
+            lineColors.insert(lineColors.end(), color, color + 4);
+            lineColors.insert(lineColors.end(), color, color + 4);
+            }
+          }
+        nc_comps = 4;
+        }
+      else
+        {
+        // Draw each visible interval; the intervals are drawn in order, so
+        // that overlapping intervals are stacked as they were added
+        const std::vector<vtkIdType> ids =
+          internal->FindIntervals(visible[0], visible[2]);
+        lines.reserve(4 * ids.size());
+        for (size_t k = 0; k < ids.size(); ++k)
           {
+          const vtkIdType i = 2 * ids[k];
           float points[4] =
             {
             data[i].GetX(),
@@ -123,32 +537,28 @@ bool vtkVgPlotTimeline::Paint(vtkContext2D* painter)
             data[i + 1].GetY()
             };
 
-          // Enforce a minimum screen width to ensure the item remains visible.
-          if (widthScale > 0.0f)
+          if (points[2] - points[0] < minWidth)
             {
-            float screenWidth = (points[2] - points[0]) * widthScale;
-            if (screenWidth < minScreenWidth)
-              {
-              float halfWidth = 0.5f * minScreenWidth / widthScale;
-              float mid = 0.5f * (points[0] + points[2]);
-              points[0] = mid - halfWidth;
-              points[2] = mid + halfWidth;
-              }
+            float mid = 0.5f * (points[0] + points[2]);
+            points[0] = mid - 0.5f * minWidth;
+            points[2] = mid + 0.5f * minWidth;
             }
 
-          painter->DrawPoly(points, 2, c, nc_comps);
-          c += nc_comps * 2;
+          lines.insert(lines.end(), points, points + 4);
+          if (c)
+            {
+            lineColors.insert(lineColors.end(), c + (i * nc_comps),
+                              c + ((i + 2) * nc_comps));
+            }
           }
         }
-      else // not coloring with scalars
+
+      // Draw all of the segments at once
+      if (!lines.empty())
         {
-        for (vtkIdType i = 0; i < numPoints - 1; i += 2)
-          {
-          painter->DrawLine(data[i].GetX(),
-                            data[i].GetY(),
-                            data[i + 1].GetX(),
-                            data[i + 1].GetY());
-          }
+        painter->GetDevice()->DrawLines(
+          &lines[0], static_cast<int>(lines.size() / 2),
+          c ? &lineColors[0] : 0, c ? nc_comps : 0);
         }
       }
     else
@@ -268,13 +678,18 @@ bool vtkVgPlotTimeline::SelectIntervals(const vtkVector2f& point,
     }
   this->Selection->SetNumberOfTuples(0);
 
-  // Iterate through all points and check whether any are in range
+  // Check the intervals which overlap the tolerance range in x
   vtkVector2f* data = static_cast<vtkVector2f*>(
                         this->Points->GetVoidPointer(0));
-  vtkIdType n = this->Points->GetNumberOfPoints();
 
-  for (vtkIdType i = 0; i < n - 1; i += 2)
+  this->UpdateIntervals();
+  const std::vector<vtkIdType> candidates =
+    this->Internal->FindIntervals(point.GetX() - tol.GetX(),
+                                  point.GetX() + tol.GetX());
+
+  for (size_t k = 0; k < candidates.size(); ++k)
     {
+    const vtkIdType i = 2 * candidates[k];
     if (this->InRange(point, tol, data[i], data[i + 1]))
       {
       // only add the 'head' id to the selection
@@ -320,22 +735,25 @@ vtkIdTypeArray* vtkVgPlotTimeline::GetIntervalIdsInArea(
   vtkVector2f* points = static_cast<vtkVector2f*>(
                           this->Points->GetVoidPointer(0));
 
-  // sort ids according to the x values of the corresponding points
-  if (!this->SortedIds || this->SortTime < this->BuildTime)
+  // find intervals which overlap the tolerance range in x
+  this->UpdateIntervals();
+  const std::vector<vtkIdType> candidates =
+    this->Internal->FindIntervals(point.GetX() - tol.GetX(),
+                                  point.GetX() + tol.GetX());
+
+  // now consider the y axis; only interval end points are reported
+  std::vector<vtkIdType> hits;
+  for (size_t k = 0; k < candidates.size(); ++k)
     {
-    this->SortTime.Modified();
-    delete [] this->SortedIds;
-    this->SortedIds = new vtkIdType[n];
-    std::generate(this->SortedIds, this->SortedIds + n, GenSeries());
-    std::sort(this->SortedIds, this->SortedIds + n, CompareIds(points));
+    const vtkIdType currId = 2 * candidates[k] + 1;
+    if (this->InRange(point, tol, points[currId - 1], points[currId]))
+      {
+      hits.push_back(currId);
+      }
     }
 
-  // get the lowest point we might hit within the supplied tolerance
-  double lowX = point.GetX() - tol.GetX();
-
-  IdToPointXIter begin(points, this->SortedIds);
-  IdToPointXIter end(points, this->SortedIds + n);
-  IdToPointXIter low = std::lower_bound(begin, end, lowX);
+  // report hits in order of the x values of their end points
+  std::stable_sort(hits.begin(), hits.end(), CompareIds(points));
 
   // set up the array
   if (!this->AreaPointIds)
@@ -344,18 +762,9 @@ vtkIdTypeArray* vtkVgPlotTimeline::GetIntervalIdsInArea(
     }
   this->AreaPointIds->SetNumberOfTuples(0);
 
-  // now consider the y axis
-  for (; low != end; ++low)
+  for (size_t k = 0; k < hits.size(); ++k)
     {
-    // only consider interval end points
-    vtkIdType currId = *(low.Pointer);
-    if (currId % 2 == 1)
-      {
-      if (this->InRange(point, tol, points[currId - 1], points[currId]))
-        {
-        this->AreaPointIds->InsertNextValue(currId);
-        };
-      }
+    this->AreaPointIds->InsertNextValue(hits[k]);
     }
 
   return this->AreaPointIds;
@@ -380,8 +789,10 @@ vtkIdTypeArray* vtkVgPlotTimeline::GetPointIdsInArea(const vtkVector2f& point,
                           this->Points->GetVoidPointer(0));
 
   // sort ids according to the x values of the corresponding points
-  if (!this->SortedIds)
+  if (!this->SortedIds || this->SortTime < this->BuildTime)
     {
+    this->SortTime.Modified();
+    delete [] this->SortedIds;
     this->SortedIds = new vtkIdType[n];
     std::generate(this->SortedIds, this->SortedIds + n, GenSeries());
     std::sort(this->SortedIds, this->SortedIds + n, CompareIds(points));
@@ -451,4 +862,8 @@ bool vtkVgPlotTimeline::InRange(const vtkVector2f& point,
 void vtkVgPlotTimeline::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "IsIntervalPlot: " << this->IsIntervalPlot << endl;
+  os << indent << "LevelOfDetailThreshold: "
+     << this->LevelOfDetailThreshold << endl;
 }
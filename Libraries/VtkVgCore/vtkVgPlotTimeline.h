@@ -54,6 +54,14 @@ public:
   vtkSetMacro(IsIntervalPlot, bool);
   vtkGetMacro(IsIntervalPlot, bool);
 
+  // Description:
+  // Set/get the number of intervals above which an interval plot is drawn
+  // from a binned summary of the intervals, rather than drawing each interval
+  // individually, when zoomed out far enough that the bins of the summary are
+  // no wider than a pixel. The default is 2000.
+  vtkSetMacro(LevelOfDetailThreshold, int);
+  vtkGetMacro(LevelOfDetailThreshold, int);
+
   // Description:
   // A General setter/getter
   virtual void SetProperty(const vtkStdString& property,
@@ -74,7 +82,10 @@ protected:
   vtkIdType* SortedIds;
   vtkIdTypeArray* AreaPointIds;
 
+  void UpdateIntervals();
+
   bool IsIntervalPlot;
+  int LevelOfDetailThreshold;
 
   vtkTimeStamp SortTime;
 
@@ -84,6 +95,9 @@ private:
   vtkVgPlotTimeline(const vtkVgPlotTimeline&);  // Not implemented.
   void operator=(const vtkVgPlotTimeline&);  // Not implemented.
 
+  class vtkInternal;
+  vtkInternal* Internal;
+
 //ETX
 };
 
@@ -43,6 +43,7 @@ public:
   TimeToIdMapConstIter AllPointsIdMapIterator;
 
   vtkTimeStamp BuildTime;
+  vtkTimeStamp PointEditTime;
   bool LastDisplayedRegardlessOfFrame;
   bool ClosureOfEmptyTrack;
 
@@ -312,6 +313,8 @@ void vtkVgTrack::CopyData(vtkVgTrack* other)
   this->PVO[2] = other->PVO[2];
 
   this->TOC = other->TOC;
+
+  this->Internal->PointEditTime.Modified();
 }
 
 //-----------------------------------------------------------------------------
@@ -764,6 +767,7 @@ void vtkVgTrack::SetPoint(const vtkVgTimeStamp& timeStamp,
     this->StartFrame = timeStamp;
     }
 
+  this->Internal->PointEditTime.Modified();
   this->Modified();
 }
 
@@ -841,6 +845,7 @@ void vtkVgTrack::DeletePoint(const vtkVgTimeStamp& timeStamp,
     this->StartFrame = this->Internal->PointIdMap.begin()->first;
     }
 
+  this->Internal->PointEditTime.Modified();
   this->Modified();
 }
 
@@ -1308,6 +1313,13 @@ void vtkVgTrack::InitPathTraversal()
   this->Internal->AllPointsIdMapIterator = this->Internal->AllPointsIdMap.begin();
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgTrack::InitPathTraversal(const vtkVgTimeStamp& start)
+{
+  this->Internal->AllPointsIdMapIterator =
+    this->Internal->AllPointsIdMap.lower_bound(start);
+}
+
 //-----------------------------------------------------------------------------
 vtkIdType vtkVgTrack::GetNextPathPt(vtkVgTimeStamp& timeStamp)
 {
@@ -1320,6 +1332,12 @@ vtkIdType vtkVgTrack::GetNextPathPt(vtkVgTimeStamp& timeStamp)
   return -1;
 }
 
+//-----------------------------------------------------------------------------
+vtkMTimeType vtkVgTrack::GetPointEditTime()
+{
+  return this->Internal->PointEditTime.GetMTime();
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgTrack::SetPVO(double person, double vehicle, double other)
 {
@@ -254,6 +254,18 @@ public:
   void InitPathTraversal();
   vtkIdType GetNextPathPt(vtkVgTimeStamp& timeStamp);
 
+  // Description:
+  // Start path traversal at the first path point at or after \a start.
+  void InitPathTraversal(const vtkVgTimeStamp& start);
+
+  // Description:
+  // Get the time at which existing points of the track were last changed
+  // (replaced, removed or copied from another track). Appending points to
+  // the end of the track does not update this time, so consumers that process
+  // the path incrementally can compare it against the time of their last
+  // update to decide whether the points already seen must be processed again.
+  vtkMTimeType GetPointEditTime();
+
   // Description:
   // Get / set the normalcy value of the track.
   vtkSetMacro(Normalcy, double);
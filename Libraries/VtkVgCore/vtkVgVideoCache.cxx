@@ -2,189 +2,745 @@
 // OSI-approved BSD 3-Clause License. See top-level LICENSE file or
 // https://github.com/Kitware/vivia/blob/master/LICENSE for details.
 
-// VTK includes.
 #include "vtkVgVideoCache.h"
-#include "vtkImageData.h"
-#include "vtkObjectFactory.h"
-#include "vtkSmartPointer.h"
-#include "vtkXMLImageDataReader.h"
-#include "vtkPointData.h"
-#include "vtkImageClip.h"
-
-// Standard VTK macro.
+
+#include "vtkVgTimeStamp.h"
+#include "vtkVgVideoFrame.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+#include <deque>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+
+#include <cmath>
+
 vtkStandardNewMacro(vtkVgVideoCache);
 
-//----------------------------------------------------------------------------
-vtkVgVideoCache::vtkVgVideoCache()
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+struct CacheEntry
 {
-  this->HasData = 0;
-  for (int i = 0; i < 6; ++i)
+  vtkVgVideoFrame Frame;
+  vtkTypeInt64 Size;
+  std::list<vtkVgTimeStamp>::iterator UsageIter;
+};
+
+//-----------------------------------------------------------------------------
+struct LoadRequest
+{
+  vtkVgTimeStamp First;
+  vtkVgTimeStamp Last;
+  int MaxFrames;
+  vg::SeekMode Direction;
+  bool IsPrefetch;
+};
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 frameSize(const vtkVgVideoFrame& frame)
+{
+  const vtkImageData* image = frame.Image.GetVolatileConstPointer();
+  if (!image)
     {
-    this->WholeExtent[i] = 0;
+    return 0;
     }
-  for (int i = 0; i < 6; ++i)
+
+  // GetActualMemorySize reports KiB
+  return 1024 * static_cast<vtkTypeInt64>(
+    const_cast<vtkImageData*>(image)->GetActualMemorySize());
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoFrame copyFrame(const vtkVgVideoFrame& frame)
+{
+  // Copy the image data itself; sharing the image would let a consumer that
+  // shallow copies or modifies it corrupt the cached frame
+  vtkVgVideoFrame result;
+  result.MetaData = frame.MetaData;
+
+  const vtkImageData* image = frame.Image.GetVolatileConstPointer();
+  vtkImageData* copy = 0;
+  if (image)
     {
-    this->Extent[i] = 0;
+    copy = vtkImageData::New();
+    copy->DeepCopy(const_cast<vtkImageData*>(image));
     }
-  this->ImageData = NULL;
-  this->CacheReader = NULL;
-  this->Resolution = 0;
+  result.Image.Reset(copy);
+
+  return result;
 }
 
-//----------------------------------------------------------------------------
-vtkVgVideoCache::~vtkVgVideoCache()
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+class vtkVgVideoCache::vtkInternal
 {
-}
+public:
+  typedef std::map<vtkVgTimeStamp, CacheEntry> FrameMap;
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::PrintSelf(ostream& os, vtkIndent indent)
+  vtkInternal();
+  ~vtkInternal();
+
+  // The following require CacheMutex to be held
+  FrameMap::iterator FindExact(const vtkVgTimeStamp& ts);
+  bool Lookup(const vtkVgTimeStamp& ts, vtkVgVideoFrame& frame);
+  bool SetRequestTime(const vtkVgTimeStamp& ts);
+  void Touch(FrameMap::iterator iter);
+  void Insert(const vtkVgVideoFrame& frame);
+  void Evict(FrameMap::iterator iter);
+  void EnforceBudget();
+  void ClearFrames();
+  void ClearRequests(bool prefetchOnly);
+  void Enqueue(const LoadRequest& request);
+
+  // Background thread
+  void Run();
+  void Process(LoadRequest request, std::unique_lock<std::mutex>& lock);
+
+  vtkSmartPointer<vtkVgVideoSourceBase> Source;
+
+  vtkTypeInt64 MemoryBudget;
+  int EvictionPolicy;
+  int PrefetchCount;
+
+  FrameMap Frames;
+  std::list<vtkVgTimeStamp> Usage; // front is most recently used
+  vtkTypeInt64 CachedBytes;
+  vtkVgTimeStamp LastRequestTime;
+
+  vtkTypeInt64 Hits;
+  vtkTypeInt64 Misses;
+  vtkTypeInt64 Evictions;
+  vtkTypeInt64 Prefetched;
+
+  std::deque<LoadRequest> Requests;
+  bool Busy;
+  bool BusyWithPrefetch;
+  bool Stop;
+  unsigned int Generation;
+
+  // Background task draining Requests; valid while Busy
+  std::shared_future<void> Task;
+
+  // Protects all of the above
+  mutable std::mutex CacheMutex;
+
+  // Serializes access to Source, which need not be thread safe; when both
+  // are needed, SourceMutex must be acquired before CacheMutex
+  mutable std::mutex SourceMutex;
+};
+
+//-----------------------------------------------------------------------------
+vtkVgVideoCache::vtkInternal::vtkInternal() :
+  MemoryBudget(256 << 20),
+  EvictionPolicy(vtkVgVideoCache::LeastRecentlyUsed),
+  PrefetchCount(0),
+  CachedBytes(0),
+  Hits(0), Misses(0), Evictions(0), Prefetched(0),
+  Busy(false), BusyWithPrefetch(false), Stop(false), Generation(0)
 {
-  Superclass::PrintSelf(os, indent);
+}
 
-  // @TODO: Implement this.
+//-----------------------------------------------------------------------------
+vtkVgVideoCache::vtkInternal::~vtkInternal()
+{
+  std::shared_future<void> task;
+    {
+    std::lock_guard<std::mutex> lock(this->CacheMutex);
+    this->Stop = true;
+    this->Requests.clear();
+    task = this->Task;
+    }
+  if (task.valid())
+    {
+    task.wait();
+    }
 }
 
-//----------------------------------------------------------------------------
-double vtkVgVideoCache::GetResolution()
+//-----------------------------------------------------------------------------
+vtkVgVideoCache::vtkInternal::FrameMap::iterator
+vtkVgVideoCache::vtkInternal::FindExact(const vtkVgTimeStamp& ts)
 {
-  return this->Resolution;
+  FrameMap::iterator iter = this->Frames.find(ts);
+  return (iter != this->Frames.end() && iter->first == ts)
+         ? iter : this->Frames.end();
 }
 
-//----------------------------------------------------------------------------
-int vtkVgVideoCache::ContainsRequest(unsigned int e[6])
+//-----------------------------------------------------------------------------
+bool vtkVgVideoCache::vtkInternal::Lookup(
+  const vtkVgTimeStamp& ts, vtkVgVideoFrame& frame)
 {
-  if (!this->HasData)
+  FrameMap::iterator iter = this->FindExact(ts);
+  if (iter == this->Frames.end())
     {
-    return 0;
+    return false;
     }
 
-  for (int i = 0; i < 3; ++i)
+  ++this->Hits;
+  this->Touch(iter);
+  frame = copyFrame(iter->second.Frame);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgVideoCache::vtkInternal::SetRequestTime(const vtkVgTimeStamp& ts)
+{
+  // Move the play head, so that the prefetch window eviction policy measures
+  // distance from the frame being requested; returns true if the play head
+  // moved backward
+  if (!ts.IsValid())
     {
-    if (e[2 * i] < this->Extent[2 * i] || e[2 * i + 1] > this->Extent[2 * i + 1])
-      {
-      return 0;
-      }
+    return false;
     }
 
-  return 1;
+  const bool reverse =
+    this->LastRequestTime.IsValid() && ts < this->LastRequestTime;
+  this->LastRequestTime = ts;
+  return reverse;
 }
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::
-GetData(unsigned int e[6], vtkSmartPointer<vtkImageData> image)
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Touch(FrameMap::iterator iter)
 {
-  // If no data then configure the image accordingly.
-  if (!this->HasData || this->ImageData == NULL)
+  this->Usage.splice(this->Usage.begin(), this->Usage, iter->second.UsageIter);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Insert(const vtkVgVideoFrame& frame)
+{
+  const vtkVgTimeStamp& ts = frame.MetaData.Time;
+  if (!ts.IsValid() || this->FindExact(ts) != this->Frames.end())
+    {
+    return;
+    }
+
+  const vtkTypeInt64 size = frameSize(frame);
+  if (size > this->MemoryBudget)
     {
-    image->SetWholeExtent(0, 0, 0, 0, 0, 0);
-    image->SetExtent(0, 0, 0, 0, 0, 0);
-    image->GetPointData()->SetScalars(NULL);
     return;
     }
 
-  // Okay we assume the request e[6] is in the cache (since we should have checked).
-  // We need to set up the image appropriately.
-  unsigned int cE[6];
-  vtkSmartPointer<vtkImageClip> clip = vtkSmartPointer<vtkImageClip>::New();
-  clip->SetInputData(this->ImageData);
-  this->ConvertWholeExtentsToCacheExtents(e, cE);
-  clip->SetOutputWholeExtent(cE[0], cE[1], cE[2], cE[3], cE[4], cE[5]);
-  clip->ClipDataOn();
-  clip->Update();
-  image->ShallowCopy(clip->GetOutput());
+  this->Usage.push_front(ts);
+
+  CacheEntry& entry = this->Frames[ts];
+  entry.Frame = frame;
+  entry.Size = size;
+  entry.UsageIter = this->Usage.begin();
+
+  this->CachedBytes += size;
+  this->EnforceBudget();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Evict(FrameMap::iterator iter)
+{
+  this->CachedBytes -= iter->second.Size;
+  this->Usage.erase(iter->second.UsageIter);
+  this->Frames.erase(iter);
+  ++this->Evictions;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::EnforceBudget()
+{
+  while (this->CachedBytes > this->MemoryBudget && !this->Frames.empty())
+    {
+    if (this->EvictionPolicy == vtkVgVideoCache::PrefetchWindow &&
+        this->LastRequestTime.IsValid())
+      {
+      // Evict whichever end of the cached range is farther from the play
+      // head; since the map is ordered, that is always the first or last
+      FrameMap::iterator first = this->Frames.begin();
+      FrameMap::iterator last = this->Frames.end();
+      --last;
+
+      const double df = std::fabs(
+        this->LastRequestTime.GetTimeDifferenceInSecs(first->first));
+      const double dl = std::fabs(
+        this->LastRequestTime.GetTimeDifferenceInSecs(last->first));
+      this->Evict(df > dl ? first : last);
+      }
+    else
+      {
+      this->Evict(this->Frames.find(this->Usage.back()));
+      }
+    }
+}
 
-  return;
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::ClearFrames()
+{
+  this->Frames.clear();
+  this->Usage.clear();
+  this->CachedBytes = 0;
 }
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::RequestData(unsigned int vtkNotUsed(e)[6])
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::ClearRequests(bool prefetchOnly)
 {
-  //The cache needs to talk to the reader
+  std::deque<LoadRequest>::iterator iter = this->Requests.begin();
+  while (iter != this->Requests.end())
+    {
+    (!prefetchOnly || iter->IsPrefetch)
+      ? iter = this->Requests.erase(iter)
+      : ++iter;
+    }
+
+  // Also abandon the request in progress, if it is one being discarded
+  if (this->Busy && (!prefetchOnly || this->BusyWithPrefetch))
+    {
+    ++this->Generation;
+    }
 }
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::LoadData(unsigned int vtkNotUsed(e)[6],
-                               vtkSmartPointer<vtkImageData> vtkNotUsed(image))
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Enqueue(const LoadRequest& request)
 {
-  //The reader should be invoking this method in response to a RequestData()
+  this->Requests.push_back(request);
+
+  // Start a task to drain the queue, unless one is already running (a
+  // finished task has cleared Busy under the lock, so is about to exit, and
+  // replacing it blocks only for that)
+  if (!this->Busy)
+    {
+    this->Busy = true;
+    this->Task =
+      std::async(std::launch::async, [this]{ this->Run(); }).share();
+    }
 }
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::LoadCacheFromFile(char* file,
-  int wholeExtentFlag, unsigned int e[6])
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Run()
 {
-  // First thing to do is clean out the existing data
-  this->ImageData = vtkSmartPointer<vtkImageData>::New();
+  std::unique_lock<std::mutex> lock(this->CacheMutex);
+  while (!this->Stop && !this->Requests.empty())
+    {
+    this->BusyWithPrefetch = this->Requests.front().IsPrefetch;
+    const LoadRequest request = this->Requests.front();
+    this->Requests.pop_front();
+    this->Process(request, lock);
+    }
 
-  // Okay read the data
-  this->CacheReader = vtkSmartPointer<vtkXMLImageDataReader>::New();
-  this->CacheReader->SetFileName(file);
-  this->CacheReader->Update();
+  this->Busy = false;
+  this->BusyWithPrefetch = false;
+}
 
-  // If successful read
-  this->HasData = 1;
-  this->ImageData = this->CacheReader->GetOutput();
-  this->CacheReader = NULL;
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::vtkInternal::Process(
+  LoadRequest request, std::unique_lock<std::mutex>& lock)
+{
+  const unsigned int generation = this->Generation;
+  const bool reverse = (request.Direction == vg::SeekPrevious);
+  vg::SeekMode seek = (reverse ? vg::SeekUpperBound : vg::SeekLowerBound);
 
-  // If the wholeExtent flag is set then this cache data covers
-  // the whole data extent otherwise it satisfies the request e[6].
-  if (wholeExtentFlag)
+  vtkVgTimeStamp ts = request.First;
+  vtkVgTimeStamp previous;
+  for (int count = 0; request.MaxFrames < 0 || count < request.MaxFrames;
+       ++count)
     {
-    for (int i = 0; i < 6; ++i)
+    // Release the cache while talking to the source, so that the GUI thread
+    // can still be served from the cache
+    vtkVgVideoFrame frame;
+    bool cached = false;
+    lock.unlock();
+      {
+      std::lock_guard<std::mutex> sourceLock(this->SourceMutex);
+      ts = (this->Source ? this->Source->ResolveSeek(ts, seek)
+                         : vtkVgTimeStamp());
+
+      // Stop at the end of the video or of the requested range, or if the
+      // source did not advance (e.g. because it clamps at the ends)
+      if (!ts.IsValid() ||
+          (previous.IsValid() && !(reverse ? ts < previous : previous < ts)) ||
+          (request.Last.IsValid() &&
+           (reverse ? ts < request.Last : request.Last < ts)))
+        {
+        lock.lock();
+        return;
+        }
+
+        {
+        std::lock_guard<std::mutex> cacheLock(this->CacheMutex);
+        cached = (this->FindExact(ts) != this->Frames.end());
+        }
+      if (!cached)
+        {
+        frame = this->Source->GetFrame(ts, vg::SeekExact);
+        }
+      }
+    lock.lock();
+
+    if (this->Stop || generation != this->Generation)
+      {
+      return;
+      }
+
+    if (!cached && frame.MetaData.Time.IsValid())
       {
-      this->Extent[i] = this->WholeExtent[i];
+      this->Insert(frame);
+      ++this->Prefetched;
       }
+
+    previous = ts;
+    seek = request.Direction;
     }
-  else
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoCache::vtkVgVideoCache() : Internal(new vtkInternal)
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoCache::~vtkVgVideoCache()
+{
+  delete this->Internal;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  os << indent << "VideoSource: " << this->Internal->Source.GetPointer()
+     << '\n'
+     << indent << "MemoryBudget: " << this->Internal->MemoryBudget << '\n'
+     << indent << "EvictionPolicy: "
+     << (this->Internal->EvictionPolicy == PrefetchWindow
+         ? "PrefetchWindow" : "LeastRecentlyUsed") << '\n'
+     << indent << "PrefetchCount: " << this->Internal->PrefetchCount << '\n'
+     << indent << "CachedFrames: " << this->Internal->Frames.size() << '\n'
+     << indent << "CachedBytes: " << this->Internal->CachedBytes << '\n'
+     << indent << "Hits: " << this->Internal->Hits << '\n'
+     << indent << "Misses: " << this->Internal->Misses << '\n'
+     << indent << "Evictions: " << this->Internal->Evictions << '\n'
+     << indent << "Prefetched: " << this->Internal->Prefetched << '\n';
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::SetVideoSource(vtkVgVideoSourceBase* source)
+{
     {
-    int i;
-    for (i = 0; i < 6; ++i)
+    std::lock_guard<std::mutex> sourceLock(this->Internal->SourceMutex);
+    std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+    if (this->Internal->Source == source)
       {
-      this->Extent[i] = e[i];
+      return;
       }
-    for (i = 0; i < 3; ++i) //crop to whole extent
+
+    this->Internal->ClearRequests(false);
+    this->Internal->ClearFrames();
+    this->Internal->LastRequestTime.Reset();
+    this->Internal->Source = source;
+    }
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoSourceBase* vtkVgVideoCache::GetVideoSource()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->Source;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::SetMemoryBudget(vtkTypeInt64 bytes)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->MemoryBudget = bytes;
+  this->Internal->EnforceBudget();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetMemoryBudget() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->MemoryBudget;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::SetEvictionPolicy(int policy)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->EvictionPolicy = policy;
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgVideoCache::GetEvictionPolicy() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->EvictionPolicy;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::SetPrefetchCount(int count)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->PrefetchCount = count;
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgVideoCache::GetPrefetchCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->PrefetchCount;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::RequestRange(
+  const vtkVgTimeStamp& first, const vtkVgTimeStamp& last)
+{
+  LoadRequest request;
+  request.First = first;
+  request.Last = last;
+  request.MaxFrames = -1;
+  request.Direction = vg::SeekNext;
+  request.IsPrefetch = false;
+
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->Enqueue(request);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::WaitForPendingRequests()
+{
+  // A request may start a new task while we wait, so wait until the cache is
+  // idle
+  for (;;)
+    {
+    std::shared_future<void> task;
       {
-      if (this->Extent[2 * i] < this->WholeExtent[2 * i])
-        {
-        this->Extent[2 * i] = this->WholeExtent[2 * i];
-        }
-      if (this->Extent[2 * i + 1] > this->WholeExtent[2 * i + 1])
+      std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+      if (!this->Internal->Busy)
         {
-        this->Extent[2 * i + 1] = this->WholeExtent[2 * i + 1];
+        return;
         }
+      task = this->Internal->Task;
       }
+    task.wait();
     }
 }
 
-//----------------------------------------------------------------------------
-void vtkVgVideoCache::
-ConvertWholeExtentsToCacheExtents(unsigned int wE[6], unsigned int cE[6])
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::CancelPendingRequests()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->ClearRequests(false);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->ClearFrames();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetHitCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->Hits;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetMissCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->Misses;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetEvictionCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->Evictions;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetPrefetchedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->Prefetched;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgVideoCache::GetCachedBytes() const
 {
-  // note that the extent should be contained in the cache
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return this->Internal->CachedBytes;
+}
 
-  // Get the size of the cache (i.e., dimensions)
-  int cExtent[6], cDims[3];
-  this->ImageData->GetDimensions(cDims);
-  this->ImageData->GetExtent(cExtent);
+//-----------------------------------------------------------------------------
+int vtkVgVideoCache::GetCachedFrameCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  return static_cast<int>(this->Internal->Frames.size());
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoCache::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->CacheMutex);
+  this->Internal->Hits = 0;
+  this->Internal->Misses = 0;
+  this->Internal->Evictions = 0;
+  this->Internal->Prefetched = 0;
+}
 
-  // Perform the coordinate conversion. Pad out a tad.
-  for (int i = 0; i < 3; ++i)
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp vtkVgVideoCache::ResolveSeek(
+  const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+{
+  std::lock_guard<std::mutex> sourceLock(this->Internal->SourceMutex);
+  if (this->Internal->Source)
+    {
+    return this->Internal->Source->ResolveSeek(ts, direction);
+    }
+  return vtkVgTimeStamp();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoFrame vtkVgVideoCache::GetFrame(
+  const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+{
+  vtkInternal* const d = this->Internal;
+  vtkVgVideoFrame result;
+  bool reverse = false;
+  bool found = false;
+
+  // An exact request for a cached frame is answered without consulting the
+  // source at all, and so without waiting on the source lock, which the
+  // background thread holds while it decodes
+  if (direction == vg::SeekExact)
     {
-    cE[2 * i] = cExtent[2 * i] + cDims[i]
-      * static_cast<double>(wE[2 * i] - this->Extent[2 * i] + 1)
-      / (this->Extent[2 * i + 1] - this->Extent[2 * i] + 1) - 1;
-    cE[2 * i + 1] = cExtent[2 * i] + cDims[i]
-      * static_cast<double>(wE[2 * i + 1] - this->Extent[2 * i] + 1)
-      / (this->Extent[2 * i + 1] - this->Extent[2 * i] + 1) + 1;
+    std::lock_guard<std::mutex> lock(d->CacheMutex);
+    if (!d->Source)
+      {
+      return result;
+      }
+
+    reverse = d->SetRequestTime(ts);
+    found = d->Lookup(ts, result);
+    }
+
+  if (!found)
+    {
+    std::lock_guard<std::mutex> sourceLock(d->SourceMutex);
+    if (!d->Source)
+      {
+      return result;
+      }
+
+    // Anything other than an exact request must first be resolved to the
+    // actual frame time
+    vtkVgTimeStamp resolved = ts;
+    if (direction != vg::SeekExact)
+      {
+      resolved = d->Source->ResolveSeek(ts, direction);
+      }
 
-    if (cE[2 * i] < static_cast<unsigned int>(cExtent[2 * i]))
       {
-      cE[2 * i] = cExtent[2 * i];
+      std::lock_guard<std::mutex> lock(d->CacheMutex);
+      if (direction != vg::SeekExact)
+        {
+        reverse = d->SetRequestTime(resolved);
+        }
+
+      // Check the cache (again, for an exact request, as the background
+      // thread may have loaded the frame while we waited for the source)
+      found = d->Lookup(resolved, result);
       }
-    if (cE[2 * i + 1] > static_cast<unsigned int>(cExtent[2 * i + 1]))
+
+    if (!found)
       {
-      cE[2 * i + 1] = cExtent[2 * i + 1];
+      result = d->Source->GetFrame(resolved, vg::SeekExact);
+
+      std::lock_guard<std::mutex> lock(d->CacheMutex);
+      ++d->Misses;
+      if (result.MetaData.Time.IsValid())
+        {
+        d->Insert(copyFrame(result));
+        }
       }
     }
 
+  // Schedule prefetching of the frames that follow in the direction of play
+  std::lock_guard<std::mutex> lock(d->CacheMutex);
+  if (d->PrefetchCount > 0 && result.MetaData.Time.IsValid())
+    {
+    LoadRequest request;
+    request.First = result.MetaData.Time;
+    request.MaxFrames = d->PrefetchCount + 1;
+    request.Direction = (reverse ? vg::SeekPrevious : vg::SeekNext);
+    request.IsPrefetch = true;
+
+    // Supersede any outstanding prefetch; the play head has moved on
+    d->ClearRequests(true);
+    d->Enqueue(request);
+    }
+
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoFrameMetaData vtkVgVideoCache::GetMetadata(
+  const vtkVgTimeStamp& ts, vg::SeekMode direction) const
+{
+  vtkInternal* const d = this->Internal;
+
+  if (direction == vg::SeekExact)
+    {
+    std::lock_guard<std::mutex> lock(d->CacheMutex);
+    vtkInternal::FrameMap::iterator iter = d->FindExact(ts);
+    if (iter != d->Frames.end())
+      {
+      return iter->second.Frame.MetaData;
+      }
+    }
+
+  std::lock_guard<std::mutex> sourceLock(d->SourceMutex);
+  if (d->Source)
+    {
+    return d->Source->GetMetadata(ts, direction);
+    }
+  return vtkVgVideoFrameMetaData();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp vtkVgVideoCache::GetMinTime() const
+{
+  std::lock_guard<std::mutex> sourceLock(this->Internal->SourceMutex);
+  if (this->Internal->Source)
+    {
+    return this->Internal->Source->GetMinTime();
+    }
+  return vtkVgTimeStamp();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp vtkVgVideoCache::GetMaxTime() const
+{
+  std::lock_guard<std::mutex> sourceLock(this->Internal->SourceMutex);
+  if (this->Internal->Source)
+    {
+    return this->Internal->Source->GetMaxTime();
+    }
+  return vtkVgTimeStamp();
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgVideoCache::GetFrameCount() const
+{
+  std::lock_guard<std::mutex> sourceLock(this->Internal->SourceMutex);
+  if (this->Internal->Source)
+    {
+    return this->Internal->Source->GetFrameCount();
+    }
+  return 0;
 }
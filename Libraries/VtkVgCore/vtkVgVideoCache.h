@@ -2,111 +2,148 @@
 // OSI-approved BSD 3-Clause License. See top-level LICENSE file or
 // https://github.com/Kitware/vivia/blob/master/LICENSE for details.
 
-// .NAME vtkVgVideoCache - cache a subset of a video stream.
+// .NAME vtkVgVideoCache - memory-bounded frame cache over a video source.
 // .SECTION Description
-// Video streams are expressed as a series of frames (images) over time.
-// The entire video stream is characterized with a whole extent defining
-// a space-time range. Requests can be made of subsets of this video stream
-// which are returned in a vtkImageData.
+// vtkVgVideoCache wraps another vtkVgVideoSourceBase and keeps decoded frames
+// in memory, up to a configurable byte budget, so that repeated requests for
+// the same frames (scrubbing, looping, multiple views) do not decode them
+// again. Because the cache is itself a vtkVgVideoSourceBase, it can be used
+// anywhere a video source is accepted, e.g. vtkVgVideoModel::SetVideoSource.
 //
-// Note that the cache contains the actual data. It knows the whole extent
-// of the data, but maintains data representing a subset of the whole extent
-// at potentially a different resolution.
+// When the budget is exceeded, frames are evicted according to the eviction
+// policy; either the least recently used frame, or the frame farthest from
+// the most recently requested time (which keeps a window of frames around
+// the play head resident).
+//
+// Frames may be loaded ahead of time on a background thread, either
+// explicitly by calling RequestRange, or automatically by setting a non-zero
+// PrefetchCount, in which case each GetFrame also schedules loading of the
+// frames that follow it in the direction of play.
+//
+// Frames are returned as copies of the cached frames, so consumers may modify
+// them freely (or hold on to their image data) without affecting the cache.
+//
+// All public methods are thread safe. Calls into the wrapped source are
+// serialized, so the wrapped source need not be thread safe itself. A
+// SeekExact request for a cached frame does not wait for the wrapped source,
+// even while a background load is decoding.
 
 #ifndef __vtkVgVideoCache_h
-#define __vtlVideoManager_h
+#define __vtkVgVideoCache_h
 
-#include "vtkObject.h"
-#include "vtkSmartPointer.h" // for memory safety
+#include "vtkVgVideoSourceBase.h"
 
-#include <vgExport.h>
+#include <vtkType.h>
 
-class vtkImageData;
-class vtkXMLImageDataReader;
+#include <vgExport.h>
 
-class VTKVG_CORE_EXPORT vtkVgVideoCache : public vtkObject
+class VTKVG_CORE_EXPORT vtkVgVideoCache : public vtkVgVideoSourceBase
 {
 public:
+  enum EvictionPolicy
+    {
+    LeastRecentlyUsed,
+    PrefetchWindow
+    };
+
+  vtkVgClassMacro(vtkVgVideoCache);
+  vtkTypeMacro(vtkVgVideoCache, vtkVgVideoSourceBase);
+
   static vtkVgVideoCache* New();
-  vtkTypeMacro(vtkVgVideoCache, vtkObject);
+
   virtual void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
-  // Specify the whole extent of the video stream. This is a 6-tuple
-  // indicating x-y-z-time min and max range. The ranges are zero
-  // offset, and time is expressed in frame numbers. The data values
-  // are (xmin,xmax,ymin,ymax,tmin,tmax).
-  vtkSetVector6Macro(WholeExtent, unsigned int);
-  vtkGetVector6Macro(WholeExtent, unsigned int);
+  // Set/Get the video source whose frames are cached. Changing the source
+  // cancels any pending background loads and clears the cache.
+  void SetVideoSource(vtkVgVideoSourceBase* source);
+  vtkVgVideoSourceBase* GetVideoSource();
+
+  // Description:
+  // Set/Get the maximum number of bytes of image data to keep in the cache.
+  // Frames larger than the budget are never cached. The default is 256 MiB.
+  void SetMemoryBudget(vtkTypeInt64 bytes);
+  vtkTypeInt64 GetMemoryBudget() const;
 
   // Description:
-  // Specify the extent of the video cache. This is a 6-tuple
-  // indicating x-y-time min and max range. The ranges are zero
-  // offset, and time is expressed in frame numbers. The data values
-  // are (xmin,xmax,ymin,ymax,tmin,tmax). Note that the extent should
-  // lie within the WholeExtent (and is in the coordinate system of the
-  // WholeExtent).
-  vtkSetVector6Macro(Extent, unsigned int);
-  vtkGetVector6Macro(Extent, unsigned int);
+  // Set/Get the policy used to choose which frames to evict when the memory
+  // budget is exceeded. The default is LeastRecentlyUsed.
+  void SetEvictionPolicy(int policy);
+  int GetEvictionPolicy() const;
+  void SetEvictionPolicyToLeastRecentlyUsed()
+    { this->SetEvictionPolicy(LeastRecentlyUsed); }
+  void SetEvictionPolicyToPrefetchWindow()
+    { this->SetEvictionPolicy(PrefetchWindow); }
 
   // Description:
-  // Return the resolution of this cache. This is the ratio of the actual
-  // extent to the whole extent of the data. (Note that the minimium
-  // resolution in the x-y directions is returned.)
-  double GetResolution();
+  // Set/Get the number of frames to load in the background following each
+  // frame request. Zero (the default) disables automatic prefetching.
+  void SetPrefetchCount(int count);
+  int GetPrefetchCount() const;
 
   // Description:
-  // Return 1 if the cache contains the requested data, 0 otherwise.
-  int ContainsRequest(unsigned int e[6]);
+  // Request that all frames in the inclusive time range be loaded into the
+  // cache on the background thread. This returns immediately.
+  void RequestRange(const vtkVgTimeStamp& first, const vtkVgTimeStamp& last);
 
   // Description:
-  // Given a request e[6], retrieve the data from the cache and place it into
-  // the vtkImageData. Note that request e[6] should have been validated
-  // previously with a ContainsRequest() invocation.
-  void GetData(unsigned int e[6], vtkSmartPointer<vtkImageData>);
+  // Block until all pending background loads have completed.
+  void WaitForPendingRequests();
 
   // Description:
-  // Given a request for data (the request e[6] is expressed in the WholeExtent
-  // coordinate system), ask the cache's reader to load data asynchronously.
-  // We expect the reader to throw an event when the cache is loaded. Note that
-  // the response to this request is that the LoadData method will update the
-  // cache with data that covers e[6] (it may be greater in extent).
-  void RequestData(unsigned int e[6]);
+  // Discard all pending background loads. A frame that is currently being
+  // decoded will still be added to the cache.
+  void CancelPendingRequests();
 
   // Description:
-  // This method loads data into the cache (typically in response to a
-  // RequestData() invocation). As it does so, it defines the Extent and
-  // DataExtent of the cache.
-  void LoadData(unsigned int extent[6], vtkSmartPointer<vtkImageData> image);
+  // Remove all frames from the cache. Statistics are not reset.
+  void Clear();
 
   // Description:
-  // This special method reads data and configures the cache. This typically
-  // is used for the low-res, full extent cache (Cache 0, and e[6] ==
-  // WholeExtent[6]).  The WholeExtent and Extent are set (to the same value)
-  // on read if initializeCache is set.
-  void LoadCacheFromFile(char* file, int wholeExtentFlag, unsigned int e[6]);
+  // Get cache statistics. Hits and misses count only GetFrame requests;
+  // frames loaded by the background thread are counted as prefetched.
+  vtkTypeInt64 GetHitCount() const;
+  vtkTypeInt64 GetMissCount() const;
+  vtkTypeInt64 GetEvictionCount() const;
+  vtkTypeInt64 GetPrefetchedCount() const;
+  vtkTypeInt64 GetCachedBytes() const;
+  int GetCachedFrameCount() const;
+  void ResetStatistics();
+
+  // \copydoc vtkVgVideoSourceBase::ResolveSeek
+  virtual vtkVgTimeStamp ResolveSeek(
+    const vtkVgTimeStamp&,
+    vg::SeekMode direction = vg::SeekNearest) const;
+
+  // \copydoc vtkVgVideoSourceBase::GetFrame
+  virtual vtkVgVideoFrame GetFrame(
+    const vtkVgTimeStamp&,
+    vg::SeekMode direction = vg::SeekNearest) const;
+
+  // \copydoc vtkVgVideoSourceBase::GetMetadata
+  virtual vtkVgVideoFrameMetaData GetMetadata(
+    const vtkVgTimeStamp&,
+    vg::SeekMode direction = vg::SeekNearest) const;
+
+  // \copydoc vtkVgVideoSourceBase::GetMinTime
+  virtual vtkVgTimeStamp GetMinTime() const;
+
+  // \copydoc vtkVgVideoSourceBase::GetMaxTime
+  virtual vtkVgTimeStamp GetMaxTime() const;
+
+  // \copydoc vtkVgVideoSourceBase::GetFrameCount
+  virtual int GetFrameCount() const;
 
 protected:
   vtkVgVideoCache();
   virtual ~vtkVgVideoCache();
 
 private:
-  vtkVgVideoCache(const vtkVgVideoCache&);  // Not implemented.
-  void operator=(const vtkVgVideoCache&);    // Not implemented.
-
-  unsigned int WholeExtent[6];
-  unsigned int Extent[6];
-  int          HasData;
-
-  vtkSmartPointer<vtkImageData> ImageData;
-  double Resolution;
-
-  // Various readers
-  vtkSmartPointer<vtkXMLImageDataReader> CacheReader;
-
-  // Convenience functions
-  void ConvertWholeExtentsToCacheExtents(unsigned int wE[6], unsigned int cE[6]);
+  class vtkInternal;
+  vtkInternal* const Internal;
 
+  vtkVgVideoCache(const vtkVgVideoCache&); // Not implemented.
+  void operator=(const vtkVgVideoCache&);  // Not implemented.
 };
 
 #endif // __vtkVgVideoCache_h
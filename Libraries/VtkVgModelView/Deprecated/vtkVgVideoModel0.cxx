@@ -160,6 +160,8 @@ int vtkVgVideoModel0::Play()
   // Reset cached application time
   this->LastAppTime = 0.0;
 
+  this->Modified();
+
   return VTK_OK;
 }
 
@@ -177,6 +179,7 @@ int vtkVgVideoModel0::Pause()
   this->Stopped = 0;
 
   this->PlayFromBeginningOff();
+  this->Modified();
 
   return VTK_OK;
 }
@@ -199,6 +202,7 @@ int vtkVgVideoModel0::Stop()
   this->CurrentSeekTime = this->ClipTimeRangeCache[0];
 
   this->PlayFromBeginningOff();
+  this->Modified();
 
   return VTK_OK;
 }
@@ -0,0 +1,103 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <qtTest.h>
+
+#include <vtkSmartPointer.h>
+
+#include "vtkVgEvent.h"
+#include "vtkVgEventModel.h"
+#include "vtkVgTimeStamp.h"
+
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp frameTime(int n)
+{
+  return vtkVgTimeStamp(n * 1e6, n);
+}
+
+//-----------------------------------------------------------------------------
+bool isActive(vtkVgEventModel* model, int frame, vtkIdType eventId)
+{
+  model->Update(frameTime(frame));
+  model->InitActiveEventTraversal();
+  for (vtkVgEventInfo info = model->GetNextActiveEvent(); info.GetEvent();
+       info = model->GetNextActiveEvent())
+    {
+    if (info.GetEvent()->GetId() == eventId)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgEvent* addEvent(vtkVgEventModel* model, vtkIdType id,
+                     int startFrame, int endFrame)
+{
+  vtkSmartPointer<vtkVgEvent> event = vtkSmartPointer<vtkVgEvent>::New();
+  event->SetId(id);
+  event->SetStartFrame(frameTime(startFrame));
+  event->SetEndFrame(frameTime(endFrame));
+  return model->AddEvent(event);
+}
+
+//-----------------------------------------------------------------------------
+int testActiveEvents(qtTest& testObject)
+{
+  vtkVgEventModel::SmartPtr model = vtkVgEventModel::SmartPtr::New();
+  addEvent(model, 1, 10, 20);
+  addEvent(model, 2, 15, 30);
+
+  TEST(!isActive(model, 5, 1));
+  TEST(isActive(model, 10, 1));
+  TEST(isActive(model, 20, 1));
+  TEST(!isActive(model, 25, 1));
+  TEST(isActive(model, 25, 2));
+
+  model->RemoveEvent(2);
+  TEST(!isActive(model, 25, 2));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testEventEditedInPlace(qtTest& testObject)
+{
+  vtkVgEventModel::SmartPtr model = vtkVgEventModel::SmartPtr::New();
+  vtkVgEvent* event = addEvent(model, 1, 10, 20);
+
+  TEST(isActive(model, 15, 1));
+  TEST(!isActive(model, 25, 1));
+
+  // Lengthen the event directly, as is done when an event in a live stream
+  // is updated; it must be active past its old end, including at the time
+  // already shown
+  event->SetEndFrame(frameTime(30));
+  TEST(isActive(model, 25, 1));
+  TEST(isActive(model, 30, 1));
+  TEST(!isActive(model, 35, 1));
+
+  // Likewise if it is shortened, or moved later
+  event->SetEndFrame(frameTime(22));
+  TEST(!isActive(model, 25, 1));
+  event->SetStartFrame(frameTime(18));
+  TEST(!isActive(model, 15, 1));
+  TEST(isActive(model, 20, 1));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Active Events",         testActiveEvents);
+  testObject.runSuite("Event Edited In Place", testEventEditedInPlace);
+  return testObject.result();
+}
@@ -8,6 +8,7 @@
 #include <vtkActor.h>
 #include <vtkCellArray.h>
 #include <vtkCollection.h>
+#include <vtkCommand.h>
 #include <vtkIdList.h>
 #include <vtkMath.h>
 #include <vtkObjectFactory.h>
@@ -29,6 +30,9 @@
 
 #include "vtkVgLabeledRegion.h"
 
+#include <vgIntervalIndex.h>
+
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <set>
@@ -46,11 +50,16 @@ struct ActivityInfo
   bool Active;
   bool DisplayActivity;
 
+  // Whether the activity passes the display state, type, saliency and event
+  // filters (i.e. everything except the current time)
+  bool Shown;
+
   ActivityInfo()
     {
     this->Activity = 0;
     this->Active = false;
     this->DisplayActivity = false;
+    this->Shown = false;
     }
 
   ~ActivityInfo()
@@ -92,6 +101,7 @@ struct ActivityInfo
     this->SetActivity(fromActivityInfo.Activity);
     this->Active = fromActivityInfo.Active;
     this->DisplayActivity = fromActivityInfo.DisplayActivity;
+    this->Shown = fromActivityInfo.Shown;
     }
 
   ActivityInfo& operator=(const ActivityInfo& fromActivityInfo)
@@ -100,10 +110,26 @@ struct ActivityInfo
     this->SetActivity(fromActivityInfo.Activity);
     this->Active = fromActivityInfo.Active;
     this->DisplayActivity = fromActivityInfo.DisplayActivity;
+    this->Shown = fromActivityInfo.Shown;
     return *this;
     }
 };
 
+//----------------------------------------------------------------------------
+// Observer of an activity in the manager, and the display window with which
+// the activity was last entered in the time index
+struct ActivityWatch
+{
+  unsigned long ObserverTag;
+  bool ShowAlways;
+  vtkVgTimeStamp Start;
+  vtkVgTimeStamp End;
+
+  ActivityWatch() : ObserverTag(0), ShowAlways(false) {}
+};
+
+typedef std::map<vtkVgActivity*, ActivityWatch> ActivityWatchMap;
+
 //----------------------------------------------------------------------------
 class vtkVgActivityManager::vtkInternal
 {
@@ -119,10 +145,47 @@ public:
 
   std::multimap<vtkVgTrack*, vtkVgActivity*>::const_iterator AdjudicationIterator;
 
-  vtkInternal(vtkVgActivityManager* activityManager) : ActivityManager(activityManager)
+  // Index of the time window (start through expiration) of each activity,
+  // by index into Activities; activities shown regardless of time are kept
+  // separately
+  vgIntervalIndex<vtkVgTimeStamp, int> TimeIndex;
+  std::vector<int> AlwaysShownActivities;
+  bool TimeIndexDirty;
+
+  // Activities may be edited in place (e.g. given more events) rather than
+  // through the manager, so the manager watches each activity for changes
+  // to its display window
+  ActivityWatchMap ActivityWatches;
+
+  // Whether the Shown state of the activities must be recomputed, and the
+  // event model filtering time it was last computed for
+  bool ShownDirty;
+  unsigned long EventFilteringTime;
+
+  // Activities which had an actor after the last update, and so must be
+  // visited again even if they are no longer within their time window
+  std::vector<int> ActorActivities;
+
+  vtkInternal(vtkVgActivityManager* activityManager) :
+    TimeIndexDirty(true), ShownDirty(true), EventFilteringTime(0),
+    ActivityManager(activityManager)
     {
     }
 
+  void UpdateShownStates();
+  void UpdateTimeIndex();
+  bool UpdateActivity(int index, const vtkVgTimeStamp& timeStamp);
+
+  void UnwatchAll()
+    {
+    for (ActivityWatchMap::iterator iter = this->ActivityWatches.begin(),
+         end = this->ActivityWatches.end(); iter != end; ++iter)
+      {
+      iter->first->RemoveObserver(iter->second.ObserverTag);
+      }
+    this->ActivityWatches.clear();
+    }
+
   ~vtkInternal()
     {
     }
@@ -130,6 +193,82 @@ public:
   vtkVgActivityManager* ActivityManager;
 };
 
+//-----------------------------------------------------------------------------
+void vtkVgActivityManager::vtkInternal::UpdateShownStates()
+{
+  for (size_t i = 0, k = this->Activities.size(); i < k; ++i)
+    {
+    ActivityInfo& info = this->Activities[i];
+    info.Shown =
+      info.DisplayActivity &&
+      !this->ActivityManager->ActivityIsFiltered(info.Activity) &&
+      this->ActivityManager->GetActivityFilteredDisplayState(
+        static_cast<int>(i));
+    }
+
+  this->ShownDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgActivityManager::vtkInternal::UpdateTimeIndex()
+{
+  this->TimeIndex.Clear();
+  this->TimeIndex.Reserve(this->Activities.size());
+  this->AlwaysShownActivities.clear();
+
+  for (size_t i = 0, k = this->Activities.size(); i < k; ++i)
+    {
+    vtkVgActivity* activity = this->Activities[i].Activity;
+
+    vtkVgTimeStamp start, end;
+    activity->GetActivityFrameExtents(start, end);
+    end.ShiftForward(activity->GetExpirationOffset());
+
+    ActivityWatchMap::iterator watchIter =
+      this->ActivityWatches.find(activity);
+    if (watchIter != this->ActivityWatches.end())
+      {
+      watchIter->second.ShowAlways = activity->GetShowAlways();
+      watchIter->second.Start = start;
+      watchIter->second.End = end;
+      }
+
+    if (activity->GetShowAlways() || !start.IsValid() || !end.IsValid())
+      {
+      this->AlwaysShownActivities.push_back(static_cast<int>(i));
+      continue;
+      }
+
+    this->TimeIndex.Insert(start, end, static_cast<int>(i));
+    }
+
+  this->TimeIndex.Build();
+  this->TimeIndexDirty = false;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgActivityManager::vtkInternal::UpdateActivity(
+  int index, const vtkVgTimeStamp& timeStamp)
+{
+  ActivityInfo& info = this->Activities[index];
+  bool actorAdded = false;
+
+  if (info.Shown)
+    {
+    if (info.Activity->SetCurrentDisplayFrame(timeStamp))
+      {
+      actorAdded = true;
+      }
+    info.Activity->SetVisibility(true);   // making sure
+    }
+  else
+    {
+    info.Activity->SetVisibility(false);
+    }
+
+  return actorAdded;
+}
+
 //-----------------------------------------------------------------------------
 vtkVgActivityManager::vtkVgActivityManager()
 {
@@ -157,6 +296,7 @@ vtkVgActivityManager::~vtkVgActivityManager()
   this->SetRenderer(0);
 
   this->ActivityTypeRegistry->Delete();
+  this->Internal->UnwatchAll();
   delete this->Internal;
 }
 
@@ -248,7 +388,11 @@ bool vtkVgActivityManager::GetActivityFilteredDisplayState(int activityIndex)
 //-----------------------------------------------------------------------------
 void vtkVgActivityManager::Initialize()
 {
+  this->Internal->UnwatchAll();
   this->Internal->Activities.clear();
+  this->Internal->ActorActivities.clear();
+  this->Internal->TimeIndexDirty = true;
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -261,6 +405,15 @@ void vtkVgActivityManager::AddActivity(vtkVgActivity* vgActivity)
   activityInfo.SetActivity(vgActivity);
   activityInfo.DisplayActivity = true;
   this->Internal->Activities.push_back(activityInfo);
+  this->Internal->TimeIndexDirty = true;
+  this->Internal->ShownDirty = true;
+
+  if (!this->Internal->ActivityWatches.count(vgActivity))
+    {
+    this->Internal->ActivityWatches[vgActivity].ObserverTag =
+      vgActivity->AddObserver(vtkCommand::ModifiedEvent, this,
+                              &vtkVgActivityManager::ActivityModified);
+    }
 
   this->SetActivityColors(vgActivity);
 
@@ -284,6 +437,35 @@ void vtkVgActivityManager::AddActivity(vtkVgActivity* vgActivity)
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgActivityManager::ActivityModified(
+  vtkObject* caller, unsigned long, void*)
+{
+  vtkInternal* const internal = this->Internal;
+  if (internal->TimeIndexDirty)
+    {
+    return;
+    }
+
+  // The time index only needs to be rebuilt if the activity's display window
+  // has moved; activities are modified for many other reasons
+  vtkVgActivity* const activity = static_cast<vtkVgActivity*>(caller);
+  ActivityWatchMap::iterator iter = internal->ActivityWatches.find(activity);
+  if (iter == internal->ActivityWatches.end())
+    {
+    return;
+    }
+
+  vtkVgTimeStamp start, end;
+  activity->GetActivityFrameExtents(start, end);
+  end.ShiftForward(activity->GetExpirationOffset());
+  if (iter->second.ShowAlways != activity->GetShowAlways() ||
+      iter->second.Start != start || iter->second.End != end)
+    {
+    internal->TimeIndexDirty = true;
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgActivityManager::UpdateActivityDisplayStates()
 {
@@ -294,6 +476,8 @@ void vtkVgActivityManager::UpdateActivityDisplayStates()
     activityIter->DisplayActivity =
       this->Internal->DisplayActivityType[activityIter->Activity->GetType()];
     }
+  this->Internal->TimeIndexDirty = true;
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -318,6 +502,20 @@ vtkVgActivity* vtkVgActivityManager::GetNextAdjudicationActivity()
   return activity;
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgActivityManager::SetActivityDisplayState(int activityIndex,
+                                                   bool state)
+{
+  if (activityIndex < 0 || activityIndex >=
+      static_cast<int>(this->Internal->Activities.size()))
+    {
+    vtkErrorMacro("Invalid index: " << activityIndex);
+    return;
+    }
+  this->Internal->Activities[activityIndex].DisplayActivity = state;
+  this->Internal->ShownDirty = true;
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgActivityManager::SetActivityState(vtkVgActivity* activity, bool state)
 {
@@ -330,6 +528,7 @@ void vtkVgActivityManager::SetActivityState(vtkVgActivity* activity, bool state)
       activityIter->DisplayActivity = state;
       }
     }
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -341,12 +540,14 @@ void vtkVgActivityManager::SetAllActivitiesDisplayState(bool state)
     {
     activityIter->DisplayActivity = state;
     }
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
 void vtkVgActivityManager::SetDisplayActivityType(int activityType, bool state)
 {
   this->Internal->DisplayActivityType[activityType] = state;
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -398,28 +599,69 @@ bool vtkVgActivityManager::UpdateActivityActors(vtkVgTimeStamp& timeStamp)
     return false;
     }
 
-  bool actorAdded = false;
+  vtkInternal* const internal = this->Internal;
+  const int count = static_cast<int>(internal->Activities.size());
 
-  std::vector<ActivityInfo>::iterator activityIter;
-  int index = 0;
-  for (activityIter = this->Internal->Activities.begin();
-       activityIter != this->Internal->Activities.end(); activityIter++, ++index)
+  // The filters only need to be evaluated again if they (or the filter
+  // results of the events) have changed
+  if (this->EventModel &&
+      this->EventModel->GetFilteringUpdateTime() !=
+      internal->EventFilteringTime)
     {
-    if (activityIter->DisplayActivity  &&
-        !this->ActivityIsFiltered(activityIter->Activity) &&
-        this->GetActivityFilteredDisplayState(index))
+    internal->EventFilteringTime = this->EventModel->GetFilteringUpdateTime();
+    internal->ShownDirty = true;
+    }
+
+  // Visit every activity after a change that may affect any of them;
+  // otherwise, only those that were showing an actor (which may need to be
+  // hidden or removed) and those whose time window contains the new time
+  std::vector<int> candidates;
+  if (internal->ShownDirty || internal->TimeIndexDirty)
+    {
+    if (internal->ShownDirty)
       {
-      if (activityIter->Activity->SetCurrentDisplayFrame(timeStamp))
-        {
-        actorAdded = true;
-        }
-      activityIter->Activity->SetVisibility(true);   // making sure
+      internal->UpdateShownStates();
+      }
+    if (internal->TimeIndexDirty)
+      {
+      internal->UpdateTimeIndex();
+      }
+
+    candidates.reserve(count);
+    for (int i = 0; i < count; ++i)
+      {
+      candidates.push_back(i);
       }
-    else
+    }
+  else
+    {
+    candidates = internal->ActorActivities;
+    candidates.insert(candidates.end(),
+                      internal->AlwaysShownActivities.begin(),
+                      internal->AlwaysShownActivities.end());
+    internal->TimeIndex.ForEachContaining(
+      timeStamp, [&candidates](int i){ candidates.push_back(i); });
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    }
+
+  bool actorAdded = false;
+  internal->ActorActivities.clear();
+  for (size_t i = 0, k = candidates.size(); i < k; ++i)
+    {
+    const int index = candidates[i];
+    if (internal->UpdateActivity(index, timeStamp))
       {
-      activityIter->Activity->SetVisibility(false);
+      actorAdded = true;
+      }
+    if (internal->Activities[index].Activity->GetActor())
+      {
+      internal->ActorActivities.push_back(index);
       }
     }
+
   return actorAdded;
 }
 
@@ -518,6 +760,7 @@ void vtkVgActivityManager::InitializeTypeInfo()
             this->Internal->DisplayActivityType.end(), true);
   std::fill(this->Internal->SaliencyThreshold.begin(),
             this->Internal->SaliencyThreshold.end(), 0.0);
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -536,6 +779,7 @@ const char* vtkVgActivityManager::GetActivityName(int activityType)
 void vtkVgActivityManager::SetSaliencyThreshold(int type, double threshold)
 {
   this->Internal->SaliencyThreshold[type] = threshold;
+  this->Internal->ShownDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -615,6 +859,7 @@ void vtkVgActivityManager::SetShowFullVolume(bool show)
     {
     iter->Activity->SetShowAlways(show);
     }
+  this->Internal->TimeIndexDirty = true;
 }
 
 //-----------------------------------------------------------------------------
@@ -626,4 +871,5 @@ void vtkVgActivityManager::SetActivityExpirationOffset(const vtkVgTimeStamp& ts)
     {
     iter->Activity->SetExpirationOffset(ts);
     }
+  this->Internal->TimeIndexDirty = true;
 }
@@ -50,6 +50,11 @@ public:
   bool GetActivityDisplayState(int activityIndex);
   bool GetActivityFilteredDisplayState(int activityIndex);
 
+  // Description:
+  // Set the display state of the activity at \p activityIndex. Unlike
+  // SetActivityState, this does not need to search for the activity.
+  void SetActivityDisplayState(int activityIndex, bool state);
+
   // Description:
   // Return whether a track is used by any activities
   bool IsTrackUsedByActivity(vtkVgTrack* track);
@@ -76,6 +81,11 @@ public:
   // Description:
   // Update all the activity actor(s). Generally called by the application layer.
   // Returns true if a new actor was added.
+  //
+  // The time window of each activity is indexed, so that only the activities
+  // that are, or were, displayed at the new time are visited. The index is
+  // rebuilt when activities are added, or when the frame extents, expiration
+  // offset or show always state of an activity are changed.
   bool UpdateActivityActors(vtkVgTimeStamp& timeStamp);
 
   // Description:
@@ -159,6 +169,11 @@ private:
 
   void SetAllActivitiesDisplayState(bool state);
 
+  // Description:
+  // Called when an activity in the manager is modified, which may have moved
+  // its display window without the manager's knowledge.
+  void ActivityModified(vtkObject* caller, unsigned long, void*);
+
   vtkVgActivityTypeRegistry* ActivityTypeRegistry;
 
   vtkVgEventModel* EventModel;
@@ -13,6 +13,8 @@
 #include "vtkVgTrack.h"
 #include "vtkVgTrackModel.h"
 
+#include <vgIntervalIndex.h>
+
 #include <vtkCommand.h>
 #include <vtkIdList.h>
 #include <vtkIdListCollection.h>
@@ -33,6 +35,24 @@ typedef std::map<vtkIdType, vtkVgEventInfo>           EventMap;
 typedef std::map<vtkIdType, vtkVgEventInfo>::iterator EventMapIterator;
 typedef std::map<int, double> EventNormalcyMap;
 
+namespace // anonymous
+{
+
+//----------------------------------------------------------------------------
+// Observer of an event in the model, and the display window with which the
+// event was last entered in the time index
+struct EventWatch
+{
+  vtkVgEvent* Event;
+  unsigned long ObserverTag;
+  vtkVgTimeStamp Start;
+  vtkVgTimeStamp End;
+};
+
+typedef std::map<vtkIdType, EventWatch> EventWatchMap;
+
+} // namespace <anonymous>
+
 //----------------------------------------------------------------------------
 struct vtkVgEventModel::vtkInternal
 {
@@ -45,8 +65,63 @@ struct vtkVgEventModel::vtkInternal
   vtkTimeStamp UpdateTime;
   vtkTimeStamp SpatialFilteringUpdateTime;
   vtkTimeStamp TemporalFilteringUpdateTime;
+  vtkTimeStamp FilteringChangeTime;
+
+  // Time of the last change made through the model's own methods; if the
+  // model MTime is newer, it was modified from outside (e.g. after an event
+  // was edited) and any event may have changed
+  vtkTimeStamp ContentsTime;
+
+  // Events that need their filter results computed (newly added or
+  // displayed), unless all events need to be filtered again
+  std::vector<vtkIdType> PendingFilterIds;
+  bool FilterAll;
+
+  // Index of event display windows, and the events active at the current
+  // time; events without a valid start and end are always active
+  vgIntervalIndex<vtkVgTimeStamp, vtkIdType> TimeIndex;
+  std::vector<vtkIdType> AlwaysActiveIds;
+  bool TimeIndexDirty;
+
+  // Events may be edited in place (e.g. extended as their tracks grow)
+  // rather than through the model, so the model watches each event for
+  // changes to its display window
+  EventWatchMap EventWatches;
+
+  std::vector<vtkIdType> ActiveIds;
+  bool ActiveIdsValid;
+  bool TraverseActive;
+  size_t ActiveIter;
 
   std::vector<EventLink> EventLinks;
+
+  vtkInternal() :
+    FilterAll(true), TimeIndexDirty(true), ActiveIdsValid(false),
+    TraverseActive(false), ActiveIter(0)
+    {}
+
+  void Unwatch(EventWatchMap::iterator iter)
+    {
+    iter->second.Event->RemoveObserver(iter->second.ObserverTag);
+    this->EventWatches.erase(iter);
+    }
+
+  void Unwatch(vtkIdType eventId)
+    {
+    EventWatchMap::iterator iter = this->EventWatches.find(eventId);
+    if (iter != this->EventWatches.end())
+      {
+      this->Unwatch(iter);
+      }
+    }
+
+  void UnwatchAll()
+    {
+    while (!this->EventWatches.empty())
+      {
+      this->Unwatch(this->EventWatches.begin());
+      }
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -76,6 +151,7 @@ vtkVgEventModel::~vtkVgEventModel()
   this->SetTrackModel(0);
   this->SetSharedRegionPoints(0);
 
+  this->Internal->UnwatchAll();
   for (EventMapIterator itr = this->Internal->EventIdMap.begin(),
        end = this->Internal->EventIdMap.end(); itr != end; ++itr)
     {
@@ -250,16 +326,23 @@ void vtkVgEventModel::SetEventExpirationOffset(const vtkVgTimeStamp& offset)
   if (offset != this->EventExpirationOffset)
     {
     this->EventExpirationOffset = offset;
-    this->Modified();
+    this->Internal->TimeIndexDirty = true;
+    this->ContentsModified();
     }
 }
 
 //-----------------------------------------------------------------------------
 void vtkVgEventModel::Initialize()
 {
+  this->Internal->UnwatchAll();
   this->Internal->EventIdMap.clear();
   this->Internal->NormalcyMinimum.clear();
   this->Internal->NormalcyMaximum.clear();
+
+  this->Internal->PendingFilterIds.clear();
+  this->Internal->ActiveIds.clear();
+  this->Internal->TimeIndexDirty = true;
+  this->ContentsModified();
 }
 
 //-----------------------------------------------------------------------------
@@ -312,10 +395,19 @@ vtkVgEvent* vtkVgEventModel::AddEvent(vtkVgEventBase* vgEventBase)
     eventInfo.SetEvent(vgEvent);
     vgEvent->Register(this);
     }
-  this->Modified();
+  this->ContentsModified();
 
   eventInfo.SetDisplayEventOn();
   this->Internal->EventIdMap[vgEvent->GetId()] = eventInfo;
+  this->Internal->PendingFilterIds.push_back(vgEvent->GetId());
+  this->Internal->TimeIndexDirty = true;
+
+  this->Internal->Unwatch(vgEvent->GetId());
+  EventWatch& watch = this->Internal->EventWatches[vgEvent->GetId()];
+  watch.Event = vgEvent;
+  watch.ObserverTag =
+    vgEvent->AddObserver(vtkCommand::ModifiedEvent, this,
+                         &vtkVgEventModel::EventModified);
 
   // Update minimum and maximum normalcy for this event's classifiers
   EventNormalcyMap::iterator itr;
@@ -405,7 +497,6 @@ vtkVgEvent* vtkVgEventModel::CreateAndAddEvent(int type, vtkIdList* trackIds)
   this->AddEvent(event);
   event->FastDelete();
 
-  this->Modified();
   return event;
 }
 
@@ -429,7 +520,6 @@ vtkVgEvent* vtkVgEventModel::CloneEvent(vtkIdType eventId)
   this->AddEvent(event);
   event->FastDelete();
 
-  this->Modified();
   return event;
 }
 
@@ -441,9 +531,11 @@ bool vtkVgEventModel::RemoveEvent(vtkIdType eventId)
     {
     vtkVgEvent* event = iter->second.GetEvent();
     this->InvokeEvent(vtkVgEventModel::EventRemoved, event);
+    this->Internal->Unwatch(eventId);
     this->Internal->EventIdMap.erase(iter);
     event->UnRegister(this);
-    this->Modified();
+    this->Internal->TimeIndexDirty = true;
+    this->ContentsModified();
     return true;
     }
   return false;  // not removed (not present)
@@ -475,21 +567,37 @@ double vtkVgEventModel::GetNormalcyMaxForType(int type)
 int vtkVgEventModel::Update(const vtkVgTimeStamp& timeStamp,
                             const vtkVgTimeStamp* referenceFrameTimeStamp/*=0*/)
 {
+  // If the model was modified other than by its own methods, events may have
+  // been edited, so everything derived from them must be recomputed
+  if (this->GetMTime() > this->Internal->ContentsTime)
+    {
+    this->Internal->FilterAll = true;
+    this->Internal->TimeIndexDirty = true;
+    }
+
+  // Filters only need to be evaluated for all events when the filters
+  // themselves have changed; otherwise, only for events that are new
   bool updateSpatial = this->ContourOperatorManager &&
-                       (this->GetMTime() >
-                        this->Internal->SpatialFilteringUpdateTime ||
+                       (this->Internal->FilterAll ||
                         this->ContourOperatorManager->GetMTime() >
                         this->Internal->SpatialFilteringUpdateTime);
 
   bool updateTemporal = this->TemporalFilters &&
-                        (this->GetMTime() >
-                         this->Internal->TemporalFilteringUpdateTime ||
+                        (this->Internal->FilterAll ||
                          this->TemporalFilters->GetMTime() >
                          this->Internal->TemporalFilteringUpdateTime);
 
+  // An event edited in place may have become active or inactive at the
+  // current time, so the active events must be found again if they were in
+  // use and the time index has changed
+  const bool updateActive =
+    this->Internal->ActiveIdsValid && this->Internal->TimeIndexDirty;
+
   if (this->CurrentTimeStamp == timeStamp &&
       this->Internal->UpdateTime > this->GetMTime() &&
-      !(updateSpatial || updateTemporal))
+      !updateActive &&
+      !(updateSpatial || updateTemporal) &&
+      this->Internal->PendingFilterIds.empty())
     {
     return VTK_OK;
     }
@@ -499,43 +607,209 @@ int vtkVgEventModel::Update(const vtkVgTimeStamp& timeStamp,
                              : vtkVgTimeStamp();
 
   this->Internal->UpdateTime.Modified();
-  if (updateSpatial)
+
+  this->UpdateFiltering(updateSpatial, updateTemporal);
+  this->UpdateActiveEvents();
+
+  // Let the representation (if listening) know it needs to update
+  //this->UpdateTime.ModifieDataRequestOn();
+  this->InvokeEvent(vtkCommand::UpdateDataEvent);
+
+  return VTK_OK;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgEventModel::UpdateFiltering(bool spatial, bool temporal)
+{
+  bool changed = false;
+
+  if (spatial || temporal)
+    {
+    EventMapIterator eventIter;
+    for (eventIter = this->Internal->EventIdMap.begin();
+         eventIter != this->Internal->EventIdMap.end(); eventIter++)
+      {
+      vtkVgEventInfo& info = eventIter->second;
+
+      // hide this event if it is not displayed
+      if (!info.GetDisplayEvent())
+        {
+        continue;
+        }
+
+      if (temporal)
+        {
+        this->UpdateTemporalFiltering(info);
+        }
+
+      if (spatial)
+        {
+        this->UpdateSpatialFiltering(info);
+        }
+      }
+
+    if (spatial)
+      {
+      this->Internal->SpatialFilteringUpdateTime.Modified();
+      }
+    if (temporal)
+      {
+      this->Internal->TemporalFilteringUpdateTime.Modified();
+      }
+    changed = true;
+    }
+
+  // Filter events that were added (or displayed) since the last update with
+  // any filters that were not just evaluated for all events
+  const bool pendingSpatial = this->ContourOperatorManager && !spatial;
+  const bool pendingTemporal = this->TemporalFilters && !temporal;
+  if (pendingSpatial || pendingTemporal)
+    {
+    for (size_t i = 0, k = this->Internal->PendingFilterIds.size(); i < k; ++i)
+      {
+      EventMapIterator eventIter =
+        this->Internal->EventIdMap.find(this->Internal->PendingFilterIds[i]);
+      if (eventIter == this->Internal->EventIdMap.end() ||
+          !eventIter->second.GetDisplayEvent())
+        {
+        continue;
+        }
+
+      if (pendingTemporal)
+        {
+        this->UpdateTemporalFiltering(eventIter->second);
+        }
+      if (pendingSpatial)
+        {
+        this->UpdateSpatialFiltering(eventIter->second);
+        }
+      changed = true;
+      }
+    }
+
+  this->Internal->PendingFilterIds.clear();
+  this->Internal->FilterAll = false;
+
+  if (changed)
     {
-    this->Internal->SpatialFilteringUpdateTime.Modified();
+    this->Internal->FilteringChangeTime.Modified();
     }
-  if (updateTemporal)
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgEventModel::UpdateActiveEvents()
+{
+  vtkInternal* const internal = this->Internal;
+
+  // When events are shown outside of their own time window, there is no
+  // bound on which events may be visible
+  if (this->ShowEventsBeforeStart || this->ShowEventsAfterExpiration ||
+      this->ShowEventsUntilSupportingTracksExpire)
     {
-    this->Internal->TemporalFilteringUpdateTime.Modified();
+    internal->ActiveIdsValid = false;
+    return;
     }
 
-  EventMapIterator eventIter;
-  for (eventIter = this->Internal->EventIdMap.begin();
-       eventIter != this->Internal->EventIdMap.end(); eventIter++)
+  if (internal->TimeIndexDirty)
     {
-    vtkVgEventInfo& info = eventIter->second;
+    internal->TimeIndex.Clear();
+    internal->TimeIndex.Reserve(internal->EventIdMap.size());
+    internal->AlwaysActiveIds.clear();
 
-    // hide this event if it is not displayed
-    if (!info.GetDisplayEvent())
+    EventMapIterator eventIter;
+    for (eventIter = internal->EventIdMap.begin();
+         eventIter != internal->EventIdMap.end(); eventIter++)
       {
-      continue;
-      }
+      vtkVgEvent* event = eventIter->second.GetEvent();
+      const vtkVgTimeStamp start = event->GetStartFrame();
+      vtkVgTimeStamp expiration = event->GetEndFrame();
 
-    if (updateTemporal)
-      {
-      this->UpdateTemporalFiltering(info);
+      EventWatchMap::iterator watchIter =
+        internal->EventWatches.find(eventIter->first);
+      if (watchIter != internal->EventWatches.end())
+        {
+        watchIter->second.Start = start;
+        watchIter->second.End = expiration;
+        }
+
+      if (!start.IsValid() || !expiration.IsValid())
+        {
+        internal->AlwaysActiveIds.push_back(eventIter->first);
+        continue;
+        }
+
+      expiration.ShiftForward(this->EventExpirationOffset);
+      internal->TimeIndex.Insert(start, expiration, eventIter->first);
       }
 
-    if (updateSpatial)
+    internal->TimeIndex.Build();
+    internal->TimeIndexDirty = false;
+    }
+
+  internal->ActiveIds = internal->AlwaysActiveIds;
+  internal->TimeIndex.ForEachContaining(
+    this->CurrentTimeStamp,
+    [internal](vtkIdType id){ internal->ActiveIds.push_back(id); });
+  internal->ActiveIdsValid = true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgEventModel::EventModified(vtkObject* caller, unsigned long, void*)
+{
+  vtkInternal* const internal = this->Internal;
+  if (internal->TimeIndexDirty)
+    {
+    return;
+    }
+
+  // The time index only needs to be rebuilt if the event's display window
+  // has moved; events are modified for many other reasons
+  vtkVgEvent* const event = static_cast<vtkVgEvent*>(caller);
+  EventWatchMap::iterator iter = internal->EventWatches.find(event->GetId());
+  if (iter == internal->EventWatches.end() ||
+      iter->second.Event != event ||
+      iter->second.Start != event->GetStartFrame() ||
+      iter->second.End != event->GetEndFrame())
+    {
+    internal->TimeIndexDirty = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgEventModel::InitActiveEventTraversal()
+{
+  // Fall back to visiting every event if the active events are not known,
+  // or may be out of date
+  this->Internal->TraverseActive =
+    this->Internal->ActiveIdsValid && !this->Internal->TimeIndexDirty &&
+    this->GetMTime() < this->Internal->ContentsTime;
+
+  this->Internal->ActiveIter = 0;
+  this->InitEventTraversal();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgEventInfo vtkVgEventModel::GetNextActiveEvent()
+{
+  if (!this->Internal->TraverseActive)
+    {
+    return this->GetNextDisplayedEvent();
+    }
+
+  const std::vector<vtkIdType>& ids = this->Internal->ActiveIds;
+  while (this->Internal->ActiveIter < ids.size())
+    {
+    EventMapIterator eventIter =
+      this->Internal->EventIdMap.find(ids[this->Internal->ActiveIter++]);
+    if (eventIter != this->Internal->EventIdMap.end() &&
+        eventIter->second.GetDisplayEvent() &&
+        eventIter->second.GetPassesFilters())
       {
-      this->UpdateSpatialFiltering(info);
+      return eventIter->second;
       }
     }
 
-  // Let the representation (if listening) know it needs to update
-  //this->UpdateTime.ModifieDataRequestOn();
-  this->InvokeEvent(vtkCommand::UpdateDataEvent);
-
-  return VTK_OK;
+  return vtkVgEventInfo();
 }
 
 //-----------------------------------------------------------------------------
@@ -547,7 +821,11 @@ void vtkVgEventModel::SetEventDisplayState(vtkIdType eventId, bool displayEvent)
     {
     displayEvent ? eventIter->second.SetDisplayEventOn()
     : eventIter->second.SetDisplayEventOff();
-    this->Modified();
+    if (displayEvent)
+      {
+      this->Internal->PendingFilterIds.push_back(eventId);
+      }
+    this->ContentsModified();
     }
 }
 
@@ -557,6 +835,19 @@ unsigned long vtkVgEventModel::GetUpdateTime()
   return this->Internal->UpdateTime.GetMTime();
 }
 
+//-----------------------------------------------------------------------------
+unsigned long vtkVgEventModel::GetFilteringUpdateTime()
+{
+  return this->Internal->FilteringChangeTime.GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgEventModel::ContentsModified()
+{
+  this->Modified();
+  this->Internal->ContentsTime.Modified();
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgEventModel::SetAllEventsDisplayState(bool state)
 {
@@ -572,7 +863,8 @@ void vtkVgEventModel::SetAllEventsDisplayState(bool state)
       itr->second.SetDisplayEventOff();
       }
     }
-  this->Modified();
+  this->Internal->FilterAll = this->Internal->FilterAll || state;
+  this->ContentsModified();
 }
 
 //-----------------------------------------------------------------------------
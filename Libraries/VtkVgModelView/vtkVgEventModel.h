@@ -97,6 +97,16 @@ public:
   vtkVgEventInfo GetNextEvent();
   vtkVgEventInfo GetNextDisplayedEvent();
 
+  // Description:
+  // Traverse the displayed events whose display window (from their start
+  // through their expiration) contains the time stamp of the last Update.
+  // Events are looked up with a time index rather than by visiting every
+  // event.  If events are shown before their start or after their expiration,
+  // or the model has changed since the last Update, this visits the same
+  // events as GetNextDisplayedEvent.
+  void InitActiveEventTraversal();
+  vtkVgEventInfo GetNextActiveEvent();
+
   vtkIdType GetNumberOfEvents();
 
   virtual int Update(const vtkVgTimeStamp& timeStamp,
@@ -134,6 +144,10 @@ public:
   // Return the MTime for the last Update (that did something).
   virtual unsigned long GetUpdateTime();
 
+  // Description:
+  // Return the MTime at which the filter results of any event last changed.
+  unsigned long GetFilteringUpdateTime();
+
   // Description
   // Set/Get whether all events are to be displayed.  If true, the event model
   // will turn off the events disregarding any other parameters and vice versa.
@@ -148,9 +162,22 @@ private:
   vtkVgEventModel(const vtkVgEventModel&); // Not implemented.
   void operator=(const vtkVgEventModel&);  // Not implemented.
 
+  void UpdateFiltering(bool spatial, bool temporal);
   void UpdateTemporalFiltering(vtkVgEventInfo& info);
   void UpdateSpatialFiltering(vtkVgEventInfo& info);
 
+  void UpdateActiveEvents();
+
+  // Description:
+  // Called when an event in the model is modified, which may have moved its
+  // display window without the model's knowledge.
+  void EventModified(vtkObject* caller, unsigned long, void*);
+
+  // Description:
+  // Mark the model modified by one of its own methods, which keep the
+  // filter results and time index up to date themselves.
+  void ContentsModified();
+
   // Description:
   // Constructor / Destructor.
   vtkVgEventModel();
@@ -200,9 +200,12 @@ void vtkVgEventRegionRepresentation::Update()
   // should do this somehwere else once...
   this->Internal->PolyData->SetPoints(this->EventModel->GetSharedRegionPoints());
 
-  this->EventModel->InitEventTraversal();
+  // Regions are only shown within the time extents of their event (or
+  // outside of them when the model is configured to show events before their
+  // start or after their end, in which case every event is visited)
+  this->EventModel->InitActiveEventTraversal();
   while (vtkVgEvent* theEvent =
-           this->EventModel->GetNextDisplayedEvent().GetEvent())
+           this->EventModel->GetNextActiveEvent().GetEvent())
     {
     // is event masked in this representation?
     unsigned int mask = this->GetDisplayMask();
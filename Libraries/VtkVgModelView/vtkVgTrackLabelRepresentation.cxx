@@ -4,20 +4,16 @@
 
 #include "vtkVgTrackLabelRepresentation.h"
 
-#include <vtkActor2D.h>
-#include <vtkIdListCollection.h>
 #include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkPoints.h>
-#include <vtkProperty2D.h>
-#include <vtkPropPicker.h>
-#include <vtkTextProperty.h>
+#include <vtkPropCollection.h>
 #include <vtkTimeStamp.h>
 #include <vtkVgUtil.h>
 
 #include <vgUtil.h>
 
-#include <vtkVgAnnotationActor.h>
+#include <vtkVgLabelLayer.h>
 #include <vtkVgTrack.h>
 
 #include "vtkVgPickData.h"
@@ -26,26 +22,50 @@
 
 #include <map>
 #include <sstream>
+#include <string>
 
 vtkStandardNewMacro(vtkVgTrackLabelRepresentation);
 
-typedef std::map<vtkIdType, vtkVgAnnotationActor*> ActorMap;
+namespace
+{
+
+//-----------------------------------------------------------------------------
+void vtkVgConvertColor(const double* in, unsigned char out[3])
+{
+  for (int i = 0; i < 3; ++i)
+    {
+    const double c = (in[i] < 0.0 ? 0.0 : (in[i] > 1.0 ? 1.0 : in[i]));
+    out[i] = static_cast<unsigned char>(c * 255.0 + 0.5);
+    }
+}
+
+} // namespace <anonymous>
 
 //----------------------------------------------------------------------------
 struct vtkVgTrackLabelRepresentation::vtkInternal
 {
-  ~vtkInternal();
-
   struct TrackInfoItem
     {
     double BackgroundColor[3];
     double ForegroundColor[3];
     };
 
-  ActorMap Actors;
+  // Label text and colors of a shown track, which are only recomputed when
+  // the representation is modified
+  struct LabelInfo
+    {
+    std::string Text;
+    unsigned char BackgroundColor[3];
+    unsigned char ForegroundColor[3];
+    };
+
+  typedef std::map<vtkIdType, LabelInfo> LabelMap;
+
+  LabelMap Labels;
   std::map<int, TrackInfoItem> TrackInfo;
 
-  vtkSmartPointer<vtkPropPicker> Picker;
+  // All labels are drawn by a single prop
+  vtkSmartPointer<vtkVgLabelLayer> LabelLayer;
 
   vtkSmartPointer<vtkMatrix4x4> InvRepresentationMatrix;
 
@@ -53,18 +73,6 @@ struct vtkVgTrackLabelRepresentation::vtkInternal
   typedef std::map<int, TrackInfoItem>::const_iterator TrackInfoConstIterator;
 };
 
-vtkVgTrackLabelRepresentation::vtkInternal::~vtkInternal()
-{
-  for (ActorMap::iterator iter = this->Actors.begin(), end = this->Actors.end();
-       iter != end; ++iter)
-    {
-    if (iter->second)
-      {
-      iter->second->Delete();
-      }
-    }
-}
-
 //-----------------------------------------------------------------------------
 vtkVgTrackLabelRepresentation::vtkVgTrackLabelRepresentation()
 {
@@ -76,8 +84,8 @@ vtkVgTrackLabelRepresentation::vtkVgTrackLabelRepresentation()
   this->LabelColorHelper = 0;
   this->Internal = new vtkInternal;
 
-  this->Internal->Picker = vtkSmartPointer<vtkPropPicker>::New();
-  this->Internal->Picker->PickFromListOn();
+  this->Internal->LabelLayer = vtkSmartPointer<vtkVgLabelLayer>::New();
+  this->Internal->LabelLayer->SetOffset(0, -15);
 
   this->Internal->InvRepresentationMatrix =
     vtkSmartPointer<vtkMatrix4x4>::New();
@@ -85,6 +93,9 @@ vtkVgTrackLabelRepresentation::vtkVgTrackLabelRepresentation()
   this->NewPropCollection    = vtkPropCollectionRef::New();
   this->ActivePropCollection = vtkPropCollectionRef::New();
   this->ExpirePropCollection = vtkPropCollectionRef::New();
+
+  this->NewPropCollection->AddItem(this->Internal->LabelLayer);
+  this->ActivePropCollection->AddItem(this->Internal->LabelLayer);
 }
 
 //-----------------------------------------------------------------------------
@@ -138,6 +149,12 @@ int vtkVgTrackLabelRepresentation::SetTrackTypeColors(
   return VTK_OK;
 }
 
+//-----------------------------------------------------------------------------
+vtkVgLabelLayer* vtkVgTrackLabelRepresentation::GetLabelLayer()
+{
+  return this->Internal->LabelLayer;
+}
+
 //-----------------------------------------------------------------------------
 const vtkPropCollection* vtkVgTrackLabelRepresentation::GetNewRenderObjects() const
 {
@@ -190,11 +207,7 @@ void vtkVgTrackLabelRepresentation::SetVisible(int flag)
     }
 
   this->Visible = flag;
-  this->ActivePropCollection->InitTraversal();
-  while (vtkProp* prop = this->ActivePropCollection->GetNextProp())
-    {
-    prop->SetVisibility(flag);
-    }
+  this->Internal->LabelLayer->SetVisibility(flag);
   this->Modified();
 }
 
@@ -213,23 +226,13 @@ void vtkVgTrackLabelRepresentation::SetLabelColorHelper(
 void vtkVgTrackLabelRepresentation::ShowTrackAnnotation(vtkVgTrack* track,
   bool rebuild)
 {
-  vtkVgAnnotationActor*& actor = this->Internal->Actors[track->GetId()];
+  typedef vtkInternal::LabelMap::value_type LabelMapEntry;
+  std::pair<vtkInternal::LabelMap::iterator, bool> insert =
+    this->Internal->Labels.insert(LabelMapEntry(track->GetId(),
+                                                vtkInternal::LabelInfo()));
+  vtkInternal::LabelInfo& label = insert.first->second;
 
-  // @TODO: Maintain a pool of actors that can be reused in order to
-  // avoid some of this reallocation.
-  if (!actor)
-    {
-    actor = vtkVgAnnotationActor::New();
-    actor->SetClampToViewport(false);
-
-    this->NewPropCollection->AddItem(actor);
-    this->ActivePropCollection->AddItem(actor);
-    rebuild = true;
-    }
-
-  actor->SetUserMatrix(this->RepresentationMatrix);
-
-  if (rebuild)
+  if (rebuild || insert.second)
     {
     const double* backgroundColor = 0;
     const double* foregroundColor = 0;
@@ -265,16 +268,8 @@ void vtkVgTrackLabelRepresentation::ShowTrackAnnotation(vtkVgTrack* track,
         }
       }
 
-    actor->GetFrameProperty()->SetColor(backgroundColor[0],
-                                        backgroundColor[1],
-                                        backgroundColor[2]);
-
-    actor->GetTextProperty()->SetColor(foregroundColor[0],
-                                       foregroundColor[1],
-                                       foregroundColor[2]);
-
-    actor->SetOffset(0, -15);
-    actor->AutoCenterXOn();
+    vtkVgConvertColor(backgroundColor, label.BackgroundColor);
+    vtkVgConvertColor(foregroundColor, label.ForegroundColor);
 
     std::ostringstream ostr;
     bool hasLabel = false;
@@ -333,13 +328,12 @@ void vtkVgTrackLabelRepresentation::ShowTrackAnnotation(vtkVgTrack* track,
         }
       }
 
-    actor->SetVisibility(hasLabel);
-    actor->SetText(ostr.str().c_str());
+    label.Text = (hasLabel ? ostr.str() : std::string());
     }
 
-  if (!actor->GetVisibility())
+  if (label.Text.empty())
     {
-    // If label is not visible, not much point updating position
+    // If label is not visible, not much point computing its position
     return;
     }
 
@@ -394,23 +388,18 @@ void vtkVgTrackLabelRepresentation::ShowTrackAnnotation(vtkVgTrack* track,
 
     track->GetPoints()->GetPoint(headId, labelPosition);
     }
-  actor->SetPosition(labelPosition);
+
+  this->Internal->LabelLayer->AddLabel(
+    track->GetId(), labelPosition, label.Text.c_str(),
+    label.ForegroundColor, label.BackgroundColor);
 }
 
 //-----------------------------------------------------------------------------
 void vtkVgTrackLabelRepresentation::HideTrackAnnotation(vtkVgTrack* track)
 {
-  ActorMap::iterator iter = this->Internal->Actors.find(track->GetId());
-  if (iter != this->Internal->Actors.end() && iter->second)
-    {
-    this->ExpirePropCollection->AddItem(iter->second);
-
-    // linear search here could get expensive...
-    this->ActivePropCollection->RemoveItem(iter->second);
-
-    iter->second->Delete();
-    iter->second = 0;
-    }
+  // The label is not drawn simply by not being added to the label layer; only
+  // the cached label needs to be discarded
+  this->Internal->Labels.erase(track->GetId());
 }
 
 //-----------------------------------------------------------------------------
@@ -439,6 +428,10 @@ void vtkVgTrackLabelRepresentation::Update()
                          this->Internal->InvRepresentationMatrix);
     }
 
+  // Labels of all shown tracks are gathered anew into the label layer
+  this->Internal->LabelLayer->RemoveAllLabels();
+  this->Internal->LabelLayer->SetUserMatrix(this->RepresentationMatrix);
+
   vtkVgTrackInfo trackInfo;
   this->TrackModel->InitTrackTraversal();
   while ((trackInfo = this->TrackModel->GetNextTrack()).GetTrack())
@@ -476,7 +469,7 @@ void vtkVgTrackLabelRepresentation::Update()
 //-----------------------------------------------------------------------------
 vtkIdType vtkVgTrackLabelRepresentation::Pick(double renX,
                                               double renY,
-                                              vtkRenderer* ren,
+                                              vtkRenderer* vtkNotUsed(ren),
                                               vtkIdType& pickType)
 {
   pickType = vtkVgPickData::EmptyPick;
@@ -486,38 +479,12 @@ vtkIdType vtkVgTrackLabelRepresentation::Pick(double renX,
     return -1;
     }
 
-  // Set up the pick list and add the actors to it
-  this->Internal->Picker->InitializePickList();
-
-  for (ActorMap::iterator iter = this->Internal->Actors.begin(),
-       end = this->Internal->Actors.end();
-       iter != end; ++iter)
+  const vtkIdType trackId =
+    this->Internal->LabelLayer->PickLabel(renX, renY);
+  if (trackId >= 0)
     {
-    if (iter->second)
-      {
-      this->Internal->Picker->AddPickList(iter->second->GetFrameActor());
-      }
-    }
-
-  if (this->Internal->Picker->Pick(renX, renY, 0.0, ren))
-    {
-    vtkProp* pickedActor = this->Internal->Picker->GetViewProp();
-    if (!pickedActor)
-      {
-      return -1;
-      }
-
-    // Look up the picked actor
-    for (ActorMap::iterator iter = this->Internal->Actors.begin(),
-         end = this->Internal->Actors.end();
-         iter != end; ++iter)
-      {
-      if (iter->second && pickedActor == iter->second->GetFrameActor())
-        {
-        pickType = vtkVgPickData::PickedEvent;
-        return iter->first;
-        }
-      }
+    pickType = vtkVgPickData::PickedEvent;
+    return trackId;
     }
 
   return -1;
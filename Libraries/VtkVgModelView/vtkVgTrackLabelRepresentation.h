@@ -11,6 +11,7 @@
 #include <vgExport.h>
 
 class vtkPropCollection;
+class vtkVgLabelLayer;
 class vtkVgTrack;
 
 class vtkVgTrackLabelColorHelper
@@ -43,6 +44,11 @@ public:
   void SetLabelColorHelper(vtkVgTrackLabelColorHelper* labelColorHelper);
   vtkGetObjectMacro(LabelColorHelper, vtkVgTrackLabelColorHelper);
 
+  // Description:
+  // Get the prop which draws the labels of all tracks. This may be used to
+  // set the text appearance and the label culling options.
+  vtkVgLabelLayer* GetLabelLayer();
+
   // Description:
   // Return all the objects that can be rendered.
   virtual const vtkPropCollection* GetNewRenderObjects() const;
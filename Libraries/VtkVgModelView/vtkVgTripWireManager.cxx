@@ -23,6 +23,8 @@
 #include "vtkVgTrackModel.h"
 #include "vtkVgEventModel.h"
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 
 vtkCxxSetObjectMacro(vtkVgTripWireManager, TrackModel, vtkVgTrackModel);
@@ -30,6 +32,9 @@ vtkCxxSetObjectMacro(vtkVgTripWireManager, EventModel, vtkVgEventModel);
 
 vtkStandardNewMacro(vtkVgTripWireManager);
 
+// Tolerance used when intersecting track segments with trip wires
+static const double TripWireTolerance = 1e-7;
+
 struct vtkVgTripWireEventInfo
 {
   vtkVgEvent* Event;
@@ -93,15 +98,23 @@ struct vtkVgTripWireInfo
 {
   vtkPolyLine* TripWire;
   vtkImplicitSelectionLoop* TripWireLoop;
-  vtkTimeStamp CheckWireTime;
   TrackEventMap TriggeredEventMap;
   bool Enabled;
 
+  // xmin, xmax, ymin, ymax of the trip wire, padded by the tolerance
+  double Bounds[4];
+
+  // true if the trip wire has not yet been tested against the full tracks
+  // (i.e. it is new, or was disabled while tracks were updated)
+  bool NeedsFullCheck;
+
   vtkVgTripWireInfo()
     {
     this->Enabled = true;
+    this->NeedsFullCheck = true;
     this->TripWire = 0;
     this->TripWireLoop = 0;
+    std::fill(this->Bounds, this->Bounds + 4, 0.0);
     }
 
   ~vtkVgTripWireInfo()
@@ -165,6 +178,9 @@ struct vtkVgTripWireInfo
   vtkVgTripWireInfo(const vtkVgTripWireInfo& fromTripWireInfo)
     {
     this->Enabled = fromTripWireInfo.Enabled;
+    this->NeedsFullCheck = fromTripWireInfo.NeedsFullCheck;
+    std::copy(fromTripWireInfo.Bounds, fromTripWireInfo.Bounds + 4,
+              this->Bounds);
     this->TripWire = 0;
     this->TripWireLoop = 0;
     this->SetTripWire(fromTripWireInfo.TripWire);
@@ -175,6 +191,9 @@ struct vtkVgTripWireInfo
   vtkVgTripWireInfo& operator=(const vtkVgTripWireInfo& fromTripWireInfo)
     {
     this->Enabled = fromTripWireInfo.Enabled;
+    this->NeedsFullCheck = fromTripWireInfo.NeedsFullCheck;
+    std::copy(fromTripWireInfo.Bounds, fromTripWireInfo.Bounds + 4,
+              this->Bounds);
     this->TripWire = 0;
     this->TripWireLoop = 0;
     this->SetTripWire(fromTripWireInfo.TripWire);
@@ -183,8 +202,188 @@ struct vtkVgTripWireInfo
 
     return *this;
     }
+
+  // Test whether the bounds of a track segment overlap the trip wire
+  bool Overlaps(const double segmentBounds[4]) const
+    {
+    return segmentBounds[0] <= this->Bounds[1] &&
+           segmentBounds[1] >= this->Bounds[0] &&
+           segmentBounds[2] <= this->Bounds[3] &&
+           segmentBounds[3] >= this->Bounds[2];
+    }
+};
+
+// Portion of a track that has already been tested against the trip wires
+struct vtkVgTripWireTrackState
+{
+  vtkVgTrack* Track;
+  vtkVgTimeStamp LastTime;  // last path point tested (invalid if none)
+  vtkMTimeType CheckTime;   // time of the check that last saw the track
+
+  vtkVgTripWireTrackState() : Track(0), CheckTime(0) {}
+};
+
+//----------------------------------------------------------------------------
+static void GetSegmentBounds(double trackPts[2][3], double bounds[4])
+{
+  bounds[0] = std::min(trackPts[0][0], trackPts[1][0]);
+  bounds[1] = std::max(trackPts[0][0], trackPts[1][0]);
+  bounds[2] = std::min(trackPts[0][1], trackPts[1][1]);
+  bounds[3] = std::max(trackPts[0][1], trackPts[1][1]);
+}
+
+//----------------------------------------------------------------------------
+// Uniform grid over the bounds of a set of trip wires, used to find the wires
+// that a track segment might cross without testing every wire
+class vtkVgTripWireGrid
+{
+public:
+  vtkVgTripWireGrid() : VisitMark(0) {}
+
+  void Build(const std::vector<vtkVgTripWireInfo*>& wires);
+  bool IsEmpty() const { return this->Wires.empty(); }
+
+  void FindCandidates(const double bounds[4],
+                      std::vector<vtkVgTripWireInfo*>& candidates);
+
+private:
+  bool GetCellRange(const double bounds[4], int range[4]) const;
+  int GetCellIndex(double value, int axis) const;
+
+  std::vector<vtkVgTripWireInfo*> Wires;
+  std::vector<std::vector<int> > Cells;
+  std::vector<unsigned int> Visited;
+  std::vector<int> Found;
+  unsigned int VisitMark;
+
+  double Bounds[4];
+  double CellSize[2];
+  int Dimensions[2];
 };
 
+//----------------------------------------------------------------------------
+void vtkVgTripWireGrid::Build(const std::vector<vtkVgTripWireInfo*>& wires)
+{
+  this->Wires = wires;
+  this->Cells.clear();
+  this->Visited.assign(wires.size(), 0);
+  this->VisitMark = 0;
+
+  if (wires.empty())
+    {
+    return;
+    }
+
+  std::copy(wires[0]->Bounds, wires[0]->Bounds + 4, this->Bounds);
+  for (size_t i = 1, k = wires.size(); i < k; ++i)
+    {
+    this->Bounds[0] = std::min(this->Bounds[0], wires[i]->Bounds[0]);
+    this->Bounds[1] = std::max(this->Bounds[1], wires[i]->Bounds[1]);
+    this->Bounds[2] = std::min(this->Bounds[2], wires[i]->Bounds[2]);
+    this->Bounds[3] = std::max(this->Bounds[3], wires[i]->Bounds[3]);
+    }
+
+  // Use roughly one cell per wire, which keeps the number of wires per cell
+  // small for wires that are spread over the scene
+  const int size = std::min(256, std::max(1, static_cast<int>(
+    std::ceil(std::sqrt(static_cast<double>(wires.size()))))));
+  for (int axis = 0; axis < 2; ++axis)
+    {
+    const double extent =
+      this->Bounds[2 * axis + 1] - this->Bounds[2 * axis];
+    this->Dimensions[axis] = (extent > 0.0 ? size : 1);
+    this->CellSize[axis] =
+      (extent > 0.0 ? extent / this->Dimensions[axis] : 1.0);
+    }
+
+  this->Cells.resize(this->Dimensions[0] * this->Dimensions[1]);
+  for (size_t i = 0, k = wires.size(); i < k; ++i)
+    {
+    int range[4];
+    this->GetCellRange(wires[i]->Bounds, range);
+    for (int y = range[2]; y <= range[3]; ++y)
+      {
+      for (int x = range[0]; x <= range[1]; ++x)
+        {
+        this->Cells[y * this->Dimensions[0] + x].push_back(
+          static_cast<int>(i));
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkVgTripWireGrid::FindCandidates(
+  const double bounds[4], std::vector<vtkVgTripWireInfo*>& candidates)
+{
+  candidates.clear();
+
+  int range[4];
+  if (this->Wires.empty() || !this->GetCellRange(bounds, range))
+    {
+    return;
+    }
+
+  // A segment may overlap several cells that share a wire; mark the wires
+  // already found by this query so that each is reported only once
+  if (++this->VisitMark == 0)
+    {
+    std::fill(this->Visited.begin(), this->Visited.end(), 0);
+    this->VisitMark = 1;
+    }
+
+  this->Found.clear();
+  for (int y = range[2]; y <= range[3]; ++y)
+    {
+    for (int x = range[0]; x <= range[1]; ++x)
+      {
+      const std::vector<int>& cell =
+        this->Cells[y * this->Dimensions[0] + x];
+      for (size_t i = 0, k = cell.size(); i < k; ++i)
+        {
+        if (this->Visited[cell[i]] != this->VisitMark)
+          {
+          this->Visited[cell[i]] = this->VisitMark;
+          this->Found.push_back(cell[i]);
+          }
+        }
+      }
+    }
+
+  // Report the wires in the order they were given (i.e. by id), so that
+  // intersections are found in the same order as when testing every wire
+  std::sort(this->Found.begin(), this->Found.end());
+  for (size_t i = 0, k = this->Found.size(); i < k; ++i)
+    {
+    candidates.push_back(this->Wires[this->Found[i]]);
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkVgTripWireGrid::GetCellRange(
+  const double bounds[4], int range[4]) const
+{
+  if (bounds[0] > this->Bounds[1] || bounds[1] < this->Bounds[0] ||
+      bounds[2] > this->Bounds[3] || bounds[3] < this->Bounds[2])
+    {
+    return false;
+    }
+
+  range[0] = this->GetCellIndex(bounds[0], 0);
+  range[1] = this->GetCellIndex(bounds[1], 0);
+  range[2] = this->GetCellIndex(bounds[2], 1);
+  range[3] = this->GetCellIndex(bounds[3], 1);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkVgTripWireGrid::GetCellIndex(double value, int axis) const
+{
+  const int index = static_cast<int>(
+    (value - this->Bounds[2 * axis]) / this->CellSize[axis]);
+  return std::max(0, std::min(this->Dimensions[axis] - 1, index));
+}
+
 //----------------------------------------------------------------------------
 class vtkVgTripWireManager::vtkInternal
 {
@@ -192,6 +391,7 @@ public:
   vtkInternal(vtkVgTripWireManager* tripWireManager)
     {
     this->TripWireManager = tripWireManager;
+    this->EnabledGridValid = false;
     }
 
   ~vtkInternal()
@@ -199,8 +399,19 @@ public:
     }
 
   void RemoveTripWireEvents(vtkIdType tripWireId);
+  void RemoveTrackEvents(vtkIdType trackId,
+                         const std::vector<vtkVgTripWireInfo*>& tripWires);
   void RemoveEventsFromModel(std::vector<vtkVgTripWireEventInfo>& events);
 
+  vtkVgTripWireGrid& GetEnabledGrid();
+  void InvalidateEnabledGrid() { this->EnabledGridValid = false; }
+
+  void CheckTrackPath(vtkVgTrack* track, const vtkVgTimeStamp& start,
+                      vtkVgTripWireGrid& grid, vtkVgTimeStamp& end);
+  void AddIntersectionEvents(
+    vtkVgTrack* track, vtkVgTripWireInfo& tripWireInfo,
+    vtkVgTripWireManager::IntersectionInfo& intersectionInfo);
+
   void GetTripWireVsTrackIntersections(
     vtkVgTrack* track, vtkVgTripWireInfo& tripWireInfo,
     std::vector<vtkVgTripWireManager::IntersectionInfo>& intersections);
@@ -219,8 +430,38 @@ public:
   vtkTimeStamp CheckTripWiresTime;
 
   std::map<vtkIdType, vtkVgTripWireInfo>              TripWires;
+  std::map<vtkIdType, vtkVgTripWireTrackState>        TrackStates;
+
+  std::vector<vtkVgTripWireInfo*> Candidates;
+
+  // Index of the enabled trip wires, for the checks of individual segments
+  // and tracks; rebuilt on demand after wires are added, removed, enabled or
+  // disabled
+  vtkVgTripWireGrid EnabledGrid;
+  bool EnabledGridValid;
 };
 
+//----------------------------------------------------------------------------
+vtkVgTripWireGrid& vtkVgTripWireManager::vtkInternal::GetEnabledGrid()
+{
+  if (!this->EnabledGridValid)
+    {
+    std::vector<vtkVgTripWireInfo*> wires;
+    std::map<vtkIdType, vtkVgTripWireInfo>::iterator iter;
+    for (iter = this->TripWires.begin(); iter != this->TripWires.end();
+         iter++)
+      {
+      if (iter->second.Enabled)
+        {
+        wires.push_back(&iter->second);
+        }
+      }
+    this->EnabledGrid.Build(wires);
+    this->EnabledGridValid = true;
+    }
+  return this->EnabledGrid;
+}
+
 //----------------------------------------------------------------------------
 void vtkVgTripWireManager::vtkInternal::
 RemoveTripWireEvents(vtkIdType tripWireId)
@@ -248,6 +489,23 @@ RemoveTripWireEvents(vtkIdType tripWireId)
   tripWireIter->second.TriggeredEventMap.clear();
 }
 
+//----------------------------------------------------------------------------
+void vtkVgTripWireManager::vtkInternal::
+RemoveTrackEvents(vtkIdType trackId,
+                  const std::vector<vtkVgTripWireInfo*>& tripWires)
+{
+  for (size_t i = 0, k = tripWires.size(); i < k; ++i)
+    {
+    TrackEventMap::iterator trackIter =
+      tripWires[i]->TriggeredEventMap.find(trackId);
+    if (trackIter != tripWires[i]->TriggeredEventMap.end())
+      {
+      this->RemoveEventsFromModel(trackIter->second);
+      tripWires[i]->TriggeredEventMap.erase(trackIter);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkVgTripWireManager::vtkInternal::
 RemoveEventsFromModel(std::vector<vtkVgTripWireEventInfo>& events)
@@ -291,16 +549,77 @@ GetTripWireVsTrackIntersections(
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgTripWireManager::vtkInternal::
+CheckTrackPath(vtkVgTrack* track, const vtkVgTimeStamp& start,
+               vtkVgTripWireGrid& grid, vtkVgTimeStamp& end)
+{
+  if (start.IsValid())
+    {
+    track->InitPathTraversal(start);
+    }
+  else
+    {
+    track->InitPathTraversal();
+    }
+
+  vtkVgTimeStamp timeStamps[2];
+  vtkIdType ptId = track->GetNextPathPt(timeStamps[0]);
+  if (ptId == -1)
+    {
+    return;
+    }
+
+  vtkPoints* points = track->GetPoints();
+  double trackPoints[2][3];
+  points->GetPoint(ptId, trackPoints[0]);
+
+  vtkVgTripWireManager::IntersectionInfo intersectionInfo;
+  while ((ptId = track->GetNextPathPt(timeStamps[1])) != -1)
+    {
+    points->GetPoint(ptId, trackPoints[1]);
+
+    // only test the wires near the segment
+    double bounds[4];
+    GetSegmentBounds(trackPoints, bounds);
+    grid.FindCandidates(bounds, this->Candidates);
+    for (size_t i = 0, k = this->Candidates.size(); i < k; ++i)
+      {
+      if (this->GetTripWireVsSegmentIntersections(
+            trackPoints, timeStamps, *this->Candidates[i], intersectionInfo))
+        {
+        intersectionInfo.TrackId = track->GetId();
+        this->AddIntersectionEvents(track, *this->Candidates[i],
+                                    intersectionInfo);
+        }
+      }
+
+    timeStamps[0] = timeStamps[1];
+    std::copy(trackPoints[1], trackPoints[1] + 3, trackPoints[0]);
+    }
+
+  end = timeStamps[0];
+}
+
 //-----------------------------------------------------------------------------
 bool vtkVgTripWireManager::vtkInternal::GetTripWireVsSegmentIntersections(
   double trackPts[2][3], const vtkVgTimeStamp (&timeStamps)[2],
   vtkVgTripWireInfo& tripWireInfo,
   vtkVgTripWireManager::IntersectionInfo& intersectionInfo)
 {
-  double t, x[3], pCoords[3], tol = 1e-7;
+  // cheap rejection of segments that are nowhere near the trip wire
+  double segmentBounds[4];
+  GetSegmentBounds(trackPts, segmentBounds);
+  if (!tripWireInfo.Overlaps(segmentBounds))
+    {
+    return false;
+    }
+
+  double t, x[3], pCoords[3];
   int subId;
   int classifierType = this->TripWireManager->TripWireId;
-  if (tripWireInfo.TripWire->IntersectWithLine(trackPts[0], trackPts[1], tol, t,
+  if (tripWireInfo.TripWire->IntersectWithLine(trackPts[0], trackPts[1],
+                                               TripWireTolerance, t,
                                                x, pCoords, subId))
     {
 
@@ -387,6 +706,57 @@ AddEvent(vtkVgTrack* track, vtkVgTimeStamp& startTime,
   trackEventMap->second.push_back(eventInfo);
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgTripWireManager::vtkInternal::
+AddIntersectionEvents(vtkVgTrack* track, vtkVgTripWireInfo& tripWireInfo,
+                      vtkVgTripWireManager::IntersectionInfo& intersectionInfo)
+{
+  vtkVgTripWireManager* manager = this->TripWireManager;
+
+  TrackEventMap::iterator trackEventMap =
+    tripWireInfo.TriggeredEventMap.insert(
+      std::make_pair(track->GetId(),
+                     std::vector<vtkVgTripWireEventInfo>())).first;
+
+  // right now, computing start time for the event regardless of whether
+  // entering/exiting or open trip wire
+
+  vtkVgTimeStamp startTime = intersectionInfo.PostFrame;
+  // for now, PreTripDuration measured from the point that
+  // caused the crossing, NOT where the interesetion occurred (which
+  // we should maybe do at some point)
+  startTime.ShiftBackward(manager->PreTripDuration);
+  if (intersectionInfo.PreFrame < startTime)
+    {
+    // if previous track point is more than PreTripDuration "old",
+    // use it for the start
+    startTime = intersectionInfo.PreFrame;
+    }
+  else if (startTime < track->GetStartFrame())
+    {
+    // if PreTripDuration puts us before start of track, use start of
+    // track as start
+    startTime = track->GetStartFrame();
+    }
+
+  // create events for both entering and exiting
+  if (intersectionInfo.ClassifierType == -1)
+    {
+    this->AddEvent(track, startTime, intersectionInfo,
+                   manager->EnteringRegionId, manager->EventIdCounter++,
+                   trackEventMap);
+    this->AddEvent(track, startTime, intersectionInfo,
+                   manager->ExitingRegionId, manager->EventIdCounter++,
+                   trackEventMap);
+    }
+  else
+    {
+    this->AddEvent(track, startTime, intersectionInfo,
+                   intersectionInfo.ClassifierType, manager->EventIdCounter++,
+                   trackEventMap);
+    }
+}
+
 //----------------------------------------------------------------------------
 vtkVgTripWireManager::vtkVgTripWireManager()
   : EnteringRegionId(-1),  ExitingRegionId(-1), TripWireId(-1),
@@ -416,6 +786,14 @@ void vtkVgTripWireManager::SetPreTripDuration(const vtkVgTimeStamp& timeStamp)
     }
 
   this->PreTripDuration = timeStamp;
+
+  // event start times depend on the duration, so recompute all events
+  std::map<vtkIdType, vtkVgTripWireInfo>::iterator iter;
+  for (iter = this->Internals->TripWires.begin();
+       iter != this->Internals->TripWires.end(); iter++)
+    {
+    iter->second.NeedsFullCheck = true;
+    }
   this->Modified();
 }
 
@@ -477,7 +855,16 @@ vtkIdType vtkVgTripWireManager::AddTripWire(vtkPoints* loopPoints,
     tripWireInfo.SetTripWireLoop(loop);
     loop->FastDelete();
     }
+
+  double bounds[6];
+  loopPoints->GetBounds(bounds);
+  tripWireInfo.Bounds[0] = bounds[0] - TripWireTolerance;
+  tripWireInfo.Bounds[1] = bounds[1] + TripWireTolerance;
+  tripWireInfo.Bounds[2] = bounds[2] - TripWireTolerance;
+  tripWireInfo.Bounds[3] = bounds[3] + TripWireTolerance;
+
   this->Internals->TripWires[tripWireId] = tripWireInfo;
+  this->Internals->InvalidateEnabledGrid();
 
   this->Modified();
   return tripWireId;
@@ -506,6 +893,7 @@ bool vtkVgTripWireManager::RemoveTripWire(vtkIdType tripWireId)
     this->Internals->RemoveTripWireEvents(tripWireId);
     }
   this->Internals->TripWires.erase(iter);
+  this->Internals->InvalidateEnabledGrid();
   this->Modified();
   return true;
 }
@@ -527,6 +915,7 @@ bool vtkVgTripWireManager::RemoveAllTripWires()
         }
       }
     this->Internals->TripWires.clear();
+    this->Internals->InvalidateEnabledGrid();
     this->Modified();
     return true;
     }
@@ -566,98 +955,99 @@ void vtkVgTripWireManager::CheckTripWires()
     return;
     }
 
-//  // only reexecute trip wire if trip wire changed (assumed not to happen for now)
-//  // or track data changes (also not assumed to happen for now)
-//
-//  // thus, we only execute a trip wire when we haven't seen it before (well, that's the plan)
+  vtkTimeStamp checkTime;
+  checkTime.Modified();
 
+  // wires that are new (or were re-enabled) are tested against the full path
+  // of every track; the remaining enabled wires only against the parts of
+  // the tracks added since the last check
+  std::vector<vtkVgTripWireInfo*> allWires, fullWires, incrementalWires;
   std::map<vtkIdType, vtkVgTripWireInfo>::iterator iter;
   for (iter = this->Internals->TripWires.begin();
        iter != this->Internals->TripWires.end(); iter++)
     {
-    vtkVgTrack* track;
-
-    if (!iter->second.Enabled ||
-        this->TrackModel->GetMTime() < iter->second.CheckWireTime)
+    allWires.push_back(&iter->second);
+    if (iter->second.Enabled)
       {
-      // nothing has changed (because we can't yet modify a trip wire)
-      continue;
+      if (iter->second.NeedsFullCheck)
+        {
+        this->Internals->RemoveTripWireEvents(iter->first);
+        fullWires.push_back(&iter->second);
+        }
+      else
+        {
+        incrementalWires.push_back(&iter->second);
+        }
       }
+    }
 
-    // for now, always clear all (if any) for this trip wire, and recompute
-    this->Internals->RemoveTripWireEvents(iter->first);
-    iter->second.CheckWireTime.Modified();
+  vtkVgTripWireGrid fullGrid, incrementalGrid;
+  fullGrid.Build(fullWires);
+  incrementalGrid.Build(incrementalWires);
 
-    this->TrackModel->InitTrackTraversal();
-    while ((track = this->TrackModel->GetNextTrack().GetTrack()))
+  vtkVgTrack* track;
+  this->TrackModel->InitTrackTraversal();
+  while ((track = this->TrackModel->GetNextTrack().GetTrack()))
+    {
+    vtkVgTripWireTrackState& state =
+      this->Internals->TrackStates[track->GetId()];
+
+    // if points we have already tested were changed, or the track was
+    // replaced, forget what we found for it and test the whole path again
+    if (state.Track != track || track->GetPointEditTime() > state.CheckTime)
       {
-      if (track->GetNumberOfPathPoints() < 2)
+      if (state.Track)
         {
-        continue;
+        this->Internals->RemoveTrackEvents(track->GetId(), incrementalWires);
         }
+      state.LastTime = vtkVgTimeStamp();
+      }
 
-      std::vector<IntersectionInfo> intersections;
-      this->Internals->GetTripWireVsTrackIntersections(
-        track, iter->second, intersections);
+    state.Track = track;
+    state.CheckTime = checkTime.GetMTime();
+    if (track->GetNumberOfPathPoints() < 2)
+      {
+      state.LastTime = vtkVgTimeStamp();
+      continue;
+      }
 
-      if (intersections.size() > 0)
-        {
-        TrackEventMap::iterator trackEventMap =
-          iter->second.TriggeredEventMap.find(track->GetId());
-        if (trackEventMap == iter->second.TriggeredEventMap.end())
-          {
-          // no entry yet for this track; create one
-          std::vector<vtkVgTripWireEventInfo> tripWireEventInfo;
-          iter->second.TriggeredEventMap[track->GetId()] = tripWireEventInfo;
-          trackEventMap =
-            iter->second.TriggeredEventMap.find(track->GetId());
-          }
+    vtkVgTimeStamp end;
+    if (!fullGrid.IsEmpty())
+      {
+      this->Internals->CheckTrackPath(track, vtkVgTimeStamp(), fullGrid, end);
+      }
+    if (!incrementalGrid.IsEmpty())
+      {
+      this->Internals->CheckTrackPath(track, state.LastTime,
+                                      incrementalGrid, end);
+      }
+    if (fullGrid.IsEmpty() && incrementalGrid.IsEmpty())
+      {
+      // nothing to test, but keep track of how much of the path was seen
+      end = track->GetEndFrame();
+      }
+    state.LastTime = end;
+    }
 
-        std::vector<IntersectionInfo>::iterator intersectionIter;
-        for (intersectionIter = intersections.begin();
-             intersectionIter != intersections.end(); intersectionIter++)
-          {
-          // right now, computing start time for the event regardless of whether
-          // entering/exiting or open trip wire
-
-          vtkVgTimeStamp startTime = intersectionIter->PostFrame;
-          // for now, PreTripDuration measured from the point that
-          // caused the crossing, NOT where the interesetion occurred (which
-          // we should maybe do at some point)
-          startTime.ShiftBackward(this->PreTripDuration);
-          if (intersectionIter->PreFrame < startTime)
-            {
-            // if previous track point is more than PreTripDuration "old",
-            // use it for the start
-            startTime = intersectionIter->PreFrame;
-            }
-          else if (startTime < track->GetStartFrame())
-            {
-            // if PreTripDuration puts us before start of track, use start of
-            // track as start
-            startTime = track->GetStartFrame();
-            }
-
-          // create events for both entering and exiting
-          if (intersectionIter->ClassifierType == -1)
-            {
-            this->Internals->AddEvent(
-              track, startTime, *intersectionIter,
-              this->EnteringRegionId, this->EventIdCounter++, trackEventMap);
-            this->Internals->AddEvent(
-              track, startTime, *intersectionIter,
-              this->ExitingRegionId, this->EventIdCounter++, trackEventMap);
-            }
-          else
-            {
-            this->Internals->AddEvent(
-              track, startTime, *intersectionIter,
-              intersectionIter->ClassifierType, this->EventIdCounter++,
-              trackEventMap);
-            }
-          }
-        }
+  // discard events of tracks that are no longer in the model
+  std::map<vtkIdType, vtkVgTripWireTrackState>::iterator stateIter =
+    this->Internals->TrackStates.begin();
+  while (stateIter != this->Internals->TrackStates.end())
+    {
+    if (stateIter->second.CheckTime != checkTime.GetMTime())
+      {
+      this->Internals->RemoveTrackEvents(stateIter->first, allWires);
+      this->Internals->TrackStates.erase(stateIter++);
       }
+    else
+      {
+      ++stateIter;
+      }
+    }
+
+  for (size_t i = 0, k = fullWires.size(); i < k; ++i)
+    {
+    fullWires[i]->NeedsFullCheck = false;
     }
 
   this->Internals->CheckTripWiresTime.Modified();
@@ -711,21 +1101,20 @@ void vtkVgTripWireManager::CheckTrackSegment(double pt1[2], double pt2[2],
   double pts[2][3] = { {pt1[0], pt1[1], 0.0}, {pt2[0], pt2[1], 0.0} };
   const vtkVgTimeStamp timeStamps[2] = {timeStamp1, timeStamp2};
 
-  std::map<vtkIdType, vtkVgTripWireInfo>::iterator iter;
-  for (iter = this->Internals->TripWires.begin();
-       iter != this->Internals->TripWires.end(); iter++)
+  // only test the enabled wires near the segment
+  double bounds[4];
+  GetSegmentBounds(pts, bounds);
+  std::vector<vtkVgTripWireInfo*>& candidates = this->Internals->Candidates;
+  this->Internals->GetEnabledGrid().FindCandidates(bounds, candidates);
+
+  for (size_t i = 0, k = candidates.size(); i < k; ++i)
     {
-    if (!iter->second.Enabled)
-      {
-      continue;
-      }
     IntersectionInfo intersectionInfo;
     if (this->Internals->GetTripWireVsSegmentIntersections(pts, timeStamps,
-        iter->second, intersectionInfo))
+        *candidates[i], intersectionInfo))
       {
       intersections.push_back(intersectionInfo);
       }
-
     }
 }
 
@@ -789,46 +1178,72 @@ void vtkVgTripWireManager::CheckTrackForTripWireEvents(
     return;
     }
 
-  std::map<vtkIdType, vtkVgTripWireInfo>::iterator iter;
-  for (iter = this->Internals->TripWires.begin();
-       iter != this->Internals->TripWires.end(); iter++)
+  if (!checkForTrip && !checkForEnter && !checkForExit)
     {
-    if (!iter->second.Enabled)
-      {
-      continue;
-      }
-    std::vector<IntersectionInfo> intersections;
-    this->Internals->GetTripWireVsTrackIntersections(track, iter->second, intersections);
+    return;
+    }
+
+  track->InitPathTraversal();
+
+  vtkVgTimeStamp timeStamps[2];
+  vtkIdType ptId = track->GetNextPathPt(timeStamps[0]);
+  if (ptId == -1)
+    {
+    return;
+    }
+
+  vtkPoints* points = track->GetPoints();
+  double trackPoints[2][3];
+  points->GetPoint(ptId, trackPoints[0]);
 
-    std::vector<IntersectionInfo>::iterator intersectionIter;
-    for (intersectionIter = intersections.begin();
-         intersectionIter != intersections.end(); intersectionIter++)
+  vtkVgTripWireGrid& grid = this->Internals->GetEnabledGrid();
+  std::vector<vtkVgTripWireInfo*>& candidates = this->Internals->Candidates;
+
+  IntersectionInfo intersectionInfo;
+  while ((ptId = track->GetNextPathPt(timeStamps[1])) != -1)
+    {
+    points->GetPoint(ptId, trackPoints[1]);
+
+    // only test the enabled wires near the segment
+    double bounds[4];
+    GetSegmentBounds(trackPoints, bounds);
+    grid.FindCandidates(bounds, candidates);
+    for (size_t i = 0, k = candidates.size(); i < k; ++i)
       {
-      if (checkForTrip && intersectionIter->ClassifierType == this->TripWireId)
+      if (!this->Internals->GetTripWireVsSegmentIntersections(
+            trackPoints, timeStamps, *candidates[i], intersectionInfo))
+        {
+        continue;
+        }
+
+      const int classifierType = intersectionInfo.ClassifierType;
+      if (checkForTrip && classifierType == this->TripWireId)
         {
         tripEvent = true;
         }
       if (checkForEnter &&
-          (intersectionIter->ClassifierType == this->EnteringRegionId ||
-           intersectionIter->ClassifierType == -1))
+          (classifierType == this->EnteringRegionId || classifierType == -1))
         {
         enterEvent = true;
         }
       if (checkForExit &&
-          (intersectionIter->ClassifierType == this->ExitingRegionId ||
-           intersectionIter->ClassifierType == -1))
+          (classifierType == this->ExitingRegionId || classifierType == -1))
         {
         exitEvent = true;
         }
-      }
 
-    // have we already found true for everything we're looking for?  If so, return
-    if ((!checkForTrip || tripEvent) &&
-        (!checkForEnter || enterEvent) &&
-        (!checkForExit || exitEvent))
-      {
-      return;
+      // have we already found true for everything we're looking for?  If
+      // so, return
+      if ((!checkForTrip || tripEvent) &&
+          (!checkForEnter || enterEvent) &&
+          (!checkForExit || exitEvent))
+        {
+        return;
+        }
       }
+
+    timeStamps[0] = timeStamps[1];
+    std::copy(trackPoints[1], trackPoints[1] + 3, trackPoints[0]);
     }
 }
 
@@ -847,6 +1262,12 @@ void vtkVgTripWireManager::SetTripWireEnabled(vtkIdType tripWireId, bool state)
   // the work
 
   iter->second.Enabled = state;
+  this->Internals->InvalidateEnabledGrid();
+  if (state)
+    {
+    // tracks may have changed while the wire was disabled
+    iter->second.NeedsFullCheck = true;
+    }
   this->Modified();
 }
 
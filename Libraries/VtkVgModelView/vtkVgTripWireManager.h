@@ -42,7 +42,11 @@ public:
 
   // Description:
   // Main "execute" function to check the status of all "trip wires" relative
-  // to the tracks in the track model.
+  // to the tracks in the track model.  Checking is incremental: only track
+  // points appended since the previous check are tested, and previously
+  // triggered events are kept (with their ids) unless the points that
+  // triggered them have been edited.  Trip wires that were added or
+  // re-enabled since the previous check are tested against the full tracks.
   void CheckTripWires();
 
   // Description:
@@ -51,6 +55,8 @@ public:
   void CheckTripWire(vtkIdType tripWireId, std::vector<IntersectionInfo>& intersections);
 
   // Description:
+  // Check a track segment for intersections against the enabled trip wires.
+  // Only wires whose bounds overlap the segment are tested.
   //int ClassifierType, // Entering, Exiting, or TripWire
   //double IntersectionPt[2],  // x, y of intersection
   //vtkVgTimeStamp &IntersectionTime);  // Interpolated "Time" at IntersectionPt
@@ -0,0 +1,300 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "../vtkVgTerrainTileCache.h"
+
+#include <qtTest.h>
+
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <thread>
+
+typedef vtkVgTerrainTileCache::TileKey TileKey;
+typedef vtkVgTerrainTileCache::LoadRequest LoadRequest;
+typedef vtkVgTerrainTileCache::NotifyFunction NotifyFunction;
+
+const int TILE_SIZE = 64;
+
+//-----------------------------------------------------------------------------
+// Tile reader which makes tiles filled with one more than their level, and
+// can run a hook while reading a given tile, so that the tests can control
+// when the reads of the cache's worker threads finish
+struct TileLoader
+{
+  TileLoader() : Calls(0), Finished(0) {}
+
+  vtkSmartPointer<vtkImageData> read(const TileKey& key)
+    {
+    ++this->Calls;
+    const auto hook = this->Hooks.find(key);
+    if (hook != this->Hooks.end())
+      {
+      hook->second();
+      }
+
+    vtkSmartPointer<vtkImageData> tile = vtkSmartPointer<vtkImageData>::New();
+    tile->SetExtent(key.X * TILE_SIZE, ((key.X + 1) * TILE_SIZE) - 1,
+                    key.Y * TILE_SIZE, ((key.Y + 1) * TILE_SIZE) - 1, 0, 0);
+    tile->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+    memset(tile->GetScalarPointer(), key.Level + 1, TILE_SIZE * TILE_SIZE);
+
+    ++this->Finished;
+    return tile;
+    }
+
+  vtkVgTerrainTileCache::ReadFunction reader()
+    {
+    return [this](const TileKey& key){ return this->read(key); };
+    }
+
+  // Hooks must be set before the tiles are queued
+  std::map<TileKey, std::function<void()>> Hooks;
+  std::atomic<int> Calls;
+  std::atomic<int> Finished;
+};
+
+//-----------------------------------------------------------------------------
+void load(vtkVgTerrainTileCache& cache, const std::vector<TileKey>& keys)
+{
+  std::vector<LoadRequest> requests;
+  for (size_t n = 0; n < keys.size(); ++n)
+    {
+    requests.push_back(LoadRequest(keys[n], false));
+    }
+  cache.Queue(requests);
+  cache.Wait();
+}
+
+//-----------------------------------------------------------------------------
+int tileLevel(vtkImageData* tile)
+{
+  return static_cast<unsigned char*>(tile->GetScalarPointer())[0] - 1;
+}
+
+//-----------------------------------------------------------------------------
+int testEviction(qtTest& testObject)
+{
+  TileLoader loader;
+  vtkVgTerrainTileCache cache(loader.reader(), NotifyFunction(), 1);
+
+  const TileKey a(0, 0, 0, 0), b(0, 0, 1, 0), c(0, 0, 2, 0), d(0, 0, 3, 0);
+  load(cache, { a, b, c });
+  TEST_EQUAL(cache.GetCachedTileCount(), vtkTypeInt64(3));
+
+  const vtkTypeInt64 size = cache.GetCachedBytes() / 3;
+  TEST(size >= TILE_SIZE * TILE_SIZE);
+  cache.SetMemoryBudget(3 * size);
+  TEST_EQUAL(cache.GetEvictionCount(), vtkTypeInt64(0));
+
+  // Using the first tile leaves the second as the least recently used, so
+  // it is the one evicted to make room for a new tile
+  TEST(cache.Touch(a));
+  load(cache, { d });
+  TEST_EQUAL(cache.GetEvictionCount(), vtkTypeInt64(1));
+  TEST_EQUAL(cache.GetCachedBytes(), 3 * size);
+  TEST(!cache.IsCachedOrLoading(b));
+  TEST(cache.IsCachedOrLoading(a));
+  TEST(cache.IsCachedOrLoading(c));
+  TEST(cache.IsCachedOrLoading(d));
+
+  // Reducing the budget evicts tiles in order of use; from least to most
+  // recent, the tiles are now c, a and d
+  cache.SetMemoryBudget(2 * size);
+  TEST(!cache.IsCachedOrLoading(c));
+  TEST(cache.IsCachedOrLoading(a));
+  cache.SetMemoryBudget(size);
+  TEST(!cache.IsCachedOrLoading(a));
+  TEST(cache.IsCachedOrLoading(d));
+  TEST_EQUAL(cache.GetEvictionCount(), vtkTypeInt64(3));
+  TEST_EQUAL(cache.GetCachedBytes(), size);
+
+  // A tile which does not fit in the budget at all is not kept
+  cache.SetMemoryBudget(size - 1);
+  load(cache, { a });
+  TEST_EQUAL(cache.GetCachedTileCount(), vtkTypeInt64(0));
+  TEST_EQUAL(loader.Calls.load(), 5);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testPinning(qtTest& testObject)
+{
+  TileLoader loader;
+  vtkVgTerrainTileCache cache(loader.reader(), NotifyFunction(), 1);
+
+  const TileKey a(0, 0, 0, 0), b(0, 0, 1, 0), c(0, 0, 2, 0), d(0, 0, 3, 0);
+  load(cache, { a });
+  const vtkTypeInt64 size = cache.GetCachedBytes();
+
+  // Tiles of a view which needs more than the budget are all kept, rather
+  // than the last tiles read evicting the first
+  cache.SetMemoryBudget(2 * size);
+  cache.SetPinnedTiles({ a, b, c });
+  load(cache, { b, c });
+  TEST_EQUAL(cache.GetCachedBytes(), 3 * size);
+  TEST_EQUAL(cache.GetEvictionCount(), vtkTypeInt64(0));
+
+  // A tile outside of the view is not kept while the view is over budget
+  load(cache, { d });
+  TEST(!cache.IsCachedOrLoading(d));
+  TEST_EQUAL(cache.GetEvictionCount(), vtkTypeInt64(1));
+
+  // Unpinned tiles are evicted, least recently used first, once the view
+  // changes
+  cache.SetPinnedTiles({ c });
+  TEST(!cache.IsCachedOrLoading(a));
+  TEST(cache.IsCachedOrLoading(b));
+  TEST(cache.IsCachedOrLoading(c));
+  TEST_EQUAL(cache.GetCachedBytes(), 2 * size);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testFallback(qtTest& testObject)
+{
+  const int levels = 3;
+  const TileKey fine(0, 0, 3, 2), coarse(0, 2, 0, 0);
+
+  // Hold the read of the fine tile until the test has looked at the cache
+  std::promise<void> started, release;
+  std::shared_future<void> released = release.get_future().share();
+
+  TileLoader loader;
+  loader.Hooks[fine] = [&]{ started.set_value(); released.wait(); };
+  vtkVgTerrainTileCache cache(loader.reader(), NotifyFunction(), 1);
+
+  int shift = -1;
+  TEST(!cache.FindCovering(fine, levels, shift));
+
+  // The coarsest tile is queued first, so that it can stand in for the fine
+  // tile while that is being read
+  cache.Queue({ LoadRequest(coarse, false), LoadRequest(fine, false) });
+  started.get_future().wait();
+
+  vtkSmartPointer<vtkImageData> tile =
+    cache.FindCovering(fine, levels, shift);
+  if (TEST(tile.GetPointer()) == 0)
+    {
+    TEST_EQUAL(shift, 2);
+    TEST_EQUAL(tileLevel(tile), 2);
+    }
+  TEST(cache.IsCachedOrLoading(fine));
+  TEST_EQUAL(cache.GetPendingTileCount(), vtkTypeInt64(1));
+  TEST(cache.TakeArrivals());
+
+  release.set_value();
+  cache.Wait();
+
+  tile = cache.FindCovering(fine, levels, shift);
+  if (TEST(tile.GetPointer()) == 0)
+    {
+    TEST_EQUAL(shift, 0);
+    TEST_EQUAL(tileLevel(tile), 0);
+    }
+  TEST_EQUAL(cache.GetPendingTileCount(), vtkTypeInt64(0));
+  TEST(cache.TakeArrivals());
+  TEST(!cache.TakeArrivals());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+// Hold the read of a tile until the other queued tiles have been abandoned
+void holdUntilAbandoned(TileLoader& loader, const TileKey& key,
+                        vtkVgTerrainTileCache*& cache,
+                        std::promise<void>& started)
+{
+  loader.Hooks[key] = [&]{
+    started.set_value();
+    while (cache->GetPendingTileCount() > 1)
+      {
+      std::this_thread::yield();
+      }
+  };
+}
+
+//-----------------------------------------------------------------------------
+int testReset(qtTest& testObject)
+{
+  const TileKey a(0, 0, 0, 0), b(0, 0, 1, 0), c(0, 0, 2, 0);
+
+  TileLoader loader;
+  std::promise<void> started;
+  vtkVgTerrainTileCache* cache = 0;
+  holdUntilAbandoned(loader, b, cache, started);
+
+  std::atomic<int> notified(0);
+  vtkVgTerrainTileCache resetCache(loader.reader(), [&]{ ++notified; }, 1);
+  cache = &resetCache;
+
+  load(resetCache, { a });
+  TEST_EQUAL(notified.load(), 1);
+
+  // Reset while the second tile is being read and the third is queued; the
+  // read can only finish after Reset has abandoned the queued tile, so if
+  // Reset did not wait for it, it would return before the read finished
+  resetCache.Queue({ LoadRequest(b, false), LoadRequest(c, false) });
+  started.get_future().wait();
+  resetCache.Reset();
+
+  TEST_EQUAL(loader.Finished.load(), 2);
+  TEST_EQUAL(loader.Calls.load(), 2);
+  TEST_EQUAL(resetCache.GetPendingTileCount(), vtkTypeInt64(0));
+  TEST_EQUAL(resetCache.GetCachedTileCount(), vtkTypeInt64(0));
+  TEST_EQUAL(resetCache.GetCachedBytes(), vtkTypeInt64(0));
+  TEST(!resetCache.TakeArrivals());
+
+  // The cache is still usable afterwards
+  load(resetCache, { c });
+  TEST(resetCache.IsCachedOrLoading(c));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testDestruction(qtTest& testObject)
+{
+  const TileKey a(0, 0, 0, 0), b(0, 0, 1, 0), c(0, 0, 2, 0);
+
+  TileLoader loader;
+  std::promise<void> started;
+  vtkVgTerrainTileCache* cache = 0;
+  holdUntilAbandoned(loader, a, cache, started);
+
+  std::atomic<int> notified(0);
+  cache = new vtkVgTerrainTileCache(loader.reader(), [&]{ ++notified; }, 1);
+
+  // Destroy the cache while a tile is being read and others are queued; the
+  // destructor must wait for the read, and the queued tiles are never read
+  cache->Queue({ LoadRequest(a, false), LoadRequest(b, false),
+                 LoadRequest(c, false) });
+  started.get_future().wait();
+  delete cache;
+
+  TEST_EQUAL(loader.Finished.load(), 1);
+  TEST_EQUAL(loader.Calls.load(), 1);
+  TEST_EQUAL(notified.load(), 0);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char** argv)
+{
+  Q_UNUSED(argc);
+  Q_UNUSED(argv);
+
+  qtTest testObject;
+
+  testObject.runSuite("Eviction Tests", testEviction);
+  testObject.runSuite("Pinning Tests", testPinning);
+  testObject.runSuite("Fallback Tests", testFallback);
+  testObject.runSuite("Reset Tests", testReset);
+  testObject.runSuite("Destruction Tests", testDestruction);
+
+  return testObject.result();
+}
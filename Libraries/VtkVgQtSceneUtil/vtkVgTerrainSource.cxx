@@ -2,10 +2,11 @@
 // OSI-approved BSD 3-Clause License. See top-level LICENSE file or
 // https://github.com/Kitware/vivia/blob/master/LICENSE for details.
 
-#include "vtkVgTerrainSource.h"
+#include "moc_vtkVgTerrainSourcePrivate.cpp"
 
 // VisGUI includes
 #include "vtkVgCoordinateTransform.h"
+#include "vtkVgTerrainTileCache.h"
 
 #include <qtKstReader.h>
 #include <qtStlUtil.h>
@@ -18,7 +19,10 @@
 #include <vtkVgTerrain.h>
 #include <vtkVgUtil.h>
 
+#include <vgUtil.h>
+
 // VTK includes.
+#include <vtkCommand.h>
 #include <vtkImageData.h>
 #include <vtkImageActor.h>
 #include <vtkMath.h>
@@ -28,7 +32,15 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFileInfo>
+#include <QThread>
+
+// STL includes
+#include <algorithm>
+#include <set>
+
+#include <cstring>
 
 vtkStandardNewMacro(vtkVgTerrainSource);
 
@@ -63,10 +75,416 @@ inline double dist(const vgPoint2d& a, const vgPoint2d b)
   return sqrt((dx * dx) + (dy * dy));
 }
 
+typedef vtkVgTerrainTileCache::TileKey TileKey;
+typedef vtkVgTerrainTileCache::LoadRequest LoadRequest;
+
+//-----------------------------------------------------------------------------
+struct ImageState
+{
+  ImageState() :
+    Level(-1), HasView(false), HasCenter(false), ShownLevel(-1),
+    Complete(false)
+    {
+    std::fill(this->Extents, this->Extents + 4, -1);
+    std::fill(this->ShownExtents, this->ShownExtents + 4, -1);
+    }
+
+  vtkSmartPointer<vtkVgMultiResJpgImageReader2> Reader;
+  vtkSmartPointer<vtkImageData> Output;
+
+  // Level and extents (in pixels of that level) wanted by the current view
+  int Level;
+  int Extents[4];
+  bool HasView;
+
+  // Center of the view, in pixels of the full resolution image, used to
+  // determine the pan direction
+  double Center[2];
+  bool HasCenter;
+
+  // Level, extents and tiles from which the output was last composed
+  int ShownLevel;
+  int ShownExtents[4];
+  std::vector<vtkSmartPointer<vtkImageData> > ShownTiles;
+  bool Complete;
+};
+
+//-----------------------------------------------------------------------------
+int computeLevel(int imageLevel, double scale, int numberOfLevels)
+{
+  // This matches the level selection of vtkVgMultiResJpgImageReader2,
+  // including its delay in going to a coarser level
+  int level = imageLevel;
+  if (level == -1)
+    {
+    level = (scale > 0.0 ? static_cast<int>(1.1 * log(scale) / log(2.0)) : 0);
+    }
+  return std::max(0, std::min(level, numberOfLevels - 1));
+}
+
+//-----------------------------------------------------------------------------
+bool computeExtents(vtkVgMultiResJpgImageReader2* reader, int level,
+                    int ext[4])
+{
+  // This matches the extents produced by vtkVgMultiResJpgImageReader2 for
+  // the reader's read extents (with ExactExtent on)
+  int dims[2];
+  reader->GetDimensions(dims);
+  reader->GetReadExtents(ext);
+
+  if (ext[0] == -1 && ext[1] == -1 && ext[2] == -1 && ext[3] == -1)
+    {
+    ext[0] = ext[2] = 0;
+    ext[1] = dims[0] - 1;
+    ext[3] = dims[1] - 1;
+    }
+  else if (ext[0] >= dims[0] || ext[1] < 0 ||
+           ext[2] >= dims[1] || ext[3] < 0)
+    {
+    return false;
+    }
+  else
+    {
+    vgTruncateLowerBoundary(ext[0], 0);
+    vgTruncateLowerBoundary(ext[2], 0);
+    vgTruncateUpperBoundary(ext[1], dims[0] - 1);
+    vgTruncateUpperBoundary(ext[3], dims[1] - 1);
+    }
+
+  if (level > 0)
+    {
+    const int k = 1 << level;
+    ext[0] /= k;
+    ext[2] /= k;
+    ext[1] = ((ext[1] + 1) / k) - 1;
+    ext[3] = ((ext[3] + 1) / k) - 1;
+
+    vgExpandUpperBoundary(ext[1], 0);
+    vgExpandUpperBoundary(ext[3], 0);
+    vgExpandLowerBoundary(ext[0], ext[1]);
+    vgExpandLowerBoundary(ext[2], ext[3]);
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void copyReplicated(vtkImageData* output, vtkImageData* tile, int shift,
+                    const int region[4])
+{
+  // Fill the region of the output by replicating the pixels of a tile which
+  // is coarser by 2^shift
+  int tileExt[6];
+  tile->GetExtent(tileExt);
+  const int components = output->GetNumberOfScalarComponents();
+  if (tile->GetNumberOfScalarComponents() != components)
+    {
+    return;
+    }
+
+  for (int j = region[2]; j <= region[3]; ++j)
+    {
+    int tj = j >> shift;
+    vgTruncateLowerBoundary(tj, tileExt[2]);
+    vgTruncateUpperBoundary(tj, tileExt[3]);
+
+    unsigned char* out =
+      static_cast<unsigned char*>(output->GetScalarPointer(region[0], j, 0));
+    for (int i = region[0]; i <= region[1]; ++i, out += components)
+      {
+      int ti = i >> shift;
+      vgTruncateLowerBoundary(ti, tileExt[0]);
+      vgTruncateUpperBoundary(ti, tileExt[1]);
+      memcpy(out, tile->GetScalarPointer(ti, tj, 0), components);
+      }
+    }
+}
+
 } // namespace <anonymous>
 
 //-----------------------------------------------------------------------------
-vtkVgTerrainSource::vtkVgTerrainSource() : vtkVgDataSourceBase()
+class vtkVgTerrainSource::vtkInternal
+{
+public:
+  vtkInternal(vtkVgTerrainSource* q);
+
+  void Reset();
+  void AddImage(vtkVgBaseImageSource* reader, vtkImageData* output);
+
+  // Called by the tile cache's worker threads
+  vtkSmartPointer<vtkImageData> ReadTile(const TileKey& key);
+  void TileLoaded();
+
+  bool Compose(int index);
+  bool UpdateImagery(bool force);
+
+  // Images are only added or removed while the tile cache is idle
+  std::vector<ImageState> Images;
+
+  QAtomicInt Asynchronous;
+
+  // Only used by the owning thread (latency is in nanoseconds)
+  int PrefetchDistance;
+
+  vtkTypeInt64 Hits;
+  vtkTypeInt64 Misses;
+  vtkTypeInt64 Fallbacks;
+
+  QElapsedTimer Clock;
+  qint64 ViewChangeTime;
+  bool ViewPending;
+  qint64 LastLatency;
+  qint64 MaximumLatency;
+  qint64 TotalLatency;
+  qint64 LatencySamples;
+
+  // The notifier must outlive the cache, whose threads use it
+  vtkVgTerrainSourceNotifier Notifier;
+  vtkVgTerrainTileCache Cache;
+};
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainSourceNotifier::vtkVgTerrainSourceNotifier(
+  vtkVgTerrainSource* source) : Source(source), Posted(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSourceNotifier::post()
+{
+  if (this->Posted.testAndSetOrdered(0, 1))
+    {
+    QMetaObject::invokeMethod(this, "deliver", Qt::QueuedConnection);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSourceNotifier::deliver()
+{
+  this->Posted.storeRelease(0);
+  this->Source->UpdateLoadedTiles();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainSource::vtkInternal::vtkInternal(vtkVgTerrainSource* q) :
+  Asynchronous(0), PrefetchDistance(1), Hits(0), Misses(0), Fallbacks(0),
+  ViewChangeTime(0), ViewPending(false), LastLatency(0), MaximumLatency(0),
+  TotalLatency(0), LatencySamples(0), Notifier(q),
+  // Tile reading is mostly I/O and decoding; a few threads are enough to
+  // keep up with interaction without competing with rendering
+  Cache([this](const TileKey& key){ return this->ReadTile(key); },
+        [this]{ this->TileLoaded(); },
+        qBound(1, QThread::idealThreadCount(), 4))
+{
+  this->Clock.start();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::vtkInternal::Reset()
+{
+  // Abandon any queued tiles, and wait for those in progress, since they
+  // refer to the images being discarded
+  this->Cache.Reset();
+  this->Images.clear();
+  this->ViewPending = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::vtkInternal::AddImage(
+  vtkVgBaseImageSource* reader, vtkImageData* output)
+{
+  ImageState image;
+  image.Reader = vtkVgMultiResJpgImageReader2::SafeDownCast(reader);
+  image.Output = output;
+  if (image.Reader && image.Output)
+    {
+    this->Images.push_back(image);
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkVgTerrainSource::vtkInternal::ReadTile(
+  const TileKey& key)
+{
+  return this->Images[key.Image].Reader->ReadTile(key.Level, key.X, key.Y);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::vtkInternal::TileLoaded()
+{
+  if (this->Asynchronous.loadAcquire())
+    {
+    this->Notifier.post();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainSource::vtkInternal::Compose(int index)
+{
+  ImageState& image = this->Images[index];
+  if (!image.HasView)
+    {
+    // The view does not overlap the image; show nothing
+    if (image.ShownTiles.empty() && image.Complete)
+      {
+      return false;
+      }
+    image.Output->Initialize();
+    image.ShownTiles.clear();
+    image.Complete = true;
+    return true;
+    }
+
+  int tileDims[2];
+  image.Reader->GetTileDimensions(tileDims);
+  const int levels = image.Reader->GetNumberOfLevels();
+  const int* const ext = image.Extents;
+  const int grid[4] =
+    {
+    ext[0] / tileDims[0], ext[1] / tileDims[0],
+    ext[2] / tileDims[1], ext[3] / tileDims[1]
+    };
+
+  // Find, for each visible tile, the tile of the finest level at or above the
+  // wanted level which covers it
+  std::vector<vtkSmartPointer<vtkImageData> > tiles;
+  std::vector<int> shifts;
+  bool complete = true;
+  bool any = false;
+  for (int y = grid[2]; y <= grid[3]; ++y)
+    {
+    for (int x = grid[0]; x <= grid[1]; ++x)
+      {
+      int shift = 0;
+      vtkSmartPointer<vtkImageData> tile = this->Cache.FindCovering(
+        TileKey(index, image.Level, x, y), levels, shift);
+      complete = complete && tile && shift == 0;
+      any = any || tile;
+      tiles.push_back(tile);
+      shifts.push_back(shift);
+      }
+    }
+
+  // If nothing at all is available, keep showing the old imagery (which is
+  // hopefully at least close) rather than a blank image
+  if (!any ||
+      (complete == image.Complete && tiles == image.ShownTiles &&
+       image.Level == image.ShownLevel &&
+       std::equal(ext, ext + 4, image.ShownExtents)))
+    {
+    return false;
+    }
+
+  int components = 0;
+  for (size_t n = 0; !components && n < tiles.size(); ++n)
+    {
+    components = (tiles[n] ? tiles[n]->GetNumberOfScalarComponents() : 0);
+    }
+
+  double spacing[3];
+  double* const readerSpacing = image.Reader->GetSpacing();
+  spacing[0] = static_cast<int>(readerSpacing[0]) << image.Level;
+  spacing[1] = static_cast<int>(readerSpacing[1]) << image.Level;
+  spacing[2] = static_cast<int>(readerSpacing[2]) << image.Level;
+
+  vtkSmartPointer<vtkImageData> output = vtkSmartPointer<vtkImageData>::New();
+  output->SetExtent(ext[0], ext[1], ext[2], ext[3], 0, 0);
+  output->SetSpacing(spacing);
+  output->SetOrigin(image.Reader->GetOrigin());
+  output->AllocateScalars(VTK_UNSIGNED_CHAR, components);
+  if (!complete)
+    {
+    memset(output->GetScalarPointer(), 0,
+           static_cast<size_t>(output->GetNumberOfPoints()) * components);
+    }
+
+  size_t n = 0;
+  for (int y = grid[2]; y <= grid[3]; ++y)
+    {
+    for (int x = grid[0]; x <= grid[1]; ++x, ++n)
+      {
+      vtkImageData* const tile = tiles[n];
+      if (!tile)
+        {
+        continue;
+        }
+
+      // Take the intersection of the tile and output
+      int region[6] =
+        {
+        x * tileDims[0], ((x + 1) * tileDims[0]) - 1,
+        y * tileDims[1], ((y + 1) * tileDims[1]) - 1,
+        0, 0
+        };
+      vgTruncateLowerBoundary(region[0], ext[0]);
+      vgTruncateUpperBoundary(region[1], ext[1]);
+      vgTruncateLowerBoundary(region[2], ext[2]);
+      vgTruncateUpperBoundary(region[3], ext[3]);
+
+      if (shifts[n] == 0)
+        {
+        int tileExt[6];
+        tile->GetExtent(tileExt);
+        vgTruncateUpperBoundary(region[1], tileExt[1]);
+        vgTruncateUpperBoundary(region[3], tileExt[3]);
+        if (region[0] <= region[1] && region[2] <= region[3])
+          {
+          output->CopyAndCastFrom(tile, region);
+          }
+        }
+      else
+        {
+        copyReplicated(output, tile, shifts[n], region);
+        }
+      }
+    }
+
+  image.Output->ShallowCopy(output);
+  image.ShownLevel = image.Level;
+  std::copy(ext, ext + 4, image.ShownExtents);
+  image.ShownTiles.swap(tiles);
+  image.Complete = complete;
+
+  if (!complete)
+    {
+    ++this->Fallbacks;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainSource::vtkInternal::UpdateImagery(bool force)
+{
+  if (!this->Cache.TakeArrivals() && !force)
+    {
+    return false;
+    }
+
+  bool changed = false;
+  bool complete = true;
+  for (size_t i = 0, k = this->Images.size(); i < k; ++i)
+    {
+    changed = this->Compose(static_cast<int>(i)) || changed;
+    complete = complete && this->Images[i].Complete;
+    }
+
+  // Record the time taken for the view to be fully shown
+  if (complete && this->ViewPending)
+    {
+    this->ViewPending = false;
+    this->LastLatency = this->Clock.nsecsElapsed() - this->ViewChangeTime;
+    this->MaximumLatency = std::max(this->MaximumLatency, this->LastLatency);
+    this->TotalLatency += this->LastLatency;
+    ++this->LatencySamples;
+    }
+
+  return changed;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainSource::vtkVgTerrainSource() : vtkVgDataSourceBase(),
+  Internal(new vtkInternal(this))
 {
   this->BaseTile = NULL;
   this->BaseTileData = NULL;
@@ -77,7 +495,7 @@ vtkVgTerrainSource::vtkVgTerrainSource() : vtkVgDataSourceBase()
 //-----------------------------------------------------------------------------
 vtkVgTerrainSource::~vtkVgTerrainSource()
 {
-  // Do nothing
+  delete this->Internal;
 }
 
 //-----------------------------------------------------------------------------
@@ -86,6 +504,13 @@ void vtkVgTerrainSource::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "DataSource: " << (this->DataSource ? "NULL" : this->DataSource) << "\n";
+
+  const vtkInternal* const d = this->Internal;
+  os << indent << "Asynchronous: " << this->GetAsynchronous() << '\n'
+     << indent << "MemoryBudget: " << d->Cache.GetMemoryBudget() << '\n'
+     << indent << "PrefetchDistance: " << d->PrefetchDistance << '\n'
+     << indent << "CachedTiles: " << d->Cache.GetCachedTileCount() << '\n'
+     << indent << "CachedBytes: " << d->Cache.GetCachedBytes() << '\n';
 }
 
 //-----------------------------------------------------------------------------
@@ -97,6 +522,8 @@ vtkSmartPointer<vtkVgTerrain> vtkVgTerrainSource::CreateTerrain()
     return 0;
     }
 
+  this->Internal->Reset();
+
   QUrl uri = QUrl::fromEncoded(this->GetDataSource());
   qtKstReader reader(uri);
 
@@ -275,6 +702,13 @@ vtkSmartPointer<vtkVgTerrain> vtkVgTerrainSource::CreateTerrain()
       reader.nextRecord();
       }
 
+    // Subsequent updates are served from the tile cache
+    this->Internal->AddImage(this->BaseTile, this->BaseTileData);
+    for (size_t i = 0, k = this->OtherTiles.size(); i < k; ++i)
+      {
+      this->Internal->AddImage(this->OtherTiles[i], this->OtherTilesData[i]);
+      }
+
     return terrain;
     }
   else
@@ -382,17 +816,306 @@ vtkMatrix4x4* vtkVgTerrainSource::GetCoordinateTransformMatrix() const
 //-----------------------------------------------------------------------------
 void vtkVgTerrainSource::Update()
 {
-  if (this->BaseTile)
+  vtkInternal* const d = this->Internal;
+  if (d->Images.empty())
     {
-    this->BaseTile->Update();
+    // Not created from a terrain description; just update the readers
+    if (this->BaseTile)
+      {
+      this->BaseTile->Update();
+
+      this->BaseTileData->ShallowCopy(this->BaseTile->GetOutput());
+      }
 
-    this->BaseTileData->ShallowCopy(this->BaseTile->GetOutput());
+    size_t numberOfOtherTiles = this->OtherTiles.size();
+    for (size_t i = 0; i < numberOfOtherTiles; ++i)
+      {
+      this->OtherTiles[i]->Update();
+      this->OtherTilesData[i]->ShallowCopy(this->OtherTiles[i]->GetOutput());
+      }
+    return;
     }
 
-  size_t numberOfOtherTiles = this->OtherTiles.size();
-  for (size_t i = 0; i < numberOfOtherTiles; ++i)
+  // Determine the tiles needed for the current view; when any are missing,
+  // the tile of the coarsest level covering it is loaded first so that there
+  // is something to show as soon as possible, followed by the missing tiles,
+  // followed by tiles just beyond the view in the direction of panning
+  std::vector<LoadRequest> coarseRequests;
+  std::vector<LoadRequest> requests;
+  std::vector<LoadRequest> prefetchRequests;
+  std::set<TileKey> requested;
+  bool viewChanged = false;
+
+  // The tiles of the view, and those used in their place until they arrive,
+  // must stay cached even if the view needs more than the memory budget;
+  // otherwise loading the last tiles of the view could evict the first
+  std::set<TileKey> pinned;
+
+  const bool asynchronous = this->GetAsynchronous();
+  const int prefetchDistance = (asynchronous ? d->PrefetchDistance : 0);
+
+  auto request = [&](std::vector<LoadRequest>& list, const TileKey& key,
+                     bool prefetch){
+    if (!d->Cache.IsCachedOrLoading(key) && requested.insert(key).second)
+      {
+      list.push_back(LoadRequest(key, prefetch));
+      }
+  };
+
+  for (size_t i = 0, k = d->Images.size(); i < k; ++i)
+    {
+    ImageState& image = d->Images[i];
+    vtkVgMultiResJpgImageReader2* const reader = image.Reader;
+    const int index = static_cast<int>(i);
+    const int levels = reader->GetNumberOfLevels();
+    const int level =
+      computeLevel(this->ImageLevel, reader->GetScale(), levels);
+
+    int ext[4];
+    const bool hasView = computeExtents(reader, level, ext);
+    if (hasView != image.HasView || level != image.Level ||
+        (hasView && !std::equal(ext, ext + 4, image.Extents)))
+      {
+      viewChanged = true;
+      }
+
+    // Determine the direction of panning; if the level changed, the view is
+    // being zoomed rather than panned
+    int readExt[4];
+    reader->GetReadExtents(readExt);
+    const double center[2] =
+      {
+      0.5 * (readExt[0] + readExt[1]),
+      0.5 * (readExt[2] + readExt[3])
+      };
+    int direction[2] = { 0, 0 };
+    if (image.HasCenter && level == image.Level)
+      {
+      direction[0] = (center[0] > image.Center[0]) -
+                     (center[0] < image.Center[0]);
+      direction[1] = (center[1] > image.Center[1]) -
+                     (center[1] < image.Center[1]);
+      }
+    image.Center[0] = center[0];
+    image.Center[1] = center[1];
+    image.HasCenter = true;
+
+    image.Level = level;
+    image.HasView = hasView;
+    std::copy(ext, ext + 4, image.Extents);
+    if (!hasView)
+      {
+      continue;
+      }
+
+    int tileDims[2], dims[2];
+    reader->GetTileDimensions(tileDims);
+    reader->GetDimensions(dims);
+    const int grid[4] =
+      {
+      ext[0] / tileDims[0], ext[1] / tileDims[0],
+      ext[2] / tileDims[1], ext[3] / tileDims[1]
+      };
+    const int lastTile[2] =
+      {
+      (std::max(dims[0] >> level, 1) - 1) / tileDims[0],
+      (std::max(dims[1] >> level, 1) - 1) / tileDims[1]
+      };
+    const int coarsestLevel = levels - 1;
+    const int shift = coarsestLevel - level;
+
+    for (int y = grid[2]; y <= grid[3]; ++y)
+      {
+      for (int x = grid[0]; x <= grid[1]; ++x)
+        {
+        const TileKey key(index, level, x, y);
+        pinned.insert(key);
+        if (d->Cache.Touch(key))
+          {
+          ++d->Hits;
+          continue;
+          }
+
+        ++d->Misses;
+        if (asynchronous && shift > 0)
+          {
+          const TileKey coarseKey(index, coarsestLevel,
+                                  x >> shift, y >> shift);
+          pinned.insert(coarseKey);
+          request(coarseRequests, coarseKey, false);
+          }
+        request(requests, key, false);
+        }
+      }
+
+    for (int n = 1; n <= prefetchDistance; ++n)
+      {
+      const int column = (direction[0] > 0 ? grid[1] + n : grid[0] - n);
+      if (direction[0] && column >= 0 && column <= lastTile[0])
+        {
+        for (int y = grid[2]; y <= grid[3]; ++y)
+          {
+          request(prefetchRequests, TileKey(index, level, column, y), true);
+          }
+        }
+
+      const int row = (direction[1] > 0 ? grid[3] + n : grid[2] - n);
+      if (direction[1] && row >= 0 && row <= lastTile[1])
+        {
+        for (int x = grid[0]; x <= grid[1]; ++x)
+          {
+          request(prefetchRequests, TileKey(index, level, x, row), true);
+          }
+        }
+      }
+    }
+
+  coarseRequests.insert(coarseRequests.end(),
+                        requests.begin(), requests.end());
+  coarseRequests.insert(coarseRequests.end(),
+                        prefetchRequests.begin(), prefetchRequests.end());
+
+  // Replace any tiles still queued for an earlier view; those still wanted
+  // are part of the new requests
+  d->Cache.SetPinnedTiles(pinned);
+  d->Cache.Queue(coarseRequests);
+
+  if (viewChanged)
     {
-    this->OtherTiles[i]->Update();
-    this->OtherTilesData[i]->ShallowCopy(this->OtherTiles[i]->GetOutput());
+    d->ViewChangeTime = d->Clock.nsecsElapsed();
+    d->ViewPending = true;
     }
+
+  if (!asynchronous)
+    {
+    d->Cache.Wait();
+    }
+
+  d->UpdateImagery(viewChanged);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::UpdateLoadedTiles()
+{
+  if (this->Internal->UpdateImagery(false))
+    {
+    this->InvokeEvent(vtkCommand::UpdateDataEvent);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::WaitForTiles()
+{
+  this->Internal->Cache.Wait();
+  this->UpdateLoadedTiles();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::SetAsynchronous(bool asynchronous)
+{
+  this->Internal->Asynchronous.storeRelease(asynchronous ? 1 : 0);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainSource::GetAsynchronous() const
+{
+  return this->Internal->Asynchronous.loadAcquire() != 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::SetMemoryBudget(vtkTypeInt64 bytes)
+{
+  this->Internal->Cache.SetMemoryBudget(bytes);
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetMemoryBudget() const
+{
+  return this->Internal->Cache.GetMemoryBudget();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::SetPrefetchDistance(int tiles)
+{
+  this->Internal->PrefetchDistance = std::max(tiles, 0);
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgTerrainSource::GetPrefetchDistance() const
+{
+  return this->Internal->PrefetchDistance;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetHitCount() const
+{
+  return this->Internal->Hits;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetMissCount() const
+{
+  return this->Internal->Misses;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetEvictionCount() const
+{
+  return this->Internal->Cache.GetEvictionCount();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetPrefetchedCount() const
+{
+  return this->Internal->Cache.GetPrefetchedCount();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetFallbackCount() const
+{
+  return this->Internal->Fallbacks;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetPendingTileCount() const
+{
+  return this->Internal->Cache.GetPendingTileCount();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainSource::GetCachedBytes() const
+{
+  return this->Internal->Cache.GetCachedBytes();
+}
+
+//-----------------------------------------------------------------------------
+double vtkVgTerrainSource::GetLastLatency() const
+{
+  return 1e-9 * this->Internal->LastLatency;
+}
+
+//-----------------------------------------------------------------------------
+double vtkVgTerrainSource::GetMaximumLatency() const
+{
+  return 1e-9 * this->Internal->MaximumLatency;
+}
+
+//-----------------------------------------------------------------------------
+double vtkVgTerrainSource::GetAverageLatency() const
+{
+  const vtkInternal* const d = this->Internal;
+  return (d->LatencySamples
+          ? 1e-9 * d->TotalLatency / d->LatencySamples
+          : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainSource::ResetStatistics()
+{
+  vtkInternal* const d = this->Internal;
+
+  d->Cache.ResetStatistics();
+  d->Hits = d->Misses = d->Fallbacks = 0;
+  d->LastLatency = d->MaximumLatency = d->TotalLatency = 0;
+  d->LatencySamples = 0;
 }
@@ -24,6 +24,20 @@ class vtkImageData;
 class vtkVgTerrain;
 class vtkVgBaseImageSource;
 
+// .NAME vtkVgTerrainSource - source of context imagery
+// .SECTION Description
+// vtkVgTerrainSource reads a KST context description and creates a terrain
+// containing an image actor for each of the multi-resolution images that it
+// lists. The imagery shown is updated to suit the visible extents and scale.
+//
+// Imagery is read a tile at a time into a cache shared by all levels, which
+// is bounded by a memory budget. In asynchronous mode, Update does not block
+// on reading; it shows whatever tiles are cached, substituting those of
+// coarser levels where the tiles of the level wanted are not yet available,
+// and queues the missing tiles (and, if panning, the tiles just beyond the
+// visible area in the pan direction) for loading by worker threads. When
+// tiles arrive, the imagery is updated from the event loop and
+// vtkCommand::UpdateDataEvent is invoked so that the view can be rendered.
 class VTKVGQT_SCENEUTIL_EXPORT vtkVgTerrainSource : public vtkVgDataSourceBase
 {
 public:
@@ -62,6 +76,53 @@ public:
   virtual void SetImageLevel(int level);
   vtkGetMacro(ImageLevel, int);
 
+  // Description:
+  // Set/get if imagery is loaded asynchronously. If disabled (the default),
+  // Update reads any tiles that are not already cached before returning.
+  void SetAsynchronous(bool);
+  bool GetAsynchronous() const;
+
+  // Description:
+  // Set/get the maximum amount of memory, in bytes, used to cache tiles.
+  // Defaults to 256 MiB. The tiles of the current view are kept even if
+  // they alone exceed the budget.
+  void SetMemoryBudget(vtkTypeInt64 bytes);
+  vtkTypeInt64 GetMemoryBudget() const;
+
+  // Description:
+  // Set/get how many rows or columns of tiles beyond the visible area, in
+  // the direction in which the view is being panned, are loaded ahead of
+  // being needed. Defaults to 1.
+  void SetPrefetchDistance(int tiles);
+  int GetPrefetchDistance() const;
+
+  // Description:
+  // Show any tiles which have finished loading since the last update, and
+  // invoke vtkCommand::UpdateDataEvent if this changed the imagery. This is
+  // called automatically from the event loop in asynchronous mode.
+  void UpdateLoadedTiles();
+
+  // Description:
+  // Block until all queued tiles have been loaded, then show them.
+  void WaitForTiles();
+
+  // Description:
+  // Get statistics on the use of the tile cache. Tiles needed by a view
+  // count as hits if cached, and misses otherwise. Latency is the time, in
+  // seconds, from an update to a view until all imagery for that view is
+  // shown at the wanted level.
+  vtkTypeInt64 GetHitCount() const;
+  vtkTypeInt64 GetMissCount() const;
+  vtkTypeInt64 GetEvictionCount() const;
+  vtkTypeInt64 GetPrefetchedCount() const;
+  vtkTypeInt64 GetFallbackCount() const;
+  vtkTypeInt64 GetPendingTileCount() const;
+  vtkTypeInt64 GetCachedBytes() const;
+  double GetLastLatency() const;
+  double GetMaximumLatency() const;
+  double GetAverageLatency() const;
+  void ResetStatistics();
+
 protected:
   vtkVgTerrainSource();
   virtual ~vtkVgTerrainSource();
@@ -80,6 +141,9 @@ protected:
 private:
   vtkVgTerrainSource(const vtkVgTerrainSource&);
   void operator= (const vtkVgTerrainSource&);
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif // __vtkVgTerrainSource_h
@@ -0,0 +1,37 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vtkVgTerrainSourcePrivate_h
+#define __vtkVgTerrainSourcePrivate_h
+
+#include <QAtomicInt>
+#include <QObject>
+
+#include "vtkVgTerrainSource.h"
+
+//-----------------------------------------------------------------------------
+// Object living in the thread which owns the terrain source, used by the
+// tile loading threads to have newly loaded tiles shown from the event loop;
+// requests made before an earlier one has been delivered are coalesced
+class vtkVgTerrainSourceNotifier : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit vtkVgTerrainSourceNotifier(vtkVgTerrainSource* source);
+
+  void post();
+
+protected slots:
+  void deliver();
+
+protected:
+  vtkVgTerrainSource* const Source;
+  QAtomicInt Posted;
+
+private:
+  Q_DISABLE_COPY(vtkVgTerrainSourceNotifier)
+};
+
+#endif
@@ -0,0 +1,291 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vtkVgTerrainTileCache.h"
+
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainTileCache::vtkVgTerrainTileCache(
+  const ReadFunction& read, const NotifyFunction& notify, int threads) :
+  Read(read), Notify(notify), MemoryBudget(256 << 20), CachedBytes(0),
+  ActiveWorkers(0), TilesArrived(false), Stop(false), Evictions(0),
+  Prefetched(0)
+{
+  this->Pool.setMaxThreadCount(std::max(threads, 1));
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainTileCache::~vtkVgTerrainTileCache()
+{
+    {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stop = true;
+    this->Requests.clear();
+    }
+  this->Pool.waitForDone();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::Reset()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->Requests.clear();
+  this->RequestsDone.wait(lock, [this]{ return this->IsIdle(); });
+
+  this->Tiles.clear();
+  this->Usage.clear();
+  this->Pinned.clear();
+  this->CachedBytes = 0;
+  this->TilesArrived = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::SetMemoryBudget(vtkTypeInt64 bytes)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->MemoryBudget = std::max(bytes, vtkTypeInt64(0));
+  this->EnforceBudget();
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetMemoryBudget() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->MemoryBudget;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::SetPinnedTiles(const std::set<TileKey>& keys)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Pinned = keys;
+  this->EnforceBudget();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainTileCache::Touch(const TileKey& key)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  TileMap::iterator iter = this->Tiles.find(key);
+  if (iter == this->Tiles.end())
+    {
+    return false;
+    }
+
+  this->Usage.splice(this->Usage.begin(), this->Usage, iter->second.UsageIter);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainTileCache::IsCachedOrLoading(const TileKey& key) const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Tiles.count(key) || this->Loading.count(key);
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vtkVgTerrainTileCache::FindCovering(
+  const TileKey& key, int levels, int& shift)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  for (shift = 0; key.Level + shift < levels; ++shift)
+    {
+    const TileKey coverKey(key.Image, key.Level + shift,
+                           key.X >> shift, key.Y >> shift);
+    TileMap::iterator iter = this->Tiles.find(coverKey);
+    if (iter != this->Tiles.end())
+      {
+      this->Usage.splice(this->Usage.begin(), this->Usage,
+                         iter->second.UsageIter);
+      return iter->second.Tile;
+      }
+    }
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::Queue(const std::vector<LoadRequest>& requests)
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Requests.assign(requests.begin(), requests.end());
+  this->StartWorkers();
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::Wait()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  this->RequestsDone.wait(lock, [this]{ return this->IsIdle(); });
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainTileCache::TakeArrivals()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  const bool arrived = this->TilesArrived;
+  this->TilesArrived = false;
+  return arrived;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetEvictionCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Evictions;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetPrefetchedCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->Prefetched;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetPendingTileCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return static_cast<vtkTypeInt64>(this->Requests.size() +
+                                   this->Loading.size());
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetCachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return this->CachedBytes;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::GetCachedTileCount() const
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  return static_cast<vtkTypeInt64>(this->Tiles.size());
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Evictions = this->Prefetched = 0;
+}
+
+//-----------------------------------------------------------------------------
+vtkTypeInt64 vtkVgTerrainTileCache::TileSize(vtkImageData* tile)
+{
+  // GetActualMemorySize reports KiB
+  return 1024 * static_cast<vtkTypeInt64>(tile->GetActualMemorySize());
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::Insert(const TileKey& key, vtkImageData* tile)
+{
+  const vtkTypeInt64 size = TileSize(tile);
+  if ((size > this->MemoryBudget && !this->Pinned.count(key)) ||
+      this->Tiles.count(key))
+    {
+    return;
+    }
+
+  this->Usage.push_front(key);
+
+  CacheEntry& entry = this->Tiles[key];
+  entry.Tile = tile;
+  entry.Size = size;
+  entry.UsageIter = this->Usage.begin();
+
+  this->CachedBytes += size;
+  this->EnforceBudget();
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTerrainTileCache::UsageList::iterator vtkVgTerrainTileCache::Evict(
+  TileMap::iterator iter)
+{
+  const UsageList::iterator next = this->Usage.erase(iter->second.UsageIter);
+  this->CachedBytes -= iter->second.Size;
+  this->Tiles.erase(iter);
+  ++this->Evictions;
+  return next;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::EnforceBudget()
+{
+  // Evict the least recently used tiles which are not pinned
+  UsageList::iterator iter = this->Usage.end();
+  while (this->CachedBytes > this->MemoryBudget &&
+         iter != this->Usage.begin())
+    {
+    --iter;
+    if (!this->Pinned.count(*iter))
+      {
+      iter = this->Evict(this->Tiles.find(*iter));
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::StartWorkers()
+{
+  const int wanted = std::min(this->Pool.maxThreadCount(),
+                              static_cast<int>(this->Requests.size()));
+  while (this->ActiveWorkers < wanted)
+    {
+    ++this->ActiveWorkers;
+    QtConcurrent::run(&this->Pool, [this]{ this->Run(); });
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgTerrainTileCache::IsIdle() const
+{
+  return this->Requests.empty() && this->ActiveWorkers == 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgTerrainTileCache::Run()
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  while (!this->Stop && !this->Requests.empty())
+    {
+    const LoadRequest request = this->Requests.front();
+    this->Requests.pop_front();
+
+    const TileKey& key = request.Key;
+    if (this->Tiles.count(key) || this->Loading.count(key))
+      {
+      continue;
+      }
+
+    // Release the cache while reading, so that other threads can still be
+    // served from it
+    this->Loading.insert(key);
+    lock.unlock();
+
+    vtkSmartPointer<vtkImageData> tile = this->Read(key);
+
+    lock.lock();
+    this->Loading.erase(key);
+    if (tile && !this->Stop)
+      {
+      this->Insert(key, tile);
+      this->TilesArrived = true;
+      if (request.IsPrefetch)
+        {
+        ++this->Prefetched;
+        }
+      if (this->Notify)
+        {
+        this->Notify();
+        }
+      }
+    }
+
+  --this->ActiveWorkers;
+  this->RequestsDone.notify_all();
+}
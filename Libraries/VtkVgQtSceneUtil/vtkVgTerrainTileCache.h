@@ -0,0 +1,181 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vtkVgTerrainTileCache_h
+#define __vtkVgTerrainTileCache_h
+
+#include <vgExport.h>
+
+#include <vtkImageData.h>
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+
+#include <QThreadPool>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// Cache of imagery tiles used by vtkVgTerrainSource, shared by all images and
+// levels and bounded by a memory budget. Tiles are evicted least recently
+// used first, except for pinned tiles (normally those of the current view),
+// which are kept even if this exceeds the budget.
+//
+// Missing tiles are queued for loading by worker threads, which call the read
+// function given at construction without holding any lock, and then call the
+// notify function each time a tile has been added.
+class VTKVGQT_SCENEUTIL_EXPORT vtkVgTerrainTileCache
+{
+public:
+  struct TileKey
+    {
+    TileKey(int image, int level, int x, int y) :
+      Image(image), Level(level), X(x), Y(y) {}
+
+    bool operator<(const TileKey& other) const
+      {
+      if (this->Image != other.Image)
+        return this->Image < other.Image;
+      if (this->Level != other.Level)
+        return this->Level < other.Level;
+      if (this->Y != other.Y)
+        return this->Y < other.Y;
+      return this->X < other.X;
+      }
+
+    int Image;
+    int Level;
+    int X;
+    int Y;
+    };
+
+  struct LoadRequest
+    {
+    LoadRequest(const TileKey& key, bool isPrefetch) :
+      Key(key), IsPrefetch(isPrefetch) {}
+
+    TileKey Key;
+    bool IsPrefetch;
+    };
+
+  typedef std::function<vtkSmartPointer<vtkImageData>(const TileKey&)>
+    ReadFunction;
+  typedef std::function<void()> NotifyFunction;
+
+  // Create a cache which loads tiles using \p read on up to \p threads
+  // worker threads, and calls \p notify (which may be empty) from a worker
+  // thread after each tile is added.
+  vtkVgTerrainTileCache(const ReadFunction& read,
+                        const NotifyFunction& notify, int threads);
+
+  // Destroying the cache abandons queued tiles and waits for those being
+  // read.
+  ~vtkVgTerrainTileCache();
+
+  // Abandon queued tiles, wait for those being read, then empty the cache.
+  void Reset();
+
+  // Set/get the maximum number of bytes used by cached tiles. Reducing the
+  // budget evicts tiles as needed. Pinned tiles are kept even when they
+  // alone exceed the budget.
+  void SetMemoryBudget(vtkTypeInt64 bytes);
+  vtkTypeInt64 GetMemoryBudget() const;
+
+  // Set the tiles which must not be evicted. Tiles which are no longer
+  // pinned are evicted as needed to return within the budget.
+  void SetPinnedTiles(const std::set<TileKey>& keys);
+
+  // Mark the tile \p key as used, if it is cached. Returns true if the tile
+  // is cached.
+  bool Touch(const TileKey& key);
+
+  // Return true if the tile \p key is cached or is being read.
+  bool IsCachedOrLoading(const TileKey& key) const;
+
+  // Find the cached tile of the finest level, between the level of \p key
+  // and \p levels - 1, which covers the tile \p key, and mark it as used.
+  // Since tiles are the same size at every level, tile (x, y) is covered by
+  // tile (x >> n, y >> n) at n levels up; \p shift is set to n. Returns
+  // NULL if no covering tile is cached.
+  vtkSmartPointer<vtkImageData> FindCovering(const TileKey& key, int levels,
+                                             int& shift);
+
+  // Replace any queued tiles with \p requests, and start reading them.
+  void Queue(const std::vector<LoadRequest>& requests);
+
+  // Block until all queued tiles have been read.
+  void Wait();
+
+  // Return true if tiles have been added since the last call.
+  bool TakeArrivals();
+
+  // Get statistics; tile counts are cumulative since construction, or since
+  // the last call to ResetStatistics.
+  vtkTypeInt64 GetEvictionCount() const;
+  vtkTypeInt64 GetPrefetchedCount() const;
+  vtkTypeInt64 GetPendingTileCount() const;
+  vtkTypeInt64 GetCachedBytes() const;
+  vtkTypeInt64 GetCachedTileCount() const;
+  void ResetStatistics();
+
+  // Get the number of bytes that \p tile counts against the budget.
+  static vtkTypeInt64 TileSize(vtkImageData* tile);
+
+protected:
+  typedef std::list<TileKey> UsageList;
+
+  struct CacheEntry
+    {
+    vtkSmartPointer<vtkImageData> Tile;
+    vtkTypeInt64 Size;
+    UsageList::iterator UsageIter;
+    };
+
+  typedef std::map<TileKey, CacheEntry> TileMap;
+
+  // The following require Mutex to be held
+  void Insert(const TileKey& key, vtkImageData* tile);
+  UsageList::iterator Evict(TileMap::iterator iter);
+  void EnforceBudget();
+  void StartWorkers();
+  bool IsIdle() const;
+
+  // Worker threads
+  void Run();
+
+  const ReadFunction Read;
+  const NotifyFunction Notify;
+
+  TileMap Tiles;
+  UsageList Usage; // front is most recently used
+  std::set<TileKey> Pinned;
+  vtkTypeInt64 MemoryBudget;
+  vtkTypeInt64 CachedBytes;
+
+  std::deque<LoadRequest> Requests;
+  std::set<TileKey> Loading;
+  int ActiveWorkers;
+  bool TilesArrived;
+  bool Stop;
+
+  vtkTypeInt64 Evictions;
+  vtkTypeInt64 Prefetched;
+
+  // Protects all of the above
+  mutable std::mutex Mutex;
+  std::condition_variable RequestsDone;
+
+  QThreadPool Pool;
+
+private:
+  vtkVgTerrainTileCache(const vtkVgTerrainTileCache&);
+  void operator=(const vtkVgTerrainTileCache&);
+};
+
+#endif
@@ -4,6 +4,8 @@
 
 #include "vtkVgAreaPicker.h"
 
+#include "vtkVgNodeIndex.h"
+
 // VTK includes.
 #include "vtkAreaPicker.h"
 #include "vtkObjectFactory.h"
@@ -27,9 +29,40 @@
 #include "vtkPlane.h"
 #include "vtkPoints.h"
 #include "vtkExtractSelectedFrustum.h"
+#include "vtkNew.h"
+
+// STL includes.
+#include <algorithm>
 
 vtkStandardNewMacro(vtkVgAreaPicker);
 
+//-----------------------------------------------------------------------------
+vtkVgAreaPicker::vtkVgAreaPicker() : vtkAreaPicker()
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkVgAreaPicker::~vtkVgAreaPicker()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgAreaPicker::SetNodeIndex(vtkVgNodeIndex* nodeIndex)
+{
+  if (this->NodeIndex != nodeIndex)
+    {
+    this->NodeIndex = nodeIndex;
+    this->Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeIndex* vtkVgAreaPicker::GetNodeIndex()
+{
+  return this->NodeIndex;
+}
+
+//-----------------------------------------------------------------------------
 int vtkVgAreaPicker::PickProps(vtkRenderer* renderer)
 {
   vtkProp* prop;
@@ -53,10 +86,24 @@ int vtkVgAreaPicker::PickProps(vtkRenderer* renderer)
   //
   vtkPropCollection* props;
   vtkProp* propCandidate;
+  vtkNew<vtkPropCollection> indexedProps;
   if (this->PickFromList)
     {
     props = this->GetPickList();
     }
+  else if (this->NodeIndex)
+    {
+    // Only consider props of nodes whose bounds intersect the frustum.
+    this->NodeIndex->FindProps(
+      [this](const double nodeBounds[6])
+        {
+        double b[6], dist;
+        std::copy(nodeBounds, nodeBounds + 6, b);
+        return this->ABoxFrustumIsect(b, dist) != 0;
+        },
+      indexedProps.GetPointer());
+    props = indexedProps.GetPointer();
+    }
   else
     {
     props = renderer->GetViewProps();
@@ -6,9 +6,12 @@
 #define __vtkVgAreaPicker_h
 
 #include <vtkAreaPicker.h>
+#include <vtkSmartPointer.h>
 
 #include <vgExport.h>
 
+class vtkVgNodeIndex;
+
 class VTKVG_SCENEGRAPH_EXPORT vtkVgAreaPicker : public vtkAreaPicker
 {
 public:
@@ -18,9 +21,19 @@ public:
 
   virtual int PickProps(vtkRenderer* renderer);
 
+  // Description:
+  // Set/Get the node index used to find candidate props. If set, and not
+  // picking from the pick list, only the props of nodes whose bounds
+  // intersect the pick frustum are tested, rather than all of the renderer's
+  // props.
+  void SetNodeIndex(vtkVgNodeIndex* nodeIndex);
+  vtkVgNodeIndex* GetNodeIndex();
+
 protected:
-  vtkVgAreaPicker() : vtkAreaPicker() {;}
-  virtual ~vtkVgAreaPicker() {;}
+  vtkVgAreaPicker();
+  virtual ~vtkVgAreaPicker();
+
+  vtkSmartPointer<vtkVgNodeIndex> NodeIndex;
 
 private:
   vtkVgAreaPicker(const vtkVgAreaPicker&);
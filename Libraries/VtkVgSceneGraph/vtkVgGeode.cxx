@@ -75,6 +75,7 @@ void vtkVgGeode::AddDrawable(vtkProp* prop)
     this->NewDrawables->AddItem(prop);
 
     this->BoundsDirtyOn();
+    this->RequestUpdate();
     }
 }
 
@@ -87,6 +88,7 @@ void vtkVgGeode::RemoveDrawable(vtkProp* prop)
     this->ExpiredDrawables->AddItem(prop);
 
     this->BoundsDirtyOn();
+    this->RequestUpdate();
     }
 }
 
@@ -201,6 +203,32 @@ void vtkVgGeode::UpdateRenderObjects(vtkVgPropCollection* propCollection)
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgGeode::Cull(vtkVgNodeVisitorBase& nodeVisitor)
+{
+  vtkVgPropCollection* propCollection = nodeVisitor.GetPropCollection();
+  if (!propCollection)
+    {
+    return;
+    }
+
+  // Pass on pending changes, then withdraw the active drawables as when the
+  // node is removed; they are added back by the next update.
+  propCollection->AddNew(this->NewDrawables);
+  propCollection->AddExpired(this->ExpiredDrawables);
+  this->NewDrawables->RemoveAllItems();
+  this->ExpiredDrawables->RemoveAllItems();
+
+  propCollection->AddExpired(this->ActiveDrawables);
+
+  this->ActiveDrawables->InitTraversal();
+  int numberOfItems = this->ActiveDrawables->GetNumberOfItems();
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    this->NewDrawables->AddItem(this->ActiveDrawables->GetNextProp());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgGeode::Accept(vtkVgNodeVisitorBase& nodeVisitor)
 {
@@ -233,3 +261,11 @@ void vtkVgGeode::ComputeBounds()
     this->BoundsDirtyOff();
     }
 }
+
+//-----------------------------------------------------------------------------
+bool vtkVgGeode::IsTimeDependent()
+{
+  // Drawables are only changed through this node's API, which requests an
+  // update as needed.
+  return false;
+}
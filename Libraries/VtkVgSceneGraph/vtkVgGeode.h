@@ -72,10 +72,14 @@ public:
 
   virtual void ComputeBounds();
 
+  virtual bool IsTimeDependent();
+
 protected:
   vtkVgGeode();
   virtual  ~vtkVgGeode();
 
+  virtual void Cull(vtkVgNodeVisitorBase& nodeVisitor);
+
   vtkSmartPointer<vtkPropCollection> ActiveDrawables;
   vtkSmartPointer<vtkPropCollection> NewDrawables;
   vtkSmartPointer<vtkPropCollection> ExpiredDrawables;
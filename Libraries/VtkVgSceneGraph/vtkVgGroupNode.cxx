@@ -84,6 +84,7 @@ int vtkVgGroupNode::RemoveChild(vtkVgNodeBase* child)
     this->Children->RemoveItem(child);
 
     this->BoundsDirtyOn();
+    this->RequestRemovalUpdate();
 
     return VTK_OK;
     }
@@ -109,11 +110,16 @@ std::vector<vtkVgNodeBase::SmartPtr> vtkVgGroupNode::GetChildren()
   int numberOfChildren = this->GetNumberOfChildren();
   if (numberOfChildren)
     {
+    children.reserve(numberOfChildren);
+
+    // Walk the collection rather than using GetChild(), which is linear in
+    // the index of the child
     this->Children->InitTraversal();
 
     for (int i = 0; i < numberOfChildren; ++i)
       {
-      children.push_back(this->GetChild(i));
+      children.push_back(static_cast<vtkVgNodeBase*>(
+                           this->Children->GetNextItemAsObject()));
       }
     }
 
@@ -231,6 +237,17 @@ void vtkVgGroupNode::ComputeBounds()
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgGroupNode::Cull(vtkVgNodeVisitorBase& nodeVisitor)
+{
+  this->Children->InitTraversal();
+  while (vtkVgNodeBase* node =
+           static_cast<vtkVgNodeBase*>(this->Children->GetNextItemAsObject()))
+    {
+    node->SetCulled(true, nodeVisitor);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgGroupNode::TraverseChildren(vtkVgNodeVisitorBase& nodeVisitor)
 {
@@ -240,14 +257,37 @@ void vtkVgGroupNode::TraverseChildren(vtkVgNodeVisitorBase& nodeVisitor)
     {
     this->Children->InitTraversal();
 
+    // If this node is dirty, all of its children need to be updated;
+    // otherwise, the visitor may skip children which have not changed or
+    // which are out of view.
+    const bool visitAll = (this->Dirty != 0);
+    bool childPending = false;
+
     vtkVgNodeBase* node =
       static_cast<vtkVgNodeBase*>(this->Children->GetNextItemAsObject());
     while (node)
       {
-      node->Accept(nodeVisitor);
+      if (visitAll || nodeVisitor.ShouldUpdate(*node))
+        {
+        node->SetCulled(false, nodeVisitor);
+        node->Accept(nodeVisitor);
+        }
+      else
+        {
+        node->SetCulled(nodeVisitor.IsCulled(*node), nodeVisitor);
+        }
+
+      childPending = childPending || node->GetUpdatePending();
 
       node = static_cast<vtkVgNodeBase*>(this->Children->GetNextItemAsObject());
       }
+
+    // Children which were skipped while they had a pending request must be
+    // considered again by the next update traversal.
+    if (childPending && !this->UpdatePending)
+      {
+      this->RequestUpdate();
+      }
     }
 
   // Now remove the nodes.
@@ -278,7 +318,7 @@ void vtkVgGroupNode::SetRemoveNode(int flag)
 {
   if (this->RemoveNode != flag)
     {
-    this->RemoveNode = flag;
+    this->Superclass::SetRemoveNode(flag);
 
     int numberOfItems = this->Children->GetNumberOfItems();
     if (numberOfItems)
@@ -74,6 +74,10 @@ protected:
 
   void TraverseChildren(vtkVgNodeVisitorBase& nodeVisitor);
 
+  // Description:
+  // Cull all children of this node.
+  virtual void Cull(vtkVgNodeVisitorBase& nodeVisitor);
+
   vtkSmartPointer<vtkCollection> Children;
   vtkSmartPointer<vtkCollection> RemoveChildren;
 
@@ -29,6 +29,16 @@ void vtkVgLeafNodeBase::PrepareForAddition(
   representation->ResetTemporaryRenderObjects();
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgLeafNodeBase::PrepareForCulling(
+  vtkVgPropCollection* propCollection, vtkVgRepresentationBase* representation)
+{
+  // Pass on any pending changes first, so that render objects which expired
+  // since the last update are not left behind in the scene.
+  this->PrepareForAddition(propCollection, representation);
+  this->PrepareForRemoval(propCollection, representation);
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgLeafNodeBase::PrepareForRemoval(
   vtkVgPropCollection* propCollection, vtkVgRepresentationBase* representation)
@@ -37,6 +37,11 @@ public:
   virtual void UpdateRenderObjects(
     vtkVgPropCollection* vtkNotUsed(propCollection)) {;}
 
+  // Description:
+  // Leaf nodes are assumed to depend on the time stamp unless they know
+  // otherwise.
+  virtual bool IsTimeDependent() {return true;}
+
 protected:
   vtkVgLeafNodeBase() {;}
   virtual ~vtkVgLeafNodeBase() {;}
@@ -46,6 +51,13 @@ protected:
   void     PrepareForRemoval(vtkVgPropCollection* propCollection,
                              vtkVgRepresentationBase* representation);
 
+  // Description:
+  // Withdraw the render objects of \param representation from
+  // \param propCollection when the node is culled. Like PrepareForRemoval,
+  // this leaves them to be added back by the next PrepareForAddition.
+  void     PrepareForCulling(vtkVgPropCollection* propCollection,
+                             vtkVgRepresentationBase* representation);
+
 private:
   vtkVgLeafNodeBase(const vtkVgLeafNodeBase&);
   void operator= (const vtkVgLeafNodeBase&);
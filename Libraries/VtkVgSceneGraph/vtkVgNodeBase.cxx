@@ -20,6 +20,9 @@ vtkVgNodeBase::vtkVgNodeBase() : vtkObject(),
   BoundsDirty(1),
   Visible(1),
   RemoveNode(0),
+  UpdatePending(true),
+  RemovalPending(false),
+  Culled(false),
   FinalMatrix(NULL),
   Parent(NULL),
   NodeReferenceFrame
@@ -63,18 +66,66 @@ int vtkVgNodeBase::SetVisible(int flag)
       (this->GetVisibleNodeMask() & VISIBLE_NODE_MASK))
     {
     this->Visible = flag;
+    this->RequestUpdate();
     return 1;
     }
 
   return 0;
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgNodeBase::SetCulled(bool culled, vtkVgNodeVisitorBase& nodeVisitor)
+{
+  // Only update traversals manage render objects.
+  if (this->Culled != culled &&
+      nodeVisitor.GetVisitorType() == vtkVgNodeVisitorBase::UPDATE_VISITOR)
+    {
+    this->Culled = culled;
+    if (culled)
+      {
+      this->Cull(nodeVisitor);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeBase::SetDirty(int flag)
+{
+  if (this->Dirty != flag)
+    {
+    this->Dirty = flag;
+    if (flag)
+      {
+      this->RequestUpdate();
+      }
+    this->Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeBase::SetRemoveNode(int flag)
+{
+  if (this->RemoveNode != flag)
+    {
+    this->RemoveNode = flag;
+    if (flag)
+      {
+      this->RequestRemovalUpdate();
+      }
+    this->Modified();
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgNodeBase::SetBoundsDirty(int flag)
 {
   if (this->BoundsDirty != flag)
     {
     this->BoundsDirty = flag;
+    if (flag)
+      {
+      this->RequestUpdate();
+      }
     if (this->Parent && flag)
       {
       this->Parent->BoundsDirtyOn();
@@ -116,6 +167,16 @@ void vtkVgNodeBase::SetParent(vtkVgGroupNode* parent)
     {
     this->Parent = parent;
     this->DirtyOn();
+
+    // Make sure the new ancestors know about any pending requests.
+    if (this->RemovalPending)
+      {
+      this->RequestRemovalUpdate();
+      }
+    else
+      {
+      this->RequestUpdate();
+      }
     }
 }
 
@@ -158,12 +219,51 @@ void vtkVgNodeBase::Update(vtkVgNodeVisitorBase& vtkNotUsed(nodeVisitor))
   // Do nothing.
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgNodeBase::RequestUpdate()
+{
+  this->UpdatePending = true;
+
+  // Ancestors of a node with a pending request always have one too, so stop
+  // at the first one that does.
+  for (vtkVgNodeBase* node = this->Parent;
+       node && !node->UpdatePending; node = node->Parent)
+    {
+    node->UpdatePending = true;
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeBase::RequestRemovalUpdate()
+{
+  this->UpdatePending = true;
+  this->RemovalPending = true;
+
+  for (vtkVgNodeBase* node = this->Parent;
+       node && !(node->UpdatePending && node->RemovalPending);
+       node = node->Parent)
+    {
+    node->UpdatePending = true;
+    node->RemovalPending = true;
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgNodeBase::Traverse(vtkVgNodeVisitorBase&  nodeVisitor)
 {
   if (nodeVisitor.GetVisitorType() == vtkVgNodeVisitorBase::UPDATE_VISITOR)
     {
+    // Clear the request first, so that changes made while this node (or its
+    // children) are being updated request another update.
+    this->UpdatePending = false;
+    this->RemovalPending = false;
+
     this->Update(nodeVisitor);
+
+    if (this->IsTimeDependent())
+      {
+      this->RequestUpdate();
+      }
     }
 
   // \NOTE: Don't call DirtyOff here. As that is the responsibility of the derived class.
@@ -59,7 +59,7 @@ public:
 
   // Description:
   // Flag that indicates is state of this node is dirty.
-  vtkSetMacro(Dirty, int);
+  virtual void SetDirty(int flag);
   vtkGetMacro(Dirty, int);
   vtkBooleanMacro(Dirty, int);
 
@@ -91,7 +91,7 @@ public:
 
   // Description:
   // Set/Get state if this node is set to be removed from its parent.
-  vtkSetMacro(RemoveNode, int);
+  virtual void SetRemoveNode(int flag);
   vtkGetMacro(RemoveNode, int);
   vtkBooleanMacro(RemoveNode, int);
 
@@ -123,6 +123,39 @@ public:
   // Computer bounds of this node.
   virtual void ComputeBounds() {;}
 
+  // Description:
+  // Request that this node be visited by the next update traversal. Changes
+  // made through the node API request this as needed; call this only when
+  // something the node depends on has changed behind its back.
+  void RequestUpdate();
+
+  // Description:
+  // Get if this node, or any of its descendants, has requested an update
+  // since it was last visited by an update traversal.
+  bool GetUpdatePending() const { return this->UpdatePending; }
+
+  // Description:
+  // Get if any of the descendants of this node has been removed from its
+  // parent since this node was last visited by an update traversal.
+  bool GetRemovalPending() const { return this->RemovalPending; }
+
+  // Description:
+  // Return true if this node must be updated by every update traversal
+  // (e.g. because its content depends on the time stamp), whether or not it
+  // has requested an update.
+  virtual bool IsTimeDependent() { return false; }
+
+  // Description:
+  // Get if this node was culled by the last update traversal which reached
+  // it (see vtkVgNodeVisitorBase::SetCullBounds). Culled nodes withdraw
+  // their render objects until they are visited again.
+  bool GetCulled() const { return this->Culled; }
+
+  // Description:
+  // Set if this node is culled by the update traversal \param nodeVisitor,
+  // whose prop collection receives the withdrawn render objects.
+  void SetCulled(bool culled, vtkVgNodeVisitorBase& nodeVisitor);
+
   static const NodeMaskType     VISIBLE_NODE_MASK    = 0xffffffff;
 
   // Not used right now.
@@ -135,6 +168,17 @@ protected:
   vtkVgNodeBase();
   virtual ~vtkVgNodeBase();
 
+  // Description:
+  // Request an update of this node, noting that one of its descendants has
+  // been removed (see GetRemovalPending).
+  void RequestRemovalUpdate();
+
+  // Description:
+  // Called when this node has been culled, to withdraw its render objects
+  // from the prop collection of \param nodeVisitor. Render objects must be
+  // restored by the next update of the node.
+  virtual void Cull(vtkVgNodeVisitorBase& vtkNotUsed(nodeVisitor)) {;}
+
   // Description:
   char*                         Name;
 
@@ -153,6 +197,13 @@ protected:
 
   int                           RemoveNode;
 
+  // Description:
+  // Update requests of this node and its descendants (see RequestUpdate).
+  bool                          UpdatePending;
+  bool                          RemovalPending;
+
+  bool                          Culled;
+
   // Description:
   // Complete matrix transform for this node. If the parent is dirty
   // this needs to be recalculated.
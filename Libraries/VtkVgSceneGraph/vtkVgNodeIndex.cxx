@@ -0,0 +1,571 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vtkVgNodeIndex.h"
+
+#include "vtkVgNodeBase.h"
+
+// VTK includes.
+#include <vtkMath.h>
+#include <vtkObjectFactory.h>
+#include <vtkProp.h>
+#include <vtkPropCollection.h>
+#include <vtkWeakPointer.h>
+
+// STL includes.
+#include <algorithm>
+#include <unordered_map>
+
+vtkStandardNewMacro(vtkVgNodeIndex);
+
+namespace // anonymous
+{
+
+// Maximum number of nodes in a leaf of the hierarchy
+const int LeafSize = 4;
+
+//-----------------------------------------------------------------------------
+void InitializeBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+//-----------------------------------------------------------------------------
+void AddBounds(double bounds[6], const double other[6])
+{
+  for (int i = 0; i < 6; i += 2)
+    {
+    bounds[i] = std::min(bounds[i], other[i]);
+    bounds[i + 1] = std::max(bounds[i + 1], other[i + 1]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool BoundsOverlap(const double a[6], const double b[6])
+{
+  return (a[0] <= b[1] && b[0] <= a[1] &&
+          a[2] <= b[3] && b[2] <= a[3] &&
+          a[4] <= b[5] && b[4] <= a[5]);
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+class vtkVgNodeIndex::vtkInternal
+{
+public:
+  struct Entry
+    {
+    vtkVgNodeBase* Key;
+    vtkWeakPointer<vtkVgNodeBase> Node;
+    double Bounds[6];
+    bool Bounded;
+
+    vtkPropCollection* Collection;
+    vtkMTimeType CollectionTime;
+    std::vector<vtkSmartPointer<vtkProp> > Props;
+    };
+
+  // Node of the bounding volume hierarchy; the hierarchy is stored in
+  // pre-order, so the left child of an interior node immediately follows it,
+  // and both children follow their parent
+  struct TreeNode
+    {
+    double Bounds[6];
+    int Right; // Index of right child (interior nodes only)
+    int First; // Index of first entry in Order (leaves only)
+    int Count; // Number of entries; zero for interior nodes
+    };
+
+  vtkInternal() : StructureDirty(false), BoundsDirty(false), MovedCount(0) {}
+
+  void SetProps(size_t index, vtkPropCollection* props);
+  bool ComputePropBounds(const Entry& entry, double bounds[6]) const;
+  void RemoveEntry(size_t index);
+
+  void EnsureTree();
+  int Build(int first, int count);
+  void Refit();
+
+  template <typename Func>
+  void Query(const BoundsTest& test, const Func& func);
+
+  std::vector<Entry> Entries;
+  std::unordered_map<vtkVgNodeBase*, size_t> NodeMap;
+  std::unordered_map<vtkProp*, size_t> PropMap;
+
+  std::vector<TreeNode> Tree;
+  std::vector<int> Order;
+  std::vector<int> Stack;
+
+  bool StructureDirty;
+  bool BoundsDirty;
+  size_t MovedCount;
+};
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::vtkInternal::SetProps(
+  size_t index, vtkPropCollection* props)
+{
+  Entry& entry = this->Entries[index];
+
+  for (size_t i = 0; i < entry.Props.size(); ++i)
+    {
+    const auto iter = this->PropMap.find(entry.Props[i]);
+    if (iter != this->PropMap.end() && iter->second == index)
+      {
+      this->PropMap.erase(iter);
+      }
+    }
+  entry.Props.clear();
+
+  entry.Collection = props;
+  entry.CollectionTime = (props ? props->GetMTime() : 0);
+  if (!props)
+    {
+    return;
+    }
+
+  vtkCollectionSimpleIterator iter;
+  props->InitTraversal(iter);
+  while (vtkProp* prop = props->GetNextProp(iter))
+    {
+    entry.Props.push_back(prop);
+    this->PropMap[prop] = index;
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgNodeIndex::vtkInternal::ComputePropBounds(
+  const Entry& entry, double bounds[6]) const
+{
+  // Unlike the node's own bounds, these include props which are not visible,
+  // so that a node which is made visible again (which does not necessarily
+  // dirty its bounds) is still found
+  InitializeBounds(bounds);
+
+  bool bounded = false;
+  for (size_t i = 0; i < entry.Props.size(); ++i)
+    {
+    double* const propBounds = entry.Props[i]->GetBounds();
+    if (propBounds && vtkMath::AreBoundsInitialized(propBounds))
+      {
+      AddBounds(bounds, propBounds);
+      bounded = true;
+      }
+    }
+
+  return bounded;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::vtkInternal::RemoveEntry(size_t index)
+{
+  this->SetProps(index, 0);
+  this->NodeMap.erase(this->Entries[index].Key);
+
+  // Move the last entry into the vacated slot
+  const size_t last = this->Entries.size() - 1;
+  if (index != last)
+    {
+    Entry& entry = this->Entries[index];
+    entry = this->Entries[last];
+
+    this->NodeMap[entry.Key] = index;
+    for (size_t i = 0; i < entry.Props.size(); ++i)
+      {
+      this->PropMap[entry.Props[i]] = index;
+      }
+    }
+
+  this->Entries.pop_back();
+  this->StructureDirty = true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::vtkInternal::EnsureTree()
+{
+  // Refitting is cheaper than rebuilding, but the quality of the hierarchy
+  // degrades as nodes move, so rebuild if a sizable fraction of the nodes
+  // have moved since the last build
+  if (!this->StructureDirty && 4 * this->MovedCount > this->Order.size())
+    {
+    this->StructureDirty = true;
+    }
+
+  if (this->StructureDirty)
+    {
+    // Drop entries for nodes which were destroyed without being removed
+    for (size_t i = this->Entries.size(); i > 0; --i)
+      {
+      if (!this->Entries[i - 1].Node)
+        {
+        this->RemoveEntry(i - 1);
+        }
+      }
+
+    this->Order.clear();
+    for (size_t i = 0; i < this->Entries.size(); ++i)
+      {
+      if (this->Entries[i].Bounded)
+        {
+        this->Order.push_back(static_cast<int>(i));
+        }
+      }
+
+    this->Tree.clear();
+    this->Tree.reserve(2 * (this->Order.size() / LeafSize) + 1);
+    if (!this->Order.empty())
+      {
+      this->Build(0, static_cast<int>(this->Order.size()));
+      }
+
+    this->StructureDirty = false;
+    this->BoundsDirty = false;
+    this->MovedCount = 0;
+    }
+  else if (this->BoundsDirty)
+    {
+    this->Refit();
+    this->BoundsDirty = false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgNodeIndex::vtkInternal::Build(int first, int count)
+{
+  const int index = static_cast<int>(this->Tree.size());
+  this->Tree.push_back(TreeNode());
+
+  double bounds[6], centers[6];
+  InitializeBounds(bounds);
+  InitializeBounds(centers);
+  for (int k = first; k < first + count; ++k)
+    {
+    const double* const b = this->Entries[this->Order[k]].Bounds;
+    const double center[6] =
+      {
+      b[0] + b[1], b[0] + b[1],
+      b[2] + b[3], b[2] + b[3],
+      b[4] + b[5], b[4] + b[5]
+      };
+    AddBounds(bounds, b);
+    AddBounds(centers, center);
+    }
+
+  std::copy(bounds, bounds + 6, this->Tree[index].Bounds);
+
+  if (count <= LeafSize)
+    {
+    this->Tree[index].Right = -1;
+    this->Tree[index].First = first;
+    this->Tree[index].Count = count;
+    return index;
+    }
+
+  // Split at the median center along the axis of greatest spread
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+    {
+    if (centers[2 * i + 1] - centers[2 * i] >
+        centers[2 * axis + 1] - centers[2 * axis])
+      {
+      axis = i;
+      }
+    }
+
+  const std::vector<Entry>& entries = this->Entries;
+  const int half = count / 2;
+  std::nth_element(
+    this->Order.begin() + first, this->Order.begin() + first + half,
+    this->Order.begin() + first + count,
+    [&entries, axis](int a, int b){
+      const double* const ba = entries[a].Bounds;
+      const double* const bb = entries[b].Bounds;
+      return (ba[2 * axis] + ba[2 * axis + 1] <
+              bb[2 * axis] + bb[2 * axis + 1]);
+      });
+
+  this->Build(first, half);
+  const int right = this->Build(first + half, count - half);
+
+  this->Tree[index].Right = right;
+  this->Tree[index].First = -1;
+  this->Tree[index].Count = 0;
+  return index;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::vtkInternal::Refit()
+{
+  // Children always follow their parent, so visiting nodes in reverse order
+  // updates every child before its parent
+  for (size_t i = this->Tree.size(); i > 0; --i)
+    {
+    TreeNode& node = this->Tree[i - 1];
+    InitializeBounds(node.Bounds);
+    if (node.Count)
+      {
+      for (int k = node.First; k < node.First + node.Count; ++k)
+        {
+        AddBounds(node.Bounds, this->Entries[this->Order[k]].Bounds);
+        }
+      }
+    else
+      {
+      AddBounds(node.Bounds, this->Tree[i].Bounds);
+      AddBounds(node.Bounds, this->Tree[node.Right].Bounds);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+template <typename Func>
+void vtkVgNodeIndex::vtkInternal::Query(
+  const BoundsTest& test, const Func& func)
+{
+  this->EnsureTree();
+  if (this->Tree.empty())
+    {
+    return;
+    }
+
+  this->Stack.clear();
+  this->Stack.push_back(0);
+  while (!this->Stack.empty())
+    {
+    const int index = this->Stack.back();
+    this->Stack.pop_back();
+
+    const TreeNode& node = this->Tree[index];
+    if (!test(node.Bounds))
+      {
+      continue;
+      }
+
+    if (node.Count)
+      {
+      for (int k = node.First; k < node.First + node.Count; ++k)
+        {
+        const Entry& entry = this->Entries[this->Order[k]];
+        if (entry.Node && (node.Count == 1 || test(entry.Bounds)))
+          {
+          func(entry);
+          }
+        }
+      }
+    else
+      {
+      this->Stack.push_back(node.Right);
+      this->Stack.push_back(index + 1);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeIndex::vtkVgNodeIndex() : Internal(new vtkInternal)
+{
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeIndex::~vtkVgNodeIndex()
+{
+  delete this->Internal;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfNodes: " << this->GetNumberOfNodes() << '\n';
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::UpdateNode(vtkVgNodeBase* node, vtkPropCollection* props)
+{
+  if (!node)
+    {
+    return;
+    }
+
+  vtkInternal* const d = this->Internal;
+
+  size_t index;
+  const auto iter = d->NodeMap.find(node);
+  if (iter == d->NodeMap.end())
+    {
+    index = d->Entries.size();
+    d->Entries.push_back(vtkInternal::Entry());
+    d->NodeMap.emplace(node, index);
+
+    vtkInternal::Entry& entry = d->Entries.back();
+    entry.Key = node;
+    entry.Bounded = false;
+    entry.Collection = 0;
+    entry.CollectionTime = 0;
+    }
+  else
+    {
+    index = iter->second;
+    }
+
+  vtkInternal::Entry& entry = d->Entries[index];
+
+  // Since this may be a different node that happens to have the same address
+  // as one which was destroyed, always (re)set the weak reference
+  entry.Node = node;
+
+  if (entry.Collection != props ||
+      (props && props->GetMTime() != entry.CollectionTime))
+    {
+    d->SetProps(index, props);
+    }
+
+  double bounds[6];
+  node->GetBounds(bounds);
+  const bool bounded = (vtkMath::AreBoundsInitialized(bounds) ||
+                        d->ComputePropBounds(entry, bounds));
+
+  if (bounded != entry.Bounded)
+    {
+    d->StructureDirty = true;
+    }
+  else if (bounded && !std::equal(bounds, bounds + 6, entry.Bounds))
+    {
+    d->BoundsDirty = true;
+    ++d->MovedCount;
+    }
+
+  entry.Bounded = bounded;
+  std::copy(bounds, bounds + 6, entry.Bounds);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::RemoveNode(vtkVgNodeBase* node)
+{
+  const auto iter = this->Internal->NodeMap.find(node);
+  if (iter != this->Internal->NodeMap.end())
+    {
+    this->Internal->RemoveEntry(iter->second);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::Reset()
+{
+  vtkInternal* const d = this->Internal;
+
+  d->Entries.clear();
+  d->NodeMap.clear();
+  d->PropMap.clear();
+  d->Tree.clear();
+  d->Order.clear();
+
+  d->StructureDirty = false;
+  d->BoundsDirty = false;
+  d->MovedCount = 0;
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgNodeIndex::GetNumberOfNodes() const
+{
+  return static_cast<int>(this->Internal->Entries.size());
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeBase* vtkVgNodeIndex::FindNode(vtkProp* prop) const
+{
+  const auto iter = this->Internal->PropMap.find(prop);
+  if (iter == this->Internal->PropMap.end())
+    {
+    return 0;
+    }
+
+  return this->Internal->Entries[iter->second].Node;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::FindNodes(
+  const BoundsTest& test, std::vector<vtkVgNodeBase*>& nodes)
+{
+  this->Internal->Query(test, [&nodes](const vtkInternal::Entry& entry){
+    nodes.push_back(entry.Node);
+    });
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::FindNodes(
+  const double bounds[6], std::vector<vtkVgNodeBase*>& nodes)
+{
+  this->FindNodes([bounds](const double b[6]){
+    return BoundsOverlap(bounds, b);
+    }, nodes);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::FindNodes(
+  const double p1[3], const double p2[3], std::vector<vtkVgNodeBase*>& nodes)
+{
+  this->FindNodes([p1, p2](const double b[6]){
+    return IntersectSegment(b, p1, p2);
+    }, nodes);
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeIndex::FindProps(
+  const BoundsTest& test, vtkPropCollection* props)
+{
+  if (!props)
+    {
+    return;
+    }
+
+  this->Internal->Query(test, [props](const vtkInternal::Entry& entry){
+    for (size_t i = 0; i < entry.Props.size(); ++i)
+      {
+      props->AddItem(entry.Props[i]);
+      }
+    });
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgNodeIndex::IntersectSegment(
+  const double bounds[6], const double p1[3], const double p2[3])
+{
+  // Clip the segment against each pair of bounding planes in turn
+  double t0 = 0.0, t1 = 1.0;
+  for (int i = 0; i < 3; ++i)
+    {
+    const double lower = bounds[2 * i];
+    const double upper = bounds[2 * i + 1];
+    const double delta = p2[i] - p1[i];
+
+    if (delta == 0.0)
+      {
+      if (p1[i] < lower || p1[i] > upper)
+        {
+        return false;
+        }
+      continue;
+      }
+
+    double ta = (lower - p1[i]) / delta;
+    double tb = (upper - p1[i]) / delta;
+    if (ta > tb)
+      {
+      std::swap(ta, tb);
+      }
+
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+    if (t0 > t1)
+      {
+      return false;
+      }
+    }
+
+  return true;
+}
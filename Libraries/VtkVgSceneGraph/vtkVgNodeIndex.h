@@ -0,0 +1,124 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vtkVgNodeIndex_h
+#define __vtkVgNodeIndex_h
+
+// VG includes.
+#include "vtkVgMacros.h"
+
+// VTK includes.
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+
+// STL includes.
+#include <functional>
+#include <vector>
+
+#include <vgExport.h>
+
+// Forward declarations.
+class vtkVgNodeBase;
+
+class vtkProp;
+class vtkPropCollection;
+
+// .NAME vtkVgNodeIndex - spatial index of scene graph leaf nodes
+// .SECTION Description
+// vtkVgNodeIndex maintains a bounding volume hierarchy over the world bounds
+// of the leaf nodes of a scene graph, and a map from each of their render
+// objects to the owning node. It is kept current by an update visitor to
+// which it has been given (see vtkVgNodeVisitorBase::SetNodeIndex), and
+// allows pickers to consider only the nodes near the pick, and to map a
+// picked prop to its node without walking the scene.
+//
+// Structural changes (nodes added or removed) cause the hierarchy to be
+// rebuilt lazily on the next query; when only bounds change, the existing
+// hierarchy is refit instead, unless enough nodes have moved that a rebuild
+// is likely to produce a much better tree.
+//
+// Queries are conservative; a node is returned if its bounds might satisfy
+// the query, and it is up to the caller to perform an exact test on the
+// node's props.
+class VTKVG_SCENEGRAPH_EXPORT vtkVgNodeIndex : public vtkObject
+{
+public:
+  // Description:
+  // Define easy to use types.
+  vtkVgClassMacro(vtkVgNodeIndex);
+
+  // Description:
+  // Function used to test node bounds in generic queries. The function is
+  // given the bounds of a node, or of a group of nodes, and must return
+  // \c true if anything within those bounds could satisfy the query.
+  typedef std::function<bool (const double bounds[6])> BoundsTest;
+
+  // Description:
+  // Usual VTK functions.
+  vtkTypeMacro(vtkVgNodeIndex, vtkObject);
+
+  static vtkVgNodeIndex* New();
+
+  virtual void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Add \p node to the index, or update its entry, using its current bounds
+  // and the props in \p props. If the node's bounds are not initialized
+  // (which happens if none of its props are visible), the bounds of the
+  // props are used instead.
+  void UpdateNode(vtkVgNodeBase* node, vtkPropCollection* props);
+
+  // Description:
+  // Remove \p node from the index.
+  void RemoveNode(vtkVgNodeBase* node);
+
+  // Description:
+  // Remove all nodes from the index.
+  void Reset();
+
+  // Description:
+  // Get the number of nodes in the index.
+  int GetNumberOfNodes() const;
+
+  // Description:
+  // Return the node which owns \p prop, or NULL if \p prop does not belong
+  // to any indexed node.
+  vtkVgNodeBase* FindNode(vtkProp* prop) const;
+
+  // Description:
+  // Find nodes whose bounds pass \p test. Nodes are appended to \p nodes.
+  void FindNodes(const BoundsTest& test, std::vector<vtkVgNodeBase*>& nodes);
+
+  // Description:
+  // Find nodes whose bounds intersect the axis aligned box \p bounds.
+  void FindNodes(const double bounds[6], std::vector<vtkVgNodeBase*>& nodes);
+
+  // Description:
+  // Find nodes whose bounds intersect the line segment from \p p1 to \p p2.
+  void FindNodes(const double p1[3], const double p2[3],
+                 std::vector<vtkVgNodeBase*>& nodes);
+
+  // Description:
+  // Find nodes whose bounds pass \p test, and add their props to \p props.
+  void FindProps(const BoundsTest& test, vtkPropCollection* props);
+
+  // Description:
+  // Test if the bounds \p bounds intersect the line segment from \p p1 to
+  // \p p2.
+  static bool IntersectSegment(const double bounds[6],
+                               const double p1[3], const double p2[3]);
+
+protected:
+  vtkVgNodeIndex();
+  virtual ~vtkVgNodeIndex();
+
+private:
+  vtkVgNodeIndex(const vtkVgNodeIndex&); // Not implemented.
+  void operator=(const vtkVgNodeIndex&); // Not implemented.
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif // __vtkVgNodeIndex_h
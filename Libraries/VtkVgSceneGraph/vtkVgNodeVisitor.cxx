@@ -8,6 +8,7 @@
 #include "vtkVgGroupNode.h"
 #include "vtkVgTransformNode.h"
 #include "vtkVgVideoNode.h"
+#include "vtkVgVideoRepresentationBase0.h"
 #include "vtkVgPropCollection.h"
 
 //-----------------------------------------------------------------------------
@@ -23,7 +24,12 @@ vtkVgNodeVisitor::~vtkVgNodeVisitor()
 //-----------------------------------------------------------------------------
 void vtkVgNodeVisitor::Visit(vtkVgGeode& geode)
 {
+  // Traversal clears the removal flag, so check it first.
+  const bool removed = (geode.GetRemoveNode() != 0);
+
   this->Traverse(geode);
+
+  this->UpdateNodeIndex(geode, removed ? 0 : geode.GetActiveDrawables());
 }
 
 //-----------------------------------------------------------------------------
@@ -41,7 +47,21 @@ void vtkVgNodeVisitor::Visit(vtkVgTransformNode& transformNode)
 //-----------------------------------------------------------------------------
 void vtkVgNodeVisitor::Visit(vtkVgVideoNode& videoNode)
 {
+  // Traversal clears the removal flag, so check it first.
+  const bool removed = (videoNode.GetRemoveNode() != 0);
+
   this->Traverse(videoNode);
+
+  vtkVgVideoRepresentationBase0* const videoRep =
+    videoNode.GetVideoRepresentation();
+  if (removed || !videoRep)
+    {
+    this->UpdateNodeIndex(videoNode, 0);
+    }
+  else
+    {
+    this->UpdateNodeIndex(videoNode, videoRep->GetActiveRenderObjects());
+    }
 }
 
 //-----------------------------------------------------------------------------
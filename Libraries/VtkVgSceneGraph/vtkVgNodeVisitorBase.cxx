@@ -5,15 +5,27 @@
 #include "vtkVgNodeVisitorBase.h"
 
 #include "vtkVgNodeBase.h"
+#include "vtkVgNodeIndex.h"
 #include "vtkVgPropCollection.h"
 
+// VTK includes.
+#include <vtkMath.h>
+
+// STL includes.
+#include <algorithm>
+
 //-----------------------------------------------------------------------------
 vtkVgNodeVisitorBase::vtkVgNodeVisitorBase() :
   NodeVisitorType(NODE_VISITOR),
-  PropCollection(NULL)
+  PropCollection(NULL),
+  NodeIndex(NULL),
+  SkipUnchangedNodes(false),
+  Culling(false)
 {
   this->TimeStamp.SetTime(-1.0);
   this->ModifiedTimeStamp.Modified();
+
+  vtkMath::UninitializeBounds(this->CullBounds);
 }
 
 //-----------------------------------------------------------------------------
@@ -71,6 +83,114 @@ vtkVgPropCollection* vtkVgNodeVisitorBase::GetPropCollection()
   return this->PropCollection;
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgNodeVisitorBase::SetNodeIndex(vtkVgNodeIndex* nodeIndex)
+{
+  if (this->NodeIndex != nodeIndex)
+    {
+    this->NodeIndex = nodeIndex;
+    this->ModifiedTimeStamp.Modified();
+    }
+}
+
+//-----------------------------------------------------------------------------
+const vtkVgNodeIndex* vtkVgNodeVisitorBase::GetNodeIndex() const
+{
+  return this->NodeIndex;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeIndex* vtkVgNodeVisitorBase::GetNodeIndex()
+{
+  return this->NodeIndex;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeVisitorBase::SetCullBounds(const double bounds[6])
+{
+  this->Culling = (bounds != 0);
+  if (bounds)
+    {
+    std::copy(bounds, bounds + 6, this->CullBounds);
+    }
+  this->ModifiedTimeStamp.Modified();
+}
+
+//-----------------------------------------------------------------------------
+const double* vtkVgNodeVisitorBase::GetCullBounds() const
+{
+  return (this->Culling ? this->CullBounds : 0);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgNodeVisitorBase::ShouldUpdate(vtkVgNodeBase& node) const
+{
+  if (this->NodeVisitorType != UPDATE_VISITOR)
+    {
+    return true;
+    }
+
+  // Dirty nodes must pick up changes from their parent, and removed nodes
+  // must give up their props, whether or not they are in view.
+  if (node.GetDirty() || node.GetRemoveNode() || node.GetRemovalPending())
+    {
+    return true;
+    }
+
+  // Nodes coming back into view must restore their render objects.
+  const bool culled = this->IsCulled(node);
+  if (node.GetCulled() && !culled)
+    {
+    return true;
+    }
+
+  if (this->SkipUnchangedNodes && !node.GetUpdatePending())
+    {
+    return false;
+    }
+
+  return !culled;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgNodeVisitorBase::IsCulled(vtkVgNodeBase& node) const
+{
+  // Cull only nodes whose bounds are known to be current.
+  if (this->NodeVisitorType != UPDATE_VISITOR || !this->Culling ||
+      node.GetBoundsDirty())
+    {
+    return false;
+    }
+
+  double* const bounds = node.GetBounds();
+  return (vtkMath::AreBoundsInitialized(bounds) &&
+          (bounds[0] > this->CullBounds[1] ||
+           bounds[1] < this->CullBounds[0] ||
+           bounds[2] > this->CullBounds[3] ||
+           bounds[3] < this->CullBounds[2] ||
+           bounds[4] > this->CullBounds[5] ||
+           bounds[5] < this->CullBounds[4]));
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgNodeVisitorBase::UpdateNodeIndex(vtkVgNodeBase& node,
+                                           vtkPropCollection* props)
+{
+  if (!this->NodeIndex || this->NodeVisitorType != UPDATE_VISITOR)
+    {
+    return;
+    }
+
+  if (props)
+    {
+    this->NodeIndex->UpdateNode(&node, props);
+    }
+  else
+    {
+    this->NodeIndex->RemoveNode(&node);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgNodeVisitorBase::ShallowCopy(vtkVgNodeVisitorBase* other)
 {
@@ -85,4 +205,8 @@ void vtkVgNodeVisitorBase::ShallowCopy(vtkVgNodeVisitorBase* other)
   this->ModifiedTimeStamp.Modified();
 
   this->PropCollection = other->GetPropCollection();
+  this->NodeIndex      = other->GetNodeIndex();
+
+  this->SkipUnchangedNodes = other->SkipUnchangedNodes;
+  this->SetCullBounds(other->GetCullBounds());
 }
@@ -23,8 +23,11 @@ class vtkVgNodeBase;
 class vtkVgTransformNode;
 class vtkVgVideoNode;
 
+class vtkVgNodeIndex;
 class vtkVgPropCollection;
 
+class vtkPropCollection;
+
 class VTKVG_SCENEGRAPH_EXPORT vtkVgNodeVisitorBase
 {
 public:
@@ -73,9 +76,47 @@ public:
   const vtkVgPropCollection* GetPropCollection() const;
   vtkVgPropCollection* GetPropCollection();
 
+  // Description:
+  // Set/Get the spatial index of leaf nodes. If set, an update visitor adds
+  // the leaf nodes it visits to the index, and removes those which have been
+  // removed from the scene.
+  void SetNodeIndex(vtkVgNodeIndex* nodeIndex);
+  const vtkVgNodeIndex* GetNodeIndex() const;
+  vtkVgNodeIndex* GetNodeIndex();
+
+  // Description:
+  // Set/Get if an update visitor skips nodes which have not requested an
+  // update (see vtkVgNodeBase::RequestUpdate). Off by default.
+  void SetSkipUnchangedNodes(bool skip) { this->SkipUnchangedNodes = skip; }
+  bool GetSkipUnchangedNodes() const { return this->SkipUnchangedNodes; }
+
+  // Description:
+  // Set the world bounds outside of which nodes are culled, or NULL to not
+  // cull any nodes. An update visitor skips nodes whose bounds are known and
+  // lie entirely outside the cull bounds, and withdraws their render objects
+  // (see vtkVgNodeBase::GetCulled). Skipped nodes keep any pending update
+  // request, and are updated once they come into view.
+  void SetCullBounds(const double bounds[6]);
+  const double* GetCullBounds() const;
+
+  // Description:
+  // Return true if \param node needs to be visited by this visitor. Nodes
+  // which are dirty or have pending removals are always visited, as are
+  // culled nodes which have come back into view.
+  virtual bool ShouldUpdate(vtkVgNodeBase& node) const;
+
+  // Description:
+  // Return true if \param node lies outside the cull bounds of this update
+  // visitor.
+  bool IsCulled(vtkVgNodeBase& node) const;
+
   virtual void ShallowCopy(vtkVgNodeVisitorBase* other);
 
 protected:
+  // Description:
+  // Update the entry for \param node in the node index, if any, using the
+  // render objects \param props, or remove it if \param props is NULL.
+  void UpdateNodeIndex(vtkVgNodeBase& node, vtkPropCollection* props);
 
   VisitorType                           NodeVisitorType;
 
@@ -85,6 +126,12 @@ protected:
 
   vtkSmartPointer<vtkVgPropCollection>  PropCollection;
 
+  vtkSmartPointer<vtkVgNodeIndex>       NodeIndex;
+
+  bool                                  SkipUnchangedNodes;
+  bool                                  Culling;
+  double                                CullBounds[6];
+
 private:
   vtkVgNodeVisitorBase(const vtkVgNodeVisitorBase&); // Not implemented.
   void operator= (const vtkVgNodeVisitorBase&);      // Not implemented.
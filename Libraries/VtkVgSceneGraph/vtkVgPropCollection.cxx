@@ -10,6 +10,7 @@
 
 // STL includes.
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 vtkStandardNewMacro(vtkVgPropCollection);
@@ -53,9 +54,12 @@ void vtkVgPropCollection::AddNew(vtkPropCollection* collection, int layerIndex)
       this->ActiveProps[layerIndex].reserve(this->AllocationSize);
       }
 
+    vtkVgPropCollection::Props& newProps = this->NewProps[layerIndex];
     for (int i = 0; i < numberOfItems; ++i)
       {
-      this->ActiveProps[layerIndex].push_back(collection->GetNextProp());
+      vtkProp* nextProp = collection->GetNextProp();
+      this->ActiveProps[layerIndex].push_back(nextProp);
+      newProps.push_back(nextProp);
       }
 
     this->DirtyCacheOn();
@@ -77,17 +81,32 @@ void vtkVgPropCollection::AddExpired(vtkPropCollection* collection, int layerInd
     {
     collection->InitTraversal();
 
+    std::unordered_set<vtkProp*> expired;
     for (int i = 0; i < numberOfItems; ++i)
       {
       vtkProp* nextProp = collection->GetNextProp();
       this->ExpiredProps[layerIndex].push_back(nextProp);
+      expired.insert(nextProp);
+      }
+
+    // Remove from the active and new props, in a single pass over each.
+    auto isExpired = [&expired](const vtkSmartPointer<vtkProp>& prop)
+      { return expired.count(prop.GetPointer()) > 0; };
+
+    Itertor itr = this->ActiveProps.find(layerIndex);
+    if (itr != this->ActiveProps.end())
+      {
+      vtkVgPropCollection::Props& props = itr->second;
+      props.erase(std::remove_if(props.begin(), props.end(), isExpired),
+                  props.end());
+      }
 
-      // Remove from the active props here.
-      // \NOTE: We have to check the performance. May be it is better to use
-      // STL list but then traversal will be expensive.
-      vtkVgPropCollection::Props props = this->ActiveProps[layerIndex];
-      props.erase(std::remove(props.begin(), props.end(), nextProp), props.end());
-      this->ActiveProps[layerIndex] = props;
+    itr = this->NewProps.find(layerIndex);
+    if (itr != this->NewProps.end())
+      {
+      vtkVgPropCollection::Props& props = itr->second;
+      props.erase(std::remove_if(props.begin(), props.end(), isExpired),
+                  props.end());
       }
 
     this->DirtyOn();
@@ -97,6 +116,7 @@ void vtkVgPropCollection::AddExpired(vtkPropCollection* collection, int layerInd
 //-----------------------------------------------------------------------------
 void vtkVgPropCollection::Reset()
 {
+  this->NewProps.clear();
   this->ExpiredProps.clear();
 
   this->DirtyCacheOff();
@@ -107,6 +127,7 @@ void vtkVgPropCollection::Reset()
 void vtkVgPropCollection::ResetComplete()
 {
   this->ActiveProps.clear();
+  this->NewProps.clear();
   this->ExpiredProps.clear();
 
   this->DirtyCacheOff();
@@ -136,3 +157,15 @@ vtkVgPropCollection::SortedProps& vtkVgPropCollection::GetExpiredProps()
 {
   return this->ExpiredProps;
 }
+
+//-----------------------------------------------------------------------------
+const vtkVgPropCollection::SortedProps& vtkVgPropCollection::GetNewProps() const
+{
+  return this->NewProps;
+}
+
+//-----------------------------------------------------------------------------
+vtkVgPropCollection::SortedProps& vtkVgPropCollection::GetNewProps()
+{
+  return this->NewProps;
+}
@@ -57,7 +57,8 @@ public:
 
   // Description:
   // Add new / expired \c vtkPropCollection. \param layerIndex
-  // decided which order vtkProps gets rendered.
+  // decided which order vtkProps gets rendered. Expired props are removed
+  // from the active and new props.
   void AddNew(vtkPropCollection* collection, int layerIndex = 1000);
   void AddExpired(vtkPropCollection* collection, int layerIndex = 1000);
 
@@ -72,6 +73,11 @@ public:
   const SortedProps& GetExpiredProps() const;
   SortedProps& GetExpiredProps();
 
+  // Description:
+  // Get the props which have been added since the last reset.
+  const SortedProps& GetNewProps() const;
+  SortedProps& GetNewProps();
+
 protected:
   vtkVgPropCollection();
   virtual ~vtkVgPropCollection();
@@ -82,6 +88,7 @@ protected:
   const int   AllocationSize;
 
   SortedProps ActiveProps;
+  SortedProps NewProps;
   SortedProps ExpiredProps;
 
 private:
@@ -2,9 +2,11 @@
 // OSI-approved BSD 3-Clause License. See top-level LICENSE file or
 // https://github.com/Kitware/vivia/blob/master/LICENSE for details.
 
+#include "vtkVgAreaPicker.h"
 #include "vtkVgFindNodeVisitor.h"
 #include "vtkVgGroupNode.h"
 #include "vtkVgNodeBase.h"
+#include "vtkVgNodeIndex.h"
 #include "vtkVgNodeVisitor.h"
 #include "vtkVgPropCollection.h"
 #include "vtkVgRenderer.h"
@@ -12,20 +14,39 @@
 #include "vtkVgTimeStamp.h"
 
 // VTK includes.
+#include <vtkCamera.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkProp3DCollection.h>
+#include <vtkPropCollection.h>
 #include <vtkPropPicker.h>
 #include <vtkRenderer.h>
 
+// STL includes.
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+#include <utility>
+
 vtkStandardNewMacro(vtkVgSceneManager);
 
 //-----------------------------------------------------------------------------
 vtkVgSceneManager::vtkVgSceneManager() : vtkObject(),
   Initialized(false),
+  FullUpdate(true),
+  SkipUnchangedNodes(true),
+  CullToView(true),
+  MaxViewPropLayer(std::numeric_limits<int>::min()),
   SceneRoot(NULL),
   NodeVisitor(NULL)
 {
   this->SceneRenderer = vtkSmartPointer<vtkVgRenderer>::New();
-  this->ScenePicker   = vtkSmartPointer<vtkPropPicker>::New();
+  this->NodeIndex     = vtkSmartPointer<vtkVgNodeIndex>::New();
+
+  this->ScenePicker     = vtkSmartPointer<vtkPropPicker>::New();
+  this->SceneAreaPicker = vtkSmartPointer<vtkVgAreaPicker>::New();
+  this->SceneAreaPicker->SetNodeIndex(this->NodeIndex);
 }
 
 //-----------------------------------------------------------------------------
@@ -47,6 +68,7 @@ void vtkVgSceneManager::SetSceneRenderer(vtkRenderer* renderer)
   if (renderer && (this->SceneRenderer != renderer))
     {
     this->SceneRenderer = renderer;
+    this->FullUpdate = true;
     this->Modified();
     }
 }
@@ -75,7 +97,13 @@ void vtkVgSceneManager::SetSceneRoot(vtkVgNodeBase* root)
       this->NodeVisitor->GetPropCollection()->ResetComplete();
       }
 
+    this->NodeIndex->Reset();
+
+    this->ViewPropLayers.clear();
+    this->MaxViewPropLayer = std::numeric_limits<int>::min();
+
     this->SceneRoot = root;
+    this->FullUpdate = true;
     }
 }
 
@@ -97,6 +125,8 @@ void vtkVgSceneManager::SetNodeVisitor(vtkVgNodeVisitorBase* nodeVisitor)
   if (nodeVisitor)
     {
     this->NodeVisitor->ShallowCopy(nodeVisitor);
+    this->NodeVisitor->SetNodeIndex(this->NodeIndex);
+    this->FullUpdate = true;
     this->Modified();
     }
 }
@@ -118,53 +148,222 @@ void vtkVgSceneManager::Update(const vtkVgTimeStamp& timeStamp)
   // Set the timestamp on node visitor.
   this->NodeVisitor->SetTimeStamp(timeStamp);
 
+  // Unless everything needs to be updated, visit only the nodes which have
+  // changed and are in view.
+  const bool fullUpdate = this->FullUpdate;
+  const bool skipUnchanged = this->SkipUnchangedNodes && !fullUpdate;
+
+  double viewBounds[6];
+  const bool cull = (this->CullToView && !fullUpdate &&
+                     this->ComputeViewBounds(viewBounds));
+
+  this->NodeVisitor->SetSkipUnchangedNodes(skipUnchanged);
+  this->NodeVisitor->SetCullBounds(cull ? viewBounds : 0);
+
   // Traverse the scene.
-  this->SceneRoot->Accept(*this->NodeVisitor);
+  if (!skipUnchanged || this->SceneRoot->GetUpdatePending())
+    {
+    this->SceneRoot->Accept(*this->NodeVisitor);
+    }
+
+  this->FullUpdate = false;
 
-  // Reset and add new props or remove expired props.
+  // Add new props and remove expired props.
   vtkVgPropCollection* propCollection = this->NodeVisitor->GetPropCollection();
-  if (propCollection->GetDirty())
+  if (fullUpdate)
+    {
+    this->ResetViewProps(propCollection);
+    propCollection->Reset();
+    }
+  else if (propCollection->GetDirty())
+    {
+    this->UpdateViewProps(propCollection);
+    propCollection->Reset();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkVgSceneManager::ComputeViewBounds(double bounds[6])
+{
+  vtkRenderer* const renderer = this->SceneRenderer;
+  const int* const size = renderer->GetSize();
+  if (!renderer->GetRenderWindow() || size[0] < 1 || size[1] < 1)
+    {
+    return false;
+    }
+
+  // The view of a perspective camera, or of one which does not look along
+  // the z axis, does not have useful extents in x and y.
+  vtkCamera* const camera = renderer->GetActiveCamera();
+  double direction[3];
+  camera->GetDirectionOfProjection(direction);
+  if (!camera->GetParallelProjection() ||
+      std::fabs(direction[2]) < 1.0 - 1e-6)
+    {
+    return false;
+    }
+
+  bounds[0] = bounds[2] = std::numeric_limits<double>::max();
+  bounds[1] = bounds[3] = -std::numeric_limits<double>::max();
+  for (int i = 0; i < 4; ++i)
     {
-    if (propCollection->GetDirtyCache())
+    double point[4];
+    renderer->SetViewPoint((i & 1) ? 1.0 : -1.0, (i & 2) ? 1.0 : -1.0, 0.0);
+    renderer->ViewToWorld();
+    renderer->GetWorldPoint(point);
+
+    bounds[0] = std::min(bounds[0], point[0]);
+    bounds[1] = std::max(bounds[1], point[0]);
+    bounds[2] = std::min(bounds[2], point[1]);
+    bounds[3] = std::max(bounds[3], point[1]);
+    }
+
+  bounds[4] = -std::numeric_limits<double>::max();
+  bounds[5] = std::numeric_limits<double>::max();
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgSceneManager::ResetViewProps(vtkVgPropCollection* propCollection)
+{
+  vtkRenderer* const renderer = this->SceneRenderer;
+  renderer->RemoveAllViewProps();
+
+  this->ViewPropLayers.clear();
+  this->MaxViewPropLayer = std::numeric_limits<int>::min();
+
+  // Add the props directly to the renderer's collection; AddViewProp checks
+  // if the prop is already present, which is linear in the number of props.
+  vtkPropCollection* const viewProps = renderer->GetViewProps();
+
+  vtkVgPropCollection::ConstItertor itr =
+    propCollection->GetActiveProps().begin();
+  for (; itr != propCollection->GetActiveProps().end(); ++itr)
+    {
+    const vtkVgPropCollection::Props& props = itr->second;
+    for (size_t i = 0; i < props.size(); ++i)
       {
-      this->SceneRenderer->RemoveAllViewProps();
+      vtkProp* const prop = props[i];
+      if (this->ViewPropLayers.insert(std::make_pair(prop, itr->first)).second)
+        {
+        viewProps->AddItem(prop);
+        prop->AddConsumer(renderer);
+        this->MaxViewPropLayer = itr->first;
+        }
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgSceneManager::UpdateViewProps(vtkVgPropCollection* propCollection)
+{
+  vtkRenderer* const renderer = this->SceneRenderer;
+  vtkPropCollection* const viewProps = renderer->GetViewProps();
 
-      vtkVgPropCollection::ConstItertor beginItr =
-        propCollection->GetActiveProps().begin();
-      vtkVgPropCollection::ConstItertor endItr =
-        propCollection->GetActiveProps().end();
+  // Find the expired props which are in the renderer.
+  std::unordered_set<vtkProp*> expired;
+  vtkVgPropCollection::ConstItertor itr =
+    propCollection->GetExpiredProps().begin();
+  for (; itr != propCollection->GetExpiredProps().end(); ++itr)
+    {
+    const vtkVgPropCollection::Props& props = itr->second;
+    for (size_t i = 0; i < props.size(); ++i)
+      {
+      if (this->ViewPropLayers.erase(props[i]))
+        {
+        expired.insert(props[i]);
+        }
+      }
+    }
 
-      while (beginItr != endItr)
+  // Find the new props which are not in the renderer, ordered by layer.
+  std::vector<std::pair<int, vtkProp*> > added;
+  itr = propCollection->GetNewProps().begin();
+  for (; itr != propCollection->GetNewProps().end(); ++itr)
+    {
+    const vtkVgPropCollection::Props& props = itr->second;
+    for (size_t i = 0; i < props.size(); ++i)
+      {
+      vtkProp* const prop = props[i];
+      if (this->ViewPropLayers.insert(std::make_pair(prop, itr->first)).second)
         {
-        vtkVgPropCollection::Props props = beginItr->second;
-        for (size_t i = 0; i < props.size(); ++i)
-          {
-          this->SceneRenderer->AddViewProp(props[i]);
-          this->ScenePicker->AddPickList(props[i]);
-          }
-        ++beginItr;
+        added.push_back(std::make_pair(itr->first, prop));
         }
       }
-    else
+    }
+
+  if (expired.empty() && added.empty())
+    {
+    return;
+    }
+
+  // Props are rendered in order, so new props must follow the props of the
+  // same or lower layers. In the common case, where none are removed and the
+  // new props belong at the end, just append them.
+  if (expired.empty() && added.front().first >= this->MaxViewPropLayer)
+    {
+    for (size_t i = 0; i < added.size(); ++i)
       {
-      vtkVgPropCollection::ConstItertor beginItr =
-        propCollection->GetExpiredProps().begin();
-      vtkVgPropCollection::ConstItertor endItr =
-        propCollection->GetExpiredProps().end();
+      viewProps->AddItem(added[i].second);
+      added[i].second->AddConsumer(renderer);
+      }
+    this->MaxViewPropLayer = added.back().first;
+    return;
+    }
+
+  // Otherwise, merge the new props into the remaining ones in a single pass.
+  std::vector<vtkSmartPointer<vtkProp> > merged;
+  merged.reserve(viewProps->GetNumberOfItems() + added.size());
 
-      while (beginItr != endItr)
+  size_t next = 0;
+  vtkCollectionSimpleIterator iter;
+  viewProps->InitTraversal(iter);
+  while (vtkProp* const prop = viewProps->GetNextProp(iter))
+    {
+    if (expired.count(prop))
+      {
+      // An expired prop may also have been added again.
+      if (!this->ViewPropLayers.count(prop))
         {
-        vtkVgPropCollection::Props props = beginItr->second;
-        for (size_t i = 0; i < props.size(); ++i)
-          {
-          this->SceneRenderer->RemoveViewProp(props[i]);
-          this->ScenePicker->DeletePickList(props[i]);
-          }
-        ++beginItr;
+        prop->ReleaseGraphicsResources(renderer->GetVTKWindow());
         }
+      prop->RemoveConsumer(renderer);
+      continue;
       }
 
-    propCollection->Reset();
+    std::unordered_map<vtkProp*, int>::const_iterator layer =
+      this->ViewPropLayers.find(prop);
+    if (layer != this->ViewPropLayers.end())
+      {
+      while (next < added.size() && added[next].first < layer->second)
+        {
+        merged.push_back(added[next++].second);
+        }
+      }
+    merged.push_back(prop);
+    }
+  while (next < added.size())
+    {
+    merged.push_back(added[next++].second);
+    }
+
+  viewProps->RemoveAllItems();
+  this->MaxViewPropLayer = std::numeric_limits<int>::min();
+  for (size_t i = 0; i < merged.size(); ++i)
+    {
+    viewProps->AddItem(merged[i]);
+
+    std::unordered_map<vtkProp*, int>::const_iterator layer =
+      this->ViewPropLayers.find(merged[i]);
+    if (layer != this->ViewPropLayers.end())
+      {
+      this->MaxViewPropLayer = std::max(this->MaxViewPropLayer, layer->second);
+      }
+    }
+  for (size_t i = 0; i < added.size(); ++i)
+    {
+    added[i].second->AddConsumer(renderer);
     }
 }
 
@@ -177,25 +376,84 @@ void vtkVgSceneManager::Initialize()
     this->NodeVisitor = new vtkVgNodeVisitor();
     this->NodeVisitor->SetVisitorType(vtkVgNodeVisitorBase::UPDATE_VISITOR);
     this->NodeVisitor->SetPropCollection(vtkVgPropCollection::SmartPtr::New());
+    this->NodeVisitor->SetNodeIndex(this->NodeIndex);
     }
 
   this->Initialized = true;
 }
 
 //-----------------------------------------------------------------------------
-vtkVgNodeBase* vtkVgSceneManager::Pick(const double& x, const double& y, const double& z)
+vtkVgNodeBase* vtkVgSceneManager::Pick(const double& x, const double& y,
+                                       const double& vtkNotUsed(z))
 {
-  if (this->ScenePicker->Pick(x, y, z, this->SceneRenderer))
+  vtkRenderer* const renderer = this->SceneRenderer;
+
+  // Only props of nodes whose bounds are crossed by the line of sight through
+  // the pick position can be picked.
+  double p1[4], p2[4];
+  renderer->SetDisplayPoint(x, y, 0.0);
+  renderer->DisplayToWorld();
+  renderer->GetWorldPoint(p1);
+  renderer->SetDisplayPoint(x, y, 1.0);
+  renderer->DisplayToWorld();
+  renderer->GetWorldPoint(p2);
+
+  vtkNew<vtkPropCollection> candidates;
+  this->NodeIndex->FindProps(
+    [&p1, &p2](const double bounds[6])
+      { return vtkVgNodeIndex::IntersectSegment(bounds, p1, p2); },
+    candidates.GetPointer());
+
+  if (candidates->GetNumberOfItems() < 1 ||
+      !this->ScenePicker->PickProp(x, y, renderer, candidates.GetPointer()))
     {
-    vtkProp3D* prop3D = this->ScenePicker->GetProp3D();
+    return NULL;
+    }
 
-    vtkVgFindNodeVisitor findNodeVisitor;
-    findNodeVisitor.SetUsingProp3D(prop3D);
+  if (vtkVgNodeBase* node =
+        this->NodeIndex->FindNode(this->ScenePicker->GetViewProp()))
+    {
+    return node;
+    }
+
+  // Every candidate belongs to an indexed node, so this should not happen,
+  // but search the scene in case the node was removed in the meantime.
+  vtkVgFindNodeVisitor findNodeVisitor;
+  findNodeVisitor.SetUsingProp3D(this->ScenePicker->GetProp3D());
 
-    this->SceneRoot->Accept(findNodeVisitor);
+  this->SceneRoot->Accept(findNodeVisitor);
 
-    return findNodeVisitor.GetNode();
+  return findNodeVisitor.GetNode();
+}
+
+//-----------------------------------------------------------------------------
+int vtkVgSceneManager::PickNodes(double x1, double y1, double x2, double y2,
+                                 std::vector<vtkVgNodeBase*>& nodes)
+{
+  if (!this->SceneAreaPicker->AreaPick(x1, y1, x2, y2, this->SceneRenderer))
+    {
+    return 0;
+    }
+
+  std::unordered_set<vtkVgNodeBase*> pickedNodes;
+
+  vtkProp3DCollection* const props = this->SceneAreaPicker->GetProp3Ds();
+  vtkCollectionSimpleIterator iter;
+  props->InitTraversal(iter);
+  while (vtkProp3D* prop = props->GetNextProp3D(iter))
+    {
+    vtkVgNodeBase* const node = this->NodeIndex->FindNode(prop);
+    if (node && pickedNodes.insert(node).second)
+      {
+      nodes.push_back(node);
+      }
     }
 
-  return NULL;
+  return static_cast<int>(pickedNodes.size());
+}
+
+//-----------------------------------------------------------------------------
+vtkVgNodeIndex* vtkVgSceneManager::GetNodeIndex()
+{
+  return this->NodeIndex;
 }
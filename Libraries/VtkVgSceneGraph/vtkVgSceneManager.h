@@ -12,6 +12,10 @@
 #include <vtkObject.h>
 #include <vtkSmartPointer.h>
 
+// STL includes.
+#include <unordered_map>
+#include <vector>
+
 #include <vgExport.h>
 
 // Forward declarations.
@@ -19,8 +23,12 @@ class vtkVgGroupNode;
 class vtkVgTimeStamp;
 class vtkVgNodeVisitorBase;
 class vtkVgNodeBase;
+class vtkVgNodeIndex;
+class vtkVgAreaPicker;
+class vtkVgPropCollection;
 
-class vtkAbstractPropPicker;;
+class vtkProp;
+class vtkPropPicker;
 class vtkRenderer;
 
 //-----------------------------------------------------------------------------
@@ -62,13 +70,46 @@ public:
   const vtkVgNodeVisitorBase* GetNodeVisitor() const;
 
   // Description:
-  // Update scene using \param timeStamp.
+  // Update scene using \param timeStamp. Only the props which have been
+  // added or removed since the last update are added to or removed from the
+  // scene renderer.
   void Update(const vtkVgTimeStamp& timeStamp);
 
   // Description:
-  // Pick a node in this view.
+  // Set/Get if an update visits only the nodes which have changed since the
+  // last update (see vtkVgNodeBase::RequestUpdate). On by default.
+  vtkSetMacro(SkipUnchangedNodes, bool);
+  vtkGetMacro(SkipUnchangedNodes, bool);
+  vtkBooleanMacro(SkipUnchangedNodes, bool);
+
+  // Description:
+  // Set/Get if an update skips nodes which are entirely outside of the view.
+  // Such nodes are not updated, and do not add new props to the renderer,
+  // until they come into view. Culling is only done for 2D views, that is,
+  // when the camera uses a parallel projection and looks along the z axis.
+  // On by default.
+  vtkSetMacro(CullToView, bool);
+  vtkGetMacro(CullToView, bool);
+  vtkBooleanMacro(CullToView, bool);
+
+  // Description:
+  // Pick a node in this view. Only the nodes whose bounds intersect the line
+  // of sight through the display position are considered.
   virtual vtkVgNodeBase* Pick(const double& x, const double& y, const double& z);
 
+  // Description:
+  // Pick all nodes having a visible, pickable prop whose bounds intersect the
+  // display rectangle with corners (\param x1, \param y1) and (\param x2,
+  // \param y2). Picked nodes are appended to \param nodes. Return the number
+  // of nodes picked.
+  virtual int PickNodes(double x1, double y1, double x2, double y2,
+                        std::vector<vtkVgNodeBase*>& nodes);
+
+  // Description:
+  // Get the spatial index of the leaf nodes of the scene. The index is
+  // updated when the scene is updated.
+  vtkVgNodeIndex* GetNodeIndex();
+
 protected:
   vtkVgSceneManager();
   virtual ~vtkVgSceneManager();
@@ -77,14 +118,41 @@ protected:
   //
   void Initialize();
 
+  // Description:
+  // Compute the world bounds of the current view, if it is a 2D view.
+  // Return false if the view bounds cannot be computed.
+  bool ComputeViewBounds(double bounds[6]);
+
+  // Description:
+  // Replace the props of the scene renderer with all of the active props of
+  // \param propCollection, or apply the new and expired props.
+  void ResetViewProps(vtkVgPropCollection* propCollection);
+  void UpdateViewProps(vtkVgPropCollection* propCollection);
+
   bool                                        Initialized;
 
+  // Description:
+  // Set when the next update must visit every node and rebuild the props of
+  // the renderer (e.g. because the scene or the renderer has changed).
+  bool                                        FullUpdate;
+
+  bool                                        SkipUnchangedNodes;
+  bool                                        CullToView;
+
+  // Description:
+  // Props which have been added to the scene renderer, and their layers.
+  std::unordered_map<vtkProp*, int>           ViewPropLayers;
+  int                                         MaxViewPropLayer;
+
   vtkSmartPointer<vtkVgNodeBase>              SceneRoot;
   vtkSmartPointer<vtkRenderer>                SceneRenderer;
 
   vtkVgNodeVisitorBase*                        NodeVisitor;
 
-  vtkSmartPointer<vtkAbstractPropPicker>      ScenePicker;
+  vtkSmartPointer<vtkVgNodeIndex>             NodeIndex;
+
+  vtkSmartPointer<vtkPropPicker>              ScenePicker;
+  vtkSmartPointer<vtkVgAreaPicker>            SceneAreaPicker;
 
 private:
   vtkVgSceneManager(const vtkVgSceneManager&);
@@ -174,6 +174,13 @@ void vtkVgTrackNode::UpdateRenderObjects(vtkVgPropCollection* propCollection)
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgTrackNode::Cull(vtkVgNodeVisitorBase& nodeVisitor)
+{
+  this->PrepareForCulling(nodeVisitor.GetPropCollection(),
+                          this->TrackRepresentation);
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgTrackNode::Accept(vtkVgNodeVisitorBase& nodeVisitor)
 {
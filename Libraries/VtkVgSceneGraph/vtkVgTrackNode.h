@@ -60,6 +60,8 @@ protected:
   vtkVgTrackNode();
   virtual ~vtkVgTrackNode();
 
+  virtual void Cull(vtkVgNodeVisitorBase& nodeVisitor);
+
   vtkSmartPointer<vtkVgTrackModel>          TrackModel;
   vtkSmartPointer<vtkVgTrackRepresentation> TrackRepresentation;
 
@@ -23,9 +23,64 @@
 #include <vtkMatrix4x4.h>
 #include <vtkObjectFactory.h>
 #include <vtkRenderer.h>
+#include <vtkWeakPointer.h>
+
+// STL includes.
+#include <vector>
 
 vtkStandardNewMacro(vtkVgVideoNode);
 
+//-----------------------------------------------------------------------------
+class vtkVgVideoNode::vtkInternal
+{
+public:
+  struct Observation
+    {
+    vtkWeakPointer<vtkObject> Subject;
+    unsigned long Tag;
+    };
+
+  vtkInternal() :
+    TrackRepresentation(0), EventRepresentation(0), Updating(false)
+    {}
+
+  ~vtkInternal() { this->RemoveObservers(); }
+
+  void Observe(vtkObject* subject, unsigned long event, vtkVgVideoNode* node)
+    {
+    if (subject)
+      {
+      Observation observation;
+      observation.Subject = subject;
+      observation.Tag = subject->AddObserver(
+        event, node, &vtkVgVideoNode::HandleRepresentationModified);
+      this->Observations.push_back(observation);
+      }
+    }
+
+  void RemoveObservers()
+    {
+    for (size_t i = 0; i < this->Observations.size(); ++i)
+      {
+      if (vtkObject* const subject = this->Observations[i].Subject)
+        {
+        subject->RemoveObserver(this->Observations[i].Tag);
+        }
+      }
+    this->Observations.clear();
+    }
+
+  std::vector<Observation> Observations;
+
+  // Representations being observed; used only for comparison.
+  vtkVgRepresentationBase* TrackRepresentation;
+  vtkVgRepresentationBase* EventRepresentation;
+
+  // Set while the node is being updated; changes made by the update itself
+  // do not need another update.
+  bool Updating;
+};
+
 //-----------------------------------------------------------------------------
 vtkVgVideoNode::vtkVgVideoNode() : vtkVgLeafNodeBase(),
   StreamId(NULL),
@@ -43,7 +98,8 @@ vtkVgVideoNode::vtkVgVideoNode() : vtkVgLeafNodeBase(),
   ActivityType(-1),
   Note(NULL),
   VideoModel(NULL),
-  VideoRepresentation(NULL)
+  VideoRepresentation(NULL),
+  Internal(new vtkInternal)
 {
   this->TimeRange[0] = this->TimeRange[1] = -1.0;
 }
@@ -54,6 +110,8 @@ vtkVgVideoNode::~vtkVgVideoNode()
   this->SetStreamId(0);
   this->SetMissionId(0);
   this->SetNote(0);
+
+  delete this->Internal;
 }
 
 //-----------------------------------------------------------------------------
@@ -81,6 +139,8 @@ void vtkVgVideoNode::SetVideoRepresentation(
     // \NOTE: This flag is on or else there won't be any data transfer to
     // video representation in \c Update call.
     this->DirtyOn();
+
+    this->UpdateObservers();
     }
 }
 
@@ -134,6 +194,8 @@ int vtkVgVideoNode::SetVisible(int flag)
 //-----------------------------------------------------------------------------
 void vtkVgVideoNode::Update(vtkVgNodeVisitorBase& nodeVisitor)
 {
+  this->Internal->Updating = true;
+
   // Update the model first.
   this->VideoModel->Update(nodeVisitor.GetTimeStamp());
 
@@ -159,6 +221,17 @@ void vtkVgVideoNode::Update(vtkVgNodeVisitorBase& nodeVisitor)
     {
     this->ComputeBounds();
     }
+
+  this->Internal->Updating = false;
+
+  // The track and event representations may have been replaced.
+  if (this->VideoRepresentation->GetTrackRepresentation() !=
+        this->Internal->TrackRepresentation ||
+      this->VideoRepresentation->GetEventRepresentation() !=
+        this->Internal->EventRepresentation)
+    {
+    this->UpdateObservers();
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -199,6 +272,26 @@ void vtkVgVideoNode::UpdateRenderObjects(vtkVgPropCollection* propCollection)
     }
 }
 
+//-----------------------------------------------------------------------------
+void vtkVgVideoNode::Cull(vtkVgNodeVisitorBase& nodeVisitor)
+{
+  vtkVgPropCollection* propCollection = nodeVisitor.GetPropCollection();
+
+  this->PrepareForCulling(propCollection, this->VideoRepresentation);
+
+  if (vtkVgRepresentationBase* trackRep =
+        this->VideoRepresentation->GetTrackRepresentation())
+    {
+    this->PrepareForCulling(propCollection, trackRep);
+    }
+
+  if (vtkVgRepresentationBase* eventRep =
+        this->VideoRepresentation->GetEventRepresentation())
+    {
+    this->PrepareForCulling(propCollection, eventRep);
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkVgVideoNode::Accept(vtkVgNodeVisitorBase& nodeVisitor)
 {
@@ -232,3 +325,53 @@ void vtkVgVideoNode::ComputeBounds()
     this->BoundsDirtyOff();
     }
 }
+
+//-----------------------------------------------------------------------------
+bool vtkVgVideoNode::IsTimeDependent()
+{
+  if (!this->Visible || !this->VideoModel)
+    {
+    return false;
+    }
+
+  return (this->VideoModel->IsPlaying() ||
+          !this->VideoModel->GetInitialized());
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoNode::UpdateObservers()
+{
+  this->Internal->RemoveObservers();
+  this->Internal->TrackRepresentation = 0;
+  this->Internal->EventRepresentation = 0;
+
+  if (!this->VideoRepresentation)
+    {
+    return;
+    }
+
+  vtkVgRepresentationBase* const trackRep =
+    this->VideoRepresentation->GetTrackRepresentation();
+  vtkVgRepresentationBase* const eventRep =
+    this->VideoRepresentation->GetEventRepresentation();
+
+  this->Internal->Observe(this->VideoModel, vtkCommand::ModifiedEvent, this);
+  this->Internal->Observe(this->VideoModel, vtkCommand::UpdateDataEvent,
+                          this);
+  this->Internal->Observe(this->VideoRepresentation,
+                          vtkCommand::ModifiedEvent, this);
+  this->Internal->Observe(trackRep, vtkCommand::ModifiedEvent, this);
+  this->Internal->Observe(eventRep, vtkCommand::ModifiedEvent, this);
+
+  this->Internal->TrackRepresentation = trackRep;
+  this->Internal->EventRepresentation = eventRep;
+}
+
+//-----------------------------------------------------------------------------
+void vtkVgVideoNode::HandleRepresentationModified()
+{
+  if (!this->Internal->Updating)
+    {
+    this->RequestUpdate();
+    }
+}
@@ -123,10 +123,25 @@ public:
 
   virtual void ComputeBounds();
 
+  // Description:
+  // A video node needs to be updated on every update traversal only while
+  // it is visible and its video is playing (or has not been initialized).
+  // Other changes to the video model (including stopping the video) or
+  // representation are observed, and request an update of the node.
+  virtual bool IsTimeDependent();
+
 protected:
   vtkVgVideoNode();
   virtual ~vtkVgVideoNode();
 
+  virtual void Cull(vtkVgNodeVisitorBase& nodeVisitor);
+
+  // Description:
+  // Observe changes to the video model and representations, so that the
+  // node is updated when they change.
+  void UpdateObservers();
+  void HandleRepresentationModified();
+
   char*     StreamId;
   char*     MissionId;
   vtkIdType InstanceId;
@@ -154,6 +169,9 @@ protected:
 private:
   vtkVgVideoNode(const vtkVgVideoNode&); // Not implemented.
   void operator=(const vtkVgVideoNode&); // Not implemented.
+
+  class vtkInternal;
+  vtkInternal* Internal;
 };
 
 #endif // __vtkVgVideoNode_h
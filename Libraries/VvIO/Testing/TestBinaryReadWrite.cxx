@@ -0,0 +1,263 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QTemporaryFile>
+#include <QUrl>
+#include <QtEndian>
+
+#include <qtTest.h>
+
+#include "../vvBinaryReader.h"
+#include "../vvBinaryWriter.h"
+#include "../vvKstWriter.h"
+
+#include "TestReadWrite.h"
+
+QString testFileBase;
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void readKst(qtTest& testObject, const QString& suffix, QList<T>& items,
+             bool (vvReader::*method)(QList<T>&))
+{
+  vvReader reader;
+  vvHeader header;
+  TEST(reader.open(QUrl::fromLocalFile(testFileBase + suffix), vvReader::Kst));
+  TEST(reader.readHeader(header));
+  TEST((reader.*method)(items));
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+QByteArray writeBinary(vvHeader::FileType type, const QList<T>& items,
+                       int chunkSize = 256)
+{
+  QBuffer buffer;
+  buffer.open(QIODevice::WriteOnly);
+
+    {
+    vvBinaryWriter writer(buffer, chunkSize);
+    writer << type << items;
+    }
+
+  return buffer.data();
+}
+
+//-----------------------------------------------------------------------------
+int testTrack(qtTest& testObject)
+{
+  QList<vvTrack> tracks;
+  TEST_CALL(readKst<vvTrack>, "-a.vst", tracks, &vvReader::readTracks);
+
+  // Write tracks, one per chunk, and read them back
+  const QByteArray data = writeBinary(vvHeader::Tracks, tracks, 1);
+
+  vvBinaryReader reader;
+  vvHeader header;
+  TEST(reader.setInput(data));
+  TEST(reader.readHeader(header));
+  TEST_EQUAL(header.type, vvHeader::Tracks);
+  TEST_EQUAL(header.version, vvBinaryWriter::FormatVersion);
+  TEST_EQUAL(reader.itemCount(), 2LL);
+
+  TEST(reader.readTracks(tracks));
+  if (TEST_EQUAL(tracks.count(), 2) == 0)
+    {
+    TEST_CALL(testTrack1, tracks[0]);
+    TEST_CALL(testTrack2, tracks[1]);
+    }
+
+  // Test random access
+  vvTrack track;
+  TEST(reader.seek(1));
+  TEST(reader.readTrack(track));
+  TEST_CALL(testTrack2, track);
+  TEST(reader.atEnd());
+  TEST(reader.seek(0));
+  TEST(reader.readTrack(track));
+  TEST_CALL(testTrack1, track);
+  TEST(!reader.seek(3));
+
+  // Read second file
+  TEST_CALL(readKst<vvTrack>, "-b.vst", tracks, &vvReader::readTracks);
+  TEST(reader.setInput(writeBinary(vvHeader::Tracks, tracks)));
+  TEST(reader.readTracks(tracks));
+  if (TEST_EQUAL(tracks.count(), 1) == 0)
+    {
+    TEST_CALL(testTrack3, tracks[0]);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testDescriptor(qtTest& testObject)
+{
+  QList<vvDescriptor> descriptors;
+  TEST_CALL(readKst<vvDescriptor>, ".vsd", descriptors,
+            &vvReader::readDescriptors);
+
+  vvBinaryReader reader;
+  vvHeader header;
+  TEST(reader.setInput(writeBinary(vvHeader::Descriptors, descriptors, 2)));
+  TEST(reader.readHeader(header));
+  TEST_EQUAL(header.type, vvHeader::Descriptors);
+
+  TEST(reader.readDescriptors(descriptors));
+  if (TEST_EQUAL(descriptors.count(), 3) == 0)
+    {
+    TEST_CALL(testDescriptor1, descriptors[0]);
+    TEST_CALL(testDescriptor2, descriptors[1]);
+    TEST_CALL(testDescriptor3, descriptors[2]);
+    }
+
+  // Reading the wrong type of data is an error
+  vvTrack track;
+  TEST(reader.rewind());
+  TEST(!reader.readTrack(track));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testQueryResult(qtTest& testObject)
+{
+  QList<vvQueryResult> results;
+  TEST_CALL(readKst<vvQueryResult>, "-2.vqr", results,
+            &vvReader::readQueryResults);
+
+  // Write to a file, and read back using format auto-detection
+  QTemporaryFile file;
+  TEST(file.open());
+  file.write(writeBinary(vvHeader::QueryResults, results));
+  file.close();
+
+  vvReader reader;
+  vvHeader header;
+  TEST(reader.open(QUrl::fromLocalFile(file.fileName())));
+  TEST(reader.readHeader(header));
+  TEST_EQUAL(header.type, vvHeader::QueryResults);
+
+  TEST(reader.readQueryResults(results));
+  if (TEST_EQUAL(results.count(), 2) == 0)
+    {
+    TEST_CALL(testQueryResult1, results[0], vvKstWriter::QueryResultsVersion);
+    TEST_CALL(testQueryResult2, results[1], vvKstWriter::QueryResultsVersion);
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testRecovery(qtTest& testObject)
+{
+  QList<vvTrack> tracks;
+  TEST_CALL(readKst<vvTrack>, "-a.vst", tracks, &vvReader::readTracks);
+  const QByteArray data = writeBinary(vvHeader::Tracks, tracks, 1);
+
+  // Archive without an index (e.g. writer did not finish) is still readable
+  vvBinaryReader reader;
+  TEST(reader.setInput(data.left(data.size() - 8)));
+  TEST_EQUAL(reader.itemCount(), 2LL);
+  TEST(reader.readTracks(tracks));
+  TEST_EQUAL(tracks.count(), 2);
+
+  // Incomplete chunks are ignored
+  TEST(reader.setInput(data.left(data.size() / 2)));
+  TEST(reader.itemCount() < 2LL);
+
+  // Not a binary archive
+  TEST(!reader.setInput(QByteArray("TRACKS;\n")));
+  TEST(!reader.error().isEmpty());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+bool readDescriptor(const QByteArray& data, vvDescriptor& descriptor)
+{
+  vvBinaryReader reader;
+  vvHeader header;
+  return reader.setInput(data) && reader.readHeader(header) &&
+         reader.readDescriptor(descriptor);
+}
+
+//-----------------------------------------------------------------------------
+quint32 getUInt32(const QByteArray& data, int offset)
+{
+  return qFromLittleEndian<quint32>(
+    reinterpret_cast<const uchar*>(data.constData() + offset));
+}
+
+//-----------------------------------------------------------------------------
+void setUInt32(QByteArray& data, int offset, quint32 value)
+{
+  qToLittleEndian<quint32>(value,
+                           reinterpret_cast<uchar*>(data.data() + offset));
+}
+
+//-----------------------------------------------------------------------------
+int testCorruptDescriptor(qtTest& testObject)
+{
+  vvDescriptor descriptor;
+  descriptor.DescriptorName = "d";
+  descriptor.ModuleName = "m";
+  descriptor.Values.resize(2, std::vector<float>(2, 1.0f));
+  const QByteArray data =
+    writeBinary(vvHeader::Descriptors, QList<vvDescriptor>() << descriptor);
+
+  // The item size follows the file and chunk headers; the value vector sizes
+  // follow the item size, names, instance ID, confidence and vector count
+  const int itemSizeOffset = 12 + 16;
+  const int valueSizeOffset = itemSizeOffset + 4 + 5 + 5 + 8 + 8 + 4;
+  TEST_EQUAL(getUInt32(data, valueSizeOffset), 2U);
+  TEST_EQUAL(getUInt32(data, valueSizeOffset + 4), 2U);
+  TEST(readDescriptor(data, descriptor));
+  TEST_EQUAL(descriptor.Values.size(), size_t(2));
+
+  // Value vector larger than the remaining data
+  QByteArray corrupt = data;
+  setUInt32(corrupt, valueSizeOffset, 0xffffffffU);
+  TEST(!readDescriptor(corrupt, descriptor));
+
+  // Value vectors which each fit in the remaining data, but not together
+  corrupt = data;
+  setUInt32(corrupt, valueSizeOffset, 4);
+  setUInt32(corrupt, valueSizeOffset + 4, 4);
+  TEST(!readDescriptor(corrupt, descriptor));
+
+  // More value vectors than the remaining data could hold
+  corrupt = data;
+  setUInt32(corrupt, valueSizeOffset - 4, 0x40000000U);
+  TEST(!readDescriptor(corrupt, descriptor));
+
+  // Item truncated before its track ID's
+  corrupt = data;
+  setUInt32(corrupt, itemSizeOffset, getUInt32(data, itemSizeOffset) - 4);
+  TEST(!readDescriptor(corrupt, descriptor));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  qtTest testObject;
+
+  if (argc < 2)
+    {
+    testObject.out() << "invocation error, path to test data files required\n";
+    return 1;
+    }
+  testFileBase = QString::fromLocal8Bit(argv[1]);
+
+  testObject.runSuite("Track Tests",                testTrack);
+  testObject.runSuite("Descriptor Tests",           testDescriptor);
+  testObject.runSuite("Query Result Tests",         testQueryResult);
+  testObject.runSuite("Recovery Tests",             testRecovery);
+  testObject.runSuite("Corrupt Descriptor Tests",   testCorruptDescriptor);
+  return testObject.result();
+}
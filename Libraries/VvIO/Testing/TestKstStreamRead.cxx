@@ -0,0 +1,248 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <QByteArray>
+#include <QList>
+
+#include <limits>
+
+#include <qtTest.h>
+
+#include "../vvKstStreamReader.h"
+#include "../vvKstWriter.h"
+
+#include "TestReadWrite.h"
+
+QString testFileBase;
+
+//-----------------------------------------------------------------------------
+template <typename T>
+struct Reader
+{
+  typedef bool (vvKstStreamReader::*Method)(
+    const vvKstStreamReader::Callback<T>&);
+};
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void readFile(qtTest& testObject, const QString& suffix, int threads,
+             typename Reader<T>::Method method, vvHeader& header,
+             QList<T>& items)
+{
+  vvKstStreamReader reader;
+  reader.setThreadCount(threads);
+  reader.setBatchSize(1);
+
+  TEST(reader.open(testFileBase + suffix));
+  TEST(reader.readHeader(header));
+  TEST((reader.*method)([&items](T& item){
+    items.append(item);
+    return true;
+  }));
+  TEST_EQUAL(reader.position(), reader.size());
+}
+
+//-----------------------------------------------------------------------------
+void testTrack(qtTest& testObject, int threads)
+{
+  vvHeader header;
+  QList<vvTrack> tracks;
+
+  TEST_CALL(readFile<vvTrack>, "-a.vst", threads,
+            &vvKstStreamReader::readTracks, header, tracks);
+  TEST_EQUAL(header.type, vvHeader::Tracks);
+  TEST_EQUAL(header.version, vvKstWriter::TracksVersion);
+  if (TEST_EQUAL(tracks.count(), 2) == 0)
+    {
+    TEST_CALL(testTrack1, tracks[0]);
+    TEST_CALL(testTrack2, tracks[1]);
+    }
+
+  tracks.clear();
+  TEST_CALL(readFile<vvTrack>, "-b.vst", threads,
+            &vvKstStreamReader::readTracks, header, tracks);
+  if (TEST_EQUAL(tracks.count(), 1) == 0)
+    {
+    TEST_CALL(testTrack3, tracks[0]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void testDescriptor(qtTest& testObject, int threads)
+{
+  vvHeader header;
+  QList<vvDescriptor> descriptors;
+
+  TEST_CALL(readFile<vvDescriptor>, ".vsd", threads,
+            &vvKstStreamReader::readDescriptors, header, descriptors);
+  TEST_EQUAL(header.type, vvHeader::Descriptors);
+  TEST_EQUAL(header.version, vvKstWriter::DescriptorsVersion);
+  if (TEST_EQUAL(descriptors.count(), 3) == 0)
+    {
+    TEST_CALL(testDescriptor1, descriptors[0]);
+    TEST_CALL(testDescriptor2, descriptors[1]);
+    TEST_CALL(testDescriptor3, descriptors[2]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void testQueryResult(qtTest& testObject, int threads)
+{
+  vvHeader header;
+  QList<vvQueryResult> results;
+
+  TEST_CALL(readFile<vvQueryResult>, "-1.vqr", threads,
+            &vvKstStreamReader::readQueryResults, header, results);
+  TEST_EQUAL(header.type, vvHeader::QueryResults);
+  TEST_EQUAL(header.version, 1U);
+  if (TEST_EQUAL(results.count(), 2) == 0)
+    {
+    // Version 1 does not have rank
+    TEST_EQUAL(results[0].Rank, -1LL);
+    TEST_EQUAL(results[1].Rank, -1LL);
+    results[0].Rank = 0;
+    results[1].Rank = 1;
+    TEST_CALL(testQueryResult1, results[0], header.version);
+    TEST_CALL(testQueryResult2, results[1], header.version);
+    }
+
+  results.clear();
+  TEST_CALL(readFile<vvQueryResult>, "-2.vqr", threads,
+            &vvKstStreamReader::readQueryResults, header, results);
+  TEST_EQUAL(header.version, vvKstWriter::QueryResultsVersion);
+  if (TEST_EQUAL(results.count(), 2) == 0)
+    {
+    TEST_CALL(testQueryResult1, results[0], header.version);
+    TEST_CALL(testQueryResult2, results[1], header.version);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int testSerial(qtTest& testObject)
+{
+  TEST_CALL(testTrack, 1);
+  TEST_CALL(testDescriptor, 1);
+  TEST_CALL(testQueryResult, 1);
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testParallel(qtTest& testObject)
+{
+  TEST_CALL(testTrack, 4);
+  TEST_CALL(testDescriptor, 4);
+  TEST_CALL(testQueryResult, 4);
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testControl(qtTest& testObject)
+{
+  const QByteArray data =
+    "TRACKS;\n"
+    "[ 0, 1 ], [ ], [ ];\n"
+    "[ 0, 2 ], [ ], [ ];\n"
+    "[ 0, 3 ], [ ], [ ];\n"
+    "[ 0, \"bad\" ], [ ], [ ];\n"
+    "[ 0, 5 ], [ ], [ ];\n";
+
+  for (int threads = 1; threads <= 2; ++threads)
+    {
+    vvKstStreamReader reader;
+    vvHeader header;
+    QList<long long> ids;
+    reader.setThreadCount(threads);
+
+    // Stopping early is not an error
+    TEST(reader.setInput(data));
+    TEST(reader.readHeader(header));
+    TEST(reader.readTracks([&ids](vvTrack& track){
+      ids.append(track.Id.SerialNumber);
+      return ids.count() < 2;
+    }));
+    TEST_EQUAL(ids.count(), 2);
+
+    // Items preceding an invalid record are delivered before the error
+    ids.clear();
+    TEST(reader.setInput(data));
+    TEST(reader.readHeader(header));
+    TEST(!reader.readTracks([&ids](vvTrack& track){
+      ids.append(track.Id.SerialNumber);
+      return true;
+    }));
+    TEST_EQUAL(ids.count(), 3);
+    TEST(!reader.error().isEmpty());
+
+    // Reading the wrong type of data is an error
+    TEST(reader.setInput(data));
+    TEST(reader.readHeader(header));
+    TEST(!reader.readDescriptors([](vvDescriptor&){ return true; }));
+    }
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+bool readTrackIds(const QByteArray& data, QList<long long>& ids)
+{
+  vvKstStreamReader reader;
+  vvHeader header;
+  ids.clear();
+  return reader.setInput(data) && reader.readHeader(header) &&
+         reader.readTracks([&ids](vvTrack& track){
+           ids.append(track.Id.SerialNumber);
+           return true;
+         });
+}
+
+//-----------------------------------------------------------------------------
+int testRange(qtTest& testObject)
+{
+  QList<long long> ids;
+
+  // Values at the limits of the integer types are accepted
+  TEST(readTrackIds("TRACKS;\n"
+                    "[ 2147483647, 9223372036854775807 ], [ ], [ ];\n"
+                    "[ -2147483648, -9223372036854775808 ], [ ], [ ];\n",
+                    ids));
+  if (TEST_EQUAL(ids.count(), 2) == 0)
+    {
+    TEST_EQUAL(ids[0], std::numeric_limits<long long>::max());
+    TEST_EQUAL(ids[1], std::numeric_limits<long long>::min());
+    }
+
+  // Values beyond the limits are errors, and do not wrap
+  TEST(!readTrackIds("TRACKS;\n"
+                     "[ 0, 9223372036854775808 ], [ ], [ ];\n", ids));
+  TEST_EQUAL(ids.count(), 0);
+  TEST(!readTrackIds("TRACKS;\n"
+                     "[ 0, -9223372036854775809 ], [ ], [ ];\n", ids));
+  TEST(!readTrackIds("TRACKS;\n"
+                     "[ 0, 18446744073709551617 ], [ ], [ ];\n", ids));
+  TEST(!readTrackIds("TRACKS;\n"
+                     "[ 2147483648, 1 ], [ ], [ ];\n", ids));
+  TEST(!readTrackIds("TRACKS;\n"
+                     "[ -2147483649, 1 ], [ ], [ ];\n", ids));
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  qtTest testObject;
+
+  if (argc < 2)
+    {
+    testObject.out() << "invocation error, path to test data files required\n";
+    return 1;
+    }
+  testFileBase = QString::fromLocal8Bit(argv[1]);
+
+  testObject.runSuite("Serial Read Tests",          testSerial);
+  testObject.runSuite("Parallel Read Tests",        testParallel);
+  testObject.runSuite("Read Control Tests",         testControl);
+  testObject.runSuite("Integer Range Tests",        testRange);
+  return testObject.result();
+}
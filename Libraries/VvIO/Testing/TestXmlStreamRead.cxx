@@ -0,0 +1,192 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <QDomDocument>
+#include <QFile>
+#include <QTextStream>
+#include <QUrl>
+
+#include <qtTest.h>
+
+#include <vvQueryResult.h>
+
+#include "../vvEventSetInfo.h"
+#include "../vvHeader.h"
+#include "../vvQueryInstance.h"
+#include "../vvWriter.h"
+#include "../vvXmlReader.h"
+
+QString testFileBase;
+
+//-----------------------------------------------------------------------------
+template <typename T>
+QString toXml(const T& data)
+{
+  QString out;
+  QTextStream stream(&out);
+  vvWriter(stream, vvWriter::Xml) << data;
+  return out;
+}
+
+//-----------------------------------------------------------------------------
+QDomNode loadDocument(qtTest& testObject, const QString& fileName,
+                      QDomDocument& doc)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text) ||
+      !doc.setContent(&file))
+    {
+    testObject.out() << "unable to load test file " << fileName << "\n";
+    return QDomNode();
+    }
+  return doc.documentElement().firstChildElement();
+}
+
+//-----------------------------------------------------------------------------
+// Read a list of items using both the DOM (external node) and stream (bound)
+// readers, and verify that the results are identical
+template <typename T>
+void compareList(
+  qtTest& testObject, const QString& suffix, int expectedCount,
+  bool (vvXmlReader::*domMethod)(QDomNode&, QList<T>&),
+  bool (vvXmlReader::*streamMethod)(QList<T>&))
+{
+  const QString fileName = testFileBase + suffix;
+
+  QDomDocument doc;
+  QDomNode node = loadDocument(testObject, fileName, doc);
+  vvXmlReader domReader;
+  QList<T> domItems;
+  TEST((domReader.*domMethod)(node, domItems));
+
+  vvXmlReader streamReader;
+  QList<T> streamItems;
+  TEST(streamReader.open(QUrl::fromLocalFile(fileName)));
+  TEST((streamReader.*streamMethod)(streamItems));
+  TEST(streamReader.atEnd());
+
+  TEST_EQUAL(streamItems.count(), expectedCount);
+  TEST_EQUAL(streamItems.count(), domItems.count());
+  TEST_EQUAL(toXml(streamItems), toXml(domItems));
+}
+
+//-----------------------------------------------------------------------------
+// As above, for a single item
+template <typename T>
+void compareItem(
+  qtTest& testObject, const QString& suffix,
+  bool (vvXmlReader::*domMethod)(QDomNode&, T&),
+  bool (vvXmlReader::*streamMethod)(T&))
+{
+  const QString fileName = testFileBase + suffix;
+
+  QDomDocument doc;
+  QDomNode node = loadDocument(testObject, fileName, doc);
+  vvXmlReader domReader;
+  T domItem;
+  TEST((domReader.*domMethod)(node, domItem));
+
+  vvXmlReader streamReader;
+  T streamItem;
+  TEST(streamReader.open(QUrl::fromLocalFile(fileName)));
+  TEST((streamReader.*streamMethod)(streamItem));
+
+  TEST_EQUAL(toXml(streamItem), toXml(domItem));
+}
+
+//-----------------------------------------------------------------------------
+int testEquivalence(qtTest& testObject)
+{
+  TEST_CALL(compareList<vvTrack>, "-a.vst.xml", 2,
+            &vvXmlReader::readTracks, &vvXmlReader::readTracks);
+  TEST_CALL(compareList<vvTrack>, "-b.vst.xml", 1,
+            &vvXmlReader::readTracks, &vvXmlReader::readTracks);
+  TEST_CALL(compareList<vvDescriptor>, ".vsd.xml", 3,
+            &vvXmlReader::readDescriptors, &vvXmlReader::readDescriptors);
+  TEST_CALL(compareList<vvQueryResult>, ".vqr.xml", 2,
+            &vvXmlReader::readQueryResults, &vvXmlReader::readQueryResults);
+
+  TEST_CALL(compareItem<vvQueryInstance>, "-a.vqp.xml",
+            &vvXmlReader::readQueryPlan, &vvXmlReader::readQueryPlan);
+  TEST_CALL(compareItem<vvQueryInstance>, "-b.vqp.xml",
+            &vvXmlReader::readQueryPlan, &vvXmlReader::readQueryPlan);
+  TEST_CALL(compareItem<vvQueryInstance>, "-c.vqp.xml",
+            &vvXmlReader::readQueryPlan, &vvXmlReader::readQueryPlan);
+  TEST_CALL(compareItem<vvEventSetInfo>, ".vem.xml",
+            &vvXmlReader::readEventSetInfo, &vvXmlReader::readEventSetInfo);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testIncremental(qtTest& testObject)
+{
+  vvXmlReader reader;
+  vvHeader header;
+  vvTrack track;
+
+  TEST(reader.open(QUrl::fromLocalFile(testFileBase + "-a.vst.xml")));
+
+  // Reading the header does not consume the first item
+  TEST(reader.readHeader(header));
+  TEST_EQUAL(header.type, vvHeader::Tracks);
+
+  TEST(reader.readTrack(track));
+  TEST_EQUAL(track.Id.SerialNumber, 1LL);
+  TEST(!reader.atEnd());
+  TEST(reader.readTrack(track));
+  TEST_EQUAL(track.Id.SerialNumber, 2LL);
+  TEST(reader.atEnd());
+  TEST(!reader.readTrack(track));
+
+  // Rewind and skip the first item
+  TEST(reader.rewind());
+  TEST(reader.advance());
+  TEST(reader.readTrack(track));
+  TEST_EQUAL(track.Id.SerialNumber, 2LL);
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int testErrors(qtTest& testObject)
+{
+  vvXmlReader reader;
+  QList<vvTrack> tracks;
+
+  // Bad root element
+  TEST(!reader.setInput("<foo><track/></foo>"));
+
+  // Wrong item type
+  TEST(reader.setInput("<xml><descriptor/></xml>"));
+  TEST(!reader.readTracks(tracks));
+
+  // Malformed document; items preceding the error are still read
+  vvTrack track;
+  TEST(reader.setInput("<xml><track source=\"0\" serial_number=\"1\"/>"
+                       "<track source=\"0\" serial_number=\"2\">"));
+  TEST(reader.readTrack(track));
+  TEST(!reader.readTrack(track));
+  TEST(!reader.error().isEmpty());
+
+  return 0;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+  qtTest testObject;
+
+  if (argc < 2)
+    {
+    testObject.out() << "invocation error, path to test data files required\n";
+    return 1;
+    }
+  testFileBase = QString::fromLocal8Bit(argv[1]);
+
+  testObject.runSuite("DOM Equivalence Tests",      testEquivalence);
+  testObject.runSuite("Incremental Read Tests",     testIncremental);
+  testObject.runSuite("Error Tests",                testErrors);
+  return testObject.result();
+}
@@ -0,0 +1,864 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vvBinaryReader.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QUrl>
+#include <QVector>
+#include <QtEndian>
+
+#include <qtStlUtil.h>
+
+#include <vvQueryResult.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "vvBinaryWriter.h"
+
+#define die(_msg) return this->abort(_msg)
+
+#define test_or_fail(_cond) if (!(_cond)) return false
+#define test_or_die(_cond, _msg) if (!(_cond)) die(_msg)
+
+QTE_IMPLEMENT_D_FUNC(vvBinaryReader)
+
+namespace // anonymous
+{
+
+// Minimum encoded sizes of various records; used to sanity check counts
+// before allocating storage for the records
+const size_t HeaderSize = 12;
+const size_t ChunkHeaderSize = 16;
+const size_t IndexEntrySize = 20;
+const size_t TrailerSize = 12;
+
+const size_t ClassificationSize = 4 + 8;
+const size_t TrackStateSize = 8 + 4 + 8 + 8 + 16 + 4 + 8 + 8 + 4;
+const size_t RegionSize = 8 + 4 + 16;
+const size_t TrackIdSize = 4 + 8;
+
+//-----------------------------------------------------------------------------
+class Decoder
+{
+public:
+  Decoder(const char* begin, const char* end) : pos(begin), end(end) {}
+
+  const char* position() const { return this->pos; }
+  size_t remaining() const
+    { return static_cast<size_t>(this->end - this->pos); }
+
+  bool get(qint32& value)  { return this->getRaw(value); }
+  bool get(quint32& value) { return this->getRaw(value); }
+  bool get(qint64& value)  { return this->getRaw(value); }
+  bool get(quint64& value) { return this->getRaw(value); }
+
+  bool get(double& value);
+  bool get(std::string& value);
+
+  bool getMagic(const char* magic);
+  bool getCount(size_t& count, size_t elementSize);
+  bool getBlock(float* values, size_t count);
+
+  template <typename T, typename Container, typename Setter>
+  bool getColumn(Container& items, Setter setter);
+
+  bool getBoxColumns(std::vector<vvImageBoundingBox>& boxes);
+
+protected:
+  template <typename T> bool getRaw(T& value);
+
+  const char* pos;
+  const char* end;
+};
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool Decoder::getRaw(T& value)
+{
+  test_or_fail(this->remaining() >= sizeof(T));
+  value = qFromLittleEndian<T>(reinterpret_cast<const uchar*>(this->pos));
+  this->pos += sizeof(T);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::get(double& value)
+{
+  quint64 bits;
+  test_or_fail(this->getRaw(bits));
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::get(std::string& value)
+{
+  size_t size;
+  test_or_fail(this->getCount(size, 1));
+  value.assign(this->pos, size);
+  this->pos += size;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::getMagic(const char* magic)
+{
+  test_or_fail(this->remaining() >= 4 && memcmp(this->pos, magic, 4) == 0);
+  this->pos += 4;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::getCount(size_t& count, size_t elementSize)
+{
+  quint32 rawCount;
+  test_or_fail(this->getRaw(rawCount));
+  count = static_cast<size_t>(rawCount);
+  return count * elementSize <= this->remaining();
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::getBlock(float* values, size_t count)
+{
+  test_or_fail(this->remaining() >= count * sizeof(float));
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  if (count)
+    {
+    memcpy(values, this->pos, count * sizeof(float));
+    this->pos += count * sizeof(float);
+    }
+#else
+  for (size_t i = 0; i < count; ++i)
+    {
+    quint32 bits;
+    this->getRaw(bits);
+    memcpy(values + i, &bits, sizeof(float));
+    }
+#endif
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename Container, typename Setter>
+bool Decoder::getColumn(Container& items, Setter setter)
+{
+  T value;
+  foreach_iter (typename Container::iterator, iter, items)
+    {
+    test_or_fail(this->get(value));
+    setter(*iter, value);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::getBoxColumns(std::vector<vvImageBoundingBox>& boxes)
+{
+  typedef vvImageBoundingBox& Box;
+  return this->getColumn<qint32>(boxes, [](Box b, qint32 v){
+                                   b.TopLeft.X = v; }) &&
+         this->getColumn<qint32>(boxes, [](Box b, qint32 v){
+                                   b.TopLeft.Y = v; }) &&
+         this->getColumn<qint32>(boxes, [](Box b, qint32 v){
+                                   b.BottomRight.X = v; }) &&
+         this->getColumn<qint32>(boxes, [](Box b, qint32 v){
+                                   b.BottomRight.Y = v; });
+}
+
+//-----------------------------------------------------------------------------
+bool decode(Decoder& in, vvTrack& track)
+{
+  typedef vvTrackState& State;
+
+  track = vvTrack();
+
+  qint32 source;
+  qint64 serialNumber;
+  test_or_fail(in.get(source) && in.get(serialNumber));
+  track.Id = vvTrackId(source, serialNumber);
+
+  // Read classification
+  size_t count;
+  test_or_fail(in.getCount(count, ClassificationSize));
+  for (size_t i = 0; i < count; ++i)
+    {
+    std::string type;
+    double probability;
+    test_or_fail(in.get(type) && in.get(probability));
+    track.Classification.insert(std::make_pair(type, probability));
+    }
+
+  // Read trajectory columns
+  test_or_fail(in.getCount(count, TrackStateSize));
+  std::vector<vvTrackState> states(count);
+  std::vector<vvImageBoundingBox> boxes(count);
+  std::vector<quint32> objectSizes(count);
+  test_or_fail(
+    in.getColumn<double>(states, [](State s, double v){
+                           s.TimeStamp.Time = v; }) &&
+    in.getColumn<quint32>(states, [](State s, quint32 v){
+                            s.TimeStamp.FrameNumber = v; }) &&
+    in.getColumn<double>(states, [](State s, double v){
+                           s.ImagePoint.X = v; }) &&
+    in.getColumn<double>(states, [](State s, double v){
+                           s.ImagePoint.Y = v; }) &&
+    in.getBoxColumns(boxes) &&
+    in.getColumn<qint32>(states, [](State s, qint32 v){
+                           s.WorldLocation.GCS = v; }) &&
+    in.getColumn<double>(states, [](State s, double v){
+                           s.WorldLocation.Northing = v; }) &&
+    in.getColumn<double>(states, [](State s, double v){
+                           s.WorldLocation.Easting = v; }) &&
+    in.getColumn<quint32>(objectSizes, [](quint32& s, quint32 v){ s = v; }));
+
+  for (size_t i = 0; i < count; ++i)
+    {
+    vvTrackState& state = states[i];
+    state.ImageBox = boxes[i];
+
+    const size_t objectSize = static_cast<size_t>(objectSizes[i]);
+    test_or_fail(objectSize * 2 * sizeof(double) <= in.remaining());
+    state.ImageObject.resize(objectSize);
+    foreach_iter (vvImagePolygonF::iterator, pi, state.ImageObject)
+      {
+      test_or_fail(in.get(pi->X) && in.get(pi->Y));
+      }
+    }
+
+  // States are written in order, so this is linear
+  track.Trajectory.insert(states.begin(), states.end());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool decode(Decoder& in, vvDescriptor& descriptor)
+{
+  typedef vvDescriptorRegionEntry& Region;
+  typedef vvTrackId& TrackId;
+
+  descriptor = vvDescriptor();
+
+  qint64 instanceId;
+  test_or_fail(in.get(descriptor.DescriptorName) &&
+               in.get(descriptor.ModuleName) &&
+               in.get(instanceId) &&
+               in.get(descriptor.Confidence));
+  descriptor.InstanceId = instanceId;
+
+  // Read value sizes, and check that the values they describe are present
+  // before allocating anything for them
+  size_t count;
+  test_or_fail(in.getCount(count, sizeof(quint32)));
+  std::vector<quint32> valueSizes(count);
+  test_or_fail(in.getColumn<quint32>(valueSizes, [](quint32& s, quint32 v){
+                                       s = v; }));
+  size_t available = in.remaining() / sizeof(float);
+  foreach_iter (std::vector<quint32>::const_iterator, iter, valueSizes)
+    {
+    const size_t size = static_cast<size_t>(*iter);
+    test_or_fail(size <= available);
+    available -= size;
+    }
+
+  // Read values
+  descriptor.Values.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    {
+    std::vector<float>& values = descriptor.Values[i];
+    values.resize(valueSizes[i]);
+    if (!values.empty())
+      {
+      test_or_fail(in.getBlock(&values[0], values.size()));
+      }
+    }
+
+  // Read regions
+  test_or_fail(in.getCount(count, RegionSize));
+  std::vector<vvDescriptorRegionEntry> regions(count);
+  std::vector<vvImageBoundingBox> boxes(count);
+  test_or_fail(
+    in.getColumn<double>(regions, [](Region r, double v){
+                           r.TimeStamp.Time = v; }) &&
+    in.getColumn<quint32>(regions, [](Region r, quint32 v){
+                            r.TimeStamp.FrameNumber = v; }) &&
+    in.getBoxColumns(boxes));
+  for (size_t i = 0; i < count; ++i)
+    {
+    regions[i].ImageRegion = boxes[i];
+    }
+  descriptor.Region.insert(regions.begin(), regions.end());
+
+  // Read track ID's
+  test_or_fail(in.getCount(count, TrackIdSize));
+  descriptor.TrackIds.resize(count);
+  return
+    in.getColumn<qint32>(descriptor.TrackIds, [](TrackId id, qint32 v){
+                           id.Source = v; }) &&
+    in.getColumn<qint64>(descriptor.TrackIds, [](TrackId id, qint64 v){
+                           id.SerialNumber = v; });
+}
+
+//-----------------------------------------------------------------------------
+bool decode(Decoder& in, vvQueryResult& result)
+{
+  result = vvQueryResult();
+
+  qint64 instanceId, startTime, endTime, rank;
+  qint32 gcs, userScore, userFlags;
+  test_or_fail(in.get(result.MissionId) &&
+               in.get(result.QueryId) &&
+               in.get(result.StreamId) &&
+               in.get(instanceId) &&
+               in.get(startTime) &&
+               in.get(endTime) &&
+               in.get(gcs) &&
+               in.get(result.Location.Northing) &&
+               in.get(result.Location.Easting) &&
+               in.get(rank) &&
+               in.get(result.RelevancyScore) &&
+               in.get(result.PreferenceScore) &&
+               in.get(userScore) &&
+               in.get(userFlags) &&
+               in.get(result.UserData.Notes));
+
+  result.InstanceId = instanceId;
+  result.StartTime = startTime;
+  result.EndTime = endTime;
+  result.Location.GCS = gcs;
+  result.Rank = rank;
+  result.UserScore = static_cast<vvIqr::Classification>(userScore);
+  result.UserData.Flags = static_cast<vvUserData::Flag>(userFlags);
+
+  size_t count;
+  test_or_fail(in.getCount(count, 1));
+  result.Tracks.resize(count);
+  foreach_iter (std::vector<vvTrack>::iterator, iter, result.Tracks)
+    {
+    test_or_fail(decode(in, *iter));
+    }
+
+  test_or_fail(in.getCount(count, 1));
+  result.Descriptors.resize(count);
+  foreach_iter (std::vector<vvDescriptor>::iterator, iter, result.Descriptors)
+    {
+    test_or_fail(decode(in, *iter));
+    }
+
+  return true;
+}
+
+} // namespace <anonymous>
+
+//BEGIN vvBinaryReaderPrivate
+
+//-----------------------------------------------------------------------------
+class vvBinaryReaderPrivate
+{
+public:
+  struct Chunk
+    {
+    const char* begin;
+    const char* end;
+    qint64 firstItem;
+    qint64 count;
+
+    bool operator<(qint64 item) const
+      { return this->firstItem + this->count <= item; }
+    };
+
+  vvBinaryReaderPrivate();
+
+  bool abort(const QString&);
+  void reset();
+
+  bool load();
+  bool loadIndex();
+  bool scanChunks();
+  bool readChunk(Decoder& in, qint64 firstItem, Chunk& chunk);
+
+  bool seek(qint64 item);
+  bool nextItem(const char*& begin, const char*& end);
+
+  template <typename T>
+  bool read(T& result, vvHeader::FileType type);
+  template <typename L>
+  bool readItems(L& list, vvHeader::FileType type);
+
+  QFile file;
+  QByteArray buffer;
+  const char* begin;
+  const char* end;
+
+  vvHeader header;
+  QVector<Chunk> chunks;
+  qint64 itemCount;
+
+  int chunk;
+  const char* pos;
+  qint64 item;
+
+  QString lastError;
+};
+
+//-----------------------------------------------------------------------------
+vvBinaryReaderPrivate::vvBinaryReaderPrivate()
+  : begin(0), end(0), itemCount(0), chunk(0), pos(0), item(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::abort(const QString& error)
+{
+  qDebug() << "vvBinaryReader:" << qPrintable(error);
+  this->lastError = error;
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryReaderPrivate::reset()
+{
+  this->file.close();
+  this->buffer.clear();
+  this->begin = this->end = 0;
+  this->header = vvHeader();
+  this->chunks.clear();
+  this->itemCount = 0;
+  this->chunk = 0;
+  this->pos = 0;
+  this->item = 0;
+  this->lastError.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::load()
+{
+  Decoder in(this->begin, this->end);
+  quint32 version, type;
+  if (!in.getMagic(vvBinaryWriter::FileMagic) ||
+      !in.get(version) || !in.get(type))
+    {
+    this->reset();
+    die("Unrecognized file format");
+    }
+
+  if (version > vvBinaryWriter::FormatVersion)
+    {
+    this->reset();
+    die("Unable to read binary archive version " + QString::number(version)
+        + ": latest recognized version is "
+        + QString::number(vvBinaryWriter::FormatVersion));
+    }
+
+  this->header.type = static_cast<vvHeader::FileType>(type);
+  this->header.version = version;
+
+  // Use the index if it is present and valid; otherwise (e.g. the writer did
+  // not finish), walk the chunks to rebuild it
+  if (!this->loadIndex())
+    {
+    qDebug() << "vvBinaryReader: archive index is missing or invalid;"
+                " scanning chunks";
+    this->chunks.clear();
+    this->itemCount = 0;
+    if (!this->scanChunks())
+      {
+      this->reset();
+      die("Archive is corrupt");
+      }
+    }
+
+  return this->seek(0);
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::readChunk(
+  Decoder& in, qint64 firstItem, Chunk& chunk)
+{
+  quint32 count;
+  quint64 size;
+  test_or_fail(in.getMagic(vvBinaryWriter::ChunkMagic) &&
+               in.get(count) && in.get(size));
+  test_or_fail(count > 0 && size <= in.remaining());
+
+  chunk.begin = in.position();
+  chunk.end = chunk.begin + size;
+  chunk.firstItem = firstItem;
+  chunk.count = count;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::loadIndex()
+{
+  const size_t size = static_cast<size_t>(this->end - this->begin);
+  test_or_fail(size >= HeaderSize + TrailerSize);
+
+  Decoder trailer(this->end - TrailerSize, this->end);
+  quint64 indexOffset;
+  test_or_fail(trailer.get(indexOffset) &&
+               trailer.getMagic(vvBinaryWriter::TrailerMagic));
+  test_or_fail(indexOffset >= HeaderSize &&
+               indexOffset <= size - TrailerSize);
+
+  Decoder in(this->begin + indexOffset, this->end - TrailerSize);
+  size_t count;
+  test_or_fail(in.getMagic(vvBinaryWriter::IndexMagic) &&
+               in.getCount(count, IndexEntrySize));
+
+  this->chunks.reserve(static_cast<int>(count));
+  for (size_t i = 0; i < count; ++i)
+    {
+    quint64 offset, firstItem;
+    quint32 itemCount;
+    test_or_fail(in.get(offset) && in.get(firstItem) && in.get(itemCount));
+    test_or_fail(offset + ChunkHeaderSize <= indexOffset &&
+                 firstItem == static_cast<quint64>(this->itemCount));
+
+    Chunk chunk;
+    Decoder chunkIn(this->begin + offset, this->begin + indexOffset);
+    test_or_fail(this->readChunk(chunkIn, this->itemCount, chunk));
+    test_or_fail(chunk.count == itemCount);
+
+    this->chunks.append(chunk);
+    this->itemCount += chunk.count;
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::scanChunks()
+{
+  Decoder in(this->begin + HeaderSize, this->end);
+  while (in.remaining() >= ChunkHeaderSize)
+    {
+    Chunk chunk;
+    if (!this->readChunk(in, this->itemCount, chunk))
+      {
+      // Stop at the index, or at an incomplete chunk
+      break;
+      }
+
+    this->chunks.append(chunk);
+    this->itemCount += chunk.count;
+    in = Decoder(chunk.end, this->end);
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::seek(qint64 item)
+{
+  test_or_die(this->begin, "No data is available");
+  test_or_die(item >= 0 && item <= this->itemCount,
+              "Item " + QString::number(item) + " is out of range");
+
+  this->item = 0;
+  this->chunk = 0;
+  this->pos = (this->chunks.isEmpty() ? 0 : this->chunks.first().begin);
+  if (item == 0)
+    {
+    return true;
+    }
+
+  // Find the chunk containing the requested item
+  const QVector<Chunk>::const_iterator iter =
+    std::lower_bound(this->chunks.constBegin(), this->chunks.constEnd(),
+                     item);
+  if (iter == this->chunks.constEnd())
+    {
+    // Position at end of data
+    this->chunk = this->chunks.count() - 1;
+    this->pos = this->chunks.last().end;
+    this->item = this->itemCount;
+    return true;
+    }
+
+  this->chunk = static_cast<int>(iter - this->chunks.constBegin());
+  this->pos = iter->begin;
+  this->item = iter->firstItem;
+
+  // Skip preceding items in the chunk
+  const char* itemBegin;
+  const char* itemEnd;
+  while (this->item < item)
+    {
+    test_or_fail(this->nextItem(itemBegin, itemEnd));
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReaderPrivate::nextItem(const char*& begin, const char*& end)
+{
+  test_or_die(this->begin, "No data is available");
+  test_or_die(this->item < this->itemCount,
+              "Read position is at end of data");
+
+  // Move to next chunk, if at end of current chunk
+  if (this->pos == this->chunks[this->chunk].end)
+    {
+    ++this->chunk;
+    this->pos = this->chunks[this->chunk].begin;
+    }
+
+  Decoder in(this->pos, this->chunks[this->chunk].end);
+  quint32 size;
+  test_or_die(in.get(size) && size <= in.remaining(),
+              "Item " + QString::number(this->item) + " is truncated");
+
+  begin = in.position();
+  end = begin + size;
+  this->pos = end;
+  ++this->item;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool vvBinaryReaderPrivate::read(T& result, vvHeader::FileType type)
+{
+  test_or_die(this->begin, "No data is available");
+  test_or_die(this->header.type == type,
+              "Header type does not match requested data type");
+
+  const char* itemBegin;
+  const char* itemEnd;
+  test_or_fail(this->nextItem(itemBegin, itemEnd));
+
+  Decoder in(itemBegin, itemEnd);
+  test_or_die(decode(in, result),
+              "Error decoding item " + QString::number(this->item - 1));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename L>
+bool vvBinaryReaderPrivate::readItems(L& list, vvHeader::FileType type)
+{
+  test_or_die(this->begin, "No data is available");
+  test_or_die(this->item < this->itemCount,
+              "Read position is at end of data");
+
+  list.clear();
+  list.reserve(static_cast<int>(this->itemCount - this->item));
+  while (this->item < this->itemCount)
+    {
+    // Read item
+    typename L::value_type item;
+    test_or_fail(this->read(item, type));
+    list.push_back(item);
+    }
+
+  return true;
+}
+
+//END vvBinaryReaderPrivate
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvBinaryReader general
+
+//-----------------------------------------------------------------------------
+vvBinaryReader::vvBinaryReader() : d_ptr(new vvBinaryReaderPrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+vvBinaryReader::~vvBinaryReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::abort(const QString& error)
+{
+  QTE_D(vvBinaryReader);
+  return d->abort(error);
+}
+
+//-----------------------------------------------------------------------------
+QString vvBinaryReader::error()
+{
+  QTE_D(vvBinaryReader);
+  return d->lastError;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::open(const QUrl& uri, vvReader::Format format)
+{
+  test_or_die(format == Auto || format == Binary,
+              "Requested format not supported");
+
+  QTE_D(vvBinaryReader);
+  d->reset();
+
+  d->file.setFileName(uri.toLocalFile());
+  test_or_die(d->file.open(QIODevice::ReadOnly),
+              "Unable to open \"" + uri.toString() + "\": "
+              + d->file.errorString());
+
+  // Map the file; if that fails (e.g. the file is not a regular file), fall
+  // back to reading it into memory
+  const qint64 size = d->file.size();
+  const uchar* const data = (size > 0 ? d->file.map(0, size) : 0);
+  if (!data)
+    {
+    const QByteArray contents = d->file.readAll();
+    d->file.close();
+    return this->setInput(contents);
+    }
+
+  d->begin = reinterpret_cast<const char*>(data);
+  d->end = d->begin + size;
+  return d->load();
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::setInput(const QString&, vvReader::Format)
+{
+  QTE_D(vvBinaryReader);
+  d->reset();
+  die("Binary archives cannot be read from text input");
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::setInput(const QByteArray& data)
+{
+  QTE_D(vvBinaryReader);
+  d->reset();
+
+  d->buffer = data;
+  d->begin = d->buffer.constData();
+  d->end = d->begin + d->buffer.size();
+  return d->load();
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryReader::setHeader(const vvHeader&)
+{
+  // Header is always taken from the archive
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::rewind()
+{
+  QTE_D(vvBinaryReader);
+  return d->seek(0);
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::advance()
+{
+  QTE_D(vvBinaryReader);
+  const char* itemBegin;
+  const char* itemEnd;
+  return d->nextItem(itemBegin, itemEnd);
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::atEnd() const
+{
+  QTE_D_CONST(vvBinaryReader);
+  return (!d->begin || d->item >= d->itemCount);
+}
+
+//-----------------------------------------------------------------------------
+qint64 vvBinaryReader::itemCount() const
+{
+  QTE_D_CONST(vvBinaryReader);
+  return d->itemCount;
+}
+
+//-----------------------------------------------------------------------------
+qint64 vvBinaryReader::position() const
+{
+  QTE_D_CONST(vvBinaryReader);
+  return d->item;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::seek(qint64 item)
+{
+  QTE_D(vvBinaryReader);
+  return d->seek(item);
+}
+
+//END vvBinaryReader general
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvBinaryReader bound data readers
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::readHeader(vvHeader& header)
+{
+  QTE_D(vvBinaryReader);
+
+  test_or_die(d->begin, "No data is available");
+  header = d->header;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+#define vvBinaryReader_Implement_Read(_name, _type, _htype) \
+  bool vvBinaryReader::read##_name(_type& data) \
+  { \
+    QTE_D(vvBinaryReader); \
+    return d->read(data, vvHeader::_htype); \
+  }
+
+vvBinaryReader_Implement_Read(Track,        vvTrack,        Tracks)
+vvBinaryReader_Implement_Read(Descriptor,   vvDescriptor,   Descriptors)
+vvBinaryReader_Implement_Read(QueryResult,  vvQueryResult,  QueryResults)
+
+//-----------------------------------------------------------------------------
+#define vvBinaryReader_Implement_Unsupported(_name, _type, _what) \
+  bool vvBinaryReader::read##_name(_type&) \
+  { \
+    die(_what " are not supported by binary archives"); \
+  }
+
+vvBinaryReader_Implement_Unsupported(QueryPlan, vvQueryInstance,
+                                     "Query plans")
+vvBinaryReader_Implement_Unsupported(QueryPlan, vvRetrievalQuery,
+                                     "Query plans")
+vvBinaryReader_Implement_Unsupported(QueryPlan, vvSimilarityQuery,
+                                     "Query plans")
+vvBinaryReader_Implement_Unsupported(EventSetInfo, vvEventSetInfo,
+                                     "Event set descriptions")
+
+//-----------------------------------------------------------------------------
+bool vvBinaryReader::readGeoPoly(
+  vgGeocodedPoly&, vvDatabaseQuery::IntersectionType*)
+{
+  die("Geospatial polygons are not supported by binary archives");
+}
+
+//END vvBinaryReader bound data readers
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvBinaryReader array helpers
+
+#define vvBinaryReader_Implement_ReadTypedArray(_name, _type, _list) \
+  bool vvBinaryReader::read##_name##s(_list<_type>& list) \
+  { \
+    QTE_D(vvBinaryReader); \
+    return d->readItems(list, vvHeader::_name##s); \
+  }
+
+#define vvBinaryReader_Implement_ReadArray(_name, _type) \
+  vvBinaryReader_Implement_ReadTypedArray(_name, _type, std::vector) \
+  vvBinaryReader_Implement_ReadTypedArray(_name, _type, QList)
+
+vvBinaryReader_Implement_ReadArray(Track, vvTrack)
+vvBinaryReader_Implement_ReadArray(Descriptor, vvDescriptor)
+vvBinaryReader_Implement_ReadArray(QueryResult, vvQueryResult)
+
+//END vvBinaryReader array helpers
@@ -0,0 +1,95 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vvBinaryReader_h
+#define __vvBinaryReader_h
+
+#include <vgExport.h>
+
+#include "vvReader.h"
+
+class QByteArray;
+
+class vvBinaryReaderPrivate;
+
+/// Reader for binary archives written by vvBinaryWriter.
+///
+/// When reading from a file, the file is memory mapped, and items are decoded
+/// directly from the mapped data. The archive header is read when the input
+/// is set; calling readHeader() is not required, and setHeader() has no
+/// effect. The chunk index allows seeking directly to any item.
+class VV_IO_EXPORT vvBinaryReader : public vvReader
+{
+public:
+  vvBinaryReader();
+  virtual ~vvBinaryReader();
+
+  virtual QString error();
+
+  // Data binding
+  virtual bool open(const QUrl&, Format format = Binary);
+  virtual bool setInput(const QString&, Format format = Binary);
+
+  /// Read from an in-memory buffer.
+  ///
+  /// The reader keeps a (shallow) copy of \p data.
+  bool setInput(const QByteArray& data);
+
+  virtual void setHeader(const vvHeader&);
+
+  // Random access
+  virtual bool rewind();
+  virtual bool advance();
+  virtual bool atEnd() const;
+
+  /// Get number of items in the archive.
+  qint64 itemCount() const;
+
+  /// Get index of the item that will be read next.
+  qint64 position() const;
+
+  /// Move read position to the specified item.
+  bool seek(qint64 item);
+
+  // Bound data readers
+  virtual bool readHeader(vvHeader& header);
+
+  virtual bool readTrack(vvTrack& track);
+  virtual bool readDescriptor(vvDescriptor& descriptor);
+
+  virtual bool readQueryPlan(vvQueryInstance& query);
+  virtual bool readQueryPlan(vvRetrievalQuery& query);
+  virtual bool readQueryPlan(vvSimilarityQuery& query);
+
+  virtual bool readQueryResult(vvQueryResult& result);
+
+  virtual bool readGeoPoly(vgGeocodedPoly& poly,
+                           vvDatabaseQuery::IntersectionType* filterMode = 0);
+
+  virtual bool readEventSetInfo(vvEventSetInfo& info);
+
+  // Array helpers
+#define vvBinaryReader_ReadArray(_name, _type) \
+  virtual bool read##_name(std::vector<_type>& list); \
+  virtual bool read##_name(QList<_type>& list)
+
+  vvBinaryReader_ReadArray(Tracks, vvTrack);
+  vvBinaryReader_ReadArray(Descriptors, vvDescriptor);
+  vvBinaryReader_ReadArray(QueryResults, vvQueryResult);
+
+#undef vvBinaryReader_ReadArray
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vvBinaryReader)
+
+  using vvReader::open;
+
+  bool abort(const QString&);
+
+private:
+  QTE_DECLARE_PRIVATE(vvBinaryReader)
+  Q_DISABLE_COPY(vvBinaryReader)
+};
+
+#endif
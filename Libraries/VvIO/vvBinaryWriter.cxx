@@ -0,0 +1,503 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vvBinaryWriter.h"
+
+#include <QDebug>
+#include <QIODevice>
+#include <QtEndian>
+
+#include <qtStlUtil.h>
+
+#include <cstring>
+
+QTE_IMPLEMENT_D_FUNC(vvBinaryWriter)
+
+// Archive layout (all values little-endian):
+//
+//   header:  magic "VVBA", u32 format version, u32 file type
+//   chunk:   magic "VVBC", u32 item count, u64 payload size, payload
+//   item:    u32 item size, item data
+//   index:   magic "VVBI", u32 chunk count,
+//            { u64 chunk offset, u64 first item, u32 item count }...
+//   trailer: u64 index offset, magic "VVBE"
+//
+// Offsets are relative to the start of the archive.
+
+//-----------------------------------------------------------------------------
+const unsigned int vvBinaryWriter::FormatVersion = 1;
+
+const char* const vvBinaryWriter::FileMagic = "VVBA";
+const char* const vvBinaryWriter::ChunkMagic = "VVBC";
+const char* const vvBinaryWriter::IndexMagic = "VVBI";
+const char* const vvBinaryWriter::TrailerMagic = "VVBE";
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void putRaw(QByteArray& out, T value)
+{
+  uchar bytes[sizeof(T)];
+  qToLittleEndian<T>(value, bytes);
+  out.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+}
+
+//-----------------------------------------------------------------------------
+void put(QByteArray& out, qint32 value)  { putRaw(out, value); }
+void put(QByteArray& out, quint32 value) { putRaw(out, value); }
+void put(QByteArray& out, qint64 value)  { putRaw(out, value); }
+void put(QByteArray& out, quint64 value) { putRaw(out, value); }
+
+//-----------------------------------------------------------------------------
+void put(QByteArray& out, double value)
+{
+  quint64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  putRaw(out, bits);
+}
+
+//-----------------------------------------------------------------------------
+void put(QByteArray& out, const std::string& value)
+{
+  put(out, static_cast<quint32>(value.size()));
+  out.append(value.data(), static_cast<int>(value.size()));
+}
+
+//-----------------------------------------------------------------------------
+void putCount(QByteArray& out, size_t count)
+{
+  put(out, static_cast<quint32>(count));
+}
+
+//-----------------------------------------------------------------------------
+void putBlock(QByteArray& out, const std::vector<float>& values)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+  if (!values.empty())
+    {
+    out.append(reinterpret_cast<const char*>(&values[0]),
+               static_cast<int>(values.size() * sizeof(float)));
+    }
+#else
+  foreach_iter (std::vector<float>::const_iterator, iter, values)
+    {
+    quint32 bits;
+    memcpy(&bits, &(*iter), sizeof(bits));
+    putRaw(out, bits);
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------
+template <typename T, typename Container, typename Accessor>
+void putColumn(QByteArray& out, const Container& items, Accessor accessor)
+{
+  foreach_iter (typename Container::const_iterator, iter, items)
+    {
+    put(out, static_cast<T>(accessor(*iter)));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void putBoxColumns(QByteArray& out, const std::vector<vvImageBoundingBox>& b)
+{
+  typedef const vvImageBoundingBox& Box;
+  putColumn<qint32>(out, b, [](Box box){ return box.TopLeft.X; });
+  putColumn<qint32>(out, b, [](Box box){ return box.TopLeft.Y; });
+  putColumn<qint32>(out, b, [](Box box){ return box.BottomRight.X; });
+  putColumn<qint32>(out, b, [](Box box){ return box.BottomRight.Y; });
+}
+
+} // namespace <anonymous>
+
+//BEGIN vvBinaryWriterPrivate
+
+//-----------------------------------------------------------------------------
+class vvBinaryWriterPrivate
+{
+public:
+  struct ChunkInfo
+    {
+    quint64 offset;
+    quint64 firstItem;
+    quint32 count;
+    };
+
+  vvBinaryWriterPrivate(QIODevice* device, int chunkSize);
+
+  void writeHeader();
+  bool begin(vvHeader::FileType);
+  void end();
+  void flushChunk();
+  void finish();
+  void write(const QByteArray&);
+
+  void writeTrack(QByteArray& out, const vvTrack&);
+  void writeDescriptor(QByteArray& out, const vvDescriptor&);
+  void writeQueryResult(QByteArray& out, const vvQueryResult&);
+
+  QIODevice* device;
+  int chunkSize;
+
+  vvHeader::FileType type;
+  bool headerWritten;
+
+  QByteArray chunk;
+  quint32 chunkItems;
+  int itemStart;
+
+  quint64 offset;
+  quint64 itemCount;
+  QList<ChunkInfo> index;
+};
+
+//-----------------------------------------------------------------------------
+vvBinaryWriterPrivate::vvBinaryWriterPrivate(QIODevice* device, int chunkSize)
+  : device(device), chunkSize(qMax(1, chunkSize)),
+    type(vvHeader::Unknown), headerWritten(false),
+    chunkItems(0), itemStart(0), offset(0), itemCount(0)
+{
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::write(const QByteArray& data)
+{
+  this->device->write(data);
+  this->offset += static_cast<quint64>(data.size());
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::writeHeader()
+{
+  QByteArray header(vvBinaryWriter::FileMagic, 4);
+  put(header, static_cast<quint32>(vvBinaryWriter::FormatVersion));
+  put(header, static_cast<quint32>(this->type));
+  this->write(header);
+  this->headerWritten = true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvBinaryWriterPrivate::begin(vvHeader::FileType itemType)
+{
+  if (!this->headerWritten)
+    {
+    // If no file type was given, take it from the first item
+    if (this->type == vvHeader::Unknown)
+      {
+      this->type = itemType;
+      }
+    this->writeHeader();
+    }
+
+  if (itemType != this->type)
+    {
+    qWarning() << "vvBinaryWriter: item type" << itemType
+               << "does not match archive type" << this->type
+               << "- item will not be written";
+    return false;
+    }
+
+  // Reserve space for the item size, which is filled in by end()
+  this->itemStart = this->chunk.size();
+  put(this->chunk, static_cast<quint32>(0));
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::end()
+{
+  const int dataStart = this->itemStart + static_cast<int>(sizeof(quint32));
+  const quint32 size = static_cast<quint32>(this->chunk.size() - dataStart);
+  qToLittleEndian<quint32>(
+    size, reinterpret_cast<uchar*>(this->chunk.data() + this->itemStart));
+
+  ++this->chunkItems;
+  if (this->chunkItems >= static_cast<quint32>(this->chunkSize))
+    {
+    this->flushChunk();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::flushChunk()
+{
+  if (!this->chunkItems)
+    {
+    return;
+    }
+
+  ChunkInfo info;
+  info.offset = this->offset;
+  info.firstItem = this->itemCount;
+  info.count = this->chunkItems;
+  this->index.append(info);
+
+  QByteArray header(vvBinaryWriter::ChunkMagic, 4);
+  put(header, this->chunkItems);
+  put(header, static_cast<quint64>(this->chunk.size()));
+  this->write(header);
+  this->write(this->chunk);
+
+  this->itemCount += this->chunkItems;
+  this->chunkItems = 0;
+  this->chunk.clear();
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::finish()
+{
+  if (!this->headerWritten && this->type == vvHeader::Unknown)
+    {
+    // Nothing was written; don't create an empty archive
+    return;
+    }
+
+  // Write header (if there were no items) and any buffered items
+  if (!this->headerWritten)
+    {
+    this->writeHeader();
+    }
+  this->flushChunk();
+
+  // Write index
+  const quint64 indexOffset = this->offset;
+  QByteArray index(vvBinaryWriter::IndexMagic, 4);
+  putCount(index, static_cast<size_t>(this->index.count()));
+  foreach (const ChunkInfo& info, this->index)
+    {
+    put(index, info.offset);
+    put(index, info.firstItem);
+    put(index, info.count);
+    }
+
+  // Write trailer
+  put(index, indexOffset);
+  index.append(vvBinaryWriter::TrailerMagic, 4);
+  this->write(index);
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::writeTrack(QByteArray& out, const vvTrack& track)
+{
+  typedef const vvTrackState& State;
+
+  put(out, static_cast<qint32>(track.Id.Source));
+  put(out, static_cast<qint64>(track.Id.SerialNumber));
+
+  // Write classification
+  putCount(out, track.Classification.size());
+  typedef vvTrackObjectClassification::const_iterator ClassificationIterator;
+  foreach_iter (ClassificationIterator, iter, track.Classification)
+    {
+    put(out, iter->first);
+    put(out, iter->second);
+    }
+
+  // Write trajectory, one column at a time
+  const vvTrackTrajectory& t = track.Trajectory;
+  putCount(out, t.size());
+  putColumn<double>(out, t, [](State s){ return s.TimeStamp.Time; });
+  putColumn<quint32>(out, t, [](State s){ return s.TimeStamp.FrameNumber; });
+  putColumn<double>(out, t, [](State s){ return s.ImagePoint.X; });
+  putColumn<double>(out, t, [](State s){ return s.ImagePoint.Y; });
+
+  std::vector<vvImageBoundingBox> boxes;
+  boxes.reserve(t.size());
+  foreach_iter (vvTrackTrajectory::const_iterator, iter, t)
+    {
+    boxes.push_back(iter->ImageBox);
+    }
+  putBoxColumns(out, boxes);
+
+  putColumn<qint32>(out, t, [](State s){ return s.WorldLocation.GCS; });
+  putColumn<double>(out, t, [](State s){ return s.WorldLocation.Northing; });
+  putColumn<double>(out, t, [](State s){ return s.WorldLocation.Easting; });
+
+  // Write object polygons; first the point counts, then all of the points
+  putColumn<quint32>(out, t, [](State s){ return s.ImageObject.size(); });
+  foreach_iter (vvTrackTrajectory::const_iterator, iter, t)
+    {
+    foreach_iter (vvImagePolygonF::const_iterator, pi, iter->ImageObject)
+      {
+      put(out, pi->X);
+      put(out, pi->Y);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::writeDescriptor(
+  QByteArray& out, const vvDescriptor& descriptor)
+{
+  typedef const vvDescriptorRegionEntry& Region;
+  typedef const vvTrackId& TrackId;
+
+  put(out, descriptor.DescriptorName);
+  put(out, descriptor.ModuleName);
+  put(out, static_cast<qint64>(descriptor.InstanceId));
+  put(out, descriptor.Confidence);
+
+  // Write value vector sizes, followed by all values as a single block
+  putCount(out, descriptor.Values.size());
+  putColumn<quint32>(out, descriptor.Values,
+                     [](const std::vector<float>& v){ return v.size(); });
+  foreach_iter (std::vector<std::vector<float> >::const_iterator,
+                iter, descriptor.Values)
+    {
+    putBlock(out, *iter);
+    }
+
+  // Write regions
+  const vvDescriptorRegionMap& r = descriptor.Region;
+  putCount(out, r.size());
+  putColumn<double>(out, r, [](Region e){ return e.TimeStamp.Time; });
+  putColumn<quint32>(out, r, [](Region e){ return e.TimeStamp.FrameNumber; });
+
+  std::vector<vvImageBoundingBox> boxes;
+  boxes.reserve(r.size());
+  foreach_iter (vvDescriptorRegionMap::const_iterator, iter, r)
+    {
+    boxes.push_back(iter->ImageRegion);
+    }
+  putBoxColumns(out, boxes);
+
+  // Write track ID's
+  const std::vector<vvTrackId>& ids = descriptor.TrackIds;
+  putCount(out, ids.size());
+  putColumn<qint32>(out, ids, [](TrackId id){ return id.Source; });
+  putColumn<qint64>(out, ids, [](TrackId id){ return id.SerialNumber; });
+}
+
+//-----------------------------------------------------------------------------
+void vvBinaryWriterPrivate::writeQueryResult(
+  QByteArray& out, const vvQueryResult& result)
+{
+  put(out, result.MissionId);
+  put(out, result.QueryId);
+  put(out, result.StreamId);
+  put(out, static_cast<qint64>(result.InstanceId));
+  put(out, static_cast<qint64>(result.StartTime));
+  put(out, static_cast<qint64>(result.EndTime));
+  put(out, static_cast<qint32>(result.Location.GCS));
+  put(out, result.Location.Northing);
+  put(out, result.Location.Easting);
+  put(out, static_cast<qint64>(result.Rank));
+  put(out, result.RelevancyScore);
+  put(out, result.PreferenceScore);
+  put(out, static_cast<qint32>(result.UserScore));
+  put(out, static_cast<qint32>(result.UserData.Flags));
+  put(out, result.UserData.Notes);
+
+  putCount(out, result.Tracks.size());
+  foreach_iter (std::vector<vvTrack>::const_iterator, iter, result.Tracks)
+    {
+    this->writeTrack(out, *iter);
+    }
+
+  putCount(out, result.Descriptors.size());
+  foreach_iter (std::vector<vvDescriptor>::const_iterator,
+                iter, result.Descriptors)
+    {
+    this->writeDescriptor(out, *iter);
+    }
+}
+
+//END vvBinaryWriterPrivate
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvBinaryWriter
+
+//-----------------------------------------------------------------------------
+vvBinaryWriter::vvBinaryWriter(QIODevice& device, int chunkSize)
+  : d_ptr(new vvBinaryWriterPrivate(&device, chunkSize))
+{
+}
+
+//-----------------------------------------------------------------------------
+vvBinaryWriter::~vvBinaryWriter()
+{
+  QTE_D(vvBinaryWriter);
+  d->finish();
+}
+
+//-----------------------------------------------------------------------------
+vvWriter& vvBinaryWriter::operator<<(vvHeader::FileType fileType)
+{
+  QTE_D(vvBinaryWriter);
+
+  switch (fileType)
+    {
+    case vvHeader::Tracks:
+    case vvHeader::Descriptors:
+    case vvHeader::QueryResults:
+      if (!d->headerWritten)
+        {
+        d->type = fileType;
+        }
+      break;
+    default:
+      qWarning() << "vvBinaryWriter: file type" << fileType
+                 << "is not supported by binary archives";
+      break;
+    }
+
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+vvWriter& vvBinaryWriter::operator<<(const vvTrack& track)
+{
+  QTE_D(vvBinaryWriter);
+  if (d->begin(vvHeader::Tracks))
+    {
+    d->writeTrack(d->chunk, track);
+    d->end();
+    }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+vvWriter& vvBinaryWriter::operator<<(const vvDescriptor& descriptor)
+{
+  QTE_D(vvBinaryWriter);
+  if (d->begin(vvHeader::Descriptors))
+    {
+    d->writeDescriptor(d->chunk, descriptor);
+    d->end();
+    }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+vvWriter& vvBinaryWriter::operator<<(const vvQueryResult& result)
+{
+  QTE_D(vvBinaryWriter);
+  if (d->begin(vvHeader::QueryResults))
+    {
+    d->writeQueryResult(d->chunk, result);
+    d->end();
+    }
+  return *this;
+}
+
+//-----------------------------------------------------------------------------
+#define vvBinaryWriter_Implement_Unsupported(_class) \
+  vvWriter& vvBinaryWriter::operator<<(_class) \
+  { \
+    qWarning() << "vvBinaryWriter:" #_class \
+                  " is not supported by binary archives"; \
+    return *this; \
+  }
+
+vvBinaryWriter_Implement_Unsupported(const vvQueryInstance&)
+vvBinaryWriter_Implement_Unsupported(const vvRetrievalQuery&)
+vvBinaryWriter_Implement_Unsupported(const vvSimilarityQuery&)
+vvBinaryWriter_Implement_Unsupported(const vgGeocodedPoly&)
+vvBinaryWriter_Implement_Unsupported(const vvSpatialFilter&)
+vvBinaryWriter_Implement_Unsupported(const vvEventSetInfo&)
+
+//END vvBinaryWriter
@@ -0,0 +1,63 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vvBinaryWriter_h
+#define __vvBinaryWriter_h
+
+#include <vgExport.h>
+
+#include "vvWriter.h"
+
+class QIODevice;
+
+class vvBinaryWriterPrivate;
+
+/// Writer for compact binary track, descriptor and query result archives.
+///
+/// A binary archive consists of a short file header, followed by one or more
+/// chunks of items, followed by an index of the chunks, which allows a reader
+/// to seek directly to any item. All values are stored little-endian.
+/// Descriptor values are stored as contiguous blocks of single-precision
+/// values, and track trajectories are stored as columnar arrays.
+///
+/// Only tracks, descriptors and query results may be written; other data
+/// (query plans, event set information, polygons) is ignored. Items are
+/// buffered until a chunk is complete; the final chunk and the index are
+/// written when the writer is destroyed.
+class VV_IO_EXPORT vvBinaryWriter : public vvWriter
+{
+public:
+  explicit vvBinaryWriter(QIODevice&, int chunkSize = 256);
+  virtual ~vvBinaryWriter();
+
+  static const unsigned int FormatVersion;
+
+  static const char* const FileMagic;
+  static const char* const ChunkMagic;
+  static const char* const IndexMagic;
+  static const char* const TrailerMagic;
+
+  virtual vvWriter& operator<<(vvHeader::FileType);
+
+  virtual vvWriter& operator<<(const vvTrack&);
+  virtual vvWriter& operator<<(const vvDescriptor&);
+  virtual vvWriter& operator<<(const vvQueryInstance&);
+  virtual vvWriter& operator<<(const vvRetrievalQuery&);
+  virtual vvWriter& operator<<(const vvSimilarityQuery&);
+  virtual vvWriter& operator<<(const vvQueryResult&);
+  virtual vvWriter& operator<<(const vgGeocodedPoly&);
+  virtual vvWriter& operator<<(const vvSpatialFilter&);
+  virtual vvWriter& operator<<(const vvEventSetInfo&);
+
+  using vvWriter::operator<<; // Copy template overload
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vvBinaryWriter)
+
+private:
+  QTE_DECLARE_PRIVATE(vvBinaryWriter)
+  Q_DISABLE_COPY(vvBinaryWriter)
+};
+
+#endif
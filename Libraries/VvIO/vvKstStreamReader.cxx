@@ -0,0 +1,1270 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vvKstStreamReader.h"
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QFuture>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrentRun>
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "vvKstWriter.h"
+
+#define die(_msg) return this->abort(_msg)
+
+#define test_or_fail(_cond) if (!(_cond)) return false
+#define test_or_die(_cond, _msg) if (!(_cond)) die(_msg)
+
+#define check_version(_name, _ver) \
+  if (version > _ver) \
+    die("Unable to read " _name " version " + QString::number(version) \
+        + ": latest recognized version is " + QString::number(_ver))
+
+QTE_IMPLEMENT_D_FUNC(vvKstStreamReader)
+
+namespace // anonymous
+{
+
+//BEGIN tokenizer
+
+//-----------------------------------------------------------------------------
+struct Node
+{
+  enum Kind
+    {
+    Empty,
+    Scalar,
+    String,
+    Array
+    };
+
+  Kind kind;
+  const char* begin;
+  const char* end;
+  int firstChild; // index of the first child in ParseTree::Children
+  int childCount;
+  bool escaped;
+};
+
+//-----------------------------------------------------------------------------
+struct ParseTree
+{
+  std::vector<Node> Nodes;
+
+  // Node indices of the children of each array; the children of an array are
+  // stored contiguously, so that they can be indexed directly
+  std::vector<int> Children;
+};
+
+//-----------------------------------------------------------------------------
+// Lightweight handle to a parsed value; values refer directly into the input
+// buffer, so no text is copied until a string value is extracted
+class Value
+{
+public:
+  Value() : Tree(0), Index(-1) {}
+  Value(const ParseTree* tree, int index) : Tree(tree), Index(index) {}
+
+  bool isEmpty() const
+    { return this->Index < 0 || this->node().kind == Node::Empty; }
+
+  bool isArray() const
+    { return this->Index >= 0 && this->node().kind == Node::Array; }
+
+  bool isEmptyArray() const
+    { return this->isArray() && this->node().childCount == 0; }
+
+  int count() const
+    { return (this->isArray() ? this->node().childCount : 0); }
+
+  Value operator[](int i) const;
+
+  bool toLong(long long& out) const;
+  bool toInt(int& out) const;
+  bool toReal(double& out) const;
+  bool toString(std::string& out) const;
+
+protected:
+  const Node& node() const { return this->Tree->Nodes[this->Index]; }
+
+  const ParseTree* Tree;
+  int Index;
+};
+
+//-----------------------------------------------------------------------------
+Value Value::operator[](int i) const
+{
+  if (i < 0 || i >= this->count())
+    {
+    return Value();
+    }
+
+  const int n = this->Tree->Children[this->node().firstChild + i];
+  return Value(this->Tree, n);
+}
+
+//-----------------------------------------------------------------------------
+bool Value::toLong(long long& out) const
+{
+  if (this->Index < 0 || this->node().kind != Node::Scalar)
+    {
+    return false;
+    }
+
+  const char* p = this->node().begin;
+  const char* const end = this->node().end;
+  const bool negative = (*p == '-');
+  if (negative || *p == '+')
+    {
+    ++p;
+    }
+  if (p == end)
+    {
+    return false;
+    }
+
+  // The magnitude of the most negative value is one more than the maximum
+  const unsigned long long limit =
+    static_cast<unsigned long long>(std::numeric_limits<long long>::max()) +
+    (negative ? 1 : 0);
+
+  unsigned long long value = 0;
+  for (; p < end; ++p)
+    {
+    const unsigned int digit = static_cast<unsigned int>(*p - '0');
+    if (digit > 9)
+      {
+      return false;
+      }
+    if (value > (limit - digit) / 10)
+      {
+      // Value is out of range; fail rather than let it wrap
+      return false;
+      }
+    value = (value * 10) + digit;
+    }
+
+  if (negative)
+    {
+    out = (value ? -static_cast<long long>(value - 1) - 1 : 0);
+    }
+  else
+    {
+    out = static_cast<long long>(value);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Value::toInt(int& out) const
+{
+  long long value;
+  test_or_fail(this->toLong(value));
+  test_or_fail(value >= std::numeric_limits<int>::min() &&
+               value <= std::numeric_limits<int>::max());
+  out = static_cast<int>(value);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Value::toReal(double& out) const
+{
+  // Most values are integral (frame numbers, times, pixel coordinates), so
+  // try the fast path first
+  long long integer;
+  if (this->toLong(integer))
+    {
+    out = static_cast<double>(integer);
+    return true;
+    }
+
+  if (this->Index < 0 || this->node().kind != Node::Scalar)
+    {
+    return false;
+    }
+
+  // Fall back to Qt's locale-independent conversion; the data is not copied
+  const Node& n = this->node();
+  bool okay;
+  out = QByteArray::fromRawData(n.begin, static_cast<int>(n.end - n.begin))
+          .toDouble(&okay);
+  return okay;
+}
+
+//-----------------------------------------------------------------------------
+bool Value::toString(std::string& out) const
+{
+  if (this->Index < 0)
+    {
+    return false;
+    }
+
+  const Node& n = this->node();
+  switch (n.kind)
+    {
+    case Node::String:
+      if (!n.escaped)
+        {
+        out.assign(n.begin, n.end);
+        return true;
+        }
+      out.clear();
+      out.reserve(static_cast<size_t>(n.end - n.begin));
+      for (const char* p = n.begin; p < n.end; ++p)
+        {
+        (*p == '\\' && p + 1 < n.end) && ++p;
+        out.push_back(*p);
+        }
+      return true;
+
+    case Node::Scalar:
+      out.assign(n.begin, n.end);
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+class Tokenizer
+{
+public:
+  // Parse the values of a single record; the range should not include the
+  // record terminator
+  bool parse(const char* begin, const char* end);
+
+  Value root() const { return Value(&this->Tree, 0); }
+
+protected:
+  int addNode(Node::Kind, const char* begin, const char* end);
+  int parseValue(const char*& p);
+  bool parseList(const char*& p, int parent, char terminator);
+  bool closeList(int parent, size_t first, bool result);
+  void skipSpace(const char*& p) const;
+
+  ParseTree Tree;
+
+  // Children of the arrays being parsed; the children of nested arrays are
+  // parsed before their parent's list is complete, so they are collected here
+  // and moved to the tree when each list ends
+  std::vector<int> Pending;
+
+  const char* End;
+};
+
+//-----------------------------------------------------------------------------
+bool Tokenizer::parse(const char* begin, const char* end)
+{
+  this->Tree.Nodes.clear();
+  this->Tree.Children.clear();
+  this->Pending.clear();
+  this->End = end;
+
+  const int root = this->addNode(Node::Array, begin, end);
+  const char* p = begin;
+  return this->parseList(p, root, 0);
+}
+
+//-----------------------------------------------------------------------------
+int Tokenizer::addNode(Node::Kind kind, const char* begin, const char* end)
+{
+  const Node n = { kind, begin, end, -1, 0, false };
+  this->Tree.Nodes.push_back(n);
+  return static_cast<int>(this->Tree.Nodes.size()) - 1;
+}
+
+//-----------------------------------------------------------------------------
+void Tokenizer::skipSpace(const char*& p) const
+{
+  while (p < this->End)
+    {
+    if (*p == '#')
+      {
+      // Skip comment
+      while (p < this->End && *p != '\n')
+        {
+        ++p;
+        }
+      }
+    else if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')
+      {
+      ++p;
+      }
+    else
+      {
+      return;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool Tokenizer::parseList(const char*& p, int parent, char terminator)
+{
+  const size_t first = this->Pending.size();
+  for (;;)
+    {
+    const int child = this->parseValue(p);
+    test_or_fail(child >= 0);
+    this->Pending.push_back(child);
+
+    this->skipSpace(p);
+    if (p >= this->End)
+      {
+      return this->closeList(parent, first, terminator == 0);
+      }
+    else if (*p == ',')
+      {
+      ++p;
+      }
+    else if (terminator && *p == terminator)
+      {
+      ++p;
+      return this->closeList(parent, first, true);
+      }
+    else
+      {
+      return false;
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool Tokenizer::closeList(int parent, size_t first, bool result)
+{
+  Node& n = this->Tree.Nodes[parent];
+  n.firstChild = static_cast<int>(this->Tree.Children.size());
+  n.childCount = static_cast<int>(this->Pending.size() - first);
+
+  this->Tree.Children.insert(this->Tree.Children.end(),
+                             this->Pending.begin() + first,
+                             this->Pending.end());
+  this->Pending.resize(first);
+  return result;
+}
+
+//-----------------------------------------------------------------------------
+int Tokenizer::parseValue(const char*& p)
+{
+  this->skipSpace(p);
+
+  if (p >= this->End || *p == ',' || *p == ']')
+    {
+    return this->addNode(Node::Empty, p, p);
+    }
+
+  if (*p == '[')
+    {
+    const int n = this->addNode(Node::Array, p, p);
+    ++p;
+    this->skipSpace(p);
+    if (p < this->End && *p == ']')
+      {
+      ++p;
+      return n;
+      }
+    return (this->parseList(p, n, ']') ? n : -1);
+    }
+
+  if (*p == '"')
+    {
+    const char* const begin = ++p;
+    bool escaped = false;
+    while (p < this->End && *p != '"')
+      {
+      if (*p == '\\')
+        {
+        escaped = true;
+        ++p;
+        }
+      ++p;
+      }
+    if (p >= this->End)
+      {
+      return -1;
+      }
+
+    const int n = this->addNode(Node::String, begin, p++);
+    this->Tree.Nodes[n].escaped = escaped;
+    return n;
+    }
+
+  const char* const begin = p;
+  while (p < this->End && !std::strchr(",] \t\r\n#", *p))
+    {
+    ++p;
+    }
+  return this->addNode(Node::Scalar, begin, p);
+}
+
+//-----------------------------------------------------------------------------
+// Find the end of the record starting at 'p'; returns a pointer to the
+// record terminator, or 'end' if the record is not terminated
+const char* findRecordEnd(const char* p, const char* end)
+{
+  while (p < end)
+    {
+    switch (*p)
+      {
+      case ';':
+        return p;
+      case '#':
+        while (p < end && *p != '\n')
+          {
+          ++p;
+          }
+        break;
+      case '"':
+        ++p;
+        while (p < end && *p != '"')
+          {
+          (*p == '\\') && ++p;
+          ++p;
+          }
+        p = qMin(p + 1, end);
+        break;
+      default:
+        ++p;
+        break;
+      }
+    }
+  return end;
+}
+
+//END tokenizer
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN decoders
+
+//-----------------------------------------------------------------------------
+class Decoder
+{
+public:
+  QString lastError;
+
+  bool abort(const QString& error) { this->lastError = error; return false; }
+
+  bool readTimeStamp(const Value& record, int index, vgTimeStamp& ts,
+                     const QString& itemName);
+  bool readImageBoundingBox(const Value& value, vvImageBoundingBox& box,
+                            const QString& itemName);
+  bool readTrackState(const Value& record, vvTrackState& state);
+
+  bool read(const Value& record, vvTrack& track, unsigned int version);
+  bool read(const Value& record, vvDescriptor& descriptor,
+            unsigned int version);
+  bool read(const Value& record, vvQueryResult& result,
+            unsigned int version);
+};
+
+//-----------------------------------------------------------------------------
+bool Decoder::readTimeStamp(
+  const Value& record, int index, vgTimeStamp& ts, const QString& itemName)
+{
+  long long frameNumber, timeCode;
+  test_or_die(record[index].toLong(frameNumber) &&
+              frameNumber <= std::numeric_limits<unsigned int>::max(),
+              "Error reading " + itemName + " frame number");
+  ts.FrameNumber = (frameNumber > 0
+                    ? static_cast<unsigned int>(frameNumber)
+                    : vgTimeStamp::InvalidFrameNumber());
+  test_or_die(record[index + 1].toLong(timeCode),
+              "Error reading " + itemName + " time");
+  ts.Time = static_cast<double>(timeCode);
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::readImageBoundingBox(
+  const Value& value, vvImageBoundingBox& box, const QString& itemName)
+{
+  test_or_die(value.isArray(), "Error reading " + itemName);
+  test_or_die(value[0][0].toInt(box.TopLeft.Y),
+              "Error reading " + itemName + " top");
+  test_or_die(value[0][1].toInt(box.TopLeft.X),
+              "Error reading " + itemName + " left");
+  test_or_die(value[1][0].toInt(box.BottomRight.Y),
+              "Error reading " + itemName + " bottom");
+  test_or_die(value[1][1].toInt(box.BottomRight.X),
+              "Error reading " + itemName + " right");
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::readTrackState(const Value& record, vvTrackState& state)
+{
+  // Read timestamp
+  test_or_fail(
+    this->readTimeStamp(record, 0, state.TimeStamp, "track trajectory"));
+
+  // Read image point
+  test_or_die(record[2].toReal(state.ImagePoint.X),
+              "Error reading track trajectory image point X");
+  test_or_die(record[3].toReal(state.ImagePoint.Y),
+              "Error reading track trajectory image point Y");
+
+  // Read image box
+  test_or_fail(this->readImageBoundingBox(record[4], state.ImageBox,
+                                          "track trajectory image box"));
+
+  // Read image object
+  const Value object = record[5];
+  if (!object.isEmptyArray())
+    {
+    test_or_die(object.isArray(),
+                "Error reading track trajectory image object point list");
+    const int k = object.count();
+    state.ImageObject.reserve(static_cast<size_t>(k));
+    for (int n = 0; n < k; ++n)
+      {
+      const Value point = object[n];
+      vvImagePointF pt;
+      test_or_die(point[0].toReal(pt.X),
+                  "Error reading track trajectory image object point X");
+      test_or_die(point[1].toReal(pt.Y),
+                  "Error reading track trajectory image object point Y");
+      state.ImageObject.push_back(pt);
+      }
+    }
+
+  // Read world location
+  const Value location = record[6];
+  if (!location.isEmptyArray())
+    {
+    test_or_die(location.isArray(),
+                "Error reading track trajectory world location");
+    test_or_die(location[0].toInt(state.WorldLocation.GCS),
+                "Error reading track trajectory world location GCS");
+    test_or_die(location[1].toReal(state.WorldLocation.Northing),
+                "Error reading track trajectory world location northing");
+    test_or_die(location[2].toReal(state.WorldLocation.Easting),
+                "Error reading track trajectory world location easting");
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::read(const Value& record, vvTrack& track, unsigned int version)
+{
+  // Check that we understand the version
+  check_version("track", vvKstWriter::TracksVersion);
+
+  // Read track ID
+  const Value id = record[0];
+  test_or_die(id.isArray(), "Error reading track ID");
+  test_or_die(id[0].toInt(track.Id.Source), "Error reading track source");
+  test_or_die(id[1].toLong(track.Id.SerialNumber),
+              "Error reading track serial number");
+
+  // Read track classification
+  const Value classification = record[1];
+  if (!classification.isEmptyArray())
+    {
+    test_or_die(classification.isArray(),
+                "Error reading track classification");
+    const int k = classification.count();
+    for (int n = 0; n < k; ++n)
+      {
+      const Value entry = classification[n];
+      std::string type;
+      double probability;
+      test_or_die(entry[0].toString(type),
+                  "Error reading track classification entry type");
+      test_or_die(entry[1].toReal(probability),
+                  "Error reading track classification entry probability");
+      track.Classification.insert(std::make_pair(type, probability));
+      }
+    }
+
+  // Read track trajectory
+  const Value trajectory = record[2];
+  if (!trajectory.isEmptyArray())
+    {
+    test_or_die(trajectory.isArray(), "Error reading track trajectory");
+    const int k = trajectory.count();
+    for (int n = 0; n < k; ++n)
+      {
+      vvTrackState state;
+      test_or_fail(this->readTrackState(trajectory[n], state));
+
+      // States are normally written in order, so hint that the new state
+      // belongs at the end
+      track.Trajectory.insert(track.Trajectory.end(), state);
+      }
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::read(
+  const Value& record, vvDescriptor& descriptor, unsigned int version)
+{
+  // Check that we understand the version
+  check_version("descriptor", vvKstWriter::DescriptorsVersion);
+
+  // Read descriptor
+  test_or_die(record[0].toString(descriptor.DescriptorName),
+              "Error reading descriptor name");
+  test_or_die(record[1].toString(descriptor.ModuleName),
+              "Error reading descriptor module name");
+  test_or_die(record[2].toLong(descriptor.InstanceId),
+              "Error reading descriptor instance ID");
+  test_or_die(record[3].toReal(descriptor.Confidence),
+              "Error reading descriptor confidence");
+
+  // Read values
+  const Value values = record[4];
+  if (!(values.isEmpty() || values.isEmptyArray()))
+    {
+    test_or_die(values.isArray(), "Error reading descriptor values");
+    const int k = values.count();
+    descriptor.Values.resize(static_cast<size_t>(k));
+    for (int n = 0; n < k; ++n)
+      {
+      const Value array = values[n];
+      test_or_die(array.isArray(), "Error reading descriptor values");
+
+      const int vk = array.count();
+      std::vector<float>& out = descriptor.Values[static_cast<size_t>(n)];
+      out.reserve(static_cast<size_t>(vk));
+      for (int i = 0; i < vk; ++i)
+        {
+        double v;
+        test_or_die(array[i].toReal(v), "Error reading descriptor values");
+        out.push_back(static_cast<float>(v));
+        }
+      }
+    }
+
+  // Read region
+  const Value region = record[5];
+  if (!(region.isEmpty() || region.isEmptyArray()))
+    {
+    test_or_die(region.isArray(), "Error reading descriptor region");
+    const int k = region.count();
+    for (int n = 0; n < k; ++n)
+      {
+      const Value entry = region[n];
+      vvDescriptorRegionEntry re;
+
+      // Read entry time stamp and image region
+      test_or_fail(this->readTimeStamp(entry, 0, re.TimeStamp,
+                                       "descriptor region entry"));
+      test_or_fail(this->readImageBoundingBox(
+                     entry[2], re.ImageRegion,
+                     "descriptor region entry image region"));
+
+      descriptor.Region.insert(descriptor.Region.end(), re);
+      }
+    }
+
+  // Read track ID's
+  const Value tracks = record[6];
+  if (!(tracks.isEmpty() || tracks.isEmptyArray()))
+    {
+    test_or_die(tracks.isArray(), "Error reading descriptor tracks");
+    const int k = tracks.count();
+    for (int n = 0; n < k; ++n)
+      {
+      const Value entry = tracks[n];
+      vvTrackId t;
+      test_or_die(entry[0].toInt(t.Source),
+                  "Error reading descriptor track source");
+      test_or_die(entry[1].toLong(t.SerialNumber),
+                  "Error reading descriptor track serial number");
+      descriptor.TrackIds.push_back(t);
+      }
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool Decoder::read(
+  const Value& record, vvQueryResult& result, unsigned int version)
+{
+  // Check that we understand the version
+  check_version("query result", vvKstWriter::QueryResultsVersion);
+
+  int vi = 0;
+
+  // Read result
+  test_or_die(record[vi++].toString(result.MissionId),
+              "Error reading result mission ID");
+
+  if (version > 0)
+    {
+    test_or_die(record[vi++].toString(result.QueryId),
+                "Error reading result query ID");
+    test_or_die(record[vi++].toString(result.StreamId),
+                "Error reading result stream ID");
+    test_or_die(record[vi++].toLong(result.InstanceId),
+                "Error reading result instance ID");
+    }
+
+  test_or_die(record[vi++].toLong(result.StartTime),
+              "Error reading result time range");
+  test_or_die(record[vi++].toLong(result.EndTime),
+              "Error reading result time range");
+
+  int userScore = -1;
+  if (version > 1)
+    {
+    // Read location
+    const Value location = record[vi++];
+    if (!location.isEmptyArray())
+      {
+      test_or_die(location.isArray(), "Error reading result location");
+      test_or_die(location[0].toInt(result.Location.GCS),
+                  "Error reading result location GCS");
+      test_or_die(location[1].toReal(result.Location.Easting),
+                  "Error reading result location easting");
+      test_or_die(location[2].toReal(result.Location.Northing),
+                  "Error reading result location northing");
+      }
+
+    // Read score
+    const Value score = record[vi++];
+    if (!score.isEmptyArray())
+      {
+      test_or_die(score.isArray(), "Error reading result score");
+      test_or_die(score[0].toLong(result.Rank),
+                  "Error reading result rank");
+      test_or_die(score[1].toReal(result.RelevancyScore),
+                  "Error reading result relevancy");
+      test_or_die(score[2].toInt(userScore),
+                  "Error reading result user classification");
+      // Read user flags
+      if (score.count() > 3)
+        {
+        int flags;
+        test_or_die(score[3].toInt(flags),
+                    "Error reading result user flags");
+        result.UserData.Flags = static_cast<vvUserData::Flag>(flags);
+        }
+      }
+    }
+  else
+    {
+    // Read location
+    test_or_die(record[vi++].toInt(result.Location.GCS),
+                "Error reading result GCS");
+    test_or_die(record[vi++].toReal(result.Location.Easting),
+                "Error reading result easting");
+    test_or_die(record[vi++].toReal(result.Location.Northing),
+                "Error reading result northing");
+
+    // Read score
+    test_or_die(record[vi++].toReal(result.RelevancyScore),
+                "Error reading result relevancy score");
+    test_or_die(record[vi++].toInt(userScore),
+                "Error reading result user score");
+    result.Rank = -1; // rank not available
+    }
+
+  // Translate user score to enum value
+  switch (userScore)
+    {
+    case static_cast<int>(vvIqr::PositiveExample):
+      result.UserScore = vvIqr::PositiveExample;
+      break;
+    case static_cast<int>(vvIqr::NegativeExample):
+      result.UserScore = vvIqr::NegativeExample;
+      break;
+    default:
+      result.UserScore = vvIqr::UnclassifiedExample;
+      break;
+    }
+
+  // Read descriptors
+  const Value descriptors = record[vi++];
+  if (!(descriptors.isEmpty() || descriptors.isEmptyArray()))
+    {
+    test_or_die(descriptors.isArray(), "Error reading result descriptors");
+    const int k = descriptors.count();
+    result.Descriptors.resize(static_cast<size_t>(k));
+    for (int n = 0; n < k; ++n)
+      {
+      test_or_die(this->read(descriptors[n],
+                             result.Descriptors[static_cast<size_t>(n)], 0),
+                  "Error reading result descriptors");
+      }
+    }
+
+  // Read tracks
+  const Value tracks = record[vi++];
+  if (!(tracks.isEmpty() || tracks.isEmptyArray()))
+    {
+    test_or_die(tracks.isArray(), "Error reading result tracks");
+    const int k = tracks.count();
+    result.Tracks.resize(static_cast<size_t>(k));
+    for (int n = 0; n < k; ++n)
+      {
+      test_or_die(this->read(tracks[n],
+                             result.Tracks[static_cast<size_t>(n)], 0),
+                  "Error reading result tracks");
+      }
+    }
+
+  // Read user notes
+  if (vi < record.count())
+    {
+    test_or_die(record[vi].toString(result.UserData.Notes),
+                "Error reading result user notes");
+    }
+
+  return true;
+}
+
+//END decoders
+
+} // namespace <anonymous>
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvKstStreamReaderPrivate
+
+//-----------------------------------------------------------------------------
+class vvKstStreamReaderPrivate
+{
+public:
+  vvKstStreamReaderPrivate();
+
+  bool abort(const QString&);
+  void reset();
+
+  bool nextRecord(const char*& begin, const char*& end);
+
+  template <typename T>
+  bool read(vvHeader::FileType type,
+            const vvKstStreamReader::Callback<T>& callback);
+
+  template <typename T>
+  bool readSerial(const vvKstStreamReader::Callback<T>& callback);
+
+  template <typename T>
+  bool readParallel(const vvKstStreamReader::Callback<T>& callback);
+
+  QFile file;
+  QByteArray buffer;
+  const char* begin;
+  const char* pos;
+  const char* end;
+
+  vvHeader header;
+  QString lastError;
+
+  int threadCount;
+  int batchSize;
+  QThreadPool pool;
+};
+
+//-----------------------------------------------------------------------------
+vvKstStreamReaderPrivate::vvKstStreamReaderPrivate()
+  : begin(0), pos(0), end(0), threadCount(1), batchSize(256)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReaderPrivate::abort(const QString& error)
+{
+  qDebug() << "vvKstStreamReader:" << qPrintable(error);
+  this->lastError = error;
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+void vvKstStreamReaderPrivate::reset()
+{
+  this->file.close();
+  this->buffer.clear();
+  this->begin = this->pos = this->end = 0;
+  this->header = vvHeader();
+  this->lastError.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReaderPrivate::nextRecord(const char*& rb, const char*& re)
+{
+  while (this->pos < this->end)
+    {
+    rb = this->pos;
+    re = findRecordEnd(rb, this->end);
+    this->pos = qMin(re + 1, this->end);
+
+    // Skip records that contain only white space and comments
+    for (const char* p = rb; p < re; ++p)
+      {
+      if (*p == '#')
+        {
+        while (p < re && *p != '\n')
+          {
+          ++p;
+          }
+        }
+      else if (!std::strchr(" \t\r\n", *p))
+        {
+        return true;
+        }
+      }
+    }
+
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool vvKstStreamReaderPrivate::read(
+  vvHeader::FileType type, const vvKstStreamReader::Callback<T>& callback)
+{
+  test_or_die(this->begin, "No data is available");
+  test_or_die(this->header.isValid(),
+              "Header is invalid or has not been read/set");
+  test_or_die(this->header.type == type,
+              "Header type does not match requested data type");
+
+  return (this->threadCount > 1 ? this->readParallel(callback)
+                                : this->readSerial(callback));
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool vvKstStreamReaderPrivate::readSerial(
+  const vvKstStreamReader::Callback<T>& callback)
+{
+  Tokenizer tokenizer;
+  Decoder decoder;
+
+  const char* rb;
+  const char* re;
+  while (this->nextRecord(rb, re))
+    {
+    test_or_die(tokenizer.parse(rb, re),
+                "Error parsing KST record at offset "
+                + QString::number(rb - this->begin));
+
+    T item;
+    test_or_die(decoder.read(tokenizer.root(), item, this->header.version),
+                decoder.lastError);
+
+    if (!callback(item))
+      {
+      break;
+      }
+    }
+
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool vvKstStreamReaderPrivate::readParallel(
+  const vvKstStreamReader::Callback<T>& callback)
+{
+  typedef std::pair<const char*, const char*> Range;
+
+  struct SliceResult
+    {
+    int failedAt;
+    QString error;
+    };
+
+  std::vector<Range> records;
+  std::vector<T> items;
+  records.reserve(static_cast<size_t>(this->batchSize));
+
+  const unsigned int version = this->header.version;
+  const char* const base = this->begin;
+
+  forever
+    {
+    // Find the next batch of records
+    Range r;
+    records.clear();
+    while (static_cast<int>(records.size()) < this->batchSize &&
+           this->nextRecord(r.first, r.second))
+      {
+      records.push_back(r);
+      }
+    if (records.empty())
+      {
+      return true;
+      }
+
+    // Decode the batch, split into contiguous slices; the calling thread
+    // takes the first slice
+    const int count = static_cast<int>(records.size());
+    const int slices = qMin(this->threadCount, count);
+    items.clear();
+    items.resize(records.size());
+    std::vector<SliceResult> results(static_cast<size_t>(slices));
+
+    auto decode = [&](int s){
+      SliceResult& result = results[static_cast<size_t>(s)];
+      result.failedAt = -1;
+
+      Tokenizer tokenizer;
+      Decoder decoder;
+      const int first = (s * count) / slices;
+      const int last = ((s + 1) * count) / slices;
+      for (int i = first; i < last; ++i)
+        {
+        const Range& range = records[static_cast<size_t>(i)];
+        if (!tokenizer.parse(range.first, range.second))
+          {
+          result.failedAt = i;
+          result.error = "Error parsing KST record at offset "
+                         + QString::number(range.first - base);
+          return;
+          }
+        if (!decoder.read(tokenizer.root(), items[static_cast<size_t>(i)],
+                          version))
+          {
+          result.failedAt = i;
+          result.error = decoder.lastError;
+          return;
+          }
+        }
+    };
+
+    QVector<QFuture<void> > futures;
+    for (int s = 1; s < slices; ++s)
+      {
+      futures.append(QtConcurrent::run(&this->pool, [&decode, s]{
+        decode(s);
+      }));
+      }
+    decode(0);
+    foreach (QFuture<void> f, futures)
+      {
+      f.waitForFinished();
+      }
+
+    // Deliver items in order, up to the first failure (if any)
+    int failedAt = count;
+    QString error;
+    foreach (const SliceResult& result, results)
+      {
+      if (result.failedAt >= 0 && result.failedAt < failedAt)
+        {
+        failedAt = result.failedAt;
+        error = result.error;
+        }
+      }
+
+    for (int i = 0; i < failedAt; ++i)
+      {
+      if (!callback(items[static_cast<size_t>(i)]))
+        {
+        return true;
+        }
+      }
+
+    test_or_die(failedAt == count, error);
+    }
+}
+
+//END vvKstStreamReaderPrivate
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vvKstStreamReader
+
+#undef die
+#define die(_msg) return d->abort(_msg)
+
+//-----------------------------------------------------------------------------
+vvKstStreamReader::vvKstStreamReader() : d_ptr(new vvKstStreamReaderPrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+vvKstStreamReader::~vvKstStreamReader()
+{
+}
+
+//-----------------------------------------------------------------------------
+QString vvKstStreamReader::error() const
+{
+  QTE_D_CONST(vvKstStreamReader);
+  return d->lastError;
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::open(const QString& fileName)
+{
+  QTE_D(vvKstStreamReader);
+  d->reset();
+
+  d->file.setFileName(fileName);
+  test_or_die(d->file.open(QIODevice::ReadOnly),
+              "Unable to open " + fileName + ": " + d->file.errorString());
+
+  const qint64 size = d->file.size();
+  if (size == 0)
+    {
+    d->begin = d->pos = d->end = "";
+    return true;
+    }
+
+  // Map the file; if that fails (e.g. the file is not a regular file), fall
+  // back to reading it into memory
+  const uchar* const data = d->file.map(0, size);
+  if (data)
+    {
+    d->begin = reinterpret_cast<const char*>(data);
+    d->pos = d->begin;
+    d->end = d->begin + size;
+    return true;
+    }
+
+  const QByteArray contents = d->file.readAll();
+  d->file.close();
+  return this->setInput(contents);
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::setInput(const QByteArray& data)
+{
+  QTE_D(vvKstStreamReader);
+  d->reset();
+
+  d->buffer = data;
+  d->begin = d->buffer.constData();
+  d->pos = d->begin;
+  d->end = d->begin + d->buffer.size();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vvKstStreamReader::setThreadCount(int count)
+{
+  QTE_D(vvKstStreamReader);
+  d->threadCount = qMax(1, count);
+  d->pool.setMaxThreadCount(qMax(1, count - 1));
+}
+
+//-----------------------------------------------------------------------------
+int vvKstStreamReader::threadCount() const
+{
+  QTE_D_CONST(vvKstStreamReader);
+  return d->threadCount;
+}
+
+//-----------------------------------------------------------------------------
+void vvKstStreamReader::setBatchSize(int size)
+{
+  QTE_D(vvKstStreamReader);
+  d->batchSize = qMax(1, size);
+}
+
+//-----------------------------------------------------------------------------
+int vvKstStreamReader::batchSize() const
+{
+  QTE_D_CONST(vvKstStreamReader);
+  return d->batchSize;
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::readHeader(vvHeader& header)
+{
+  QTE_D(vvKstStreamReader);
+  test_or_die(d->begin, "No data is available");
+
+  const char* rb;
+  const char* re;
+  Tokenizer tokenizer;
+  test_or_die(d->nextRecord(rb, re) && tokenizer.parse(rb, re),
+              "Unable to read header");
+
+  // Read type
+  const Value record = tokenizer.root();
+  std::string type;
+  test_or_die(record[0].toString(type), "Unable to read header");
+
+  if (type == vvHeader::TracksTag)
+    {
+    header.type = vvHeader::Tracks;
+    }
+  else if (type == vvHeader::DescriptorsTag)
+    {
+    header.type = vvHeader::Descriptors;
+    }
+  else if (type == vvHeader::QueryPlanTag)
+    {
+    header.type = vvHeader::QueryPlan;
+    }
+  else if (type == vvHeader::QueryResultsTag)
+    {
+    header.type = vvHeader::QueryResults;
+    }
+  else if (type == vvHeader::EventSetInfoTag || type == "ALERT")
+    {
+    // For backwards compatibility, "ALERT" is considered to be EventSetInfo
+    header.type = vvHeader::EventSetInfo;
+    }
+  else
+    {
+    die("Unrecognized file format " + QString::fromStdString(type));
+    }
+
+  // Read version
+  int version = 0;
+  test_or_die(record.count() < 2 || record[1].toInt(version),
+              "Unable to read header");
+  header.version = static_cast<unsigned int>(version);
+
+  d->header = header;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::readTracks(const Callback<vvTrack>& callback)
+{
+  QTE_D(vvKstStreamReader);
+  return d->read(vvHeader::Tracks, callback);
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::readDescriptors(
+  const Callback<vvDescriptor>& callback)
+{
+  QTE_D(vvKstStreamReader);
+  return d->read(vvHeader::Descriptors, callback);
+}
+
+//-----------------------------------------------------------------------------
+bool vvKstStreamReader::readQueryResults(
+  const Callback<vvQueryResult>& callback)
+{
+  QTE_D(vvKstStreamReader);
+  return d->read(vvHeader::QueryResults, callback);
+}
+
+//-----------------------------------------------------------------------------
+qint64 vvKstStreamReader::position() const
+{
+  QTE_D_CONST(vvKstStreamReader);
+  return d->pos - d->begin;
+}
+
+//-----------------------------------------------------------------------------
+qint64 vvKstStreamReader::size() const
+{
+  QTE_D_CONST(vvKstStreamReader);
+  return d->end - d->begin;
+}
+
+//END vvKstStreamReader
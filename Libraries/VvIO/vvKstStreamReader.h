@@ -0,0 +1,92 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vvKstStreamReader_h
+#define __vvKstStreamReader_h
+
+#include <QString>
+
+#include <qtGlobal.h>
+
+#include <vgExport.h>
+
+#include <vvDescriptor.h>
+#include <vvQueryResult.h>
+#include <vvTrack.h>
+
+#include <functional>
+
+#include "vvHeader.h"
+
+class QByteArray;
+
+class vvKstStreamReaderPrivate;
+
+// Streaming reader for KST track, descriptor and query result archives.
+//
+// Unlike vvKstReader, which parses the entire input into a qtKstReader
+// before any data is extracted, this reader tokenizes records directly from
+// the raw input (which, when reading from a file, is memory mapped) and
+// passes each decoded item to a callback as soon as it is available. This
+// allows very large archives to be read without holding every item in
+// memory at once, and allows the caller to filter or discard items as they
+// are read.
+//
+// Records may optionally be decoded in parallel; in this case, records are
+// decoded in batches, and the callback is still invoked for each item, in
+// file order, from the thread that called the read method.
+class VV_IO_EXPORT vvKstStreamReader
+{
+public:
+  // Item callback; the callback may take ownership of the item's contents
+  // (e.g. by moving from it), and returning false stops reading (this is not
+  // an error)
+  template <typename T>
+  using Callback = std::function<bool (T&)>;
+
+  vvKstStreamReader();
+  ~vvKstStreamReader();
+
+  QString error() const;
+
+  // Open (and memory map) the specified file
+  bool open(const QString& fileName);
+
+  // Read from an in-memory buffer; the reader keeps a (shallow) copy of the
+  // data
+  bool setInput(const QByteArray& data);
+
+  // Number of threads used to decode records; values less than 2 (the
+  // default is 1) decode records serially, in the calling thread
+  void setThreadCount(int);
+  int threadCount() const;
+
+  // Number of records decoded per batch when decoding in parallel (default
+  // 256); larger batches use more memory, but reduce synchronization overhead
+  void setBatchSize(int);
+  int batchSize() const;
+
+  // Read file header; this must be called before reading any data, and
+  // determines the type of data that may be read
+  bool readHeader(vvHeader& header);
+
+  bool readTracks(const Callback<vvTrack>& callback);
+  bool readDescriptors(const Callback<vvDescriptor>& callback);
+  bool readQueryResults(const Callback<vvQueryResult>& callback);
+
+  // Number of bytes of input consumed so far
+  qint64 position() const;
+
+  // Total size of input, in bytes
+  qint64 size() const;
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vvKstStreamReader)
+
+private:
+  QTE_DECLARE_PRIVATE(vvKstStreamReader)
+  Q_DISABLE_COPY(vvKstStreamReader)
+};
+
+#endif
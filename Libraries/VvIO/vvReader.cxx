@@ -10,6 +10,8 @@
 
 #include <vvQueryResult.h>
 
+#include "vvBinaryReader.h"
+#include "vvBinaryWriter.h"
 #include "vvHeader.h"
 #include "vvKstReader.h"
 #include "vvQueryInstance.h"
@@ -74,10 +76,32 @@ bool vvReader::open(const QUrl& uri, vvReader::Format format)
     d->reader.reset(new vvXmlReader);
     return d->reader->open(uri);
     }
+  else if (format == Binary)
+    {
+    d->reader.reset(new vvBinaryReader);
+    return d->reader->open(uri);
+    }
   else
     {
     // No matter what, calling open() resets the reader
     d->reader.reset();
+
+    // Binary and XML can be read directly from the file, rather than loading
+    // the whole file up front, so check for those first
+    QFile file(uri.toLocalFile());
+    if (file.open(QIODevice::ReadOnly))
+      {
+      const QByteArray head = file.peek(1024);
+      if (head.startsWith(vvBinaryWriter::FileMagic))
+        {
+        return this->open(uri, Binary);
+        }
+      if (QString::fromLocal8Bit(head).contains(QRegExp("^\\s*<")))
+        {
+        return this->open(uri, Xml);
+        }
+      }
+
     return this->open(uri, d->lastError);
     }
 }
@@ -114,6 +138,11 @@ bool vvReader::setInput(const QString& data, vvReader::Format format)
     d->reader.reset(new vvXmlReader);
     return d->reader->setInput(data);
     }
+  else if (format == Binary)
+    {
+    d->reader.reset(new vvBinaryReader);
+    return d->reader->setInput(data);
+    }
   else
     {
     // Guess format from data
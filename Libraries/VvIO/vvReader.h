@@ -32,7 +32,8 @@ public:
     {
     Auto,
     Kst,
-    Xml
+    Xml,
+    Binary
     };
 
   vvReader();
@@ -6,6 +6,7 @@
 
 #include <qtUtil.h>
 
+#include "vvBinaryWriter.h"
 #include "vvKstWriter.h"
 #include "vvXmlWriter.h"
 
@@ -33,6 +34,9 @@ vvWriterPrivate::vvWriterPrivate(
     case vvWriter::Xml:
       this->writer.reset(new vvXmlWriter(file, pretty ? 2 : -1));
       break;
+    case vvWriter::Binary:
+      this->writer.reset(new vvBinaryWriter(file));
+      break;
     default:
       break;
     }
@@ -50,6 +54,14 @@ vvWriterPrivate::vvWriterPrivate(
     case vvWriter::Xml:
       this->writer.reset(new vvXmlWriter(stream, pretty ? 2 : -1));
       break;
+    case vvWriter::Binary:
+      // Binary data can only be written to the stream's underlying device
+      if (stream.device())
+        {
+        stream.flush();
+        this->writer.reset(new vvBinaryWriter(*stream.device()));
+        }
+      break;
     default:
       break;
     }
@@ -22,7 +22,8 @@ public:
   enum Format
     {
     Kst,
-    Xml
+    Xml,
+    Binary
     };
 
   explicit vvWriter(QFile&, Format format = Kst, bool pretty = true);
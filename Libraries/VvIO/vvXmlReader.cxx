@@ -6,6 +6,9 @@
 
 #include <QDomElement>
 #include <QDebug>
+#include <QFile>
+#include <QUrl>
+#include <QXmlStreamReader>
 
 #include <vvQueryResult.h>
 
@@ -32,16 +35,33 @@ QTE_IMPLEMENT_D_FUNC(vvXmlReader)
 class vvXmlReaderPrivate
 {
 public:
-  QDomDocument document;
-  QDomNode currentNode;
+  vvXmlReaderPrivate() : hasInput(false) {}
+
+  // Bound data is read incrementally using a stream reader; the stream is
+  // positioned at the start of the current item, and is not at a start
+  // element when at the end of the data
+  QFile file;
+  QString data;
+  bool hasInput;
+  QXmlStreamReader xml;
 
   QString lastError;
 
   bool abort(const QString&);
+  bool abortParse();
+
+  bool atEnd() const;
+  bool checkPosition();
+  void nextItem();
+
+  void reset();
+  bool readHeader(const QString& tagName, vvHeader& header);
 
   template <typename T>
-  bool read(T& result, vvXmlReader& q,
-            bool (vvXmlReader::*method)(QDomNode&, T&));
+  bool readItem(T& result);
+  template <typename L>
+  bool readItems(L& list);
+
   template <typename L, typename T>
   bool read(L& list, QDomNode& node, vvXmlReader& q,
             bool (vvXmlReader::*method)(QDomNode&, T&));
@@ -59,13 +79,99 @@ bool vvXmlReaderPrivate::abort(const QString& error)
   return false;
 }
 
+//-----------------------------------------------------------------------------
+bool vvXmlReaderPrivate::abortParse()
+{
+  const QString format("Unable to parse XML: at %1:%2: %3");
+  die(format.arg(this->xml.lineNumber()).arg(this->xml.columnNumber())
+            .arg(this->xml.errorString()));
+}
+
+//-----------------------------------------------------------------------------
+void vvXmlReaderPrivate::reset()
+{
+  this->xml.clear();
+  this->file.close();
+  this->data.clear();
+  this->hasInput = false;
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReaderPrivate::readHeader(const QString& type, vvHeader& header)
+{
+  BEGIN_MAP_FROM_STRING(vvHeader::FileType, type, header.type);
+  MAP_FROM_STRING("track",          vvHeader::Tracks);
+  MAP_FROM_STRING("descriptor",     vvHeader::Descriptors);
+  MAP_FROM_STRING("query",          vvHeader::QueryPlan);
+  MAP_FROM_STRING("query_result",   vvHeader::QueryResults);
+  MAP_FROM_STRING("event_meta",     vvHeader::EventSetInfo);
+  END_MAP_FROM_STRING(die("Unrecognized file format " + type));
+
+  header.version = 0;
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReaderPrivate::atEnd() const
+{
+  return !this->hasInput || !this->xml.isStartElement();
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReaderPrivate::checkPosition()
+{
+  test_or_die(this->hasInput, "No data is available");
+  if (this->xml.hasError())
+    {
+    return this->abortParse();
+    }
+  test_or_die(!this->atEnd(),
+              "No data available or read position at end of data");
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vvXmlReaderPrivate::nextItem()
+{
+  // Move to the start of the next item, or to the end of the root element
+  // if there are no more items
+  this->xml.readNextStartElement();
+}
+
 //-----------------------------------------------------------------------------
 template <typename T>
-bool vvXmlReaderPrivate::read(
-  T& result, vvXmlReader& q, bool (vvXmlReader::*method)(QDomNode&, T&))
+bool vvXmlReaderPrivate::readItem(T& result)
 {
-  test_or_die(!this->document.isNull(), "No data is available");
-  return (q.*method)(this->currentNode, result);
+  test_or_fail(this->checkPosition());
+
+  // Read data
+  test_or_fail(vvXmlUtil::readElement(this->xml, result, &this->lastError));
+
+  // Advance read position to next item
+  this->nextItem();
+
+  // Done
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template <typename L>
+bool vvXmlReaderPrivate::readItems(L& list)
+{
+  test_or_die(this->hasInput, "No data is available");
+  test_or_die(!this->atEnd(), "Read position is at end of data");
+
+  list.clear();
+  while (!this->atEnd())
+    {
+    // Read item
+    typename L::value_type item;
+    test_or_fail(this->readItem(item));
+    list.push_back(item);
+    }
+
+  // Check that the remaining data was well formed
+  return (this->xml.hasError() ? this->abortParse() : true);
 }
 
 //-----------------------------------------------------------------------------
@@ -74,7 +180,6 @@ bool vvXmlReaderPrivate::read(
   L& list, QDomNode& node, vvXmlReader& q,
   bool (vvXmlReader::*method)(QDomNode&, T&))
 {
-  test_or_die(!this->document.isNull(), "No data is available");
   test_or_die(!node.isNull(), "Read position is at end of data");
 
   list.clear();
@@ -158,9 +263,20 @@ bool vvXmlReader::open(const QUrl& uri, vvReader::Format format)
   test_or_die(format == Auto || format == Xml,
               "Requested format not supported");
 
-  QString error;
-  test_or_die(this->open(uri, error), error);
-  return true;
+  QTE_D(vvXmlReader);
+  d->reset();
+
+  // Read directly from the file, so that items can be read without first
+  // loading the entire file
+  d->file.setFileName(uri.toLocalFile());
+  if (!d->file.open(QIODevice::ReadOnly))
+    {
+    die("Unable to open \"" + uri.toString() + "\": "
+        + d->file.errorString());
+    }
+
+  d->hasInput = true;
+  return this->rewind();
 }
 
 //-----------------------------------------------------------------------------
@@ -170,20 +286,10 @@ bool vvXmlReader::setInput(const QString& data, vvReader::Format format)
               "Requested format not supported");
 
   QTE_D(vvXmlReader);
+  d->reset();
 
-  d->document = QDomDocument();
-  d->currentNode = QDomNode();
-
-  QString em;
-  int el, ec;
-
-  if (!d->document.setContent(data, &em, &el, &ec))
-    {
-    d->document = QDomDocument();
-    const QString format("Unable to parse XML: at %1:%2: %3");
-    die(format.arg(el).arg(ec).arg(em));
-    }
-
+  d->data = data;
+  d->hasInput = true;
   return this->rewind();
 }
 
@@ -197,15 +303,31 @@ void vvXmlReader::setHeader(const vvHeader&)
 bool vvXmlReader::rewind()
 {
   QTE_D(vvXmlReader);
+  test_or_die(d->hasInput, "No data is available");
+
+  // Restart the stream
+  if (d->file.isOpen())
+    {
+    d->file.seek(0);
+    d->xml.setDevice(&d->file);
+    }
+  else
+    {
+    d->xml.clear();
+    d->xml.addData(d->data);
+    }
 
-  QDomElement root = d->document.firstChildElement();
-  if (root.isNull() || root.tagName() != "xml")
+  // Check root element
+  if (!d->xml.readNextStartElement() || d->xml.name() != "xml")
     {
-    d->document = QDomDocument();
-    die("Invalid or missing XML root node");
+    d->xml.hasError() ? d->abortParse()
+                      : d->abort("Invalid or missing XML root node");
+    d->reset();
+    return false;
     }
 
-  d->currentNode = root.firstChildElement();
+  // Move to first item
+  d->nextItem();
   return true;
 }
 
@@ -216,22 +338,9 @@ bool vvXmlReader::advance()
 
   QTE_D(vvXmlReader);
 
-  QDomElement next;
-  while (!d->currentNode.isNull())
-    {
-    // See if we have a next sibling
-    next = d->currentNode.nextSiblingElement();
-    if (!next.isNull())
-      {
-      // If yes, move to that node
-      d->currentNode = next;
-      return true;
-      }
-
-    // If not, move up to parent and keep looking
-    d->currentNode = d->currentNode.parentNode();
-    }
-
+  // Skip the current item and move to the next one
+  d->xml.skipCurrentElement();
+  d->nextItem();
   return true;
 }
 
@@ -239,14 +348,14 @@ bool vvXmlReader::advance()
 bool vvXmlReader::atEnd() const
 {
   QTE_D_CONST(vvXmlReader);
-  return d->currentNode.isNull();
+  return d->atEnd();
 }
 
-//END vvKstReader general
+//END vvXmlReader general
 
 ///////////////////////////////////////////////////////////////////////////////
 
-//BEGIN vvKstReader struct readers
+//BEGIN vvXmlReader struct readers
 
 //-----------------------------------------------------------------------------
 bool vvXmlReader::readHeader(QDomNode& node, vvHeader& header)
@@ -255,19 +364,7 @@ bool vvXmlReader::readHeader(QDomNode& node, vvHeader& header)
 
   QDomElement elem;
   test_or_fail(d->firstElement(elem, node, "header"));
-
-  const QString type = elem.tagName();
-
-  BEGIN_MAP_FROM_STRING(vvHeader::FileType, type, header.type);
-  MAP_FROM_STRING("track",          vvHeader::Tracks);
-  MAP_FROM_STRING("descriptor",     vvHeader::Descriptors);
-  MAP_FROM_STRING("query",          vvHeader::QueryPlan);
-  MAP_FROM_STRING("query_result",   vvHeader::QueryResults);
-  MAP_FROM_STRING("event_meta",     vvHeader::EventSetInfo);
-  END_MAP_FROM_STRING(die("Unrecognized file format " + type));
-
-  header.version = 0;
-  return true;
+  return d->readHeader(elem.tagName(), header);
 }
 
 //-----------------------------------------------------------------------------
@@ -337,39 +434,91 @@ vvXmlReader_Implement_Read(EventSetInfo,  vvEventSetInfo,   "event_meta")
 ///////////////////////////////////////////////////////////////////////////////
 
 //BEGIN vvXmlReader bound data readers
+
+//-----------------------------------------------------------------------------
+bool vvXmlReader::readHeader(vvHeader& header)
+{
+  QTE_D(vvXmlReader);
+
+  // Determine type from the current item, but do not consume it
+  test_or_fail(d->checkPosition());
+  return d->readHeader(d->xml.name().toString(), header);
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReader::readQueryPlan(vvRetrievalQuery& query)
+{
+  // Read generic query
+  vvQueryInstance qi;
+  test_or_fail(this->readQueryPlan(qi));
+
+  // Verify query type
+  test_or_die(qi.isRetrievalQuery(), "Node is not a retrieval query");
+
+  // Done
+  query = *qi.constRetrievalQuery();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReader::readQueryPlan(vvSimilarityQuery& query)
+{
+  // Read generic query
+  vvQueryInstance qi;
+  test_or_fail(this->readQueryPlan(qi));
+
+  // Verify query type
+  test_or_die(qi.isSimilarityQuery(), "Node is not a similarity query");
+
+  // Done
+  query = *qi.constSimilarityQuery();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlReader::readGeoPoly(
+  vgGeocodedPoly& poly, vvDatabaseQuery::IntersectionType* filterMode)
+{
+  QTE_D(vvXmlReader);
+
+  // Read data
+  test_or_fail(d->checkPosition());
+  test_or_fail(vvXmlUtil::readElement(d->xml, poly, filterMode,
+                                      &d->lastError));
+
+  // Advance read position to next item
+  d->nextItem();
+
+  // Done
+  return true;
+}
+
+//-----------------------------------------------------------------------------
 #define vvXmlReader_Implement_BoundRead(_name, _type) \
   bool vvXmlReader::read##_name(_type& data) \
   { \
     QTE_D(vvXmlReader); \
-    bool (vvXmlReader::*method)(QDomNode&, _type&) = \
-      &vvXmlReader::read##_name; \
-    return d->read(data, *this, method); \
+    return d->readItem(data); \
   }
 
-vvXmlReader_Implement_BoundRead(Header,       vvHeader)
 vvXmlReader_Implement_BoundRead(Track,        vvTrack)
 vvXmlReader_Implement_BoundRead(Descriptor,   vvDescriptor)
 vvXmlReader_Implement_BoundRead(QueryPlan,    vvQueryInstance)
-vvXmlReader_Implement_BoundRead(QueryPlan,    vvRetrievalQuery)
-vvXmlReader_Implement_BoundRead(QueryPlan,    vvSimilarityQuery)
 vvXmlReader_Implement_BoundRead(QueryResult,  vvQueryResult)
 vvXmlReader_Implement_BoundRead(EventSetInfo, vvEventSetInfo)
 
-//-----------------------------------------------------------------------------
-bool vvXmlReader::readGeoPoly(
-  vgGeocodedPoly& poly, vvDatabaseQuery::IntersectionType* filterMode)
-{
-  QTE_D(vvXmlReader);
-
-  test_or_die(!d->document.isNull(), "No data is available");
-  return this->readGeoPoly(d->currentNode, poly, filterMode);
-}
-
-//END vvKstReader bound data readers
+//END vvXmlReader bound data readers
 
 ///////////////////////////////////////////////////////////////////////////////
 
-//BEGIN vvKstReader array helpers
+//BEGIN vvXmlReader array helpers
+
+#define vvXmlReader_Implement_ReadBoundArray(_name, _type, _list) \
+  bool vvXmlReader::read##_name##s(_list<_type>& list) \
+  { \
+    QTE_D(vvXmlReader); \
+    return d->readItems(list); \
+  }
 
 #define vvXmlReader_Implement_ReadTypedArray(_name, _type, _list) \
   bool vvXmlReader::read##_name##s(QDomNode& node, _list<_type>& list) \
@@ -381,8 +530,8 @@ bool vvXmlReader::readGeoPoly(
   }
 
 #define vvXmlReader_Implement_ReadArray(_name, _type) \
-  vvXmlReader_Implement_BoundRead(_name##s, QList<_type>) \
-  vvXmlReader_Implement_BoundRead(_name##s, std::vector<_type>) \
+  vvXmlReader_Implement_ReadBoundArray(_name, _type, QList) \
+  vvXmlReader_Implement_ReadBoundArray(_name, _type, std::vector) \
   vvXmlReader_Implement_ReadTypedArray(_name, _type, std::vector) \
   vvXmlReader_Implement_ReadTypedArray(_name, _type, QList)
 
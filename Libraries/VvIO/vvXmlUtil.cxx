@@ -6,6 +6,7 @@
 
 #include <QDomDocument>
 #include <QStringList>
+#include <QXmlStreamReader>
 
 #include <qtStlUtil.h>
 
@@ -42,6 +43,25 @@ namespace // anonymous
 #define END_MAP_FROM_STRING(_msg) \
   else { die(_msg); } } while (0)
 
+//-----------------------------------------------------------------------------
+// Attribute value accessors; these allow the attribute readers to be shared
+// between the DOM and stream readers
+QString attributeValue(const QDomElement& elem, const QString& name)
+{
+  return elem.attribute(name);
+}
+
+//-----------------------------------------------------------------------------
+QStringRef attributeValue(
+  const QXmlStreamAttributes& attributes, const QString& name)
+{
+  return attributes.value(name);
+}
+
+//-----------------------------------------------------------------------------
+inline QString toString(const QString& s) { return s; }
+inline QString toString(const QStringRef& s) { return s.toString(); }
+
 //-----------------------------------------------------------------------------
 bool readColorComponent(qreal& out, const QString& value)
 {
@@ -97,13 +117,14 @@ bool readColor(
 
 //-----------------------------------------------------------------------------
 #define vvXmlUtil_Implement_ReadAttribute(_t, _c) \
-  bool readAttribute(_t& out, const QDomElement& elem, const QString& tagName, \
+  template <typename Element> \
+  bool readAttribute(_t& out, const Element& elem, const QString& tagName, \
                      const QString& name, QString* error) \
   { \
     test_or_die(elem.hasAttribute(tagName), \
                 QString("Error reading %1: no such attribute").arg(name)); \
     bool okay; \
-    out = elem.attribute(tagName).to##_c(&okay); \
+    out = attributeValue(elem, tagName).to##_c(&okay); \
     test_or_die(okay, QString("Error reading %1: bad value").arg(name)); \
     return true; \
   }
@@ -115,30 +136,33 @@ vvXmlUtil_Implement_ReadAttribute(float, Float)
 vvXmlUtil_Implement_ReadAttribute(double, Double)
 
 //-----------------------------------------------------------------------------
+template <typename Element>
 bool readAttribute(
-  QString& out, const QDomElement& elem, const QString& tagName,
+  QString& out, const Element& elem, const QString& tagName,
   const QString& name, QString* error)
 {
   test_or_die(elem.hasAttribute(tagName),
               QString("Error reading %1: no such attribute").arg(name));
-  out = elem.attribute(tagName);
+  out = toString(attributeValue(elem, tagName));
   return true;
 }
 
 //-----------------------------------------------------------------------------
+template <typename Element>
 bool readAttribute(
-  std::string& out, const QDomElement& elem, const QString& tagName,
+  std::string& out, const Element& elem, const QString& tagName,
   const QString& name, QString* error)
 {
   test_or_die(elem.hasAttribute(tagName),
               QString("Error reading %1: no such attribute").arg(name));
-  out = stdString(elem.attribute(tagName));
+  out = stdString(toString(attributeValue(elem, tagName)));
   return true;
 }
 
 //-----------------------------------------------------------------------------
+template <typename Element>
 bool readAttribute(
-  QColor& out, const QDomElement& elem, const QString& tagName,
+  QColor& out, const Element& elem, const QString& tagName,
   const QString& name, QString* error)
 {
 
@@ -146,7 +170,7 @@ bool readAttribute(
               QString("Error reading %1: no such attribute").arg(name));
 
   bool result = false;
-  const QString value = elem.attribute(tagName);
+  const QString value = toString(attributeValue(elem, tagName));
   if (value.startsWith("rgb("))
     {
     result = readColor(out, value, false, &QColor::setRgbF);
@@ -177,14 +201,15 @@ bool readAttribute(
 }
 
 //-----------------------------------------------------------------------------
+template <typename Element>
 bool readAttribute(
-  vvDatabaseQuery::IntersectionType& out, const QDomElement& elem,
+  vvDatabaseQuery::IntersectionType& out, const Element& elem,
   const QString& tagName, const QString& name, QString* error)
 {
   test_or_die(elem.hasAttribute(tagName),
               QString("Error reading %1 filter mode: no such attribute").arg(name));
 
-  const QString value = elem.attribute(tagName);
+  const QString value = toString(attributeValue(elem, tagName));
   test_or_die(!value.isEmpty(),
               QString("Error reading %1 filter mode: missing value").arg(name));
 
@@ -204,7 +229,8 @@ bool readAttribute(
 }
 
 //-----------------------------------------------------------------------------
-bool readTime(vgTimeStamp& ts, const QDomElement& elem,
+template <typename Element>
+bool readTime(vgTimeStamp& ts, const Element& elem,
               const QString& name, QString* error)
 {
   read_attr(ts.Time, elem, "time", name + " time");
@@ -213,7 +239,8 @@ bool readTime(vgTimeStamp& ts, const QDomElement& elem,
 }
 
 //-----------------------------------------------------------------------------
-bool readCoord(vgGeoRawCoordinate& coord, const QDomElement& elem,
+template <typename Element>
+bool readCoord(vgGeoRawCoordinate& coord, const Element& elem,
                const QString& name, QString* error)
 {
   if (elem.hasAttribute("latitude") && elem.hasAttribute("longitude"))
@@ -241,7 +268,8 @@ bool readCoord(vgGeoRawCoordinate& coord, const QDomElement& elem,
 }
 
 //-----------------------------------------------------------------------------
-bool readNode(const QDomElement& elem, vvTrackId& id, QString* error)
+template <typename Element>
+bool readNode(const Element& elem, vvTrackId& id, QString* error)
 {
   read_attr(id.Source, elem, "source", "track source");
   read_attr(id.SerialNumber, elem, "serial_number", "serial number");
@@ -249,8 +277,9 @@ bool readNode(const QDomElement& elem, vvTrackId& id, QString* error)
 }
 
 //-----------------------------------------------------------------------------
+template <typename Element>
 bool readNode(
-  const QDomElement& elem, vvDescriptorRegionEntry& re, QString* error)
+  const Element& elem, vvDescriptorRegionEntry& re, QString* error)
 {
   test_or_fail(readTime(re.TimeStamp, elem,
                         "descriptor region entry", error));
@@ -426,6 +455,122 @@ bool readNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+//BEGIN stream reader private helper functions
+
+namespace // anonymous
+{
+
+#define init_stream_elem(_x, _tag, _msg) \
+  test_or_die(_x.isStartElement(), "Node is not an XML element"); \
+  test_or_die(_x.name() == _tag, _msg)
+
+//-----------------------------------------------------------------------------
+// Call 'func' for each child element of the current element; 'func' must
+// consume the child element (i.e. read through its end element)
+template <typename Func>
+bool forEachChildElement(QXmlStreamReader& xml, QString* error, Func func)
+{
+  while (xml.readNextStartElement())
+    {
+    test_or_fail(func(xml.name()));
+    }
+
+  test_or_die(!xml.hasError(), "Error parsing XML: " + xml.errorString());
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Build a DOM element from the current element of the stream; this is used
+// for infrequent, small items (query plans, polygons) in order to share the
+// DOM reader logic for those types
+QDomElement readFragment(QXmlStreamReader& xml, QDomDocument& doc)
+{
+  QDomElement elem = doc.createElement(xml.name().toString());
+  foreach (const QXmlStreamAttribute& attr, xml.attributes())
+    {
+    elem.setAttribute(attr.qualifiedName().toString(),
+                      attr.value().toString());
+    }
+
+  while (xml.readNextStartElement())
+    {
+    elem.appendChild(readFragment(xml, doc));
+    }
+
+  return elem;
+}
+
+//-----------------------------------------------------------------------------
+bool readTrackState(
+  QXmlStreamReader& xml, vvTrackState& ts, QString* error)
+{
+  const QXmlStreamAttributes tta = xml.attributes();
+
+  // Read time stamp and image point
+  test_or_fail(::readTime(ts.TimeStamp, tta, "track trajectory", error));
+  read_attr(ts.ImagePoint.X, tta, "x", "track trajectory image point X");
+  read_attr(ts.ImagePoint.Y, tta, "y", "track trajectory image point Y");
+
+  // Read image box
+  read_attr(ts.ImageBox.TopLeft.Y, tta, "bbox_top",
+            "track trajectory image box top");
+  read_attr(ts.ImageBox.TopLeft.X, tta, "bbox_left",
+            "track trajectory image box left");
+  read_attr(ts.ImageBox.BottomRight.Y, tta, "bbox_bottom",
+            "track trajectory image box bottom");
+  read_attr(ts.ImageBox.BottomRight.X, tta, "bbox_right",
+            "track trajectory image box right");
+
+  bool hasWorldLocation = false;
+  return forEachChildElement(xml, error, [&](const QStringRef& tag) -> bool {
+    if (tag == "world_location" && !hasWorldLocation)
+      {
+      // Read world location
+      hasWorldLocation = true;
+      const QXmlStreamAttributes wla = xml.attributes();
+      read_attr(ts.WorldLocation.GCS, wla, "gcs",
+                "track trajectory world location GCS");
+      test_or_fail(readCoord(ts.WorldLocation, wla,
+                             "track trajectory world location", error));
+      }
+    else if (tag == "image_object_point")
+      {
+      // Read image object point
+      const QXmlStreamAttributes ioa = xml.attributes();
+      vvImagePointF ip;
+      read_attr(ip.X, ioa, "x", "track trajectory image object point X");
+      read_attr(ip.Y, ioa, "y", "track trajectory image object point Y");
+      ts.ImageObject.push_back(ip);
+      }
+
+    xml.skipCurrentElement();
+    return true;
+    });
+}
+
+//-----------------------------------------------------------------------------
+bool readValueVector(
+  QXmlStreamReader& xml, std::vector<float>& values, QString* error)
+{
+  return forEachChildElement(xml, error, [&](const QStringRef& tag) -> bool {
+    if (tag == "value")
+      {
+      float value;
+      read_attr(value, xml.attributes(), "data", "descriptor values");
+      values.push_back(value);
+      }
+
+    xml.skipCurrentElement();
+    return true;
+    });
+}
+
+}
+
+//END stream reader private helper functions
+
+///////////////////////////////////////////////////////////////////////////////
+
 //BEGIN writer private helper functions
 
 namespace // anonymous
@@ -865,6 +1010,248 @@ bool vvXmlUtil::readNode(
 
 ///////////////////////////////////////////////////////////////////////////////
 
+//BEGIN vvXmlUtil public stream reader functions
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vvTrack& track, QString* error)
+{
+  init_stream_elem(xml, "track", "Node is not a track");
+
+  track = vvTrack();
+
+  // Read track ID
+  test_or_fail(::readNode(xml.attributes(), track.Id, error));
+
+  return forEachChildElement(xml, error, [&](const QStringRef& tag) -> bool {
+    if (tag == "classification")
+      {
+      // Read track classification
+      const QXmlStreamAttributes tca = xml.attributes();
+      QString type;
+      double value;
+      read_attr(type, tca, "type", "track classification entry type");
+      read_attr(value, tca, "value",
+                "track classification entry probability");
+      track.Classification.insert(std::make_pair(stdString(type), value));
+      }
+    else if (tag == "trajectory_state")
+      {
+      // Read track state (this consumes the element)
+      vvTrackState ts;
+      test_or_fail(readTrackState(xml, ts, error));
+      track.Trajectory.insert(track.Trajectory.end(), ts);
+      return true;
+      }
+
+    xml.skipCurrentElement();
+    return true;
+    });
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vvDescriptor& descriptor, QString* error)
+{
+  init_stream_elem(xml, "descriptor", "Node is not a descriptor");
+
+  descriptor = vvDescriptor();
+
+  // Read basic descriptor attributes
+  const QXmlStreamAttributes attrs = xml.attributes();
+  read_attr(descriptor.DescriptorName, attrs, "name",
+            "descriptor name");
+  read_attr(descriptor.ModuleName, attrs, "module",
+            "descriptor module name");
+  read_attr(descriptor.InstanceId, attrs, "instance_id",
+            "descriptor instance ID");
+  read_attr(descriptor.Confidence, attrs, "confidence",
+            "descriptor confidence");
+
+  return forEachChildElement(xml, error, [&](const QStringRef& tag) -> bool {
+    if (tag == "value_vector")
+      {
+      // Read values (this consumes the element)
+      std::vector<float> values;
+      test_or_fail(readValueVector(xml, values, error));
+      descriptor.Values.push_back(values);
+      return true;
+      }
+    else if (tag == "region")
+      {
+      // Read region
+      vvDescriptorRegionEntry region;
+      test_or_fail(::readNode(xml.attributes(), region, error));
+      descriptor.Region.insert(descriptor.Region.end(), region);
+      }
+    else if (tag == "track")
+      {
+      // Read track reference
+      vvTrackId tid;
+      test_or_fail(::readNode(xml.attributes(), tid, error));
+      descriptor.TrackIds.push_back(tid);
+      }
+
+    xml.skipCurrentElement();
+    return true;
+    });
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vvQueryInstance& query, QString* error)
+{
+  init_stream_elem(xml, "query", "Node is not a query plan");
+
+  QDomDocument doc;
+  const QDomElement elem = readFragment(xml, doc);
+  test_or_die(!xml.hasError(), "Error parsing XML: " + xml.errorString());
+
+  return vvXmlUtil::readNode(elem, query, error);
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vvQueryResult& result, QString* error)
+{
+  init_stream_elem(xml, "query_result", "Node is not a query result");
+
+  result = vvQueryResult();
+
+  // Read basic result attributes
+  const QXmlStreamAttributes attrs = xml.attributes();
+  read_attr(result.QueryId, attrs, "query", "result query ID");
+  read_attr(result.StreamId, attrs, "stream", "result stream ID");
+  read_attr(result.MissionId, attrs, "mission", "result mission ID");
+  read_attr(result.InstanceId, attrs, "instance_id", "result instance ID");
+
+  // Read user notes
+  read_attr_opt(result.UserData.Notes, attrs, "notes", "result user notes");
+
+  bool hasTemporalLocation = false;
+  bool hasSpatialLocation = false;
+  bool hasScore = false;
+
+  return forEachChildElement(xml, error, [&](const QStringRef& tag) -> bool {
+    if (tag == "temporal_location" && !hasTemporalLocation)
+      {
+      // Read temporal location
+      hasTemporalLocation = true;
+      const QXmlStreamAttributes tla = xml.attributes();
+      read_attr(result.StartTime, tla, "start", "result start time");
+      read_attr(result.EndTime, tla, "end", "result end time");
+      }
+    else if (tag == "spatial_location" && !hasSpatialLocation)
+      {
+      // Read spatial location
+      hasSpatialLocation = true;
+      const QXmlStreamAttributes sla = xml.attributes();
+      read_attr(result.Location.GCS, sla, "gcs", "result location GCS");
+      test_or_fail(readCoord(result.Location, sla,
+                             "result location", error));
+      }
+    else if (tag == "score" && !hasScore)
+      {
+      // Read basic score attributes
+      hasScore = true;
+      const QXmlStreamAttributes rsa = xml.attributes();
+      read_attr_opt(result.Rank, rsa, "rank", "result rank");
+      read_attr_opt(result.RelevancyScore, rsa, "relevancy",
+                    "result relevancy");
+
+      // Read user classification
+      const QString rating = rsa.value("rating").toString();
+      if (!rating.isEmpty())
+        {
+        BEGIN_MAP_FROM_STRING(vvIqr::Classification, rating,
+                              result.UserScore);
+        MAP_FROM_STRING("positive",     vvIqr::PositiveExample);
+        MAP_FROM_STRING("negative",     vvIqr::NegativeExample);
+        MAP_FROM_STRING("unclassified", vvIqr::UnclassifiedExample);
+        END_MAP_FROM_STRING(
+          QString("Error reading result user classification:"
+                  " '%1' is not a valid classification").arg(rating));
+        }
+
+      // Read user flags
+      const QStringList flags =
+        rsa.value("flags").toString().split(',', QString::SkipEmptyParts);
+      foreach (const QString& flag, flags)
+        {
+        // Test for known flags
+        accept_flag("starred", vvUserData::Starred)
+        // If we get here, the flag is not recognized
+        const QString msg =
+          "Error reading result user flags: unknown flag '%1'";
+        die(msg.arg(flag));
+        }
+      }
+    else if (tag == "track")
+      {
+      // Read track (this consumes the element)
+      vvTrack track;
+      test_or_fail(readElement(xml, track, error));
+      result.Tracks.push_back(track);
+      return true;
+      }
+    else if (tag == "descriptor")
+      {
+      // Read descriptor (this consumes the element)
+      vvDescriptor descriptor;
+      test_or_fail(readElement(xml, descriptor, error));
+      result.Descriptors.push_back(descriptor);
+      return true;
+      }
+
+    xml.skipCurrentElement();
+    return true;
+    });
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vvEventSetInfo& info, QString* error)
+{
+  init_stream_elem(xml, "event_meta", "Node is not event set information");
+
+  info = vvEventSetInfo();
+
+  // Read attributes
+  const QXmlStreamAttributes attrs = xml.attributes();
+  read_attr(info.Name, attrs, "name",
+            "event set name");
+  read_attr(info.DisplayThreshold, attrs, "display_threshold",
+            "event set display threshold");
+  read_attr(info.PenColor, attrs, "pen_color",
+            "event set pen color");
+  read_attr(info.BackgroundColor, attrs, "background_color",
+            "event set background color");
+  read_attr(info.ForegroundColor, attrs, "foreground_color",
+            "event set foreground color");
+
+  // Done
+  xml.skipCurrentElement();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+bool vvXmlUtil::readElement(
+  QXmlStreamReader& xml, vgGeocodedPoly& poly,
+  vvDatabaseQuery::IntersectionType* filterMode, QString* error)
+{
+  init_stream_elem(xml, "geo_poly", "Node is not a geocoded polygon");
+
+  QDomDocument doc;
+  const QDomElement elem = readFragment(xml, doc);
+  test_or_die(!xml.hasError(), "Error parsing XML: " + xml.errorString());
+
+  return vvXmlUtil::readNode(elem, poly, filterMode, error);
+}
+
+//END vvXmlUtil public stream reader functions
+
+///////////////////////////////////////////////////////////////////////////////
+
 //BEGIN vvXmlUtil public writer functions
 
 //-----------------------------------------------------------------------------
@@ -11,6 +11,7 @@
 
 class QDomDocument;
 class QDomNode;
+class QXmlStreamReader;
 
 #define OUT_ERROR QString* error = 0
 
@@ -24,6 +25,20 @@ namespace vvXmlUtil
   VV_IO_EXPORT bool readNode(const QDomNode&, vgGeocodedPoly&,
                              vvDatabaseQuery::IntersectionType*, OUT_ERROR);
 
+  // Stream readers; the stream must be positioned at the start of the
+  // element to be read, and (on success) is left at its end element
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vvTrack&, OUT_ERROR);
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vvDescriptor&, OUT_ERROR);
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vvQueryInstance&,
+                                OUT_ERROR);
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vvQueryResult&,
+                                OUT_ERROR);
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vvEventSetInfo&,
+                                OUT_ERROR);
+  VV_IO_EXPORT bool readElement(QXmlStreamReader&, vgGeocodedPoly&,
+                                vvDatabaseQuery::IntersectionType*,
+                                OUT_ERROR);
+
   VV_IO_EXPORT QDomNode makeNode(QDomDocument&, const vvTrack&);
   VV_IO_EXPORT QDomNode makeNode(QDomDocument&, const vvDescriptor&);
   VV_IO_EXPORT QDomNode makeNode(QDomDocument&, const vvDatabaseQuery&);
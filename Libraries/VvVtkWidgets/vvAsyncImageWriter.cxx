@@ -0,0 +1,118 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vvAsyncImageWriter.h"
+
+#include <QAtomicInt>
+#include <QDebug>
+#include <QSemaphore>
+#include <QString>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+
+#include <vtkErrorCode.h>
+#include <vtkImageData.h>
+#include <vtkPNGWriter.h>
+#include <vtkPNMWriter.h>
+#include <vtkSmartPointer.h>
+
+#include <qtStlUtil.h>
+
+#include <string>
+
+QTE_IMPLEMENT_D_FUNC(vvAsyncImageWriter)
+
+//-----------------------------------------------------------------------------
+class vvAsyncImageWriterPrivate
+{
+public:
+  void writeImage(vtkSmartPointer<vtkImageData> image,
+                  const std::string& fileName,
+                  vvAsyncImageWriter::Format format);
+
+  QThreadPool Pool;
+  QSemaphore Slots;
+  QAtomicInt Failures;
+};
+
+//-----------------------------------------------------------------------------
+void vvAsyncImageWriterPrivate::writeImage(
+  vtkSmartPointer<vtkImageData> image, const std::string& fileName,
+  vvAsyncImageWriter::Format format)
+{
+  // Each task uses its own writer, as the writers are not thread safe
+  vtkSmartPointer<vtkImageWriter> writer;
+  if (format == vvAsyncImageWriter::Png)
+    {
+    writer = vtkSmartPointer<vtkPNGWriter>::New();
+    }
+  else
+    {
+    writer = vtkSmartPointer<vtkPNMWriter>::New();
+    }
+
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(image);
+  writer->Write();
+
+  if (writer->GetErrorCode() != vtkErrorCode::NoError)
+    {
+    qWarning() << "vvAsyncImageWriter: failed to write"
+               << qtString(fileName) << ":"
+               << vtkErrorCode::GetStringFromErrorCode(
+                    writer->GetErrorCode());
+    this->Failures.ref();
+    }
+
+  this->Slots.release();
+}
+
+//-----------------------------------------------------------------------------
+vvAsyncImageWriter::vvAsyncImageWriter(int maxPending)
+  : d_ptr(new vvAsyncImageWriterPrivate)
+{
+  QTE_D(vvAsyncImageWriter);
+
+  if (maxPending < 1)
+    {
+    maxPending = 2 * d->Pool.maxThreadCount();
+    }
+  d->Slots.release(maxPending);
+}
+
+//-----------------------------------------------------------------------------
+vvAsyncImageWriter::~vvAsyncImageWriter()
+{
+  this->waitForDone();
+}
+
+//-----------------------------------------------------------------------------
+void vvAsyncImageWriter::write(
+  vtkImageData* image, const QString& fileName, Format format)
+{
+  QTE_D(vvAsyncImageWriter);
+
+  // Take a shallow copy, so that the caller is free to reuse the image object
+  vtkSmartPointer<vtkImageData> imageCopy =
+    vtkSmartPointer<vtkImageData>::New();
+  imageCopy->ShallowCopy(image);
+
+  // Wait for a free slot; this keeps the number of images that are waiting to
+  // be written (and thus the memory held by them) bounded
+  d->Slots.acquire();
+
+  const std::string path = stdString(fileName);
+  QtConcurrent::run(&d->Pool, [d, imageCopy, path, format]{
+    d->writeImage(imageCopy, path, format);
+  });
+}
+
+//-----------------------------------------------------------------------------
+int vvAsyncImageWriter::waitForDone()
+{
+  QTE_D(vvAsyncImageWriter);
+
+  d->Pool.waitForDone();
+  return d->Failures.fetchAndStoreOrdered(0);
+}
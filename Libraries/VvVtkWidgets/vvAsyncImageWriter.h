@@ -0,0 +1,65 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vvAsyncImageWriter_h
+#define __vvAsyncImageWriter_h
+
+#include <QScopedPointer>
+
+#include <qtGlobal.h>
+
+#include <vgExport.h>
+
+class QString;
+
+class vtkImageData;
+
+class vvAsyncImageWriterPrivate;
+
+/// Image file writer which encodes images on a pool of worker threads.
+///
+/// Images passed to write() are queued and encoded in the background, so that
+/// the caller can continue to decode and render further images. The number of
+/// queued images is limited in order to bound memory use; write() blocks
+/// while the queue is full. The destructor waits for all queued images to be
+/// written.
+class VV_VTKWIDGETS_EXPORT vvAsyncImageWriter
+{
+public:
+  enum Format
+    {
+    Png,
+    Pnm
+    };
+
+  /// Create writer.
+  ///
+  /// At most \p maxPending images will be queued at once. If \p maxPending is
+  /// less than 1, twice the number of worker threads is used.
+  explicit vvAsyncImageWriter(int maxPending = -1);
+  ~vvAsyncImageWriter();
+
+  /// Queue an image to be written to \p fileName.
+  ///
+  /// The writer keeps a reference to the scalars of \p image, which must not
+  /// be modified in place until the image has been written. The image object
+  /// itself may be reused (e.g. by calling its ShallowCopy method) as soon as
+  /// this method returns.
+  void write(vtkImageData* image, const QString& fileName, Format format);
+
+  /// Wait until all queued images have been written.
+  ///
+  /// \return Number of images that could not be written since the previous
+  ///         call to this method.
+  int waitForDone();
+
+protected:
+  QTE_DECLARE_PRIVATE_RPTR(vvAsyncImageWriter)
+
+private:
+  QTE_DECLARE_PRIVATE(vvAsyncImageWriter)
+  Q_DISABLE_COPY(vvAsyncImageWriter)
+};
+
+#endif
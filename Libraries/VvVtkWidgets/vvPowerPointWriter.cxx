@@ -4,6 +4,8 @@
 
 #include "vvPowerPointWriter.h"
 
+#include "vvAsyncImageWriter.h"
+
 #include <QDebug>
 #include <QDir>
 #include <QEventLoop>
@@ -16,9 +18,9 @@
 #include <vtkImageActor.h>
 #include <vtkNew.h>
 #include <vtkPNGWriter.h>
-#include <vtkPNMWriter.h>
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
+#include <vtkSmartPointer.h>
 #include <vtkWindowToImageFilter.h>
 
 #include <qtStlUtil.h>
@@ -44,9 +46,18 @@ public:
   void reportError(QString message);
 
 public:
-  vtkNew<vtkPNMWriter> PnmWriter;
   vtkNew<vtkPNGWriter> PngWriter;
 
+  // Video frame images are encoded on worker threads, and are only waited for
+  // when the video is created
+  vvAsyncImageWriter VideoImageWriter;
+
+  // Render window used to write video images is kept between frames, rather
+  // than being recreated for every frame
+  vtkSmartPointer<vtkRenderWindow> VideoRenderWindow;
+  vtkSmartPointer<vtkRenderer> VideoRenderer;
+  vtkSmartPointer<vtkImageActor> VideoImageActor;
+
   int Instance;
   bool Canceled;
 
@@ -214,23 +225,33 @@ void vvPowerPointWriter::writeVideoImageWithRep(vtkImageData* imageData,
   int dim[3];
   imageData->GetDimensions(dim);
 
-  vtkNew<vtkRenderer> renderer;
-  vtkNew<vtkRenderWindow> renderWindow;
+  if (!d->VideoRenderWindow)
+    {
+    d->VideoRenderer = vtkSmartPointer<vtkRenderer>::New();
+    d->VideoRenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    d->VideoImageActor = vtkSmartPointer<vtkImageActor>::New();
+
+    d->VideoRenderWindow->SetOffScreenRendering(1);
+    d->VideoRenderWindow->AddRenderer(d->VideoRenderer);
+    d->VideoRenderer->GetActiveCamera()->ParallelProjectionOn();
+    }
 
-  renderWindow->SetSize(dim[0], dim[1]);
-  renderWindow->SetOffScreenRendering(1);
-  renderWindow->AddRenderer(renderer.GetPointer());
-  renderer->GetActiveCamera()->ParallelProjectionOn();
+  int* size = d->VideoRenderWindow->GetSize();
+  if (size[0] != dim[0] || size[1] != dim[1])
+    {
+    d->VideoRenderWindow->SetSize(dim[0], dim[1]);
+    }
 
-  vtkNew<vtkImageActor> imageProp;
+  vtkRenderer* renderer = d->VideoRenderer;
+  renderer->RemoveAllViewProps();
 
   // Add image actor
-  imageProp->SetInputData(imageData);
-  renderer->AddViewProp(imageProp.GetPointer());
+  d->VideoImageActor->SetInputData(imageData);
+  renderer->AddViewProp(d->VideoImageActor);
 
   double bounds[6];
-  imageProp->GetBounds(bounds);
-  vtkVgRendererUtils::ZoomToExtents2D(renderer.GetPointer(), bounds);
+  d->VideoImageActor->GetBounds(bounds);
+  vtkVgRendererUtils::ZoomToExtents2D(renderer, bounds);
 
   props->InitTraversal();
   while (vtkProp* prop = props->GetNextProp())
@@ -239,10 +260,10 @@ void vvPowerPointWriter::writeVideoImageWithRep(vtkImageData* imageData,
     }
 
   // Render to image
-  renderWindow->Render();
+  d->VideoRenderWindow->Render();
 
   vtkNew<vtkWindowToImageFilter> windowToImageFilter;
-  windowToImageFilter->SetInput(renderWindow.GetPointer());
+  windowToImageFilter->SetInput(d->VideoRenderWindow);
   windowToImageFilter->Update();
 
   const QString path =
@@ -256,9 +277,8 @@ void vvPowerPointWriter::writeVideoImageWithRep(vtkImageData* imageData,
   // Write as PNM/PPM file as it's much faster than generating a PNG
   const QString filepath =
     QString("%2/%1.pnm").arg(frameNumber, 6, 10, QChar('0')).arg(path);
-  d->PnmWriter->SetFileName(qPrintable(filepath));
-  d->PnmWriter->SetInputConnection(windowToImageFilter->GetOutputPort());
-  d->PnmWriter->Write();
+  d->VideoImageWriter.write(windowToImageFilter->GetOutput(), filepath,
+                            vvAsyncImageWriter::Pnm);
 }
 
 //-----------------------------------------------------------------------------
@@ -270,6 +290,13 @@ QString vvPowerPointWriter::createVideo(int outputId)
     QString("%2/%1").arg(outputId).arg(d->OutputFile);
 
   const QString filePath = imagePath + ".wmv";
+
+  // All of the frame images must be written before they can be encoded
+  if (d->VideoImageWriter.waitForDone() > 0)
+    {
+    qWarning() << "Some video images could not be written";
+    }
+
   QStringList args;
   args << "-y"; // overwrite existing
   args << "-r";
@@ -343,6 +370,7 @@ vvPowerPointWriter::~vvPowerPointWriter()
 void vvPowerPointWriter::cancel()
 {
   QTE_D(vvPowerPointWriter);
+  d->VideoImageWriter.waitForDone();
   kwpptDiscard(d->Instance);
   d->Canceled = true;
 }
@@ -4,6 +4,8 @@
 
 #include "vvReportWriter.h"
 
+#include "vvAsyncImageWriter.h"
+
 #include <QDebug>
 #include <QDir>
 #include <QDomDocument>
@@ -20,8 +22,6 @@
 #include <vtkImageActor.h>
 #include <vtkImageData.h>
 #include <vtkMatrix4x4.h>
-#include <vtkPNGWriter.h>
-#include <vtkPNMWriter.h>
 #include <vtkPoints.h>
 #include <vtkPropCollection.h>
 #include <vtkRenderer.h>
@@ -75,8 +75,6 @@ public:
     : File(file), TextStream(&file), Document(),
       OverviewElement(Document.createElement("Overview")),
       EventsElement(Document.createElement("ReportedEvents")),
-      PngWriter(vtkSmartPointer<vtkPNGWriter>::New()),
-      PnmWriter(vtkSmartPointer<vtkPNMWriter>::New()),
       Event(0), EventTypeRegistry(0), Rank(-1), RelevancyScore(-1.0),
       Track(0), Context(0), ImageData(0), CurrentId(-1)
     {
@@ -115,8 +113,17 @@ public:
   QDomElement EventsElement;
   QDomElement CurrentEventElement;
 
-  vtkSmartPointer<vtkPNGWriter> PngWriter;
-  vtkSmartPointer<vtkPNMWriter> PnmWriter;
+  // Images are encoded on worker threads; only the report document itself is
+  // assembled (in order) on the calling thread
+  vvAsyncImageWriter ImageWriter;
+
+  // Render window and event representation used to write video images are
+  // kept between frames, rather than being recreated for every frame
+  vtkSmartPointer<vtkRenderWindow> VideoRenderWindow;
+  vtkSmartPointer<vtkRenderer> VideoRenderer;
+  vtkSmartPointer<vtkImageActor> VideoImageActor;
+  vtkSmartPointer<vtkVgEventModel> VideoEventModel;
+  vtkSmartPointer<vtkVgEventRegionRepresentation> VideoEventRepresentation;
 
   vtkVgEvent* Event;
   vtkVgEventTypeRegistry* EventTypeRegistry;
@@ -168,6 +175,7 @@ vvReportWriter::~vvReportWriter()
 {
   QTE_D(vvReportWriter);
 
+  d->ImageWriter.waitForDone();
   d->TextStream << d->Document.toString();
 }
 
@@ -183,6 +191,12 @@ void vvReportWriter::setEvent(vtkVgEvent* event,
 {
   QTE_D(vvReportWriter);
 
+  if (d->Event != event)
+    {
+    d->VideoEventModel = 0;
+    d->VideoEventRepresentation = 0;
+    }
+
   d->Event = event;
   d->CurrentId = outputId;
   d->EventNote = eventNote;
@@ -306,9 +320,8 @@ void vvReportWriter::writeOverview()
   const QString filename = "overview.png";
   const QString filePath = QString("%1/%2").arg(path, filename);
 
-  d->PngWriter->SetFileName(qPrintable(filePath));
-  d->PngWriter->SetInputConnection(windowToImageFilter->GetOutputPort());
-  d->PngWriter->Write();
+  d->ImageWriter.write(windowToImageFilter->GetOutput(), filePath,
+                       vvAsyncImageWriter::Png);
 
   // Create overview info
   QDomElement overviewElem = d->Document.createElement("OverviewImage");
@@ -370,9 +383,7 @@ void vvReportWriter::writeEventSummary()
   QString warpedFilePath = "%1/%2.warped.png";
   warpedFilePath = warpedFilePath.arg(path).arg(d->CurrentId);
 
-  d->PngWriter->SetFileName(qPrintable(filePath));
-  d->PngWriter->SetInputData(d->ImageData);
-  d->PngWriter->Write();
+  d->ImageWriter.write(d->ImageData, filePath, vvAsyncImageWriter::Png);
 
   vtkSmartPointer<vtkMatrix4x4> imageToWorld;
   double viewBounds[4];
@@ -494,9 +505,8 @@ void vvReportWriter::writeEventSummary()
     windowToImageFilter->SetInputBufferTypeToRGBA();
     windowToImageFilter->Update();
 
-    d->PngWriter->SetFileName(qPrintable(contextFilePath));
-    d->PngWriter->SetInputConnection(windowToImageFilter->GetOutputPort());
-    d->PngWriter->Write();
+    d->ImageWriter.write(windowToImageFilter->GetOutput(), contextFilePath,
+                         vvAsyncImageWriter::Png);
 
     // Hide context and show image
     props->InitTraversal();
@@ -506,12 +516,18 @@ void vvReportWriter::writeEventSummary()
       }
     imageProp->SetVisibility(1);
 
-    // Render warped image in same coordinates as context
+    // Render warped image in same coordinates as context; use a new filter,
+    // as the output of the previous one may still be waiting to be written
     renderWindow->Render();
-    windowToImageFilter->Modified();
 
-    d->PngWriter->SetFileName(qPrintable(warpedFilePath));
-    d->PngWriter->Write();
+    vtkSmartPointer<vtkWindowToImageFilter> warpedImageFilter =
+      vtkSmartPointer<vtkWindowToImageFilter>::New();
+    warpedImageFilter->SetInput(renderWindow);
+    warpedImageFilter->SetInputBufferTypeToRGBA();
+    warpedImageFilter->Update();
+
+    d->ImageWriter.write(warpedImageFilter->GetOutput(), warpedFilePath,
+                         vvAsyncImageWriter::Png);
     }
 
   QDomElement eventElem = d->Document.createElement("Event");
@@ -832,53 +848,61 @@ void vvReportWriter::writeEventVideoImage(int number)
                 d->ImageData->GetDimensions()[1]
               };
 
-  vtkSmartPointer<vtkRenderer> renderer =
-    vtkSmartPointer<vtkRenderer>::New();
+  if (!d->VideoRenderWindow)
+    {
+    d->VideoRenderer = vtkSmartPointer<vtkRenderer>::New();
+    d->VideoRenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    d->VideoImageActor = vtkSmartPointer<vtkImageActor>::New();
 
-  vtkSmartPointer<vtkRenderWindow> renderWindow =
-    vtkSmartPointer<vtkRenderWindow>::New();
+    d->VideoRenderWindow->SetOffScreenRendering(1);
+    d->VideoRenderWindow->AddRenderer(d->VideoRenderer);
+    d->VideoRenderer->GetActiveCamera()->ParallelProjectionOn();
+    }
 
-  renderWindow->SetSize(dim[0], dim[1]);
-  renderWindow->SetOffScreenRendering(1);
-  renderWindow->AddRenderer(renderer);
-  renderer->GetActiveCamera()->ParallelProjectionOn();
+  int* size = d->VideoRenderWindow->GetSize();
+  if (size[0] != dim[0] || size[1] != dim[1])
+    {
+    d->VideoRenderWindow->SetSize(dim[0], dim[1]);
+    }
 
-  vtkSmartPointer<vtkImageActor> imageProp =
-    vtkSmartPointer<vtkImageActor>::New();
+  vtkRenderer* renderer = d->VideoRenderer;
+  renderer->RemoveAllViewProps();
 
   // Add image actor
-  imageProp->SetInputData(d->ImageData);
-  renderer->AddViewProp(imageProp);
+  d->VideoImageActor->SetInputData(d->ImageData);
+  renderer->AddViewProp(d->VideoImageActor);
 
   double bounds[6];
-  imageProp->GetBounds(bounds);
+  d->VideoImageActor->GetBounds(bounds);
   vtkVgRendererUtils::ZoomToExtents2D(renderer, bounds);
 
-  // Add event representation
-  vtkSmartPointer<vtkVgEventModel> eventModel =
-    vtkSmartPointer<vtkVgEventModel>::New();
-
-  vtkSmartPointer<vtkVgEventRegionRepresentation> eventRep =
-    vtkSmartPointer<vtkVgEventRegionRepresentation>::New();
+  // Add event representation; this is only (re)built when the event changes
+  if (!d->VideoEventRepresentation)
+    {
+    d->VideoEventModel = vtkSmartPointer<vtkVgEventModel>::New();
+    d->VideoEventRepresentation =
+      vtkSmartPointer<vtkVgEventRegionRepresentation>::New();
 
-  vtkSmartPointer<vtkVgEventBase> eventCopy =
-    vtkSmartPointer<vtkVgEventBase>::New();
+    vtkSmartPointer<vtkVgEventBase> eventCopy =
+      vtkSmartPointer<vtkVgEventBase>::New();
 
-  // Need to make a copy of the event so that it points to the right points
-  eventCopy->SetRegionPoints(eventModel->GetSharedRegionPoints());
-  eventCopy->DeepCopy(d->Event);
+    // Need to make a copy of the event so that it points to the right points
+    eventCopy->SetRegionPoints(d->VideoEventModel->GetSharedRegionPoints());
+    eventCopy->DeepCopy(d->Event);
 
-  eventModel->AddEvent(eventCopy);
-  eventRep->SetEventModel(eventModel);
-  eventRep->SetEventTypeRegistry(d->EventTypeRegistry);
-  eventRep->SetRegionZOffset(0.1);
+    d->VideoEventModel->AddEvent(eventCopy);
+    d->VideoEventRepresentation->SetEventModel(d->VideoEventModel);
+    d->VideoEventRepresentation->SetEventTypeRegistry(d->EventTypeRegistry);
+    d->VideoEventRepresentation->SetRegionZOffset(0.1);
+    }
 
+  vtkVgEventRegionRepresentation* eventRep = d->VideoEventRepresentation;
   if (d->ModelToImage)
     {
     eventRep->SetRepresentationMatrix(d->ModelToImage);
     }
 
-  eventModel->Update(d->ImageTimeStamp);
+  d->VideoEventModel->Update(d->ImageTimeStamp);
   eventRep->Update();
 
   vtkPropCollection* props = eventRep->GetActiveRenderObjects();
@@ -889,11 +913,11 @@ void vvReportWriter::writeEventVideoImage(int number)
     }
 
   // Render to image
-  renderWindow->Render();
+  d->VideoRenderWindow->Render();
 
   vtkSmartPointer<vtkWindowToImageFilter> windowToImageFilter =
     vtkSmartPointer<vtkWindowToImageFilter>::New();
-  windowToImageFilter->SetInput(renderWindow);
+  windowToImageFilter->SetInput(d->VideoRenderWindow);
   windowToImageFilter->Update();
 
   QString path = "%1/%2";
@@ -908,9 +932,8 @@ void vvReportWriter::writeEventVideoImage(int number)
   QString filepath = "%1/%2.pnm";
   filepath = filepath.arg(path)
                      .arg(number, 6, 10, QChar('0'));
-  d->PnmWriter->SetFileName(qPrintable(filepath));
-  d->PnmWriter->SetInputConnection(windowToImageFilter->GetOutputPort());
-  d->PnmWriter->Write();
+  d->ImageWriter.write(windowToImageFilter->GetOutput(), filepath,
+                       vvAsyncImageWriter::Pnm);
 }
 
 //-----------------------------------------------------------------------------
@@ -924,6 +947,12 @@ void vvReportWriter::writeEventVideo()
 
   QString filePath = imagePath + ".wmv";
 
+  // All of the frame images must be written before they can be encoded
+  if (d->ImageWriter.waitForDone() > 0)
+    {
+    qDebug() << "Some video images could not be written";
+    }
+
   QStringList args;
   args << "-y"; // overwrite existing
   args << "-r";
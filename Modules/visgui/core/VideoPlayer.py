@@ -20,7 +20,13 @@ class VideoPlayer:
     self._renderer = renderer
     self._actor = vtkRenderingCorePython.vtkImageActor()
     self._videoSource = None
+    # Keep decoded frames around the play head, and decode the frames that
+    # follow it in the background while the current one is displayed
+    self._videoCache = vtkVgVideoCache()
+    self._videoCache.SetEvictionPolicyToPrefetchWindow()
+    self._videoCache.SetPrefetchCount(8)
     self._videoModel = vtkVgVideoModel()
+    self._videoModel.SetVideoSource(self._videoCache)
     self._trackModel = vtkVgTrackModel()
     self._trackModel.SetDisplayAllTracks(True)
     self._trackModel.SetTrackExpirationOffset(vtkVgTimeStamp(1.5e6, 15))
@@ -49,7 +55,7 @@ class VideoPlayer:
   def Init(self, streamId):
     self._streamId = streamId
     self._videoSource = vtkVgKwaVideoSource()
-    self._videoModel.SetVideoSource(self._videoSource)
+    self._videoCache.SetVideoSource(self._videoSource)
 
     if not self._videoSource.Open(streamId):
       raise IOError(0, 'Unable to open video stream %s' % streamId)
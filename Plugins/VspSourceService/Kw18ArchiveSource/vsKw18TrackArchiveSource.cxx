@@ -4,14 +4,9 @@
 
 #include "vsKw18TrackArchiveSource.h"
 
-#include <qtThread.h>
-
-#include <tracking/kw18_reader.h>
-
 #include <vsAdapt.h>
 #include <vsArchiveSourcePrivate.h>
-
-#include <vvAdaptVidtk.h>
+#include <vsKw18TrackReader.h>
 
 //-----------------------------------------------------------------------------
 class vsKw18TrackArchiveSourcePrivate : public vsArchiveSourcePrivate
@@ -39,33 +34,23 @@ bool vsKw18TrackArchiveSourcePrivate::processArchive(const QUrl& uri)
 {
   QTE_Q(vsKw18TrackArchiveSource);
 
-  QString fileName = uri.toLocalFile();
-  vidtk::kw18_reader trackReader(qPrintable(fileName));
-
-  // Read tracks
-  std::vector<vidtk::track_sptr> tracks;
-  if (!trackReader.read(tracks))
+  vsKw18TrackReader reader;
+  if (!reader.open(uri.toLocalFile()))
     {
     return false;
     }
 
-  // Process the tracks
-  for (size_t n = 0; n < tracks.size(); ++n)
-    {
-    QList<vvTrackState> states;
-    vsTrackId id = vsAdaptTrackId(tracks[n]->id());
-    const std::vector<vidtk::track_state_sptr>& h = tracks[n]->history();
-    for (size_t j = 0; j < h.size(); ++j)
+  // Emit tracks as they are completed, rather than waiting for the entire
+  // file to be read
+  return reader.readTracks([q](QList<vsKw18TrackReader::Track>& tracks){
+    foreach (const vsKw18TrackReader::Track& track, tracks)
       {
-      vidtk::track_state_sptr s = h[j];
-      states.append(vvAdapt(*s));
+      const vsTrackId id = vsAdaptTrackId(track.Id);
+      emit q->trackUpdated(id, track.States);
+      emit q->trackClosed(id);
       }
-    emit q->trackUpdated(id, states);
-    emit q->trackClosed(id);
-    }
-
-  // Done
-  return true;
+    return true;
+  });
 }
 
 //-----------------------------------------------------------------------------
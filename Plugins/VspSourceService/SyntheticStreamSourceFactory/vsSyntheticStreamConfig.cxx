@@ -0,0 +1,125 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsSyntheticStreamConfig.h"
+
+#include <QPair>
+#include <QStringList>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include <limits>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+bool fail(QString* error, const QString& message)
+{
+  if (error)
+    {
+    *error = message;
+    }
+  return false;
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+bool parseValue(const QString& text, T& out, T minimum)
+{
+  // Values outside the range of the output type (including NaN) are
+  // rejected, as converting them to an integer type is undefined
+  bool okay;
+  const double value = text.toDouble(&okay);
+  if (!okay || !(value >= static_cast<double>(minimum)) ||
+      !(value <= static_cast<double>(std::numeric_limits<T>::max())))
+    {
+    return false;
+    }
+  out = static_cast<T>(value);
+  return true;
+}
+
+} // namespace <anonymous>
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamConfig::vsSyntheticStreamConfig() :
+  Seed(1), FrameRate(30.0), Speed(1.0), Frames(0), Width(640), Height(480),
+  MaxTracks(100), BirthRate(10.0), Lifetime(10.0), StateRate(30.0),
+  DescriptorRate(1.0), EventRate(1.0), StatsInterval(5.0)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vsSyntheticStreamConfig::parse(const QUrl& uri, QString* error)
+{
+  if (uri.scheme() != "synthetic")
+    {
+    return fail(error, "The scheme " + uri.scheme() + " is not supported.");
+    }
+
+  typedef QPair<QString, QString> Item;
+  foreach (const Item& item,
+           QUrlQuery(uri).queryItems(QUrl::FullyDecoded))
+    {
+    const QString& key = item.first;
+    const QString& value = item.second;
+
+    bool okay = true;
+    if (key == "seed")
+      okay = parseValue(value, this->Seed, 0u);
+    else if (key == "rate")
+      okay = parseValue(value, this->FrameRate, 1e-3);
+    else if (key == "speed")
+      okay = parseValue(value, this->Speed, 0.0);
+    else if (key == "frames")
+      okay = parseValue(value, this->Frames, 0u);
+    else if (key == "width")
+      okay = parseValue(value, this->Width, 1);
+    else if (key == "height")
+      okay = parseValue(value, this->Height, 1);
+    else if (key == "tracks")
+      okay = parseValue(value, this->MaxTracks, 0);
+    else if (key == "births")
+      okay = parseValue(value, this->BirthRate, 0.0);
+    else if (key == "lifetime")
+      okay = parseValue(value, this->Lifetime, 0.0);
+    else if (key == "states")
+      okay = parseValue(value, this->StateRate, 1e-3);
+    else if (key == "descriptors")
+      okay = parseValue(value, this->DescriptorRate, 0.0);
+    else if (key == "events")
+      okay = parseValue(value, this->EventRate, 0.0);
+    else if (key == "stats")
+      okay = parseValue(value, this->StatsInterval, 0.0);
+    else if (key == "stats-file")
+      this->StatsFile = value;
+    else if (key == "event-types")
+      {
+      this->EventTypes.clear();
+      foreach (const QString& type,
+               value.split(',', QString::SkipEmptyParts))
+        {
+        const int t = type.toInt(&okay);
+        if (!okay)
+          {
+          break;
+          }
+        this->EventTypes.append(t);
+        }
+      }
+    else
+      {
+      return fail(error, "Unknown parameter \"" + key + "\".");
+      }
+
+    if (!okay)
+      {
+      return fail(error, "Invalid value \"" + value +
+                         "\" for parameter \"" + key + "\".");
+      }
+    }
+
+  return true;
+}
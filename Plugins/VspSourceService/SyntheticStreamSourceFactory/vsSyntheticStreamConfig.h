@@ -0,0 +1,56 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsSyntheticStreamConfig_h
+#define __vsSyntheticStreamConfig_h
+
+#include <QList>
+#include <QString>
+
+class QUrl;
+
+/// Parameters of a synthetic stream.
+///
+/// The parameters are given as the query of a \c synthetic: URI, e.g.
+/// <code>synthetic:?seed=7&tracks=500&births=50</code>. Rates are per second
+/// of stream (not wall clock) time. Parameters which are not specified keep
+/// their default values.
+struct vsSyntheticStreamConfig
+{
+  vsSyntheticStreamConfig();
+
+  /// Parse parameters from \p uri.
+  ///
+  /// \return \c true on success; otherwise \c false, with a description of
+  ///         the problem in \p error.
+  bool parse(const QUrl& uri, QString* error = 0);
+
+  unsigned int Seed;      ///< Random seed (\c seed).
+  double FrameRate;       ///< Frames per second (\c rate).
+  double Speed;           ///< Multiple of real time (\c speed).
+  unsigned int Frames;    ///< Number of frames; \c 0 is unbounded (\c frames).
+  int Width;              ///< Frame width (\c width).
+  int Height;             ///< Frame height (\c height).
+  int MaxTracks;          ///< Maximum concurrent tracks (\c tracks).
+  double BirthRate;       ///< Track births per second (\c births).
+  double Lifetime;        ///< Mean track lifetime, in seconds (\c lifetime).
+  double StateRate;       ///< States per second, per track (\c states).
+  double DescriptorRate;  ///< Descriptors per second (\c descriptors).
+  double EventRate;       ///< Events per second (\c events).
+  QList<int> EventTypes;  ///< Event types (\c event-types).
+  double StatsInterval;   ///< Counter report interval, in seconds (\c stats).
+  QString StatsFile;      ///< Counter log file (\c stats-file).
+
+  /// \var Speed
+  /// A speed of \c 0 generates frames as fast as possible.
+  ///
+  /// \var EventTypes
+  /// If empty, the standard classifier event types are used.
+  ///
+  /// \var StatsFile
+  /// If set, each counter report is also appended to the file as a line of
+  /// JSON.
+};
+
+#endif
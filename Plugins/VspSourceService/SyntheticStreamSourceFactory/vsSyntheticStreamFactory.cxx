@@ -0,0 +1,62 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsSyntheticStreamFactory.h"
+
+#include <QInputDialog>
+#include <QUrl>
+
+#include "vsSyntheticStreamConfig.h"
+#include "vsSyntheticStreamSource.h"
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamFactory::vsSyntheticStreamFactory()
+{
+}
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamFactory::~vsSyntheticStreamFactory()
+{
+}
+
+//-----------------------------------------------------------------------------
+bool vsSyntheticStreamFactory::initialize(QWidget* dialogParent)
+{
+  bool accepted;
+  const QString parameters = QInputDialog::getText(
+    dialogParent, "Create synthetic stream",
+    "Stream parameters (e.g. seed=1&tracks=100&births=10):",
+    QLineEdit::Normal, "seed=1", &accepted);
+
+  if (!accepted)
+    {
+    return false;
+    }
+
+  return this->initialize(QUrl("synthetic:?" + parameters), dialogParent);
+}
+
+//-----------------------------------------------------------------------------
+bool vsSyntheticStreamFactory::initialize(const QUrl& uri)
+{
+  return this->initialize(uri, 0);
+}
+
+//-----------------------------------------------------------------------------
+bool vsSyntheticStreamFactory::initialize(
+  const QUrl& uri, QWidget* dialogParent)
+{
+  QString error;
+  vsSyntheticStreamConfig config;
+  if (!config.parse(uri, &error))
+    {
+    const QString message =
+     "Error creating stream from URI \"" + uri.toString() + "\": " + error;
+    this->warn(dialogParent, "Invalid stream parameters", message);
+    return false;
+    }
+
+  this->setSource(new vsSyntheticStreamSource(uri));
+  return true;
+}
@@ -0,0 +1,26 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsSyntheticStreamFactory_h
+#define __vsSyntheticStreamFactory_h
+
+#include <vsStreamFactory.h>
+
+class vsSyntheticStreamFactory : public vsStreamFactory
+{
+public:
+  vsSyntheticStreamFactory();
+  virtual ~vsSyntheticStreamFactory();
+
+  virtual bool initialize(QWidget* dialogParent) QTE_OVERRIDE;
+  virtual bool initialize(const QUrl& uri) QTE_OVERRIDE;
+
+protected:
+  bool initialize(const QUrl& uri, QWidget* dialogParent);
+
+private:
+  QTE_DISABLE_COPY(vsSyntheticStreamFactory)
+};
+
+#endif
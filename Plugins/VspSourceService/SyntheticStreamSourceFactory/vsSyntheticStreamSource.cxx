@@ -0,0 +1,767 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "moc_vsSyntheticStreamSourcePrivate.cpp"
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <vtkImageData.h>
+#include <vtkMath.h>
+
+#include <vgVideoSourceRequestor.h>
+#include <vgVtkVideoFrame.h>
+
+#include <vtkVsTrackInfo.h>
+
+#include <vsDescriptorSource.h>
+#include <vsTrackSource.h>
+
+#include <cmath>
+#include <limits>
+
+QTE_IMPLEMENT_D_FUNC(vsSyntheticStreamSource)
+
+namespace // anonymous
+{
+
+const char* const stageNames[] =
+{
+  "frames",
+  "states",
+  "closures",
+  "classifiers",
+  "descriptors",
+  "events",
+  "render",
+  "ingest"
+};
+
+const double infinity = std::numeric_limits<double>::infinity();
+
+//-----------------------------------------------------------------------------
+void cameraOffset(double time, double& dx, double& dy)
+{
+  // Slow pan with some sway, so that the homography changes every frame
+  dx = 12.0 * time;
+  dy = 25.0 * std::sin(0.2 * time);
+}
+
+} // namespace <anonymous>
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vsSyntheticStreamProbe
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamProbe::vsSyntheticStreamProbe(const QElapsedTimer* clock) :
+  Clock(clock)
+{
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamProbe::ping(qint64 sent)
+{
+  emit this->delivered(this->Clock->nsecsElapsed() - sent);
+}
+
+//END vsSyntheticStreamProbe
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vsSyntheticStreamSourcePrivate
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::Counter::add(qint64 count)
+{
+  this->Total += count;
+  this->Count += count;
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::Counter::addLatency(qint64 nanoseconds)
+{
+  ++this->Samples;
+  this->Latency += nanoseconds;
+  this->MaxLatency = qMax(this->MaxLatency, nanoseconds);
+}
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSourcePrivate::vsSyntheticStreamSourcePrivate(
+  vsSyntheticStreamSource* q, const QUrl& streamUri)
+  : vsStreamSourcePrivate(q, streamUri), LastReportTime(0), NextFrame(0),
+    NextBirthTime(0.0), NextDescriptorTime(0.0), NextEventTime(0.0),
+    NextTrackSerial(1), NextDescriptorId(0), NextEventId(0)
+{
+  // The factory has already validated the URI
+  this->Config.parse(streamUri);
+  this->RandomEngine.seed(this->Config.Seed);
+}
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSourcePrivate::~vsSyntheticStreamSourcePrivate()
+{
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::run()
+{
+  this->updateStatus(vsDataSource::StreamingPending);
+
+  QTE_Q(vsSyntheticStreamSource);
+  connect(this, SIGNAL(trackUpdated(vsTrackId, vvTrackState)),
+          q->trackSource().data(),
+          SIGNAL(trackUpdated(vsTrackId, vvTrackState)));
+  connect(this, SIGNAL(trackClosed(vsTrackId)),
+          q->trackSource().data(),
+          SIGNAL(trackClosed(vsTrackId)));
+  connect(this, SIGNAL(tocAvailable(vsTrackId, vsTrackObjectClassifier)),
+          q->descriptorSource().data(),
+          SIGNAL(tocAvailable(vsTrackId, vsTrackObjectClassifier)));
+  connect(this, SIGNAL(descriptorsAvailable(vsDescriptorList)),
+          q->descriptorSource().data(),
+          SLOT(emitDescriptors(vsDescriptorList)));
+  connect(this, SIGNAL(eventAvailable(vsEvent)),
+          q->descriptorSource().data(),
+          SLOT(emitEvent(vsEvent)));
+
+  // Determine what event types to generate
+  this->EventTypes = this->Config.EventTypes;
+  if (this->EventTypes.isEmpty())
+    {
+    foreach (const vsEventInfo& ei, vsEventInfo::events(vsEventInfo::All))
+      {
+      if (vsEventInfo::eventGroup(ei.type) & vsEventInfo::Classifier)
+        {
+        this->EventTypes.append(ei.type);
+        }
+      }
+    }
+  if (this->EventTypes.isEmpty())
+    {
+    this->EventTypes.append(vsEventInfo::Annotation);
+    }
+  if (this->Config.EventRate > 0.0)
+    {
+    this->notifyClassifiersAvailable(true);
+    }
+
+  // Open counter log, if requested
+  if (!this->Config.StatsFile.isEmpty())
+    {
+    this->StatsFile.setFileName(this->Config.StatsFile);
+    if (!this->StatsFile.open(QIODevice::WriteOnly | QIODevice::Append |
+                              QIODevice::Text))
+      {
+      qWarning() << "synthetic stream: unable to open counter log"
+                 << this->Config.StatsFile;
+      }
+    }
+
+  // Schedule the first occurrence of each kind of random data
+  this->NextBirthTime = this->randomInterval(this->Config.BirthRate);
+  this->NextDescriptorTime = this->randomInterval(this->Config.DescriptorRate);
+  this->NextEventTime = this->randomInterval(this->Config.EventRate);
+
+  // Start generating frames
+  this->Clock.start();
+  this->updateStatus(vsDataSource::StreamingActive);
+  QTimer::singleShot(0, this, SLOT(generateFrame()));
+
+  // Hand off to event loop
+  vsStreamSourcePrivate::run();
+}
+
+//-----------------------------------------------------------------------------
+double vsSyntheticStreamSourcePrivate::random()
+{
+  // Uniform in [0, 1), using the top 53 bits of the engine output
+  return static_cast<double>(this->RandomEngine() >> 11) *
+         (1.0 / 9007199254740992.0);
+}
+
+//-----------------------------------------------------------------------------
+double vsSyntheticStreamSourcePrivate::random(double lower, double upper)
+{
+  return lower + (upper - lower) * this->random();
+}
+
+//-----------------------------------------------------------------------------
+double vsSyntheticStreamSourcePrivate::randomInterval(double rate)
+{
+  // Exponentially distributed time between events of a Poisson process
+  return (rate > 0.0 ? -std::log(1.0 - this->random()) / rate : infinity);
+}
+
+//-----------------------------------------------------------------------------
+QUuid vsSyntheticStreamSourcePrivate::randomUuid()
+{
+  const quint64 a = this->RandomEngine();
+  const quint64 b = this->RandomEngine();
+
+  // Produce a (version 4) random UUID
+  return QUuid(static_cast<uint>(a >> 32), static_cast<ushort>(a >> 16),
+               static_cast<ushort>((a & 0x0fff) | 0x4000),
+               static_cast<uchar>(((b >> 56) & 0x3f) | 0x80),
+               static_cast<uchar>(b >> 48), static_cast<uchar>(b >> 40),
+               static_cast<uchar>(b >> 32), static_cast<uchar>(b >> 24),
+               static_cast<uchar>(b >> 16), static_cast<uchar>(b >> 8),
+               static_cast<uchar>(b));
+}
+
+//-----------------------------------------------------------------------------
+vtkVgTimeStamp vsSyntheticStreamSourcePrivate::frameTime(
+  unsigned int frame) const
+{
+  return vtkVgTimeStamp(1e6 * frame / this->Config.FrameRate, frame);
+}
+
+//-----------------------------------------------------------------------------
+qint64 vsSyntheticStreamSourcePrivate::frameDeadline(unsigned int frame) const
+{
+  const double rate = this->Config.FrameRate * this->Config.Speed;
+  return static_cast<qint64>(1e9 * frame / rate);
+}
+
+//-----------------------------------------------------------------------------
+int vsSyntheticStreamSourcePrivate::seekFrame(
+  const vgTimeStamp& position, vg::SeekMode direction) const
+{
+  static const double epsilon = 1e-6;
+
+  if (!this->NextFrame)
+    {
+    return -1;
+    }
+
+  double x;
+  if (position.HasTime())
+    {
+    x = position.Time * 1e-6 * this->Config.FrameRate;
+    }
+  else if (position.HasFrameNumber())
+    {
+    x = position.FrameNumber;
+    }
+  else
+    {
+    return -1;
+    }
+
+  const double last = this->NextFrame - 1;
+  double frame;
+  switch (direction)
+    {
+    case vg::SeekExact:
+      frame = std::floor(x + 0.5);
+      if (std::fabs(x - frame) > epsilon)
+        {
+        return -1;
+        }
+      break;
+    case vg::SeekLowerBound:
+      frame = qMax(0.0, std::ceil(x - epsilon));
+      break;
+    case vg::SeekUpperBound:
+      frame = qMin(last, std::floor(x + epsilon));
+      break;
+    case vg::SeekNext:
+      frame = qMax(0.0, std::floor(x + epsilon) + 1.0);
+      break;
+    case vg::SeekPrevious:
+      frame = qMin(last, std::ceil(x - epsilon) - 1.0);
+      break;
+    default:
+      frame = qBound(0.0, std::floor(x + 0.5), last);
+      break;
+    }
+
+  return ((frame < 0.0 || frame > last) ? -1 : static_cast<int>(frame));
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::findTime(
+  vtkVgTimeStamp* result, unsigned int frameNumber, vg::SeekMode roundMode)
+{
+  const int frame =
+    this->seekFrame(vgTimeStamp::fromFrameNumber(frameNumber), roundMode);
+  *result = (frame < 0 ? vtkVgTimeStamp() : this->frameTime(frame));
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::requestFrame(
+  const vgVideoSeekRequest& request)
+{
+  const qint64 start = this->Clock.nsecsElapsed();
+
+  QObject* requestor = request.Requestor.data();
+  if (!this->LastRequest.contains(requestor))
+    {
+    this->LastRequest.insert(requestor, -1);
+    connect(requestor, SIGNAL(destroyed(QObject*)),
+            this, SLOT(cleanupRequestor(QObject*)));
+    }
+
+  // Check if the frame is valid and has advanced
+  const int frame = this->seekFrame(request.TimeStamp, request.Direction);
+  if (frame < 0 || frame == this->LastRequest.value(requestor))
+    {
+    // Nope; if the requestor is expecting a reply, notify them that the
+    // request was discarded
+    if (request.RequestId >= 0)
+      {
+      vgVtkVideoFramePtr noFrame;
+      request.sendReply(noFrame);
+      }
+    return;
+    }
+
+  // Generate the frame and hand it to the caller
+  this->LastRequest.insert(requestor, frame);
+  vgVtkVideoFramePtr rframe(new vtkVgVideoFrame(this->renderFrame(frame)));
+  rframe->MetaData = this->frameMetaData(frame);
+  request.sendReply(rframe);
+
+  Counter& counter = this->Counters[RenderStage];
+  counter.add();
+  counter.addLatency(this->Clock.nsecsElapsed() - start);
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::clearLastRequest(
+  vgVideoSourceRequestor* requestor)
+{
+  this->LastRequest.remove(requestor);
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::cleanupRequestor(QObject* requestor)
+{
+  this->LastRequest.remove(requestor);
+}
+
+//-----------------------------------------------------------------------------
+vtkVgVideoFrameMetaData vsSyntheticStreamSourcePrivate::frameMetaData(
+  unsigned int frame) const
+{
+  const vtkVgTimeStamp time = this->frameTime(frame);
+
+  double dx, dy;
+  cameraOffset(1e-6 * time.GetTime(), dx, dy);
+
+  // Homography maps image coordinates to those of the first frame
+  vtkVgVideoFrameMetaData metadata;
+  metadata.Time = time;
+  metadata.Gsd = 0.5;
+  metadata.HomographyReferenceFrame = 0;
+  metadata.Homography->Identity();
+  metadata.Homography->SetElement(0, 3, dx);
+  metadata.Homography->SetElement(1, 3, dy);
+  metadata.SetWidthAndHeight(this->Config.Width, this->Config.Height);
+  return metadata;
+}
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> vsSyntheticStreamSourcePrivate::renderFrame(
+  unsigned int frame) const
+{
+  const int w = this->Config.Width;
+  const int h = this->Config.Height;
+
+  double dx, dy;
+  cameraOffset(frame / this->Config.FrameRate, dx, dy);
+  const int ox = static_cast<int>(std::floor(dx));
+  const int oy = static_cast<int>(std::floor(dy));
+
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(w, h, 1);
+  image->AllocateScalars(VTK_UNSIGNED_CHAR, 3);
+
+  // Draw a checkerboard that is fixed in the reference frame, so that it
+  // moves consistently with the homography
+  unsigned char* p = static_cast<unsigned char*>(image->GetScalarPointer());
+  for (int y = 0; y < h; ++y)
+    {
+    const int cy = (y + oy) >> 5;
+    for (int x = 0; x < w; ++x, p += 3)
+      {
+      const int cx = (x + ox) >> 5;
+      const unsigned char value = ((cx ^ cy) & 1 ? 160 : 96);
+      p[0] = value;
+      p[1] = value;
+      p[2] = static_cast<unsigned char>(value + (cx & 31));
+      }
+    }
+
+  return image;
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::generateFrame()
+{
+  const qint64 tickTime = this->Clock.nsecsElapsed();
+  const unsigned int frame = this->NextFrame++;
+  const vtkVgTimeStamp now = this->frameTime(frame);
+  const double time = 1e-6 * now.GetTime();
+
+  // Emit frame metadata and availability
+  QList<vtkVgVideoFrameMetaData> metadata;
+  metadata.append(this->frameMetaData(frame));
+  this->emitMetadata(metadata);
+  this->updateFrameRange(this->frameTime(0), now);
+
+  Counter& frameCounter = this->Counters[FrameStage];
+  frameCounter.add();
+  if (this->Config.Speed > 0.0)
+    {
+    frameCounter.addLatency(tickTime - this->frameDeadline(frame));
+    }
+
+  // Create new tracks
+  while (this->NextBirthTime <= time)
+    {
+    if (this->Tracks.count() < this->Config.MaxTracks)
+      {
+      this->birthTrack(now);
+      }
+    this->NextBirthTime += this->randomInterval(this->Config.BirthRate);
+    }
+
+  // Update existing tracks
+  QList<Track>::iterator iter = this->Tracks.begin();
+  while (iter != this->Tracks.end())
+    {
+    if (iter->NextStateTime <= time)
+      {
+      this->updateTrack(*iter, now);
+      }
+    if (iter->EndTime <= time)
+      {
+      emit this->trackClosed(iter->Id);
+      this->Counters[ClosureStage].add();
+      iter = this->Tracks.erase(iter);
+      continue;
+      }
+    ++iter;
+    }
+
+  this->generateDescriptors(now);
+  this->generateEvents(now);
+
+  // Measure how long it takes for everything emitted so far to be delivered
+  emit this->probeRequested(this->Clock.nsecsElapsed());
+
+  if (this->Config.StatsInterval > 0.0 &&
+      this->Clock.nsecsElapsed() - this->LastReportTime >=
+      static_cast<qint64>(1e9 * this->Config.StatsInterval))
+    {
+    this->reportStatistics();
+    }
+
+  if (this->Config.Frames && this->NextFrame >= this->Config.Frames)
+    {
+    this->finish();
+    return;
+    }
+
+  // Schedule next frame
+  qint64 delay = 0;
+  if (this->Config.Speed > 0.0)
+    {
+    const qint64 deadline = this->frameDeadline(this->NextFrame);
+    delay = qMax(Q_INT64_C(0), deadline - this->Clock.nsecsElapsed());
+    }
+  QTimer::singleShot(static_cast<int>(delay / 1000000), Qt::PreciseTimer,
+                     this, SLOT(generateFrame()));
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::birthTrack(const vtkVgTimeStamp& now)
+{
+  const double time = 1e-6 * now.GetTime();
+  const double speed = this->random(10.0, 60.0);
+  const double heading = this->random(0.0, 2.0 * vtkMath::Pi());
+
+  Track track;
+  track.Id = vsTrackId(0, this->NextTrackSerial++, this->randomUuid());
+  track.Start = now;
+  track.X = this->random(0.0, this->Config.Width);
+  track.Y = this->random(0.0, this->Config.Height);
+  track.VX = speed * std::cos(heading);
+  track.VY = speed * std::sin(heading);
+  track.BoxWidth = static_cast<int>(this->random(10.0, 60.0));
+  track.BoxHeight = static_cast<int>(this->random(10.0, 80.0));
+  track.LastTime = time;
+  track.NextStateTime = time;
+  track.EndTime = time + (this->Config.Lifetime > 0.0
+                          ? this->randomInterval(1.0 / this->Config.Lifetime)
+                          : 0.0);
+
+  vsTrackObjectClassifier toc;
+  toc.probabilityPerson = this->random();
+  toc.probabilityVehicle = this->random();
+  toc.probabilityOther = this->random();
+  const double total = toc.probabilityPerson + toc.probabilityVehicle +
+                       toc.probabilityOther;
+  if (total > 0.0)
+    {
+    toc.probabilityPerson /= total;
+    toc.probabilityVehicle /= total;
+    toc.probabilityOther /= total;
+    }
+
+  // New tracks are updated (and hence emit their first state) on the frame on
+  // which they are created; the classifier follows the first state
+  this->Tracks.append(track);
+  this->updateTrack(this->Tracks.last(), now);
+  emit this->tocAvailable(track.Id, toc);
+  this->Counters[ClassifierStage].add();
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::updateTrack(
+  Track& track, const vtkVgTimeStamp& now)
+{
+  const double time = 1e-6 * now.GetTime();
+  const double w = this->Config.Width;
+  const double h = this->Config.Height;
+
+  // Move, bouncing off of the edges of the frame
+  const double dt = time - track.LastTime;
+  track.X += track.VX * dt;
+  track.Y += track.VY * dt;
+  if (track.X < 0.0 || track.X > w)
+    {
+    track.VX = -track.VX;
+    track.X = qBound(0.0, (track.X < 0.0 ? -track.X : 2.0 * w - track.X), w);
+    }
+  if (track.Y < 0.0 || track.Y > h)
+    {
+    track.VY = -track.VY;
+    track.Y = qBound(0.0, (track.Y < 0.0 ? -track.Y : 2.0 * h - track.Y), h);
+    }
+  track.LastTime = time;
+
+  // Schedule next update; if states are requested more often than frames are
+  // generated, update on every frame
+  track.NextStateTime += 1.0 / this->Config.StateRate;
+  if (track.NextStateTime <= time)
+    {
+    track.NextStateTime = time + 1.0 / this->Config.StateRate;
+    }
+
+  // Build state; the image point is the bottom center of the box
+  const int x = static_cast<int>(track.X);
+  const int y = static_cast<int>(track.Y);
+  vvTrackState& state = track.State;
+  state.TimeStamp = now;
+  state.ImagePoint = vvImagePointF(track.X, track.Y);
+  state.ImageBox.TopLeft = vvImagePoint(x - track.BoxWidth / 2,
+                                        y - track.BoxHeight);
+  state.ImageBox.BottomRight = vvImagePoint(x + track.BoxWidth / 2, y);
+
+  const vvImagePoint& tl = state.ImageBox.TopLeft;
+  const vvImagePoint& br = state.ImageBox.BottomRight;
+  state.ImageObject.clear();
+  state.ImageObject.push_back(vvImagePointF(tl.X, tl.Y));
+  state.ImageObject.push_back(vvImagePointF(br.X, tl.Y));
+  state.ImageObject.push_back(vvImagePointF(br.X, br.Y));
+  state.ImageObject.push_back(vvImagePointF(tl.X, br.Y));
+
+  emit this->trackUpdated(track.Id, state);
+  this->Counters[StateStage].add();
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::generateDescriptors(
+  const vtkVgTimeStamp& now)
+{
+  const double time = 1e-6 * now.GetTime();
+
+  vsDescriptorList descriptors;
+  while (this->NextDescriptorTime <= time)
+    {
+    this->NextDescriptorTime +=
+      this->randomInterval(this->Config.DescriptorRate);
+    if (this->Tracks.isEmpty())
+      {
+      continue;
+      }
+
+    // Describe the current state of a random track
+    const int n = static_cast<int>(this->random() * this->Tracks.count());
+    const Track& track = this->Tracks[n];
+
+    vvDescriptorRegionEntry region;
+    region.TimeStamp = track.State.TimeStamp;
+    region.ImageRegion = track.State.ImageBox;
+
+    vvDescriptor* descriptor = new vvDescriptor;
+    descriptor->DescriptorName = "synthetic";
+    descriptor->ModuleName = "vsSyntheticStream";
+    descriptor->InstanceId = this->NextDescriptorId++;
+    descriptor->Confidence = this->random();
+    descriptor->Values.resize(1);
+    for (int i = 0; i < 16; ++i)
+      {
+      descriptor->Values[0].push_back(static_cast<float>(this->random()));
+      }
+    descriptor->Region.insert(region);
+    descriptor->TrackIds.push_back(track.Id);
+    descriptors.append(descriptor);
+    }
+
+  if (!descriptors.isEmpty())
+    {
+    this->Counters[DescriptorStage].add(descriptors.count());
+    emit this->descriptorsAvailable(descriptors);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::generateEvents(const vtkVgTimeStamp& now)
+{
+  const double time = 1e-6 * now.GetTime();
+
+  while (this->NextEventTime <= time)
+    {
+    this->NextEventTime += this->randomInterval(this->Config.EventRate);
+    if (this->Tracks.isEmpty())
+      {
+      continue;
+      }
+
+    // Create an event spanning the history of a random track
+    const int n = static_cast<int>(this->random() * this->Tracks.count());
+    const int t = static_cast<int>(this->random() * this->EventTypes.count());
+    const Track& track = this->Tracks[n];
+
+    vsEvent event(this->randomUuid());
+    event->SetId(this->NextEventId++);
+    event->AddClassifier(this->EventTypes[t], this->random(), 0.0);
+    event->AddTrack(new vtkVsTrackInfo(track.Id, track.Start,
+                                       track.State.TimeStamp));
+
+    emit this->eventAvailable(event);
+    this->Counters[EventStage].add();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::finish()
+{
+  // Close all remaining tracks
+  foreach (const Track& track, this->Tracks)
+    {
+    emit this->trackClosed(track.Id);
+    this->Counters[ClosureStage].add();
+    }
+  this->Tracks.clear();
+
+  emit this->probeRequested(this->Clock.nsecsElapsed());
+  this->updateStatus(vsDataSource::StreamingStopped);
+  this->reportStatistics();
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::recordIngestLatency(qint64 latency)
+{
+  Counter& counter = this->Counters[IngestStage];
+  counter.add();
+  counter.addLatency(latency);
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourcePrivate::reportStatistics()
+{
+  const qint64 now = this->Clock.nsecsElapsed();
+  const qint64 elapsed = now - this->LastReportTime;
+  const double interval = 1e-9 * qMax(Q_INT64_C(1), elapsed);
+  this->LastReportTime = now;
+
+  QJsonObject stages;
+  QString summary;
+  for (int i = 0; i < StageCount; ++i)
+    {
+    Counter& counter = this->Counters[i];
+    const double rate = counter.Count / interval;
+
+    QJsonObject stage;
+    stage.insert("total", counter.Total);
+    stage.insert("count", counter.Count);
+    stage.insert("rate", rate);
+    summary += QString(" %1 %2 (%3/s").arg(stageNames[i])
+                 .arg(counter.Total).arg(rate, 0, 'f', 1);
+
+    if (counter.Samples)
+      {
+      // Report latency in milliseconds
+      const double mean = 1e-6 * counter.Latency / counter.Samples;
+      const double max = 1e-6 * counter.MaxLatency;
+      stage.insert("latency-mean", mean);
+      stage.insert("latency-max", max);
+      summary += QString(", %1/%2 ms").arg(mean, 0, 'f', 2)
+                                     .arg(max, 0, 'f', 2);
+      }
+    summary += ')';
+    stages.insert(stageNames[i], stage);
+
+    counter.Count = 0;
+    counter.Samples = 0;
+    counter.Latency = 0;
+    counter.MaxLatency = 0;
+    }
+
+  qDebug().noquote() << "synthetic stream:" << "live tracks"
+                     << this->Tracks.count() << summary;
+
+  if (this->StatsFile.isOpen())
+    {
+    QJsonObject report;
+    report.insert("elapsed", 1e-9 * now);
+    report.insert("frame", static_cast<qint64>(this->NextFrame));
+    report.insert("tracks", this->Tracks.count());
+    report.insert("stages", stages);
+    const QJsonDocument doc(report);
+    this->StatsFile.write(doc.toJson(QJsonDocument::Compact) + '\n');
+    this->StatsFile.flush();
+    }
+}
+
+//-----------------------------------------------------------------------------
+QString vsSyntheticStreamSourcePrivate::text(QString format) const
+{
+  return format.arg(QString("synthetic %1").arg(this->Config.Seed));
+}
+
+//END vsSyntheticStreamSourcePrivate
+
+///////////////////////////////////////////////////////////////////////////////
+
+//BEGIN vsSyntheticStreamSource
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSource::vsSyntheticStreamSource(const QUrl& streamUri) :
+  vsStreamSource(new vsSyntheticStreamSourcePrivate(this, streamUri))
+{
+  QTE_D(vsSyntheticStreamSource);
+
+  // The probe lives in the GUI thread (i.e. ours), where the core and scene
+  // receive the data we generate
+  vsSyntheticStreamProbe* probe = new vsSyntheticStreamProbe(&d->Clock);
+  probe->setParent(this);
+  connect(d, SIGNAL(probeRequested(qint64)),
+          probe, SLOT(ping(qint64)), Qt::QueuedConnection);
+  connect(probe, SIGNAL(delivered(qint64)),
+          d, SLOT(recordIngestLatency(qint64)), Qt::QueuedConnection);
+}
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSource::~vsSyntheticStreamSource()
+{
+}
+
+//END vsSyntheticStreamSource
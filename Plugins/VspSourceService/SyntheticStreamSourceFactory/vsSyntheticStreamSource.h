@@ -0,0 +1,38 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsSyntheticStreamSource_h
+#define __vsSyntheticStreamSource_h
+
+#include <vsStreamSource.h>
+
+class QUrl;
+
+class vsSyntheticStreamSourcePrivate;
+
+/// Stream source which generates data procedurally.
+///
+/// This source produces video frames and metadata, tracks, track
+/// classifiers, descriptors and events from a random seed, at configurable
+/// rates (see vsSyntheticStreamConfig), without requiring any input data or
+/// user interaction. The same parameters always produce the same data.
+///
+/// While running, the source periodically reports counters for each stage of
+/// generation, including the latency with which generated data is delivered
+/// to the GUI thread, to allow the ingestion of streaming data to be soak
+/// tested.
+class vsSyntheticStreamSource : public vsStreamSource
+{
+  Q_OBJECT
+
+public:
+  vsSyntheticStreamSource(const QUrl& streamUri);
+  virtual ~vsSyntheticStreamSource();
+
+private:
+  QTE_DECLARE_PRIVATE(vsSyntheticStreamSource)
+  QTE_DISABLE_COPY(vsSyntheticStreamSource)
+};
+
+#endif
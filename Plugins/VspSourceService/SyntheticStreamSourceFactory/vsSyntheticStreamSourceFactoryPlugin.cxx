@@ -0,0 +1,81 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "vsSyntheticStreamSourceFactoryPlugin.h"
+
+#include <QUrl>
+#include <QtPlugin>
+
+#include <qtCliArgs.h>
+
+#include <vsFactoryAction.h>
+
+#include "vsSyntheticStreamFactory.h"
+
+namespace { static const int keyCreateAction = 0; }
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSourceFactoryPlugin::vsSyntheticStreamSourceFactoryPlugin()
+{
+}
+
+//-----------------------------------------------------------------------------
+vsSyntheticStreamSourceFactoryPlugin::~vsSyntheticStreamSourceFactoryPlugin()
+{
+}
+
+//-----------------------------------------------------------------------------
+QString vsSyntheticStreamSourceFactoryPlugin::identifier() const
+{
+  return "SyntheticStream";
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourceFactoryPlugin::registerFactoryCliOptions(
+  qtCliOptions& options)
+{
+  options.add("synthetic-stream <parameters>",
+              "Create a synthetic stream using the specified 'parameters'"
+              " (e.g. \"seed=1&tracks=100\")");
+}
+
+//-----------------------------------------------------------------------------
+QList<vsPendingFactoryAction>
+vsSyntheticStreamSourceFactoryPlugin::parseFactoryArguments(
+  const qtCliArgs& args)
+{
+  QList<vsPendingFactoryAction> requestedActions;
+  foreach (const QString& parameters, args.values("synthetic-stream"))
+    {
+    vsPendingFactoryAction action;
+    action.FactoryIdentifier = this->identifier();
+    action.SourceUri = QUrl("synthetic:?" + parameters);
+    requestedActions.append(action);
+    }
+  return requestedActions;
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourceFactoryPlugin::registerActions()
+{
+  this->registerAction(
+    keyCreateAction, "Create S&ynthetic Stream", QString(), QString(),
+    "Create a stream of procedurally generated data");
+}
+
+//-----------------------------------------------------------------------------
+void vsSyntheticStreamSourceFactoryPlugin::insertActions(
+  qtPrioritizedMenuProxy& videoMenu, qtPrioritizedMenuProxy& trackMenu,
+  qtPrioritizedMenuProxy& descriptorMenu)
+{
+  videoMenu.insertAction(this->action(keyCreateAction), 110);
+  Q_UNUSED(trackMenu);
+  Q_UNUSED(descriptorMenu);
+}
+
+//-----------------------------------------------------------------------------
+vsSourceFactory* vsSyntheticStreamSourceFactoryPlugin::createFactory()
+{
+  return new vsSyntheticStreamFactory;
+}
@@ -0,0 +1,170 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __vsSyntheticStreamSourcePrivate_h
+#define __vsSyntheticStreamSourcePrivate_h
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QUuid>
+
+#include <vtkSmartPointer.h>
+
+#include <vvTrack.h>
+
+#include <vsTrackClassifier.h>
+#include <vsTrackId.h>
+
+#include <vsStreamSourcePrivate.h>
+
+#include "vsSyntheticStreamConfig.h"
+#include "vsSyntheticStreamSource.h"
+
+#include <random>
+
+class vtkImageData;
+
+//-----------------------------------------------------------------------------
+// Object living in the GUI thread which reports the latency with which queued
+// data reaches that thread; since queued calls are delivered in order, a ping
+// is not received until everything emitted before it has been delivered
+class vsSyntheticStreamProbe : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit vsSyntheticStreamProbe(const QElapsedTimer* clock);
+
+signals:
+  void delivered(qint64 latency);
+
+public slots:
+  void ping(qint64 sent);
+
+protected:
+  const QElapsedTimer* const Clock;
+};
+
+//-----------------------------------------------------------------------------
+class vsSyntheticStreamSourcePrivate : public vsStreamSourcePrivate
+{
+  Q_OBJECT
+
+protected:
+  QTE_DECLARE_PUBLIC(vsSyntheticStreamSource)
+
+  vsSyntheticStreamSourcePrivate(vsSyntheticStreamSource* q,
+                                 const QUrl& streamUri);
+  virtual ~vsSyntheticStreamSourcePrivate();
+
+  virtual void run() QTE_OVERRIDE;
+  virtual void findTime(vtkVgTimeStamp* result, unsigned int frameNumber,
+                        vg::SeekMode) QTE_OVERRIDE;
+  virtual void requestFrame(const vgVideoSeekRequest&) QTE_OVERRIDE;
+  virtual void clearLastRequest(vgVideoSourceRequestor*) QTE_OVERRIDE;
+
+  using vsStreamSourcePrivate::text;
+  virtual QString text(QString format) const QTE_OVERRIDE;
+
+  enum Stage
+    {
+    FrameStage,
+    StateStage,
+    ClosureStage,
+    ClassifierStage,
+    DescriptorStage,
+    EventStage,
+    RenderStage,
+    IngestStage,
+    StageCount
+    };
+
+  struct Counter
+    {
+    Counter() : Total(0), Count(0), Samples(0), Latency(0), MaxLatency(0) {}
+
+    void add(qint64 count = 1);
+    void addLatency(qint64 nanoseconds);
+
+    qint64 Total;
+    qint64 Count;
+    qint64 Samples;
+    qint64 Latency;
+    qint64 MaxLatency;
+    };
+
+  struct Track
+    {
+    vsTrackId Id;
+    vtkVgTimeStamp Start;
+    double X, Y, VX, VY;
+    int BoxWidth, BoxHeight;
+    double LastTime, NextStateTime, EndTime;
+    vvTrackState State;
+    };
+
+  // Random number generation is implemented here rather than by the standard
+  // distributions, whose output is not specified, so that the generated data
+  // is the same on every platform
+  double random();
+  double random(double lower, double upper);
+  double randomInterval(double rate);
+  QUuid randomUuid();
+
+  int seekFrame(const vgTimeStamp& position, vg::SeekMode) const;
+  vtkVgTimeStamp frameTime(unsigned int frame) const;
+  vtkVgVideoFrameMetaData frameMetaData(unsigned int frame) const;
+  vtkSmartPointer<vtkImageData> renderFrame(unsigned int frame) const;
+  qint64 frameDeadline(unsigned int frame) const;
+
+  void birthTrack(const vtkVgTimeStamp& now);
+  void updateTrack(Track&, const vtkVgTimeStamp& now);
+  void generateDescriptors(const vtkVgTimeStamp& now);
+  void generateEvents(const vtkVgTimeStamp& now);
+
+  void finish();
+  void reportStatistics();
+
+signals:
+  void trackUpdated(vsTrackId trackId, vvTrackState state);
+  void trackClosed(vsTrackId trackId);
+
+  void tocAvailable(vsTrackId trackId, vsTrackObjectClassifier toc);
+
+  void probeRequested(qint64 sent);
+
+protected slots:
+  void generateFrame();
+  void recordIngestLatency(qint64 latency);
+  void cleanupRequestor(QObject*);
+
+protected:
+  vsSyntheticStreamConfig Config;
+  std::mt19937_64 RandomEngine;
+
+  QElapsedTimer Clock;
+  qint64 LastReportTime;
+  Counter Counters[StageCount];
+  QFile StatsFile;
+
+  unsigned int NextFrame;
+  double NextBirthTime;
+  double NextDescriptorTime;
+  double NextEventTime;
+
+  QList<Track> Tracks;
+  QList<int> EventTypes;
+  long long NextTrackSerial;
+  long long NextDescriptorId;
+  vtkIdType NextEventId;
+
+  QHash<QObject*, int> LastRequest;
+
+private:
+  QTE_DISABLE_COPY(vsSyntheticStreamSourcePrivate)
+};
+
+#endif
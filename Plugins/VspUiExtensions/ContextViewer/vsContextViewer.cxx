@@ -924,6 +924,12 @@ void vsContextViewer::addRasterLayer(const QUrl& uri)
     d->TerrainSource = vtkVgTerrainSource::SmartPtr::New();
     d->TerrainSource->SetDataSource(uri.toEncoded().constData());
 
+    // Load imagery in the background while panning and zooming, and render
+    // again as it arrives
+    d->TerrainSource->SetAsynchronous(true);
+    vtkConnect(d->TerrainSource, vtkCommand::UpdateDataEvent,
+               this, SLOT(update()));
+
     // Add the context to the main viewer scene.
     d->Terrain = d->TerrainSource->CreateTerrain();
     if (!d->Terrain)
@@ -19,7 +19,7 @@
 #include <vtkVgTrack.h>
 
 #include <vgCheckArg.h>
-#include <vgUtil.h>
+#include <vgRowPacker.h>
 
 #include <qtColorUtil.h>
 #include <qtScopedValueChange.h>
@@ -44,9 +44,6 @@ namespace // anonymous
 
 typedef vsDisplayInfo (vsScene::*GetInfoMethod)(vtkIdType);
 
-typedef vgRange<double> Interval;
-typedef QList<Interval> IntervalList;
-
 enum TableColumn
 {
   TC_X = 0,
@@ -98,8 +95,7 @@ struct TimelineEntityInfo : TimelineEntityReference
   vtkIdType TableRow;
   vtkSmartPointer<vtkTable> Table;
 
-  int Y; // Index of Y container (IntervalList) to which this entity belongs
-  int YX; // Index of this entity's Interval in its IntervalList
+  int Y; // Index of the layout row to which this entity belongs
 };
 
 typedef QHash<vtkIdType, TimelineEntityInfo> EntityInfoMap;
@@ -148,9 +144,7 @@ public:
 
   void addEntityToRow(TimelineEntityInfo& info);
   void updateEntityYPosition(const TimelineEntityInfo& info);
-  void updateRowInterval(const TimelineEntityInfo& info);
-
-  void recomputeLayout();
+  void updateRowInterval(TimelineEntityInfo& info, double oldStartTime);
 
   void updateYScale();
   void setYScale(EntityInfoMap& entities, double scale);
@@ -169,7 +163,6 @@ protected:
   bool ChartDirty;
   bool SizeDirty;
   bool ScaleDirty;
-  bool LayoutDirty;
   bool RenderPending;
 
   bool UpdatingSelection;
@@ -183,8 +176,9 @@ protected:
   int MinY, MaxY;
   double YScale;
 
-  QList<IntervalList> Rows;
-  double LastStartTime;
+  // Packing of entities into rows; entities may arrive in any order, and are
+  // placed as they arrive
+  vgRowPacker Layout;
 
   vtkSmartPointer<vtkContextView> Viewer;
   vtkSmartPointer<vtkVgChartTimeline> Chart;
@@ -214,7 +208,6 @@ vsTimelineViewerPrivate::vsTimelineViewerPrivate(
   this->ChartDirty = false;
   this->SizeDirty = true;
   this->ScaleDirty = false;
-  this->LayoutDirty = false;
   this->RenderPending = false;
   this->UpdatingSelection = false;
 
@@ -222,7 +215,7 @@ vsTimelineViewerPrivate::vsTimelineViewerPrivate(
   this->MinimumXPadding = 1e6;
   this->MaximumYScale = 15.0;
 
-  this->LastStartTime = -std::numeric_limits<double>::max();
+  this->Layout.setPadding(this->MinimumXPadding);
 
   this->MinY = 0;
   this->MaxY = -1; // Ensure first addition will set ScaleDirty
@@ -337,10 +330,11 @@ void vsTimelineViewerPrivate::updateEntity(
   if (entry.StartTime != tei.StartTime || entry.EndTime != tei.EndTime)
     {
     // Update start and end time
+    const double oldStartTime = entry.StartTime;
     entry.StartTime = tei.StartTime;
     entry.EndTime = tei.EndTime;
     entry.VirtualEndTime = qMax(tei.EndTime, tei.StartTime + this->MinimumSize);
-    this->updateRowInterval(entry);
+    this->updateRowInterval(entry, oldStartTime);
 
     entry.Table->SetValue(entry.TableRow + 0, TC_Time, entry.StartTime);
     entry.Table->SetValue(entry.TableRow + 1, TC_Time, entry.VirtualEndTime);
@@ -407,53 +401,9 @@ void vsTimelineViewerPrivate::updateEntities(
 //-----------------------------------------------------------------------------
 void vsTimelineViewerPrivate::addEntityToRow(TimelineEntityInfo& info)
 {
-  if (this->LayoutDirty || info.StartTime < this->LastStartTime)
-    {
-    // For any entity seen "out of order" (or if the layout is dirty), there is
-    // no point computing a position now, so just punt (marking the layout as
-    // dirty if it isn't already) and let things get sorted out at the next
-    // update when we recompute the whole layout anyway
-    info.Y = info.YX = 0;
-    this->LayoutDirty = true;
-    return;
-    }
-  this->LastStartTime = info.StartTime;
-
-  const Interval interval(info.StartTime, info.VirtualEndTime);
-  const double padding = this->MinimumXPadding;
-
-  // Find the best row into which to insert the entity (no-op if no rows exist)
-  int candidate = 0;
-  const int k = this->Rows.count();
-  while (candidate < k)
-    {
-    const double available = this->Rows[candidate].last().upper + padding;
-    if (available < info.StartTime)
-      {
-      // This one will do
-      break;
-      }
-    ++candidate;
-    }
-
-  // Did we find a spot in an existing row?
-  if (candidate < k)
-    {
-    // Yes; add the entity there
-    IntervalList& row = this->Rows[candidate];
-    info.Y = candidate;
-    info.YX = row.count();
-    row.append(interval);
-    }
-  else
-    {
-    // No; make a new row
-    IntervalList row;
-    row.append(interval);
-    this->Rows.append(row);
-    info.Y = k;
-    info.YX = 0;
-    }
+  // Add the entity to the first row in which it fits; entities that arrive
+  // out of order are fitted into gaps in existing rows where possible
+  info.Y = this->Layout.insert(info.StartTime, info.VirtualEndTime);
 }
 
 //-----------------------------------------------------------------------------
@@ -482,69 +432,17 @@ void vsTimelineViewerPrivate::updateEntityYPosition(
 }
 
 //-----------------------------------------------------------------------------
-void vsTimelineViewerPrivate::updateRowInterval(const TimelineEntityInfo& info)
+void vsTimelineViewerPrivate::updateRowInterval(
+  TimelineEntityInfo& info, double oldStartTime)
 {
-  // Do nothing if layout is already dirty, as interval indices may be invalid,
-  // and we're due to relayout anyway
-  CHECK_ARG(!this->LayoutDirty);
-
-  // Get row and interval for entity
-  IntervalList& row = this->Rows[info.Y];
-  Interval& interval = row[info.YX];
-
-  // Test if lower boundary overlaps previous entity in row (if any)
-  if (interval.lower > info.StartTime && info.YX > 0)
+  // Update the entity's interval; if it no longer fits in its row, it is moved
+  // to another row, but the rest of the layout is unaffected
+  const int y = this->Layout.update(info.Y, oldStartTime,
+                                    info.StartTime, info.VirtualEndTime);
+  if (y != info.Y)
     {
-    const double available = row[info.YX - 1].upper + this->MinimumXPadding;
-    if (info.StartTime < available)
-      {
-      this->LayoutDirty = true;
-      return;
-      }
-    }
-
-  // Test if upper boundary overlaps next entity in row (if any)
-  if (interval.upper < info.VirtualEndTime && info.YX < row.count() - 1)
-    {
-    const double available = row[info.YX + 1].lower - this->MinimumXPadding;
-    if (info.VirtualEndTime > available)
-      {
-      this->LayoutDirty = true;
-      return;
-      }
-    }
-
-  // Updated entity still fits; update its interval
-  interval.lower = info.StartTime;
-  interval.upper = info.VirtualEndTime;
-}
-
-//-----------------------------------------------------------------------------
-void vsTimelineViewerPrivate::recomputeLayout()
-{
-  // Clear existing rows
-  this->Rows.clear();
-  this->LayoutDirty = false;
-  this->LastStartTime = -std::numeric_limits<double>::max();
-
-  // Build time-sorted list of all entities
-  QMultiMap<double, TimelineEntityInfo*> entities;
-  foreach_iter (EntityInfoMap::iterator, tIter, this->Tracks)
-    {
-    TimelineEntityInfo& tInfo = tIter.value();
-    entities.insert(tInfo.StartTime, &tInfo);
-    }
-  foreach_iter (EntityInfoMap::iterator, eIter, this->Events)
-    {
-    TimelineEntityInfo& eInfo = eIter.value();
-    entities.insert(eInfo.StartTime, &eInfo);
-    }
-
-  // Re-add each entity
-  foreach (TimelineEntityInfo* info, entities)
-    {
-    this->addEntityToRow(*info);
-    this->updateEntityYPosition(*info);
+    info.Y = y;
+    this->updateEntityYPosition(info);
     }
 }
 
@@ -617,19 +515,8 @@ vtkSmartPointer<vtkTable> vsTimelineViewerPrivate::createTable()
 //-----------------------------------------------------------------------------
 vgRange<double> vsTimelineViewerPrivate::getXExtents() const
 {
-  CHECK_ARG(!this->Rows.empty(), vgRange<double>(0.0, 0.0));
-
-  const double maxDouble = std::numeric_limits<double>::max();
-  vgRange<double> x(maxDouble, -maxDouble);
-
-  foreach (const IntervalList& row, this->Rows)
-    {
-    if (!row.isEmpty())
-      {
-      vgExpandLowerBoundary(x.lower, row.first().lower);
-      vgExpandUpperBoundary(x.upper, row.last().upper);
-      }
-    }
+  const vgRange<double> x = this->Layout.extents();
+  CHECK_ARG(x.lower <= x.upper, vgRange<double>(0.0, 0.0));
 
   return x;
 }
@@ -784,12 +671,6 @@ void vsTimelineViewer::render()
 {
   QTE_D(vsTimelineViewer);
 
-  if (d->LayoutDirty)
-    {
-    d->recomputeLayout();
-    d->ChartDirty = true;
-    }
-
   if (d->ChartDirty)
     {
     d->updateChart();
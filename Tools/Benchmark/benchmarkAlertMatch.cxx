@@ -0,0 +1,168 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vsAlertMatchIndex.h>
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+// Alert matches as vsCore kept them before the reverse index was added; each
+// alert holds its matched events, and removing an event scans every alert
+class AlertMatchScan
+{
+public:
+  void addMatch(int alertId, vtkIdType eventId)
+    {
+    this->AlertMatches[alertId].insert(eventId);
+    }
+
+  int removeEvent(vtkIdType eventId)
+    {
+    typedef QHash<int, QSet<vtkIdType> >::iterator Iterator;
+    int result = -1;
+    const Iterator end = this->AlertMatches.end();
+    for (Iterator iter = this->AlertMatches.begin(); iter != end; ++iter)
+      {
+      if (iter->remove(eventId))
+        {
+        result = iter->count();
+        }
+      }
+    return result;
+    }
+
+protected:
+  QHash<int, QSet<vtkIdType> > AlertMatches;
+};
+
+//-----------------------------------------------------------------------------
+void benchmarkAlertMatch(vgBenchmark& benchmark, const QList<int>& alertCounts,
+                         int eventCount, int removalCount)
+{
+  const int iterations = benchmark.iterations();
+  removalCount = qMax(1, qMin(removalCount, eventCount / iterations));
+
+  foreach (const int alertCount, alertCounts)
+    {
+    // Assign events to alerts at random; one event in four matches no alert,
+    // as most events in a session are not alert events
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> alertDist(0, alertCount - 1);
+    std::vector<int> eventAlerts(eventCount);
+    for (int n = 0; n < eventCount; ++n)
+      {
+      eventAlerts[n] = (n % 4 ? alertDist(rng) : -1);
+      }
+
+    // Remove a different set of events in each iteration, so that every
+    // removal finds the event still present
+    std::vector<vtkIdType> removals(eventCount);
+    for (int n = 0; n < eventCount; ++n)
+      {
+      removals[n] = n;
+      }
+    std::shuffle(removals.begin(), removals.end(), rng);
+
+    QJsonObject parameters;
+    parameters.insert("alerts", alertCount);
+    parameters.insert("events", eventCount);
+
+    // Build a separate index in each iteration, so that releasing the
+    // previous one is not included in the measurement
+    std::vector<vsAlertMatchIndex> indices(iterations);
+    int batch = 0;
+    benchmark.measure(
+      "alert-match", "index-add", parameters, eventCount, "events",
+      [&]{
+        vsAlertMatchIndex& index = indices[batch++];
+        for (int n = 0; n < eventCount; ++n)
+          {
+          if (eventAlerts[n] >= 0)
+            {
+            index.addMatch(eventAlerts[n], n);
+            }
+          }
+      });
+
+    vsAlertMatchIndex index = indices.back();
+    indices.clear();
+
+    AlertMatchScan scan;
+    for (int n = 0; n < eventCount; ++n)
+      {
+      if (eventAlerts[n] >= 0)
+        {
+        scan.addMatch(eventAlerts[n], n);
+        }
+      }
+
+    parameters.insert("removals", removalCount);
+
+    // Accumulate results so the removals cannot be optimized away
+    volatile int sink = 0;
+
+    batch = 0;
+    benchmark.measure(
+      "alert-match", "index-remove", parameters, removalCount, "events",
+      [&]{
+        const vtkIdType* const first = &removals[batch++ * removalCount];
+        for (int n = 0; n < removalCount; ++n)
+          {
+          sink += index.removeEvent(first[n]);
+          }
+      });
+
+    batch = 0;
+    benchmark.measure(
+      "alert-match", "scan-remove", parameters, removalCount, "events",
+      [&]{
+        const vtkIdType* const first = &removals[batch++ * removalCount];
+        for (int n = 0; n < removalCount; ++n)
+          {
+          sink += scan.removeEvent(first[n]);
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("alerts <list>",
+              "Comma separated list of alert counts for alert matching",
+              "1000,5000");
+
+  options.add("alert-events <num>",
+              "Number of events matched against alerts", "1000000");
+
+  options.add("alert-removals <num>",
+              "Number of events removed by each alert matching measurement",
+              "10000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkAlertMatch(benchmark, context.sizes("alerts"),
+                      context.count("alert-events"),
+                      context.count("alert-removals"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("alert-match", &addOptions, &run, false);
+
+} // namespace <anonymous>
@@ -0,0 +1,181 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgActivity.h>
+#include <vtkVgActivityManager.h>
+#include <vtkVgActivityTypeRegistry.h>
+#include <vtkVgEvent.h>
+#include <vtkVgEventModel.h>
+#include <vtkVgTrack.h>
+#include <vtkVgTrackModel.h>
+
+#include <vtkNew.h>
+#include <vtkRenderer.h>
+
+#include <QJsonObject>
+
+#include <random>
+#include <vector>
+
+using vgBenchmarkData::FrameInterval;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkDisplay(vgBenchmark& benchmark, const QList<int>& eventCounts,
+                      int activityCount, int frameCount)
+{
+  // Scrub through a long sequence, a few frames at a time, so that each frame
+  // change sees a modest number of events start and end
+  const int sequenceLength = frameCount * 100;
+  const int frameStep = 3;
+  const int steps = (sequenceLength + frameStep - 1) / frameStep;
+
+  foreach (const int eventCount, eventCounts)
+    {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> startDist(0, sequenceLength - 1);
+    std::uniform_int_distribution<int> lengthDist(30, 300);
+    std::uniform_real_distribution<double> posDist(0.0, 1000.0);
+
+    vtkNew<vtkVgTrackModel> trackModel;
+    vtkNew<vtkVgEventModel> eventModel;
+    eventModel->SetTrackModel(trackModel.GetPointer());
+
+    // Only events that support an activity are given a track, as activities
+    // derive their bounds from those of their tracks
+    const int activities = qMin(activityCount, eventCount);
+    std::vector<vtkVgEvent*> events;
+    for (int n = 0; n < eventCount; ++n)
+      {
+      const int first = startDist(rng);
+      const int last = first + lengthDist(rng);
+      const vtkVgTimeStamp start(first * FrameInterval, first);
+      const vtkVgTimeStamp end(last * FrameInterval, last);
+
+      vtkNew<vtkVgEvent> event;
+      event->SetId(n);
+      event->SetStartFrame(start);
+      event->SetEndFrame(end);
+
+      if (n < activities)
+        {
+        vtkNew<vtkVgTrack> track;
+        track->SetPoints(trackModel->GetPoints());
+        track->SetId(n);
+        const double x = posDist(rng), y = posDist(rng);
+        const double p0[2] = { x, y }, p1[2] = { x + 20.0, y + 20.0 };
+        track->InsertNextPoint(start, p0, vtkVgGeoCoord());
+        track->InsertNextPoint(end, p1, vtkVgGeoCoord());
+        trackModel->AddTrack(track.GetPointer());
+        event->AddTrack(track.GetPointer(), start, end);
+        }
+
+      events.push_back(eventModel->AddEvent(event.GetPointer()));
+      }
+
+    QJsonObject parameters;
+    parameters.insert("events", eventCount);
+    parameters.insert("frames", sequenceLength);
+    parameters.insert("frame_step", frameStep);
+
+    // The first update after adding events also builds the time index; this
+    // is done beforehand so that only the per-frame cost is measured
+    vtkVgTimeStamp time(0.0, 0);
+    eventModel->Update(time);
+
+    benchmark.measure(
+      "display", "events", parameters, steps, "frames",
+      [&]{
+        for (int frame = 0; frame < sequenceLength; frame += frameStep)
+          {
+          time = vtkVgTimeStamp(frame * FrameInterval, frame);
+          eventModel->Update(time);
+
+          // Visit the events to be drawn, as the representations do
+          eventModel->InitActiveEventTraversal();
+          while (eventModel->GetNextActiveEvent().GetEvent())
+            {
+            }
+          }
+      });
+
+    if (activities < 1)
+      {
+      continue;
+      }
+
+    // Build one activity around each of the events that has a track
+    vgActivityType type;
+    type.SetId("Benchmark");
+    vtkNew<vtkVgActivityTypeRegistry> registry;
+    registry->AddType(type);
+
+    vtkNew<vtkRenderer> renderer;
+    vtkNew<vtkVgActivityManager> manager;
+    manager->SetRenderer(renderer.GetPointer());
+    manager->SetEventModel(eventModel.GetPointer());
+    manager->SetActivityTypeRegistry(registry.GetPointer());
+    manager->InitializeTypeInfo();
+
+    for (int n = 0; n < activities; ++n)
+      {
+      vtkNew<vtkVgActivity> activity;
+      activity->SetId(n);
+      activity->SetType(0);
+      activity->AddEvent(events[n]);
+      activity->SetBoundsMode(true);
+
+      double bounds[4];
+      events[n]->GetFullBounds(bounds);
+      activity->SetSpatialBounds(bounds);
+      manager->AddActivity(activity.GetPointer());
+      }
+
+    parameters.insert("activities", activities);
+    manager->UpdateActivityActors(time);
+
+    benchmark.measure(
+      "display", "activities", parameters, steps, "frames",
+      [&]{
+        for (int frame = 0; frame < sequenceLength; frame += frameStep)
+          {
+          time = vtkVgTimeStamp(frame * FrameInterval, frame);
+          eventModel->Update(time);
+          manager->UpdateActivityActors(time);
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("events <list>",
+              "Comma separated list of event counts for display updates",
+              "10000,100000");
+
+  options.add("activities <num>",
+              "Number of activities for display updates", "10000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkDisplay(benchmark, context.sizes("events"),
+                   context.count("activities", 0),
+                   syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("display", &addOptions, &run, false);
+
+} // namespace <anonymous>
@@ -0,0 +1,97 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgGeodesy.h>
+#include <vgGeoTypes.h>
+
+#include <QJsonObject>
+
+#include <random>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkGeodesy(vgBenchmark& benchmark, const QList<int>& pointCounts)
+{
+  const int utmGcs = vgGeodesy::UTM_Wgs84North + 18;
+
+  foreach (const int pointCount, pointCounts)
+    {
+    // Scatter points over about a degree in each direction
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> latDist(42.5, 43.5);
+    std::uniform_real_distribution<double> lonDist(-74.5, -73.5);
+
+    vgGeocodedPoly poly;
+    poly.GCS = vgGeodesy::LatLon_Wgs84;
+    for (int n = 0; n < pointCount; ++n)
+      {
+      poly.Coordinate.push_back(
+        vgGeoRawCoordinate(latDist(rng), lonDist(rng)));
+      }
+
+    QJsonObject parameters;
+    parameters.insert("points", pointCount);
+
+    // Accumulate results so the conversions cannot be optimized away
+    volatile double sink = 0.0;
+
+    // Convert one coordinate at a time
+    benchmark.measure(
+      "geodesy", "convert-each", parameters, pointCount, "points",
+      [&]{
+        for (const vgGeoRawCoordinate& raw : poly.Coordinate)
+          {
+          const vgGeocodedCoordinate in(raw, poly.GCS);
+          sink += vgGeodesy::convertGcs(in, utmGcs).Easting;
+          }
+      });
+
+    // Convert the whole polygon in one batch
+    benchmark.measure(
+      "geodesy", "convert-poly", parameters, pointCount, "points",
+      [&]{
+        const vgGeocodedPoly out = vgGeodesy::convertGcs(poly, utmGcs);
+        sink += out.Coordinate.back().Easting;
+      });
+
+    // Generate regions (as is done for MGRS queries) around the points
+    const int regionCount = qMin(pointCount, 1000);
+    benchmark.measure(
+      "geodesy", "generate-region", parameters, regionCount, "regions",
+      [&]{
+        for (int n = 0; n < regionCount; ++n)
+          {
+          const vgGeocodedCoordinate center(poly.Coordinate[n], poly.GCS);
+          const vgGeocodedPoly region =
+            vgGeodesy::generateRegion(center, 100.0);
+          sink += region.Coordinate.size();
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("geo-points <list>",
+              "Comma separated list of point counts for coordinate "
+              "conversion", "1000,100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkGeodesy(benchmark, context.sizes("geo-points"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("geodesy", &addOptions, &run, false);
+
+} // namespace <anonymous>
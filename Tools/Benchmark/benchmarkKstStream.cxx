@@ -0,0 +1,116 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vvHeader.h>
+#include <vvKstStreamReader.h>
+#include <vvReader.h>
+#include <vvWriter.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QUrl>
+
+#include <random>
+
+using vgBenchmarkData::makeSyntheticResults;
+using vgBenchmarkData::writeSyntheticArchive;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkKstStream(vgBenchmark& benchmark, const QString& directory,
+                        const QList<int>& resultCounts, int trackLength,
+                        int frameCount, int threadCount)
+{
+  std::mt19937 rng(42);
+
+  foreach (const int resultCount, resultCounts)
+    {
+    const QString resultFile =
+      QDir(directory).filePath(QString("results-%1.vqr").arg(resultCount));
+
+    // Write synthetic data; this is scoped so that the synthetic results do
+    // not contribute to the memory use of the readers
+      {
+      const QList<vvQueryResult> results =
+        makeSyntheticResults(resultCount, trackLength, frameCount, rng);
+      if (!writeSyntheticArchive(resultFile, vvWriter::Kst,
+                                 vvHeader::QueryResults, results))
+        {
+        continue;
+        }
+      }
+
+    const qint64 bytes = QFileInfo(resultFile).size();
+    const double megabytes = 1e-6 * bytes;
+
+    QJsonObject parameters;
+    parameters.insert("results", resultCount);
+    parameters.insert("track_length", trackLength);
+    parameters.insert("bytes", bytes);
+
+    // Peak RSS is a process-wide high-water mark, so run the streaming
+    // reader first; the reader under test can be isolated by running each
+    // suite (and result count) in a separate process
+    QList<int> threadCounts;
+    threadCounts << 1;
+    if (threadCount > 1)
+      {
+      threadCounts << threadCount;
+      }
+
+    foreach (const int threads, threadCounts)
+      {
+      parameters.insert("threads", threads);
+      benchmark.measure(
+        "kst-stream", "stream", parameters, megabytes, "MB",
+        [&]{
+          vvKstStreamReader reader;
+          vvHeader header;
+          reader.setThreadCount(threads);
+          if (!reader.open(resultFile) || !reader.readHeader(header) ||
+              !reader.readQueryResults([](vvQueryResult&){ return true; }))
+            {
+            qWarning() << "Failed to read" << resultFile
+                       << '-' << reader.error();
+            }
+        });
+      }
+
+    parameters.remove("threads");
+    benchmark.measure(
+      "kst-stream", "vvreader", parameters, megabytes, "MB",
+      [&]{
+        vvReader reader;
+        vvHeader header;
+        QList<vvQueryResult> result;
+        if (!reader.open(QUrl::fromLocalFile(resultFile)) ||
+            !reader.readHeader(header) || !reader.readQueryResults(result))
+          {
+          qWarning() << "Failed to read" << resultFile
+                     << '-' << reader.error();
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkKstStream(benchmark, context.workDirectory(),
+                     context.sizes("tracks"), syntheticTrackLength(context),
+                     syntheticFrameCount(context),
+                     context.threadCount("threads"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("kst-stream", 0, &run, false);
+
+} // namespace <anonymous>
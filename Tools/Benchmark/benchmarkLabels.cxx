@@ -0,0 +1,156 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vtkVgAnnotationActor.h>
+#include <vtkVgLabelLayer.h>
+
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkSmartPointer.h>
+
+#include <QJsonObject>
+
+#include <random>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkLabels(vgBenchmark& benchmark, const QList<int>& labelCounts,
+                     int width, int height)
+{
+  const int frameCount = 100;
+
+  // Render off screen; if VTK is built with OSMesa, this uses a software
+  // rendered context, and so measures the cost on machines without a GPU
+  vtkNew<vtkRenderWindow> window;
+  vtkNew<vtkRenderer> renderer;
+  window->SetOffScreenRendering(1);
+  window->SetSize(width, height);
+  window->AddRenderer(renderer.GetPointer());
+
+  // Set up the camera so that one world unit is one pixel
+  vtkCamera* const camera = renderer->GetActiveCamera();
+  camera->ParallelProjectionOn();
+  camera->SetParallelScale(0.5 * height);
+
+  // Scatter labels over an area four times the size of the view, and pan
+  // across it so that labels are placed again on every frame
+  const auto render = [&]{
+    for (int frame = 0; frame < frameCount; ++frame)
+      {
+      const double x = 0.5 * width + frame * (width / frameCount);
+      const double y = 0.5 * height + frame * (height / frameCount);
+      camera->SetFocalPoint(x, y, 0.0);
+      camera->SetPosition(x, y, 1.0);
+      window->Render();
+      }
+    };
+
+  foreach (const int labelCount, labelCounts)
+    {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> xDist(0.0, 2.0 * width);
+    std::uniform_real_distribution<double> yDist(0.0, 2.0 * height);
+    std::uniform_int_distribution<int> colorDist(0, 255);
+
+    vtkNew<vtkVgLabelLayer> layer;
+    for (int n = 0; n < labelCount; ++n)
+      {
+      const double position[] = { xDist(rng), yDist(rng), 0.0 };
+      const unsigned char fg[] = { 255, 255, 255 };
+      const unsigned char bg[] =
+        {
+        static_cast<unsigned char>(colorDist(rng)),
+        static_cast<unsigned char>(colorDist(rng)),
+        static_cast<unsigned char>(colorDist(rng))
+        };
+      layer->AddLabel(n, position, qPrintable(QString("T%1").arg(n)),
+                      fg, bg);
+      }
+
+    renderer->AddViewProp(layer.GetPointer());
+    window->Render();
+
+    QJsonObject parameters;
+    parameters.insert("labels", labelCount);
+    parameters.insert("placed", layer->GetNumberOfPlacedLabels());
+    parameters.insert("width", width);
+    parameters.insert("height", height);
+
+    benchmark.measure("labels", "layer", parameters, frameCount, "frames",
+                      render);
+
+    // Also measure with overlapping labels culled, which places fewer labels
+    // but must test each label against those already placed
+    layer->CullOverlappingLabelsOn();
+    window->Render();
+    parameters.insert("placed", layer->GetNumberOfPlacedLabels());
+    benchmark.measure("labels", "layer-culled", parameters, frameCount,
+                      "frames", render);
+    layer->CullOverlappingLabelsOff();
+
+    renderer->RemoveViewProp(layer.GetPointer());
+
+    // For comparison, draw the same labels with one actor per label, as was
+    // previously done for track labels
+    std::vector<vtkSmartPointer<vtkVgAnnotationActor> > actors;
+    for (int n = 0; n < labelCount; ++n)
+      {
+      double position[3];
+      unsigned char bg[3];
+      layer->GetLabelPositions()->GetPoint(n, position);
+      layer->GetBackgroundColors()->GetTypedTuple(n, bg);
+
+      auto actor = vtkSmartPointer<vtkVgAnnotationActor>::New();
+      actor->SetClampToViewport(false);
+      actor->SetOffset(0, -15);
+      actor->AutoCenterXOn();
+      actor->SetText(layer->GetLabelText()->GetValue(n).c_str());
+      actor->SetPosition(position);
+      actor->GetFrameProperty()->SetColor(bg[0] / 255.0, bg[1] / 255.0,
+                                          bg[2] / 255.0);
+      renderer->AddViewProp(actor);
+      actors.push_back(actor);
+      }
+
+    window->Render();
+    parameters.remove("placed");
+    benchmark.measure("labels", "actors", parameters, frameCount, "frames",
+                      render);
+
+    for (size_t n = 0; n < actors.size(); ++n)
+      {
+      renderer->RemoveViewProp(actors[n]);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("labels <list>",
+              "Comma separated list of label counts for label rendering",
+              "1000,10000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkLabels(benchmark, context.sizes("labels"),
+                  frameSize.width(), frameSize.height());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("labels", &addOptions, &run, false);
+
+} // namespace <anonymous>
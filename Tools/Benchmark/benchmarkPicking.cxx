@@ -0,0 +1,192 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vtkVgAreaPicker.h>
+#include <vtkVgFindNodeVisitor.h>
+#include <vtkVgGeode.h>
+#include <vtkVgGroupNode.h>
+#include <vtkVgSceneManager.h>
+
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProp3DCollection.h>
+#include <vtkPropPicker.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+
+#include <QJsonObject>
+
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkPicking(vgBenchmark& benchmark, const QList<int>& nodeCounts,
+                      int width, int height)
+{
+  const int pointPickCount = 100;
+  const int areaPickCount = 20;
+
+  // Render off screen, with one world unit per pixel
+  vtkNew<vtkRenderWindow> window;
+  window->SetOffScreenRendering(1);
+  window->SetSize(width, height);
+
+  vtkNew<vtkPlaneSource> plane;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(plane->GetOutputPort());
+
+  foreach (const int nodeCount, nodeCounts)
+    {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> xDist(0.0, width);
+    std::uniform_real_distribution<double> yDist(0.0, height);
+
+    auto manager = vtkVgSceneManager::SmartPtr::New();
+    vtkRenderer* const renderer = manager->GetSceneRenderer();
+    window->AddRenderer(renderer);
+
+    vtkCamera* const camera = renderer->GetActiveCamera();
+    camera->ParallelProjectionOn();
+    camera->SetParallelScale(0.5 * height);
+    camera->SetFocalPoint(0.5 * width, 0.5 * height, 0.0);
+    camera->SetPosition(0.5 * width, 0.5 * height, 1.0);
+
+    // Size nodes so that, together, they cover about the whole view
+    const double size = std::sqrt(static_cast<double>(width) * height /
+                                  nodeCount);
+
+    auto root = vtkVgGroupNode::SmartPtr::New();
+    for (int n = 0; n < nodeCount; ++n)
+      {
+      vtkNew<vtkActor> actor;
+      actor->SetMapper(mapper.GetPointer());
+      actor->SetScale(size, size, 1.0);
+      actor->SetPosition(xDist(rng), yDist(rng), 0.0);
+
+      auto geode = vtkVgGeode::SmartPtr::New();
+      geode->AddDrawable(actor.GetPointer());
+      root->AddChild(geode);
+      }
+
+    manager->SetSceneRoot(root);
+    manager->Update(vtkVgTimeStamp());
+    renderer->ResetCameraClippingRange();
+    window->Render();
+
+    std::vector<std::pair<double, double> > points;
+    for (int n = 0; n < pointPickCount; ++n)
+      {
+      points.push_back(std::make_pair(xDist(rng), yDist(rng)));
+      }
+
+    std::vector<std::pair<double, double> > areas;
+    for (int n = 0; n < areaPickCount; ++n)
+      {
+      areas.push_back(std::make_pair(xDist(rng), yDist(rng)));
+      }
+    const double areaWidth = 0.1 * width;
+    const double areaHeight = 0.1 * height;
+
+    QJsonObject parameters;
+    parameters.insert("nodes", nodeCount);
+    parameters.insert("width", width);
+    parameters.insert("height", height);
+
+    benchmark.measure(
+      "picking", "point", parameters, pointPickCount, "picks",
+      [&]{
+        for (size_t n = 0; n < points.size(); ++n)
+          {
+          manager->Pick(points[n].first, points[n].second, 0.0);
+          }
+      });
+
+    // For comparison, pick from every prop and search the scene for the
+    // picked prop's node, as was previously done
+    vtkNew<vtkPropPicker> propPicker;
+    benchmark.measure(
+      "picking", "point-walk", parameters, pointPickCount, "picks",
+      [&]{
+        for (size_t n = 0; n < points.size(); ++n)
+          {
+          if (propPicker->Pick(points[n].first, points[n].second, 0.0,
+                               renderer))
+            {
+            vtkVgFindNodeVisitor visitor;
+            visitor.SetUsingProp3D(propPicker->GetProp3D());
+            root->Accept(visitor);
+            }
+          }
+      });
+
+    benchmark.measure(
+      "picking", "area", parameters, areaPickCount, "picks",
+      [&]{
+        for (size_t n = 0; n < areas.size(); ++n)
+          {
+          std::vector<vtkVgNodeBase*> nodes;
+          manager->PickNodes(areas[n].first, areas[n].second,
+                             areas[n].first + areaWidth,
+                             areas[n].second + areaHeight, nodes);
+          }
+      });
+
+    vtkNew<vtkVgAreaPicker> areaPicker;
+    benchmark.measure(
+      "picking", "area-walk", parameters, areaPickCount, "picks",
+      [&]{
+        for (size_t n = 0; n < areas.size(); ++n)
+          {
+          areaPicker->AreaPick(areas[n].first, areas[n].second,
+                               areas[n].first + areaWidth,
+                               areas[n].second + areaHeight, renderer);
+
+          vtkProp3DCollection* const props = areaPicker->GetProp3Ds();
+          vtkCollectionSimpleIterator iter;
+          props->InitTraversal(iter);
+          while (vtkProp3D* prop = props->GetNextProp3D(iter))
+            {
+            vtkVgFindNodeVisitor visitor;
+            visitor.SetUsingProp3D(prop);
+            root->Accept(visitor);
+            }
+          }
+      });
+
+    window->RemoveRenderer(renderer);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("pick-nodes <list>",
+              "Comma separated list of scene node counts for picking",
+              "1000,10000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkPicking(benchmark, context.sizes("pick-nodes"),
+                   frameSize.width(), frameSize.height());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("picking", &addOptions, &run, false);
+
+} // namespace <anonymous>
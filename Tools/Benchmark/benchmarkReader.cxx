@@ -0,0 +1,143 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vvHeader.h>
+#include <vvReader.h>
+#include <vvWriter.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QUrl>
+
+#include <random>
+
+using vgBenchmarkData::makeSyntheticDescriptors;
+using vgBenchmarkData::makeSyntheticResults;
+using vgBenchmarkData::makeSyntheticTracks;
+using vgBenchmarkData::writeSyntheticArchive;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkReader(vgBenchmark& benchmark, const QString& directory,
+                     const QList<int>& trackCounts, int trackLength,
+                     int frameCount)
+{
+  std::mt19937 rng(42);
+
+  const struct { vvWriter::Format format; const char* name; } formats[] = {
+    { vvWriter::Kst, "kst" },
+    { vvWriter::Xml, "xml" },
+    { vvWriter::Binary, "binary" },
+  };
+
+  foreach (const int trackCount, trackCounts)
+    {
+    const QList<vvTrack> tracks =
+      makeSyntheticTracks(trackCount, trackLength, frameCount, rng);
+    const QList<vvDescriptor> descriptors =
+      makeSyntheticDescriptors(trackCount, 128, rng);
+    const QList<vvQueryResult> results =
+      makeSyntheticResults(trackCount, trackLength, frameCount, rng);
+
+    for (auto f : formats)
+      {
+      const QString name = QString::fromLatin1(f.name);
+      const QString trackFile =
+        QDir(directory).filePath(QString("tracks-%1.%2").arg(trackCount)
+                                                        .arg(name));
+      const QString descriptorFile =
+        QDir(directory).filePath(QString("descriptors-%1.%2").arg(trackCount)
+                                                             .arg(name));
+      const QString resultFile =
+        QDir(directory).filePath(QString("results-%1.%2").arg(trackCount)
+                                                         .arg(name));
+
+      if (!writeSyntheticArchive(trackFile, f.format,
+                                 vvHeader::Tracks, tracks) ||
+          !writeSyntheticArchive(descriptorFile, f.format,
+                                 vvHeader::Descriptors, descriptors) ||
+          !writeSyntheticArchive(resultFile, f.format,
+                                 vvHeader::QueryResults, results))
+        {
+        continue;
+        }
+
+      QJsonObject parameters;
+      parameters.insert("format", name);
+      parameters.insert("tracks", trackCount);
+      parameters.insert("track_length", trackLength);
+      parameters.insert("bytes", QFileInfo(trackFile).size());
+
+      benchmark.measure(
+        "reader", "tracks", parameters, trackCount, "tracks",
+        [&]{
+          vvReader reader;
+          vvHeader header;
+          QList<vvTrack> result;
+          if (!reader.open(QUrl::fromLocalFile(trackFile)) ||
+              !reader.readHeader(header) || !reader.readTracks(result))
+            {
+            qWarning() << "Failed to read" << trackFile
+                       << '-' << reader.error();
+            }
+        });
+
+      parameters.insert("descriptors", trackCount);
+      parameters.insert("bytes", QFileInfo(descriptorFile).size());
+      parameters.remove("tracks");
+      parameters.remove("track_length");
+
+      benchmark.measure(
+        "reader", "descriptors", parameters, trackCount, "descriptors",
+        [&]{
+          vvReader reader;
+          vvHeader header;
+          QList<vvDescriptor> result;
+          if (!reader.open(QUrl::fromLocalFile(descriptorFile)) ||
+              !reader.readHeader(header) || !reader.readDescriptors(result))
+            {
+            qWarning() << "Failed to read" << descriptorFile
+                       << '-' << reader.error();
+            }
+        });
+
+      parameters.insert("results", trackCount);
+      parameters.insert("bytes", QFileInfo(resultFile).size());
+      parameters.remove("descriptors");
+
+      benchmark.measure(
+        "reader", "results", parameters, trackCount, "results",
+        [&]{
+          vvReader reader;
+          vvHeader header;
+          QList<vvQueryResult> result;
+          if (!reader.open(QUrl::fromLocalFile(resultFile)) ||
+              !reader.readHeader(header) || !reader.readQueryResults(result))
+            {
+            qWarning() << "Failed to read" << resultFile
+                       << '-' << reader.error();
+            }
+        });
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkReader(benchmark, context.workDirectory(), context.sizes("tracks"),
+                  syntheticTrackLength(context), syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("reader", 0, &run, true);
+
+} // namespace <anonymous>
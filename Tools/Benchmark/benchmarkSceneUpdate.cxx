@@ -0,0 +1,160 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vtkVgGeode.h>
+#include <vtkVgGroupNode.h>
+#include <vtkVgSceneManager.h>
+
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkNew.h>
+#include <vtkPlaneSource.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+
+#include <QJsonObject>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkSceneUpdate(vgBenchmark& benchmark, const QList<int>& nodeCounts,
+                          int width, int height)
+{
+  const int frameCount = 100;
+  const int changesPerFrame = 10;
+
+  vtkNew<vtkRenderWindow> window;
+  window->SetOffScreenRendering(1);
+  window->SetSize(width, height);
+
+  vtkNew<vtkPlaneSource> plane;
+  vtkNew<vtkPolyDataMapper> mapper;
+  mapper->SetInputConnection(plane->GetOutputPort());
+
+  foreach (const int nodeCount, nodeCounts)
+    {
+    std::mt19937 rng(42);
+
+    // Spread the nodes over an area four times that of the view, so that
+    // about a quarter of them are in view
+    std::uniform_real_distribution<double> xDist(0.0, 2.0 * width);
+    std::uniform_real_distribution<double> yDist(0.0, 2.0 * height);
+    std::uniform_int_distribution<int> nodeDist(0, nodeCount - 1);
+
+    const double size = std::sqrt(4.0 * width * height / nodeCount);
+
+    auto makeNode = [&]() -> vtkVgGeode::SmartPtr {
+      vtkNew<vtkActor> actor;
+      actor->SetMapper(mapper.GetPointer());
+      actor->SetScale(size, size, 1.0);
+      actor->SetPosition(xDist(rng), yDist(rng), 0.0);
+
+      auto geode = vtkVgGeode::SmartPtr::New();
+      geode->AddDrawable(actor.GetPointer());
+      return geode;
+    };
+
+    QJsonObject parameters;
+    parameters.insert("nodes", nodeCount);
+    parameters.insert("width", width);
+    parameters.insert("height", height);
+
+    // Compare updating only changed nodes in view to visiting every node
+    for (int incremental = 1; incremental >= 0; --incremental)
+      {
+      auto manager = vtkVgSceneManager::SmartPtr::New();
+      manager->SetSkipUnchangedNodes(incremental != 0);
+      manager->SetCullToView(incremental != 0);
+
+      vtkRenderer* const renderer = manager->GetSceneRenderer();
+      window->AddRenderer(renderer);
+
+      vtkCamera* const camera = renderer->GetActiveCamera();
+      camera->ParallelProjectionOn();
+      camera->SetParallelScale(0.5 * height);
+      camera->SetFocalPoint(0.5 * width, 0.5 * height, 0.0);
+      camera->SetPosition(0.5 * width, 0.5 * height, 1.0);
+
+      std::vector<vtkVgGeode::SmartPtr> nodes;
+      auto root = vtkVgGroupNode::SmartPtr::New();
+      for (int n = 0; n < nodeCount; ++n)
+        {
+        nodes.push_back(makeNode());
+        root->AddChild(nodes.back());
+        }
+
+      manager->SetSceneRoot(root);
+      manager->Update(vtkVgTimeStamp());
+
+      const QString suffix = (incremental ? "" : "-full");
+      vtkVgTimeStamp now(0.0);
+
+      benchmark.measure(
+        "scene-update", "idle" + suffix, parameters, frameCount, "frames",
+        [&]{
+          for (int n = 0; n < frameCount; ++n)
+            {
+            now.SetTime(now.GetTime() + 1.0);
+            manager->Update(now);
+            }
+        });
+
+      // Each frame, hide or show some nodes, and replace one node with a new
+      // one, so that props are both added and removed
+      benchmark.measure(
+        "scene-update", "changes" + suffix, parameters, frameCount, "frames",
+        [&]{
+          for (int n = 0; n < frameCount; ++n)
+            {
+            for (int k = 0; k < changesPerFrame; ++k)
+              {
+              vtkVgGeode* const node = nodes[nodeDist(rng)];
+              node->SetVisible(!node->GetVisible());
+              }
+
+            const int replaced = nodeDist(rng);
+            root->RemoveChild(nodes[replaced]);
+            nodes[replaced] = makeNode();
+            root->AddChild(nodes[replaced]);
+
+            now.SetTime(now.GetTime() + 1.0);
+            manager->Update(now);
+            }
+        });
+
+      window->RemoveRenderer(renderer);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("update-nodes <list>",
+              "Comma separated list of scene node counts for scene updates",
+              "1000,10000,50000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkSceneUpdate(benchmark, context.sizes("update-nodes"),
+                       frameSize.width(), frameSize.height());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("scene-update", &addOptions, &run, false);
+
+} // namespace <anonymous>
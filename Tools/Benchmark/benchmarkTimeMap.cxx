@@ -0,0 +1,96 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vgTimeMap.h>
+
+#include <QJsonObject>
+
+#include <random>
+#include <vector>
+
+using vgBenchmarkData::FrameInterval;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTimeMap(vgBenchmark& benchmark, const QList<int>& mapSizes,
+                      int seekCount)
+{
+  const struct { vg::SeekMode mode; const char* name; } modes[] = {
+    { vg::SeekExact, "exact" },
+    { vg::SeekNearest, "nearest" },
+    { vg::SeekLowerBound, "lower-bound" },
+    { vg::SeekPrevious, "previous" },
+  };
+
+  foreach (const int size, mapSizes)
+    {
+    vgTimeMap<int> map;
+    for (int n = 0; n < size; ++n)
+      {
+      map.insert(vgTimeStamp(n * FrameInterval, n), n);
+      }
+
+    // Seek to times on and between entries, in a fixed pseudo-random order
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<qint64> timeDist(
+      0, static_cast<qint64>(size) * FrameInterval);
+    std::vector<vgTimeStamp> times(seekCount);
+    for (int n = 0; n < seekCount; ++n)
+      {
+      const qint64 t = timeDist(rng);
+      times[n] = vgTimeStamp::fromTime(
+        (n & 1) ? t : (t / FrameInterval) * FrameInterval);
+      }
+
+    for (auto m : modes)
+      {
+      QJsonObject parameters;
+      parameters.insert("entries", size);
+      parameters.insert("mode", QString::fromLatin1(m.name));
+
+      // Accumulate results so the seeks cannot be optimized away
+      volatile int sink = 0;
+      benchmark.measure(
+        "timemap", "seek", parameters, seekCount, "seeks",
+        [&]{
+          const vgTimeMap<int>& cmap = map;
+          for (const vgTimeStamp& ts : times)
+            {
+            const vgTimeMap<int>::const_iterator iter = cmap.find(ts, m.mode);
+            sink += (iter == cmap.constEnd() ? 0 : iter.value());
+            }
+        });
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("map-sizes <list>",
+              "Comma separated list of time map sizes", "1000,100000");
+
+  options.add("seeks <num>",
+              "Number of seeks per time map measurement", "100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTimeMap(benchmark, context.sizes("map-sizes"),
+                   context.count("seeks"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("timemap", &addOptions, &run, true);
+
+} // namespace <anonymous>
@@ -0,0 +1,209 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vtkVgChartTimeline.h>
+#include <vtkVgPlotTimeline.h>
+
+#include <vtkAxis.h>
+#include <vtkContextMouseEvent.h>
+#include <vtkContextScene.h>
+#include <vtkContextView.h>
+#include <vtkFloatArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkLookupTable.h>
+#include <vtkNew.h>
+#include <vtkTable.h>
+
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTimeline(vgBenchmark& benchmark,
+                       const QList<int>& intervalCounts,
+                       int width, int height)
+{
+  const int frameCount = 50;
+  const int hoverCount = 10000;
+  const int rowCount = 50;
+  const double span = 3600.0; // one hour, in seconds
+
+  foreach (const int intervalCount, intervalCounts)
+    {
+    // Set up a timeline as viqui does, with one interval plot colored by a
+    // scalar column, rendered off screen
+    vtkNew<vtkContextView> view;
+    view->GetRenderWindow()->SetOffScreenRendering(1);
+    view->GetRenderWindow()->SetSize(width, height);
+
+    vtkNew<vtkVgChartTimeline> chart;
+    chart->SetAutoAxes(false);
+    chart->SetShowLegend(false);
+    view->GetScene()->AddItem(chart.GetPointer());
+
+    vtkNew<vtkTable> table;
+    const char* const columnNames[] = { "X", "Y", "Colors" };
+    for (int c = 0; c < 3; ++c)
+      {
+      vtkNew<vtkFloatArray> column;
+      column->SetName(columnNames[c]);
+      table->AddColumn(column.GetPointer());
+      }
+    vtkNew<vtkIdTypeArray> idColumn;
+    idColumn->SetName("Id");
+    table->AddColumn(idColumn.GetPointer());
+
+    // Intervals are mostly short (a few seconds), with a few long ones
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> startDist(0.0, span);
+    std::exponential_distribution<double> lengthDist(1.0 / 5.0);
+    std::uniform_int_distribution<int> rowDist(0, rowCount - 1);
+    std::uniform_real_distribution<double> unitDist(0.0, 1.0);
+
+    const auto addIntervals = [&](int first, int last){
+      for (int n = first; n < last; ++n)
+        {
+        const double start = startDist(rng);
+        const double end = std::min(span, start + lengthDist(rng));
+        const float y = static_cast<float>(rowDist(rng));
+        const float color = static_cast<float>(unitDist(rng));
+        const double x[] = { start, end };
+        for (int k = 0; k < 2; ++k)
+          {
+          const vtkIdType row = table->InsertNextBlankRow();
+          table->SetValue(row, 0, x[k]);
+          table->SetValue(row, 1, y);
+          table->SetValue(row, 2, color);
+          table->SetValue(row, 3, n);
+          }
+        }
+      table->Modified();
+    };
+
+    // Start with a small part of the data, so that the rest can be appended
+    // below to measure incremental updates
+    const int initialCount = intervalCount / 10;
+    addIntervals(0, initialCount);
+
+    vtkNew<vtkLookupTable> lut;
+    lut->SetRange(0.0, 1.0);
+    lut->Build();
+
+    vtkNew<vtkVgPlotTimeline> plot;
+    plot->SetInputData(table.GetPointer(), 0, 1);
+    plot->SetIsIntervalPlot(true);
+    plot->SetScalarVisibility(1);
+    plot->SelectColorArray("Colors");
+    plot->SetLookupTable(lut.GetPointer());
+    chart->AddPlot(plot.GetPointer());
+
+    vtkAxis* const xAxis = chart->GetAxis(vtkAxis::BOTTOM);
+    chart->GetAxis(vtkAxis::LEFT)->SetRange(-0.5, rowCount - 0.5);
+    xAxis->SetRange(0.0, span);
+    view->Render();
+
+    QJsonObject parameters;
+    parameters.insert("intervals", intervalCount);
+    parameters.insert("rows", rowCount);
+    parameters.insert("width", width);
+    parameters.insert("height", height);
+
+    // Append the remaining intervals in batches, repainting after each batch
+    // as the timeline would while data is being loaded
+    const int batchCount = 20;
+    benchmark.measure(
+      "timeline", "append", parameters, batchCount, "batches",
+      [&]{
+        table->SetNumberOfRows(2 * initialCount);
+        table->Modified();
+        view->Render();
+        for (int b = 0; b < batchCount; ++b)
+          {
+          const int remaining = intervalCount - initialCount;
+          addIntervals(initialCount + (remaining * b) / batchCount,
+                       initialCount + (remaining * (b + 1)) / batchCount);
+          view->Render();
+          }
+      });
+
+    // Measure repainting with the whole timeline visible (which is drawn
+    // from the binned summary when there are many intervals), and zoomed in
+    // to a minute of data, panning across the timeline
+    const auto paint = [&](double visibleSpan){
+      for (int frame = 0; frame < frameCount; ++frame)
+        {
+        const double start = (span - visibleSpan) * frame / frameCount;
+        xAxis->SetRange(start, start + visibleSpan);
+        chart->RecalculatePlotTransforms();
+        view->GetScene()->SetDirty(true);
+        view->Render();
+        }
+      };
+
+    benchmark.measure("timeline", "paint-all", parameters, frameCount,
+                      "frames", [&]{ paint(span); });
+    benchmark.measure("timeline", "paint-zoomed", parameters, frameCount,
+                      "frames", [&]{ paint(60.0); });
+
+    // Measure hover (tooltip) hit testing, with the whole timeline visible
+    xAxis->SetRange(0.0, span);
+    chart->RecalculatePlotTransforms();
+    view->Render();
+
+    std::vector<vtkVector2f> positions;
+    const int* const origin = chart->GetPoint1();
+    const int* const corner = chart->GetPoint2();
+    std::uniform_real_distribution<float> xPixelDist(origin[0], corner[0]);
+    std::uniform_real_distribution<float> yPixelDist(origin[1], corner[1]);
+    for (int n = 0; n < hoverCount; ++n)
+      {
+      positions.push_back(vtkVector2f(xPixelDist(rng), yPixelDist(rng)));
+      }
+
+    benchmark.measure(
+      "timeline", "hover", parameters, hoverCount, "events",
+      [&]{
+        vtkContextMouseEvent mouse;
+        mouse.SetButton(vtkContextMouseEvent::NO_BUTTON);
+        foreach (const vtkVector2f& pos, positions)
+          {
+          mouse.SetPos(pos);
+          mouse.SetScreenPos(vtkVector2i(static_cast<int>(pos[0]),
+                                         static_cast<int>(pos[1])));
+          chart->MouseMoveEvent(mouse);
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("intervals <list>",
+              "Comma separated list of interval counts for timeline "
+              "rendering", "10000,100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkTimeline(benchmark, context.sizes("intervals"),
+                    frameSize.width(), frameSize.height());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("timeline", &addOptions, &run, false);
+
+} // namespace <anonymous>
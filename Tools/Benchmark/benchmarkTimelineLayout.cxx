@@ -0,0 +1,158 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgRowPacker.h>
+
+#include <QJsonObject>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTimelineLayout(vgBenchmark& benchmark,
+                             const QList<int>& entityCounts)
+{
+  // Entities arrive about every 10 ms of data time, with a random delay of up
+  // to one second, as from a streaming source; the timeline renders after
+  // every 100 arrivals
+  const qint64 arrivalInterval = 10000;
+  const qint64 maxJitter = 1000000;
+  const qint64 padding = 1000000;
+  const int renderInterval = 100;
+
+  foreach (const int entityCount, entityCounts)
+    {
+    struct Entity { double Start; double End; };
+    std::vector<Entity> entities;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<qint64> jitterDist(0, maxJitter);
+    std::exponential_distribution<double> lengthDist(1.0 / 5e6);
+    for (int n = 0; n < entityCount; ++n)
+      {
+      Entity e;
+      e.Start = static_cast<double>(n * arrivalInterval);
+      e.End = e.Start + std::max(1e6, lengthDist(rng));
+      entities.push_back(e);
+      }
+
+    // Deliver entities in order of their start time plus jitter
+    std::vector<double> arrival(entities.size());
+    for (size_t n = 0; n < entities.size(); ++n)
+      {
+      arrival[n] = entities[n].Start + jitterDist(rng);
+      }
+    std::vector<size_t> order(entities.size());
+    for (size_t n = 0; n < order.size(); ++n)
+      {
+      order[n] = n;
+      }
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b){ return arrival[a] < arrival[b]; });
+
+    QJsonObject parameters;
+    parameters.insert("entities", entityCount);
+    parameters.insert("jitter_us", maxJitter);
+
+    volatile int sink = 0;
+
+    // Incremental packing, placing each entity as it arrives
+    benchmark.measure(
+      "timeline-layout", "incremental", parameters, entityCount, "entities",
+      [&]{
+        vgRowPacker packer(padding);
+        for (const size_t n : order)
+          {
+          sink += packer.insert(entities[n].Start, entities[n].End);
+          }
+        sink += packer.rowCount();
+      });
+
+    // For comparison, the previous approach: place entities that arrive in
+    // order in the first row whose last entity ends before they start, but
+    // relayout everything before the next render if any entity arrives out of
+    // order
+    benchmark.measure(
+      "timeline-layout", "relayout", parameters, entityCount, "entities",
+      [&]{
+        std::vector<double> rowEnds;
+        std::vector<size_t> arrived;
+        double lastStart = -std::numeric_limits<double>::max();
+        bool dirty = false;
+
+        const auto addToRow = [&](const Entity& e){
+          if (dirty || e.Start < lastStart)
+            {
+            dirty = true;
+            return;
+            }
+          lastStart = e.Start;
+
+          size_t row = 0;
+          while (row < rowEnds.size() && !(rowEnds[row] + padding < e.Start))
+            {
+            ++row;
+            }
+          if (row == rowEnds.size())
+            {
+            rowEnds.push_back(e.End);
+            }
+          rowEnds[row] = e.End;
+          sink += static_cast<int>(row);
+        };
+
+        for (size_t k = 0; k < order.size(); ++k)
+          {
+          arrived.push_back(order[k]);
+          addToRow(entities[order[k]]);
+
+          if (dirty && (k + 1) % renderInterval == 0)
+            {
+            std::vector<size_t> sorted = arrived;
+            std::stable_sort(sorted.begin(), sorted.end(),
+                             [&](size_t a, size_t b){
+                               return entities[a].Start < entities[b].Start;
+                             });
+            rowEnds.clear();
+            lastStart = -std::numeric_limits<double>::max();
+            dirty = false;
+            for (const size_t n : sorted)
+              {
+              addToRow(entities[n]);
+              }
+            }
+          }
+        sink += static_cast<int>(rowEnds.size());
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("timeline-entities <list>",
+              "Comma separated list of streamed entity counts for timeline "
+              "layout", "100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTimelineLayout(benchmark, context.sizes("timeline-entities"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("timeline-layout", &addOptions, &run, false);
+
+} // namespace <anonymous>
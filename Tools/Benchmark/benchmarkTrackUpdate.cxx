@@ -0,0 +1,191 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vsTrackState.h>
+#include <vsTrackStateTransform.h>
+
+#include <vtkVgUtil.h>
+
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+#include <QJsonObject>
+
+#include <cmath>
+#include <random>
+
+using vgBenchmarkData::FrameInterval;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+// Stabilization of a track state as vsCore did it before the transform was
+// factored out; each state builds its point buffer and polygon by appending,
+// and each point goes through a full 4x4 multiply
+double updateStateAppend(const vvTrackState& state,
+                         const vtkMatrix4x4& homography)
+{
+  vsTrackState wstate;
+  wstate.time = state.TimeStamp;
+
+  QVector<float> object;
+  double wp[2];
+  for (size_t n = 0; n < state.ImageObject.size(); ++n)
+    {
+    const vvImagePointF& ip = state.ImageObject[n];
+    vtkVgApplyHomography(ip.X, ip.Y, homography, wp);
+    object.append(wp[0]); object.append(wp[1]); object.append(0.0f);
+    wstate.object.append(QPointF(wp[0], wp[1]));
+    }
+  vtkVgApplyHomography(state.ImagePoint.X, state.ImagePoint.Y,
+                       homography, wp);
+  wstate.point = QPointF(wp[0], wp[1]);
+
+  return wp[0] + object.last() + wstate.object.last().y();
+}
+
+//-----------------------------------------------------------------------------
+// Stabilization of a track state as vsCore does it now
+double updateStateReuse(const vvTrackState& state,
+                        const vtkMatrix4x4& homography,
+                        QVector<float>& object)
+{
+  vsTrackState wstate;
+  wstate.time = state.TimeStamp;
+
+  const vsTrackStateTransform transform(homography);
+  transform.mapObject(state.ImageObject, object, wstate.object);
+
+  double wp[2];
+  transform.map(state.ImagePoint.X, state.ImagePoint.Y, wp[0], wp[1]);
+  wstate.point = QPointF(wp[0], wp[1]);
+
+  return wp[0] + object.last() + wstate.object.last().y();
+}
+
+//-----------------------------------------------------------------------------
+template <typename Func>
+void countAllocations(vgBenchmark& benchmark, int stateCount, Func func)
+{
+  const qint64 start = allocationCount();
+  if (start < 0)
+    {
+    return;
+    }
+
+  func();
+  const qint64 allocations = allocationCount() - start;
+  benchmark.annotate("allocations_per_state",
+                     static_cast<double>(allocations) / stateCount);
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkTrackUpdate(vgBenchmark& benchmark,
+                          const QList<int>& objectSizes, int stateCount)
+{
+  // Use a homography with some perspective, so that the divide by w is not
+  // trivial
+  vtkNew<vtkMatrix4x4> matrix;
+  matrix->SetElement(0, 0, 1.02);
+  matrix->SetElement(0, 1, 0.01);
+  matrix->SetElement(0, 3, -12.5);
+  matrix->SetElement(1, 0, -0.01);
+  matrix->SetElement(1, 1, 0.98);
+  matrix->SetElement(1, 3, 7.25);
+  matrix->SetElement(3, 0, 1e-5);
+  matrix->SetElement(3, 1, -2e-5);
+  const vtkMatrix4x4& homography = *matrix.GetPointer();
+
+  foreach (const int objectSize, objectSizes)
+    {
+    // Generate states which move at random, each with an object outline of
+    // the requested number of points around its location
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> stepDist(-4.0, 4.0);
+
+    QList<vvTrackState> states;
+    double x = 320.0, y = 240.0;
+    for (int n = 0; n < stateCount; ++n)
+      {
+      x += stepDist(rng);
+      y += stepDist(rng);
+
+      vvTrackState state;
+      state.TimeStamp = vgTimeStamp(n * FrameInterval, n);
+      state.ImagePoint = vvImagePointF(x, y);
+      state.ImageObject.reserve(objectSize);
+      for (int k = 0; k < objectSize; ++k)
+        {
+        const double a = (2.0 * vtkMath::Pi() * k) / objectSize;
+        state.ImageObject.push_back(
+          vvImagePointF(x + 20.0 * cos(a), y + 20.0 * sin(a)));
+        }
+      states.append(state);
+      }
+
+    QJsonObject parameters;
+    parameters.insert("states", stateCount);
+    parameters.insert("object_points", objectSize);
+
+    // Accumulate results so the updates cannot be optimized away
+    volatile double sink = 0.0;
+
+    const auto runAppend = [&]{
+      foreach (const vvTrackState& state, states)
+        {
+        sink += updateStateAppend(state, homography);
+        }
+    };
+    const auto runReuse = [&]{
+      // As in vsCorePrivate::updateTrack, the point buffer is shared by all
+      // states of a batch
+      QVector<float> object;
+      foreach (const vvTrackState& state, states)
+        {
+        sink += updateStateReuse(state, homography, object);
+        }
+    };
+
+    // Time each path, then run it once more to count its allocations
+    benchmark.measure("track-update", "append", parameters,
+                      stateCount, "states", runAppend);
+    countAllocations(benchmark, stateCount, runAppend);
+
+    benchmark.measure("track-update", "reuse", parameters,
+                      stateCount, "states", runReuse);
+    countAllocations(benchmark, stateCount, runReuse);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("object-points <list>",
+              "Comma separated list of object outline point counts for track "
+              "state updates", "4,16,64");
+
+  options.add("update-states <num>",
+              "Number of track states stabilized by each track state update "
+              "measurement", "100000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTrackUpdate(benchmark, context.sizes("object-points"),
+                       context.count("update-states"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("track-update", &addOptions, &run, false);
+
+} // namespace <anonymous>
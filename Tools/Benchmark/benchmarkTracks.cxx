@@ -0,0 +1,112 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgTrack.h>
+#include <vtkVgTrackModel.h>
+#include <vtkVgTrackRepresentation.h>
+
+#include <vtkNew.h>
+
+#include <QJsonObject>
+
+#include <random>
+
+using vgBenchmarkData::FrameInterval;
+using vgBenchmarkData::makeSyntheticTracks;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTracks(vgBenchmark& benchmark, const QList<int>& trackCounts,
+                     int trackLength, int frameCount)
+{
+  std::mt19937 rng(42);
+  const int updateCount = qMin(frameCount, 100);
+
+  foreach (const int trackCount, trackCounts)
+    {
+    const QList<vvTrack> tracks =
+      makeSyntheticTracks(trackCount, trackLength, frameCount, rng);
+
+    QJsonObject parameters;
+    parameters.insert("tracks", trackCount);
+    parameters.insert("track_length", trackLength);
+    parameters.insert("updates", updateCount);
+
+    vtkNew<vtkVgTrackModel> trackModel;
+    trackModel->SetDisplayAllTracks(true);
+    trackModel->Initialize();
+
+    benchmark.measure(
+      "tracks", "model-populate", parameters, trackCount, "tracks",
+      [&]{
+        trackModel->Initialize();
+        vtkIdType nextId = 0;
+        foreach (const vvTrack& track, tracks)
+          {
+          vtkNew<vtkVgTrack> t;
+          t->SetPoints(trackModel->GetPoints());
+          t->SetId(++nextId);
+
+          foreach (const vvTrackState& s, track.Trajectory)
+            {
+            const double pos[2] = { s.ImagePoint.X, s.ImagePoint.Y };
+            t->InsertNextPoint(s.TimeStamp, pos, s.WorldLocation);
+            }
+
+          trackModel->AddTrack(t.GetPointer());
+          }
+      });
+
+    vtkNew<vtkVgTrackRepresentation> trackRepresentation;
+    trackRepresentation->SetTrackModel(trackModel.GetPointer());
+    trackRepresentation->SetVisible(true);
+
+    // Step through the video at an interval that covers the whole range
+    const int step = qMax(1, frameCount / updateCount);
+    const auto timeAt = [&](int n){
+      const int frame = (n * step) % frameCount;
+      return vtkVgTimeStamp(frame * FrameInterval, frame);
+    };
+
+    benchmark.measure(
+      "tracks", "model-update", parameters, updateCount, "updates",
+      [&]{
+        for (int n = 0; n < updateCount; ++n)
+          {
+          trackModel->Update(timeAt(n));
+          }
+      });
+
+    // Representation updates only do work when the model has changed, so
+    // measure them interleaved with model updates; the cost of the
+    // representation alone is the difference from the model-update result
+    benchmark.measure(
+      "tracks", "representation-update", parameters, updateCount, "updates",
+      [&]{
+        for (int n = 0; n < updateCount; ++n)
+          {
+          trackModel->Update(timeAt(n));
+          trackRepresentation->Update();
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTracks(benchmark, context.sizes("tracks"),
+                  syntheticTrackLength(context), syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("tracks", 0, &run, true);
+
+} // namespace <anonymous>
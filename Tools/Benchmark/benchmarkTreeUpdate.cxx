@@ -0,0 +1,253 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vgRowCache.h>
+#include <vgUnixTime.h>
+
+#include <qtGlobal.h>
+
+#include <QAbstractTableModel>
+#include <QJsonObject>
+#include <QSortFilterProxyModel>
+
+#include <random>
+
+using vgBenchmarkData::FrameInterval;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+// Flat model with the same update path as the vsPlay track and event tree
+// models; display text is formatted when first requested and cached in a
+// vgRowCache until the row changes
+class TreeUpdateModel : public QAbstractTableModel
+{
+public:
+  enum
+    {
+    IdColumn,
+    ProbabilityColumn,
+    StartTimeColumn,
+    EndTimeColumn,
+    NumColumns
+    };
+
+  explicit TreeUpdateModel(int rowCount) : Items(rowCount)
+    {
+    for (int n = 0; n < rowCount; ++n)
+      {
+      this->Items[n].StartTime = n * FrameInterval;
+      this->Items[n].EndTime = (n + 30) * FrameInterval;
+      this->Items[n].Probability = static_cast<double>(n % 100) / 100.0;
+      this->RowCache.append(n);
+      }
+    }
+
+  virtual int rowCount(
+    const QModelIndex& parent = QModelIndex()) const QTE_OVERRIDE
+    { return (parent.isValid() ? 0 : this->Items.count()); }
+
+  virtual int columnCount(
+    const QModelIndex& parent = QModelIndex()) const QTE_OVERRIDE
+    { return (parent.isValid() ? 0 : NumColumns); }
+
+  virtual QVariant data(
+    const QModelIndex& index, int role) const QTE_OVERRIDE;
+
+  // Extend the specified items by a frame, and announce the change either
+  // with a single dataChanged() for the whole model, invalidating every
+  // cached row, or with coalesced ranges covering only the changed rows
+  void extendItems(const QVector<int>& itemIds, bool coalesce);
+
+protected:
+  struct Item
+    {
+    Item() : StartTime(0), EndTime(0), Probability(0.0) {}
+
+    qint64 StartTime;
+    qint64 EndTime;
+    double Probability;
+    };
+
+  struct DisplayValues
+    {
+    QString Text[NumColumns];
+    };
+
+  const DisplayValues& displayValues(int row) const;
+
+  QVector<Item> Items;
+  vgRowCache<int, DisplayValues> RowCache;
+};
+
+//-----------------------------------------------------------------------------
+QVariant TreeUpdateModel::data(const QModelIndex& index, int role) const
+{
+  if (!index.isValid() || role != Qt::DisplayRole)
+    {
+    return QVariant();
+    }
+
+  return this->displayValues(index.row()).Text[index.column()];
+}
+
+//-----------------------------------------------------------------------------
+const TreeUpdateModel::DisplayValues& TreeUpdateModel::displayValues(
+  int row) const
+{
+  if (const DisplayValues* const cached = this->RowCache.values(row))
+    {
+    return *cached;
+    }
+
+  const Item& item = this->Items[this->RowCache.key(row)];
+
+  DisplayValues values;
+  values.Text[IdColumn] = QString::number(this->RowCache.key(row));
+  values.Text[ProbabilityColumn] = QString::number(item.Probability, 'f', 4);
+  values.Text[StartTimeColumn] = vgUnixTime(item.StartTime).timeString();
+  values.Text[EndTimeColumn] = vgUnixTime(item.EndTime).timeString();
+
+  return this->RowCache.setValues(row, values);
+}
+
+//-----------------------------------------------------------------------------
+void TreeUpdateModel::extendItems(const QVector<int>& itemIds, bool coalesce)
+{
+  foreach (const int id, itemIds)
+    {
+    this->Items[id].EndTime += FrameInterval;
+    this->RowCache.invalidate(this->RowCache.row(id));
+    }
+
+  if (!coalesce)
+    {
+    this->RowCache.invalidateAll();
+    }
+
+  typedef vgRowCache<int, DisplayValues>::Range Range;
+  foreach (const Range& range, this->RowCache.takeChanges())
+    {
+    emit this->dataChanged(this->index(range.first, 0),
+                           this->index(range.second, NumColumns - 1));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void benchmarkTreeUpdate(vgBenchmark& benchmark, const QList<int>& rowCounts,
+                         int changeCount)
+{
+  std::mt19937 rng(7);
+
+  foreach (const int rowCount, rowCounts)
+    {
+    TreeUpdateModel model(rowCount);
+
+    // Sort by id, as the tree views do by default, so that the proxy checks
+    // the order of changed rows without actually reordering them
+    QSortFilterProxyModel proxy;
+    proxy.setDynamicSortFilter(true);
+    proxy.setSourceModel(&model);
+    proxy.sort(TreeUpdateModel::IdColumn);
+
+    // Check each dataChanged() from the proxy in the manner of
+    // QAbstractItemModelTester, and fetch the changed cells as a view would
+    // when repainting them
+    qint64 cellsFetched = 0;
+    int errors = 0;
+    QObject::connect(
+      &proxy, &QAbstractItemModel::dataChanged,
+      [&](const QModelIndex& topLeft, const QModelIndex& bottomRight)
+        {
+        if (!topLeft.isValid() || !bottomRight.isValid() ||
+            topLeft.model() != &proxy || bottomRight.model() != &proxy ||
+            topLeft.parent() != bottomRight.parent() ||
+            topLeft.row() > bottomRight.row() ||
+            topLeft.column() > bottomRight.column())
+          {
+          ++errors;
+          return;
+          }
+
+        for (int r = topLeft.row(); r <= bottomRight.row(); ++r)
+          {
+          for (int c = topLeft.column(); c <= bottomRight.column(); ++c)
+            {
+            proxy.index(r, c).data();
+            ++cellsFetched;
+            }
+          }
+        });
+
+    // Prime the cache, as the initial population of the view would
+    for (int r = 0; r < rowCount; ++r)
+      {
+      for (int c = 0; c < TreeUpdateModel::NumColumns; ++c)
+        {
+        proxy.index(r, c).data();
+        }
+      }
+
+    // Tracks updated on a frame tick are mostly the most recently added
+    // ones, with a few older ones scattered throughout
+    std::uniform_int_distribution<int> anyRow(0, rowCount - 1);
+    QVector<int> changedItems;
+    const int changes = qMin(changeCount, rowCount);
+    for (int n = 0; n < changes; ++n)
+      {
+      changedItems.append(n % 4 ? rowCount - 1 - n : anyRow(rng));
+      }
+
+    QJsonObject parameters;
+    parameters.insert("rows", rowCount);
+    parameters.insert("changes", changes);
+
+    cellsFetched = 0;
+    benchmark.measure(
+      "tree-update", "full", parameters, changes, "changes",
+      [&]{ model.extendItems(changedItems, false); });
+    parameters.insert("cells_fetched", cellsFetched / benchmark.iterations());
+
+    cellsFetched = 0;
+    benchmark.measure(
+      "tree-update", "change-set", parameters, changes, "changes",
+      [&]{ model.extendItems(changedItems, true); });
+
+    if (errors)
+      {
+      qWarning() << "Tree update produced" << errors
+                 << "invalid dataChanged() ranges";
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("tree-update-rows <list>",
+              "Comma separated list of row counts for tree model updates",
+              "10000,100000");
+
+  options.add("tree-update-changes <num>",
+              "Number of rows changed by each tree model update", "100");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTreeUpdate(benchmark, context.sizes("tree-update-rows"),
+                      context.count("tree-update-changes"));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("tree-update", &addOptions, &run, false);
+
+} // namespace <anonymous>
@@ -0,0 +1,193 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <vgBenchmarkData.h>
+
+#include <vtkVgEventModel.h>
+#include <vtkVgTrack.h>
+#include <vtkVgTrackModel.h>
+#include <vtkVgTripWireManager.h>
+
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkSmartPointer.h>
+
+#include <QJsonObject>
+
+#include <random>
+#include <vector>
+
+using vgBenchmarkData::makeSyntheticTracks;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkTripWires(vgBenchmark& benchmark, const QList<int>& wireCounts,
+                        const QList<int>& trackCounts, int trackLength,
+                        int frameCount)
+{
+  enum { TripWireId = 1, EnteringRegionId = 2, ExitingRegionId = 3 };
+
+  foreach (const int wireCount, wireCounts)
+    {
+    // Scatter short wires over the scene; every fourth wire is a closed
+    // region, so that enter/exit classification is also exercised
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> posDist(0.0, 1000.0);
+    std::uniform_real_distribution<double> sizeDist(5.0, 40.0);
+
+    std::vector<vtkSmartPointer<vtkPoints> > wires;
+    for (int n = 0; n < wireCount; ++n)
+      {
+      const double x = posDist(rng), y = posDist(rng);
+      const double w = sizeDist(rng), h = sizeDist(rng);
+
+      auto points = vtkSmartPointer<vtkPoints>::New();
+      points->InsertNextPoint(x, y, 0.0);
+      points->InsertNextPoint(x + w, y, 0.0);
+      points->InsertNextPoint(x + w, y + h, 0.0);
+      if (n % 4 == 0)
+        {
+        points->InsertNextPoint(x, y + h, 0.0);
+        points->InsertNextPoint(x, y, 0.0);
+        }
+      wires.push_back(points);
+      }
+
+    foreach (const int trackCount, trackCounts)
+      {
+      const QList<vvTrack> tracks =
+        makeSyntheticTracks(trackCount, trackLength, frameCount, rng);
+
+      QJsonObject parameters;
+      parameters.insert("tripwires", wireCount);
+      parameters.insert("tracks", trackCount);
+      parameters.insert("track_length", trackLength);
+
+      vtkNew<vtkVgTrackModel> trackModel;
+      vtkNew<vtkVgEventModel> eventModel;
+      vtkSmartPointer<vtkVgTripWireManager> manager;
+
+      const auto reset = [&]{
+        trackModel->Initialize();
+        eventModel->Initialize();
+
+        manager = vtkSmartPointer<vtkVgTripWireManager>::New();
+        manager->SetTrackModel(trackModel.GetPointer());
+        manager->SetEventModel(eventModel.GetPointer());
+        manager->SetTripWireId(TripWireId);
+        manager->SetEnteringRegionId(EnteringRegionId);
+        manager->SetExitingRegionId(ExitingRegionId);
+        for (size_t n = 0; n < wires.size(); ++n)
+          {
+          manager->AddTripWire(wires[n], wires[n]->GetNumberOfPoints() > 3);
+          }
+        };
+
+      // Feed the tracks to the model one frame at a time, as they would
+      // arrive from a live source, checking the wires after every frame
+      benchmark.measure(
+        "tripwire", "stream", parameters, frameCount, "updates",
+        [&]{
+          reset();
+
+          std::vector<vtkVgTrack*> modelTracks;
+          for (int t = 0; t < trackCount; ++t)
+            {
+            vtkNew<vtkVgTrack> track;
+            track->SetPoints(trackModel->GetPoints());
+            track->SetId(t);
+            trackModel->AddTrack(track.GetPointer());
+            modelTracks.push_back(track.GetPointer());
+            }
+
+          std::vector<int> next(trackCount, 0);
+          for (int frame = 0; frame < frameCount; ++frame)
+            {
+            for (int t = 0; t < trackCount; ++t)
+              {
+              const QList<vvTrackState>& trajectory = tracks[t].Trajectory;
+              if (next[t] < trajectory.count() &&
+                  static_cast<int>(
+                    trajectory[next[t]].TimeStamp.FrameNumber) == frame)
+                {
+                const vvTrackState& s = trajectory[next[t]++];
+                const double pos[2] = { s.ImagePoint.X, s.ImagePoint.Y };
+                modelTracks[t]->InsertNextPoint(s.TimeStamp, pos,
+                                                s.WorldLocation);
+                }
+              }
+            trackModel->Modified();
+            manager->CheckTripWires();
+            }
+        });
+
+      // Test each new track segment against the wires as it arrives, as the
+      // live trip wire descriptor does
+      int segmentCount = 0;
+      foreach (const vvTrack& track, tracks)
+        {
+        segmentCount += qMax(0, track.Trajectory.count() - 1);
+        }
+
+      benchmark.measure(
+        "tripwire", "segments", parameters, segmentCount, "segments",
+        [&]{
+          reset();
+
+          std::vector<vtkVgTripWireManager::IntersectionInfo> intersections;
+          for (int t = 0; t < trackCount; ++t)
+            {
+            const QList<vvTrackState>& trajectory = tracks[t].Trajectory;
+            for (int n = 1; n < trajectory.count(); ++n)
+              {
+              const vvTrackState& s0 = trajectory[n - 1];
+              const vvTrackState& s1 = trajectory[n];
+              double pt0[2] = { s0.ImagePoint.X, s0.ImagePoint.Y };
+              double pt1[2] = { s1.ImagePoint.X, s1.ImagePoint.Y };
+              manager->CheckTrackSegment(pt0, pt1, s0.TimeStamp, s1.TimeStamp,
+                                         intersections);
+              }
+            }
+        });
+
+      // Changing the pre-trip duration forces every wire to be checked
+      // against the full tracks, which is the cost of the first check of a
+      // newly added wire
+      vtkVgTimeStamp duration = manager->GetPreTripDuration();
+      benchmark.measure(
+        "tripwire", "full-check", parameters, wireCount, "tripwires",
+        [&]{
+          duration.SetFrameNumber(duration.GetFrameNumber() ^ 1);
+          manager->SetPreTripDuration(duration);
+          manager->CheckTripWires();
+        });
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void addOptions(qtCliOptions& options)
+{
+  options.add("tripwires <list>",
+              "Comma separated list of trip wire counts", "100,1000,5000");
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkTripWires(benchmark, context.sizes("tripwires"),
+                     context.sizes("tracks"), syntheticTrackLength(context),
+                     syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("tripwire", &addOptions, &run, false);
+
+} // namespace <anonymous>
@@ -0,0 +1,105 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vgKwaVideoClip.h>
+
+#include <QJsonObject>
+#include <QUrl>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using vgBenchmarkData::FrameInterval;
+using vgBenchmarkData::writeSyntheticKwa;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkVideo(vgBenchmark& benchmark, const QString& directory,
+                    int frameCount, int width, int height)
+{
+  QString indexName;
+  if (!writeSyntheticKwa(directory, frameCount, width, height, indexName))
+    {
+    return;
+    }
+
+  QJsonObject parameters;
+  parameters.insert("frames", frameCount);
+  parameters.insert("width", width);
+  parameters.insert("height", height);
+
+  const QUrl uri = QUrl::fromLocalFile(indexName);
+
+  benchmark.measure(
+    "video", "kwa-open", parameters, frameCount, "frames",
+    [&]{ vgKwaVideoClip clip(uri); });
+
+  vgKwaVideoClip clip(uri);
+  if (clip.frameCount() != frameCount)
+    {
+    qWarning() << "Synthetic video has" << clip.frameCount()
+               << "frames; expected" << frameCount;
+    return;
+    }
+
+  benchmark.measure(
+    "video", "kwa-decode", parameters, frameCount, "frames",
+    [&]{
+      clip.rewind();
+      while (clip.currentTimeStamp().IsValid())
+        {
+        // Force read of pixel data
+        clip.currentImage().constData();
+        clip.advance();
+        }
+    });
+
+  // Seek in a fixed pseudo-random order, so runs are comparable
+  std::vector<unsigned int> order(frameCount);
+  for (int n = 0; n < frameCount; ++n)
+    {
+    order[n] = static_cast<unsigned int>(n);
+    }
+  std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+  benchmark.measure(
+    "video", "seek-time", parameters, frameCount, "seeks",
+    [&]{
+      foreach (const unsigned int n, order)
+        {
+        clip.frameAt(vgTimeStamp::fromTime(n * FrameInterval),
+                     vg::SeekNearest);
+        }
+    });
+
+  benchmark.measure(
+    "video", "seek-frame-number", parameters, frameCount, "seeks",
+    [&]{
+      foreach (const unsigned int n, order)
+        {
+        clip.frameAtFrameNumber(n, vg::SeekNearest);
+        }
+    });
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  const QSize frameSize = context.frameSize("frame-size");
+  benchmarkVideo(benchmark, context.workDirectory(),
+                 syntheticFrameCount(context),
+                 frameSize.width(), frameSize.height());
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("video", 0, &run, true);
+
+} // namespace <anonymous>
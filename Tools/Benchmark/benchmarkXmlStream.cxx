@@ -0,0 +1,117 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <vgBenchmarkData.h>
+
+#include <vvHeader.h>
+#include <vvWriter.h>
+#include <vvXmlReader.h>
+
+#include <QDir>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QUrl>
+
+#include <random>
+
+using vgBenchmarkData::makeSyntheticResults;
+using vgBenchmarkData::writeSyntheticArchive;
+
+namespace // anonymous
+{
+
+//-----------------------------------------------------------------------------
+void benchmarkXmlStream(vgBenchmark& benchmark, const QString& directory,
+                        const QList<int>& resultCounts, int trackLength,
+                        int frameCount)
+{
+  std::mt19937 rng(42);
+
+  foreach (const int resultCount, resultCounts)
+    {
+    const QString resultFile =
+      QDir(directory).filePath(QString("results-%1.xml").arg(resultCount));
+
+    // Write synthetic data (scoped, as for the KST stream suite)
+      {
+      const QList<vvQueryResult> results =
+        makeSyntheticResults(resultCount, trackLength, frameCount, rng);
+      if (!writeSyntheticArchive(resultFile, vvWriter::Xml,
+                                 vvHeader::QueryResults, results))
+        {
+        continue;
+        }
+      }
+
+    const qint64 bytes = QFileInfo(resultFile).size();
+    const double megabytes = 1e-6 * bytes;
+
+    QJsonObject parameters;
+    parameters.insert("results", resultCount);
+    parameters.insert("track_length", trackLength);
+    parameters.insert("bytes", bytes);
+
+    // As above, run the stream reader first so that its peak RSS is not
+    // masked by that of the DOM reader
+    benchmark.measure(
+      "xml-stream", "stream", parameters, megabytes, "MB",
+      [&]{
+        vvXmlReader reader;
+        vvQueryResult result;
+        if (!reader.open(QUrl::fromLocalFile(resultFile)))
+          {
+          qWarning() << "Failed to open" << resultFile
+                     << '-' << reader.error();
+          return;
+          }
+        while (!reader.atEnd())
+          {
+          if (!reader.readQueryResult(result))
+            {
+            qWarning() << "Failed to read" << resultFile
+                       << '-' << reader.error();
+            return;
+            }
+          }
+      });
+
+    benchmark.measure(
+      "xml-stream", "dom", parameters, megabytes, "MB",
+      [&]{
+        QFile file(resultFile);
+        QDomDocument doc;
+        if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file))
+          {
+          qWarning() << "Failed to parse" << resultFile;
+          return;
+          }
+
+        vvXmlReader reader;
+        QDomNode node = doc.documentElement().firstChildElement();
+        QList<vvQueryResult> results;
+        if (!reader.readQueryResults(node, results))
+          {
+          qWarning() << "Failed to read" << resultFile
+                     << '-' << reader.error();
+          }
+      });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void run(vgBenchmark& benchmark, const vgBenchmarkContext& context)
+{
+  benchmarkXmlStream(benchmark, context.workDirectory(),
+                     context.sizes("tracks"), syntheticTrackLength(context),
+                     syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+vgBenchmarkSuite suite("xml-stream", 0, &run, false);
+
+} // namespace <anonymous>
@@ -0,0 +1,106 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include "visguiBenchmark.h"
+
+#include <qtCliOptions.h>
+
+#include <atomic>
+
+namespace // anonymous
+{
+
+std::atomic<qint64> allocations(0);
+
+//-----------------------------------------------------------------------------
+void addSharedOptions(qtCliOptions& options)
+{
+  options.add("frames <num>", "Number of frames of synthetic video", "300")
+         .add("f", qtCliOption::Short);
+
+  options.add("frame-size <width>x<height>",
+              "Size of synthetic video frames", "640x480");
+
+  options.add("tracks <list>",
+              "Comma separated list of synthetic track counts",
+              "100,1000,10000")
+         .add("t", qtCliOption::Short);
+
+  options.add("track-length <num>",
+              "Number of states in each synthetic track", "50");
+
+  options.add("threads <num>",
+              "Number of threads used by parallel readers "
+              "(by default, the number of processor cores)");
+}
+
+} // namespace <anonymous>
+
+#ifdef __GLIBC__
+
+// Count heap allocations by wrapping the allocator; the glibc entry points
+// are used, as those are what the replaced functions would have called.
+// Both operator new and Qt's containers allocate through these.
+extern "C"
+{
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+
+//-----------------------------------------------------------------------------
+void* malloc(size_t size) __THROW
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+//-----------------------------------------------------------------------------
+void* calloc(size_t count, size_t size) __THROW
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+//-----------------------------------------------------------------------------
+void* realloc(void* ptr, size_t size) __THROW
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+}
+
+//-----------------------------------------------------------------------------
+qint64 allocationCount()
+{
+  return allocations.load(std::memory_order_relaxed);
+}
+
+#else
+
+//-----------------------------------------------------------------------------
+qint64 allocationCount()
+{
+  return -1;
+}
+
+#endif
+
+//-----------------------------------------------------------------------------
+int syntheticFrameCount(const vgBenchmarkContext& context)
+{
+  return context.count("frames");
+}
+
+//-----------------------------------------------------------------------------
+int syntheticTrackLength(const vgBenchmarkContext& context)
+{
+  return qMin(context.count("track-length"), syntheticFrameCount(context));
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  return vgBenchmarkSuite::exec(argc, argv, "VisGUI performance benchmark",
+                                &addSharedOptions);
+}
@@ -0,0 +1,22 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#ifndef __visguiBenchmark_h
+#define __visguiBenchmark_h
+
+#include <vgBenchmark.h>
+#include <vgBenchmarkSuite.h>
+
+// Number of heap allocations made by the process so far, or -1 if
+// allocations are not counted on this platform
+qint64 allocationCount();
+
+// Number of frames of synthetic data
+int syntheticFrameCount(const vgBenchmarkContext& context);
+
+// Number of states in each synthetic track; this is never more than the
+// number of frames
+int syntheticTrackLength(const vgBenchmarkContext& context);
+
+#endif
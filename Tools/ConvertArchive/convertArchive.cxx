@@ -0,0 +1,155 @@
+// This file is part of ViViA, and is distributed under the
+// OSI-approved BSD 3-Clause License. See top-level LICENSE file or
+// https://github.com/Kitware/vivia/blob/master/LICENSE for details.
+
+#include <vvEventSetInfo.h>
+#include <vvHeader.h>
+#include <vvQueryInstance.h>
+#include <vvReader.h>
+#include <vvWriter.h>
+
+#include <qtCliArgs.h>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QUrl>
+
+//-----------------------------------------------------------------------------
+template <typename T>
+int convert(vvReader& reader, vvWriter& writer, bool (vvReader::*method)(T&))
+{
+  int count = 0;
+  T item;
+  while (!reader.atEnd())
+    {
+    if (!(reader.*method)(item))
+      {
+      qCritical() << "ERROR: Failed to read input:" << reader.error();
+      return -1;
+      }
+    writer << item;
+    ++count;
+    }
+  return count;
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+  // Set application information
+  QCoreApplication::setApplicationName("VisGUI archive conversion utility");
+  QCoreApplication::setOrganizationName("Kitware");
+  QCoreApplication::setOrganizationDomain("kitware.com");
+
+  // Set up command line options
+  qtCliArgs args(argc, argv);
+
+  qtCliOptions options;
+  options.add("input <file>", "Path to input archive", qtCliOption::Required)
+         .add("i", qtCliOption::Short);
+  options.add("output <file>", "Path to output archive",
+              qtCliOption::Required)
+         .add("o", qtCliOption::Short);
+  options.add("format <name>",
+              "Output format ('binary', 'kst' or 'xml')", "binary")
+         .add("f", qtCliOption::Short);
+  args.addOptions(options);
+
+  // Parse arguments
+  args.parseOrDie();
+
+  const QString formatName = args.value("format").toLower();
+  vvWriter::Format format;
+  if (formatName == "binary")
+    {
+    format = vvWriter::Binary;
+    }
+  else if (formatName == "kst")
+    {
+    format = vvWriter::Kst;
+    }
+  else if (formatName == "xml")
+    {
+    format = vvWriter::Xml;
+    }
+  else
+    {
+    qCritical() << "ERROR: Unknown output format" << formatName;
+    return EXIT_FAILURE;
+    }
+
+  // Open input archive (format is detected automatically)
+  vvReader reader;
+  vvHeader header;
+  const QUrl inputUri = QUrl::fromLocalFile(args.value("input"));
+  qDebug() << "Reading" << inputUri;
+  if (!reader.open(inputUri) || !reader.readHeader(header))
+    {
+    qCritical() << "ERROR: Failed to read input:" << reader.error();
+    return EXIT_FAILURE;
+    }
+
+  if (format == vvWriter::Binary &&
+      header.type != vvHeader::Tracks &&
+      header.type != vvHeader::Descriptors &&
+      header.type != vvHeader::QueryResults)
+    {
+    qCritical() << "ERROR: Binary archives may only contain tracks,"
+                   " descriptors or query results";
+    return EXIT_FAILURE;
+    }
+
+  // Open output file
+  QFile of(args.value("output"));
+  const QIODevice::OpenMode mode =
+    (format == vvWriter::Binary ? QIODevice::WriteOnly
+                                : QIODevice::WriteOnly | QIODevice::Text);
+  if (!of.open(mode))
+    {
+    qCritical() << "ERROR: Failed to open output file:" << of.errorString();
+    return EXIT_FAILURE;
+    }
+
+  // Convert items one at a time, so that the entire archive is never held in
+  // memory at once
+  int count = -1;
+    {
+    vvWriter writer(of, format);
+    writer << header.type;
+
+    switch (header.type)
+      {
+      case vvHeader::Tracks:
+        count = convert<vvTrack>(reader, writer, &vvReader::readTrack);
+        break;
+      case vvHeader::Descriptors:
+        count = convert<vvDescriptor>(reader, writer,
+                                      &vvReader::readDescriptor);
+        break;
+      case vvHeader::QueryResults:
+        count = convert<vvQueryResult>(reader, writer,
+                                       &vvReader::readQueryResult);
+        break;
+      case vvHeader::QueryPlan:
+        count = convert<vvQueryInstance>(reader, writer,
+                                         &vvReader::readQueryPlan);
+        break;
+      case vvHeader::EventSetInfo:
+        count = convert<vvEventSetInfo>(reader, writer,
+                                        &vvReader::readEventSetInfo);
+        break;
+      default:
+        qCritical() << "ERROR: Input archive has unknown type";
+        break;
+      }
+    }
+
+  if (count < 0)
+    {
+    return EXIT_FAILURE;
+    }
+
+  qDebug() << "Wrote" << count << "item(s) to" << args.value("output");
+  return EXIT_SUCCESS;
+}
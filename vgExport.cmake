@@ -17,6 +17,7 @@ set(CONTENT_PRE_EXPORTS
 add_export(qtTestingSupport QT_TESTINGSUPPORT)
 add_export(qtVgCommon       QTVG_COMMON)
 add_export(qtVgWidgets      QTVG_WIDGETS)
+add_export(vgBenchmarkSupport VG_BENCHMARKSUPPORT)
 add_export(vgCommon         VG_COMMON)
 add_export(vgVideo          VG_VIDEO)
 add_export(vgVtkVideo       VG_VTKVIDEO)